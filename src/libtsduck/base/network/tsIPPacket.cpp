@@ -18,6 +18,88 @@ ts::IPPacket::IPPacket(const void* data, size_t size)
     reset(data, size);
 }
 
+ts::IPPacket::IPPacket(const IPPacket& other) :
+    _valid(other._valid),
+    _proto_type(other._proto_type),
+    _ip_header_size(other._ip_header_size),
+    _proto_header_size(other._proto_header_size),
+    _source(other._source),
+    _destination(other._destination),
+    _size(other._size)
+{
+    copyData(other);
+}
+
+ts::IPPacket::IPPacket(IPPacket&& other) noexcept :
+    _valid(other._valid),
+    _proto_type(other._proto_type),
+    _ip_header_size(other._ip_header_size),
+    _proto_header_size(other._proto_header_size),
+    _source(other._source),
+    _destination(other._destination),
+    _addr(other._addr),
+    _size(other._size),
+    _data(std::move(other._data))
+{
+    relocate();
+    other.clear();
+}
+
+ts::IPPacket& ts::IPPacket::operator=(const IPPacket& other)
+{
+    if (&other != this) {
+        _valid = other._valid;
+        _proto_type = other._proto_type;
+        _ip_header_size = other._ip_header_size;
+        _proto_header_size = other._proto_header_size;
+        _source = other._source;
+        _destination = other._destination;
+        _size = other._size;
+        copyData(other);
+    }
+    return *this;
+}
+
+ts::IPPacket& ts::IPPacket::operator=(IPPacket&& other) noexcept
+{
+    if (&other != this) {
+        _valid = other._valid;
+        _proto_type = other._proto_type;
+        _ip_header_size = other._ip_header_size;
+        _proto_header_size = other._proto_header_size;
+        _source = other._source;
+        _destination = other._destination;
+        _addr = other._addr;
+        _size = other._size;
+        _data = std::move(other._data);
+        relocate();
+        other.clear();
+    }
+    return *this;
+}
+
+// A copy always owns its packet content, even if the other instance references external data.
+void ts::IPPacket::copyData(const IPPacket& other)
+{
+    if (other._addr == nullptr || other._size == 0) {
+        _data.clear();
+        _addr = nullptr;
+    }
+    else {
+        _data.copy(other._addr, other._size);
+        _addr = _data.data();
+    }
+}
+
+// After a move, when the packet content is held by the instance, point to our own copy.
+// When the packet references external data, keep the same reference.
+void ts::IPPacket::relocate()
+{
+    if (!_data.empty()) {
+        _addr = _data.data();
+    }
+}
+
 void ts::IPPacket::clear()
 {
     _valid = false;
@@ -26,6 +108,8 @@ void ts::IPPacket::clear()
     _proto_header_size = 0;
     _source.clear();
     _destination.clear();
+    _addr = nullptr;
+    _size = 0;
     _data.clear();
 }
 
@@ -34,7 +118,7 @@ void ts::IPPacket::clear()
 // Reinitialize the IPv4 packet with new content.
 //----------------------------------------------------------------------------
 
-bool ts::IPPacket::reset(const void* data, size_t size)
+bool ts::IPPacket::reset(const void* data, size_t size, bool copy)
 {
     // Clear previous content.
     clear();
@@ -108,7 +192,14 @@ bool ts::IPPacket::reset(const void* data, size_t size)
     }
 
     // Packet is valid.
-    _data.copy(data, size);
+    if (copy) {
+        _data.copy(data, size);
+        _addr = _data.data();
+    }
+    else {
+        _addr = ip;
+    }
+    _size = size;
     return _valid = true;
 }
 
@@ -120,8 +211,8 @@ bool ts::IPPacket::reset(const void* data, size_t size)
 bool ts::IPPacket::fragmented() const
 {
     return _valid && _source.generation() == IP::v4 && (
-        (_data[IPv4_FRAGMENT_OFFSET] & 0x20) != 0 ||                      // "More Fragments" bit set
-        (GetUInt16BE(_data.data() + IPv4_FRAGMENT_OFFSET) & 0x1FFF) != 0  // "Fragment Offset" not zero
+        (_addr[IPv4_FRAGMENT_OFFSET] & 0x20) != 0 ||                      // "More Fragments" bit set
+        (GetUInt16BE(_addr + IPv4_FRAGMENT_OFFSET) & 0x1FFF) != 0  // "Fragment Offset" not zero
     );
 }
 
@@ -132,27 +223,27 @@ bool ts::IPPacket::fragmented() const
 
 uint32_t ts::IPPacket::tcpSequenceNumber() const
 {
-    return isTCP() ? GetUInt32BE(&_data[_ip_header_size + TCP_SEQUENCE_OFFSET]) : 0;
+    return isTCP() ? GetUInt32BE(_addr + _ip_header_size + TCP_SEQUENCE_OFFSET) : 0;
 }
 
 bool ts::IPPacket::tcpSYN() const
 {
-    return isTCP() && (_data[_ip_header_size + TCP_FLAGS_OFFSET] & 0x02) != 0;
+    return isTCP() && (_addr[_ip_header_size + TCP_FLAGS_OFFSET] & 0x02) != 0;
 }
 
 bool ts::IPPacket::tcpACK() const
 {
-    return isTCP() && (_data[_ip_header_size + TCP_FLAGS_OFFSET] & 0x10) != 0;
+    return isTCP() && (_addr[_ip_header_size + TCP_FLAGS_OFFSET] & 0x10) != 0;
 }
 
 bool ts::IPPacket::tcpRST() const
 {
-    return isTCP() && (_data[_ip_header_size + TCP_FLAGS_OFFSET] & 0x04) != 0;
+    return isTCP() && (_addr[_ip_header_size + TCP_FLAGS_OFFSET] & 0x04) != 0;
 }
 
 bool ts::IPPacket::tcpFIN() const
 {
-    return isTCP() && (_data[_ip_header_size + TCP_FLAGS_OFFSET] & 0x01) != 0;
+    return isTCP() && (_addr[_ip_header_size + TCP_FLAGS_OFFSET] & 0x01) != 0;
 }
 
 
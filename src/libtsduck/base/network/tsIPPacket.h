@@ -41,19 +41,60 @@ namespace ts {
         //!
         IPPacket(const void* data, size_t size);
 
+        //!
+        //! Copy constructor.
+        //! The packet data are always copied in this object, even if @a other references external data.
+        //! @param [in] other Other instance to copy.
+        //!
+        IPPacket(const IPPacket& other);
+
+        //!
+        //! Move constructor.
+        //! When @a other references external data, this object references the same data.
+        //! @param [in,out] other Other instance to move.
+        //!
+        IPPacket(IPPacket&& other) noexcept;
+
+        //!
+        //! Assignment operator.
+        //! The packet data are always copied in this object, even if @a other references external data.
+        //! @param [in] other Other instance to copy.
+        //! @return A reference to this object.
+        //!
+        IPPacket& operator=(const IPPacket& other);
+
+        //!
+        //! Move assignment operator.
+        //! When @a other references external data, this object references the same data.
+        //! @param [in,out] other Other instance to move.
+        //! @return A reference to this object.
+        //!
+        IPPacket& operator=(IPPacket&& other) noexcept;
+
         //!
         //! Reinitialize the IP4 packet with new content.
         //! @param [in] data Address of the IP packet data.
         //! @param [in] size Size of the IP packet data.
+        //! @param [in] copy If true (the default), the packet data are copied in this object.
+        //! If false, this object references the packet data without copy. In that case,
+        //! the caller must ensure that the memory area remains valid and unmodified
+        //! as long as this object is used (or until the next reset()).
         //! @return True on success, false if the packet is invalid.
         //!
-        bool reset(const void* data, size_t size);
+        bool reset(const void* data, size_t size, bool copy = true);
 
         //!
         //! Clear the packet content.
         //!
         void clear();
 
+        //!
+        //! Check if the packet data are copied in this object or referenced.
+        //! @return True if the packet is valid and references external data without copy.
+        //! @see reset()
+        //!
+        bool isReference() const { return _valid && _data.empty(); }
+
         //!
         //! Check if the IPv4 packet is valid.
         //! @return True if the packet is valid, false otherwise.
@@ -88,19 +129,19 @@ namespace ts {
         //! Get the address of the IP packet content.
         //! @return The address of the IP packet content or a null pointer if the packet is invalid.
         //!
-        const uint8_t* data() const { return _valid ? _data.data() : nullptr; }
+        const uint8_t* data() const { return _valid ? _addr : nullptr; }
 
         //!
         //! Get the size in bytes of the IP packet content.
         //! @return The size in bytes of the IP packet content.
         //!
-        size_t size() const { return _valid ? _data.size() : 0; }
+        size_t size() const { return _valid ? _size : 0; }
 
         //!
         //! Get the address of the IP header.
         //! @return The address of the IP header or a null pointer if the packet is invalid.
         //!
-        const uint8_t* ipHeader() const { return _valid ? _data.data() : nullptr; }
+        const uint8_t* ipHeader() const { return _valid ? _addr : nullptr; }
 
         //!
         //! Get the size in bytes of the IP header.
@@ -112,7 +153,7 @@ namespace ts {
         //! Get the address of the sub-protocol header (TCP header, UDP header, etc).
         //! @return The address of the sub-protocol header or a null pointer if the packet is invalid.
         //!
-        const uint8_t* protocolHeader() const { return _valid ? _data.data() + _ip_header_size : nullptr; }
+        const uint8_t* protocolHeader() const { return _valid ? _addr + _ip_header_size : nullptr; }
 
         //!
         //! Get the size in bytes of the sub-protocol header (TCP header, UDP header, etc).
@@ -124,13 +165,13 @@ namespace ts {
         //! Get the address of the sub-protocol payload data (TCP data, UDP data, etc).
         //! @return The address of the sub-protocol header payload data or a null pointer if the packet is invalid.
         //!
-        const uint8_t* protocolData() const { return _valid ? _data.data() + _ip_header_size + _proto_header_size : nullptr; }
+        const uint8_t* protocolData() const { return _valid ? _addr + _ip_header_size + _proto_header_size : nullptr; }
 
         //!
         //! Get the size in bytes of the sub-protocol payload data (TCP data, UDP data, etc).
         //! @return The size in bytes of the sub-protocol payload data.
         //!
-        size_t protocolDataSize() const { return _valid ? _data.size() - _ip_header_size - _proto_header_size : 0; }
+        size_t protocolDataSize() const { return _valid ? _size - _ip_header_size - _proto_header_size : 0; }
 
         //!
         //! Check if the IP packet is fragmented.
@@ -227,6 +268,14 @@ namespace ts {
         size_t          _proto_header_size = 0;
         IPSocketAddress _source {};
         IPSocketAddress _destination {};
-        ByteBlock       _data {};
+        const uint8_t*  _addr = nullptr;  // Packet content, either in _data or external.
+        size_t          _size = 0;
+        ByteBlock       _data {};         // Empty when the packet references external data.
+
+        // Copy the packet content of another instance in our own buffer.
+        void copyData(const IPPacket& other);
+
+        // Adjust the packet address after moving from another instance.
+        void relocate();
     };
 }
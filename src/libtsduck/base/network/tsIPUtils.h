@@ -90,6 +90,18 @@ namespace ts {
     constexpr int SYS_SOCKET_ERR_NOTCONN = ENOTCONN;
 #endif
 
+    //!
+    //! System error code value meaning "operation would block" on a non-blocking socket.
+    //! On some UNIX systems, EAGAIN and EWOULDBLOCK are distinct values. Both must be tested.
+    //!
+#if defined(DOXYGEN)
+    constexpr int SYS_SOCKET_ERR_WOULDBLOCK = platform_specific;
+#elif defined(TS_WINDOWS)
+    constexpr int SYS_SOCKET_ERR_WOULDBLOCK = WSAEWOULDBLOCK;
+#elif defined(TS_UNIX)
+    constexpr int SYS_SOCKET_ERR_WOULDBLOCK = EWOULDBLOCK;
+#endif
+
     //!
     //! Integer data type which receives the length of a struct sockaddr.
     //! Example:
@@ -12,6 +12,12 @@
 #include "tsIntegerUtils.h"
 #include "tsSysUtils.h"
 
+#if defined(TS_UNIX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/stat.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
 
 //----------------------------------------------------------------------------
 // Constructors and destructors.
@@ -29,7 +35,7 @@ ts::PcapFile::~PcapFile()
 
 bool ts::PcapFile::open(const fs::path& filename, Report& report)
 {
-    if (_in != nullptr) {
+    if (isOpen()) {
         report.error(u"already open");
         return false;
     }
@@ -53,6 +59,10 @@ bool ts::PcapFile::open(const fs::path& filename, Report& report)
         _in = &std::cin;
         _name = u"standard input";
     }
+    else if (_use_map && mapFile(filename, report)) {
+        // Memory-mapped file, no input stream.
+        _name = filename;
+    }
     else {
         _file.open(filename, std::ios::in | std::ios::binary);
         if (!_file) {
@@ -85,6 +95,51 @@ void ts::PcapFile::close()
         _file.close();
     }
     _in = nullptr;
+    if (_map_data != nullptr) {
+#if defined(TS_UNIX)
+        ::munmap(const_cast<uint8_t*>(_map_data), _map_size);
+#endif
+        _map_data = nullptr;
+        _map_size = 0;
+        _map_pos = 0;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Map a named file in memory.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFile::mapFile(const fs::path& filename, Report& report)
+{
+#if defined(TS_UNIX)
+    // Errors are not reported here, the file is then opened as a stream, with error reporting.
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    void* addr = MAP_FAILED;
+    size_t size = 0;
+    struct ::stat st;
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && uint64_t(st.st_size) <= uint64_t(std::numeric_limits<size_t>::max())) {
+        size = size_t(st.st_size);
+        addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    // The file is read once, from beginning to end.
+    ::madvise(addr, size, MADV_SEQUENTIAL);
+    _map_data = reinterpret_cast<const uint8_t*>(addr);
+    _map_size = size;
+    _map_pos = 0;
+    report.debug(u"%s mapped in memory, %'d bytes", filename, size);
+    return true;
+#else
+    // Not implemented on Windows, use input streams.
+    return false;
+#endif
 }
 
 
@@ -94,6 +149,16 @@ void ts::PcapFile::close()
 
 bool ts::PcapFile::readall(uint8_t* data, size_t size, Report& report)
 {
+    // Copy from the memory-mapped file.
+    if (_map_data != nullptr) {
+        const uint8_t* view = nullptr;
+        if (!readView(view, size, report)) {
+            return false;
+        }
+        MemCopy(data, view, size);
+        return true;
+    }
+
     // Repeatedly read until all requested bytes are read.
     while (size > 0) {
         // Read at most "size" bytes.
@@ -120,6 +185,34 @@ bool ts::PcapFile::readall(uint8_t* data, size_t size, Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Get the address of the next "size" bytes.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFile::readView(const uint8_t*& data, size_t size, Report& report)
+{
+    if (_map_data == nullptr) {
+        // Read the data in the internal buffer.
+        _buffer.resize(size);
+        data = _buffer.data();
+        return readall(_buffer.data(), size, report);
+    }
+    else if (size > _map_size - _map_pos) {
+        // Truncated file, same as end of file.
+        data = nullptr;
+        _map_pos = _file_size = _map_size;
+        return error();
+    }
+    else {
+        // Point into the memory-mapped file, no copy.
+        data = _map_data + _map_pos;
+        _map_pos += size;
+        _file_size = _map_pos;
+        return true;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Read a file header, starting from a magic which was read as big endian.
 //----------------------------------------------------------------------------
@@ -149,15 +242,16 @@ bool ts::PcapFile::readHeader(uint32_t magic, Report& report)
         case PCAPNG_MAGIC: {
             // This is a pcap-ng file. Read the complete section header, compute endianness.
             _ng = true;
-            ByteBlock header;
-            if (!readNgBlockBody(magic, header, report)) {
+            const uint8_t* header = nullptr;
+            size_t header_size = 0;
+            if (!readNgBlockBody(magic, header, header_size, report)) {
                 return error();
             }
-            if (header.size() < 16) {
+            if (header_size < 16) {
                 return error(report, u"invalid pcap-ng file, truncated section header in %s", _name);
             }
-            _major = get16(header.data() + 4);
-            _minor = get16(header.data() + 6);
+            _major = get16(header + 4);
+            _minor = get16(header + 6);
             _if.clear(); // will read interface descriptions in dedicated blocks.
             break;
         }
@@ -228,9 +322,10 @@ bool ts::PcapFile::analyzeNgInterface(const uint8_t* data, size_t size, Report&
 // Read a pcap-ng block. The 32-bit block type has already been read.
 //----------------------------------------------------------------------------
 
-bool ts::PcapFile::readNgBlockBody(uint32_t block_type, ByteBlock& body, Report& report)
+bool ts::PcapFile::readNgBlockBody(uint32_t block_type, const uint8_t*& body, size_t& body_size, Report& report)
 {
-    body.clear();
+    body = nullptr;
+    body_size = 0;
 
     // Read the first "Block Total Length" field.
     uint8_t lenfield[4];
@@ -239,17 +334,17 @@ bool ts::PcapFile::readNgBlockBody(uint32_t block_type, ByteBlock& body, Report&
     }
 
     // If the block type is Section Header, then the endianness is given by the first 4 bytes.
+    uint8_t order_field[4];
+    size_t order_size = 0;
     if (block_type == PCAPNG_SECTION_HEADER) {
         // Pcap-ng files have an endian-neutral block-type value for section header.
         // The byte order is defined by the 'byte-order magic' at the beginning of the section header block body.
-        body.resize(4);
-        if (!readall(body.data(), body.size(), report)) {
-            body.clear();
+        order_size = sizeof(order_field);
+        if (!readall(order_field, order_size, report)) {
             return error();
         }
-        const uint32_t order_magic = GetUInt32BE(body.data());
+        const uint32_t order_magic = GetUInt32BE(order_field);
         if (order_magic != PCAPNG_ORDER_BE && order_magic != PCAPNG_ORDER_LE) {
-            body.clear();
             return error(report, u"invalid pcap-ng file, unknown 'byte-order magic' 0x%X in %s", order_magic, _name);
         }
         _be = order_magic == PCAPNG_ORDER_BE;
@@ -258,26 +353,38 @@ bool ts::PcapFile::readNgBlockBody(uint32_t block_type, ByteBlock& body, Report&
     // Interpret the packet size. The packet size include 12 additional bytes
     // for the block type and the two block length fields.
     const size_t size = get32(lenfield);
-    if (size % 4 != 0 || size < 12 + body.size()) {
-        body.clear();
+    if (size % 4 != 0 || size < 12 + order_size) {
         return error(report, u"invalid pcap-ng block length %d in %s", size, _name);
     }
 
     // Read the rest of the block body.
-    const size_t start = body.size();
-    body.resize(size - 12);
-    if (!readall(body.data() + start, body.size() - start, report)) {
-        body.clear();
-        return error();
+    if (order_size == 0) {
+        if (!readView(body, size - 12, report)) {
+            body = nullptr;
+            return error();
+        }
+    }
+    else {
+        // Rare section header, rebuild a contiguous body in the internal buffer.
+        _buffer.resize(size - 12);
+        MemCopy(_buffer.data(), order_field, order_size);
+        if (!readall(_buffer.data() + order_size, _buffer.size() - order_size, report)) {
+            return error();
+        }
+        body = _buffer.data();
     }
+    body_size = size - 12;
 
     // Read and check the last "Block Total Length" field.
     if (!readall(lenfield, sizeof(lenfield), report)) {
+        body = nullptr;
+        body_size = 0;
         return error();
     }
     const size_t last_size = get32(lenfield);
     if (size != last_size) {
-        body.clear();
+        body = nullptr;
+        body_size = 0;
         return error(report, u"inconsistent pcap-ng block length in %s, leading length: %d, trailing length: %d", _name, size, last_size);
     }
     return true;
@@ -296,12 +403,12 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
     timestamp = cn::microseconds(-1);
 
     // Check that the file is open.
-    if (_in == nullptr) {
+    if (!isOpen()) {
         report.error(u"no pcap file open");
         return false;
     }
     if (_error) {
-        if (!_in->eof()) {
+        if (!atEndOfFile()) {
             report.debug(u"pcap file already in error state");
         }
         return false;
@@ -310,8 +417,9 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
     // Loop on file blocks until an IP packet is found.
     for (;;) {
 
-        // The captured packet will go there.
-        ByteBlock buffer;
+        // The captured packet is there, either in the mapped file or in the internal buffer.
+        const uint8_t* buffer = nullptr;
+        size_t buffer_size = 0;
         size_t cap_start = 0;  // captured packet start index in buffer
         size_t cap_size = 0;   // captured packet size
         size_t orig_size = 0;  // original packet size (on network)
@@ -335,25 +443,25 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
                 continue; // loop to next packet block
             }
             // Read one data block.
-            if (!readNgBlockBody(type, buffer, report)) {
+            if (!readNgBlockBody(type, buffer, buffer_size, report)) {
                 return error();
             }
             if (type == PCAPNG_INTERFACE_DESC) {
                 // Process an interface description.
-                if (!analyzeNgInterface(buffer.data(), buffer.size(), report)) {
+                if (!analyzeNgInterface(buffer, buffer_size, report)) {
                     return error();
                 }
                 continue; // loop to next packet block
             }
-            else if ((type == PCAPNG_ENHANCED_PACKET || type == PCAPNG_OBSOLETE_PACKET) && buffer.size() >= 20) {
+            else if ((type == PCAPNG_ENHANCED_PACKET || type == PCAPNG_OBSOLETE_PACKET) && buffer_size >= 20) {
                 _packet_count++;
                 cap_start = 20;
-                cap_size = std::min<size_t>(get32(buffer.data() + 12), buffer.size() - 20);
-                orig_size = get32(buffer.data() + 16);
-                if_index = type == PCAPNG_OBSOLETE_PACKET ? get16(buffer.data()) : get32(buffer.data());
+                cap_size = std::min<size_t>(get32(buffer + 12), buffer_size - 20);
+                orig_size = get32(buffer + 16);
+                if_index = type == PCAPNG_OBSOLETE_PACKET ? get16(buffer) : get32(buffer);
                 if (if_index < _if.size() && _if[if_index].time_units != 0) {
                     const std::intmax_t units = _if[if_index].time_units;
-                    const std::intmax_t tstamp = std::intmax_t(uint64_t(get32(buffer.data() + 4)) << 32) + get32(buffer.data() + 8);
+                    const std::intmax_t tstamp = std::intmax_t(uint64_t(get32(buffer + 4)) << 32) + get32(buffer + 8);
                     // Take care to overflow in tstamp. Sometimes, the timestamp is a full time since 1970
                     // with time unit being 1,000,000,000. The value is close to the 64-bit max.
                     if (units == std::micro::den) {
@@ -373,11 +481,11 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
                     }
                 }
             }
-            else if (type == PCAPNG_SIMPLE_PACKET && buffer.size() >= 4) {
+            else if (type == PCAPNG_SIMPLE_PACKET && buffer_size >= 4) {
                 _packet_count++;
                 cap_start = 4;
-                orig_size = get32(buffer.data());
-                cap_size = std::min(orig_size, buffer.size() - 4);
+                orig_size = get32(buffer);
+                cap_size = std::min(orig_size, buffer_size - 4);
             }
             else {
                 // This data block does not contain a captured packet, ignore it.
@@ -386,11 +494,11 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
         }
         else {
             // Pcap file, beginning of a packet block. Read the 16-byte header.
-            _packet_count++;
-            uint8_t header[16];
-            if (!readall(header, sizeof(header), report)) {
+            const uint8_t* header = nullptr;
+            if (!readView(header, 16, report)) {
                 return error();
             }
+            _packet_count++;
             const uint32_t tstamp = get32(header);
             const uint32_t sub_tstamp = get32(header + 4);
             cap_size = get32(header + 8);
@@ -402,8 +510,8 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
                 cn::microseconds((cn::microseconds::rep(tstamp) * std::micro::den) + (cn::microseconds::rep(sub_tstamp) * std::micro::den) / _if[0].time_units);
 
             // Read packet data.
-            buffer.resize(cap_size);
-            if (!readall(buffer.data(), buffer.size(), report)) {
+            buffer_size = cap_size;
+            if (!readView(buffer, buffer_size, report)) {
                 return error();
             }
         }
@@ -429,7 +537,7 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
         }
 
         report.log(2, u"pcap data block: %d bytes, captured packet at offset %d, %d bytes (original: %d bytes), link type: %d",
-                   buffer.size(), cap_start, cap_size, orig_size, ifd.link_type);
+                   buffer_size, cap_start, cap_size, orig_size, ifd.link_type);
 
         // With LINKTYPE_NULL and LINKTYPE_LOOP, the standard says that there is a 4-byte header with a protocol type.
         // However, in some pcap files (not pcap-ng), it has been noticed that LINKTYPE_NULL and LINKTYPE_LOOP can
@@ -440,11 +548,11 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
         if (cap_size >= 4) {
             if (ifd.link_type == LINKTYPE_NULL) {
                 // BSD loopback encapsulation; the link layer header is a 4-byte field, in host byte order.
-                bsd_proto = get32(buffer.data() + cap_start);
+                bsd_proto = get32(buffer + cap_start);
             }
             else if (ifd.link_type == LINKTYPE_LOOP) {
                 // OpenBSD loopback encapsulation; the link-layer header is a 4-byte field, in network byte order.
-                bsd_proto = GetUInt32BE(buffer.data() + cap_start);
+                bsd_proto = GetUInt32BE(buffer + cap_start);
             }
         }
 
@@ -460,7 +568,7 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
             // This should apply to LINKTYPE_ETHERNET only. However, in some pcap files (not pcap-ng), it has been noticed that
             // LINKTYPE_NULL and LINKTYPE_LOOP can contain a raw Ethernet frame without the initial 4 bytes of encapsulation.
             // Get the EtherType, skip the Ethernet header, remove the trailing FCS byte.
-            uint16_t ether_type = GetUInt16BE(buffer.data() + cap_start + ETHER_TYPE_OFFSET);
+            uint16_t ether_type = GetUInt16BE(buffer + cap_start + ETHER_TYPE_OFFSET);
             cap_start += ETHER_HEADER_SIZE;
             cap_size -= ETHER_HEADER_SIZE + ifd.fcs_size;
             // Loop on all forms of VLAN encapsulation, until we get the inner packet.
@@ -468,8 +576,8 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
                 if ((ether_type == ETHERTYPE_802_1Q || ether_type == ETHERTYPE_802_1AD) && cap_size >= 4) {
                     // IEEE 802.1Q or IEEE 802.1ad VLAN encapsulation.
                     // Followed by 4 bytes: 2-byte flags and VLAN id, 2-byte next EtherType.
-                    ether_type = GetUInt16BE(buffer.data() + cap_start + 2);
-                    vlans.push_back({ether_type, uint32_t(GetUInt16BE(buffer.data() + cap_start) & 0x0FFF)});
+                    ether_type = GetUInt16BE(buffer + cap_start + 2);
+                    vlans.push_back({ether_type, uint32_t(GetUInt16BE(buffer + cap_start) & 0x0FFF)});
                     cap_start += 4;
                     cap_size -= 4;
                 }
@@ -477,8 +585,8 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
                     // MAC in MAC (MIM), Provider Backbone Bridges VLAN encapsulation, IEEE 802.1ah.
                     // Followed by 18 bytes: 4-byte flags and Service id, 6-byte customer destination MAC,
                     // 6-byte customer source MAC, 2-byte next EtherType.
-                    ether_type = GetUInt16BE(buffer.data() + cap_start + 16);
-                    vlans.push_back({ether_type, uint32_t(GetUInt24BE(buffer.data() + cap_start + 1) & 0x0FFF)});
+                    ether_type = GetUInt16BE(buffer + cap_start + 16);
+                    vlans.push_back({ether_type, uint32_t(GetUInt24BE(buffer + cap_start + 1) & 0x0FFF)});
                     cap_start += 18;
                     cap_size -= 18;
                 }
@@ -503,7 +611,8 @@ bool ts::PcapFile::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds
 
         // A possible IP datagram was found.
         if (cap_size > 0) {
-            if (packet.reset(buffer.data() + cap_start, cap_size)) {
+            // When the file is memory-mapped, the packet references the file content, without copy.
+            if (packet.reset(buffer + cap_start, cap_size, _map_data == nullptr)) {
                 _ip_packet_count++;
                 _ip_packets_size += cap_size;
                 return true;
@@ -16,6 +16,7 @@
 #include "tsMemory.h"
 #include "tsTime.h"
 #include "tsIPPacket.h"
+#include "tsByteBlock.h"
 #include "tsPcap.h"
 
 namespace ts {
@@ -27,6 +28,10 @@ namespace ts {
     //! This class reads a pcap or pcapng file and extracts IP frames (IPv4 or IPv6).
     //! All metadata and all other types of frames are ignored.
     //!
+    //! By default, the file is read sequentially. Optionally (see setMemoryMapping()),
+    //! a named regular file is mapped in memory and the IP packets which are returned
+    //! by readIP() reference the mapped file content, without copy.
+    //!
     //! @see https://tools.ietf.org/pdf/draft-gharris-opsawg-pcap-02.pdf (PCAP)
     //! @see https://datatracker.ietf.org/doc/draft-gharris-opsawg-pcap/ (PCAP tracker)
     //! @see https://tools.ietf.org/pdf/draft-tuexen-opsawg-pcapng-04.pdf (PCAP-ng)
@@ -58,7 +63,28 @@ namespace ts {
         //! Check if the file is open.
         //! @return True if the file is open, false otherwise.
         //!
-        bool isOpen() const { return _in != nullptr; }
+        bool isOpen() const { return _in != nullptr || _map_data != nullptr; }
+
+        //!
+        //! Specify if the next files shall be mapped in memory, when possible.
+        //! This is not the default. Memory mapping is not used on standard input or on special files.
+        //!
+        //! A mapped file must remain unchanged while it is read. A file which is still being
+        //! written (a live capture for instance) is read only up to its size when it was opened.
+        //! If the file is truncated while it is mapped, the process may crash (SIGBUS on UNIX).
+        //! With sequential reads (the default), a growing file is read until its current end
+        //! and a truncated file is seen as a premature end of file.
+        //!
+        //! @param [in] on If true, map the files in memory when possible. If false, always read the file sequentially.
+        //! Must be called before open().
+        //!
+        void setMemoryMapping(bool on) { _use_map = on; }
+
+        //!
+        //! Check if the current file is mapped in memory.
+        //! @return True if the current file is mapped in memory.
+        //!
+        bool isMemoryMapped() const { return _map_data != nullptr; }
 
         //!
         //! Get the file name.
@@ -71,6 +97,9 @@ namespace ts {
         //! Read the next IP packet, IPv4 or IPv6, headers included.
         //! Skip intermediate metadata and other types of packets.
         //!
+        //! When the file is mapped in memory, the returned IP packet references the mapped
+        //! file content, without copy. In that case, the packet remains valid until close().
+        //!
         //! @param [out] packet Received IP packet.
         //! @param [out] vlans Stack of VLAN encapsulation from which the packet is extracted.
         //! @param [out] timestamp Capture timestamp in microseconds since Unix epoch or -1 if none is available.
@@ -171,8 +200,13 @@ namespace ts {
         };
 
         bool             _error = false;          // Error was set, may be logical error, not a file error.
+        bool             _use_map = false;        // Map files in memory when possible.
         std::istream*    _in = nullptr;           // Point to actual input stream.
         std::ifstream    _file {};                // Input file (when it is a named file).
+        const uint8_t*   _map_data = nullptr;     // Base address of the mapped file, when memory-mapped.
+        size_t           _map_size = 0;           // Size of the mapped file.
+        size_t           _map_pos = 0;            // Current read position in the mapped file.
+        ByteBlock        _buffer {};              // Read buffer, when not memory-mapped.
         UString          _name {};                // Saved file name for messages.
         bool             _be = false;             // The file use a big-endian representation.
         bool             _ng = false;             // Pcapng format (not pcap).
@@ -200,9 +234,19 @@ namespace ts {
             return error();
         }
 
+        // Map a named file in memory. Return false if the file cannot be mapped (not an error).
+        bool mapFile(const fs::path& filename, Report& report);
+
+        // Check if the end of file was reached.
+        bool atEndOfFile() const { return _map_data != nullptr ? _map_pos >= _map_size : _in != nullptr && _in->eof(); }
+
         // Read exactly "size" bytes. Return false if not enough bytes before eof.
         bool readall(uint8_t* data, size_t size, Report& report);
 
+        // Get the address of the next "size" bytes, without copy when memory-mapped, in _buffer otherwise.
+        // The returned address is valid until the next read operation.
+        bool readView(const uint8_t*& data, size_t size, Report& report);
+
         // Read a file / section header, starting from a magic number which was read as big endian.
         bool readHeader(uint32_t magic, Report& report);
 
@@ -211,8 +255,8 @@ namespace ts {
 
         // Read a pcap-ng block. The 32-bit block type has already been read.
         // Start at "Block total length". Read complete block, including the two length fields.
-        // Return only the block body.
-        bool readNgBlockBody(uint32_t block_type, ByteBlock& body, Report& report);
+        // Return only the block body, valid until the next read operation.
+        bool readNgBlockBody(uint32_t block_type, const uint8_t*& body, size_t& body_size, Report& report);
 
         // Read 32 or 16 bits using the endianness.
         uint16_t get16(const void* addr) const { return _be ? GetUInt16BE(addr) : GetUInt16LE(addr); }
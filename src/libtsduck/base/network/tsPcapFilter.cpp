@@ -46,6 +46,14 @@ void ts::PcapFilter::defineArgs(Args& args)
     args.help(u"last-date", u"date-time",
          u"Filter packets up to the specified date. Use format YYYY/MM/DD:hh:mm:ss.mmm.");
 
+    args.option(u"memory-map");
+    args.help(u"memory-map",
+              u"Map the pcap file in memory instead of reading it. "
+              u"This is faster on large files but the file must remain unchanged while it is read. "
+              u"A file which is still being written is read only up to its size at the time it is opened. "
+              u"The process may crash if the file is truncated in the meantime. "
+              u"This option is ignored on standard input and on non-regular files.");
+
     args.option(u"vlan-id", 0, Args::UINT32, 0, Args::UNLIMITED_COUNT);
     args.help(u"vlan-id",
               u"Filter packets from the specified VLAN id. "
@@ -91,6 +99,7 @@ bool ts::PcapFilter::loadArgs(DuckContext& duck, Args& args)
     args.getChronoValue(_opt_last_time_offset, u"last-timestamp", cn::microseconds::max());
     _opt_first_time = getDate(args, u"first-date", cn::microseconds::zero());
     _opt_last_time = getDate(args, u"last-date", cn::microseconds::max());
+    setMemoryMapping(args.present(u"memory-map"));
 
     std::vector<uint32_t> ids;
     args.getIntValues(ids, u"vlan-id");
@@ -109,23 +118,27 @@ bool ts::PcapFilter::loadArgs(DuckContext& duck, Args& args)
 
 void ts::PcapFilter::setProtocolFilterTCP()
 {
+    _flows.clear();
     _protocols.clear();
     _protocols.insert(IP_SUBPROTO_TCP);
 }
 
 void ts::PcapFilter::setProtocolFilterUDP()
 {
+    _flows.clear();
     _protocols.clear();
     _protocols.insert(IP_SUBPROTO_UDP);
 }
 
 void ts::PcapFilter::setProtocolFilter(const std::set<uint8_t>& protocols)
 {
+    _flows.clear();
     _protocols = protocols;
 }
 
 void ts::PcapFilter::clearProtocolFilter()
 {
+    _flows.clear();
     _protocols.clear();
 }
 
@@ -136,18 +149,21 @@ void ts::PcapFilter::clearProtocolFilter()
 
 void ts::PcapFilter::setSourceFilter(const IPSocketAddress& addr)
 {
+    _flows.clear();
     _source = addr;
     _bidirectional_filter = false;
 }
 
 void ts::PcapFilter::setDestinationFilter(const IPSocketAddress& addr)
 {
+    _flows.clear();
     _destination = addr;
     _bidirectional_filter = false;
 }
 
 void ts::PcapFilter::setBidirectionalFilter(const IPSocketAddress& addr1, const IPSocketAddress& addr2)
 {
+    _flows.clear();
     _source = addr1;
     _destination = addr2;
     _bidirectional_filter = true;
@@ -155,6 +171,7 @@ void ts::PcapFilter::setBidirectionalFilter(const IPSocketAddress& addr1, const
 
 void ts::PcapFilter::setWildcardFilter(bool on)
 {
+    _flows.clear();
     _wildcard_filter = on;
 }
 
@@ -181,6 +198,40 @@ const ts::IPSocketAddress& ts::PcapFilter::otherFilter(const IPSocketAddress& ad
 }
 
 
+//----------------------------------------------------------------------------
+// Compute the protocol and address filtering decision of a flow.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFilter::matchFlow(uint8_t protocol, const IPSocketAddress& src, const IPSocketAddress& dst) const
+{
+    return (_protocols.empty() || _protocols.contains(protocol)) &&
+           ((src.match(_source) && dst.match(_destination)) || (_bidirectional_filter && src.match(_destination) && dst.match(_source)));
+}
+
+
+//----------------------------------------------------------------------------
+// Identification of a flow.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFilter::FlowKey::match(uint8_t proto, const IPSocketAddress& src, const IPSocketAddress& dst) const
+{
+    return protocol == proto && source == src && destination == dst;
+}
+
+bool ts::PcapFilter::FlowKey::operator<(const FlowKey& other) const
+{
+    if (protocol != other.protocol) {
+        return protocol < other.protocol;
+    }
+    else if (!(source == other.source)) {
+        return source < other.source;
+    }
+    else {
+        return destination < other.destination;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Open the file, inherited method.
 //----------------------------------------------------------------------------
@@ -191,6 +242,7 @@ bool ts::PcapFilter::open(const fs::path& filename, Report& report)
     const bool ok = PcapFile::open(filename, report);
     if (ok) {
         // Reinitialize filters.
+        _flows.clear();
         _protocols.clear();
         _source.clear();
         _destination.clear();
@@ -229,8 +281,7 @@ bool ts::PcapFilter::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microsecon
         }
 
         // Check if the packet matches all general filters.
-        if ((!_protocols.empty() && !_protocols.contains(packet.protocol())) ||
-            packetCount() < _first_packet ||
+        if (packetCount() < _first_packet ||
             timestamp < _first_time ||
             timeOffset(timestamp) < _first_time_offset ||
             !vlans.match(_opt_vlans))
@@ -240,33 +291,47 @@ bool ts::PcapFilter::readIP(IPPacket& packet, VLANIdStack& vlans, cn::microsecon
         }
 
         // Is there any unspecified field in current stream addresses (act as wildcard)?
-        const IPSocketAddress src(packet.source());
-        const IPSocketAddress dst(packet.destination());
-        const bool unspecified = !_wildcard_filter && !addressFilterIsSet();
-        bool display_filter = false;
-
-        // Check if the IP packet belongs to the filtered session.
-        // By default, _source and _destination are empty and match everything.
-        if (src.match(_source) && dst.match(_destination)) {
-            if (unspecified) {
+        const IPSocketAddress& src(packet.source());
+        const IPSocketAddress& dst(packet.destination());
+
+        if (_wildcard_filter || addressFilterIsSet()) {
+            // The filters are stable, use the cached decision for this flow.
+            // Most of the time, consecutive packets belong to the same flow.
+            if (_flows.empty() || !_last_flow->first.match(packet.protocol(), src, dst)) {
+                FlowKey key(packet.protocol(), src, dst);
+                _last_flow = _flows.find(key);
+                if (_last_flow == _flows.end()) {
+                    if (_flows.size() >= MAX_FLOWS) {
+                        _flows.clear();
+                    }
+                    const bool match = matchFlow(packet.protocol(), src, dst);
+                    _last_flow = _flows.emplace(std::move(key), match).first;
+                }
+            }
+            if (!_last_flow->second) {
+                // Not a packet from the filtered protocols or session.
+                continue;
+            }
+        }
+        else {
+            // Check if the IP packet belongs to the filtered session. The first matching packet sets the filter.
+            if (!_protocols.empty() && !_protocols.contains(packet.protocol())) {
+                continue;
+            }
+            else if (src.match(_source) && dst.match(_destination)) {
                 _source = src;
                 _destination = dst;
-                display_filter = true;
             }
-        }
-        else if (_bidirectional_filter && src.match(_destination) && dst.match(_source)) {
-            if (unspecified) {
+            else if (_bidirectional_filter && src.match(_destination) && dst.match(_source)) {
                 _source = dst;
                 _destination = src;
-                display_filter = true;
             }
-        }
-        else {
-            // Not a packet from that TCP session.
-            continue;
-        }
-
-        if (display_filter) {
+            else {
+                // Not a packet from that TCP session.
+                continue;
+            }
+            // The filter is now set, the previous decisions are obsolete.
+            _flows.clear();
             report.log(_display_addresses_severity, u"selected stream %s %s %s", _source, _bidirectional_filter ? u"<->" : u"->", _destination);
         }
 
@@ -25,6 +25,10 @@ namespace ts {
     //! This class also sets filtering options from the command line:
     //! @c -\-first-packet, @c -\-first-timestamp, @c -\-first-date, @c -\-last-packet, @c -\-last-timestamp, @c -\-last-date.
     //!
+    //! The protocol and address filtering only depends on the flow of the packet (protocol,
+    //! source and destination socket addresses). The filtering decision is computed once
+    //! per flow and cached.
+    //!
     //! @ingroup net
     //!
     class TSDUCKDLL PcapFilter: public PcapFile
@@ -221,6 +225,26 @@ namespace ts {
         virtual bool readIP(IPPacket& packet, VLANIdStack& vlans, cn::microseconds& timestamp, Report& report) override;
 
     private:
+        // Identification of a flow: protocol, source, destination.
+        // Not a std::tuple: the comparison of tuples would use the operator<=> of the base
+        // interface classes of IPSocketAddress instead of IPSocketAddress::operator<.
+        class FlowKey
+        {
+        public:
+            uint8_t         protocol;
+            IPSocketAddress source;
+            IPSocketAddress destination;
+            FlowKey(uint8_t proto, const IPSocketAddress& src, const IPSocketAddress& dst) : protocol(proto), source(src), destination(dst) {}
+            bool match(uint8_t proto, const IPSocketAddress& src, const IPSocketAddress& dst) const;
+            bool operator<(const FlowKey& other) const;
+        };
+        using FlowMap = std::map<FlowKey, bool>;
+
+        // Maximum number of cached flow decisions. The cache is reset when it is full.
+        static constexpr size_t MAX_FLOWS = 10'000;
+
+        FlowMap           _flows {};             // Cached filtering decisions per flow.
+        FlowMap::const_iterator _last_flow {};   // Last used flow in _flows, valid when _flows is not empty.
         std::set<uint8_t> _protocols {};
         IPSocketAddress   _source {};
         IPSocketAddress   _destination {};
@@ -241,6 +265,9 @@ namespace ts {
         cn::microseconds  _opt_last_time = cn::microseconds::max();
         VLANIdStack       _opt_vlans {};
 
+        // Compute the protocol and address filtering decision of a flow, in wildcard mode or once the filter is set.
+        bool matchFlow(uint8_t protocol, const IPSocketAddress& src, const IPSocketAddress& dst) const;
+
         // Get a date option and return it as micro-seconds since Unix epoch.
         cn::microseconds getDate(Args& args, const ts::UChar* arg_name, cn::microseconds def_value);
     };
@@ -171,6 +171,32 @@ bool ts::Socket::setReceiveTimeout(cn::milliseconds timeout, Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Set the non-blocking mode.
+//----------------------------------------------------------------------------
+
+bool ts::Socket::setNonBlocking(bool on, Report& report)
+{
+    report.debug(u"setting socket non-blocking mode to %s", on);
+
+#if defined(TS_WINDOWS)
+    ::u_long param = on ? 1 : 0;
+    if (::ioctlsocket(_sock, FIONBIO, &param) != 0) {
+        report.error(u"error setting socket non-blocking mode: %s", SysErrorCodeMessage());
+        return false;
+    }
+#else
+    const int flags = ::fcntl(_sock, F_GETFL, 0);
+    if (flags < 0 || ::fcntl(_sock, F_SETFL, on ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK)) < 0) {
+        report.error(u"error setting socket non-blocking mode: %s", SysErrorCodeMessage());
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Set the "reuse port" option.
 //----------------------------------------------------------------------------
@@ -87,6 +87,15 @@ namespace ts {
         //!
         bool setReceiveTimeout(cn::milliseconds timeout, Report& report = CERR);
 
+        //!
+        //! Set the non-blocking mode of the socket.
+        //! In non-blocking mode, I/O operations never wait. This is typically used with a SocketReactor.
+        //! @param [in] on If true, set the socket in non-blocking mode. If false, restore the blocking mode.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool setNonBlocking(bool on, Report& report = CERR);
+
         //!
         //! Set the "reuse port" option.
         //! @param [in] reuse_port If true, the socket is allowed to reuse a local
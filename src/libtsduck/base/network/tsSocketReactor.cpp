@@ -0,0 +1,450 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsSocketReactor.h"
+#include "tsSysUtils.h"
+#include "tsNullReport.h"
+#include "tsMemory.h"
+
+#if defined(TS_LINUX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include "tsAfterStandardHeaders.h"
+#elif defined(TS_UNIX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <poll.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+// Without wake-up descriptor on Windows, the wait for events is periodically interrupted.
+#if defined(TS_WINDOWS)
+    static constexpr cn::milliseconds MAX_POLL_TIME = cn::milliseconds(10);
+#endif
+
+// Maximum number of events to process in one epoll_wait().
+#if defined(TS_LINUX)
+    static constexpr int MAX_EPOLL_EVENTS = 256;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::SocketReactor::SocketReactor()
+{
+}
+
+ts::SocketReactor::~SocketReactor()
+{
+    close(NULLREP);
+}
+
+ts::SocketReactorHandlerInterface::~SocketReactorHandlerInterface()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Open / close the reactor.
+//----------------------------------------------------------------------------
+
+bool ts::SocketReactor::open(Report& report)
+{
+    if (_is_open) {
+        report.error(u"socket reactor already open");
+        return false;
+    }
+
+#if defined(TS_LINUX)
+    _epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll_fd < 0) {
+        report.error(u"error creating epoll: %s", SysErrorCodeMessage());
+        return false;
+    }
+    _event_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_event_fd < 0) {
+        report.error(u"error creating eventfd: %s", SysErrorCodeMessage());
+        ::close(_epoll_fd);
+        _epoll_fd = -1;
+        return false;
+    }
+    ::epoll_event ev;
+    TS_ZERO(ev);
+    ev.events = EPOLLIN;
+    ev.data.fd = _event_fd;
+    if (::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _event_fd, &ev) < 0) {
+        report.error(u"error adding eventfd in epoll: %s", SysErrorCodeMessage());
+        ::close(_event_fd);
+        ::close(_epoll_fd);
+        _event_fd = _epoll_fd = -1;
+        return false;
+    }
+#elif defined(TS_UNIX)
+    if (::pipe(_wake_fds) < 0) {
+        report.error(u"error creating pipe: %s", SysErrorCodeMessage());
+        return false;
+    }
+    for (int fd : _wake_fds) {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+#endif
+
+    _stop_requested = false;
+    _is_open = true;
+    return true;
+}
+
+bool ts::SocketReactor::close(Report& report)
+{
+    if (_is_open) {
+#if defined(TS_LINUX)
+        ::close(_event_fd);
+        ::close(_epoll_fd);
+        _event_fd = _epoll_fd = -1;
+#elif defined(TS_UNIX)
+        ::close(_wake_fds[0]);
+        ::close(_wake_fds[1]);
+        _wake_fds[0] = _wake_fds[1] = -1;
+#endif
+        _sockets.clear();
+        std::lock_guard<std::mutex> lock(_mutex);
+        _posted.clear();
+        _timers = TimerQueue();
+        _is_open = false;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Management of registered sockets.
+//----------------------------------------------------------------------------
+
+#if defined(TS_LINUX)
+namespace {
+    uint32_t EpollEvents(ts::SocketEvents events)
+    {
+        uint32_t ev = EPOLLRDHUP;
+        if (bool(events & ts::SocketEvents::READ)) {
+            ev |= EPOLLIN;
+        }
+        if (bool(events & ts::SocketEvents::WRITE)) {
+            ev |= EPOLLOUT;
+        }
+        return ev;
+    }
+}
+#endif
+
+bool ts::SocketReactor::add(SysSocketType sock, SocketReactorHandlerInterface* handler, SocketEvents events, Report& report)
+{
+    if (!_is_open || sock == SYS_SOCKET_INVALID || handler == nullptr) {
+        report.error(u"invalid socket reactor registration");
+        return false;
+    }
+    if (_sockets.contains(sock)) {
+        report.error(u"socket already registered in reactor");
+        return false;
+    }
+
+#if defined(TS_LINUX)
+    ::epoll_event ev;
+    TS_ZERO(ev);
+    ev.events = EpollEvents(events);
+    ev.data.fd = sock;
+    if (::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, sock, &ev) < 0) {
+        report.error(u"error adding socket in epoll: %s", SysErrorCodeMessage());
+        return false;
+    }
+#endif
+
+    _sockets[sock] = SocketEntry{handler, events};
+    return true;
+}
+
+bool ts::SocketReactor::modify(SysSocketType sock, SocketEvents events, Report& report)
+{
+    const auto it = _sockets.find(sock);
+    if (it == _sockets.end()) {
+        report.error(u"socket not registered in reactor");
+        return false;
+    }
+    if (it->second.events == events) {
+        // Nothing to do, avoid a system call.
+        return true;
+    }
+
+#if defined(TS_LINUX)
+    ::epoll_event ev;
+    TS_ZERO(ev);
+    ev.events = EpollEvents(events);
+    ev.data.fd = sock;
+    if (::epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, sock, &ev) < 0) {
+        report.error(u"error modifying socket in epoll: %s", SysErrorCodeMessage());
+        return false;
+    }
+#endif
+
+    it->second.events = events;
+    return true;
+}
+
+bool ts::SocketReactor::remove(SysSocketType sock, Report& report)
+{
+    const auto it = _sockets.find(sock);
+    if (it == _sockets.end()) {
+        report.error(u"socket not registered in reactor");
+        return false;
+    }
+    _sockets.erase(it);
+
+#if defined(TS_LINUX)
+    // The event structure is ignored but must be non-null with old kernels.
+    ::epoll_event ev;
+    TS_ZERO(ev);
+    if (::epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, sock, &ev) < 0) {
+        report.error(u"error removing socket from epoll: %s", SysErrorCodeMessage());
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Posted callbacks and timers.
+//----------------------------------------------------------------------------
+
+void ts::SocketReactor::post(Callback callback)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _posted.push_back(std::move(callback));
+    }
+    wakeUp();
+}
+
+void ts::SocketReactor::postAfter(cn::microseconds delay, Callback callback)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _timers.push(Timer{cn::steady_clock::now() + delay, _timer_sequence++, std::move(callback)});
+    }
+    wakeUp();
+}
+
+void ts::SocketReactor::stop()
+{
+    _stop_requested = true;
+    wakeUp();
+}
+
+void ts::SocketReactor::wakeUp()
+{
+#if defined(TS_LINUX)
+    const uint64_t one = 1;
+    [[maybe_unused]] const ssize_t ret = ::write(_event_fd, &one, sizeof(one));
+#elif defined(TS_UNIX)
+    const uint8_t one = 1;
+    [[maybe_unused]] const ssize_t ret = ::write(_wake_fds[1], &one, sizeof(one));
+#endif
+}
+
+// Execute the posted callbacks and the due timers.
+cn::milliseconds ts::SocketReactor::executeCallbacks()
+{
+    // Swap the list of posted callbacks to execute them without holding the mutex.
+    // The callbacks may post other callbacks.
+    std::vector<Callback> posted;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        posted.swap(_posted);
+    }
+    for (auto& cb : posted) {
+        cb();
+    }
+
+    // Execute all due timers.
+    for (;;) {
+        Callback cb;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_posted.empty()) {
+                // New callbacks were posted, don't wait.
+                return cn::milliseconds::zero();
+            }
+            if (_timers.empty()) {
+                return cn::milliseconds(-1);
+            }
+            const auto now = cn::steady_clock::now();
+            if (_timers.top().due > now) {
+                // Round up to the next millisecond to avoid busy loops.
+                return cn::ceil<cn::milliseconds>(_timers.top().due - now);
+            }
+            cb = std::move(const_cast<Timer&>(_timers.top()).callback);
+            _timers.pop();
+        }
+        cb();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Run the reactor.
+//----------------------------------------------------------------------------
+
+bool ts::SocketReactor::run(Report& report)
+{
+    if (!_is_open) {
+        report.error(u"socket reactor not open");
+        return false;
+    }
+
+    bool ok = true;
+    while (ok && !_stop_requested) {
+        const cn::milliseconds timeout = executeCallbacks();
+        if (!_stop_requested) {
+            ok = waitEvents(timeout, report);
+        }
+    }
+    _stop_requested = false;
+    return ok;
+}
+
+// Dispatch events on a socket.
+void ts::SocketReactor::dispatch(SysSocketType sock, SocketEvents events)
+{
+    // The socket may have been removed by a previous handler in the same loop.
+    const auto it = _sockets.find(sock);
+    if (it != _sockets.end() && events != SocketEvents::NONE) {
+        it->second.handler->handleSocketEvents(*this, sock, events);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Wait for events and dispatch them, Linux version.
+//----------------------------------------------------------------------------
+
+#if defined(TS_LINUX)
+
+bool ts::SocketReactor::waitEvents(cn::milliseconds timeout, Report& report)
+{
+    ::epoll_event events[MAX_EPOLL_EVENTS];
+    const int count = ::epoll_wait(_epoll_fd, events, MAX_EPOLL_EVENTS, timeout < cn::milliseconds::zero() ? -1 : int(timeout.count()));
+    if (count < 0) {
+        if (errno == EINTR) {
+            return true;
+        }
+        report.error(u"epoll_wait error: %s", SysErrorCodeMessage());
+        return false;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (events[i].data.fd == _event_fd) {
+            // Reset the wake-up counter.
+            uint64_t value = 0;
+            [[maybe_unused]] const ssize_t ret = ::read(_event_fd, &value, sizeof(value));
+        }
+        else {
+            SocketEvents ev = SocketEvents::NONE;
+            if ((events[i].events & (EPOLLIN | EPOLLPRI)) != 0) {
+                ev |= SocketEvents::READ;
+            }
+            if ((events[i].events & EPOLLOUT) != 0) {
+                ev |= SocketEvents::WRITE;
+            }
+            if ((events[i].events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) != 0) {
+                ev |= SocketEvents::HANGUP;
+            }
+            dispatch(events[i].data.fd, ev);
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Wait for events and dispatch them, poll() version for other systems.
+//----------------------------------------------------------------------------
+
+#else
+
+bool ts::SocketReactor::waitEvents(cn::milliseconds timeout, Report& report)
+{
+    // Build the list of polled sockets.
+    std::vector<::pollfd> fds;
+    fds.reserve(_sockets.size() + 1);
+#if defined(TS_UNIX)
+    fds.push_back(::pollfd{_wake_fds[0], POLLIN, 0});
+#endif
+    for (const auto& it : _sockets) {
+        short ev = 0;
+        if (bool(it.second.events & SocketEvents::READ)) {
+            ev |= POLLIN;
+        }
+        if (bool(it.second.events & SocketEvents::WRITE)) {
+            ev |= POLLOUT;
+        }
+        fds.push_back(::pollfd{it.first, ev, 0});
+    }
+
+#if defined(TS_WINDOWS)
+    if (timeout < cn::milliseconds::zero() || timeout > MAX_POLL_TIME) {
+        timeout = MAX_POLL_TIME;
+    }
+    if (fds.empty()) {
+        // WSAPoll() fails without socket.
+        std::this_thread::sleep_for(timeout);
+        return true;
+    }
+    const int count = ::WSAPoll(fds.data(), ::ULONG(fds.size()), int(timeout.count()));
+#else
+    const int count = ::poll(fds.data(), ::nfds_t(fds.size()), timeout < cn::milliseconds::zero() ? -1 : int(timeout.count()));
+#endif
+
+    if (count < 0) {
+#if defined(TS_UNIX)
+        if (errno == EINTR) {
+            return true;
+        }
+#endif
+        report.error(u"poll error: %s", SysErrorCodeMessage());
+        return false;
+    }
+
+    for (const auto& pfd : fds) {
+#if defined(TS_UNIX)
+        if (pfd.fd == _wake_fds[0]) {
+            // Drain the wake-up pipe.
+            uint8_t buffer[64];
+            while (::read(_wake_fds[0], buffer, sizeof(buffer)) > 0) {
+            }
+            continue;
+        }
+#endif
+        SocketEvents ev = SocketEvents::NONE;
+        if ((pfd.revents & POLLIN) != 0) {
+            ev |= SocketEvents::READ;
+        }
+        if ((pfd.revents & POLLOUT) != 0) {
+            ev |= SocketEvents::WRITE;
+        }
+        if ((pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0) {
+            ev |= SocketEvents::HANGUP;
+        }
+        dispatch(pfd.fd, ev);
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,222 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Event-driven reactor for non-blocking sockets.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsIPUtils.h"
+#include "tsReport.h"
+#include "tsEnumUtils.h"
+#include <functional>
+#include <queue>
+
+namespace ts {
+
+    class SocketReactor;
+
+    //!
+    //! Events which are monitored or signalled on a socket by a SocketReactor.
+    //! @ingroup net
+    //!
+    enum class SocketEvents : uint8_t {
+        NONE   = 0x00,  //!< No event.
+        READ   = 0x01,  //!< Socket is readable: data available, incoming connection, disconnection.
+        WRITE  = 0x02,  //!< Socket is writable: some space is available in the send buffer.
+        HANGUP = 0x04,  //!< Error or hang-up on the socket, signalled only, never monitored.
+    };
+}
+TS_ENABLE_BITMASK_OPERATORS(ts::SocketEvents);
+
+namespace ts {
+    //!
+    //! Abstract interface to receive events on sockets from a SocketReactor.
+    //! @ingroup net
+    //!
+    class TSDUCKDLL SocketReactorHandlerInterface
+    {
+        TS_INTERFACE(SocketReactorHandlerInterface);
+    public:
+        //!
+        //! Invoked by the reactor when events occur on a socket.
+        //! This handler is always invoked in the context of the thread which runs the reactor.
+        //! @param [in,out] reactor The calling reactor.
+        //! @param [in] sock The socket on which the events occured.
+        //! @param [in] events The signalled events.
+        //!
+        virtual void handleSocketEvents(SocketReactor& reactor, SysSocketType sock, SocketEvents events) = 0;
+    };
+
+    //!
+    //! Event-driven reactor for non-blocking sockets.
+    //! @ingroup net
+    //!
+    //! A reactor monitors a set of sockets and invokes handlers when they become readable or
+    //! writable. A single thread can manage thousands of connections this way, instead of using
+    //! one thread per connection. The implementation uses epoll() on Linux, poll() on other UNIX
+    //! systems, and WSAPoll() on Windows.
+    //!
+    //! All sockets and handlers are managed in the context of the thread which runs the reactor.
+    //! Other threads (typically worker threads) can interact with the reactor using post() and
+    //! stop() only. The posted callbacks are executed in the context of the reactor thread.
+    //!
+    //! The reactor also manages timers. Timers are executed in the context of the reactor thread.
+    //!
+    class TSDUCKDLL SocketReactor
+    {
+        TS_NOCOPY(SocketReactor);
+    public:
+        //!
+        //! A callback which is executed in the context of the reactor thread.
+        //!
+        using Callback = std::function<void()>;
+
+        //!
+        //! Constructor.
+        //!
+        SocketReactor();
+
+        //!
+        //! Destructor.
+        //!
+        ~SocketReactor();
+
+        //!
+        //! Open the reactor.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool open(Report& report = CERR);
+
+        //!
+        //! Close the reactor.
+        //! The registered sockets are not closed, they are simply forgotten.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool close(Report& report = CERR);
+
+        //!
+        //! Check if the reactor is open.
+        //! @return True if the reactor is open.
+        //!
+        bool isOpen() const { return _is_open; }
+
+        //!
+        //! Register a socket in the reactor.
+        //! Must be called from the reactor thread or before running the reactor.
+        //! @param [in] sock The socket to monitor. It should be in non-blocking mode.
+        //! @param [in] handler The handler to notify. Must remain valid until the socket is removed.
+        //! @param [in] events The events to monitor, READ and/or WRITE.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool add(SysSocketType sock, SocketReactorHandlerInterface* handler, SocketEvents events, Report& report = CERR);
+
+        //!
+        //! Change the set of monitored events on a registered socket.
+        //! Must be called from the reactor thread or before running the reactor.
+        //! @param [in] sock The socket to monitor.
+        //! @param [in] events The events to monitor, READ and/or WRITE.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool modify(SysSocketType sock, SocketEvents events, Report& report = CERR);
+
+        //!
+        //! Unregister a socket from the reactor.
+        //! Must be called from the reactor thread or before running the reactor.
+        //! This method must be called before closing the socket.
+        //! @param [in] sock The socket to remove.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool remove(SysSocketType sock, Report& report = CERR);
+
+        //!
+        //! Get the number of registered sockets.
+        //! @return The number of registered sockets.
+        //!
+        size_t socketCount() const { return _sockets.size(); }
+
+        //!
+        //! Post a callback to execute in the context of the reactor thread.
+        //! This method is thread-safe and can be called from any thread.
+        //! @param [in] callback The callback to execute.
+        //!
+        void post(Callback callback);
+
+        //!
+        //! Schedule a callback to execute in the context of the reactor thread after some delay.
+        //! This method is thread-safe and can be called from any thread.
+        //! @param [in] delay Delay after which the callback is executed.
+        //! @param [in] callback The callback to execute.
+        //!
+        void postAfter(cn::microseconds delay, Callback callback);
+
+        //!
+        //! Run the reactor until stop() is called or an error occurs.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success (stopped), false on error.
+        //!
+        bool run(Report& report = CERR);
+
+        //!
+        //! Request the termination of the reactor.
+        //! This method is thread-safe and can be called from any thread, including from a handler.
+        //!
+        void stop();
+
+    private:
+        // A scheduled callback.
+        struct Timer
+        {
+            cn::steady_clock::time_point due;
+            uint64_t sequence;  // Preserve submission order for identical due times.
+            Callback callback;
+            bool operator>(const Timer& other) const { return due > other.due || (due == other.due && sequence > other.sequence); }
+        };
+        using TimerQueue = std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>>;
+
+        // Description of a registered socket.
+        struct SocketEntry
+        {
+            SocketReactorHandlerInterface* handler = nullptr;
+            SocketEvents events = SocketEvents::NONE;
+        };
+
+        bool                              _is_open = false;
+        std::atomic_bool                  _stop_requested {false};
+        std::map<SysSocketType, SocketEntry> _sockets {};  // Registered sockets.
+        std::mutex                        _mutex {};       // Protect the posted callbacks and timers.
+        std::vector<Callback>             _posted {};      // Posted callbacks, to execute asap.
+        TimerQueue                        _timers {};      // Scheduled callbacks.
+        uint64_t                          _timer_sequence = 0;
+
+#if defined(TS_LINUX)
+        int _epoll_fd = -1;    // Epoll file descriptor.
+        int _event_fd = -1;    // Eventfd to wake up the reactor.
+#elif defined(TS_UNIX)
+        int _wake_fds[2] {-1, -1};   // Pipe to wake up the reactor.
+#endif
+
+        // Wake up the reactor thread when waiting for events.
+        void wakeUp();
+
+        // Execute the posted callbacks and the due timers. Return the delay until the next timer, negative if none.
+        cn::milliseconds executeCallbacks();
+
+        // Wait for events for the specified duration (negative: infinite) and dispatch them.
+        bool waitEvents(cn::milliseconds timeout, Report& report);
+
+        // Dispatch events on a socket.
+        void dispatch(SysSocketType sock, SocketEvents events);
+    };
+}
@@ -204,6 +204,97 @@ bool ts::TCPConnection::receive(void* buffer, size_t size, const AbortInterface*
 }
 
 
+//----------------------------------------------------------------------------
+// Send data on a non-blocking socket.
+//----------------------------------------------------------------------------
+
+bool ts::TCPConnection::sendSome(const void* buffer, size_t size, size_t& sent_size, Report& report)
+{
+    const char* data = reinterpret_cast<const char*>(buffer);
+    sent_size = 0;
+
+    while (sent_size < size) {
+        SysSocketSignedSizeType gone = ::send(getSocket(), SysSendBufferPointer(data + sent_size), int(size - sent_size), 0);
+        const int errcode = LastSysErrorCode();
+        if (gone > 0) {
+            assert(size_t(gone) <= size - sent_size);
+            sent_size += size_t(gone);
+        }
+#if defined(TS_UNIX)
+        else if (errcode == EINTR) {
+            // Ignore signal, retry
+            report.debug(u"send() interrupted by signal, retrying");
+        }
+        else if (errcode == EAGAIN || errcode == SYS_SOCKET_ERR_WOULDBLOCK) {
+            // Socket buffer is full, will send the rest later.
+            break;
+        }
+#else
+        else if (errcode == SYS_SOCKET_ERR_WOULDBLOCK) {
+            // Socket buffer is full, will send the rest later.
+            break;
+        }
+#endif
+        else {
+            report.error(u"error sending data to socket: %s", SysErrorCodeMessage(errcode));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Receive data on a non-blocking socket.
+//----------------------------------------------------------------------------
+
+bool ts::TCPConnection::receiveSome(void* data, size_t max_size, size_t& ret_size, Report& report)
+{
+    ret_size = 0;
+
+    // Loop on unsollicited interrupts
+    for (;;) {
+        SysSocketSignedSizeType got = ::recv(getSocket(), SysRecvBufferPointer(data), int(max_size), 0);
+        const int errcode = LastSysErrorCode();
+        if (got > 0) {
+            // Received some data
+            assert(size_t(got) <= max_size);
+            ret_size = size_t(got);
+            return true;
+        }
+        else if (got == 0 || errcode == SYS_SOCKET_ERR_RESET) {
+            // End of connection (graceful or aborted). Do not report an error.
+            declareDisconnected(report);
+            return false;
+        }
+#if defined(TS_UNIX)
+        else if (errcode == EINTR) {
+            // Ignore signal, retry
+            report.debug(u"recv() interrupted by signal, retrying");
+        }
+        else if (errcode == EAGAIN || errcode == SYS_SOCKET_ERR_WOULDBLOCK) {
+            // No data available now.
+            return true;
+        }
+#else
+        else if (errcode == SYS_SOCKET_ERR_WOULDBLOCK) {
+            // No data available now.
+            return true;
+        }
+#endif
+        else {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            if (isOpen()) {
+                // Report the error only if the error does not result from a close in another thread.
+                report.error(u"error receiving data from socket: %s", SysErrorCodeMessage(errcode));
+            }
+            return false;
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Connect to a remote address and port.
 // Use this method when acting as TCP client.
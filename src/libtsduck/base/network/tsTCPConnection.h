@@ -181,6 +181,36 @@ namespace ts {
                      const AbortInterface* abort = nullptr,
                      Report& report = CERR);
 
+        //!
+        //! Send data on a non-blocking socket.
+        //!
+        //! This version of send() returns as soon as the socket cannot accept more data.
+        //! The socket shall have been set in non-blocking mode using setNonBlocking().
+        //!
+        //! @param [in] data Address of the data to send.
+        //! @param [in] size Size in bytes of the data to send.
+        //! @param [out] sent_size Size in bytes of the data which were actually sent.
+        //! Can be less than @a size, possibly zero, when the socket buffer is full.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool sendSome(const void* data, size_t size, size_t& sent_size, Report& report = CERR);
+
+        //!
+        //! Receive data on a non-blocking socket.
+        //!
+        //! This version of receive() returns immediately with the data which are
+        //! already available, possibly none. The socket shall have been set in
+        //! non-blocking mode using setNonBlocking().
+        //!
+        //! @param [out] buffer Address of the buffer for the received data.
+        //! @param [in] max_size Size in bytes of the reception buffer.
+        //! @param [out] ret_size Size in bytes of the received data, zero if no data are available.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error or disconnection.
+        //!
+        bool receiveSome(void* buffer, size_t max_size, size_t& ret_size, Report& report = CERR);
+
     protected:
         //!
         //! This virtual method can be overriden by subclasses to be notified of connection.
@@ -106,6 +106,8 @@ bool ts::UDPSocket::close(Report& report)
     }
 
     // Close socket
+    _tx_time = false;
+    _tx_clock = TransmitClock::MONOTONIC;
     return Socket::close(report);
 }
 
@@ -316,6 +318,32 @@ bool ts::UDPSocket::setReceiveTimestamps(bool on, Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Enable the transmission of outgoing packets at a given time.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::setTransmitTime(TransmitClock clock, Report& report)
+{
+#if defined(SO_TXTIME)
+    // The clock of monotonic_time is CLOCK_MONOTONIC on Linux.
+    ::sock_txtime config;
+    TS_ZERO(config);
+    config.clockid = clock == TransmitClock::TAI ? CLOCK_TAI : CLOCK_MONOTONIC;
+    report.debug(u"setting socket SO_TXTIME, clock %s", clock == TransmitClock::TAI ? u"TAI" : u"monotonic");
+    if (::setsockopt(getSocket(), SOL_SOCKET, SO_TXTIME, &config, sizeof(config)) != 0) {
+        report.error(u"socket option SO_TXTIME: %s", SysErrorCodeMessage());
+        return false;
+    }
+    _tx_time = true;
+    _tx_clock = clock;
+    return true;
+#else
+    report.error(u"transmit time of outgoing packets is not supported on this system");
+    return false;
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Enable or disable the broadcast option.
 //----------------------------------------------------------------------------
@@ -567,6 +595,66 @@ bool ts::UDPSocket::send(const void* data, size_t size, const IPSocketAddress& d
 }
 
 
+//----------------------------------------------------------------------------
+// Send a message to the default destination at a given time.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::sendAt(const void* data, size_t size, const monotonic_time& tx_time, Report& report)
+{
+#if defined(SO_TXTIME)
+    if (_tx_time) {
+        IPSocketAddress dest(_default_destination);
+        if (!convert(dest, report)) {
+            return false;
+        }
+
+        ::sockaddr_storage addr;
+        const size_t addr_size = dest.get(addr);
+
+        ::iovec vec;
+        TS_ZERO(vec);
+        vec.iov_base = const_cast<void*>(data);
+        vec.iov_len = size;
+
+        // Ancillary data: transmit time in nanoseconds on the socket clock.
+        uint8_t ancil_data[CMSG_SPACE(sizeof(uint64_t))];
+        TS_ZERO(ancil_data);
+
+        ::msghdr hdr;
+        TS_ZERO(hdr);
+        hdr.msg_name = &addr;
+        hdr.msg_namelen = socklen_t(addr_size);
+        hdr.msg_iov = &vec;
+        hdr.msg_iovlen = 1;
+        hdr.msg_control = ancil_data;
+        hdr.msg_controllen = sizeof(ancil_data);
+
+        ::cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_TXTIME;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+        cn::nanoseconds::rep nano = cn::duration_cast<cn::nanoseconds>(tx_time.time_since_epoch()).count();
+        if (_tx_clock == TransmitClock::TAI) {
+            // Convert the monotonic time into TAI, using the current offset between the two clocks.
+            ::timespec mono, tai;
+            ::clock_gettime(CLOCK_MONOTONIC, &mono);
+            ::clock_gettime(CLOCK_TAI, &tai);
+            nano += (cn::nanoseconds::rep(tai.tv_sec) - cn::nanoseconds::rep(mono.tv_sec)) * 1'000'000'000 + (tai.tv_nsec - mono.tv_nsec);
+        }
+        const uint64_t txtime = uint64_t(nano);
+        MemCopy(CMSG_DATA(cmsg), &txtime, sizeof(txtime));
+
+        if (::sendmsg(getSocket(), &hdr, 0) < 0) {
+            report.error(u"error sending UDP message: %s", SysErrorCodeMessage());
+            return false;
+        }
+        return true;
+    }
+#endif
+    return send(data, size, _default_destination, report);
+}
+
+
 //----------------------------------------------------------------------------
 // Receive a message.
 //----------------------------------------------------------------------------
@@ -27,6 +27,15 @@
 #endif
 
 namespace ts {
+    //!
+    //! Reference clock of the transmit time of outgoing UDP packets.
+    //! @see UDPSocket::setTransmitTime()
+    //!
+    enum class TransmitClock : int {
+        MONOTONIC,  //!< Monotonic clock, as expected by the "fq" queuing discipline.
+        TAI,        //!< International Atomic Time, as typically configured with the "etf" queuing discipline.
+    };
+
     //!
     //! UDP Socket.
     //! @ingroup net
@@ -208,6 +217,31 @@ namespace ts {
         //!
         bool setReceiveTimestamps(bool on, Report& report = CERR);
 
+        //!
+        //! Enable the transmission of outgoing packets at a given time.
+        //!
+        //! When enabled, the transmit time of each packet which is sent using sendAt() is passed
+        //! to the kernel which delays the transmission until that time (socket option SO_TXTIME).
+        //! The pacing is done by the queuing discipline of the network interface, typically "fq"
+        //! or "etf". Using the "etf" queuing discipline with hardware offload, the transmit time
+        //! is enforced by the network interface itself. When the queuing discipline does not
+        //! support transmit times, the packets are sent immediately.
+        //!
+        //! The reference clock of the socket must be the clock of the queuing discipline. The "fq"
+        //! queuing discipline always uses the monotonic clock. The "etf" queuing discipline uses
+        //! the clock which was specified when it was configured, typically CLOCK_TAI. In sendAt(),
+        //! the transmit time is always specified on the monotonic clock and is converted when
+        //! the socket clock is TAI. Packets with a transmit time on the wrong clock are dropped
+        //! by the queuing discipline.
+        //!
+        //! Currently, this option is supported on Linux only. It is an error on other systems.
+        //!
+        //! @param [in] clock Reference clock of the transmit time.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool setTransmitTime(TransmitClock clock, Report& report = CERR);
+
         //!
         //! Enable or disable the broadcast option.
         //!
@@ -335,6 +369,20 @@ namespace ts {
         //!
         virtual bool send(const void* data, size_t size, Report& report = CERR);
 
+        //!
+        //! Send a message to the default destination address and port at a given time.
+        //!
+        //! If setTransmitTime() was not previously called, the message is immediately sent
+        //! and the transmit time is ignored.
+        //!
+        //! @param [in] data Address of the message to send.
+        //! @param [in] size Size in bytes of the message to send.
+        //! @param [in] tx_time Transmit time of the message on the monotonic clock.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool sendAt(const void* data, size_t size, const monotonic_time& tx_time, Report& report = CERR);
+
         //!
         //! Receive a message.
         //!
@@ -432,6 +480,8 @@ namespace ts {
         // Private members
         IPSocketAddress _local_address {};
         IPSocketAddress _default_destination {};
+        bool            _tx_time = false;    // SO_TXTIME is set.
+        TransmitClock   _tx_clock = TransmitClock::MONOTONIC; // Reference clock of SO_TXTIME.
         MReqSet         _mcast {};    // Current set of IPv4 multicast memberships
         MReq6Set        _mcast6 {};   // Current set of IPv6 multicast memberships
 #if !defined(TS_NO_SSM)
@@ -175,6 +175,16 @@ namespace ts {
         //!
         void setAutoRedirect(bool on) { _autoRedirect = on; }
 
+        //!
+        //! Keep the network connection after a transfer, for the next transfer on the same server.
+        //! When supported by the system, the network connection is kept in the WebRequest object
+        //! after close() and reused by the next transfer on the same server. This avoids the overhead
+        //! of a new connection when the same object is used to download a sequence of files.
+        //! This option is disabled by default: the connection is closed at the end of each transfer.
+        //! @param [in] on If true, keep the network connection between transfers.
+        //!
+        void setKeepConnections(bool on) { _keepConnections = on; }
+
         //!
         //! Set various arguments from command line.
         //! @param [in] args Command line arguments.
@@ -283,6 +293,7 @@ namespace ts {
         //!
         //! Close the transfer.
         //! @return True on success, false on error.
+        //! @see setKeepConnections()
         //!
         bool close();
 
@@ -350,6 +361,7 @@ namespace ts {
         Report&          _report;
         UString          _userAgent {DEFAULT_USER_AGENT};
         bool             _autoRedirect = true;
+        bool             _keepConnections = false;
         UString          _originalURL {};
         UString          _finalURL {};
         cn::milliseconds _connectionTimeout {};
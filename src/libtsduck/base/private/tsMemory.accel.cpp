@@ -0,0 +1,279 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+// Implementation of memory search functions using vector instructions.
+//
+// The 128-bit vector instructions (SSE2 on Intel x86-64, Neon on Arm64) are
+// part of the base instruction set of these architectures and are always
+// available. The AVX2 functions are compiled for the AVX2 target only and
+// shall not be called when these instructions are not implemented in the
+// current CPU.
+//
+// All functions use the same principle: compare a few bytes at consecutive
+// positions in the memory area, one vector at a time, and check the positions
+// which match all comparisons using a bit mask. The end of the memory area,
+// where the vectors would overflow, is processed using the portable version.
+//
+//----------------------------------------------------------------------------
+
+#include "tsMemoryAcceleration.h"
+#include "tsMemory.h"
+
+#if defined(TS_X86_64)
+    #define TS_SSE2_INSTRUCTIONS 1
+    #include <emmintrin.h>
+    #if defined(TS_GCC) || defined(TS_MSC)
+        #define TS_AVX2_INSTRUCTIONS 1
+        #include <immintrin.h>
+    #endif
+#elif defined(TS_ARM64) && (defined(__ARM_NEON) || defined(TS_MSC))
+    #define TS_NEON_INSTRUCTIONS 1
+    #include <arm_neon.h>
+#endif
+
+// With GCC and LLVM, the AVX2 functions are individually compiled for the AVX2 target.
+// With MSVC, the AVX2 intrinsics can be used in any function.
+#if defined(TS_AVX2_INSTRUCTIONS) && defined(TS_GCC)
+    #define TS_AVX2_FUNCTION __attribute__((target("avx2")))
+#else
+    #define TS_AVX2_FUNCTION
+#endif
+
+// "Hidden" exported bools to inform the SysInfo class that we have compiled accelerated instructions.
+extern const bool tsMemorySIMDIsAccelerated =
+#if defined(TS_SSE2_INSTRUCTIONS) || defined(TS_NEON_INSTRUCTIONS)
+    true;
+#else
+    false;
+#endif
+
+extern const bool tsMemoryAVX2IsAccelerated =
+#if defined(TS_AVX2_INSTRUCTIONS)
+    true;
+#else
+    false;
+#endif
+
+// Don't complain about assert(false) when acceleration is not implemented.
+TS_LLVM_NOWARNING(missing-noreturn)
+
+
+//----------------------------------------------------------------------------
+// Basic operations on 128-bit vectors of bytes.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // Extract the index of the first byte in a comparison mask and remove it from the mask.
+    // Each byte of the vector is represented by BITS bits in the mask.
+    template <size_t BITS>
+    inline size_t NextIndex(uint64_t& mask)
+    {
+        const size_t index = size_t(std::countr_zero(mask)) / BITS;
+        mask &= ~(((uint64_t(1) << BITS) - 1) << (index * BITS));
+        return index;
+    }
+
+#if defined(TS_SSE2_INSTRUCTIONS)
+
+    using Vector = __m128i;
+    constexpr size_t VECTOR_BITS_PER_BYTE = 1;
+    inline Vector Load(const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    inline Vector Splat(uint8_t b) { return _mm_set1_epi8(char(b)); }
+    inline Vector Equal(Vector a, Vector b) { return _mm_cmpeq_epi8(a, b); }
+    inline Vector LowerEqual(Vector a, Vector b) { return _mm_cmpeq_epi8(_mm_min_epu8(a, b), a); }
+    inline Vector And(Vector a, Vector b) { return _mm_and_si128(a, b); }
+    inline uint64_t Mask(Vector a) { return uint32_t(_mm_movemask_epi8(a)); }
+
+#elif defined(TS_NEON_INSTRUCTIONS)
+
+    // There is no "movemask" on Neon. A shift-right-and-narrow instruction builds a 64-bit mask with 4 bits per byte.
+    using Vector = uint8x16_t;
+    constexpr size_t VECTOR_BITS_PER_BYTE = 4;
+    inline Vector Load(const uint8_t* p) { return vld1q_u8(p); }
+    inline Vector Splat(uint8_t b) { return vdupq_n_u8(b); }
+    inline Vector Equal(Vector a, Vector b) { return vceqq_u8(a, b); }
+    inline Vector LowerEqual(Vector a, Vector b) { return vcleq_u8(a, b); }
+    inline Vector And(Vector a, Vector b) { return vandq_u8(a, b); }
+    inline uint64_t Mask(Vector a) { return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(a), 4)), 0); }
+
+#endif
+
+}
+
+
+//----------------------------------------------------------------------------
+// Implementations using 128-bit vectors.
+//----------------------------------------------------------------------------
+
+#if defined(TS_SSE2_INSTRUCTIONS) || defined(TS_NEON_INSTRUCTIONS)
+
+const uint8_t* ts::LocatePatternSIMD(const uint8_t* area, size_t area_size, const uint8_t* pattern, size_t pattern_size)
+{
+    // Two-byte anchor: compare the first and last bytes of the pattern at 16 consecutive
+    // positions, then check the middle of the pattern at the matching positions only.
+    constexpr size_t width = 16;
+    const size_t last = pattern_size - 1;
+    const Vector first_byte = Splat(pattern[0]);
+    const Vector last_byte = Splat(pattern[last]);
+    size_t index = 0;
+    for (; index + last + width <= area_size; index += width) {
+        uint64_t mask = Mask(And(Equal(Load(area + index), first_byte), Equal(Load(area + index + last), last_byte)));
+        while (mask != 0) {
+            const uint8_t* const p = area + index + NextIndex<VECTOR_BITS_PER_BYTE>(mask);
+            if (MemEqual(p + 1, pattern + 1, last - 1)) {
+                return p;
+            }
+        }
+    }
+    return LocatePatternGeneric(area + index, area_size - index, pattern, pattern_size);
+}
+
+const uint8_t* ts::LocateZeroZeroSIMD(const uint8_t* area, size_t area_size, uint8_t third)
+{
+    constexpr size_t width = 16;
+    const Vector zero = Splat(0);
+    const Vector third_byte = Splat(third);
+    size_t index = 0;
+    for (; index + width + 2 <= area_size; index += width) {
+        const uint64_t mask = Mask(And(And(Equal(Load(area + index), zero), Equal(Load(area + index + 1), zero)), Equal(Load(area + index + 2), third_byte)));
+        if (mask != 0) {
+            return area + index + size_t(std::countr_zero(mask)) / VECTOR_BITS_PER_BYTE;
+        }
+    }
+    return LocateZeroZeroGeneric(area + index, area_size - index, third);
+}
+
+void ts::LocateAllZeroZeroSIMD(std::vector<size_t>& offsets, const uint8_t* area, size_t area_size, uint8_t max_third, size_t base)
+{
+    constexpr size_t width = 16;
+    const Vector zero = Splat(0);
+    const Vector max_byte = Splat(max_third);
+    size_t index = 0;
+    for (; index + width + 2 <= area_size; index += width) {
+        uint64_t mask = Mask(And(And(Equal(Load(area + index), zero), Equal(Load(area + index + 1), zero)), LowerEqual(Load(area + index + 2), max_byte)));
+        while (mask != 0) {
+            offsets.push_back(base + index + NextIndex<VECTOR_BITS_PER_BYTE>(mask));
+        }
+    }
+    LocateAllZeroZeroGeneric(offsets, area + index, area_size - index, max_third, base + index);
+}
+
+#else
+
+const uint8_t* ts::LocatePatternSIMD(const uint8_t*, size_t, const uint8_t*, size_t)
+{
+    // Shall not be called.
+    assert(false);
+    return nullptr;
+}
+
+const uint8_t* ts::LocateZeroZeroSIMD(const uint8_t*, size_t, uint8_t)
+{
+    // Shall not be called.
+    assert(false);
+    return nullptr;
+}
+
+void ts::LocateAllZeroZeroSIMD(std::vector<size_t>&, const uint8_t*, size_t, uint8_t, size_t)
+{
+    // Shall not be called.
+    assert(false);
+}
+
+#endif
+
+
+//----------------------------------------------------------------------------
+// Implementations using 256-bit AVX2 vectors.
+// The end of the area is processed using SSE2 which is always available.
+//----------------------------------------------------------------------------
+
+#if defined(TS_AVX2_INSTRUCTIONS)
+
+TS_AVX2_FUNCTION const uint8_t* ts::LocatePatternAVX2(const uint8_t* area, size_t area_size, const uint8_t* pattern, size_t pattern_size)
+{
+    constexpr size_t width = 32;
+    const size_t last = pattern_size - 1;
+    const __m256i first_byte = _mm256_set1_epi8(char(pattern[0]));
+    const __m256i last_byte = _mm256_set1_epi8(char(pattern[last]));
+    size_t index = 0;
+    for (; index + last + width <= area_size; index += width) {
+        const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(area + index));
+        const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(area + index + last));
+        uint64_t mask = uint32_t(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(b0, first_byte), _mm256_cmpeq_epi8(b1, last_byte))));
+        while (mask != 0) {
+            const uint8_t* const p = area + index + NextIndex<1>(mask);
+            if (MemEqual(p + 1, pattern + 1, last - 1)) {
+                return p;
+            }
+        }
+    }
+    return LocatePatternSIMD(area + index, area_size - index, pattern, pattern_size);
+}
+
+TS_AVX2_FUNCTION const uint8_t* ts::LocateZeroZeroAVX2(const uint8_t* area, size_t area_size, uint8_t third)
+{
+    constexpr size_t width = 32;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i third_byte = _mm256_set1_epi8(char(third));
+    size_t index = 0;
+    for (; index + width + 2 <= area_size; index += width) {
+        const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(area + index));
+        const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(area + index + 1));
+        const __m256i b2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(area + index + 2));
+        const uint32_t mask = uint32_t(_mm256_movemask_epi8(_mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi8(b0, zero), _mm256_cmpeq_epi8(b1, zero)), _mm256_cmpeq_epi8(b2, third_byte))));
+        if (mask != 0) {
+            return area + index + std::countr_zero(mask);
+        }
+    }
+    return LocateZeroZeroSIMD(area + index, area_size - index, third);
+}
+
+TS_AVX2_FUNCTION void ts::LocateAllZeroZeroAVX2(std::vector<size_t>& offsets, const uint8_t* area, size_t area_size, uint8_t max_third, size_t base)
+{
+    constexpr size_t width = 32;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i max_byte = _mm256_set1_epi8(char(max_third));
+    size_t index = 0;
+    for (; index + width + 2 <= area_size; index += width) {
+        const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(area + index));
+        const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(area + index + 1));
+        const __m256i b2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(area + index + 2));
+        const __m256i third_ok = _mm256_cmpeq_epi8(_mm256_min_epu8(b2, max_byte), b2);
+        uint64_t mask = uint32_t(_mm256_movemask_epi8(_mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi8(b0, zero), _mm256_cmpeq_epi8(b1, zero)), third_ok)));
+        while (mask != 0) {
+            offsets.push_back(base + index + NextIndex<1>(mask));
+        }
+    }
+    LocateAllZeroZeroSIMD(offsets, area + index, area_size - index, max_third, base + index);
+}
+
+#else
+
+const uint8_t* ts::LocatePatternAVX2(const uint8_t*, size_t, const uint8_t*, size_t)
+{
+    // Shall not be called.
+    assert(false);
+    return nullptr;
+}
+
+const uint8_t* ts::LocateZeroZeroAVX2(const uint8_t*, size_t, uint8_t)
+{
+    // Shall not be called.
+    assert(false);
+    return nullptr;
+}
+
+void ts::LocateAllZeroZeroAVX2(std::vector<size_t>&, const uint8_t*, size_t, uint8_t, size_t)
+{
+    // Shall not be called.
+    assert(false);
+}
+
+#endif
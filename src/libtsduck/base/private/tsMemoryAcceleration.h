@@ -0,0 +1,55 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Declare the accelerated implementations of memory search functions.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+// Some global constant private booleans which are defined when the accelerated
+// modules are compiled with accelerated instructions.
+extern const bool tsMemorySIMDIsAccelerated;
+extern const bool tsMemoryAVX2IsAccelerated;
+
+namespace ts {
+    //
+    // Profiles of the internal implementations of LocatePattern(), LocateZeroZero() and LocateAllZeroZero().
+    // The arguments are checked by the public functions: pattern_size is always 2 or more.
+    //
+    using LocatePatternFunction = const uint8_t* (*)(const uint8_t* area, size_t area_size, const uint8_t* pattern, size_t pattern_size);
+    using LocateZeroZeroFunction = const uint8_t* (*)(const uint8_t* area, size_t area_size, uint8_t third);
+    using LocateAllZeroZeroFunction = void (*)(std::vector<size_t>& offsets, const uint8_t* area, size_t area_size, uint8_t max_third, size_t base);
+
+    //
+    // Portable implementations, in tsMemory.cpp.
+    // They are also used by the accelerated versions to process the end of the memory area.
+    // In LocateAllZeroZero functions, the value of 'base' is added to all returned offsets.
+    //
+    const uint8_t* LocatePatternGeneric(const uint8_t* area, size_t area_size, const uint8_t* pattern, size_t pattern_size);
+    const uint8_t* LocateZeroZeroGeneric(const uint8_t* area, size_t area_size, uint8_t third);
+    void LocateAllZeroZeroGeneric(std::vector<size_t>& offsets, const uint8_t* area, size_t area_size, uint8_t max_third, size_t base);
+
+    //
+    // Implementations using 128-bit vectors (SSE2 on Intel, Neon on Arm), in tsMemory.accel.cpp.
+    // Shall be called only when tsMemorySIMDIsAccelerated is true.
+    //
+    const uint8_t* LocatePatternSIMD(const uint8_t* area, size_t area_size, const uint8_t* pattern, size_t pattern_size);
+    const uint8_t* LocateZeroZeroSIMD(const uint8_t* area, size_t area_size, uint8_t third);
+    void LocateAllZeroZeroSIMD(std::vector<size_t>& offsets, const uint8_t* area, size_t area_size, uint8_t max_third, size_t base);
+
+    //
+    // Implementations using 256-bit AVX2 vectors, in tsMemory.accel.cpp.
+    // Shall be called only when tsMemoryAVX2IsAccelerated is true and the CPU supports AVX2.
+    //
+    const uint8_t* LocatePatternAVX2(const uint8_t* area, size_t area_size, const uint8_t* pattern, size_t pattern_size);
+    const uint8_t* LocateZeroZeroAVX2(const uint8_t* area, size_t area_size, uint8_t third);
+    void LocateAllZeroZeroAVX2(std::vector<size_t>& offsets, const uint8_t* area, size_t area_size, uint8_t max_third, size_t base);
+}
@@ -8,6 +8,84 @@
 
 #include "tsAbstractWriteStreamInterface.h"
 
+#if defined(TS_UNIX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/uio.h>
+    #include <limits.h>
+    #include <unistd.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
 ts::AbstractWriteStreamInterface::~AbstractWriteStreamInterface()
 {
 }
+
+
+//----------------------------------------------------------------------------
+// Default implementation of vectored write: one write per chunk.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractWriteStreamInterface::writeStreamChunks(const Chunk* chunks, size_t chunk_count, size_t& written_size, Report& report)
+{
+    written_size = 0;
+    bool success = true;
+    for (size_t i = 0; success && i < chunk_count; ++i) {
+        size_t size = 0;
+        success = writeStream(chunks[i].addr, chunks[i].size, size, report);
+        written_size += size;
+    }
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Write several chunks of data to a UNIX file descriptor.
+//----------------------------------------------------------------------------
+
+#if defined(TS_UNIX)
+int ts::AbstractWriteStreamInterface::WriteChunksToDescriptor(int fd, const Chunk* chunks, size_t chunk_count, size_t& written_size)
+{
+    written_size = 0;
+    std::vector<::iovec> iov;
+    iov.reserve(std::min<size_t>(chunk_count, IOV_MAX));
+    size_t index = 0;   // Index of first chunk to write.
+    size_t offset = 0;  // Offset of first byte to write in that chunk.
+
+    for (;;) {
+        // Skip completely written chunks.
+        while (index < chunk_count && offset >= chunks[index].size) {
+            index++;
+            offset = 0;
+        }
+        if (index >= chunk_count) {
+            return 0;
+        }
+
+        // Build the list of I/O vectors, at most IOV_MAX chunks at a time.
+        iov.clear();
+        for (size_t i = index; i < chunk_count && iov.size() < IOV_MAX; ++i) {
+            const size_t start = i == index ? offset : 0;
+            iov.push_back({const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(chunks[i].addr)) + start, chunks[i].size - start});
+        }
+
+        const ssize_t outsize = ::writev(fd, iov.data(), int(iov.size()));
+        if (outsize > 0) {
+            // Some data were written, move to the next data to write.
+            written_size += size_t(outsize);
+            for (size_t remain = size_t(outsize); remain > 0 && index < chunk_count; ) {
+                const size_t size = std::min(remain, chunks[index].size - offset);
+                remain -= size;
+                offset += size;
+                if (offset >= chunks[index].size) {
+                    index++;
+                    offset = 0;
+                }
+            }
+        }
+        else if (errno != EINTR) {
+            // Actual error (not an interrupt).
+            return errno;
+        }
+    }
+}
+#endif
@@ -34,5 +34,44 @@ namespace ts {
         //! @return True on success, false on error.
         //!
         virtual bool writeStream(const void* addr, size_t size, size_t& written_size, Report& report) = 0;
+
+        //!
+        //! Description of a contiguous chunk of data, for vectored write operations.
+        //!
+        class Chunk
+        {
+        public:
+            const void* addr = nullptr;  //!< Address of the data to write.
+            size_t      size = 0;        //!< Size in bytes of the data to write.
+        };
+
+        //!
+        //! Write several chunks of data to the stream, in sequence.
+        //! The default implementation invokes writeStream() once per chunk. Subclasses
+        //! may override it using vectored system calls, typically writev() on UNIX.
+        //! @param [in] chunks Address of an array of chunks of data.
+        //! @param [in] chunk_count Number of chunks in @a chunks.
+        //! @param [out] written_size Actually written size in bytes, in all chunks.
+        //! Can be less than the total size in case of error in the middle of the write.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        virtual bool writeStreamChunks(const Chunk* chunks, size_t chunk_count, size_t& written_size, Report& report);
+
+#if defined(TS_UNIX) || defined(DOXYGEN)
+    protected:
+        //!
+        //! Write several chunks of data to a UNIX file descriptor, using writev().
+        //! This is a helper for subclasses which override writeStreamChunks() on UNIX systems.
+        //! Partial writes and interrupted system calls are retried and the number of chunks in
+        //! each system call is limited to IOV_MAX. Errors are not reported.
+        //! @param [in] fd File descriptor.
+        //! @param [in] chunks Address of an array of chunks of data.
+        //! @param [in] chunk_count Number of chunks in @a chunks.
+        //! @param [out] written_size Actually written size in bytes, in all chunks.
+        //! @return Zero on success, the system error code (errno) on error.
+        //!
+        static int WriteChunksToDescriptor(int fd, const Chunk* chunks, size_t chunk_count, size_t& written_size);
+#endif
     };
 }
@@ -539,22 +539,34 @@ void ts::ForkPipe::abortPipeReadWrite()
 // Implementation of AbstractWriteStreamInterface
 //----------------------------------------------------------------------------
 
-bool ts::ForkPipe::writeStream(const void* addr, size_t size, size_t& written_size, Report& report)
+bool ts::ForkPipe::canWrite(bool& status, Report& report)
 {
-    written_size = 0;
-
     if (!_is_open) {
         report.error(u"pipe is not open");
+        status = false;
         return false;
     }
     if (!_in_pipe) {
         report.error(u"process was created without input pipe");
+        status = false;
         return false;
     }
 
     // If pipe already broken, return
     if (_broken_pipe) {
-        return _ignore_abort;
+        status = _ignore_abort;
+        return false;
+    }
+    return true;
+}
+
+bool ts::ForkPipe::writeStream(const void* addr, size_t size, size_t& written_size, Report& report)
+{
+    written_size = 0;
+
+    bool status = false;
+    if (!canWrite(status, report)) {
+        return status;
     }
 
     bool error = false;
@@ -606,6 +618,47 @@ bool ts::ForkPipe::writeStream(const void* addr, size_t size, size_t& written_si
     }
 #endif
 
+    return writeStatus(error, errcode, report);
+}
+
+
+//----------------------------------------------------------------------------
+// Write several chunks of data to the pipe.
+//----------------------------------------------------------------------------
+
+bool ts::ForkPipe::writeStreamChunks(const Chunk* chunks, size_t chunk_count, size_t& written_size, Report& report)
+{
+#if defined(TS_WINDOWS)
+
+    // No vectored write on Windows pipes, use the default implementation.
+    return AbstractWriteStreamInterface::writeStreamChunks(chunks, chunk_count, written_size, report);
+
+#else
+
+    // UNIX implementation: use writev().
+    // Note: vmsplice() is not used because the caller may reuse the data buffers
+    // as soon as we return, before the forked process reads them from the pipe.
+    written_size = 0;
+
+    bool status = false;
+    if (!canWrite(status, report)) {
+        return status;
+    }
+
+    const int errcode = WriteChunksToDescriptor(_fd, chunks, chunk_count, written_size);
+    _broken_pipe = errcode == EPIPE;
+    return writeStatus(errcode != 0, errcode, report);
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Process the final status of a write operation.
+//----------------------------------------------------------------------------
+
+bool ts::ForkPipe::writeStatus(bool error, int errcode, Report& report)
+{
     if (!error) {
         return true;
     }
@@ -176,6 +176,7 @@ namespace ts {
 
         // Implementation of AbstractWriteStreamInterface
         virtual bool writeStream(const void* addr, size_t size, size_t& written_size, Report& report) override;
+        virtual bool writeStreamChunks(const Chunk* chunks, size_t chunk_count, size_t& written_size, Report& report) override;
 
     protected:
         // Implementation of AbstractOutputStream
@@ -199,5 +200,11 @@ namespace ts {
         ::pid_t       _fpid = 0;                 // Forked process id (UNIX PID, not MPEG PID!)
         int           _fd {-1};                  // Pipe output file descriptor.
 #endif
+
+        // Check if the pipe can be written. Return false and set status if the write shall not be attempted.
+        bool canWrite(bool& status, Report& report);
+
+        // Process the final status of a write operation, with the system error code in case of error.
+        bool writeStatus(bool error, int errcode, Report& report);
     };
 }
@@ -0,0 +1,109 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsPacingTimer.h"
+#include "tsSysUtils.h"
+
+#if defined(TS_LINUX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/prctl.h>
+    #include <time.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+
+//----------------------------------------------------------------------------
+// Minimum useful interval between two waits.
+//----------------------------------------------------------------------------
+
+cn::nanoseconds ts::PacingTimer::precision() const
+{
+    // Without spin phase, the waits are limited by the precision of the system timers.
+    // We try to request 2 milliseconds and we keep what the operating system gives.
+    cn::nanoseconds precision = cn::milliseconds(2);
+    SetTimersPrecision(precision);
+
+#if defined(TS_WINDOWS)
+    // On Windows, the sleep phase is limited by the system timer resolution.
+    // The spin phase is useful only when it covers this resolution.
+    const bool spin_useful = _spin >= precision;
+#else
+    const bool spin_useful = _spin > cn::nanoseconds::zero();
+#endif
+
+    // With an active spin phase, the wait precision is only limited by the cost of waking up.
+    return spin_useful ? cn::nanoseconds(cn::microseconds(100)) : precision;
+}
+
+
+//----------------------------------------------------------------------------
+// Wait until a given time on the monotonic clock.
+//----------------------------------------------------------------------------
+
+void ts::PacingTimer::waitUntil(const monotonic_time& due)
+{
+    monotonic_time now = monotonic_time::clock::now();
+    if (now >= due) {
+        return;
+    }
+
+    // Sleep phase, until the beginning of the spin phase.
+    const monotonic_time wake_up = due - cn::duration_cast<monotonic_time::duration>(_spin);
+    if (now < wake_up) {
+#if defined(TS_LINUX)
+        // Reduce the timer slack of the current thread, once per thread. The default
+        // timer slack is 50 microseconds, added to all sleeps of the thread.
+        static thread_local bool slack_set = false;
+        if (!slack_set) {
+            slack_set = true;
+            ::prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+        }
+        // The clock of monotonic_time is CLOCK_MONOTONIC on Linux.
+        const cn::nanoseconds::rep ns = cn::duration_cast<cn::nanoseconds>(wake_up.time_since_epoch()).count();
+        ::timespec ts;
+        ts.tv_sec = ::time_t(ns / 1'000'000'000);
+        ts.tv_nsec = long(ns % 1'000'000'000);
+        while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+        }
+#else
+        std::this_thread::sleep_until(wake_up);
+#endif
+    }
+
+    // Spin phase, until the deadline.
+    do {
+        now = monotonic_time::clock::now();
+    } while (now < due);
+
+    // Collect statistics.
+    const cn::nanoseconds late = cn::duration_cast<cn::nanoseconds>(now - due);
+    _wait_count++;
+    _total_late += late;
+    _max_late = std::max(_max_late, late);
+}
+
+
+//----------------------------------------------------------------------------
+// Wait statistics.
+//----------------------------------------------------------------------------
+
+void ts::PacingTimer::resetStatistics()
+{
+    _wait_count = 0;
+    _total_late = _max_late = cn::nanoseconds::zero();
+}
+
+cn::nanoseconds ts::PacingTimer::meanLateness() const
+{
+    return _wait_count == 0 ? cn::nanoseconds::zero() : _total_late / cn::nanoseconds::rep(_wait_count);
+}
+
+ts::UString ts::PacingTimer::statistics() const
+{
+    return UString::Format(u"%'d waits, mean lateness: %'d ns, max lateness: %'d ns", _wait_count, meanLateness().count(), _max_late.count());
+}
@@ -0,0 +1,118 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  High-precision wait on absolute deadlines, for packet pacing.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsUString.h"
+
+namespace ts {
+    //!
+    //! High-precision wait on absolute deadlines, for packet pacing.
+    //! @ingroup system
+    //!
+    //! Waiting with std::this_thread::sleep_until() typically wakes up the thread with
+    //! a delay of several tens of microseconds, up to a few milliseconds, depending on the
+    //! system timer resolution and timer slack. When packets are regulated using such
+    //! waits, the output stream has a large jitter.
+    //!
+    //! A PacingTimer waits in two phases. First, the thread sleeps until a short time before
+    //! the deadline. Then, the thread actively spins on the monotonic clock until the deadline.
+    //! The spin phase is disabled by default: with frequent deadlines, spinning before each
+    //! of them keeps one CPU core almost permanently busy. It must be explicitly enabled
+    //! using setSpinDuration() by applications which favor precision over CPU load.
+    //!
+    //! On Linux, the sleep phase uses clock_nanosleep() on an absolute deadline on the monotonic
+    //! clock. The first time a thread waits, its timer slack is reduced to the minimum
+    //! (see prctl(PR_SET_TIMERSLACK)). On other systems, std::this_thread::sleep_until() is used.
+    //!
+    //! The instance also collects statistics on the lateness of the waits, which is the
+    //! difference between the actual wake-up time and the deadline.
+    //!
+    class TSDUCKDLL PacingTimer
+    {
+        TS_NOCOPY(PacingTimer);
+    public:
+        //!
+        //! Default duration of the active spin phase before each deadline (no spin).
+        //!
+        static constexpr cn::microseconds DEFAULT_SPIN = cn::microseconds::zero();
+
+        //!
+        //! Default constructor.
+        //!
+        PacingTimer() = default;
+
+        //!
+        //! Set the duration of the active spin phase before each deadline.
+        //! @param [in] spin Duration of the spin phase. Zero means never spin, use sleep only.
+        //!
+        void setSpinDuration(cn::nanoseconds spin) { _spin = std::max(spin, cn::nanoseconds::zero()); }
+
+        //!
+        //! Get the duration of the active spin phase before each deadline.
+        //! @return The duration of the spin phase.
+        //!
+        cn::nanoseconds spinDuration() const { return _spin; }
+
+        //!
+        //! Get the minimum interval between two waits which is reliably honored on this system.
+        //! Waiting on shorter intervals is possible but not useful, it is better to burst more
+        //! packets between two waits. Without spin phase, this is the precision of the system
+        //! timers, at least 2 milliseconds. With a spin phase, this is a much shorter interval.
+        //! @return The minimum useful interval between two waits with the current spin duration.
+        //!
+        cn::nanoseconds precision() const;
+
+        //!
+        //! Wait until a given time on the monotonic clock.
+        //! Return immediately if the deadline is already passed.
+        //! @param [in] due Deadline of the wait.
+        //!
+        void waitUntil(const monotonic_time& due);
+
+        //!
+        //! Reset the wait statistics.
+        //!
+        void resetStatistics();
+
+        //!
+        //! Get the number of waits since the last reset of the statistics.
+        //! Waits on a deadline which is already passed are not counted.
+        //! @return The number of waits.
+        //!
+        uint64_t waitCount() const { return _wait_count; }
+
+        //!
+        //! Get the mean lateness of the waits since the last reset of the statistics.
+        //! @return The mean lateness.
+        //!
+        cn::nanoseconds meanLateness() const;
+
+        //!
+        //! Get the maximum lateness of the waits since the last reset of the statistics.
+        //! @return The maximum lateness.
+        //!
+        cn::nanoseconds maxLateness() const { return _max_late; }
+
+        //!
+        //! Format a summary of the wait statistics, for logging.
+        //! @return A string describing the wait statistics.
+        //!
+        UString statistics() const;
+
+    private:
+        cn::nanoseconds _spin = DEFAULT_SPIN;
+        uint64_t        _wait_count = 0;
+        cn::nanoseconds _total_late {0};
+        cn::nanoseconds _max_late {0};
+    };
+}
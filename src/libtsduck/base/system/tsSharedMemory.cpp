@@ -0,0 +1,237 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedMemory.h"
+#include "tsSysUtils.h"
+#include "tsNullReport.h"
+
+#if defined(TS_UNIX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/stat.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+ts::SharedMemory::~SharedMemory()
+{
+    close(NULLREP);
+}
+
+
+//----------------------------------------------------------------------------
+// Build the system name of a segment.
+//----------------------------------------------------------------------------
+
+ts::UString ts::SharedMemory::SystemName(const UString& name)
+{
+#if defined(TS_WINDOWS)
+    return u"Local\\tsduck-" + name;
+#else
+    return u"/tsduck-" + name;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Create a new shared memory segment.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemory::create(const UString& name, size_t size, Report& report)
+{
+    if (isOpen()) {
+        report.error(u"shared memory %s already open", _name);
+        return false;
+    }
+    if (name.empty() || name.contains(u'/') || name.contains(u'\\') || size == 0) {
+        report.error(u"invalid shared memory name or size: \"%s\", %'d bytes", name, size);
+        return false;
+    }
+
+    const UString sysname(SystemName(name));
+
+#if defined(TS_WINDOWS)
+
+    const uint64_t size64 = uint64_t(size);
+    _handle = ::CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, ::DWORD(size64 >> 32), ::DWORD(size64), sysname.wc_str());
+    if (_handle == nullptr) {
+        report.error(u"error creating shared memory %s: %s", name, SysErrorCodeMessage());
+        return false;
+    }
+    if (::GetLastError() == ERROR_ALREADY_EXISTS) {
+        report.error(u"shared memory %s already in use", name);
+        ::CloseHandle(_handle);
+        _handle = nullptr;
+        return false;
+    }
+    _address = ::MapViewOfFile(_handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (_address == nullptr) {
+        report.error(u"error mapping shared memory %s: %s", name, SysErrorCodeMessage());
+        ::CloseHandle(_handle);
+        _handle = nullptr;
+        return false;
+    }
+
+#else
+
+    // Never replace an existing segment, it may be in use by another process.
+    const std::string sname(sysname.toUTF8());
+    const int fd = ::shm_open(sname.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+    if (fd < 0 && errno == EEXIST) {
+        report.error(u"shared memory %s already in use", name);
+        return false;
+    }
+    else if (fd < 0) {
+        report.error(u"error creating shared memory %s: %s", name, SysErrorCodeMessage());
+        return false;
+    }
+    if (::ftruncate(fd, ::off_t(size)) < 0) {
+        report.error(u"error resizing shared memory %s: %s", name, SysErrorCodeMessage());
+        ::close(fd);
+        ::shm_unlink(sname.c_str());
+        return false;
+    }
+    void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        report.error(u"error mapping shared memory %s: %s", name, SysErrorCodeMessage());
+        ::shm_unlink(sname.c_str());
+        return false;
+    }
+    _address = addr;
+
+#endif
+
+    _name = name;
+    _size = size;
+    _owner = true;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Open an existing shared memory segment.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemory::open(const UString& name, Report& report)
+{
+    if (isOpen()) {
+        report.error(u"shared memory %s already open", _name);
+        return false;
+    }
+
+    const UString sysname(SystemName(name));
+
+#if defined(TS_WINDOWS)
+
+    _handle = ::OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, sysname.wc_str());
+    if (_handle == nullptr) {
+        report.error(u"error opening shared memory %s: %s", name, SysErrorCodeMessage());
+        return false;
+    }
+    _address = ::MapViewOfFile(_handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    ::MEMORY_BASIC_INFORMATION info;
+    if (_address == nullptr || ::VirtualQuery(_address, &info, sizeof(info)) == 0) {
+        report.error(u"error mapping shared memory %s: %s", name, SysErrorCodeMessage());
+        if (_address != nullptr) {
+            ::UnmapViewOfFile(_address);
+            _address = nullptr;
+        }
+        ::CloseHandle(_handle);
+        _handle = nullptr;
+        return false;
+    }
+    _size = size_t(info.RegionSize);
+
+#else
+
+    const int fd = ::shm_open(sysname.toUTF8().c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        report.error(u"error opening shared memory %s: %s", name, SysErrorCodeMessage());
+        return false;
+    }
+    struct ::stat st;
+    if (::fstat(fd, &st) < 0 || st.st_size <= 0) {
+        report.error(u"error getting size of shared memory %s: %s", name, SysErrorCodeMessage());
+        ::close(fd);
+        return false;
+    }
+    void* addr = ::mmap(nullptr, size_t(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        report.error(u"error mapping shared memory %s: %s", name, SysErrorCodeMessage());
+        return false;
+    }
+    _address = addr;
+    _size = size_t(st.st_size);
+
+#endif
+
+    _name = name;
+    _owner = false;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Remove the name of an existing shared memory segment.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemory::Remove(const UString& name, Report& report)
+{
+#if defined(TS_UNIX)
+    if (::shm_unlink(SystemName(name).toUTF8().c_str()) < 0 && errno != ENOENT) {
+        report.error(u"error deleting shared memory %s: %s", name, SysErrorCodeMessage());
+        return false;
+    }
+#endif
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Unmap the shared memory segment.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemory::close(Report& report)
+{
+    if (!isOpen()) {
+        return true;
+    }
+
+    bool success = true;
+
+#if defined(TS_WINDOWS)
+
+    if (!::UnmapViewOfFile(_address) || !::CloseHandle(_handle)) {
+        report.error(u"error closing shared memory %s: %s", _name, SysErrorCodeMessage());
+        success = false;
+    }
+    _handle = nullptr;
+
+#else
+
+    if (::munmap(_address, _size) < 0) {
+        report.error(u"error unmapping shared memory %s: %s", _name, SysErrorCodeMessage());
+        success = false;
+    }
+    if (_owner && ::shm_unlink(SystemName(_name).toUTF8().c_str()) < 0) {
+        report.error(u"error deleting shared memory %s: %s", _name, SysErrorCodeMessage());
+        success = false;
+    }
+
+#endif
+
+    _address = nullptr;
+    _size = 0;
+    _owner = false;
+    return success;
+}
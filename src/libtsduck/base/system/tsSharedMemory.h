@@ -0,0 +1,129 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Named shared memory segment.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsUString.h"
+#include "tsCerrReport.h"
+
+namespace ts {
+    //!
+    //! Named shared memory segment, which can be mapped by several processes.
+    //! @ingroup system
+    //!
+    //! On UNIX systems, the segment is a POSIX shared memory object (see shm_open()).
+    //! On Windows, the segment is a named file mapping, backed by the paging file.
+    //!
+    //! The segment is created by one process, its owner. Other processes open the
+    //! existing segment using the same name. All processes map the segment in read/write
+    //! mode. When the owner closes the segment, its name is removed from the system.
+    //! The other processes can continue to use the segment until they close it.
+    //!
+    class TSDUCKDLL SharedMemory
+    {
+        TS_NOCOPY(SharedMemory);
+    public:
+        //!
+        //! Default constructor.
+        //!
+        SharedMemory() = default;
+
+        //!
+        //! Destructor.
+        //! The segment is unmapped.
+        //!
+        ~SharedMemory();
+
+        //!
+        //! Create a new shared memory segment and map it in the current process.
+        //! The creation fails if a segment with the same name already exists. A segment
+        //! which was left by a crashed owner must be explicitly deleted using Remove().
+        //! @param [in] name Name of the segment. This is a simple name, without path or
+        //! leading slash. All names are in a TSDuck-specific namespace.
+        //! @param [in] size Size in bytes of the segment. The segment is initially zeroed.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool create(const UString& name, size_t size, Report& report = CERR);
+
+        //!
+        //! Open an existing shared memory segment and map it in the current process.
+        //! @param [in] name Name of the segment, as specified by its owner.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool open(const UString& name, Report& report = CERR);
+
+        //!
+        //! Unmap the shared memory segment.
+        //! If the segment was created by this object, its name is removed from the system.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool close(Report& report = CERR);
+
+        //!
+        //! Remove the name of an existing shared memory segment from the system.
+        //! This is typically used to delete a stale segment after a crash of its owner.
+        //! Processes which still map the segment can continue to use it.
+        //! On Windows, a segment disappears when its last handle is closed and this
+        //! function does nothing.
+        //! @param [in] name Name of the segment.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        static bool Remove(const UString& name, Report& report = CERR);
+
+        //!
+        //! Check if the segment is open.
+        //! @return True if the segment is open and mapped.
+        //!
+        bool isOpen() const { return _address != nullptr; }
+
+        //!
+        //! Check if the segment was created by this object.
+        //! @return True if the segment was created by this object.
+        //!
+        bool isOwner() const { return _owner; }
+
+        //!
+        //! Get the address of the mapped segment in the current process.
+        //! @return The address of the segment or a null pointer if the segment is not open.
+        //!
+        void* address() const { return _address; }
+
+        //!
+        //! Get the size of the mapped segment.
+        //! @return The size in bytes of the segment. On Windows, when the segment was open
+        //! and not created, this is the size of the mapped area, rounded up to a page boundary.
+        //!
+        size_t size() const { return _size; }
+
+        //!
+        //! Get the name of the segment.
+        //! @return The name of the segment.
+        //!
+        const UString& name() const { return _name; }
+
+    private:
+        UString _name {};
+        bool    _owner = false;
+        void*   _address = nullptr;
+        size_t  _size = 0;
+#if defined(TS_WINDOWS)
+        ::HANDLE _handle = nullptr;
+#endif
+
+        // Build the system name of a segment.
+        static UString SystemName(const UString& name);
+    };
+}
@@ -10,6 +10,7 @@
 #include "tsEnvironment.h"
 #include "tsMemory.h"
 #include "tsCryptoAcceleration.h"
+#include "tsMemoryAcceleration.h"
 #include "tsVersionInfo.h"
 
 #if defined(TS_LINUX)
@@ -295,6 +296,17 @@ ts::SysInfo::SysInfo() :
                 _crcInstructions = tsCRC32IsAccelerated && SysCtrlBool("hw.optional.armv8_crc32");
             #endif
         }
+        if (GetEnvironment(u"TS_NO_SIMD_INSTRUCTIONS").empty()) {
+            // SSE2 and Neon are part of the base instruction set on x86-64 and Arm64.
+            _simdInstructions = tsMemorySIMDIsAccelerated;
+            if (_simdInstructions && GetEnvironment(u"TS_NO_AVX2_INSTRUCTIONS").empty()) {
+                #if defined(TS_X86_64) && defined(TS_GCC)
+                    _avx2Instructions = tsMemoryAVX2IsAccelerated && __builtin_cpu_supports("avx2");
+                #elif defined(TS_X86_64) && defined(TS_WINDOWS)
+                    _avx2Instructions = tsMemoryAVX2IsAccelerated && ::IsProcessorFeaturePresent(PF_AVX2_INSTRUCTIONS_AVAILABLE);
+                #endif
+            }
+        }
     }
 }
 
@@ -335,7 +347,14 @@ TS_REGISTER_FEATURE(u"acceleration", u"Acceleration", ALWAYS, ts::SysInfo::GetAc
 
 ts::UString ts::SysInfo::GetAccelerations()
 {
-    return UString::Format(u"CRC32: %s", UString::YesNo(Instance().crcInstructions()));
+    const SysInfo& sys(Instance());
+    UString str(UString::Format(u"CRC32: %s", UString::YesNo(sys.crcInstructions())));
+#if defined(TS_X86_64)
+    str.format(u", SSE2: %s, AVX2: %s", UString::YesNo(sys.simdInstructions()), UString::YesNo(sys.avx2Instructions()));
+#elif defined(TS_ARM64)
+    str.format(u", Neon: %s", UString::YesNo(sys.simdInstructions()));
+#endif
+    return str;
 }
 
 
@@ -90,6 +90,18 @@ namespace ts {
         //!
         bool crcInstructions() const { return _crcInstructions; }
         //!
+        //! Check if the CPU supports 128-bit vector instructions (SSE2 on Intel, Neon on Arm).
+        //! These instructions are used to accelerate memory searches.
+        //! @return True if the CPU supports 128-bit vector instructions.
+        //!
+        bool simdInstructions() const { return _simdInstructions; }
+        //!
+        //! Check if the CPU supports AVX2 instructions (256-bit vectors on Intel).
+        //! These instructions are used to accelerate memory searches.
+        //! @return True if the CPU supports AVX2 instructions.
+        //!
+        bool avx2Instructions() const { return _avx2Instructions; }
+        //!
         //! Get the operating system version.
         //! @return The operating system version.
         //!
@@ -145,6 +157,8 @@ namespace ts {
         SysOS     _osFamily;
         SysFlavor _osFlavor = UNKNOWN;
         bool      _crcInstructions = false;
+        bool      _simdInstructions = false;
+        bool      _avx2Instructions = false;
         int       _systemMajorVersion = -1;
         UString   _systemVersion {};
         UString   _systemName {};
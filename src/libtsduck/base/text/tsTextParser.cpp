@@ -32,10 +32,10 @@ ts::TextParser::TextParser(const UString& text, Report& report) :
     loadDocument(text);
 }
 
-ts::TextParser::Position::Position(const UStringList& textLines) :
+ts::TextParser::Position::Position(const UStringList& textLines, size_t firstLineNumber) :
     _lines(&textLines),
     _curLine(textLines.begin()),
-    _curLineNumber(1),
+    _curLineNumber(firstLineNumber),
     _curIndex(0)
 {
 }
@@ -53,6 +53,7 @@ void ts::TextParser::clear()
 {
     _lines.clear();
     _pos = Position(_lines);
+    _firstLineNumber = 1;
 }
 
 
@@ -66,10 +67,11 @@ void ts::TextParser::loadDocument(const UStringList& lines)
     _pos = Position(lines);
 }
 
-void ts::TextParser::loadDocument(const UString& text)
+void ts::TextParser::loadDocument(const UString& text, size_t firstLineNumber)
 {
     text.toRemoved(u'\r').split(_lines, u'\n', false);
-    _pos = Position(_lines);
+    _firstLineNumber = firstLineNumber;
+    _pos = Position(_lines, _firstLineNumber);
 }
 
 bool ts::TextParser::loadFile(const fs::path& fileName)
@@ -81,6 +83,7 @@ bool ts::TextParser::loadFile(const fs::path& fileName)
     }
 
     // Initialize the parser on the internal lines buffer, including on file error (empty).
+    _firstLineNumber = 1;
     _pos = Position(_lines);
     return ok;
 }
@@ -94,6 +97,7 @@ bool ts::TextParser::loadStream(std::istream& strm)
     }
 
     // Initialize the parser on the internal lines buffer, including on file error (empty).
+    _firstLineNumber = 1;
     _pos = Position(_lines);
     return ok;
 }
@@ -153,7 +157,7 @@ bool ts::TextParser::eol() const
 
 void ts::TextParser::rewind()
 {
-    _pos = Position(_lines);
+    _pos = Position(_lines, _firstLineNumber);
 }
 
 
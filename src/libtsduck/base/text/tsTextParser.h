@@ -66,8 +66,10 @@ namespace ts {
         //!
         //! Load the document to parse.
         //! @param [in] text Document text to parse with embedded new-line characters.
+        //! @param [in] firstLineNumber Line number of the first line in @a text. This is useful
+        //! when @a text is an extract from a larger document, to report meaningful line numbers.
         //!
-        void loadDocument(const UString& text);
+        void loadDocument(const UString& text, size_t firstLineNumber = 1);
 
         //!
         //! Load the document to parse from a text file.
@@ -122,7 +124,7 @@ namespace ts {
         private:
             // Constructors.
             Position() = delete;
-            Position(const UStringList&);
+            Position(const UStringList&, size_t = 1);
 
             // Everything is private to the application.
             // Only TextParser can use it.
@@ -261,5 +263,6 @@ namespace ts {
         Report&     _report;
         UStringList _lines;
         Position    _pos;
+        size_t      _firstLineNumber = 1;
     };
 }
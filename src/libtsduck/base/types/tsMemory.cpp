@@ -7,6 +7,8 @@
 //----------------------------------------------------------------------------
 
 #include "tsMemory.h"
+#include "tsMemoryAcceleration.h"
+#include "tsSysInfo.h"
 
 
 //----------------------------------------------------------------------------
@@ -19,6 +21,45 @@ bool ts::StartsWith(const void* area, size_t area_size, const void* prefix, size
 }
 
 
+//----------------------------------------------------------------------------
+// Selection of the memory search implementations for the current CPU.
+//----------------------------------------------------------------------------
+
+namespace {
+    class MemorySearch
+    {
+        TS_NOCOPY(MemorySearch);
+    public:
+        ts::LocatePatternFunction     pattern = ts::LocatePatternGeneric;
+        ts::LocateZeroZeroFunction    zero_zero = ts::LocateZeroZeroGeneric;
+        ts::LocateAllZeroZeroFunction all_zero_zero = ts::LocateAllZeroZeroGeneric;
+
+        // The selection is done only once, on first use.
+        static const MemorySearch& Instance()
+        {
+            static const MemorySearch instance;
+            return instance;
+        }
+
+    private:
+        MemorySearch()
+        {
+            const ts::SysInfo& sys(ts::SysInfo::Instance());
+            if (sys.avx2Instructions()) {
+                pattern = ts::LocatePatternAVX2;
+                zero_zero = ts::LocateZeroZeroAVX2;
+                all_zero_zero = ts::LocateAllZeroZeroAVX2;
+            }
+            else if (sys.simdInstructions()) {
+                pattern = ts::LocatePatternSIMD;
+                zero_zero = ts::LocateZeroZeroSIMD;
+                all_zero_zero = ts::LocateAllZeroZeroSIMD;
+            }
+        }
+    };
+}
+
+
 //----------------------------------------------------------------------------
 // Locate a pattern into a memory area. Return 0 if not found
 //----------------------------------------------------------------------------
@@ -35,20 +76,25 @@ const uint8_t* ts::LocatePattern(const void* area, size_t area_size, const void*
         return reinterpret_cast<const uint8_t*>(std::memchr(area, val, area_size));
     }
     else {
-        const uint8_t* a = reinterpret_cast<const uint8_t*>(area);
-        const uint8_t* const p = reinterpret_cast<const uint8_t*>(pattern);
-        const uint8_t* const p1 = p + 1;
-        const size_t last = pattern_size - 1;
-        const size_t sublen = pattern_size - 2;
-        while (area_size >= pattern_size) {
-            if (*a == *p && a[last] == p[last] && MemEqual(a + 1, p1, sublen)) {
-                return a;
-            }
-            ++a;
-            --area_size;
+        return MemorySearch::Instance().pattern(reinterpret_cast<const uint8_t*>(area), area_size, reinterpret_cast<const uint8_t*>(pattern), pattern_size);
+    }
+}
+
+// Portable version, pattern_size is at least 2.
+const uint8_t* ts::LocatePatternGeneric(const uint8_t* area, size_t area_size, const uint8_t* pattern, size_t pattern_size)
+{
+    const uint8_t* a = area;
+    const uint8_t* const p1 = pattern + 1;
+    const size_t last = pattern_size - 1;
+    const size_t sublen = pattern_size - 2;
+    while (area_size >= pattern_size) {
+        if (*a == *pattern && a[last] == pattern[last] && MemEqual(a + 1, p1, sublen)) {
+            return a;
         }
-        return nullptr; // not found
+        ++a;
+        --area_size;
     }
+    return nullptr; // not found
 }
 
 
@@ -58,7 +104,13 @@ const uint8_t* ts::LocatePattern(const void* area, size_t area_size, const void*
 
 const uint8_t* ts::LocateZeroZero(const void* area, size_t area_size, uint8_t third)
 {
-    const uint8_t* a = reinterpret_cast<const uint8_t*>(area);
+    return MemorySearch::Instance().zero_zero(reinterpret_cast<const uint8_t*>(area), area_size, third);
+}
+
+// Portable version.
+const uint8_t* ts::LocateZeroZeroGeneric(const uint8_t* area, size_t area_size, uint8_t third)
+{
+    const uint8_t* a = area;
     while (area_size >= 3) {
         const uint8_t* next = reinterpret_cast<const uint8_t*>(std::memchr(a, 0x00, area_size - 2));
         if (next == nullptr) {
@@ -80,6 +132,40 @@ const uint8_t* ts::LocateZeroZero(const void* area, size_t area_size, uint8_t th
 }
 
 
+//----------------------------------------------------------------------------
+// Locate all 3-byte patterns 00 00 XY into a memory area, with XY <= max.
+//----------------------------------------------------------------------------
+
+size_t ts::LocateAllZeroZero(std::vector<size_t>& offsets, const void* area, size_t area_size, uint8_t max_third)
+{
+    offsets.clear();
+    MemorySearch::Instance().all_zero_zero(offsets, reinterpret_cast<const uint8_t*>(area), area_size, max_third, 0);
+    return offsets.size();
+}
+
+// Portable version.
+void ts::LocateAllZeroZeroGeneric(std::vector<size_t>& offsets, const uint8_t* area, size_t area_size, uint8_t max_third, size_t base)
+{
+    size_t index = 0;
+    while (index + 3 <= area_size) {
+        const uint8_t* next = reinterpret_cast<const uint8_t*>(std::memchr(area + index, 0x00, area_size - index - 2));
+        if (next == nullptr) {
+            break;
+        }
+        index = next - area;
+        if (next[1] != 0x00) {
+            index += 2;
+        }
+        else {
+            if (next[2] <= max_third) {
+                offsets.push_back(base + index);
+            }
+            index++;
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Check if a memory area contains all identical byte values.
 //----------------------------------------------------------------------------
@@ -133,6 +133,19 @@ namespace ts {
     //!
     TSDUCKDLL const uint8_t* LocateZeroZero(const void* area, size_t area_size, uint8_t third);
 
+    //!
+    //! Locate all 3-byte patterns 00 00 XY into a memory area, where XY is lower than or equal to a maximum value.
+    //! This is typically used to locate all start code prefixes (00 00 01) in a video stream in one pass.
+    //! With the default @a max_third, the end of NALunits (00 00 00) are also located.
+    //! Overlapping patterns are all reported. For instance, 00 00 00 01 contains two patterns, at offsets 0 and 1.
+    //! @param [out] offsets Returned offsets of all patterns in @a area, in increasing order.
+    //! @param [in] area Address of a memory area to check.
+    //! @param [in] area_size Size in bytes of the memory area.
+    //! @param [in] max_third Maximum value of the third byte of the pattern, after 00 00.
+    //! @return The number of patterns which were found, same as @a offsets.size().
+    //!
+    TSDUCKDLL size_t LocateAllZeroZero(std::vector<size_t>& offsets, const void* area, size_t area_size, uint8_t max_third = 0x01);
+
     //!
     //! Check if a memory area contains all identical byte values.
     //! @param [in] area Address of a memory area to check.
@@ -196,8 +196,9 @@ public:
     // Start the transfer using WebRequest parameters.
     bool startTransfer(CertState certState);
 
-    // Close and cleanup everything.
-    void clear();
+    // Close and cleanup everything. When keepConnections is true, the curl_multi handler is
+    // preserved, with its cache of open connections, for the next transfer on the same server.
+    void clear(bool keepConnections = false);
 
     // Wait for data to be present in the reception buffer.
     // If maxSize is zero, wait until something is present in data buffer
@@ -227,7 +228,7 @@ private:
     char          _error[CURL_ERROR_SIZE] {0}; // Error message buffer for libcurl.
 
     // Close and cleanup everything with _mutex already held.
-    void clearUnderLock();
+    void clearUnderLock(bool keepConnections = false);
 
     // Handle an error while receiving data. Always return false.
     bool downloadError(const UString& message, bool* certError);
@@ -312,7 +313,7 @@ bool ts::WebRequest::receive(void* buffer, size_t maxSize, size_t& retSize)
 bool ts::WebRequest::close()
 {
     bool success = _isOpen;
-    _guts->clear();
+    _guts->clear(_keepConnections);
     _isOpen = false;
     return success;
 }
@@ -345,8 +346,8 @@ bool ts::WebRequest::SystemGuts::startTransfer(CertState certState)
     // Loop until all retries are exhausted.
     for (;;) {
 
-        // Make sure we start from a clean state.
-        clear();
+        // Make sure we start from a clean state. Keep open connections from previous transfers if requested.
+        clear(_request._keepConnections);
         _canRetry = retries > 0;
 
         // If no CA certificate file is specified, bypass certificate processing.
@@ -386,8 +387,8 @@ bool ts::WebRequest::SystemGuts::startTransfer(CertState certState)
 #if defined(TS_CURL_WAKEUP)
             std::lock_guard<std::mutex> lock(_mutex);
 #endif
-            // Initialize curl_multi and curl_easy
-            if ((_curlm = ::curl_multi_init()) == nullptr) {
+            // Initialize curl_multi and curl_easy. The curl_multi handler may be reused from a previous transfer.
+            if (_curlm == nullptr && (_curlm = ::curl_multi_init()) == nullptr) {
                 _request._report.error(u"libcurl 'curl_multi' initialization error");
                 return false;
             }
@@ -689,16 +690,16 @@ void ts::WebRequest::SystemGuts::abort()
 // Close and cleanup everything.
 //----------------------------------------------------------------------------
 
-void ts::WebRequest::SystemGuts::clear()
+void ts::WebRequest::SystemGuts::clear(bool keepConnections)
 {
 #if defined(TS_CURL_WAKEUP)
     // Make sure we don't call curl_multi_wakeup() while deallocating.
     std::lock_guard<std::mutex> lock(_mutex);
 #endif
-    clearUnderLock();
+    clearUnderLock(keepConnections);
 }
 
-void ts::WebRequest::SystemGuts::clearUnderLock()
+void ts::WebRequest::SystemGuts::clearUnderLock(bool keepConnections)
 {
     // Deallocate list of headers.
     if (_headers != nullptr) {
@@ -717,8 +718,8 @@ void ts::WebRequest::SystemGuts::clearUnderLock()
         _curl = nullptr;
     }
 
-    // Make sure the curl_multi is clean.
-    if (_curlm != nullptr) {
+    // Make sure the curl_multi is clean. Its connection cache is kept for the next transfer when requested.
+    if (_curlm != nullptr && !keepConnections) {
         ::curl_multi_cleanup(_curlm);
         _curlm = nullptr;
     }
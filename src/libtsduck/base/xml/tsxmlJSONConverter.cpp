@@ -67,6 +67,60 @@ ts::json::ValuePtr ts::xml::JSONConverter::convertToJSON(const Document& source,
 }
 
 
+//----------------------------------------------------------------------------
+// Get the JSON type of an XML attribute and its integer or boolean value.
+//----------------------------------------------------------------------------
+
+ts::xml::JSONConverter::AttributeType ts::xml::JSONConverter::GetAttributeType(const Element* model, const Element* source, const UString& name, const UString& value, const Tweaks& xml_tweaks, int64_t& int_value, bool& bool_value)
+{
+    // Get description of this attribute in the model.
+    UString description;
+    bool intModel = false;
+    bool boolModel = false;
+    if (model != nullptr) {
+        // Get description, empty string without error if not found.
+        model->getAttribute(description, name, false);
+        description.trim(true, false, false);
+        intModel = description.starts_with(u"uint", CASE_INSENSITIVE) || description.starts_with(u"int", CASE_INSENSITIVE);
+        boolModel = description.starts_with(u"bool", CASE_INSENSITIVE);
+    }
+
+    // Try to convert as an integer or boolean if defined as such by the model.
+    if (intModel) {
+        // Should be an integer according to the model.
+        if (value.toInteger(int_value, UString::DEFAULT_THOUSANDS_SEPARATOR)) {
+            // A "very negative" value is typically a large unsigned hexadecimal value which will not be
+            // handled correctly when reading back the JSON file. We cannot use hexadecimal literals in
+            // JSON (new in JSON 5), so we leave it as a string.
+            return int_value < -0xFFFFFFFFLL ? AttributeType::STRING : AttributeType::INTEGER;
+        }
+        else {
+            source->report().warning(u"attribute '%s' in <%s> line %d is '%s' but should be an integer", name, source->name(), source->lineNumber(), value);
+        }
+    }
+    else if (boolModel) {
+        // Should be a boolean according to the model.
+        if (value.toBool(bool_value)) {
+            return AttributeType::BOOLEAN;
+        }
+        else {
+            source->report().warning(u"attribute '%s' in <%s> line %d is '%s' but should be a boolean", name, source->name(), source->lineNumber(), value);
+        }
+    }
+
+    // Try to enforce integer of boolean value if specified on command line.
+    if (xml_tweaks.x2jEnforceInteger && !intModel && value.toInteger(int_value, UString::DEFAULT_THOUSANDS_SEPARATOR)) {
+        return AttributeType::INTEGER;
+    }
+    if (xml_tweaks.x2jEnforceBoolean && !boolModel && value.toBool(bool_value)) {
+        return AttributeType::BOOLEAN;
+    }
+
+    // Use a string value by default.
+    return AttributeType::STRING;
+}
+
+
 //----------------------------------------------------------------------------
 // Convert an XML tree of elements.
 //----------------------------------------------------------------------------
@@ -84,68 +138,20 @@ ts::json::ValuePtr ts::xml::JSONConverter::convertElementToJSON(const Element* m
 
     // Add attributes in the JSON object.
     for (const auto& it : attributes) {
-
-        // JSON value of the attribute.
-        json::ValuePtr jvalue;
         int64_t intValue = 0;
         bool boolValue = false;
-
-        // Get description of this attribute in the model.
-        UString description;
-        bool intModel = false;
-        bool boolModel = false;
-        if (model != nullptr) {
-            // Get description, empty string without error if not found.
-            model->getAttribute(description, it.first, false);
-            description.trim(true, false, false);
-            intModel = description.starts_with(u"uint", CASE_INSENSITIVE) || description.starts_with(u"int", CASE_INSENSITIVE);
-            boolModel = description.starts_with(u"bool", CASE_INSENSITIVE);
+        switch (GetAttributeType(model, source, it.first, it.second, xml_tweaks, intValue, boolValue)) {
+            case AttributeType::INTEGER:
+                jobj->add(it.first, std::make_shared<json::Number>(intValue));
+                break;
+            case AttributeType::BOOLEAN:
+                jobj->add(it.first, json::Bool(boolValue));
+                break;
+            case AttributeType::STRING:
+            default:
+                jobj->add(it.first, std::make_shared<json::String>(it.second));
+                break;
         }
-
-        // Try to convert as an integer or boolean if defined as such by the model.
-        if (intModel) {
-            // Should be an integer according to the model.
-            if (it.second.toInteger(intValue, UString::DEFAULT_THOUSANDS_SEPARATOR)) {
-                if (intValue < -0xFFFFFFFFLL) {
-                    // This is a "very negative" value. This is typically a large unsigned hexadecimal value
-                    // which will not be handled correctly when reading back the JSON file. We cannot use
-                    // hexadecimal literals in JSON (new in JSON 5), so we leave it as a string.
-                    jvalue = std::make_shared<json::String>(it.second);
-                }
-                else {
-                    // Acceptable integer.
-                    jvalue = std::make_shared<json::Number>(intValue);
-                }
-            }
-            else {
-                source->report().warning(u"attribute '%s' in <%s> line %d is '%s' but should be an integer", it.first, source->name(), source->lineNumber(), it.second);
-            }
-        }
-        else if (boolModel) {
-            // Should be a boolean according to the model.
-            if (it.second.toBool(boolValue)) {
-                jvalue = json::Bool(boolValue);
-            }
-            else {
-                source->report().warning(u"attribute '%s' in <%s> line %d is '%s' but should be a boolean", it.first, source->name(), source->lineNumber(), it.second);
-            }
-        }
-
-        // Try to enforce integer of boolean value if specified on command line.
-        if (jvalue == nullptr && xml_tweaks.x2jEnforceInteger && !intModel && it.second.toInteger(intValue, UString::DEFAULT_THOUSANDS_SEPARATOR)) {
-            jvalue = std::make_shared<json::Number>(intValue);
-        }
-        if (jvalue == nullptr && xml_tweaks.x2jEnforceBoolean && !boolModel && it.second.toBool(boolValue)) {
-            jvalue = json::Bool(boolValue);
-        }
-
-        // Use a string value by default.
-        if (jvalue == nullptr) {
-            jvalue = std::make_shared<json::String>(it.second);
-        }
-
-        // Add the attribute in the JSON object.
-        jobj->add(it.first, jvalue);
     }
 
     // Process the list of children, if any.
@@ -205,6 +211,147 @@ ts::json::ValuePtr ts::xml::JSONConverter::convertChildrenToJSON(const Element*
 }
 
 
+//----------------------------------------------------------------------------
+// Convert an XML element into JSON and print it directly.
+//----------------------------------------------------------------------------
+
+void ts::xml::JSONConverter::printJSON(TextFormatter& output, const Element* source) const
+{
+    if (source == nullptr) {
+        output << "null";
+    }
+    else {
+        printElementJSON(output, modelOf(source), source, tweaks());
+    }
+}
+
+ts::UString ts::xml::JSONConverter::oneLinerJSON(const Element* source) const
+{
+    TextFormatter out(report());
+    out.setString();
+    out.setEndOfLineMode(TextFormatter::EndOfLineMode::SPACING);
+    printJSON(out, source);
+    return out.toString();
+}
+
+
+//----------------------------------------------------------------------------
+// Find the model of an element, from the root of its document.
+//----------------------------------------------------------------------------
+
+const ts::xml::Element* ts::xml::JSONConverter::modelOf(const Element* source) const
+{
+    const Element* parent = dynamic_cast<const Element*>(source->parent());
+    if (parent != nullptr) {
+        return findModelElement(modelOf(parent), source->name());
+    }
+    else {
+        // Root of the source document, same rule as convertToJSON().
+        const Element* modelRoot = rootElement();
+        return modelRoot != nullptr && modelRoot->name().similar(source->name()) ? modelRoot : nullptr;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Print an XML tree of elements in JSON format.
+// Must produce exactly the same output as json::Object::print() on the
+// result of convertElementToJSON(). The fields of a JSON object are sorted
+// by name: "#name", "#nodes", then the attributes (XML attribute names
+// cannot start with a character which sorts before '#').
+//----------------------------------------------------------------------------
+
+void ts::xml::JSONConverter::printElementJSON(TextFormatter& output, const Element* model, const Element* source, const Tweaks& xml_tweaks) const
+{
+    output << "{" << ts::indent;
+    output << ts::endl << ts::margin << "\"#name\": \"" << source->name().toJSON() << '"';
+
+    // Process the list of children, if any.
+    if (source->hasChildren()) {
+        output << "," << ts::endl << ts::margin << "\"#nodes\": ";
+        printChildrenJSON(output, model, source, xml_tweaks);
+    }
+
+    // Get all attributes of the XML element, sorted by name.
+    std::map<UString,UString> attributes;
+    source->getAttributes(attributes);
+
+    for (const auto& it : attributes) {
+        output << "," << ts::endl << ts::margin << '"' << it.first.toJSON() << "\": ";
+        int64_t intValue = 0;
+        bool boolValue = false;
+        switch (GetAttributeType(model, source, it.first, it.second, xml_tweaks, intValue, boolValue)) {
+            case AttributeType::INTEGER:
+                output << UString::Decimal(intValue, 0, true, UString());
+                break;
+            case AttributeType::BOOLEAN:
+                output << (boolValue ? "true" : "false");
+                break;
+            case AttributeType::STRING:
+            default:
+                output << '"' << it.second.toJSON() << '"';
+                break;
+        }
+    }
+
+    output << ts::endl << ts::unindent << ts::margin << "}";
+}
+
+
+//----------------------------------------------------------------------------
+// Print all children of an element as a JSON array.
+// Must produce exactly the same output as json::Array::print() on the
+// result of convertChildrenToJSON().
+//----------------------------------------------------------------------------
+
+void ts::xml::JSONConverter::printChildrenJSON(TextFormatter& output, const Element* model, const Element* parent, const Tweaks& xml_tweaks) const
+{
+    output << "[" << ts::indent;
+
+    // Content of the text children in the model.
+    UString textModel;
+    bool getTextModel = model != nullptr;
+    bool hexaModel = false;
+
+    // Loop on all children nodes.
+    bool first = true;
+    bool lastNode = false;
+    for (const Node* child = parent->firstChild(); child != nullptr && !lastNode; child = child->nextSibling()) {
+        lastNode = child == parent->lastChild();
+
+        // Interpret the child either as an Element or a Text node.
+        // Other types of nodes are ignored.
+        const Element* elem = dynamic_cast<const Element*>(child);
+        const Text* text = dynamic_cast<const Text*>(child);
+
+        if (elem != nullptr || text != nullptr) {
+            if (!first) {
+                output << ",";
+            }
+            output << ts::endl << ts::margin;
+            first = false;
+        }
+        if (elem != nullptr) {
+            printElementJSON(output, findModelElement(model, elem->name()), elem, xml_tweaks);
+        }
+        else if (text != nullptr) {
+            UString content(text->value());
+            // Get the model description once only.
+            if (getTextModel) {
+                getTextModel = false;
+                model->getText(textModel, true);
+                hexaModel = textModel.starts_with(u"hexa", CASE_INSENSITIVE);
+            }
+            // Trim the text content according to model and command line options.
+            content.trim(hexaModel || xml_tweaks.x2jTrimText, hexaModel || xml_tweaks.x2jTrimText, hexaModel || xml_tweaks.x2jCollapseText);
+            output << '"' << content.toJSON() << '"';
+        }
+    }
+
+    output << ts::endl << ts::unindent << ts::margin << "]";
+}
+
+
 //----------------------------------------------------------------------------
 // Build a valid XML element name from a JSON string.
 //----------------------------------------------------------------------------
@@ -15,6 +15,7 @@
 #include "tsxmlDocument.h"
 #include "tsxmlModelDocument.h"
 #include "tsjson.h"
+#include "tsTextFormatter.h"
 #include "tsReport.h"
 
 namespace ts::xml {
@@ -75,6 +76,26 @@ namespace ts::xml {
         //!
         json::ValuePtr convertToJSON(const Document& source, bool force_root = false) const;
 
+        //!
+        //! Convert an XML element into JSON and print it directly, without building an intermediate JSON object.
+        //! The output is identical to printing the JSON object which is built by convertToJSON() for this element.
+        //! This is a faster alternative when the JSON object is only built to be serialized.
+        //! @param [in,out] output The output text formatter. The formatting options (indentation, end-of-line mode)
+        //! are used the same way as in json::Value::print().
+        //! @param [in] source The source XML element to convert. It is typically an element inside a document.
+        //! The model of that element is searched from the root of the source document. If null, a JSON
+        //! null value is printed.
+        //!
+        void printJSON(TextFormatter& output, const Element* source) const;
+
+        //!
+        //! Convert an XML element into a JSON one-liner, without building an intermediate JSON object.
+        //! The result is identical to json::Value::oneLiner() on the JSON object which is built by convertToJSON().
+        //! @param [in] source The source XML element to convert.
+        //! @return The JSON one-liner.
+        //!
+        UString oneLinerJSON(const Element* source) const;
+
         //!
         //! Convert a JSON object into an XML document.
         //! Not all JSON values can be converted. Basically, only JSON objects which were previously
@@ -105,6 +126,19 @@ namespace ts::xml {
         static const UString HashUnnamed;
 
     private:
+        // JSON type of a converted XML attribute.
+        enum class AttributeType {STRING, INTEGER, BOOLEAN};
+
+        // Get the JSON type of an XML attribute and its integer or boolean value.
+        static AttributeType GetAttributeType(const Element* model, const Element* source, const UString& name, const UString& value, const Tweaks&, int64_t& int_value, bool& bool_value);
+
+        // Find the model of an element, from the root of its document.
+        const Element* modelOf(const Element* source) const;
+
+        // Print an XML tree of elements or all children of an element in JSON format.
+        void printElementJSON(TextFormatter& output, const Element* model, const Element* source, const Tweaks&) const;
+        void printChildrenJSON(TextFormatter& output, const Element* model, const Element* parent, const Tweaks&) const;
+
         // Convert an XML tree of elements. Null pointer on error or if not convertible.
         json::ValuePtr convertElementToJSON(const Element* model, const Element* source, const Tweaks&) const;
 
@@ -32,6 +32,140 @@ ts::xml::ModelDocument::~ModelDocument()
 {
 }
 
+void ts::xml::ModelDocument::clear()
+{
+    // Invalidate the compiled model, it references the deleted elements.
+    std::lock_guard<std::mutex> lock(_compiled_mutex);
+    _compiled.clear();
+    _compiled_index.clear();
+    _compiled_root = nullptr;
+    _compiled_ok = false;
+    Document::clear();
+}
+
+
+
+//----------------------------------------------------------------------------
+// Compile the model.
+//----------------------------------------------------------------------------
+
+bool ts::xml::ModelDocument::compile() const
+{
+    std::lock_guard<std::mutex> lock(_compiled_mutex);
+    return compileLocked();
+}
+
+bool ts::xml::ModelDocument::compileLocked() const
+{
+    _compiled.clear();
+    _compiled_index.clear();
+    _compiled_root = rootElement();
+    _compiled_ok = true;
+
+    if (_compiled_root == nullptr) {
+        report().error(u"invalid XML model, no root element");
+        _compiled_ok = false;
+    }
+    else {
+        // Recursively compile all elements, starting at the root (index 0).
+        compileElement(_compiled_root);
+    }
+    return _compiled_ok;
+}
+
+
+bool ts::xml::ModelDocument::compileIfNeeded() const
+{
+    // An empty model is never compiled. This is not an error, some models are optional.
+    // Once compiled, the tables are no longer modified and can be read without lock.
+    const Element* root = rootElement();
+    std::lock_guard<std::mutex> lock(_compiled_mutex);
+    return root != nullptr && (root == _compiled_root ? _compiled_ok : compileLocked());
+}
+
+
+//----------------------------------------------------------------------------
+// Compile an element of the model, return its index in _compiled.
+//----------------------------------------------------------------------------
+
+size_t ts::xml::ModelDocument::compileElement(const Element* model) const
+{
+    // Each model element is compiled only once, even when referenced several times.
+    const auto it = _compiled_index.find(model);
+    if (it != _compiled_index.end()) {
+        return it->second;
+    }
+
+    const size_t index = _compiled.size();
+    _compiled_index[model] = index;
+    _compiled.emplace_back();
+    _compiled[index].model = model;
+
+    // Allowed attributes.
+    UStringList names;
+    model->getAttributesNames(names);
+    for (const auto& name : names) {
+        _compiled[index].attributes.insert(name.toLower());
+    }
+
+    // Allowed children, after resolution of references.
+    std::set<const Element*> references;
+    compileChildren(index, model, references);
+    return index;
+}
+
+
+//----------------------------------------------------------------------------
+// Add all children of a model element to a compiled element.
+//----------------------------------------------------------------------------
+
+void ts::xml::ModelDocument::compileChildren(size_t index, const Element* model, std::set<const Element*>& references) const
+{
+    for (const Element* child = model->firstChildElement(); child != nullptr; child = child->nextSiblingElement()) {
+        if (child->name().similar(TSXML_REF_NODE)) {
+            // The model contains a reference to a child of the root of the document.
+            // Example: <_any in="_descriptors"/> => all children of <_descriptors> are allowed.
+            // Invalid references are reported but ignored, the rest of the model is still usable.
+            const Element* ref = resolveReference(child);
+            if (ref != nullptr && references.insert(ref).second) {
+                compileChildren(index, ref, references);
+            }
+        }
+        else {
+            // When the same name is present several times, the first one is used.
+            UString name(child->name().toLower());
+            if (!_compiled[index].children.contains(name)) {
+                // Warning: compileElement() may reallocate _compiled, don't keep references across the call.
+                const size_t child_index = compileElement(child);
+                _compiled[index].children.emplace(std::move(name), child_index);
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Resolve a reference to an element inside the model root.
+//----------------------------------------------------------------------------
+
+const ts::xml::Element* ts::xml::ModelDocument::resolveReference(const Element* ref) const
+{
+    // Find the reference name, "_descriptors" in <_any in="_descriptors"/>.
+    const UString refName(ref->attribute(TSXML_REF_ATTR).value());
+    if (refName.empty()) {
+        report().error(u"invalid XML model, missing or empty attribute 'in' for <%s> at line %d", ref->name(), ref->lineNumber());
+        return nullptr;
+    }
+
+    // Locate the referenced node inside the model root.
+    const Document* document = ref->document();
+    const Element* root = document == nullptr ? nullptr : document->rootElement();
+    const Element* refElem = root == nullptr ? nullptr : root->findFirstChild(refName, true);
+    if (refElem == nullptr) {
+        report().error(u"invalid XML model, <%s> not found in model root, referenced in line %d", refName, ref->attribute(TSXML_REF_ATTR).lineNumber());
+    }
+    return refElem;
+}
 
 
 //----------------------------------------------------------------------------
@@ -51,13 +185,17 @@ bool ts::xml::ModelDocument::validate(const Document& doc) const
         report().error(u"invalid XML document, no root element");
         return false;
     }
-    else if (modelRoot->haveSameName(docRoot)) {
-        return validateElement(modelRoot, docRoot);
-    }
-    else {
+    else if (!modelRoot->haveSameName(docRoot)) {
         report().error(u"invalid XML document, expected <%s> as root, found <%s>", modelRoot->name(), docRoot->name());
         return false;
     }
+    else if (!compileIfNeeded()) {
+        report().error(u"invalid XML model document");
+        return false;
+    }
+    else {
+        return validateElement(_compiled[0], docRoot);
+    }
 }
 
 
@@ -65,17 +203,8 @@ bool ts::xml::ModelDocument::validate(const Document& doc) const
 // Validate an XML tree of elements, used by validate().
 //----------------------------------------------------------------------------
 
-bool ts::xml::ModelDocument::validateElement(const Element* model, const Element* doc) const
+bool ts::xml::ModelDocument::validateElement(const CompiledElement& model, const Element* doc) const
 {
-    if (model == nullptr) {
-        report().error(u"invalid XML model document");
-        return false;
-    }
-    if (doc == nullptr) {
-        report().error(u"invalid XML document");
-        return false;
-    }
-
     // Report all errors, return final status at the end.
     bool success = true;
 
@@ -85,7 +214,7 @@ bool ts::xml::ModelDocument::validateElement(const Element* model, const Element
 
     // Check that all attributes in doc exist in model.
     for (const auto& atname : names) {
-        if (!model->hasAttribute(atname)) {
+        if (!model.attributes.contains(atname.toLower())) {
             // The corresponding attribute does not exist in the model.
             const Attribute& attr(doc->attribute(atname));
             report().error(u"unexpected attribute '%s' in <%s>, line %d", attr.name(), doc->name(), attr.lineNumber());
@@ -95,13 +224,13 @@ bool ts::xml::ModelDocument::validateElement(const Element* model, const Element
 
     // Check that all children elements in doc exist in model.
     for (const Element* docChild = doc->firstChildElement(); docChild != nullptr; docChild = docChild->nextSiblingElement()) {
-        const Element* modelChild = findModelElement(model, docChild->name());
-        if (modelChild == nullptr) {
+        const auto it = model.children.find(docChild->name().toLower());
+        if (it == model.children.end()) {
             // The corresponding node does not exist in the model.
             report().error(u"unexpected node <%s> in <%s>, line %d", docChild->name(), doc->name(), docChild->lineNumber());
             success = false;
         }
-        else if (!validateElement(modelChild, docChild)) {
+        else if (!validateElement(_compiled[it->second], docChild)) {
             success = false;
         }
     }
@@ -117,44 +246,19 @@ bool ts::xml::ModelDocument::validateElement(const Element* model, const Element
 const ts::xml::Element* ts::xml::ModelDocument::findModelElement(const Element* elem, const UString& name) const
 {
     // Filter invalid parameters.
-    if (elem == nullptr || name.empty()) {
+    if (elem == nullptr || name.empty() || !compileIfNeeded()) {
         return nullptr;
     }
 
-    // Loop on all children.
-    for (const Element* child = elem->firstChildElement(); child != nullptr; child = child->nextSiblingElement()) {
-        if (name.similar(child->name())) {
-            // Found the child.
-            return child;
-        }
-        else if (child->name().similar(TSXML_REF_NODE)) {
-            // The model contains a reference to a child of the root of the document.
-            // Example: <_any in="_descriptors"/> => child is the <_any> node.
-            // Find the reference name, "_descriptors" in the example.
-            const UString refName(child->attribute(TSXML_REF_ATTR).value());
-            if (refName.empty()) {
-                report().error(u"invalid XML model, missing or empty attribute 'in' for <%s> at line %d", child->name(), child->lineNumber());
-            }
-            else {
-                // Locate the referenced node inside the model root.
-                const Document* document = elem->document();
-                const Element* root = document == nullptr ? nullptr : document->rootElement();
-                const Element* refElem = root == nullptr ? nullptr : root->findFirstChild(refName, true);
-                if (refElem == nullptr) {
-                    // The referenced element does not exist.
-                    report().error(u"invalid XML model, <%s> not found in model root, referenced in line %d", refName, child->attribute(TSXML_REF_ATTR).lineNumber());
-                }
-                else {
-                    // Check if the child is found inside the referenced element.
-                    const Element* e = findModelElement(refElem, name);
-                    if (e != nullptr) {
-                        return e;
-                    }
-                }
-            }
-        }
+    // Locate the compiled model element.
+    const auto it = _compiled_index.find(elem);
+    if (it == _compiled_index.end()) {
+        // Not an element from this model.
+        return nullptr;
     }
 
-    // Child node not found.
-    return nullptr;
+    // Locate the child.
+    const CompiledElement& model(_compiled[it->second]);
+    const auto child = model.children.find(name.toLower());
+    return child == model.children.end() ? nullptr : _compiled[child->second].model;
 }
@@ -27,6 +27,17 @@ namespace ts::xml {
     //! elements and attributes. There is no type checking, no cardinality check.
     //! Comments and texts are ignored. The values of attributes are ignored.
     //!
+    //! On first use, the model is compiled into a table of model elements, where the
+    //! allowed attributes and children of each element are found using hash tables
+    //! of lower-case names. All references to other elements ("_any" nodes) are resolved
+    //! once during the compilation. The validation of a document is consequently linear
+    //! in the size of the document. The model shall not be modified after being used.
+    //! If this is required, call compile() again after modifying the model.
+    //!
+    //! The compilation on first use is protected by a mutex. Once loaded, the same model
+    //! can be used to validate documents in several threads at the same time. Loading,
+    //! modifying or explicitly recompiling the model is not thread-safe.
+    //!
     class TSDUCKDLL ModelDocument: public Document
     {
         TS_NOCOPY(ModelDocument);
@@ -49,6 +60,17 @@ namespace ts::xml {
         //!
         bool validate(const Document& doc) const;
 
+        //!
+        //! Compile the model.
+        //! This is automatically done the first time the model is used. Calling this method
+        //! is necessary only when the model is modified after being used.
+        //! @return True on success, false if the model is invalid.
+        //!
+        bool compile() const;
+
+        // Inherited from xml::Node.
+        virtual void clear() override;
+
     protected:
         //!
         //! Find a child element by name in an XML model element.
@@ -59,12 +81,42 @@ namespace ts::xml {
         const Element* findModelElement(const Element* elem, const UString& name) const;
 
     private:
-        //!
-        //! Validate an XML tree of elements, used by validate().
-        //! @param [in] model The model element.
-        //! @param [in] doc The element to validate.
-        //! @return True if @a doc matches @a model, false if it does not.
-        //!
-        bool validateElement(const Element* model, const Element* doc) const;
+        // Hash function for names.
+        using NameHash = std::hash<std::u16string>;
+
+        // Compiled form of one element of the model.
+        // All names are stored in lower case because names are case-insensitive.
+        class CompiledElement
+        {
+        public:
+            const Element* model = nullptr;                               // Element in the model document.
+            std::unordered_set<UString, NameHash> attributes {};          // Allowed attribute names.
+            std::unordered_map<UString, size_t, NameHash> children {};    // Allowed children -> index in _compiled.
+        };
+
+        // Compiled form of the complete model.
+        mutable const Element* _compiled_root = nullptr;                        // Root of the model when compiled.
+        mutable bool _compiled_ok = false;                                      // Compilation status.
+        mutable std::vector<CompiledElement> _compiled {};                      // Compiled elements, index 0 is the root.
+        mutable std::unordered_map<const Element*, size_t> _compiled_index {}; // Model element -> index in _compiled.
+        mutable std::mutex _compiled_mutex {};                                 // Protect the compilation on first use.
+
+        // Compile the model if not yet done.
+        bool compileIfNeeded() const;
+
+        // Compile the model, the mutex must be held.
+        bool compileLocked() const;
+
+        // Compile an element of the model, return its index in _compiled.
+        size_t compileElement(const Element* model) const;
+
+        // Add all children of a model element to a compiled element, resolving references.
+        void compileChildren(size_t index, const Element* model, std::set<const Element*>& references) const;
+
+        // Resolve a reference to an element inside the model root (a "_any" node). Return null on error.
+        const Element* resolveReference(const Element* ref) const;
+
+        // Validate an XML tree of elements, used by validate().
+        bool validateElement(const CompiledElement& model, const Element* doc) const;
     };
 }
@@ -0,0 +1,408 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsxmlStreamingDocument.h"
+#include "tsxmlElement.h"
+#include "tsTextParser.h"
+#include "tsFileUtils.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::xml::StreamingDocument::StreamingDocument(Report& report) :
+    Document(report)
+{
+}
+
+ts::xml::StreamingDocument::~StreamingDocument()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Close the document.
+//----------------------------------------------------------------------------
+
+void ts::xml::StreamingDocument::close()
+{
+    if (_file.is_open()) {
+        _file.close();
+    }
+    _inline.str(std::string());
+    _in = nullptr;
+    _line.clear();
+    _lineNumber = 0;
+    _index = 0;
+    _capturing = false;
+    _capture.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Open an XML file.
+//----------------------------------------------------------------------------
+
+bool ts::xml::StreamingDocument::open(const UString& fileName, bool search)
+{
+    close();
+
+    // Specific case of inline XML content.
+    if (IsInlineXML(fileName)) {
+        _inline.clear();
+        _inline.str(fileName.toUTF8());
+        return open(_inline);
+    }
+
+    // Specific case of the standard input.
+    if (fileName.empty() || fileName == u"-") {
+        return open(std::cin);
+    }
+
+    // Actual file name to load after optional search in directories.
+    const UString actualFileName(search ? SearchConfigurationFile(fileName) : fileName);
+    if (actualFileName.empty()) {
+        report().error(u"file not found: %s", fileName);
+        return false;
+    }
+
+    report().debug(u"opening XML file %s", actualFileName);
+    _file.open(actualFileName.toUTF8());
+    if (!_file.is_open()) {
+        report().error(u"error reading file %s", actualFileName);
+        return false;
+    }
+    return open(_file);
+}
+
+
+//----------------------------------------------------------------------------
+// Start reading an XML document from a text stream.
+//----------------------------------------------------------------------------
+
+bool ts::xml::StreamingDocument::open(std::istream& strm)
+{
+    // Cleanup previous state. Don't close the file, we may read from it.
+    clear();
+    _in = &strm;
+    _line.clear();
+    _lineNumber = 0;
+    _index = 0;
+    _eof = false;
+
+    // Accumulate the prolog and the start tag of the root element.
+    _capture.clear();
+    _capturing = true;
+
+    bool found_root = false;
+    bool empty_root = false;
+    UChar c = CHAR_NULL;
+
+    while (!found_root && nextChar(c)) {
+        if (c != u'<') {
+            // Text outside markup, will be processed by the document parser.
+        }
+        else if (skipIf(u"?")) {
+            if (!skipUntil(u"?>")) {
+                break;
+            }
+        }
+        else if (skipIf(u"!--")) {
+            if (!skipUntil(u"-->")) {
+                break;
+            }
+        }
+        else if (skipIf(u"!")) {
+            // DTD, ignored but kept in the prolog.
+            if (!skipUntil(u">")) {
+                break;
+            }
+        }
+        else if (!skipStartTag(empty_root)) {
+            break;
+        }
+        else {
+            found_root = true;
+        }
+    }
+    _capturing = false;
+
+    if (!found_root) {
+        report().error(u"invalid XML document, no root element found");
+        close();
+        return false;
+    }
+
+    // Parse the prolog with an empty root element. The children are read by next().
+    if (!empty_root) {
+        assert(!_capture.empty() && _capture.back() == u'>');
+        _capture.insert(_capture.length() - 1, 1, u'/');
+    }
+    TextParser parser(_capture, report());
+    const bool success = parseNode(parser, nullptr);
+    _capture.clear();
+
+    if (!success) {
+        close();
+    }
+    else if (empty_root) {
+        // No child, this is the end of the document.
+        return closeDocument();
+    }
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Read the next top-level element.
+//----------------------------------------------------------------------------
+
+bool ts::xml::StreamingDocument::next()
+{
+    // Delete the previous top-level element. Keep the root element and its attributes.
+    Element* root = rootElement();
+    while (root != nullptr && root->hasChildren()) {
+        delete root->firstChild();
+    }
+
+    // Check that the document is currently open.
+    if (_in == nullptr || root == nullptr) {
+        return false;
+    }
+
+    UChar c = CHAR_NULL;
+    while (nextChar(c)) {
+        // Skip texts under the root element.
+        if (c != u'<') {
+            continue;
+        }
+
+        // Line number of the markup.
+        const size_t line = _lineNumber;
+
+        bool ok = true;
+        if (skipIf(u"!--")) {
+            ok = skipUntil(u"-->");
+        }
+        else if (skipIf(u"![CDATA[")) {
+            ok = skipUntil(u"]]>");
+        }
+        else if (skipIf(u"?")) {
+            ok = skipUntil(u"?>");
+        }
+        else if (skipIf(u"!")) {
+            ok = skipUntil(u">");
+        }
+        else if (skipIf(u"/")) {
+            // End tag of the root element, no more element.
+            if (skipUntil(u">")) {
+                closeDocument();
+                return false;
+            }
+            ok = false;
+        }
+        else {
+            // Start of a top-level element. Accumulate its text and parse it.
+            _capture.assign(1, u'<');
+            _capturing = true;
+            ok = skipElement();
+            _capturing = false;
+            if (ok) {
+                // Parse the element text as a child of the document. Then move it under the root element.
+                TextParser parser(report());
+                parser.loadDocument(_capture, line);
+                _capture.clear();
+                Element* elem = parseChildren(parser) ? dynamic_cast<Element*>(lastChild()) : nullptr;
+                if (elem == nullptr || elem == root) {
+                    report().error(u"line %d: invalid XML element", line);
+                    close();
+                    return false;
+                }
+                elem->reparent(root);
+                return true;
+            }
+        }
+        if (!ok) {
+            close();
+            return false;
+        }
+    }
+
+    // Reached end of input without closing the root element.
+    report().error(u"line %d: unexpected end of XML document, missing </%s>", _lineNumber, root->name());
+    close();
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Process the end of document after the end tag of the root element.
+//----------------------------------------------------------------------------
+
+bool ts::xml::StreamingDocument::closeDocument()
+{
+    // Only comments are allowed after the root element.
+    bool success = true;
+    UChar c = CHAR_NULL;
+    while (success && nextChar(c)) {
+        if (!IsSpace(c)) {
+            success = c == u'<' && skipIf(u"!--") && skipUntil(u"-->");
+        }
+    }
+    if (!success) {
+        report().error(u"line %d: trailing character sequence, invalid XML document", _lineNumber);
+    }
+    _eof = success;
+    close();
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Read the next input line or character.
+//----------------------------------------------------------------------------
+
+bool ts::xml::StreamingDocument::nextLine()
+{
+    if (_in == nullptr || !_line.getLine(*_in)) {
+        return false;
+    }
+    if (_capturing && _lineNumber > 0) {
+        _capture.push_back(u'\n');
+    }
+    _lineNumber++;
+    _index = 0;
+    return true;
+}
+
+bool ts::xml::StreamingDocument::nextChar(UChar& c)
+{
+    while (_index >= _line.length()) {
+        if (!nextLine()) {
+            return false;
+        }
+    }
+    c = _line[_index++];
+    if (_capturing) {
+        _capture.push_back(c);
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Skip strings and tokens.
+//----------------------------------------------------------------------------
+
+bool ts::xml::StreamingDocument::skipIf(const UChar* str)
+{
+    const size_t len = std::char_traits<UChar>::length(str);
+    if (_index + len <= _line.length() && _line.compare(_index, len, str, len) == 0) {
+        if (_capturing) {
+            _capture.append(str, len);
+        }
+        _index += len;
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+bool ts::xml::StreamingDocument::skipUntil(const UString& token)
+{
+    // The tokens we search never contain line breaks. Search line by line.
+    for (;;) {
+        const size_t pos = _line.find(token, _index);
+        const size_t end = pos == NPOS ? _line.length() : pos + token.length();
+        if (_capturing) {
+            _capture.append(_line, _index, end - _index);
+        }
+        _index = end;
+        if (pos != NPOS) {
+            return true;
+        }
+        else if (!nextLine()) {
+            report().error(u"line %d: unexpected end of XML document, missing \"%s\"", _lineNumber, token);
+            return false;
+        }
+    }
+}
+
+bool ts::xml::StreamingDocument::skipStartTag(bool& empty)
+{
+    // The tag ends with the first '>' which is not part of an attribute value.
+    UChar quote = CHAR_NULL;
+    UChar prev = CHAR_NULL;
+    UChar c = CHAR_NULL;
+    while (nextChar(c)) {
+        if (quote != CHAR_NULL) {
+            if (c == quote) {
+                quote = CHAR_NULL;
+            }
+        }
+        else if (c == u'"' || c == u'\'') {
+            quote = c;
+        }
+        else if (c == u'>') {
+            empty = prev == u'/';
+            return true;
+        }
+        prev = c;
+    }
+    report().error(u"line %d: unexpected end of XML document, unterminated tag", _lineNumber);
+    return false;
+}
+
+bool ts::xml::StreamingDocument::skipElement()
+{
+    // Skip the start tag of the element.
+    bool empty = false;
+    if (!skipStartTag(empty)) {
+        return false;
+    }
+
+    // Skip the content of the element, up to its end tag.
+    size_t depth = empty ? 0 : 1;
+    bool ok = true;
+    UChar c = CHAR_NULL;
+    while (ok && depth > 0) {
+        if (!nextChar(c)) {
+            report().error(u"line %d: unexpected end of XML document, unterminated element", _lineNumber);
+            return false;
+        }
+        else if (c != u'<') {
+            // Text inside the element.
+        }
+        else if (skipIf(u"!--")) {
+            ok = skipUntil(u"-->");
+        }
+        else if (skipIf(u"![CDATA[")) {
+            ok = skipUntil(u"]]>");
+        }
+        else if (skipIf(u"?")) {
+            ok = skipUntil(u"?>");
+        }
+        else if (skipIf(u"/")) {
+            ok = skipUntil(u">");
+            depth--;
+        }
+        else if (skipIf(u"!")) {
+            ok = skipUntil(u">");
+        }
+        else {
+            ok = skipStartTag(empty);
+            if (!empty) {
+                depth++;
+            }
+        }
+    }
+    return ok;
+}
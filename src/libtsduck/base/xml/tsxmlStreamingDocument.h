@@ -0,0 +1,128 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Representation of a "streaming" XML document which is read on the fly.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsxmlDocument.h"
+
+namespace ts::xml {
+    //!
+    //! Representation of a "streaming" XML document which is read on the fly.
+    //! @ingroup xml
+    //!
+    //! This is the input counterpart of RunningDocument. The idea is to read
+    //! an arbitrary large XML document, one top-level element at a time, without
+    //! loading the complete document in memory.
+    //!
+    //! When the document is open, it contains the prolog of the XML file (declaration,
+    //! comments) and its root element, with all its attributes, but without children.
+    //! Each call to next() replaces the previous child element of the root by the next
+    //! one in the file. At any time, the document contains at most one child element
+    //! under its root. It can be validated using a ModelDocument like any other document.
+    //!
+    //! Only the text of the current top-level element is kept in memory. Comments and
+    //! texts directly under the root element are ignored.
+    //!
+    //! The input is read line by line. The memory bound therefore assumes a document
+    //! with line breaks between elements, as generated by TSDuck and most XML tools.
+    //! When the complete document is on one single line, this line is entirely
+    //! buffered in memory, even though the elements are still returned one by one.
+    //!
+    class TSDUCKDLL StreamingDocument: public Document
+    {
+        TS_NOCOPY(StreamingDocument);
+    public:
+        //!
+        //! Constructor.
+        //! @param [in,out] report Where to report errors.
+        //!
+        explicit StreamingDocument(Report& report = NULLREP);
+
+        //!
+        //! Destructor.
+        //!
+        virtual ~StreamingDocument() override;
+
+        //!
+        //! Open an XML file and read its prolog and the start of its root element.
+        //! @param [in] fileName Name of the XML file to load.
+        //! If @a fileName is empty or "-", read the standard input.
+        //! If @a fileName starts with "<?xml", this is considered as "inline XML content".
+        //! @param [in] search If true, search the XML file in the TSDuck configuration directories
+        //! if @a fileName is not found and does not contain any directory part.
+        //! @return True on success, false on error.
+        //! @see Document::load()
+        //!
+        bool open(const UString& fileName, bool search = false);
+
+        //!
+        //! Start reading an XML document from a text stream.
+        //! The prolog and the start of the root element are read.
+        //! @param [in,out] strm A standard text stream in input mode.
+        //! The referenced stream object must remain valid until close() or end of document.
+        //! @return True on success, false on error.
+        //!
+        bool open(std::istream& strm);
+
+        //!
+        //! Read the next top-level element, under the root element of the document.
+        //! The previous top-level element, if any, is deleted from the document.
+        //! @return True when a new element is loaded, false at end of document or on error.
+        //! Use eof() to check if the document was entirely read without error.
+        //!
+        bool next();
+
+        //!
+        //! Check if the end of document was reached without error.
+        //! @return True when the root element was closed and the document was entirely read.
+        //!
+        bool eof() const { return _eof; }
+
+        //!
+        //! Close the document.
+        //! The input file, if any, is closed. The content of the document is left unmodified.
+        //!
+        void close();
+
+    private:
+        std::ifstream      _file {};             // Input file, when one was opened.
+        std::istringstream _inline {};           // Inline XML content.
+        std::istream*      _in = nullptr;        // Current input stream.
+        UString            _line {};             // Current input line.
+        size_t             _lineNumber = 0;      // Current input line number.
+        size_t             _index = 0;           // Index of next character in _line.
+        bool               _capturing = false;   // Accumulate input characters in _capture.
+        UString            _capture {};          // Text of the current markup.
+        bool               _eof = false;         // Root element completely read.
+
+        // Read the next input line. Return false at end of input.
+        bool nextLine();
+
+        // Read the next input character, skip line breaks. Return false at end of input.
+        bool nextChar(UChar& c);
+
+        // Check if the rest of the current line starts with a string. If it does, skip it.
+        bool skipIf(const UChar* str);
+
+        // Skip characters up to and including the specified token. Return false at end of input.
+        bool skipUntil(const UString& token);
+
+        // Skip a start tag, after the initial '<'. Set 'empty' if the tag ends with "/>".
+        bool skipStartTag(bool& empty);
+
+        // Skip a complete element, after the initial '<' of its start tag.
+        bool skipElement();
+
+        // Process the end of document after the end tag of the root element.
+        bool closeDocument();
+    };
+}
@@ -27,6 +27,30 @@
 // Constant string "Unreferenced"
 const ts::UString ts::TSAnalyzer::UNREFERENCED(u"Unreferenced");
 
+// Parameters of the bounded-memory mode.
+namespace {
+    // Number of TS packets between two pruning passes.
+    constexpr ts::PacketCounter PRUNE_INTERVAL = 10'000;
+
+    // Estimated overhead of a node in a std::map or std::set and of the control block of a std::shared_ptr.
+    constexpr size_t NODE_OVERHEAD = 4 * sizeof(void*);
+    constexpr size_t SHARED_OVERHEAD = 2 * sizeof(void*) + 2 * sizeof(long);
+
+    // Estimated memory footprint of dynamic structures.
+    size_t StringFootprint(const ts::UString& str)
+    {
+        return str.capacity() * sizeof(ts::UChar);
+    }
+    size_t StringsFootprint(const ts::UStringVector& vec)
+    {
+        size_t size = vec.capacity() * sizeof(ts::UString);
+        for (const auto& str : vec) {
+            size += StringFootprint(str);
+        }
+        return size;
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Constructor for the TS analyzer
@@ -37,6 +61,8 @@ ts::TSAnalyzer::TSAnalyzer(DuckContext& duck, const BitRate& bitrate_hint, BitRa
     _ts_user_bitrate(bitrate_hint),
     _ts_user_br_confidence(bitrate_confidence)
 {
+    // All EIT's are analyzed. On EIT-heavy streams, a memory arena reduces the cost of section allocation.
+    _demux.useSectionArena(true);
     resetSectionDemux();
 }
 
@@ -105,6 +131,12 @@ void ts::TSAnalyzer::reset()
     _t2mi_demux.reset();
     _lcn.clear();
     _dct.invalidate();
+    _pruned_pid_cnt = 0;
+    _pruned_table_cnt = 0;
+    _pruned_service_cnt = 0;
+    if (_next_prune_pkt != 0) {
+        _next_prune_pkt = PRUNE_INTERVAL;
+    }
 
     resetSectionDemux();
 }
@@ -255,6 +287,7 @@ ts::TSAnalyzer::XTIDContextPtr ts::TSAnalyzer::getXTID(const Section& section)
         XTIDContextPtr result = std::make_shared<XTIDContext>(xtid);
         pc->sections[xtid] = result;
         result->first_version = section.version();
+        result->last_section_pkt = _ts_pkt_cnt;
         return result;
     }
 }
@@ -269,7 +302,9 @@ ts::TSAnalyzer::PIDContextPtr ts::TSAnalyzer::getPID(PID pid, const UString& des
     const PIDContextPtr p(_pids[pid]);
     if (p == nullptr) {
         // The PID was not yet used, map entry just created.
-        return _pids[pid] = std::make_shared<PIDContext>(pid, description);
+        PIDContextPtr result = _pids[pid] = std::make_shared<PIDContext>(pid, description);
+        result->last_pkt = _ts_pkt_cnt;
+        return result;
     }
     else {
         // If the PID was marked as unreferenced, now use actual description.
@@ -355,6 +390,7 @@ void ts::TSAnalyzer::handleSection(SectionDemux&, const Section& section)
 
     // Count one section
     etc->section_count++;
+    etc->last_section_pkt = _ts_pkt_cnt;
 
     // Section# 0 is used to track tables
     if (section.sectionNumber() == 0) {
@@ -1422,6 +1458,11 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt, const TSPacketMetadata& mda
     _ts_pkt_cnt++;
     uint64_t packet_index(_ts_pkt_cnt);
 
+    // In bounded-memory mode, periodically prune the old contexts.
+    if (_next_prune_pkt != 0 && _ts_pkt_cnt >= _next_prune_pkt) {
+        pruneContexts();
+    }
+
     // Detect and ignore invalid packets
     bool invalid_packet = false;
     if (!pkt.hasValidSync()) {
@@ -1461,6 +1502,7 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt, const TSPacketMetadata& mda
     // Get PID context
     PIDContextPtr ps(getPID(pkt.getPID()));
     ps->ts_pkt_cnt++;
+    ps->last_pkt = packet_index;
 
     // Accumulate stat from packet
     if (pkt.hasAF()) {
@@ -1515,7 +1557,9 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt, const TSPacketMetadata& mda
     if (ps->pid != PID_NULL) {
         if (ps->ts_pkt_cnt == 1) {
             // First packet, initialize continuity
-            ps->cur_continuity = pkt.getCC();
+            ps->cur_continuity = ps->first_continuity = pkt.getCC();
+            ps->first_discontinuity = pkt.getDiscontinuityIndicator();
+            ps->first_payload = pkt.hasPayload();
         }
         else if (pkt.getDiscontinuityIndicator()) {
             // Expected discontinuity
@@ -1674,6 +1718,505 @@ void ts::TSAnalyzer::setBitrateHint(const BitRate& bitrate_hint, BitRateConfiden
 }
 
 
+//----------------------------------------------------------------------------
+// Merge the analysis of the packets which immediately follow.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::merge(const TSAnalyzer& next)
+{
+    // Packet indexes in the next analysis are relative to the end of this one.
+    const uint64_t offset = _ts_pkt_cnt;
+
+    // Global counters and time stamps.
+    if (next._ts_id.has_value()) {
+        _ts_id = next._ts_id;
+    }
+    _ts_pkt_cnt += next._ts_pkt_cnt;
+    _invalid_sync += next._invalid_sync;
+    _transport_errors += next._transport_errors;
+    _suspect_ignored += next._suspect_ignored;
+    _ts_bitrate_sum += next._ts_bitrate_sum;
+    _ts_bitrate_cnt += next._ts_bitrate_cnt;
+    _preceding_errors = next._preceding_errors;
+    _preceding_suspects = next._preceding_suspects;
+    _pruned_pid_cnt += next._pruned_pid_cnt;
+    _pruned_table_cnt += next._pruned_table_cnt;
+    _pruned_service_cnt += next._pruned_service_cnt;
+    _tid_present |= next._tid_present;
+    if (_first_utc == Time::Epoch) {
+        _first_utc = next._first_utc;
+        _first_local = next._first_local;
+    }
+    if (_first_tdt == Time::Epoch) {
+        _first_tdt = next._first_tdt;
+    }
+    if (next._last_tdt != Time::Epoch) {
+        _last_tdt = next._last_tdt;
+    }
+    if (_first_tot == Time::Epoch) {
+        _first_tot = next._first_tot;
+    }
+    if (next._last_tot != Time::Epoch) {
+        _last_tot = next._last_tot;
+    }
+    if (_first_stt == Time::Epoch) {
+        _first_stt = next._first_stt;
+    }
+    if (next._last_stt != Time::Epoch) {
+        _last_stt = next._last_stt;
+    }
+    if (!next._country_code.empty()) {
+        _country_code = next._country_code;
+    }
+    _lcn.addFrom(next._lcn);
+    if (&_duck != &next._duck) {
+        _duck.addStandards(next._duck.standards());
+    }
+
+    // Merge services. The synthetic data from the tables of the next analysis are more recent.
+    for (const auto& it : next._services) {
+        const ServiceContext& nsv(*it.second);
+        ServiceContext& sv(*getService(it.first));
+        if (nsv.orig_netw_id.has_value()) {
+            sv.orig_netw_id = nsv.orig_netw_id;
+        }
+        if (nsv.lcn.has_value()) {
+            sv.lcn = nsv.lcn;
+        }
+        if (nsv.service_type != 0) {
+            sv.service_type = nsv.service_type;
+        }
+        if (!nsv.name.empty()) {
+            sv.name = nsv.name;
+        }
+        if (!nsv.provider.empty()) {
+            sv.provider = nsv.provider;
+        }
+        if (nsv.pmt_pid != PID_PAT) {
+            sv.pmt_pid = nsv.pmt_pid;
+        }
+        if (nsv.pcr_pid != PID_PAT) {
+            sv.pcr_pid = nsv.pcr_pid;
+        }
+        sv.hidden = sv.hidden || nsv.hidden;
+        sv.carry_ssu = sv.carry_ssu || nsv.carry_ssu;
+        sv.carry_t2mi = sv.carry_t2mi || nsv.carry_t2mi;
+    }
+
+    // Merge PID's.
+    for (const auto& it : next._pids) {
+        mergePID(*getPID(it.first, it.second->description), *it.second, offset);
+    }
+
+    // A pending ISDB DCT is analyzed as soon as the TS id is known.
+    if (next._dct.isValid()) {
+        if (_ts_id.has_value()) {
+            analyzeDCT(next._dct);
+        }
+        else {
+            _dct = next._dct;
+        }
+    }
+
+    _modified = true;
+}
+
+
+//----------------------------------------------------------------------------
+// Merge the analysis of a PID from the next chunk of packets.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::mergePID(PIDContext& pc, const PIDContext& next, uint64_t offset)
+{
+    // Check the continuity between the last packet of this analysis and the first packet of the next one.
+    // This is the same processing as in feedPacket().
+    if (pc.ts_pkt_cnt > 0 && next.ts_pkt_cnt > 0 && pc.pid != PID_NULL) {
+        if (next.first_discontinuity) {
+            pc.exp_discont++;
+        }
+        else if (next.first_payload) {
+            if (next.first_continuity == pc.cur_continuity) {
+                pc.duplicated++;
+            }
+            else if (next.first_continuity != (pc.cur_continuity + 1) % CC_MAX) {
+                pc.unexp_discont++;
+            }
+        }
+        else if (next.first_continuity != pc.cur_continuity) {
+            pc.unexp_discont++;
+        }
+    }
+
+    // Same thing for clock leaps between the last and first time stamps.
+    if (pc.last_pcr != INVALID_PCR && next.first_pcr != INVALID_PCR && (pc.last_pcr > next.first_pcr || (next.first_pcr - pc.last_pcr) > SYSTEM_CLOCK_FREQ)) {
+        pc.pcr_leap_cnt++;
+    }
+    if (pc.last_pts != INVALID_PTS && next.first_pts != INVALID_PTS) {
+        const uint64_t diff = next.first_pts > pc.last_pts ? next.first_pts - pc.last_pts : pc.last_pts - next.first_pts;
+        if (diff > 3 * SYSTEM_CLOCK_SUBFREQ) {
+            pc.pts_leap_cnt++;
+        }
+    }
+    if (pc.last_dts != INVALID_DTS && next.first_dts != INVALID_DTS && (pc.last_dts > next.first_dts || (next.first_dts - pc.last_dts) > 3 * SYSTEM_CLOCK_SUBFREQ)) {
+        pc.dts_leap_cnt++;
+    }
+
+    // Global counts of PID's, which are not recomputed by recomputeStatistics().
+    if (next.scrambled && !pc.scrambled) {
+        _scrambled_pid_cnt++;
+    }
+    if (next.pcr_cnt > 0 && pc.pcr_cnt == 0) {
+        _pcr_pid_cnt++;
+    }
+
+    // Synthetic data from the tables.
+    if (pc.description.empty() || pc.description == UNREFERENCED) {
+        pc.description = next.description;
+    }
+    if (pc.comment.empty()) {
+        pc.comment = next.comment;
+    }
+    for (const auto& lang : next.languages) {
+        AppendUnique(pc.languages, lang);
+    }
+    for (const auto& attr : next.attributes) {
+        AppendUnique(pc.attributes, attr);
+    }
+    pc.services.insert(next.services.begin(), next.services.end());
+    pc.cas_operators.insert(next.cas_operators.begin(), next.cas_operators.end());
+    pc.ssu_oui.insert(next.ssu_oui.begin(), next.ssu_oui.end());
+    pc.is_pmt_pid = pc.is_pmt_pid || next.is_pmt_pid;
+    pc.is_pcr_pid = pc.is_pcr_pid || next.is_pcr_pid;
+    pc.referenced = pc.referenced || next.referenced;
+    pc.optional = pc.optional && next.optional;
+    pc.carry_pes = pc.carry_pes || next.carry_pes;
+    pc.carry_section = pc.carry_section || next.carry_section;
+    pc.carry_ecm = pc.carry_ecm || next.carry_ecm;
+    pc.carry_emm = pc.carry_emm || next.carry_emm;
+    pc.carry_audio = pc.carry_audio || next.carry_audio;
+    pc.carry_video = pc.carry_video || next.carry_video;
+    pc.carry_t2mi = pc.carry_t2mi || next.carry_t2mi;
+    pc.carry_iip = pc.carry_iip || next.carry_iip;
+    pc.scrambled = pc.scrambled || next.scrambled;
+    if (next.pes_stream_id != 0) {
+        pc.same_stream_id = pc.pes_stream_id == 0 ? next.same_stream_id : pc.same_stream_id && next.same_stream_id && pc.pes_stream_id == next.pes_stream_id;
+        if (pc.pes_stream_id == 0) {
+            pc.pes_stream_id = next.pes_stream_id;
+        }
+    }
+    if (next.stream_type != 0) {
+        pc.stream_type = next.stream_type;
+    }
+    if (pc.cas_id == 0) {
+        pc.cas_id = next.cas_id;
+    }
+
+    // Counters.
+    pc.ts_af_cnt += next.ts_af_cnt;
+    pc.unit_start_cnt += next.unit_start_cnt;
+    pc.pl_start_cnt += next.pl_start_cnt;
+    pc.unexp_discont += next.unexp_discont;
+    pc.exp_discont += next.exp_discont;
+    pc.duplicated += next.duplicated;
+    pc.ts_sc_cnt += next.ts_sc_cnt;
+    pc.inv_ts_sc_cnt += next.inv_ts_sc_cnt;
+    pc.inv_sections += next.inv_sections;
+    pc.inv_pes += next.inv_pes;
+    pc.inv_pes_start += next.inv_pes_start;
+    pc.t2mi_cnt += next.t2mi_cnt;
+    pc.pcr_cnt += next.pcr_cnt;
+    pc.pts_cnt += next.pts_cnt;
+    pc.dts_cnt += next.dts_cnt;
+    pc.pcr_leap_cnt += next.pcr_leap_cnt;
+    pc.pts_leap_cnt += next.pts_leap_cnt;
+    pc.dts_leap_cnt += next.dts_leap_cnt;
+    pc.ts_bitrate_sum += next.ts_bitrate_sum;
+    pc.ts_bitrate_cnt += next.ts_bitrate_cnt;
+    pc.isdb_layers.accumulate(next.isdb_layers);
+    for (const auto& it : next.t2mi_plp_ts) {
+        pc.t2mi_plp_ts[it.first] += it.second;
+    }
+
+    // First and last time stamps.
+    if (pc.first_pcr == INVALID_PCR) {
+        pc.first_pcr = next.first_pcr;
+    }
+    if (next.last_pcr != INVALID_PCR) {
+        pc.last_pcr = next.last_pcr;
+    }
+    if (pc.first_pts == INVALID_PTS) {
+        pc.first_pts = next.first_pts;
+    }
+    if (next.last_pts != INVALID_PTS) {
+        pc.last_pts = next.last_pts;
+    }
+    if (pc.first_dts == INVALID_DTS) {
+        pc.first_dts = next.first_dts;
+    }
+    if (next.last_dts != INVALID_DTS) {
+        pc.last_dts = next.last_dts;
+    }
+
+    // The first crypto-period of the next analysis is truncated and its duration is not counted.
+    // Exclude it from the number of crypto-periods which are used to compute the average.
+    if (next.cryptop_cnt > 0) {
+        pc.cryptop_cnt += pc.cryptop_cnt == 0 ? next.cryptop_cnt : next.cryptop_cnt - 1;
+        pc.cryptop_ts_cnt += next.cryptop_ts_cnt;
+    }
+
+    // Merge the tables. A PMT which is repeated at the boundary is counted only once.
+    uint64_t same_pmt = 0;
+    for (const auto& it : next.sections) {
+        XTIDContextPtr& xt(pc.sections[it.first]);
+        if (xt == nullptr) {
+            xt = std::make_shared<XTIDContext>(it.first);
+            xt->first_version = it.second->first_version;
+        }
+        if (MergeXTID(*xt, *it.second, offset) && it.first.tid() == TID_PMT) {
+            same_pmt++;
+        }
+    }
+    pc.pmt_cnt += next.pmt_cnt - std::min(same_pmt, next.pmt_cnt);
+
+    // Analysis state at the end of the next analysis.
+    if (next.ts_pkt_cnt > 0) {
+        if (pc.ts_pkt_cnt == 0) {
+            pc.first_continuity = next.first_continuity;
+            pc.first_discontinuity = next.first_discontinuity;
+            pc.first_payload = next.first_payload;
+        }
+        pc.ts_pkt_cnt += next.ts_pkt_cnt;
+        pc.cur_continuity = next.cur_continuity;
+        pc.last_pkt = next.last_pkt + offset;
+        if (next.cur_ts_sc != SC_CLEAR) {
+            pc.cur_ts_sc = next.cur_ts_sc;
+            pc.cur_ts_sc_pkt = next.cur_ts_sc_pkt + offset;
+        }
+        if (next.br_last_pcr != INVALID_PCR) {
+            pc.br_last_pcr = next.br_last_pcr;
+            pc.br_last_pcr_pkt = next.br_last_pcr_pkt + offset;
+        }
+    }
+    if (next.audio2.isValid()) {
+        pc.audio2 = next.audio2;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Merge the analysis of a table from the next chunk of packets.
+// Return true if the first table in next has the same version as the last one.
+//----------------------------------------------------------------------------
+
+bool ts::TSAnalyzer::MergeXTID(XTIDContext& xt, const XTIDContext& next, uint64_t offset)
+{
+    bool same_version = false;
+
+    xt.section_count += next.section_count;
+    xt.last_section_pkt = std::max(xt.last_section_pkt, next.last_section_pkt + offset);
+
+    if (next.table_count > 0) {
+        if (xt.table_count == 0) {
+            xt.first_version = next.first_version;
+            xt.first_pkt = next.first_pkt + offset;
+            xt.table_count = next.table_count;
+            xt.repetition_ts = next.repetition_ts;
+            xt.min_repetition_ts = next.min_repetition_ts;
+            xt.max_repetition_ts = next.max_repetition_ts;
+        }
+        else {
+            // Repetition interval between the last table in this analysis and the first table in the next one.
+            const uint64_t rep = next.first_pkt + offset - xt.last_pkt;
+            xt.min_repetition_ts = xt.table_count < 2 ? rep : std::min(xt.min_repetition_ts, rep);
+            xt.max_repetition_ts = xt.table_count < 2 ? rep : std::max(xt.max_repetition_ts, rep);
+            if (next.table_count > 1) {
+                xt.min_repetition_ts = std::min(xt.min_repetition_ts, next.min_repetition_ts);
+                xt.max_repetition_ts = std::max(xt.max_repetition_ts, next.max_repetition_ts);
+            }
+            same_version = next.first_version == xt.last_version;
+            xt.table_count += next.table_count;
+            xt.repetition_ts = (next.last_pkt + offset - xt.first_pkt + (xt.table_count - 1) / 2) / (xt.table_count - 1);
+        }
+        xt.last_pkt = next.last_pkt + offset;
+        xt.last_version = next.last_version;
+    }
+    xt.versions |= next.versions;
+
+    return same_version;
+}
+
+
+//----------------------------------------------------------------------------
+// Set memory limits for long-running analysis (bounded-memory mode).
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::setMemoryLimits(cn::milliseconds unseen, size_t max_bytes)
+{
+    _prune_unseen = unseen;
+    _max_memory = max_bytes;
+    _next_prune_pkt = _prune_unseen > cn::milliseconds::zero() || _max_memory > 0 ? _ts_pkt_cnt + PRUNE_INTERVAL : 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Estimate the memory footprint of the analysis contexts.
+//----------------------------------------------------------------------------
+
+size_t ts::TSAnalyzer::pidFootprint(const PIDContext& pc) const
+{
+    return sizeof(PIDContextMap::value_type) + SHARED_OVERHEAD + sizeof(PIDContext) +
+        StringFootprint(pc.description) + StringFootprint(pc.comment) +
+        StringsFootprint(pc.languages) + StringsFootprint(pc.attributes) +
+        pc.services.size() * (NODE_OVERHEAD + sizeof(uint16_t)) +
+        (pc.cas_operators.size() + pc.ssu_oui.size()) * (NODE_OVERHEAD + sizeof(uint32_t)) +
+        (pc.isdb_layers.size() + pc.t2mi_plp_ts.size()) * (NODE_OVERHEAD + 2 * sizeof(uint64_t)) +
+        pc.sections.size() * (NODE_OVERHEAD + sizeof(XTIDContextMap::value_type) + SHARED_OVERHEAD + sizeof(XTIDContext));
+}
+
+size_t ts::TSAnalyzer::memoryFootprint() const
+{
+    size_t size = sizeof(TSAnalyzer);
+    for (const auto& it : _pids) {
+        size += pidFootprint(*it.second);
+    }
+    for (const auto& it : _services) {
+        const ServiceContext& sv(*it.second);
+        size += NODE_OVERHEAD + sizeof(ServiceContextMap::value_type) + SHARED_OVERHEAD + sizeof(ServiceContext) +
+            StringFootprint(sv.name) + StringFootprint(sv.provider) +
+            sv.isdb_layers.size() * (NODE_OVERHEAD + 2 * sizeof(uint64_t));
+    }
+    return size;
+}
+
+
+//----------------------------------------------------------------------------
+// Bounded-memory mode: remove one PID context.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::removePID(PID pid)
+{
+    const auto it = _pids.find(pid);
+    if (it == _pids.end()) {
+        return;
+    }
+    const PIDContextPtr pc(it->second);
+    _pids.erase(it);
+    _pruned_pid_cnt++;
+    _pruned_table_cnt += pc->sections.size();
+    _modified = true;
+
+    // Forget the PID in the demux. If it comes back, it will be analyzed from scratch.
+    _demux.resetPID(pid);
+    _pes_demux.resetPID(pid);
+
+    // If the PID is referenced, the tables which reference it shall be analyzed again
+    // when they are received, to restore the description of the PID if it comes back.
+    if (pc->referenced) {
+        _demux.resetPID(PID_PAT);
+        _demux.resetPID(PID_CAT);
+        for (uint16_t id : pc->services) {
+            const auto srv = _services.find(id);
+            if (srv != _services.end() && srv->second->pmt_pid != pid) {
+                _demux.resetPID(srv->second->pmt_pid);
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Bounded-memory mode: prune the old contexts.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::pruneContexts()
+{
+    _next_prune_pkt = _ts_pkt_cnt + PRUNE_INTERVAL;
+
+    // Remove PID's and tables which were not seen during the specified duration.
+    // The duration is converted in packets using the current TS bitrate.
+    // There is no time-based pruning as long as the bitrate is unknown.
+    if (_prune_unseen > cn::milliseconds::zero()) {
+        const BitRate bitrate = SelectBitrate(_ts_user_bitrate, _ts_user_br_confidence,
+                                              _ts_bitrate_cnt == 0 ? 0 : BitRate(_ts_bitrate_sum / _ts_bitrate_cnt),
+                                              BitRateConfidence::PCR_AVERAGE);
+        const PacketCounter distance = PacketDistance(bitrate, _prune_unseen);
+        if (distance > 0 && distance < _ts_pkt_cnt) {
+            const uint64_t oldest = _ts_pkt_cnt - distance;
+            std::vector<PID> old_pids;
+            for (auto& it : _pids) {
+                PIDContext& pc(*it.second);
+                if (pc.ts_pkt_cnt > 0 && pc.last_pkt < oldest) {
+                    // PID's without packets are only references from tables, they remain.
+                    old_pids.push_back(pc.pid);
+                }
+                else {
+                    const size_t count = std::erase_if(pc.sections, [oldest](const auto& xt) { return xt.second->last_section_pkt < oldest; });
+                    _pruned_table_cnt += count;
+                    _modified = _modified || count > 0;
+                }
+            }
+            for (PID pid : old_pids) {
+                removePID(pid);
+            }
+        }
+    }
+
+    // Remove the least recently seen contexts when the memory footprint exceeds the limit.
+    size_t footprint = _max_memory == 0 ? 0 : memoryFootprint();
+    if (footprint > _max_memory) {
+        // Remove the least recently seen tables first.
+        std::vector<std::pair<uint64_t, std::pair<PID, XTID>>> tables;
+        for (const auto& it : _pids) {
+            for (const auto& xt : it.second->sections) {
+                tables.push_back(std::make_pair(xt.second->last_section_pkt, std::make_pair(it.first, xt.first)));
+            }
+        }
+        std::sort(tables.begin(), tables.end(), [](const auto& t1, const auto& t2) { return t1.first < t2.first; });
+        const size_t table_size = NODE_OVERHEAD + sizeof(XTIDContextMap::value_type) + SHARED_OVERHEAD + sizeof(XTIDContext);
+        for (size_t i = 0; footprint > _max_memory && i < tables.size(); ++i) {
+            _pids[tables[i].second.first]->sections.erase(tables[i].second.second);
+            footprint -= std::min(footprint, table_size);
+            _pruned_table_cnt++;
+            _modified = true;
+        }
+
+        // Then remove the least recently seen PID's, except those which were seen since the previous pruning.
+        if (footprint > _max_memory) {
+            std::vector<std::pair<uint64_t, PID>> pids;
+            for (const auto& it : _pids) {
+                if (it.second->last_pkt + PRUNE_INTERVAL < _ts_pkt_cnt) {
+                    pids.push_back(std::make_pair(it.second->last_pkt, it.first));
+                }
+            }
+            std::sort(pids.begin(), pids.end());
+            for (size_t i = 0; footprint > _max_memory && i < pids.size(); ++i) {
+                footprint -= std::min(footprint, pidFootprint(*_pids[pids[i].second]));
+                removePID(pids[i].second);
+            }
+        }
+    }
+
+    // Remove the services for which the PMT PID was removed.
+    for (auto it = _services.begin(); it != _services.end(); ) {
+        const uint16_t id = it->first;
+        if (it->second->pmt_pid != PID_PAT && !pidExists(it->second->pmt_pid)) {
+            it = _services.erase(it);
+            _pruned_service_cnt++;
+            _modified = true;
+            for (auto& pc : _pids) {
+                pc.second->services.erase(id);
+            }
+            // Reanalyze the PAT and SDT when received, in case the service comes back.
+            _demux.resetPID(PID_PAT);
+            _demux.resetPID(PID_SDT);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Update the global statistics value if internal data were modified.
 //----------------------------------------------------------------------------
@@ -16,6 +16,7 @@
 #include "tsTSPacketMetadata.h"
 #include "tsSectionDemux.h"
 #include "tsPESDemux.h"
+#include "tsPIDMap.h"
 #include "tsT2MIDemux.h"
 #include "tsISDB.h"
 #include "tsLogicalChannelNumbers.h"
@@ -75,6 +76,30 @@ namespace ts {
         //!
         void reset();
 
+        //!
+        //! Merge the analysis of the packets which immediately follow the packets of this analyzer.
+        //!
+        //! This is used to analyze consecutive chunks of a large file in parallel with independent
+        //! analyzers, and merge the results in order. The merged analysis is equivalent to the
+        //! analysis of all packets by one analyzer, with the following approximations at each
+        //! boundary between chunks:
+        //! - The PCR interval which spans the boundary is not used in the bitrate evaluation.
+        //! - The crypto-period which spans the boundary is not used in the average crypto-period.
+        //! - A section, a PES packet or a T2-MI packet which spans the boundary is lost.
+        //! - In @a next, the sections in PID's which are referenced by other tables (PMT, ECM, EMM, etc.)
+        //!   are ignored until the referencing table (PAT, PMT, CAT, etc.) is found.
+        //! - The suspect packet detection restarts in @a next without the list of known PID's.
+        //! - The system times of the analysis, which are not significant with files, are those of the chunks.
+        //!
+        //! Continuity errors, PCR/PTS/DTS leaps, table repetition intervals and versions
+        //! which span the boundary are exactly reported.
+        //!
+        //! @param [in] next Analysis of the next chunk. Its DuckContext shall be distinct.
+        //! The TS standards which were found in its DuckContext are added to the DuckContext
+        //! of this analyzer.
+        //!
+        void merge(const TSAnalyzer& next);
+
         //!
         //! Specify a "bitrate hint" for the analysis.
         //! @param [in] bitrate_hint Optional bitrate "hint" for the analysis. It is the user-specified
@@ -107,6 +132,24 @@ namespace ts {
             _max_consecutive_suspects = count;
         }
 
+        //!
+        //! Set memory limits for long-running analysis (bounded-memory mode).
+        //! When limits are set, the analysis contexts of PID's, tables and services are periodically pruned.
+        //! Reports are unchanged as long as nothing is pruned.
+        //! @param [in] unseen PID's and tables which have not been seen during that duration (based on
+        //! the TS bitrate) are removed from the analysis. Services are removed when their PMT PID is
+        //! removed. Zero means no time-based pruning.
+        //! @param [in] max_bytes Approximate maximum memory footprint of the analysis contexts in bytes.
+        //! When exceeded, the least recently seen tables, then PID's, are removed. Zero means unlimited.
+        //!
+        void setMemoryLimits(cn::milliseconds unseen, size_t max_bytes);
+
+        //!
+        //! Get an estimate of the memory footprint of the analysis contexts.
+        //! @return The approximate number of bytes which are used by the analysis contexts.
+        //!
+        size_t memoryFootprint() const;
+
         //!
         //! Get the list of service ids.
         //! @param [out] list The returned list of service ids.
@@ -252,6 +295,7 @@ namespace ts {
             // Public members - Analysis data: Repetition interval evaluation:
             uint64_t   first_pkt = 0;              //!< Last packet index of first section# 0.
             uint64_t   last_pkt = 0;               //!< Last packet index of last section# 0.
+            uint64_t   last_section_pkt = 0;       //!< Last packet index of last section, any section number.
 
             //!
             //! Constructor.
@@ -366,6 +410,14 @@ namespace ts {
             BitRate       ts_bitrate_sum = 0;        //!< Sum of all computed TS bitrates.
             uint64_t      ts_bitrate_cnt = 0;        //!< Number of computed TS bitrates.
 
+            // Public members - Analysis data: Memory pruning
+            uint64_t      last_pkt = 0;              //!< Index of last packet in the PID (or creation of the context).
+
+            // Public members - Analysis data: Merge of analyses, continuity of the first packet.
+            uint8_t       first_continuity = 0;      //!< Continuity counter of the first packet.
+            bool          first_discontinuity = false; //!< First packet has the discontinuity indicator.
+            bool          first_payload = false;     //!< First packet has a payload.
+
             //!
             //! Default constructor.
             //! @param [in] pid PID value.
@@ -430,7 +482,7 @@ namespace ts {
         //!
         //! Map of PIDContext, indexed by PID.
         //!
-        using PIDContextMap = std::map<PID, PIDContextPtr>;
+        using PIDContextMap = PIDMap<PIDContextPtr>;
 
         //!
         //! Check if a PID context exists.
@@ -507,6 +559,9 @@ namespace ts {
         std::bitset<TID_MAX> _tid_present {};         //!< Array of detected tables.
         PIDContextMap        _pids {};                //!< Description of PIDs.
         ServiceContextMap    _services {};            //!< Description of services, map key: service id.
+        size_t               _pruned_pid_cnt = 0;     //!< Number of PID contexts which were pruned in bounded-memory mode.
+        size_t               _pruned_table_cnt = 0;   //!< Number of table contexts which were pruned in bounded-memory mode.
+        size_t               _pruned_service_cnt = 0; //!< Number of service contexts which were pruned in bounded-memory mode.
 
     private:
         // Constant string "Unreferenced"
@@ -515,6 +570,15 @@ namespace ts {
         // Reset the section demux.
         void resetSectionDemux();
 
+        // Merge the analysis of a PID or a table from the next chunk of packets.
+        void mergePID(PIDContext&, const PIDContext& next, uint64_t offset);
+        static bool MergeXTID(XTIDContext&, const XTIDContext& next, uint64_t offset);
+
+        // Bounded-memory mode: prune old contexts, footprint of one PID context, remove one PID context.
+        void pruneContexts();
+        size_t pidFootprint(const PIDContext&) const;
+        void removePID(PID pid);
+
         // Analyze the various PSI tables
         void analyzePAT(const PAT&);
         void analyzeCAT(const CAT&);
@@ -574,5 +638,8 @@ namespace ts {
         T2MIDemux    _t2mi_demux {_duck, this};      // T2-MI analysis
         LogicalChannelNumbers _lcn {_duck};          // Accumulate LCN and visible flags
         DCT          _dct {};                        // Last ISDB CDT waiting to be analyzed, waiting for TS id
+        cn::milliseconds _prune_unseen {};           // Prune contexts which are unseen during that duration
+        size_t       _max_memory = 0;                // Max memory footprint of contexts in bytes
+        uint64_t     _next_prune_pkt = 0;            // Packet index of next pruning, zero if not bounded
     };
 }
@@ -118,6 +118,23 @@ void ts::TSAnalyzerOptions::defineArgs(Args& args)
               u"(see option --suspect-min-error-count)\n"
               u"- it immediately follows no more than the specified number consecutive "
               u"suspect packets.");
+
+    args.option<cn::seconds>(u"prune-unseen");
+    args.help(u"prune-unseen",
+              u"Bounded-memory mode for long-running analysis. "
+              u"Remove from the analysis the PID's and tables which have not been seen "
+              u"during the specified number of seconds. Services are removed when their "
+              u"PMT PID is removed. The duration is evaluated from the transport stream "
+              u"bitrate. Nothing is removed as long as the bitrate is unknown. "
+              u"With a cumulative analysis, this option defines a sliding window on the "
+              u"reported elements. By default, nothing is removed.");
+
+    args.option(u"max-memory", 0, Args::UNSIGNED);
+    args.help(u"max-memory", u"kilobytes",
+              u"Bounded-memory mode for long-running analysis. "
+              u"Specify the approximate maximum memory footprint of the analysis contexts. "
+              u"When this limit is exceeded, the least recently seen tables, then PID's, "
+              u"are removed from the analysis. By default, the memory is not limited.");
 }
 
 
@@ -146,6 +163,8 @@ bool ts::TSAnalyzerOptions::loadArgs(DuckContext& duck, Args& args)
     args.getValue(title, u"title");
     args.getIntValue(suspect_min_error_count, u"suspect-min-error-count", 1);
     args.getIntValue(suspect_max_consecutive, u"suspect-max-consecutive", 1);
+    args.getChronoValue(prune_unseen, u"prune-unseen");
+    max_memory = 1024 * args.intValue<size_t>(u"max-memory");
 
     bool ok = json.loadArgs(duck, args);
 
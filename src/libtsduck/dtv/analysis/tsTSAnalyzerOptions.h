@@ -65,6 +65,10 @@ namespace ts {
         uint64_t suspect_min_error_count = 1;  //!< Option -\-suspect-min-error-count
         uint64_t suspect_max_consecutive = 1;  //!< Option -\-suspect-max-consecutive
 
+        // Bounded-memory mode
+        cn::seconds prune_unseen {};         //!< Option -\-prune-unseen
+        size_t      max_memory = 0;          //!< Option -\-max-memory, in bytes
+
         //!
         //! Add command line option definitions in an Args.
         //! @param [in,out] args Command line arguments to update.
@@ -59,6 +59,7 @@ void ts::TSAnalyzerReport::setAnalysisOptions(const TSAnalyzerOptions& opt)
 {
     setMinErrorCountBeforeSuspect(opt.suspect_min_error_count);
     setMaxConsecutiveSuspectCount(opt.suspect_max_consecutive);
+    setMemoryLimits(opt.prune_unseen, opt.max_memory);
 }
 
 
@@ -252,6 +253,16 @@ void ts::TSAnalyzerReport::reportTS(Grid& grid, const UString& title)
         grid.subSection();
     }
 
+    // Add bounded-memory mode info when something was pruned.
+    if (_pruned_pid_cnt + _pruned_table_cnt + _pruned_service_cnt > 0) {
+        grid.setLayout({grid.bothTruncateLeft(42, u'.'), grid.border(), grid.bothTruncateLeft(26, u'.')});
+        grid.putLayout({{u"Pruned PID's:", UString::Decimal(_pruned_pid_cnt)},
+                        {u"Pruned tables:", UString::Decimal(_pruned_table_cnt)}});
+        grid.putLayout({{u"Pruned services:", UString::Decimal(_pruned_service_cnt)},
+                        {u"Memory (kB):", UString::Decimal((memoryFootprint() + 1023) / 1024)}});
+        grid.subSection();
+    }
+
     // Display list of services
     grid.setLayout({wide ? grid.both(WIDE_SRV_COL1) : grid.right(DEF_SRV_COL1),
                     grid.bothTruncateLeft(wide ? WIDE_SRV_COL2 : DEF_SRV_COL2),
@@ -838,6 +849,12 @@ void ts::TSAnalyzerReport::reportNormalized(TSAnalyzerOptions& opt, std::ostream
         stm << "country=" << _country_code << ":";
     }
     _ts_isdb_layers.addNormalizedKeys(stm, u"isdbtlayers", true);
+    if (_pruned_pid_cnt + _pruned_table_cnt + _pruned_service_cnt > 0) {
+        stm << "prunedpids=" << _pruned_pid_cnt << ":"
+            << "prunedtables=" << _pruned_table_cnt << ":"
+            << "prunedservices=" << _pruned_service_cnt << ":"
+            << "memory=" << memoryFootprint() << ":";
+    }
     stm << std::endl;
 
     // Print lines for first and last UTC and local time
@@ -1143,6 +1160,15 @@ void ts::TSAnalyzerReport::reportJSON(TSAnalyzerOptions& opt, std::ostream& stm,
     packets.add(u"transport-errors", _transport_errors);
     packets.add(u"suspect-ignored", _suspect_ignored);
 
+    // Bounded-memory mode info, only when something was pruned.
+    if (_pruned_pid_cnt + _pruned_table_cnt + _pruned_service_cnt > 0) {
+        json::Value& pruned(root.query(u"ts.pruned", true));
+        pruned.add(u"pids", _pruned_pid_cnt);
+        pruned.add(u"tables", _pruned_table_cnt);
+        pruned.add(u"services", _pruned_service_cnt);
+        pruned.add(u"memory", memoryFootprint());
+    }
+
     // Add PID's info.
     json::Value& pids(root.query(u"ts.pids", true));
     pids.add(u"total", _pid_cnt);
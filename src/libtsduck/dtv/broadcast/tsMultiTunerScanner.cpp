@@ -0,0 +1,216 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsMultiTunerScanner.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::MultiTunerScanner::MultiTunerScanner(Report& report, const TunerArgs& tuner_args, const UStringVector& device_names, const DuckContext::SavedArgs& duck_args) :
+    _report(report),
+    _tuner_args(tuner_args),
+    _duck_args(duck_args)
+{
+    // One scanning thread per tuner. Without device name, use the one from the tuner arguments.
+    // Prefix the messages with the tuner index when there are several tuners.
+    const UStringVector names(device_names.empty() ? UStringVector{tuner_args.device_name} : device_names);
+    for (size_t i = 0; i < names.size(); ++i) {
+        const UString prefix(names.size() > 1 ? UString::Format(u"tuner %d: ", i) : UString());
+        _threads.push_back(std::make_unique<ScanThread>(*this, names[i], prefix));
+    }
+}
+
+ts::MultiTunerScanner::~MultiTunerScanner()
+{
+    // Explicitly terminate the threads while the scanner is still fully valid.
+    _threads.clear();
+}
+
+ts::MultiTunerScanner::ScanThread::ScanThread(MultiTunerScanner& scanner, const UString& device_name, const UString& prefix) :
+    _scanner(scanner),
+    _device_name(device_name),
+    _report(scanner._report.maxSeverity(), prefix, &scanner._report)
+{
+    _duck.restoreArgs(_scanner._duck_args);
+}
+
+ts::MultiTunerScanner::ScanThread::~ScanThread()
+{
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Access the tuners outside run().
+//----------------------------------------------------------------------------
+
+bool ts::MultiTunerScanner::openTuner(size_t index)
+{
+    assert(index < _threads.size());
+    return _threads[index]->openTuner();
+}
+
+ts::Tuner& ts::MultiTunerScanner::tuner(size_t index)
+{
+    assert(index < _threads.size());
+    return _threads[index]->_tuner;
+}
+
+ts::DuckContext& ts::MultiTunerScanner::duck(size_t index)
+{
+    assert(index < _threads.size());
+    return _threads[index]->_duck;
+}
+
+bool ts::MultiTunerScanner::ScanThread::openTuner()
+{
+    // On a channel without signal, the locking timeout is not an error when scanning.
+    TunerArgs args(_scanner._tuner_args);
+    args.device_name = _device_name;
+    _tuner.setSignalTimeoutSilent(true);
+    return args.configureTuner(_tuner);
+}
+
+
+//----------------------------------------------------------------------------
+// Add a job at the end of the list of jobs.
+//----------------------------------------------------------------------------
+
+void ts::MultiTunerScanner::addJob(const Job& job)
+{
+    _jobs.push_back(job);
+    _jobs.back()._completed = false;
+}
+
+
+//----------------------------------------------------------------------------
+// Scanning thread main code.
+//----------------------------------------------------------------------------
+
+void ts::MultiTunerScanner::ScanThread::main()
+{
+    if (openTuner()) {
+        _scanner.tunerOpened();
+        for (Job* job = _scanner.nextJob(); job != nullptr; job = _scanner.nextJob()) {
+            // An exception in a job shall not block the reporting of the next jobs.
+            try {
+                _scanner.scanJob(*job, _tuner, _duck, _report);
+            }
+            catch (const std::exception& e) {
+                _report.error(u"scanning error: %s", e.what());
+            }
+            _scanner.jobCompleted(job);
+        }
+        _tuner.close();
+    }
+    _scanner.threadTerminated();
+}
+
+
+//----------------------------------------------------------------------------
+// Interactions between the scanning threads and the scanner.
+//----------------------------------------------------------------------------
+
+ts::MultiTunerScanner::Job* ts::MultiTunerScanner::nextJob()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _next_job < _jobs.size() ? &_jobs[_next_job++] : nullptr;
+}
+
+void ts::MultiTunerScanner::tunerOpened()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _opened_tuners++;
+}
+
+void ts::MultiTunerScanner::jobCompleted(Job* job)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    job->_completed = true;
+    _changed.notify_all();
+}
+
+void ts::MultiTunerScanner::threadTerminated()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    assert(_running_threads > 0);
+    _running_threads--;
+    _changed.notify_all();
+}
+
+
+//----------------------------------------------------------------------------
+// Execute all jobs and report the results in order.
+//----------------------------------------------------------------------------
+
+bool ts::MultiTunerScanner::run()
+{
+    if (_jobs.empty()) {
+        return true;
+    }
+
+    // Start all scanning threads.
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _next_job = 0;
+        _running_threads = _threads.size();
+        _opened_tuners = 0;
+    }
+    for (auto& thread : _threads) {
+        if (!thread->start()) {
+            _report.error(u"error starting scanning thread");
+            threadTerminated();
+        }
+    }
+
+    // Report the results in the order of the jobs, as soon as they are available.
+    // This is the same order as a sequential scanning with one tuner.
+    for (auto& job : _jobs) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _changed.wait(lock, [this, &job]() { return job._completed || _running_threads == 0; });
+        if (!job._completed) {
+            break; // all threads terminated on error
+        }
+        lock.unlock();
+        reportJob(job);
+    }
+
+    // Wait for the termination of all threads.
+    for (auto& thread : _threads) {
+        thread->waitForTermination();
+    }
+    return _opened_tuners > 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Report the result of a job: merge the channels and services.
+//----------------------------------------------------------------------------
+
+void ts::MultiTunerScanner::reportJob(Job& job)
+{
+    // Reset TS description in channels file.
+    if (job.ts_found) {
+        ChannelFile::NetworkPtr net_info(_channels.networkGetOrCreate(job.net_id, TunerTypeOf(job.tune.delivery_system.value_or(DS_UNDEFINED))));
+        ChannelFile::TransportStreamPtr ts_info(net_info->tsGetOrCreate(job.ts_id));
+        ts_info->clear(); // reset all services in TS.
+        ts_info->onid = job.onid;
+        ts_info->tune = job.tune;
+        if (job.services_found) {
+            // Add all services in the channels info.
+            ts_info->addServices(job.services);
+        }
+    }
+
+    // Add collected services in global service list.
+    if (job.services_found) {
+        _services.insert(_services.end(), job.services.begin(), job.services.end());
+    }
+}
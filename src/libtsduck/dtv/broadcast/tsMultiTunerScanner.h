@@ -0,0 +1,207 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Scan channels or transport streams with several tuners in parallel.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTuner.h"
+#include "tsTunerArgs.h"
+#include "tsDuckContext.h"
+#include "tsChannelFile.h"
+#include "tsService.h"
+#include "tsThread.h"
+
+namespace ts {
+    //!
+    //! Scan channels or transport streams with several tuners in parallel.
+    //! @ingroup hardware
+    //!
+    //! The channels or transport streams to scan are described by a list of jobs. There is one
+    //! scanning thread per tuner. Each thread executes the next job from the list as soon as its
+    //! tuner is free. Each tuner has its own DuckContext and its own Report, which delegates to
+    //! the Report of the scanner.
+    //!
+    //! The results are reported in the thread which calls run(), in the order of the jobs, as soon
+    //! as they are available. This is the same order as a sequential scanning with one tuner. By
+    //! default, the results of all jobs are merged in a channel file and a global list of services.
+    //!
+    //! This is an abstract class. A subclass implements scanJob() to analyze one channel or one
+    //! transport stream and, optionally, overrides reportJob() to process the results.
+    //!
+    class TSDUCKDLL MultiTunerScanner
+    {
+        TS_NOBUILD_NOCOPY(MultiTunerScanner);
+    public:
+        //!
+        //! One scanning job: a channel or transport stream to scan and its result.
+        //!
+        class TSDUCKDLL Job
+        {
+        public:
+            // Description of the job.
+            uint32_t       channel = 0;            //!< UHF/VHF channel number, with band scanning.
+            ModulationArgs params {};              //!< Tuning parameters, with NIT-based scanning.
+
+            // Result of the job.
+            std::string    text {};                //!< Output text of the job.
+            bool           ts_found = false;       //!< A transport stream was found and analyzed.
+            uint16_t       ts_id = 0;              //!< Transport stream id.
+            uint16_t       net_id = 0;             //!< Network id.
+            uint16_t       onid = 0;               //!< Original network id.
+            ModulationArgs tune {};                //!< Actual tuning parameters of the transport stream.
+            bool           services_found = false; //!< The list of services is valid.
+            ServiceList    services {};            //!< Services in the transport stream.
+
+        private:
+            friend class MultiTunerScanner;
+            bool _completed = false;  // The job is completed, the result is available.
+        };
+
+        //!
+        //! Constructor.
+        //! @param [in,out] report Where to report errors. The reference is kept inside the scanner.
+        //! @param [in] tuner_args Tuner parameters. The device name is replaced by each name in @a device_names.
+        //! @param [in] device_names Names of the tuner devices, one scanning thread per tuner.
+        //! When empty, use one tuner with the device name from @a tuner_args.
+        //! @param [in] duck_args Command line options to restore in the DuckContext of each tuner.
+        //!
+        MultiTunerScanner(Report& report,
+                          const TunerArgs& tuner_args,
+                          const UStringVector& device_names,
+                          const DuckContext::SavedArgs& duck_args = DuckContext::SavedArgs());
+
+        //!
+        //! Destructor.
+        //! The destructor waits for the termination of all scanning threads.
+        //!
+        virtual ~MultiTunerScanner();
+
+        //!
+        //! Get the number of tuners, one per scanning thread.
+        //! @return The number of tuners.
+        //!
+        size_t tunerCount() const { return _threads.size(); }
+
+        //!
+        //! Open and configure a tuner, outside run().
+        //! This is typically used to collect information on a reference transport stream before
+        //! building the list of jobs. The tuner must be closed before run().
+        //! @param [in] index Index of the tuner, from 0 to tunerCount() - 1.
+        //! @return True on success, false on error.
+        //!
+        bool openTuner(size_t index);
+
+        //!
+        //! Access a tuner, outside run().
+        //! @param [in] index Index of the tuner, from 0 to tunerCount() - 1.
+        //! @return A reference to the tuner.
+        //!
+        Tuner& tuner(size_t index);
+
+        //!
+        //! Access the execution context of a tuner, outside run().
+        //! @param [in] index Index of the tuner, from 0 to tunerCount() - 1.
+        //! @return A reference to the execution context of the tuner.
+        //!
+        DuckContext& duck(size_t index);
+
+        //!
+        //! Add a job at the end of the list of jobs.
+        //! Must not be called during run().
+        //! @param [in] job Description of the job.
+        //!
+        void addJob(const Job& job);
+
+        //!
+        //! Get the number of jobs.
+        //! @return The number of jobs.
+        //!
+        size_t jobCount() const { return _jobs.size(); }
+
+        //!
+        //! Execute all jobs on all tuners and report the results in the order of the jobs.
+        //! @return False if no tuner could be opened, true otherwise.
+        //!
+        bool run();
+
+        //!
+        //! Get the channel file where the results of all jobs are merged.
+        //! It can be loaded before run(), to update an existing channel file.
+        //! @return A reference to the channel file.
+        //!
+        ChannelFile& channels() { return _channels; }
+
+        //!
+        //! Get the global list of services where the services of all jobs are merged.
+        //! @return A reference to the global list of services.
+        //!
+        ServiceList& services() { return _services; }
+
+    protected:
+        //!
+        //! Execute one job. Invoked in the scanning thread of a tuner.
+        //! Several jobs are simultaneously executed on distinct tuners.
+        //! @param [in,out] job The job to execute. Its result is updated.
+        //! @param [in,out] tuner The open tuner to use.
+        //! @param [in,out] duck The execution context of the tuner.
+        //! @param [in,out] report Where to report messages, with the prefix of the tuner.
+        //!
+        virtual void scanJob(Job& job, Tuner& tuner, DuckContext& duck, Report& report) = 0;
+
+        //!
+        //! Report the result of a job. Invoked in the thread which called run(), in the order of the jobs.
+        //! The default implementation merges the transport stream in the channel file and its services
+        //! in the global list of services. A subclass which overrides this method should call it.
+        //! @param [in,out] job The completed job.
+        //!
+        virtual void reportJob(Job& job);
+
+    private:
+        // Scanning thread, one per tuner.
+        class ScanThread: public Thread
+        {
+            TS_NOBUILD_NOCOPY(ScanThread);
+        public:
+            ScanThread(MultiTunerScanner& scanner, const UString& device_name, const UString& prefix);
+            virtual ~ScanThread() override;
+            bool openTuner();
+
+        private:
+            friend class MultiTunerScanner;
+            MultiTunerScanner& _scanner;
+            UString            _device_name;
+            Report             _report;
+            DuckContext        _duck {&_report};
+            Tuner              _tuner {_duck};
+
+            virtual void main() override;
+        };
+
+        Report&                 _report;
+        TunerArgs               _tuner_args;
+        DuckContext::SavedArgs  _duck_args;
+        ChannelFile             _channels {};
+        ServiceList             _services {};
+        std::vector<std::unique_ptr<ScanThread>> _threads {};
+        std::vector<Job>        _jobs {};            // Not resized while threads are running.
+        std::mutex              _mutex {};           // Protect all subsequent fields.
+        std::condition_variable _changed {};         // Signalled when a job is completed or a thread terminates.
+        size_t                  _next_job = 0;       // Index of next job to execute.
+        size_t                  _running_threads = 0;
+        size_t                  _opened_tuners = 0;
+
+        // Interactions between the scanning threads and the scanner.
+        Job* nextJob();
+        void tunerOpened();
+        void jobCompleted(Job* job);
+        void threadTerminated();
+    };
+}
@@ -15,7 +15,9 @@
 #include "tsATSC.h"
 #include "tsLogicalChannelNumbers.h"
 
-#define BUFFER_PACKET_COUNT  10000 // packets
+// Some tuners do not return before the packet buffer is full. Using a small buffer,
+// the collection stops shortly after the last required table, even on low bitrates.
+#define BUFFER_PACKET_COUNT  1000 // packets
 
 
 //----------------------------------------------------------------------------
@@ -33,6 +33,7 @@ namespace ts {
         //!
         //! Constructor.
         //! The transport stream is scanned be the constructor.
+        //! The collection stops as soon as all expected tables are received or on timeout.
         //! The collected data can be fetched later.
         //! @param [in,out] duck TSDuck execution context. The reference is kept inside the scanner.
         //! @param [in,out] tuner A tuner which is already tuned to the expected channel.
@@ -41,6 +42,13 @@ namespace ts {
         //!
         TSScanner(DuckContext& duck, Tuner& tuner, cn::milliseconds timeout, bool pat_only = false);
 
+        //!
+        //! Check if all expected tables were collected before the timeout.
+        //! @return True if all expected tables were collected. When false, the collection stopped
+        //! on timeout or reception error and some tables may be missing.
+        //!
+        bool completed() const { return _completed; }
+
         //!
         //! Get the list of services.
         //! @param [out] services Returned list of services.
@@ -42,6 +42,11 @@ ts::AccessUnitIterator::AccessUnitIterator(const uint8_t* data, size_t size, uin
         }
     }
 
+    // Locate all start code prefixes 00 00 01 and end of NALunits 00 00 00 in one pass.
+    if (_valid) {
+        LocateAllZeroZero(_start_codes, _data, _data_size, 0x01);
+    }
+
     // Search the first access unit.
     reset();
 }
@@ -57,6 +62,7 @@ void ts::AccessUnitIterator::reset()
         // Point to the beginning of area, before the first access unit.
         // Calling next() will find the first one (if any).
         _nalunit = _data;
+        _next_start_code = 0;
         next();
         // Reset NALunit index since we point to the first one.
         _nalunit_index = 0;
@@ -99,12 +105,11 @@ bool ts::AccessUnitIterator::next()
 
     // A start code prefix is 00 00 01.
     constexpr size_t StartCodePrefixSize = 3;
-    constexpr uint8_t StartCodePrefixThird = 0x01;
 
-    // Remaining size in data area.
+    // Current offset in data area.
     assert(_nalunit >= _data);
     assert(_nalunit <= _data + _data_size);
-    size_t remain = _data + _data_size - _nalunit;
+    const size_t offset = _nalunit - _data;
 
     // Preset access unit type to an invalid value.
     // If the video format is undefined, we won't be able to extract a valid one.
@@ -115,8 +120,8 @@ bool ts::AccessUnitIterator::next()
     // Locate next access unit: starts with 00 00 01.
     // The start code prefix 00 00 01 is not part of the NALunit.
     // The NALunit starts at the NALunit type byte (see H.264, 7.3.1).
-    const uint8_t* const p1 = LocateZeroZero(_nalunit, remain, StartCodePrefixThird);
-    if (p1 == nullptr) {
+    const size_t start = nextStartCode(offset, false);
+    if (start == NPOS) {
         // No next access unit.
         _nalunit = nullptr;
         _nalunit_index++;
@@ -124,26 +129,11 @@ bool ts::AccessUnitIterator::next()
     }
 
     // Jump to first byte of NALunit.
-    remain -= p1 - _nalunit + StartCodePrefixSize;
-    _nalunit = p1 + StartCodePrefixSize;
+    _nalunit = _data + start + StartCodePrefixSize;
 
     // Locate end of access unit: ends with 00 00 00, 00 00 01 or end of data.
-    const uint8_t* const p2 = LocateZeroZero(_nalunit, remain, StartCodePrefixThird);
-    const uint8_t* const p3 = LocateZeroZero(_nalunit, remain, 0x00);
-    if (p2 == nullptr && p3 == nullptr) {
-        // No 00 00 01, no 00 00 00, the NALunit extends up to the end of data.
-        _nalunit_size = remain;
-    }
-    else if (p2 == nullptr || (p3 != nullptr && p3 < p2)) {
-        // NALunit ends at 00 00 00.
-        assert(p3 != nullptr);
-        _nalunit_size = p3 - _nalunit;
-    }
-    else {
-        // NALunit ends at 00 00 01.
-        assert(p2 != nullptr);
-        _nalunit_size = p2 - _nalunit;
-    }
+    const size_t end = nextStartCode(start + StartCodePrefixSize, true);
+    _nalunit_size = (end == NPOS ? _data_size : end) - start - StartCodePrefixSize;
 
     // Extract NALunit type.
     if (_format == CodecType::AVC && _nalunit_size >= 1) {
@@ -163,3 +153,22 @@ bool ts::AccessUnitIterator::next()
     _nalunit_index++;
     return true;
 }
+
+
+//----------------------------------------------------------------------------
+// Find the first start code at or after the specified offset.
+//----------------------------------------------------------------------------
+
+size_t ts::AccessUnitIterator::nextStartCode(size_t offset, bool end_of_unit)
+{
+    // The offsets are always increasing: skip start codes before the offset once for all.
+    while (_next_start_code < _start_codes.size() && _start_codes[_next_start_code] < offset) {
+        _next_start_code++;
+    }
+    for (size_t i = _next_start_code; i < _start_codes.size(); ++i) {
+        if (end_of_unit || _data[_start_codes[i] + 2] == 0x01) {
+            return _start_codes[i];
+        }
+    }
+    return NPOS;
+}
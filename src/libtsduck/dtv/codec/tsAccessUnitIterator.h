@@ -135,5 +135,11 @@ namespace ts {
         size_t         _nalunit_header_size = 0;
         size_t         _nalunit_index = 0;
         uint8_t        _nalunit_type = AVC_AUT_INVALID;
+        std::vector<size_t> _start_codes {};  // Offsets of all 00 00 00 and 00 00 01 in the data area.
+        size_t         _next_start_code = 0;  // Index in _start_codes of the first one after _nalunit.
+
+        // Find the first 00 00 01 (or also 00 00 00 when end_of_unit is true) at or after the specified offset.
+        // Return the offset of the start code or NPOS if there is none.
+        size_t nextStartCode(size_t offset, bool end_of_unit);
     };
 }
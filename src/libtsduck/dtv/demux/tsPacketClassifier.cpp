@@ -0,0 +1,492 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsPacketClassifier.h"
+#include "tsISDBTInformation.h"
+#include "tsService.h"
+#include "tsMemory.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::PacketClassifier::PacketClassifier(DuckContext& duck) :
+    _duck(duck)
+{
+    _demux.setHandler(this);
+    _explicit.fill(UNSET);
+    invalidate();
+}
+
+ts::PacketClassifier::~PacketClassifier()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Remove all selection criteria and explicit verdicts.
+//----------------------------------------------------------------------------
+
+void ts::PacketClassifier::clear()
+{
+    _default_verdict = DROP;
+    _explicit.fill(UNSET);
+    _pid_classes.clear();
+    _codecs.clear();
+    _service_ids.clear();
+    _service_names.clear();
+    _predicates.clear();
+    _labels.reset();
+    _stream_ids.clear();
+    _isdb_layers.clear();
+    _pattern.clear();
+    _pattern_payload = false;
+    _pattern_use_offset = false;
+    _pattern_offset = 0;
+    _ranges.clear();
+    _every = 0;
+    _every_origin = 0;
+    restart();
+}
+
+
+//----------------------------------------------------------------------------
+// Restart the classification with the same criteria.
+//----------------------------------------------------------------------------
+
+void ts::PacketClassifier::restart()
+{
+    _demux.reset();
+    _all_service_ids = _service_ids;
+    _stream_id_pids.reset();
+    updateCriteria();
+}
+
+
+//----------------------------------------------------------------------------
+// Update the state of the classifier after modifying criteria.
+//----------------------------------------------------------------------------
+
+void ts::PacketClassifier::updateCriteria()
+{
+    _pid_criteria = !_pid_classes.empty() || !_codecs.empty() || !_service_ids.empty() || !_service_names.empty();
+    _packet_criteria = !_predicates.empty() || _labels.any() || !_stream_ids.empty() || !_isdb_layers.empty() ||
+        !_pattern.empty() || !_ranges.empty() || _every > 0;
+
+    // The intra-frame detection is done by the signalization demux.
+    _need_demux = _pid_criteria || _handler != nullptr;
+    for (const auto& it : _predicates) {
+        _need_demux = _need_demux || it.pred == Predicate::INTRA_FRAME;
+    }
+    invalidate();
+}
+
+
+//----------------------------------------------------------------------------
+// Set the application signalization handler.
+//----------------------------------------------------------------------------
+
+void ts::PacketClassifier::setSignalizationHandler(SignalizationHandlerInterface* handler)
+{
+    _handler = handler;
+    updateCriteria();
+}
+
+
+//----------------------------------------------------------------------------
+// Explicit verdicts.
+//----------------------------------------------------------------------------
+
+void ts::PacketClassifier::setDefaultVerdict(Verdict verdict)
+{
+    _default_verdict = verdict;
+    invalidate();
+}
+
+void ts::PacketClassifier::setVerdict(PID pid, Verdict verdict)
+{
+    if (pid < PID_MAX) {
+        _explicit[pid] = verdict;
+        _compiled[pid] = UNKNOWN;
+    }
+}
+
+void ts::PacketClassifier::setVerdict(const PIDSet& pids, Verdict verdict)
+{
+    for (PID pid = 0; pid < PID_MAX; ++pid) {
+        if (pids.test(pid)) {
+            _explicit[pid] = verdict;
+            _compiled[pid] = UNKNOWN;
+        }
+    }
+}
+
+void ts::PacketClassifier::clearVerdict(PID pid)
+{
+    setVerdict(pid, UNSET);
+}
+
+void ts::PacketClassifier::clearVerdicts()
+{
+    _explicit.fill(UNSET);
+    invalidate();
+}
+
+
+//----------------------------------------------------------------------------
+// PID-level selection criteria.
+//----------------------------------------------------------------------------
+
+void ts::PacketClassifier::selectPIDClass(PIDClass cls)
+{
+    _pid_classes.insert(cls);
+    updateCriteria();
+}
+
+void ts::PacketClassifier::selectCodec(CodecType codec)
+{
+    _codecs.insert(codec);
+    updateCriteria();
+}
+
+void ts::PacketClassifier::selectServiceId(uint16_t service_id)
+{
+    _service_ids.insert(service_id);
+    _all_service_ids.insert(service_id);
+    updateCriteria();
+}
+
+void ts::PacketClassifier::selectService(const UString& service)
+{
+    uint16_t id = 0;
+    if (service.toInteger(id, UString::DEFAULT_THOUSANDS_SEPARATOR)) {
+        selectServiceId(id);
+    }
+    else {
+        _service_names.push_back(service);
+        updateCriteria();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Per-packet selection criteria.
+//----------------------------------------------------------------------------
+
+void ts::PacketClassifier::selectPredicate(Predicate pred, int value)
+{
+    _predicates.push_back({pred, value});
+    updateCriteria();
+}
+
+void ts::PacketClassifier::selectLabels(const TSPacketLabelSet& labels)
+{
+    _labels |= labels;
+    updateCriteria();
+}
+
+void ts::PacketClassifier::selectStreamIds(const std::set<uint8_t>& ids)
+{
+    _stream_ids.insert(ids.begin(), ids.end());
+    updateCriteria();
+}
+
+void ts::PacketClassifier::selectISDBLayers(const std::set<uint8_t>& layers)
+{
+    _isdb_layers.insert(layers.begin(), layers.end());
+    updateCriteria();
+}
+
+void ts::PacketClassifier::selectPattern(const ByteBlock& pattern, bool payload_only, bool use_offset, size_t offset)
+{
+    _pattern = pattern;
+    _pattern_payload = payload_only;
+    _pattern_use_offset = use_offset;
+    _pattern_offset = offset;
+    updateCriteria();
+}
+
+void ts::PacketClassifier::selectPacketRange(PacketCounter first, PacketCounter last)
+{
+    _ranges.push_back(std::make_pair(first, last));
+    updateCriteria();
+}
+
+void ts::PacketClassifier::selectEvery(PacketCounter every, PacketCounter origin)
+{
+    _every = every;
+    _every_origin = origin;
+    updateCriteria();
+}
+
+
+//----------------------------------------------------------------------------
+// Compute the verdict of a PID.
+//----------------------------------------------------------------------------
+
+ts::PacketClassifier::Verdict ts::PacketClassifier::compile(PID pid) const
+{
+    // An explicit verdict overrides everything else.
+    if (_explicit[pid] != UNSET) {
+        return _explicit[pid];
+    }
+
+    // Check signalization-based criteria.
+    if (_pid_criteria) {
+        const PIDClass cls = _demux.pidClass(pid);
+        if (_pid_classes.contains(cls) ||
+            (!_codecs.empty() && _codecs.contains(_demux.codecType(pid))) ||
+            (!_all_service_ids.empty() && _demux.inAnyService(pid, _all_service_ids)))
+        {
+            return PASS;
+        }
+    }
+
+    // Not selected at PID level.
+    return _packet_criteria ? CHECK : _default_verdict;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the PID-level verdict of a PID.
+//----------------------------------------------------------------------------
+
+ts::PacketClassifier::Verdict ts::PacketClassifier::verdict(PID pid)
+{
+    if (pid >= PID_MAX) {
+        return _default_verdict;
+    }
+    if (_compiled[pid] == UNKNOWN) {
+        _compiled[pid] = compile(pid);
+    }
+    return _compiled[pid] == CHECK ? _default_verdict : _compiled[pid];
+}
+
+
+//----------------------------------------------------------------------------
+// Classify a TS packet.
+//----------------------------------------------------------------------------
+
+ts::PacketClassifier::Verdict ts::PacketClassifier::classify(const TSPacket& pkt, const TSPacketMetadata& mdata, PacketCounter index)
+{
+    const PID pid = pkt.getPID();
+
+    // Track stream ids of PES packets. The stream id is in the fourth byte of
+    // the payload of a TS packet containing the start of a PES packet.
+    // This must be done on all packets, even when the PID is already selected.
+    if (!_stream_ids.empty() && pkt.startPES() && pkt.getPayloadSize() >= 4) {
+        _stream_id_pids.set(pid, _stream_ids.contains(pkt.getPayload()[3]));
+    }
+
+    // Common case: one table lookup.
+    Verdict verdict = _compiled[pid];
+    if (verdict == UNKNOWN) {
+        verdict = _compiled[pid] = compile(pid);
+    }
+    if (verdict == CHECK) {
+        verdict = evaluate(pkt, mdata, index) ? PASS : _default_verdict;
+    }
+    return verdict;
+}
+
+
+//----------------------------------------------------------------------------
+// Evaluate all per-packet predicates.
+//----------------------------------------------------------------------------
+
+bool ts::PacketClassifier::evaluate(const TSPacket& pkt, const TSPacketMetadata& mdata, PacketCounter index)
+{
+    const PID pid = pkt.getPID();
+
+    if (_stream_id_pids.test(pid) || mdata.hasAnyLabel(_labels)) {
+        return true;
+    }
+
+    for (const auto& it : _predicates) {
+        bool match = false;
+        switch (it.pred) {
+            case Predicate::PAYLOAD:
+                match = pkt.hasPayload();
+                break;
+            case Predicate::ADAPTATION_FIELD:
+                match = pkt.hasAF();
+                break;
+            case Predicate::UNIT_START:
+                match = pkt.getPUSI();
+                break;
+            case Predicate::PES_START:
+                match = pkt.startPES();
+                break;
+            case Predicate::HAS_PCR:
+                match = pkt.hasPCR() || pkt.hasOPCR();
+                break;
+            case Predicate::SPLICE_COUNTDOWN:
+                match = pkt.hasSpliceCountdown();
+                break;
+            case Predicate::VALID:
+                match = pkt.hasValidSync() && !pkt.getTEI();
+                break;
+            case Predicate::NULLIFIED:
+                match = mdata.getNullified();
+                break;
+            case Predicate::INPUT_STUFFING:
+                match = mdata.getInputStuffing();
+                break;
+            case Predicate::INTRA_FRAME:
+                match = _demux.atIntraFrame(pid);
+                break;
+            case Predicate::SCRAMBLING:
+                match = int(pkt.getScrambling()) == it.value;
+                break;
+            case Predicate::SPLICE_EQUAL:
+                match = pkt.hasSpliceCountdown() && pkt.getSpliceCountdown() == it.value;
+                break;
+            case Predicate::SPLICE_MIN:
+                match = pkt.hasSpliceCountdown() && pkt.getSpliceCountdown() >= it.value;
+                break;
+            case Predicate::SPLICE_MAX:
+                match = pkt.hasSpliceCountdown() && pkt.getSpliceCountdown() <= it.value;
+                break;
+            case Predicate::MIN_PAYLOAD:
+                match = int(pkt.getPayloadSize()) >= it.value;
+                break;
+            case Predicate::MAX_PAYLOAD:
+                match = int(pkt.getPayloadSize()) <= it.value;
+                break;
+            case Predicate::MIN_AF:
+                match = int(pkt.getAFSize()) >= it.value;
+                break;
+            case Predicate::MAX_AF:
+                match = int(pkt.getAFSize()) <= it.value;
+                break;
+            default:
+                break;
+        }
+        if (match) {
+            return true;
+        }
+    }
+
+    if (_every > 0 && index >= _every_origin && (index - _every_origin) % _every == 0) {
+        return true;
+    }
+
+    for (const auto& it : _ranges) {
+        if (index >= it.first && index <= it.second) {
+            return true;
+        }
+    }
+
+    // Get ISDB layer if required.
+    if (!_isdb_layers.empty()) {
+        // Do not check if ISDB is part of the standards, assume it if ISDB layers are selected.
+        const ISDBTInformation info(_duck, mdata, false);
+        if (info.is_valid && _isdb_layers.contains(info.layer_indicator)) {
+            return true;
+        }
+    }
+
+    // Search binary patterns in packets.
+    if (!_pattern.empty()) {
+        const size_t start = _pattern_payload ? pkt.getHeaderSize() : 0;
+        if (start + _pattern_offset + _pattern.size() <= PKT_SIZE) {
+            if (_pattern_use_offset) {
+                return MemEqual(pkt.b + start + _pattern_offset, _pattern.data(), _pattern.size());
+            }
+            else {
+                return LocatePattern(pkt.b + start, PKT_SIZE - start, _pattern.data(), _pattern.size()) != nullptr;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Invalidate verdicts when the signalization changes, notify the application.
+//----------------------------------------------------------------------------
+
+void ts::PacketClassifier::handlePAT(const PAT& table, PID pid)
+{
+    invalidate();
+    if (_handler != nullptr) {
+        _handler->handlePAT(table, pid);
+    }
+}
+
+void ts::PacketClassifier::handleCAT(const CAT& table, PID pid)
+{
+    invalidate();
+    if (_handler != nullptr) {
+        _handler->handleCAT(table, pid);
+    }
+}
+
+void ts::PacketClassifier::handlePMT(const PMT& table, PID pid)
+{
+    invalidate();
+    if (_handler != nullptr) {
+        _handler->handlePMT(table, pid);
+    }
+}
+
+void ts::PacketClassifier::handleMGT(const MGT& table, PID pid)
+{
+    invalidate();
+    if (_handler != nullptr) {
+        _handler->handleMGT(table, pid);
+    }
+}
+
+void ts::PacketClassifier::handleService(uint16_t ts_id, const Service& service, const PMT& pmt, bool removed)
+{
+    // If the service is selected by name, add its service id in the selected services.
+    if (!_service_names.empty() && service.hasId() && !_all_service_ids.contains(service.getId())) {
+        const UString name(service.getName());
+        for (const auto& it : _service_names) {
+            if (it.similar(name)) {
+                _all_service_ids.insert(service.getId());
+                invalidate();
+                break;
+            }
+        }
+    }
+    if (_handler != nullptr) {
+        _handler->handleService(ts_id, service, pmt, removed);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Forward other signalization to the application handler.
+//----------------------------------------------------------------------------
+
+#define TS_FORWARD_HANDLER(handler, type, param)                      \
+    void ts::PacketClassifier::handler(const type& table, param value) \
+    {                                                                  \
+        if (_handler != nullptr) {                                     \
+            _handler->handler(table, value);                           \
+        }                                                              \
+    }
+
+TS_FORWARD_HANDLER(handleTSDT, TSDT, PID)
+TS_FORWARD_HANDLER(handleNIT, NIT, PID)
+TS_FORWARD_HANDLER(handleSDT, SDT, PID)
+TS_FORWARD_HANDLER(handleBAT, BAT, PID)
+TS_FORWARD_HANDLER(handleRST, RST, PID)
+TS_FORWARD_HANDLER(handleTDT, TDT, PID)
+TS_FORWARD_HANDLER(handleTOT, TOT, PID)
+TS_FORWARD_HANDLER(handleVCT, VCT, PID)
+TS_FORWARD_HANDLER(handleCVCT, CVCT, PID)
+TS_FORWARD_HANDLER(handleTVCT, TVCT, PID)
+TS_FORWARD_HANDLER(handleRRT, RRT, PID)
+TS_FORWARD_HANDLER(handleSTT, STT, PID)
+TS_FORWARD_HANDLER(handleUTC, Time, TID)
+TS_FORWARD_HANDLER(handleSAT, SAT, PID)
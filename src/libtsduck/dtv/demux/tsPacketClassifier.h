@@ -0,0 +1,349 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Compiled classifier of TS packets.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsSignalizationDemux.h"
+#include "tsSignalizationHandlerInterface.h"
+#include "tsTSPacket.h"
+#include "tsTSPacketMetadata.h"
+#include "tsByteBlock.h"
+
+namespace ts {
+    //!
+    //! Compiled classifier of TS packets.
+    //! @ingroup mpeg
+    //!
+    //! A packet classifier returns a verdict for each TS packet. A verdict is an 8-bit value.
+    //! The verdicts DROP and PASS are predefined. Applications may use their own verdicts,
+    //! starting at FIRST_USER_VERDICT, for PID's which need a specific processing.
+    //!
+    //! The selection criteria are compiled into a table of verdicts, one per PID, and a short
+    //! list of per-packet predicates. A packet is selected (verdict PASS) when any criterion matches.
+    //! - Explicit verdicts, set by the application on specific PID's.
+    //! - PID-level criteria which depend on the signalization: PID classes, codecs, services.
+    //!   They are resolved using a SignalizationDemux which is owned by the classifier.
+    //! - Per-packet predicates: packet header content, labels, PES stream ids, binary patterns,
+    //!   packet ranges, etc.
+    //!
+    //! The verdict of a PID is lazily computed the first time a packet from that PID is classified.
+    //! All verdicts are invalidated only when the signalization changes or when criteria are modified.
+    //! In the common case, classifying a packet is one table lookup. The per-packet predicates are
+    //! evaluated only on PID's which are not selected by PID-level criteria.
+    //!
+    class TSDUCKDLL PacketClassifier : private SignalizationHandlerInterface
+    {
+        TS_NOBUILD_NOCOPY(PacketClassifier);
+    public:
+        //!
+        //! Type of a packet verdict.
+        //!
+        using Verdict = uint8_t;
+
+        static constexpr Verdict DROP = 0;                //!< Packet is not selected.
+        static constexpr Verdict PASS = 1;                //!< Packet is selected.
+        static constexpr Verdict FIRST_USER_VERDICT = 16; //!< First application-defined verdict.
+
+        //!
+        //! Per-packet predicates without associated data.
+        //! Some predicates use an integer value.
+        //!
+        enum class Predicate : uint8_t {
+            PAYLOAD,           //!< Packet has a payload.
+            ADAPTATION_FIELD,  //!< Packet has an adaptation field.
+            UNIT_START,        //!< Packet has the payload unit start indicator.
+            PES_START,         //!< Packet contains the start of a clear PES packet.
+            HAS_PCR,           //!< Packet has a PCR or OPCR.
+            SPLICE_COUNTDOWN,  //!< Packet has a splice countdown in the adaptation field.
+            VALID,             //!< Packet has a valid sync byte and no transport error indicator.
+            NULLIFIED,         //!< Packet was nullified by a previous plugin (metadata).
+            INPUT_STUFFING,    //!< Packet was artificially inserted as input stuffing (metadata).
+            INTRA_FRAME,       //!< Packet contains the start of a video intra-frame (requires the signalization demux).
+            SCRAMBLING,        //!< Scrambling control value is equal to the integer value.
+            SPLICE_EQUAL,      //!< Splice countdown is equal to the integer value.
+            SPLICE_MIN,        //!< Splice countdown is greater than or equal to the integer value.
+            SPLICE_MAX,        //!< Splice countdown is lower than or equal to the integer value.
+            MIN_PAYLOAD,       //!< Payload size is greater than or equal to the integer value.
+            MAX_PAYLOAD,       //!< Payload size is lower than or equal to the integer value (or no payload).
+            MIN_AF,            //!< Adaptation field size is greater than or equal to the integer value.
+            MAX_AF,            //!< Adaptation field size is lower than or equal to the integer value (or no adaptation field).
+        };
+
+        //!
+        //! Constructor.
+        //! @param [in,out] duck TSDuck execution context.
+        //!
+        explicit PacketClassifier(DuckContext& duck);
+
+        //!
+        //! Destructor.
+        //!
+        virtual ~PacketClassifier() override;
+
+        //!
+        //! Remove all selection criteria and explicit verdicts, reset the signalization demux.
+        //!
+        void clear();
+
+        //!
+        //! Restart the classification with the same criteria.
+        //! Reset the signalization demux and all dynamic states (service names resolution, stream ids).
+        //!
+        void restart();
+
+        //!
+        //! Set the verdict for PID's which are not selected by any criterion.
+        //! The default value is DROP.
+        //! @param [in] verdict The default verdict.
+        //!
+        void setDefaultVerdict(Verdict verdict);
+
+        //!
+        //! Set an explicit verdict on a PID.
+        //! An explicit verdict overrides all other criteria.
+        //! @param [in] pid The PID to set.
+        //! @param [in] verdict The verdict for all packets in this PID.
+        //!
+        void setVerdict(PID pid, Verdict verdict);
+
+        //!
+        //! Set an explicit verdict on a set of PID's.
+        //! An explicit verdict overrides all other criteria.
+        //! @param [in] pids The PID's to set.
+        //! @param [in] verdict The verdict for all packets in these PID's.
+        //!
+        void setVerdict(const PIDSet& pids, Verdict verdict);
+
+        //!
+        //! Remove the explicit verdict of a PID.
+        //! @param [in] pid The PID to reset.
+        //!
+        void clearVerdict(PID pid);
+
+        //!
+        //! Remove the explicit verdicts of all PID's.
+        //!
+        void clearVerdicts();
+
+        //!
+        //! Select all PID's of a given class, as found in the signalization.
+        //! @param [in] cls The PID class to select.
+        //!
+        void selectPIDClass(PIDClass cls);
+
+        //!
+        //! Select all PID's with a given codec, as found in the signalization.
+        //! @param [in] codec The codec to select.
+        //!
+        void selectCodec(CodecType codec);
+
+        //!
+        //! Select all PID's of a service.
+        //! @param [in] service_id The service id to select.
+        //!
+        void selectServiceId(uint16_t service_id);
+
+        //!
+        //! Select all PID's of a service.
+        //! @param [in] service A service id (decimal or hexadecimal) or a service name.
+        //! A service name is resolved when it is found in the signalization.
+        //!
+        void selectService(const UString& service);
+
+        //!
+        //! Add a per-packet predicate.
+        //! @param [in] pred The predicate.
+        //! @param [in] value Associated integer value, for predicates which need one.
+        //!
+        void selectPredicate(Predicate pred, int value = 0);
+
+        //!
+        //! Select packets with any of the specified labels.
+        //! @param [in] labels The labels to select.
+        //!
+        void selectLabels(const TSPacketLabelSet& labels);
+
+        //!
+        //! Select packets from PID's which carry PES packets with any of the specified stream ids.
+        //! A PID starts to be selected when a specified stream id appears. Such a PID is no longer
+        //! selected when non-specified stream id is found.
+        //! @param [in] ids The stream ids to select.
+        //!
+        void selectStreamIds(const std::set<uint8_t>& ids);
+
+        //!
+        //! Select packets with any of the specified layer indicator in the ISDB-T Information.
+        //! @param [in] layers The ISDB-T layers to select.
+        //!
+        void selectISDBLayers(const std::set<uint8_t>& layers);
+
+        //!
+        //! Select packets containing a binary pattern.
+        //! @param [in] pattern The binary pattern to search.
+        //! @param [in] payload_only If true, search in the payload only.
+        //! @param [in] use_offset If true, the pattern must be located at @a offset only.
+        //! @param [in] offset Offset of the pattern, in the packet or in the payload.
+        //!
+        void selectPattern(const ByteBlock& pattern, bool payload_only, bool use_offset, size_t offset);
+
+        //!
+        //! Select a range of packets, by packet index.
+        //! @param [in] first Index of the first packet to select.
+        //! @param [in] last Index of the last packet to select, inclusive.
+        //!
+        void selectPacketRange(PacketCounter first, PacketCounter last);
+
+        //!
+        //! Select one packet every N packets, by packet index.
+        //! @param [in] every Select one packet every that number of packets.
+        //! @param [in] origin Index of the first selected packet.
+        //!
+        void selectEvery(PacketCounter every, PacketCounter origin = 0);
+
+        //!
+        //! Check if the signalization demux is required to evaluate the criteria.
+        //! @return True if the signalization demux is required.
+        //!
+        bool needDemux() const { return _need_demux; }
+
+        //!
+        //! Access the signalization demux of the classifier.
+        //! @return A constant reference to the signalization demux.
+        //!
+        const SignalizationDemux& demux() const { return _demux; }
+
+        //!
+        //! Set a handler which is notified of the signalization found by the demux of the classifier.
+        //! Applications which compute their own verdicts from the signalization use this handler
+        //! instead of demuxing the same tables a second time. When a handler is set, the signalization
+        //! demux is always required. The handler is not removed by clear().
+        //! @param [in] handler The handler, null to remove it.
+        //!
+        void setSignalizationHandler(SignalizationHandlerInterface* handler);
+
+        //!
+        //! Feed the signalization demux with a TS packet, if the demux is required.
+        //! All packets of the stream must be passed here, before being classified.
+        //! @param [in] pkt A TS packet.
+        //!
+        void feedPacket(const TSPacket& pkt)
+        {
+            if (_need_demux) {
+                _demux.feedPacket(pkt);
+            }
+        }
+
+        //!
+        //! Get the PID-level verdict of a PID, without evaluating per-packet predicates.
+        //! @param [in] pid A PID.
+        //! @return The verdict of @a pid, PASS, DROP or an application-defined verdict.
+        //! When per-packet predicates need to be evaluated on that PID, DROP is returned.
+        //!
+        Verdict verdict(PID pid);
+
+        //!
+        //! Classify a TS packet.
+        //! @param [in] pkt The TS packet to classify.
+        //! @param [in] mdata The metadata of the TS packet.
+        //! @param [in] index Index of the packet in the stream, used with packet ranges.
+        //! @return The verdict for this packet.
+        //!
+        Verdict classify(const TSPacket& pkt, const TSPacketMetadata& mdata, PacketCounter index);
+
+        //!
+        //! Check if a TS packet is selected.
+        //! @param [in] pkt The TS packet to classify.
+        //! @param [in] mdata The metadata of the TS packet.
+        //! @param [in] index Index of the packet in the stream, used with packet ranges.
+        //! @return True if the verdict for this packet is PASS.
+        //!
+        bool isSelected(const TSPacket& pkt, const TSPacketMetadata& mdata, PacketCounter index)
+        {
+            return classify(pkt, mdata, index) == PASS;
+        }
+
+    private:
+        // Internal verdicts, never returned to the application.
+        static constexpr Verdict CHECK = 2;       // Evaluate per-packet predicates.
+        static constexpr Verdict UNSET = 0xFE;    // No explicit verdict on this PID.
+        static constexpr Verdict UNKNOWN = 0xFF;  // Verdict not yet computed.
+
+        // A per-packet predicate and its value.
+        struct PredicateEntry
+        {
+            Predicate pred;
+            int       value;
+        };
+        using PacketRange = std::pair<PacketCounter, PacketCounter>;
+
+        DuckContext&                 _duck;
+        SignalizationDemux           _demux {_duck};
+        SignalizationHandlerInterface* _handler = nullptr;    // Application signalization handler.
+        bool                         _need_demux = false;     // Signalization demux is required.
+        bool                         _pid_criteria = false;   // There are signalization-based PID criteria.
+        bool                         _packet_criteria = false; // There are per-packet criteria.
+        Verdict                      _default_verdict = DROP; // Verdict for unselected PID's.
+        std::array<Verdict, PID_MAX> _explicit {};            // Explicit verdicts, UNSET if none.
+        std::array<Verdict, PID_MAX> _compiled {};            // Compiled verdicts, UNKNOWN if not yet computed.
+        std::set<PIDClass>           _pid_classes {};         // Selected PID classes.
+        std::set<CodecType>          _codecs {};              // Selected codecs.
+        std::set<uint16_t>           _service_ids {};         // Selected service ids, from the application.
+        std::set<uint16_t>           _all_service_ids {};     // Selected service ids, including resolved service names.
+        UStringVector                _service_names {};       // Selected service names.
+        std::vector<PredicateEntry>  _predicates {};          // Simple per-packet predicates.
+        TSPacketLabelSet             _labels {};              // Selected labels.
+        std::set<uint8_t>            _stream_ids {};          // Selected PES stream ids.
+        PIDSet                       _stream_id_pids {};      // PID's which currently carry selected stream ids.
+        std::set<uint8_t>            _isdb_layers {};         // Selected ISDB-T layers.
+        ByteBlock                    _pattern {};             // Binary pattern to search.
+        bool                         _pattern_payload = false; // Search pattern in payload only.
+        bool                         _pattern_use_offset = false; // Search pattern at specified offset only.
+        size_t                       _pattern_offset = 0;     // Offset of pattern.
+        std::vector<PacketRange>     _ranges {};              // Selected packet ranges.
+        PacketCounter                _every = 0;              // Select one packet every N packets.
+        PacketCounter                _every_origin = 0;       // Index of first selected packet with _every.
+
+        // Invalidate all compiled verdicts. They will be recomputed on demand.
+        void invalidate() { _compiled.fill(UNKNOWN); }
+
+        // Update the state of the classifier after modifying criteria.
+        void updateCriteria();
+
+        // Compute the verdict of a PID.
+        Verdict compile(PID pid) const;
+
+        // Evaluate all per-packet predicates.
+        bool evaluate(const TSPacket& pkt, const TSPacketMetadata& mdata, PacketCounter index);
+
+        // Implementation of SignalizationHandlerInterface: invalidate verdicts when signalization changes.
+        // All notifications are forwarded to the application handler, if any.
+        virtual void handlePAT(const PAT& table, PID pid) override;
+        virtual void handleCAT(const CAT& table, PID pid) override;
+        virtual void handlePMT(const PMT& table, PID pid) override;
+        virtual void handleTSDT(const TSDT& table, PID pid) override;
+        virtual void handleNIT(const NIT& table, PID pid) override;
+        virtual void handleSDT(const SDT& table, PID pid) override;
+        virtual void handleBAT(const BAT& table, PID pid) override;
+        virtual void handleRST(const RST& table, PID pid) override;
+        virtual void handleTDT(const TDT& table, PID pid) override;
+        virtual void handleTOT(const TOT& table, PID pid) override;
+        virtual void handleMGT(const MGT& table, PID pid) override;
+        virtual void handleVCT(const VCT& table, PID pid) override;
+        virtual void handleCVCT(const CVCT& table, PID pid) override;
+        virtual void handleTVCT(const TVCT& table, PID pid) override;
+        virtual void handleRRT(const RRT& table, PID pid) override;
+        virtual void handleSTT(const STT& table, PID pid) override;
+        virtual void handleUTC(const Time& utc, TID tid) override;
+        virtual void handleSAT(const SAT& table, PID pid) override;
+        virtual void handleService(uint16_t ts_id, const Service& service, const PMT& pmt, bool removed) override;
+    };
+}
@@ -0,0 +1,262 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsSectionArena.h"
+#include "tsSection.h"
+#include "tsPSI.h"
+
+
+//----------------------------------------------------------------------------
+// The memory pool, shared by the arena and all its sections.
+//----------------------------------------------------------------------------
+
+class ts::SectionArena::Pool
+{
+    TS_NOCOPY(Pool);
+public:
+    Pool() = default;
+    ~Pool();
+
+    // Allocate / deallocate raw memory for the Section and control block objects.
+    void* allocate(size_t size);
+    void deallocate(void* addr, size_t size);
+
+    // Get / recycle a ByteBlock for a section data area.
+    ByteBlock* getByteBlock(size_t size);
+    void recycle(ByteBlock* bb);
+
+    // Statistics, under the protection of the mutex.
+    mutable std::mutex mutex {};
+    Statistics stats {};
+
+private:
+    // Raw memory blocks are allocated in slabs, by size classes, with 16-byte granularity.
+    static constexpr size_t GRANULARITY = 16;
+    static constexpr size_t MAX_BLOCK_SIZE = 256;
+    static constexpr size_t BLOCKS_PER_SLAB = 64;
+    static constexpr size_t SIZE_CLASSES = MAX_BLOCK_SIZE / GRANULARITY;
+
+    // ByteBlock objects are recycled by capacity classes, up to the maximum section size.
+    static constexpr size_t BB_CLASSES = 3;
+    static constexpr size_t BB_CAPACITY[BB_CLASSES] {256, 1024, MAX_PRIVATE_SECTION_SIZE};
+    static constexpr size_t MAX_FREE_BYTE_BLOCKS = 256;
+
+    // A free memory block is a node in a singly-linked list.
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    std::vector<void*>      _slabs {};
+    FreeBlock*              _free_blocks[SIZE_CLASSES] {};
+    std::vector<ByteBlock*> _free_bb[BB_CLASSES] {};
+
+    // Get the ByteBlock class for a given size, BB_CLASSES if too large.
+    static size_t byteBlockClass(size_t size);
+};
+
+
+//----------------------------------------------------------------------------
+// Standard C++ allocator on the memory pool.
+//----------------------------------------------------------------------------
+
+template <typename T>
+class ts::SectionArena::Allocator
+{
+public:
+    using value_type = T;
+    std::shared_ptr<Pool> pool;
+
+    Allocator(const std::shared_ptr<Pool>& p) : pool(p) {}
+    template <typename U> Allocator(const Allocator<U>& other) : pool(other.pool) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(pool->allocate(n * sizeof(T))); }
+    void deallocate(T* p, size_t n) { pool->deallocate(p, n * sizeof(T)); }
+
+    template <typename U> bool operator==(const Allocator<U>& other) const { return pool == other.pool; }
+};
+
+
+//----------------------------------------------------------------------------
+// Deleter of ByteBlock objects, return them to the memory pool.
+//----------------------------------------------------------------------------
+
+class ts::SectionArena::Recycler
+{
+public:
+    std::shared_ptr<Pool> pool;
+    void operator()(ByteBlock* bb) const { pool->recycle(bb); }
+};
+
+
+//----------------------------------------------------------------------------
+// Arena constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::SectionArena::SectionArena() :
+    _pool(std::make_shared<Pool>())
+{
+}
+
+ts::SectionArena::~SectionArena()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Get the statistics of the arena.
+//----------------------------------------------------------------------------
+
+ts::SectionArena::Statistics ts::SectionArena::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(_pool->mutex);
+    return _pool->stats;
+}
+
+
+//----------------------------------------------------------------------------
+// Allocate a new section from the arena.
+//----------------------------------------------------------------------------
+
+ts::SectionPtr ts::SectionArena::newSection(const void* content, size_t content_size, PID source_pid, CRC32::Validation crc_op)
+{
+    // Get a data area for the section.
+    ByteBlock* bb = _pool->getByteBlock(content_size);
+    bb->copy(content, content_size);
+
+    // The control block of the ByteBlockPtr is allocated in the pool.
+    // The ByteBlock is returned to the pool when the last reference is released.
+    ByteBlockPtr bbptr(bb, Recycler{_pool}, Allocator<ByteBlock>(_pool));
+
+    // The Section and its control block are allocated in the pool.
+    return std::allocate_shared<Section>(Allocator<Section>(_pool), bbptr, source_pid, crc_op);
+}
+
+
+//----------------------------------------------------------------------------
+// Memory pool destructor.
+//----------------------------------------------------------------------------
+
+ts::SectionArena::Pool::~Pool()
+{
+    for (auto addr : _slabs) {
+        ::operator delete(addr);
+    }
+    for (auto& list : _free_bb) {
+        for (auto bb : list) {
+            delete bb;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Allocate / deallocate raw memory for the Section and control block objects.
+//----------------------------------------------------------------------------
+
+void* ts::SectionArena::Pool::allocate(size_t size)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (size == 0 || size > MAX_BLOCK_SIZE) {
+        // Unusual size, use the system heap.
+        stats.large_blocks++;
+        return ::operator new(size);
+    }
+
+    const size_t index = (size - 1) / GRANULARITY;
+    if (_free_blocks[index] == nullptr) {
+        // Allocate a new slab and split it in free blocks.
+        const size_t block_size = (index + 1) * GRANULARITY;
+        uint8_t* slab = static_cast<uint8_t*>(::operator new(block_size * BLOCKS_PER_SLAB));
+        _slabs.push_back(slab);
+        stats.slabs++;
+        stats.memory_size += block_size * BLOCKS_PER_SLAB;
+        for (size_t i = 0; i < BLOCKS_PER_SLAB; ++i) {
+            FreeBlock* fb = reinterpret_cast<FreeBlock*>(slab + i * block_size);
+            fb->next = _free_blocks[index];
+            _free_blocks[index] = fb;
+        }
+    }
+
+    FreeBlock* fb = _free_blocks[index];
+    _free_blocks[index] = fb->next;
+    return fb;
+}
+
+void ts::SectionArena::Pool::deallocate(void* addr, size_t size)
+{
+    if (size == 0 || size > MAX_BLOCK_SIZE) {
+        ::operator delete(addr);
+    }
+    else {
+        std::lock_guard<std::mutex> lock(mutex);
+        FreeBlock* fb = static_cast<FreeBlock*>(addr);
+        const size_t index = (size - 1) / GRANULARITY;
+        fb->next = _free_blocks[index];
+        _free_blocks[index] = fb;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get / recycle a ByteBlock for a section data area.
+//----------------------------------------------------------------------------
+
+size_t ts::SectionArena::Pool::byteBlockClass(size_t size)
+{
+    size_t index = 0;
+    while (index < BB_CLASSES && size > BB_CAPACITY[index]) {
+        index++;
+    }
+    return index;
+}
+
+ts::ByteBlock* ts::SectionArena::Pool::getByteBlock(size_t size)
+{
+    const size_t index = byteBlockClass(size);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.sections++;
+        if (index < BB_CLASSES && !_free_bb[index].empty()) {
+            ByteBlock* bb = _free_bb[index].back();
+            _free_bb[index].pop_back();
+            stats.reused_byte_blocks++;
+            stats.memory_size -= sizeof(ByteBlock) + bb->capacity();
+            return bb;
+        }
+        stats.new_byte_blocks++;
+    }
+
+    // Allocate a new ByteBlock outside the critical section.
+    ByteBlock* bb = new ByteBlock;
+    bb->reserve(index < BB_CLASSES ? BB_CAPACITY[index] : size);
+    return bb;
+}
+
+void ts::SectionArena::Pool::recycle(ByteBlock* bb)
+{
+    if (bb != nullptr) {
+        // The ByteBlock may have been resized by the application, recompute its class:
+        // the largest class which fits in the capacity. Don't keep oversized blocks.
+        size_t count = BB_CLASSES;
+        while (count > 0 && bb->capacity() < BB_CAPACITY[count - 1]) {
+            count--;
+        }
+        if (count > 0 && bb->capacity() <= 2 * BB_CAPACITY[count - 1]) {
+            const size_t index = count - 1;
+            std::lock_guard<std::mutex> lock(mutex);
+            if (_free_bb[index].size() < MAX_FREE_BYTE_BLOCKS) {
+                bb->clear();
+                _free_bb[index].push_back(bb);
+                stats.memory_size += sizeof(ByteBlock) + bb->capacity();
+                return;
+            }
+        }
+        delete bb;
+    }
+}
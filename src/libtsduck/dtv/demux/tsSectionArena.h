@@ -0,0 +1,98 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Memory arena for the allocation of sections.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTablesPtr.h"
+#include "tsCRC32.h"
+#include "tsTS.h"
+
+namespace ts {
+    //!
+    //! Memory arena for the allocation of sections.
+    //! @ingroup mpeg
+    //!
+    //! Allocating a Section from the heap requires at least three memory allocations:
+    //! the Section object with its shared pointer control block, the ByteBlock object
+    //! with its own control block and the data area of the ByteBlock. In demuxes with
+    //! high section rates, such as EIT-heavy streams, these allocations can become
+    //! a significant part of the processing.
+    //!
+    //! A section arena allocates these objects from slabs of fixed-size memory blocks
+    //! and recycles the ByteBlock objects, using a few size classes, up to the maximum
+    //! section size. After some time, when the arena is warm, allocating a section does
+    //! not call the system allocator anymore.
+    //!
+    //! The allocated sections are standard Section objects, referenced by standard SectionPtr.
+    //! They can safely outlive the arena object: the memory of the arena is released when
+    //! the arena object and all sections which were allocated from it are deleted.
+    //!
+    //! This class is thread-safe. Sections can be released from any thread.
+    //!
+    class TSDUCKDLL SectionArena
+    {
+        TS_NOCOPY(SectionArena);
+    public:
+        //!
+        //! Constructor.
+        //!
+        SectionArena();
+
+        //!
+        //! Destructor.
+        //!
+        ~SectionArena();
+
+        //!
+        //! Allocate a new section from the arena.
+        //! @param [in] content Address of the binary section data.
+        //! @param [in] content_size Size in bytes of the section.
+        //! @param [in] source_pid PID from which the section was read.
+        //! @param [in] crc_op How to process the CRC32 of the section.
+        //! @return A safe pointer to the new section. Check isValid() on the section.
+        //!
+        SectionPtr newSection(const void* content, size_t content_size, PID source_pid, CRC32::Validation crc_op);
+
+        //!
+        //! Statistics of an arena.
+        //!
+        class TSDUCKDLL Statistics
+        {
+        public:
+            uint64_t sections = 0;         //!< Number of allocated sections.
+            uint64_t slabs = 0;            //!< Number of memory slabs which were allocated from the system.
+            uint64_t large_blocks = 0;     //!< Number of memory blocks which were too large for a slab.
+            uint64_t new_byte_blocks = 0;  //!< Number of ByteBlock objects which were allocated from the system.
+            uint64_t reused_byte_blocks = 0; //!< Number of ByteBlock objects which were recycled.
+            size_t   memory_size = 0;      //!< Current memory size in the arena (slabs and free ByteBlock objects).
+
+            //!
+            //! Number of memory allocations which were performed on the system heap.
+            //! @return The number of memory allocations on the system heap.
+            //!
+            uint64_t heapAllocations() const { return slabs + large_blocks + 2 * new_byte_blocks; }
+        };
+
+        //!
+        //! Get the statistics of the arena.
+        //! @return The statistics of the arena.
+        //!
+        Statistics getStatistics() const;
+
+    private:
+        class Pool;
+        class Recycler;
+        template <typename T> class Allocator;
+
+        std::shared_ptr<Pool> _pool;
+    };
+}
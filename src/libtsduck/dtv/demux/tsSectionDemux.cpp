@@ -66,6 +66,21 @@ bool ts::SectionDemux::Status::hasErrors() const
         truncated_sect != 0;
 }
 
+// Add the counters of another status block.
+ts::SectionDemux::Status& ts::SectionDemux::Status::operator+=(const Status& other)
+{
+    invalid_ts += other.invalid_ts;
+    discontinuities += other.discontinuities;
+    scrambled += other.scrambled;
+    inv_sect_length += other.inv_sect_length;
+    inv_sect_index += other.inv_sect_index;
+    inv_sect_version += other.inv_sect_version;
+    wrong_crc += other.wrong_crc;
+    is_next += other.is_next;
+    truncated_sect += other.truncated_sect;
+    return *this;
+}
+
 
 //----------------------------------------------------------------------------
 // Display content of a status block.
@@ -184,6 +199,22 @@ ts::SectionDemux::SectionDemux(DuckContext& duck, TableHandlerInterface* table_h
 }
 
 
+//----------------------------------------------------------------------------
+// Allocate the demuxed sections from a memory arena.
+//----------------------------------------------------------------------------
+
+void ts::SectionDemux::useSectionArena(bool on)
+{
+    if (!on) {
+        // Previously allocated sections keep the memory pool alive.
+        _arena.reset();
+    }
+    else if (_arena == nullptr) {
+        _arena = std::make_shared<SectionArena>();
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Reset the analysis context (partially built sections and tables).
 //----------------------------------------------------------------------------
@@ -478,7 +509,12 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
             SectionPtr sect_ptr;
 
             if (section_ok && (_section_handler != nullptr || (tc != nullptr && tc->sects[section_number] == nullptr))) {
-                sect_ptr = std::make_shared<Section>(ts_start, section_length, pid, CRC32::CHECK);
+                if (_arena != nullptr) {
+                    sect_ptr = _arena->newSection(ts_start, section_length, pid, CRC32::CHECK);
+                }
+                else {
+                    sect_ptr = std::make_shared<Section>(ts_start, section_length, pid, CRC32::CHECK);
+                }
                 sect_ptr->setFirstTSPacketIndex(pusi_pkt_index);
                 sect_ptr->setLastTSPacketIndex(_packet_count);
                 if (!sect_ptr->isValid()) {
@@ -18,6 +18,8 @@
 #include "tsSectionHandlerInterface.h"
 #include "tsInvalidSectionHandlerInterface.h"
 #include "tsXTID.h"
+#include "tsPIDMap.h"
+#include "tsSectionArena.h"
 
 namespace ts {
     //!
@@ -151,6 +153,21 @@ namespace ts {
             _ts_error_level = level;
         }
 
+        //!
+        //! Allocate the demuxed sections from a memory arena.
+        //! When the section rate is high, this reduces the number of heap allocations.
+        //! The demuxed sections can be safely kept by the application after the destruction of the demux.
+        //! @param [in] on Use a memory arena. This is false by default.
+        //! @see SectionArena
+        //!
+        void useSectionArena(bool on);
+
+        //!
+        //! Get the memory arena which is used to allocate sections.
+        //! @return A pointer to the memory arena or a null pointer if no arena is used.
+        //!
+        const SectionArena* sectionArena() const { return _arena.get(); }
+
         //!
         //! Demux status information.
         //! It contains error counters.
@@ -190,6 +207,14 @@ namespace ts {
             //!
             bool hasErrors() const;
 
+            //!
+            //! Add the counters of another status block.
+            //! This is useful when the PID's of a stream are demuxed by several demux.
+            //! @param [in] other Another status block to add.
+            //! @return A reference to this object.
+            //!
+            Status& operator+=(const Status& other);
+
             //!
             //! Display the content of a status block.
             //! @param [in,out] strm A standard stream in output mode.
@@ -278,12 +303,13 @@ namespace ts {
         TableHandlerInterface*          _table_handler = nullptr;
         SectionHandlerInterface*        _section_handler = nullptr;
         InvalidSectionHandlerInterface* _invalid_handler = nullptr;
-        std::map<PID,PIDContext>        _pids {};
+        PIDMap<PIDContext>              _pids {};
         Status _status {};
         bool   _get_current = true;
         bool   _get_next = false;
         bool   _track_invalid_version = false;
         int    _ts_error_level {Severity::Debug};
+        std::shared_ptr<SectionArena> _arena {};
     };
 }
 
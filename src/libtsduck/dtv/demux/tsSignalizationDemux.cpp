@@ -15,7 +15,10 @@
 #include "tsCADescriptor.h"
 #include "tsISDBAccessControlDescriptor.h"
 #include "tsCAT.h"
-#include "tsSDT.h"
+#include "tsPATView.h"
+#include "tsPMTView.h"
+#include "tsNITView.h"
+#include "tsSDTView.h"
 #include "tsBAT.h"
 #include "tsRST.h"
 #include "tsTDT.h"
@@ -67,6 +70,7 @@ void ts::SignalizationDemux::reset()
     _last_pat_handled = false;
     _last_nit.invalidate();
     _last_nit_handled = false;
+    _last_sdt.invalidate();
     _ts_id = INVALID_TS_ID;
     _orig_network_id = _network_id = INVALID_NETWORK_ID;
     _last_utc.clear();
@@ -231,6 +235,18 @@ void ts::SignalizationDemux::getServices(ServiceList& services) const
     }
 }
 
+bool ts::SignalizationDemux::getPMT(PMT& pmt, uint16_t service_id) const
+{
+    const auto it = _services.find(service_id);
+    if (it == _services.end()) {
+        pmt.invalidate();
+    }
+    else {
+        pmt = it->second->pmt;
+    }
+    return pmt.isValid();
+}
+
 
 //----------------------------------------------------------------------------
 // Add table filtering for full services and PID's analysis.
@@ -613,62 +629,124 @@ void ts::SignalizationDemux::handleTable(SectionDemux&, const BinaryTable& table
     const PID pid = table.sourcePID();
     const TID tid = table.tableId();
 
+    // For the most frequent tables, when the application does not want the table, a new version
+    // which is identical to the previous one, except the version, is not deserialized again.
     switch (tid) {
         case TID_PAT: {
-            const PAT pat(_duck, table);
-            if (pat.isValid() && pid == PID_PAT) {
-                handlePAT(pat, pid);
+            if (pid == PID_PAT && !isHandledTableId(TID_PAT) && PATView::SameContent(table, _last_pat)) {
+                handleSamePAT(table.version());
+            }
+            else {
+                const PAT pat(_duck, table);
+                if (pat.isValid() && pid == PID_PAT) {
+                    handlePAT(pat, pid);
+                }
             }
             break;
         }
         case TID_CAT: {
-            const CAT cat(_duck, table);
-            if (cat.isValid() && pid == PID_CAT) {
-                handleCAT(cat, pid);
+            if (pid == PID_CAT && !isHandledTableId(TID_CAT)) {
+                // The CAT is only used to locate the EMM PID's.
+                for (size_t i = 0; i < table.sectionCount(); ++i) {
+                    const CATView cat(*table.sectionAt(i));
+                    if (cat.isValid()) {
+                        handleCAT(cat, pid);
+                    }
+                }
+            }
+            else {
+                const CAT cat(_duck, table);
+                if (cat.isValid() && pid == PID_CAT) {
+                    handleCAT(cat, pid);
+                }
             }
             break;
         }
         case TID_PMT: {
-            const PMT pmt(_duck, table);
-            if (pmt.isValid()) {
-                handlePMT(pmt, pid);
+            const uint16_t service_id = table.tableIdExtension();
+            const auto srv(getServiceContext(service_id, CreateService::NEVER));
+            if (srv != nullptr &&
+                srv->service.hasPMTPID(pid) &&
+                !isHandledTableId(TID_PMT) &&
+                (_handler == nullptr || !isFilteredServiceId(service_id)) &&
+                PMTView::SameContent(table, srv->pmt))
+            {
+                handleSamePMT(*srv, table.version());
+            }
+            else {
+                const PMT pmt(_duck, table);
+                if (pmt.isValid()) {
+                    handlePMT(pmt, pid);
+                }
             }
             break;
         }
         case TID_TSDT: {
-            const TSDT tsdt(_duck, table);
-            if (tsdt.isValid() && pid == PID_TSDT && _handler != nullptr && isFilteredTableId(TID_TSDT)) {
-                _handler->handleTSDT(tsdt, pid);
+            if (pid == PID_TSDT && isHandledTableId(TID_TSDT)) {
+                const TSDT tsdt(_duck, table);
+                if (tsdt.isValid()) {
+                    _handler->handleTSDT(tsdt, pid);
+                }
             }
             break;
         }
         case TID_NIT_ACT:
         case TID_NIT_OTH:  {
-            const NIT nit(_duck, table);
-            if (nit.isValid() && pid == nitPID()) {
-                handleNIT(nit, pid);
+            if (pid != nitPID()) {
+                // Not a NIT in the expected PID.
+            }
+            else if (!isHandledTableId(tid) && (tid == TID_NIT_OTH || NITView::SameContent(table, _last_nit))) {
+                // A NIT Other is only passed to the application. An identical NIT Actual is reprocessed,
+                // in case the services have changed since the previous version.
+                if (tid == TID_NIT_ACT) {
+                    _last_nit.version = table.version();
+                    handleNIT(_last_nit, pid);
+                }
+            }
+            else {
+                const NIT nit(_duck, table);
+                if (nit.isValid()) {
+                    handleNIT(nit, pid);
+                }
             }
             break;
         }
         case TID_SDT_ACT:
         case TID_SDT_OTH:  {
-            const SDT sdt(_duck, table);
-            if (sdt.isValid() && pid == PID_SDT) {
-                handleSDT(sdt, pid);
+            if (pid != PID_SDT) {
+                // Not an SDT in the expected PID.
+            }
+            else if (!isHandledTableId(tid) && (tid == TID_SDT_OTH || SDTView::SameContent(table, _last_sdt))) {
+                // An SDT Other is only passed to the application. An identical SDT Actual is reprocessed,
+                // in case the services have changed since the previous version.
+                if (tid == TID_SDT_ACT) {
+                    _last_sdt.version = table.version();
+                    handleSDT(_last_sdt, pid);
+                }
+            }
+            else {
+                const SDT sdt(_duck, table);
+                if (sdt.isValid()) {
+                    handleSDT(sdt, pid);
+                }
             }
             break;
         }
         case TID_BAT: {
-            const BAT bat(_duck, table);
-            if (bat.isValid() && pid == PID_BAT && _handler != nullptr && isFilteredTableId(tid)) {
-                _handler->handleBAT(bat, pid);
+            if (pid == PID_BAT && isHandledTableId(tid)) {
+                const BAT bat(_duck, table);
+                if (bat.isValid()) {
+                    _handler->handleBAT(bat, pid);
+                }
             }
             break;
         }
         case TID_RST: {
-            const RST rst(_duck, table);
-            if (rst.isValid() && pid == PID_RST && _handler != nullptr && isFilteredTableId(tid)) {
-                _handler->handleRST(rst, pid);
+            if (pid == PID_RST && isHandledTableId(tid)) {
+                const RST rst(_duck, table);
+                if (rst.isValid()) {
+                    _handler->handleRST(rst, pid);
+                }
             }
             break;
         }
@@ -720,9 +798,11 @@ void ts::SignalizationDemux::handleTable(SectionDemux&, const BinaryTable& table
             break;
         }
         case TID_RRT: {
-            const RRT rrt(_duck, table);
-            if (rrt.isValid() && pid == PID_PSIP && _handler != nullptr && isFilteredTableId(tid)) {
-                _handler->handleRRT(rrt, pid);
+            if (pid == PID_PSIP && isHandledTableId(tid)) {
+                const RRT rrt(_duck, table);
+                if (rrt.isValid()) {
+                    _handler->handleRRT(rrt, pid);
+                }
             }
             break;
         }
@@ -841,6 +921,24 @@ void ts::SignalizationDemux::handlePAT(const PAT& pat, PID pid)
 }
 
 
+//----------------------------------------------------------------------------
+// Process a new version of a PAT which is identical to the previous one.
+//----------------------------------------------------------------------------
+
+void ts::SignalizationDemux::handleSamePAT(uint8_t version)
+{
+    // Same as handlePAT() without any change in the services.
+    _last_pat.version = version;
+    _last_pat_handled = false;
+    _ts_id = _last_pat.ts_id;
+
+    // Reprocess the last NIT (TS id may have changed from an SDT).
+    if (_last_nit.isValid() && !_last_nit_handled) {
+        handleNIT(_last_nit, nitPID());
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Process a CAT.
 //----------------------------------------------------------------------------
@@ -856,6 +954,19 @@ void ts::SignalizationDemux::handleCAT(const CAT& cat, PID pid)
     handleDescriptors(cat.descs, pid);
 }
 
+void ts::SignalizationDemux::handleCAT(const CATView& cat, PID pid)
+{
+    // Look for EMM PID's in the CAT section, without deserialization. The CA_descriptor
+    // and the ISDB access_control_descriptor start with the same CA_system_id and PID.
+    for (const auto& desc : cat.descs()) {
+        if ((desc.tag() == DID_MPEG_CA || (bool(_duck.standards() & Standards::ISDB) && desc.tag() == DID_ISDB_CA)) && desc.payloadSize() >= 4) {
+            auto& ctx(getPIDContext(GetUInt16(desc.payload() + 2) & 0x1FFF));
+            ctx.cas_id = GetUInt16(desc.payload());
+            ctx.pid_class = PIDClass::EMM;
+        }
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Process a PMT.
@@ -924,6 +1035,22 @@ void ts::SignalizationDemux::handlePMT(const PMT& pmt, PID pid)
 }
 
 
+//----------------------------------------------------------------------------
+// Process a new version of a PMT which is identical to the previous one.
+//----------------------------------------------------------------------------
+
+void ts::SignalizationDemux::handleSamePMT(ServiceContext& srv, uint8_t version)
+{
+    srv.pmt.version = version;
+
+    // Same notification as handlePMT(), the PMT version has changed.
+    if (_handler != nullptr) {
+        _handler->handleService(_ts_id, srv.service, srv.pmt, false);
+        srv.service.clearModified();
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Process a NIT.
 //----------------------------------------------------------------------------
@@ -989,6 +1116,11 @@ void ts::SignalizationDemux::handleSDT(const SDT& sdt, PID pid)
     // Extract information on this TS only on the SDT Actual.
     if (sdt.isActual()) {
 
+        // Remember the last SDT (if not the reprocessing of the last SDT)
+        if (&sdt != &_last_sdt) {
+            _last_sdt = sdt;
+        }
+
         // Get transport stream identification.
         _ts_id = sdt.ts_id;
         _orig_network_id = sdt.onetw_id;
@@ -21,6 +21,8 @@
 #include "tsPAT.h"
 #include "tsPMT.h"
 #include "tsNIT.h"
+#include "tsSDT.h"
+#include "tsCATView.h"
 #include "tsDVB.h"
 
 namespace ts {
@@ -79,6 +81,13 @@ namespace ts {
         //!
         void setHandler(SignalizationHandlerInterface* handler) { _handler = handler; }
 
+        //!
+        //! Allocate the demuxed sections from a memory arena.
+        //! @param [in] on Use a memory arena. This is false by default.
+        //! @see SectionDemux::useSectionArena()
+        //!
+        void useSectionArena(bool on) { _demux.useSectionArena(on); }
+
         //!
         //! Reset the demux, remove all signalization filters.
         //!
@@ -257,6 +266,14 @@ namespace ts {
         //!
         void getServices(ServiceList& services) const;
 
+        //!
+        //! Get the last PMT of a service.
+        //! @param [out] pmt The last PMT of the service. Invalidated if the service or its PMT is unknown.
+        //! @param [in] service_id The service id.
+        //! @return True if the PMT of the service has been received, false otherwise.
+        //!
+        bool getPMT(PMT& pmt, uint16_t service_id) const;
+
         //--------------------------------------------------------------------
         // Accessing PID information.
         //--------------------------------------------------------------------
@@ -679,6 +696,7 @@ namespace ts {
         bool                           _last_pat_handled = false;  // Last received PAT was handled by application.
         NIT                            _last_nit {};               // Last received NIT.
         bool                           _last_nit_handled = false;  // Last received NIT was handled by application.
+        SDT                            _last_sdt {};               // Last received SDT Actual.
         uint16_t                       _ts_id = INVALID_TS_ID;     // Transport stream id.
         uint16_t                       _orig_network_id = INVALID_NETWORK_ID;  // Original network id.
         uint16_t                       _network_id = INVALID_NETWORK_ID;       // Actual network id.
@@ -689,6 +707,9 @@ namespace ts {
         // Get the context for a PID. Create if not existent.
         PIDContext& getPIDContext(PID pid);
 
+        // Check if a table id shall be passed to the application.
+        bool isHandledTableId(TID tid) const { return _handler != nullptr && isFilteredTableId(tid); }
+
         // When to create a service description.
         enum class CreateService {ALWAYS, IF_MAY_EXIST, NEVER};
 
@@ -702,6 +723,7 @@ namespace ts {
         // Process specific tables.
         void handlePAT(const PAT&, PID);
         void handleCAT(const CAT&, PID);
+        void handleCAT(const CATView&, PID);
         void handlePMT(const PMT&, PID);
         void handleNIT(const NIT&, PID);
         void handleSDT(const SDT&, PID);
@@ -715,6 +737,10 @@ namespace ts {
         // Process a descriptor list, looking for useful information.
         void handleDescriptors(const DescriptorList&, PID);
 
+        // Process a new version of a PAT or PMT which is identical to the previous one.
+        void handleSamePAT(uint8_t version);
+        void handleSamePMT(ServiceContext& srv, uint8_t version);
+
         // Extract a field of a PIDContext.
         template<typename T>
         T getPIDContextField(PID pid, const T& no_value, T PIDContext::* field) const;
@@ -17,6 +17,7 @@
 #include "tstlvMessageFactory.h"
 #include "tstlvMessage.h"
 #include "tstlvLogger.h"
+#include "tstlvSerializer.h"
 
 namespace ts::tlv {
     //!
@@ -92,6 +93,46 @@ namespace ts::tlv {
         //!
         bool receive(MessagePtr& msg, const AbortInterface* abort, Logger& logger);
 
+        //!
+        //! Serialize and send a TLV message on a non-blocking connection.
+        //! The message is serialized at the end of the output buffer of the connection.
+        //! Then, the output buffer is sent as much as possible, without blocking.
+        //! The rest of the data remain buffered and will be sent by subsequent calls
+        //! to sendNonBlocking() or flushOutput(), typically when the socket becomes
+        //! writable in a SocketReactor.
+        //! @param [in] msg The message to send.
+        //! @param [in,out] logger Where to report errors and messages.
+        //! @return True on success, false on error.
+        //! @see setNonBlocking()
+        //!
+        bool sendNonBlocking(const Message& msg, Logger& logger);
+
+        //!
+        //! Send buffered output data on a non-blocking connection, without blocking.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //! @see sendNonBlocking()
+        //!
+        bool flushOutput(Report& report);
+
+        //!
+        //! Check if some output data are buffered on a non-blocking connection.
+        //! @return True if some output data are waiting to be sent.
+        //!
+        bool hasPendingOutput() const { return _out_start < _out_buffer->size(); }
+
+        //!
+        //! Receive all TLV messages which are immediately available on a non-blocking connection.
+        //! Incomplete messages remain buffered until the rest of their data is received.
+        //! Invalid messages are processed as in receive().
+        //! @param [in,out] msgs The received messages are appended to this list.
+        //! @param [in,out] logger Where to report errors and messages.
+        //! @return True on success, false on error or disconnection. When false is returned,
+        //! some messages may have been received before the error and appended to @a msgs.
+        //! @see setNonBlocking()
+        //!
+        bool receiveNonBlocking(std::list<MessagePtr>& msgs, Logger& logger);
+
         //!
         //! Get invalid incoming messages processing.
         //! @return True if, when an invalid message is received, the corresponding
@@ -131,6 +172,19 @@ namespace ts::tlv {
         size_t          _invalid_msg_count = 0;
         MutexType       _send_mutex {};
         MutexType       _receive_mutex {};
+        ByteBlock       _in_buffer {};       // Non-blocking mode: partially received messages.
+        ByteBlockPtr    _out_buffer {std::make_shared<ByteBlock>()};  // Non-blocking mode: serialized messages to send.
+        size_t          _out_start = 0;      // Non-blocking mode: index of first byte to send in _out_buffer.
+
+        // Size of message header and offset of length field.
+        size_t headerSize() const { return _protocol.hasVersion() ? 5 : 4; }
+        size_t lengthOffset() const { return _protocol.hasVersion() ? 3 : 2; }
+
+        // Send buffered output data, with the send mutex already held.
+        bool flushOutputLocked(Report& report);
+
+        // Process an invalid message. Return false if the connection shall be broken.
+        bool handleInvalidMessage(MessageFactory& mf, Logger& logger, bool non_blocking);
     };
 }
 
@@ -159,6 +213,9 @@ void ts::tlv::Connection<SAFETY>::handleConnected(Report& report)
 {
     SuperClass::handleConnected(report);
     _invalid_msg_count = 0;
+    _in_buffer.clear();
+    _out_buffer->clear();
+    _out_start = 0;
 }
 TS_POP_WARNING()
 
@@ -233,22 +290,134 @@ bool ts::tlv::Connection<SAFETY>::receive(MessagePtr& msg, const AbortInterface*
         }
 
         // Received an invalid message
-        _invalid_msg_count++;
+        if (!handleInvalidMessage(mf, logger, false)) {
+            return false;
+        }
+    }
+}
 
-        // Send back an error message if necessary
-        if (_auto_error_response) {
-            MessagePtr resp;
-            mf.buildErrorResponse(resp);
-            if (!send(*resp, logger.report())) {
-                return false;
+// Process an invalid message. Return false if the connection shall be broken.
+template <ts::ThreadSafety SAFETY>
+bool ts::tlv::Connection<SAFETY>::handleInvalidMessage(MessageFactory& mf, Logger& logger, bool non_blocking)
+{
+    _invalid_msg_count++;
+
+    // Send back an error message if necessary
+    if (_auto_error_response) {
+        MessagePtr resp;
+        mf.buildErrorResponse(resp);
+        if (non_blocking ? !sendNonBlocking(*resp, logger) : !send(*resp, logger.report())) {
+            return false;
+        }
+    }
+
+    // If invalid message max has been reached, break the connection
+    if (_max_invalid_msg > 0 && _invalid_msg_count >= _max_invalid_msg) {
+        logger.report().error(u"too many invalid messages from %s, disconnecting", peerName());
+        disconnect(logger.report());
+        return false;
+    }
+    return true;
+}
+
+// Serialize and send a TLV message on a non-blocking connection.
+template <ts::ThreadSafety SAFETY>
+bool ts::tlv::Connection<SAFETY>::sendNonBlocking(const Message& msg, Logger& logger)
+{
+    logger.log(msg, u"sending message to " + peerName());
+
+    std::lock_guard<MutexType> lock(_send_mutex);
+    {
+        // Serialize at the end of the output buffer. The serializer must be destructed before sending.
+        Serializer serial(_out_buffer);
+        msg.serialize(serial);
+    }
+    return flushOutputLocked(logger.report());
+}
+
+// Send buffered output data on a non-blocking connection.
+template <ts::ThreadSafety SAFETY>
+bool ts::tlv::Connection<SAFETY>::flushOutput(Report& report)
+{
+    std::lock_guard<MutexType> lock(_send_mutex);
+    return flushOutputLocked(report);
+}
+
+// Send buffered output data, with the send mutex already held.
+template <ts::ThreadSafety SAFETY>
+bool ts::tlv::Connection<SAFETY>::flushOutputLocked(Report& report)
+{
+    size_t sent = 0;
+    if (_out_start < _out_buffer->size() && !SuperClass::sendSome(_out_buffer->data() + _out_start, _out_buffer->size() - _out_start, sent, report)) {
+        return false;
+    }
+    _out_start += sent;
+
+    if (_out_start >= _out_buffer->size()) {
+        // Everything was sent, reuse the buffer.
+        _out_buffer->clear();
+        _out_start = 0;
+    }
+    else if (_out_start >= _out_buffer->size() / 2) {
+        // Compact the buffer when more than half of it was sent.
+        _out_buffer->erase(0, _out_start);
+        _out_start = 0;
+    }
+    return true;
+}
+
+// Receive all TLV messages which are immediately available on a non-blocking connection.
+template <ts::ThreadSafety SAFETY>
+bool ts::tlv::Connection<SAFETY>::receiveNonBlocking(std::list<MessagePtr>& msgs, Logger& logger)
+{
+    // Limit the amount of data per call to avoid starving other connections of the same reactor.
+    constexpr size_t CHUNK_SIZE = 16 * 1024;
+    constexpr size_t MAX_CHUNKS = 8;
+
+    bool ok = true;
+    size_t start = 0;
+    {
+        std::lock_guard<MutexType> lock(_receive_mutex);
+
+        // Read all immediately available data.
+        for (size_t count = 0; ok && count < MAX_CHUNKS; ++count) {
+            const size_t previous = _in_buffer.size();
+            size_t got = 0;
+            _in_buffer.resize(previous + CHUNK_SIZE);
+            ok = SuperClass::receiveSome(_in_buffer.data() + previous, CHUNK_SIZE, got, logger.report());
+            _in_buffer.resize(previous + got);
+            if (got < CHUNK_SIZE) {
+                break;
             }
         }
 
-        // If invalid message max has been reached, break the connection
-        if (_max_invalid_msg > 0 && _invalid_msg_count >= _max_invalid_msg) {
-            logger.report().error(u"too many invalid messages from %s, disconnecting", peerName());
-            disconnect(logger.report());
-            return false;
+        // Analyze all complete messages.
+        const size_t header_size = headerSize();
+        while (start + header_size <= _in_buffer.size()) {
+            const size_t size = header_size + GetUInt16(_in_buffer.data() + start + lengthOffset());
+            if (start + size > _in_buffer.size()) {
+                // Incomplete message, wait for more data.
+                break;
+            }
+            MessageFactory mf(_in_buffer.data() + start, size, _protocol);
+            start += size;
+            if (mf.errorStatus() == tlv::OK) {
+                _invalid_msg_count = 0;
+                MessagePtr msg;
+                mf.factory(msg);
+                if (msg != nullptr) {
+                    logger.log(*msg, u"received message from " + peerName());
+                    msgs.push_back(msg);
+                }
+            }
+            else if (!handleInvalidMessage(mf, logger, true)) {
+                ok = false;
+                break;
+            }
         }
+
+        // Remove analyzed messages.
+        _in_buffer.erase(0, start);
     }
+    return ok;
 }
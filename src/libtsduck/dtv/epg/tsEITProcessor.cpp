@@ -27,6 +27,8 @@ ts::EITProcessor::EITProcessor(DuckContext& duck, PID pid) :
 {
     _input_pids.set(pid);
     _demux.addPID(pid);
+    // All EIT sections are individually processed, allocate them from a memory arena.
+    _demux.useSectionArena(true);
 }
 
 void ts::EITProcessor::reset()
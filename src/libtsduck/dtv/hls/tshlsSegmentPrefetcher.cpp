@@ -0,0 +1,276 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tshlsSegmentPrefetcher.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::hls::SegmentPrefetcher::SegmentPrefetcher(Report& report) :
+    _report(report)
+{
+}
+
+ts::hls::SegmentPrefetcher::~SegmentPrefetcher()
+{
+    stop();
+}
+
+ts::hls::SegmentPrefetcher::PlayListThread::~PlayListThread()
+{
+    waitForTermination();
+}
+
+ts::hls::SegmentPrefetcher::DownloadThread::~DownloadThread()
+{
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Start downloading segments.
+//----------------------------------------------------------------------------
+
+bool ts::hls::SegmentPrefetcher::start(const PlayList& playlist, const WebRequestArgs& args, size_t depth, size_t max_segments)
+{
+    // Stop previous session, if any.
+    stop();
+
+    if (depth == 0) {
+        _report.error(u"invalid HLS prefetch depth");
+        return false;
+    }
+    if (!playlist.isMedia()) {
+        _report.error(u"invalid HLS playlist type, expected a media playlist");
+        return false;
+    }
+
+    // The other threads are not yet started, no need to lock.
+    _playlist = playlist;
+    _args = args;
+    _depth = depth;
+    _max_segments = max_segments;
+    _segment_count = 0;
+    _aborted = false;
+    _playlist_end = false;
+    _slots.clear();
+
+    // Start the threads. There is one download thread per prefetched segment.
+    _playlist_thread = std::make_unique<PlayListThread>(*this);
+    bool success = _playlist_thread->start();
+    for (size_t i = 0; success && i < _depth; ++i) {
+        _download_threads.push_back(std::make_unique<DownloadThread>(*this));
+        success = _download_threads.back()->start();
+    }
+    if (!success) {
+        _report.error(u"error starting HLS download threads");
+        stop();
+    }
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Abort all downloads.
+//----------------------------------------------------------------------------
+
+void ts::hls::SegmentPrefetcher::abort()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _aborted = true;
+    _changed.notify_all();
+
+    // Interrupt current transfers.
+    for (const auto& thread : _download_threads) {
+        thread->abort();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Stop all downloads and wait for the termination of all threads.
+//----------------------------------------------------------------------------
+
+void ts::hls::SegmentPrefetcher::stop()
+{
+    abort();
+
+    // The destructors of the threads wait for their termination.
+    _playlist_thread.reset();
+    _download_threads.clear();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _slots.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Get the next media segment, in playlist order.
+//----------------------------------------------------------------------------
+
+bool ts::hls::SegmentPrefetcher::getNextSegment(MediaSegment& segment, ByteBlock& data)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // Wait until the first segment in the pipeline is downloaded or there is no more segment.
+    _changed.wait(lock, [this]() {
+        return _aborted || (_slots.empty() && _playlist_end) || (!_slots.empty() && (_slots.front().state == State::COMPLETED || _slots.front().state == State::FAILED));
+    });
+    if (_aborted || _slots.empty()) {
+        return false;
+    }
+
+    // Remove the segment from the pipeline.
+    Slot& slot(_slots.front());
+    const bool success = slot.state == State::COMPLETED;
+    segment = slot.segment;
+    data.swap(slot.data);
+    _slots.pop_front();
+
+    // There is room in the pipeline for the next segment.
+    _changed.notify_all();
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Playlist thread: get segments from the playlist, reload it when necessary.
+//----------------------------------------------------------------------------
+
+void ts::hls::SegmentPrefetcher::PlayListThread::main()
+{
+    for (;;) {
+        // Wait until there is room in the pipeline.
+        {
+            std::unique_lock<std::mutex> lock(_parent._mutex);
+            _parent._changed.wait(lock, [this]() { return _parent._aborted || _parent._slots.size() < _parent._depth; });
+            if (_parent._aborted) {
+                break;
+            }
+        }
+
+        // Get next segment, without holding the mutex since the playlist may be reloaded.
+        MediaSegment seg;
+        if (!_parent.nextPlayListSegment(seg)) {
+            break;
+        }
+
+        // Queue the segment for download.
+        std::lock_guard<std::mutex> lock(_parent._mutex);
+        _parent._slots.emplace_back(seg);
+        _parent._changed.notify_all();
+    }
+
+    // No more segment will be queued.
+    std::lock_guard<std::mutex> lock(_parent._mutex);
+    _parent._playlist_end = true;
+    _parent._changed.notify_all();
+}
+
+
+//----------------------------------------------------------------------------
+// Get the next segment in the playlist, reload the playlist when necessary.
+//----------------------------------------------------------------------------
+
+bool ts::hls::SegmentPrefetcher::nextPlayListSegment(MediaSegment& seg)
+{
+    // Check if the maximum number of segments is reached.
+    if (_max_segments > 0 && _segment_count >= _max_segments) {
+        _report.verbose(u"HLS playlist completed");
+        return false;
+    }
+
+    // If there is only one or zero remaining segment, try to reload the playlist.
+    if (_playlist.segmentCount() < 2 && _playlist.isUpdatable()) {
+
+        // Reload the playlist, ignore errors, continue to play next segments.
+        _playlist.reload(false, _args, _report);
+
+        // If the playlist is still empty, the server has not yet produced new segments. For live streams,
+        // this is possible because new segments can be produced as late as the estimated end time of the
+        // previous playlist. So, we retry at regular intervals until we get new segments.
+        while (_playlist.segmentCount() == 0 && Time::CurrentUTC() <= _playlist.terminationUTC()) {
+            // The wait between two retries is half the target duration of a segment, with a minimum of 2 seconds.
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                if (_changed.wait_for(lock, std::max<cn::milliseconds>(cn::seconds(2), _playlist.targetDuration() / 2), [this]() { return _aborted; })) {
+                    return false;
+                }
+            }
+            // This time, we stop on reload error.
+            if (!_playlist.reload(false, _args, _report)) {
+                break;
+            }
+        }
+    }
+
+    // Remove first segment from the playlist.
+    if (!_playlist.popFirstSegment(seg)) {
+        _report.verbose(u"HLS playlist completed");
+        return false;
+    }
+    _segment_count++;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Download thread: download or read segments in the pipeline.
+//----------------------------------------------------------------------------
+
+void ts::hls::SegmentPrefetcher::DownloadThread::main()
+{
+    for (;;) {
+        // Wait for a segment to download.
+        Slot* slot = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(_parent._mutex);
+            _parent._changed.wait(lock, [this, &slot]() {
+                if (_parent._aborted) {
+                    return true;
+                }
+                for (auto& it : _parent._slots) {
+                    if (it.state == State::PENDING) {
+                        slot = &it;
+                        return true;
+                    }
+                }
+                return _parent._playlist_end;
+            });
+            if (slot == nullptr) {
+                // Aborted or no more segment to download.
+                break;
+            }
+            slot->state = State::DOWNLOADING;
+        }
+
+        // Download the segment without holding the mutex. The slot remains in the list until
+        // its state is COMPLETED or FAILED and no other thread accesses its data in between.
+        bool success = false;
+        if (slot->segment.url.isValid()) {
+            const UString url(slot->segment.url.toString());
+            _parent._report.debug(u"downloading segment %s", url);
+            _request.setArgs(_parent._args);
+            _request.setAutoRedirect(true);
+            _request.setKeepConnections(true);
+            success = _request.downloadBinaryContent(url, slot->data);
+        }
+        else {
+            // The playlist was loaded from a file, the segments are local files.
+            _parent._report.debug(u"reading segment %s", slot->segment.file_path);
+            success = slot->data.loadFromFile(slot->segment.file_path, std::numeric_limits<size_t>::max(), &_parent._report);
+        }
+
+        // Signal the end of download.
+        std::lock_guard<std::mutex> lock(_parent._mutex);
+        slot->state = success ? State::COMPLETED : State::FAILED;
+        _parent._changed.notify_all();
+    }
+}
@@ -0,0 +1,143 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Prefetch pipeline for HLS media segments.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tshlsPlayList.h"
+#include "tsWebRequest.h"
+#include "tsWebRequestArgs.h"
+#include "tsByteBlock.h"
+#include "tsThread.h"
+
+namespace ts::hls {
+    //!
+    //! Prefetch pipeline for the media segments of an HLS media playlist.
+    //! @ingroup hls
+    //!
+    //! The media segments are downloaded in advance by a pool of threads and returned to the
+    //! application in playlist order. Each download thread uses its own WebRequest object so that
+    //! its network connection is reused from one segment to the next one. With live playlists,
+    //! the playlist is reloaded in a separate thread, in parallel with the segment downloads.
+    //!
+    //! When the playlist was loaded from a file, the media segments are local files which are
+    //! read by the same threads.
+    //!
+    //! The number of segments which are simultaneously in memory (being downloaded or waiting
+    //! to be read by the application) is bounded by the prefetch depth.
+    //!
+    class TSDUCKDLL SegmentPrefetcher
+    {
+        TS_NOBUILD_NOCOPY(SegmentPrefetcher);
+    public:
+        //!
+        //! Constructor.
+        //! @param [in,out] report Where to report errors. Must be thread-safe.
+        //!
+        SegmentPrefetcher(Report& report);
+
+        //!
+        //! Destructor.
+        //!
+        ~SegmentPrefetcher();
+
+        //!
+        //! Start downloading segments.
+        //! @param [in] playlist A media playlist. The segments are downloaded starting with the first one
+        //! in the playlist. The playlist is copied and, when updatable, reloaded when necessary.
+        //! @param [in] args Web request arguments.
+        //! @param [in] depth Maximum number of segments to download in advance. This is also the number
+        //! of download threads. Must not be zero.
+        //! @param [in] max_segments Maximum number of segments to download. Zero means unlimited.
+        //! @return True on success, false on error.
+        //!
+        bool start(const PlayList& playlist, const WebRequestArgs& args, size_t depth, size_t max_segments = 0);
+
+        //!
+        //! Get the next media segment, in playlist order.
+        //! Wait until the segment is completely downloaded.
+        //! @param [out] segment Description of the media segment.
+        //! @param [out] data Content of the media segment.
+        //! @return True on success, false at end of playlist, on download error or after abort().
+        //!
+        bool getNextSegment(MediaSegment& segment, ByteBlock& data);
+
+        //!
+        //! Abort all downloads.
+        //! Can be called from another thread. Any subsequent call to getNextSegment() returns false.
+        //!
+        void abort();
+
+        //!
+        //! Stop all downloads and wait for the termination of all threads.
+        //!
+        void stop();
+
+    private:
+        // Download state of a segment.
+        enum class State {PENDING, DOWNLOADING, COMPLETED, FAILED};
+
+        // Description of a segment in the pipeline.
+        class Slot
+        {
+        public:
+            Slot(const MediaSegment& seg) : segment(seg) {}
+            MediaSegment segment;
+            State        state = State::PENDING;
+            ByteBlock    data {};
+        };
+
+        // Thread which reloads the playlist and queues segments.
+        class PlayListThread: public Thread
+        {
+            TS_NOBUILD_NOCOPY(PlayListThread);
+        public:
+            PlayListThread(SegmentPrefetcher& parent) : _parent(parent) {}
+            virtual ~PlayListThread() override;
+        private:
+            SegmentPrefetcher& _parent;
+            virtual void main() override;
+        };
+
+        // Thread which downloads segments.
+        class DownloadThread: public Thread
+        {
+            TS_NOBUILD_NOCOPY(DownloadThread);
+        public:
+            DownloadThread(SegmentPrefetcher& parent) : _parent(parent), _request(parent._report) {}
+            virtual ~DownloadThread() override;
+            void abort() { _request.abort(); }
+        private:
+            SegmentPrefetcher& _parent;
+            WebRequest         _request;  // Persistent request, keep the connection between segments.
+            virtual void main() override;
+        };
+
+        Report&                 _report;
+        WebRequestArgs          _args {};
+        size_t                  _depth = 0;
+        size_t                  _max_segments = 0;
+        size_t                  _segment_count = 0;       // Number of queued segments, in playlist thread.
+        PlayList                _playlist {};             // Used by the playlist thread only.
+        std::mutex              _mutex {};                // Protect all subsequent fields.
+        std::condition_variable _changed {};              // Signalled on any state change.
+        bool                    _aborted = false;         // All operations aborted.
+        bool                    _playlist_end = false;    // No more segment will be queued.
+        std::list<Slot>         _slots {};                // Segments in the pipeline, in playlist order.
+
+        // Working threads.
+        std::unique_ptr<PlayListThread>              _playlist_thread {};
+        std::vector<std::unique_ptr<DownloadThread>> _download_threads {};
+
+        // Get the next segment in the playlist, reload the playlist when necessary. Executed in the playlist thread.
+        bool nextPlayListSegment(MediaSegment& seg);
+    };
+}
@@ -515,13 +515,17 @@ void ts::PESDemux::handlePESContent(PIDContext& pc, const PESPacket& pes)
 
     // Process MPEG-1 (ISO 11172-2) and MPEG-2 (ISO 13818-2) video start codes
     else if (pes.isMPEG2Video()) {
-        // Locate all start codes and invoke handler.
+        // Locate all start codes in one pass and invoke handler.
         // The beginning of the payload is already a start code prefix.
+        constexpr uint8_t StartCodePrefixThird = 0x01;
+        LocateAllZeroZero(_start_codes, pl_data, pl_size, StartCodePrefixThird);
+        size_t index = 0;
         for (size_t offset = 0; offset + 4 < pl_size; ) {
-            // Look for next start code
-            constexpr uint8_t StartCodePrefixThird = 0x01;
-            const uint8_t* pnext = LocateZeroZero(pl_data + offset + 1, pl_size - offset - 1, StartCodePrefixThird);
-            size_t next = pnext == nullptr ? pl_size : pnext - pl_data;
+            // Look for next start code prefix 00 00 01, ignoring 00 00 00.
+            while (index < _start_codes.size() && (_start_codes[index] <= offset || pl_data[_start_codes[index] + 2] != StartCodePrefixThird)) {
+                index++;
+            }
+            const size_t next = index < _start_codes.size() ? _start_codes[index] : pl_size;
             // Invoke handler
             _pes_handler->handleVideoStartCode(*this, pes, pl_data[offset + 3], offset, next - offset);
             // Accumulate info from video units to extract video attributes.
@@ -21,6 +21,7 @@
 #include "tsHEVCAttributes.h"
 #include "tsAC3Attributes.h"
 #include "tsSectionDemux.h"
+#include "tsPIDMap.h"
 
 namespace ts {
     //!
@@ -196,7 +197,7 @@ namespace ts {
 
         // Map of PID contexts, indexed by PID.
         // One context is created per demuxed PES PID.
-        using PIDContextMap = std::map<PID,PIDContext>;
+        using PIDContextMap = PIDMap<PIDContext>;
 
         // This internal structure describes the content of one PID.
         struct PIDType
@@ -232,6 +233,7 @@ namespace ts {
         CodecType            _default_codec {CodecType::UNDEFINED};
         PIDContextMap        _pids {};
         PIDTypeMap           _pid_types {};
+        std::vector<size_t>  _start_codes {};  // Work area for start code offsets in a PES payload.
         SectionDemux         _section_demux;
     };
 }
@@ -0,0 +1,52 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsDescriptorListView.h"
+#include "tsDescriptorList.h"
+#include "tsMemory.h"
+
+
+//----------------------------------------------------------------------------
+// Load the descriptor from a binary area.
+//----------------------------------------------------------------------------
+
+size_t ts::DescriptorView::parse(const uint8_t* data, size_t size)
+{
+    if (data == nullptr || size < 2 || size_t(data[1]) + 2 > size) {
+        _data = nullptr;
+        return 0;
+    }
+    else {
+        _data = data;
+        return size_t(data[1]) + 2;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Compare with a descriptor list.
+//----------------------------------------------------------------------------
+
+bool ts::DescriptorListView::matchList(const DescriptorList& list, size_t& index) const
+{
+    size_t next = index;
+    for (const auto& desc : *this) {
+        if (next >= list.size() || list[next] == nullptr || list[next]->size() != desc.size() || !MemEqual(list[next]->content(), desc.content(), desc.size())) {
+            return false;
+        }
+        next++;
+    }
+    index = next;
+    return true;
+}
+
+bool ts::DescriptorListView::sameAs(const DescriptorList& list) const
+{
+    size_t index = 0;
+    return matchList(list, index) && index == list.size();
+}
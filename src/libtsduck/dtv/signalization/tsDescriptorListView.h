@@ -0,0 +1,99 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view over a binary list of descriptors.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsLoopView.h"
+#include "tsDID.h"
+
+namespace ts {
+
+    class DescriptorList;
+
+    //!
+    //! Read-only view over one binary descriptor, an entry in a DescriptorListView.
+    //! @ingroup mpeg
+    //!
+    class TSDUCKDLL DescriptorView
+    {
+    public:
+        //!
+        //! Get the descriptor tag.
+        //! @return The descriptor tag.
+        //!
+        DID tag() const { return _data == nullptr ? DID(0) : _data[0]; }
+
+        //!
+        //! Get the address of the binary descriptor.
+        //! @return The address of the binary descriptor, including the tag and length.
+        //!
+        const uint8_t* content() const { return _data; }
+
+        //!
+        //! Get the size of the binary descriptor.
+        //! @return The size in bytes of the binary descriptor, including the tag and length.
+        //!
+        size_t size() const { return _data == nullptr ? 0 : size_t(_data[1]) + 2; }
+
+        //!
+        //! Get the address of the descriptor payload.
+        //! @return The address of the descriptor payload, after the tag and length.
+        //!
+        const uint8_t* payload() const { return _data == nullptr ? nullptr : _data + 2; }
+
+        //!
+        //! Get the size of the descriptor payload.
+        //! @return The size in bytes of the descriptor payload.
+        //!
+        size_t payloadSize() const { return _data == nullptr ? 0 : size_t(_data[1]); }
+
+        //!
+        //! Load the descriptor from a binary area.
+        //! @param [in] data Address of the binary descriptor.
+        //! @param [in] size Size in bytes of the binary area.
+        //! @return The size of the descriptor or zero if truncated.
+        //!
+        size_t parse(const uint8_t* data, size_t size);
+
+    private:
+        const uint8_t* _data = nullptr;
+    };
+
+    //!
+    //! Read-only view over a binary list of descriptors, without copy or allocation.
+    //! @ingroup mpeg
+    //!
+    class TSDUCKDLL DescriptorListView : public LoopView<DescriptorView>
+    {
+    public:
+        using LoopView<DescriptorView>::LoopView;
+
+        //!
+        //! Check if the descriptors of this view are identical to a part of a descriptor list.
+        //! A deserialized table may be built from several sections, so its descriptor lists
+        //! may be split over several views.
+        //! @param [in] list A descriptor list to compare with.
+        //! @param [in,out] index Index in @a list of the first descriptor to compare with.
+        //! On return, when successful, index of the first descriptor after this view.
+        //! @return True if all descriptors of this view are identical to the corresponding
+        //! descriptors in @a list.
+        //!
+        bool matchList(const DescriptorList& list, size_t& index) const;
+
+        //!
+        //! Check if the descriptors of this view are identical to a complete descriptor list.
+        //! @param [in] list A descriptor list to compare with.
+        //! @return True if the descriptors are identical.
+        //!
+        bool sameAs(const DescriptorList& list) const;
+    };
+}
@@ -47,6 +47,13 @@ void ts::LogicalChannelNumbers::addLCN(uint16_t lcn, uint16_t srv_id, uint16_t t
     _lcn_map.insert(std::make_pair(srv_id, LCN{lcn, ts_id, onet_id, visible}));
 }
 
+void ts::LogicalChannelNumbers::addFrom(const LogicalChannelNumbers& other)
+{
+    for (const auto& it : other._lcn_map) {
+        addLCN(it.second.lcn, it.first, it.second.ts_id, it.second.onet_id, it.second.visible);
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Collect all LCN which are declared in a list of descriptors.
@@ -0,0 +1,177 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view over a loop of binary entries in a section.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+    //!
+    //! Read-only view over a loop of binary entries in a section, without copy or allocation.
+    //! @ingroup mpeg
+    //!
+    //! Many loops in MPEG or DVB tables are sequences of variable-size entries (descriptors,
+    //! elementary streams in a PMT, services in an SDT, etc.) This class iterates over these
+    //! entries directly in the binary data. The iteration stops on the first truncated entry.
+    //! The binary data must remain valid while the view or its iterators are in use.
+    //!
+    //! @tparam ENTRY The class of each entry. It must be default-constructible and have a
+    //! method `size_t parse(const uint8_t* data, size_t size)` which loads the entry from
+    //! the start of the binary area and returns the size of the entry in bytes, or zero
+    //! if the entry is truncated or invalid.
+    //!
+    template <class ENTRY>
+    class LoopView
+    {
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] data Address of the binary loop.
+        //! @param [in] size Size in bytes of the binary loop.
+        //!
+        LoopView(const uint8_t* data = nullptr, size_t size = 0) : _data(data), _size(data == nullptr ? 0 : size) {}
+
+        //!
+        //! Get the address of the binary loop.
+        //! @return The address of the binary loop.
+        //!
+        const uint8_t* data() const { return _data; }
+
+        //!
+        //! Get the size of the binary loop.
+        //! @return The size in bytes of the binary loop.
+        //!
+        size_t size() const { return _size; }
+
+        //!
+        //! Check if the loop is empty.
+        //! @return True if the loop is empty.
+        //!
+        bool empty() const { return begin() == end(); }
+
+        //!
+        //! Count the number of entries in the loop.
+        //! @return The number of valid entries in the loop.
+        //!
+        size_t count() const;
+
+        //!
+        //! Forward iterator over the entries of the loop.
+        //!
+        class const_iterator
+        {
+        public:
+            //! @cond nodoxygen
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = ENTRY;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const ENTRY*;
+            using reference = const ENTRY&;
+            //! @endcond
+
+            //!
+            //! Default constructor, build an end iterator.
+            //!
+            const_iterator() = default;
+
+            //!
+            //! Access the current entry.
+            //! @return A constant reference to the current entry.
+            //!
+            const ENTRY& operator*() const { return _entry; }
+
+            //!
+            //! Access the current entry.
+            //! @return A constant pointer to the current entry.
+            //!
+            const ENTRY* operator->() const { return &_entry; }
+
+            //!
+            //! Move to the next entry.
+            //! @return A reference to this object.
+            //!
+            const_iterator& operator++() { _data += _entry_size; parse(); return *this; }
+
+            //!
+            //! Move to the next entry.
+            //! @return A copy of this iterator before moving.
+            //!
+            const_iterator operator++(int) { const_iterator it(*this); ++*this; return it; }
+
+            //!
+            //! Equality operator.
+            //! @param [in] other Another iterator to compare.
+            //! @return True if both iterators point to the same entry.
+            //!
+            bool operator==(const const_iterator& other) const { return _data == other._data; }
+
+        private:
+            friend class LoopView<ENTRY>;
+            const uint8_t* _data = nullptr;  // Current entry, nullptr at end of loop.
+            const uint8_t* _end = nullptr;   // End of loop.
+            size_t         _entry_size = 0;  // Size of current entry.
+            ENTRY          _entry {};        // Current entry.
+
+            // Constructor from the loop.
+            const_iterator(const uint8_t* data, size_t size) : _data(data), _end(data + size) { parse(); }
+
+            // Parse the current entry, move to end when there is no more valid entry.
+            void parse()
+            {
+                _entry_size = _data == nullptr || _data >= _end ? 0 : _entry.parse(_data, _end - _data);
+                if (_entry_size == 0) {
+                    _data = _end = nullptr;
+                }
+            }
+        };
+
+        //!
+        //! Alias for iterator, the binary data are read-only.
+        //!
+        using iterator = const_iterator;
+
+        //!
+        //! Get an iterator to the first entry.
+        //! @return An iterator to the first entry.
+        //!
+        const_iterator begin() const { return const_iterator(_data, _size); }
+
+        //!
+        //! Get an iterator after the last entry.
+        //! @return An iterator after the last entry.
+        //!
+        const_iterator end() const { return const_iterator(); }
+
+    private:
+        const uint8_t* _data = nullptr;
+        size_t         _size = 0;
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Template definitions.
+//----------------------------------------------------------------------------
+
+#if !defined(DOXYGEN)
+
+template <class ENTRY>
+size_t ts::LoopView<ENTRY>::count() const
+{
+    size_t n = 0;
+    for (auto it = begin(); it != end(); ++it) {
+        n++;
+    }
+    return n;
+}
+
+#endif
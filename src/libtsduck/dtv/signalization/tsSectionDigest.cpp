@@ -0,0 +1,137 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsSectionDigest.h"
+#include "tsSection.h"
+#include "tsMemory.h"
+
+
+//----------------------------------------------------------------------------
+// Compute the digest of a binary content (MurmurHash3, x64, 128 bits).
+//----------------------------------------------------------------------------
+
+namespace {
+    constexpr uint64_t C1 = 0x87C37B91114253D5;
+    constexpr uint64_t C2 = 0x4CF5AD432745937F;
+
+    inline uint64_t Mix1(uint64_t k) { return std::rotl(k * C1, 31) * C2; }
+    inline uint64_t Mix2(uint64_t k) { return std::rotl(k * C2, 33) * C1; }
+
+    inline uint64_t FinalMix(uint64_t k)
+    {
+        k ^= k >> 33;
+        k *= 0xFF51AFD7ED558CCD;
+        k ^= k >> 33;
+        k *= 0xC4CEB9FE1A85EC53;
+        k ^= k >> 33;
+        return k;
+    }
+}
+
+ts::SectionDigest::SectionDigest(const void* data, size_t size)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    uint64_t h1 = 0;
+    uint64_t h2 = 0;
+
+    // Process 16-byte blocks.
+    const size_t nblocks = size / 16;
+    for (size_t i = 0; i < nblocks; ++i, bytes += 16) {
+        h1 ^= Mix1(GetUInt64LE(bytes));
+        h1 = (std::rotl(h1, 27) + h2) * 5 + 0x52DCE729;
+        h2 ^= Mix2(GetUInt64LE(bytes + 8));
+        h2 = (std::rotl(h2, 31) + h1) * 5 + 0x38495AB5;
+    }
+
+    // Process the remaining bytes.
+    const size_t rem = size % 16;
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+    for (size_t i = 0; i < rem; ++i) {
+        if (i < 8) {
+            k1 |= uint64_t(bytes[i]) << (8 * i);
+        }
+        else {
+            k2 |= uint64_t(bytes[i]) << (8 * (i - 8));
+        }
+    }
+    if (rem > 8) {
+        h2 ^= Mix2(k2);
+    }
+    if (rem > 0) {
+        h1 ^= Mix1(k1);
+    }
+
+    // Finalization.
+    h1 ^= uint64_t(size);
+    h2 ^= uint64_t(size);
+    h1 += h2;
+    h2 += h1;
+    h1 = FinalMix(h1);
+    h2 = FinalMix(h2);
+    h1 += h2;
+    h2 += h1;
+
+    high = h1;
+    low = h2;
+}
+
+ts::SectionDigest::SectionDigest(const Section& section)
+{
+    if (section.isValid()) {
+        *this = SectionDigest(section.content(), section.size());
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Set of section digests with LRU bound.
+//----------------------------------------------------------------------------
+
+void ts::SectionDigestSet::setMaxSize(size_t max_size)
+{
+    _max_size = max_size;
+    while (_max_size > 0 && _index.size() > _max_size) {
+        _index.erase(_lru.back());
+        _lru.pop_back();
+    }
+}
+
+bool ts::SectionDigestSet::findOrInsert(const SectionDigest& digest)
+{
+    const auto it = _index.find(digest);
+    if (it != _index.end()) {
+        // Already present, becomes the most recently used.
+        _lru.splice(_lru.begin(), _lru, it->second);
+        return true;
+    }
+    else {
+        // Remove the least recently used digest if the set is full.
+        if (_max_size > 0 && _index.size() >= _max_size) {
+            _index.erase(_lru.back());
+            _lru.pop_back();
+        }
+        _lru.push_front(digest);
+        _index.emplace(digest, _lru.begin());
+        return false;
+    }
+}
+
+void ts::SectionDigestSet::clear()
+{
+    _index.clear();
+    _lru.clear();
+}
+
+size_t ts::SectionDigestSet::memorySize() const
+{
+    // Estimated size: one list node and one hash node per digest, plus the bucket array.
+    constexpr size_t list_node = sizeof(SectionDigest) + 2 * sizeof(void*);
+    constexpr size_t hash_node = sizeof(SectionDigest) + sizeof(LRUList::iterator) + 2 * sizeof(void*);
+    return sizeof(*this) + _index.size() * (list_node + hash_node) + _index.bucket_count() * sizeof(void*);
+}
@@ -0,0 +1,134 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Compact digest of a section content, for duplicate detection.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTablesPtr.h"
+
+namespace ts {
+    //!
+    //! Compact 128-bit digest of a section content, for duplicate detection.
+    //! @ingroup mpeg
+    //!
+    //! The digest is computed using a fast non-cryptographic hash function (MurmurHash3, x64, 128 bits).
+    //! It is suitable to detect duplicate sections in a stream, not to authenticate a content.
+    //! Compared to Section::hash(), which returns a SHA-1 in a ByteBlock, the digest is much faster
+    //! to compute and does not need any heap allocation.
+    //!
+    class TSDUCKDLL SectionDigest
+    {
+    public:
+        uint64_t high = 0;  //!< High-order 64 bits of the digest.
+        uint64_t low = 0;   //!< Low-order 64 bits of the digest.
+
+        //!
+        //! Default constructor, a null digest.
+        //!
+        SectionDigest() = default;
+
+        //!
+        //! Constructor from a binary content.
+        //! @param [in] data Address of the content.
+        //! @param [in] size Size in bytes of the content.
+        //!
+        SectionDigest(const void* data, size_t size);
+
+        //!
+        //! Constructor from a section.
+        //! @param [in] section A section. If the section is invalid, the digest is null,
+        //! the same way Section::hash() returns an empty hash on invalid sections.
+        //!
+        explicit SectionDigest(const Section& section);
+
+        //!
+        //! Check if the digest is null, typically built from an invalid section.
+        //! @return True if the digest is null.
+        //!
+        bool isNull() const { return high == 0 && low == 0; }
+
+        //!
+        //! Equality operator.
+        //! @param [in] other Another digest to compare.
+        //! @return True if the two digests are identical.
+        //!
+        bool operator==(const SectionDigest& other) const = default;
+
+        //!
+        //! Hash function object for SectionDigest, to be used in unordered containers.
+        //!
+        struct Hash
+        {
+            //!
+            //! Hash function.
+            //! @param [in] digest A section digest.
+            //! @return The hash value of the digest.
+            //!
+            size_t operator()(const SectionDigest& digest) const { return size_t(digest.low); }
+        };
+    };
+
+    //!
+    //! A set of section digests with an optional LRU bound.
+    //! @ingroup mpeg
+    //!
+    //! When a maximum size is set and the set is full, inserting a new digest removes
+    //! the least recently used one (the digest which was inserted or found the longest
+    //! time ago).
+    //!
+    class TSDUCKDLL SectionDigestSet
+    {
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] max_size Maximum number of digests in the set. Zero means unlimited.
+        //!
+        SectionDigestSet(size_t max_size = 0) : _max_size(max_size) {}
+
+        //!
+        //! Set the maximum number of digests in the set.
+        //! When the set is larger, the least recently used digests are removed.
+        //! @param [in] max_size Maximum number of digests in the set. Zero means unlimited.
+        //!
+        void setMaxSize(size_t max_size);
+
+        //!
+        //! Check if a digest is present in the set and insert it if not.
+        //! In both cases, the digest becomes the most recently used one.
+        //! @param [in] digest A section digest.
+        //! @return True if the digest was already present, false if it was inserted.
+        //!
+        bool findOrInsert(const SectionDigest& digest);
+
+        //!
+        //! Get the number of digests in the set.
+        //! @return The number of digests in the set.
+        //!
+        size_t size() const { return _index.size(); }
+
+        //!
+        //! Clear the content of the set.
+        //!
+        void clear();
+
+        //!
+        //! Get an estimation of the memory which is used by the set.
+        //! @return An estimated size in bytes of the memory which is used by the set.
+        //!
+        size_t memorySize() const;
+
+    private:
+        using LRUList = std::list<SectionDigest>;
+        size_t  _max_size = 0;
+        LRUList _lru {};  // Most recently used first.
+        std::unordered_map<SectionDigest, LRUList::iterator, SectionDigest::Hash> _index {};
+    };
+}
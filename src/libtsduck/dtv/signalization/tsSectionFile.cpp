@@ -12,6 +12,7 @@
 #include "tsPSIRepository.h"
 #include "tsDuckContext.h"
 #include "tsxmlElement.h"
+#include "tsxmlStreamingDocument.h"
 #include "tsxmlJSONConverter.h"
 #include "tsjsonNull.h"
 #include "tsEIT.h"
@@ -533,16 +534,16 @@ bool ts::SectionFile::LoadModel(xml::Document& doc, bool load_extensions)
 
 bool ts::SectionFile::loadXML(const UString& file_name)
 {
-    xml::Document doc(_report);
+    xml::StreamingDocument doc(_report);
     doc.setTweaks(_xmlTweaks);
-    return doc.load(file_name, false) && parseDocument(doc);
+    return doc.open(file_name, false) && parseStreamingDocument(doc);
 }
 
 bool ts::SectionFile::loadXML(std::istream& strm)
 {
-    xml::Document doc(_report);
+    xml::StreamingDocument doc(_report);
     doc.setTweaks(_xmlTweaks);
-    return doc.load(strm) && parseDocument(doc);
+    return doc.open(strm) && parseStreamingDocument(doc);
 }
 
 bool ts::SectionFile::parseXML(const UString& xml_content)
@@ -583,6 +584,19 @@ bool ts::SectionFile::parseDocument(const xml::Document& doc)
     return success;
 }
 
+bool ts::SectionFile::parseStreamingDocument(xml::StreamingDocument& doc)
+{
+    // The document is read one table at a time. At any time, the document contains
+    // at most one table under its root. Each table is validated, serialized, and then
+    // its XML representation is freed when the next table is read. As with a complete
+    // document, the valid tables are added and the invalid ones are reported.
+    bool success = parseDocument(doc);
+    while (doc.next()) {
+        success = parseDocument(doc) && success;
+    }
+    return success && doc.eof();
+}
+
 
 //----------------------------------------------------------------------------
 // Create XML file or text.
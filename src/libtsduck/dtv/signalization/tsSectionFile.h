@@ -148,6 +148,9 @@ namespace ts {
         //!
         //! Load an XML file.
         //! The loaded tables are added to the content of this object.
+        //! The XML file is read and validated one table at a time. Only the binary
+        //! sections are kept in memory, not the XML representation of the tables.
+        //! On error, the valid tables are added and false is returned, as with parseXML().
         //! @param [in] file_name XML file name.
         //! If the file name starts with "<?xml", this is considered as "inline XML content".
         //! If the file name is empty or "-", the standard input is used.
@@ -158,6 +161,8 @@ namespace ts {
         //!
         //! Load an XML file from an open text stream.
         //! The loaded sections are added to the content of this object.
+        //! The XML content is read and validated one table at a time.
+        //! On error, the valid tables are added and false is returned, as with parseXML().
         //! @param [in,out] strm A standard text stream in input mode.
         //! @return True on success, false on error.
         //!
@@ -454,6 +459,9 @@ namespace ts {
         // Parse an XML document.
         bool parseDocument(const xml::Document& doc);
 
+        // Parse a streaming XML document, one table at a time.
+        bool parseStreamingDocument(xml::StreamingDocument& doc);
+
         // Generate an XML document.
         bool generateDocument(xml::Document& doc) const;
 
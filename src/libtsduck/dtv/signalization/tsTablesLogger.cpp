@@ -11,12 +11,101 @@
 #include "tsTablesDisplay.h"
 #include "tsBinaryTable.h"
 #include "tsSectionFile.h"
+#include "tsxmlElement.h"
 #include "tsArgs.h"
 #include "tsDuckContext.h"
 #include "tsSimulCryptDate.h"
 #include "tsjsonArray.h"
 #include "tsjsonObject.h"
 #include "tsMJD.h"
+#include "tsThread.h"
+#include "tsMessageQueue.h"
+
+
+//----------------------------------------------------------------------------
+// Internal data structures for the parallel demux of sections.
+//----------------------------------------------------------------------------
+
+// Number of packets per batch and max number of batches in progress.
+namespace {
+    constexpr size_t DEMUX_BATCH_PACKETS = 1000;
+    constexpr size_t DEMUX_MAX_BATCHES = 16;
+}
+
+// A batch of packets, sent to all demux threads.
+struct ts::TablesLogger::PacketBatch
+{
+    PacketCounter  first = 0;   // Index of first packet in the stream.
+    TSPacketVector packets {};  // Packets in the batch.
+};
+
+namespace {
+    // One event from a demux thread, to be replayed in the main thread.
+    struct DemuxEvent
+    {
+        enum Type {STANDARDS, LOG, TABLE, SECTION, INVALID};
+        Type                             type = STANDARDS;
+        ts::PacketCounter                index = 0;                        // Packet index of the event.
+        ts::Standards                    standards = ts::Standards::NONE;  // With STANDARDS, new standards only.
+        int                              severity = ts::Severity::Info;    // With LOG.
+        ts::UString                      message {};                       // With LOG.
+        ts::BinaryTablePtr               table {};                         // With TABLE.
+        ts::SectionPtr                   section {};                       // With SECTION.
+        std::shared_ptr<ts::DemuxedData> data {};                          // With INVALID.
+    };
+    using DemuxEventList = std::vector<DemuxEvent>;
+}
+
+// A demux thread. The report of the demux is used to collect the log messages of the demux.
+class ts::TablesLogger::DemuxThread :
+    public Thread,
+    private Report,
+    private TableHandlerInterface,
+    private SectionHandlerInterface,
+    private InvalidSectionHandlerInterface
+{
+    TS_NOBUILD_NOCOPY(DemuxThread);
+public:
+    // Constructor and destructor.
+    DemuxThread(const TablesLogger& logger, const PIDSet& pids);
+    virtual ~DemuxThread() override;
+
+    // Input batches of packets and output lists of events, one per batch. A null batch terminates the thread.
+    MessageQueue<PacketBatch>    input {};
+    MessageQueue<DemuxEventList> output {};
+
+    // Get the demux status.
+    void getStatus(SectionDemux::Status& status) const { _demux.getStatus(status); }
+
+private:
+    // A section demux with settable packet index.
+    class Demux : public SectionDemux
+    {
+        TS_NOBUILD_NOCOPY(Demux);
+    public:
+        Demux(DuckContext& duck) : SectionDemux(duck) {}
+        void setPacketIndex(PacketCounter index) { _packet_count = index; }
+    };
+
+    DuckContext     _duck {this};
+    Demux           _demux {_duck};
+    PacketCounter   _index = 0;                   // Current packet index.
+    Standards       _standards = Standards::NONE; // Last reported standards.
+    DemuxEventList* _events = nullptr;            // Events of the current batch.
+
+    // Add an event for the current packet.
+    DemuxEvent& newEvent(DemuxEvent::Type type);
+
+    // Report new standards from the demux.
+    void checkStandards();
+
+    // Implementation of interfaces.
+    virtual void main() override;
+    virtual void writeLog(int severity, const UString& message) override;
+    virtual void handleTable(SectionDemux&, const BinaryTable&) override;
+    virtual void handleSection(SectionDemux&, const Section&) override;
+    virtual void handleInvalidSection(SectionDemux&, const DemuxedData&) override;
+};
 
 
 //----------------------------------------------------------------------------
@@ -153,6 +242,12 @@ void ts::TablesLogger::defineArgs(Args& args)
     args.option(u"meta-sections");
     args.help(u"meta-sections", u"Add hexadecimal dump of each section in XML and JSON metadata.");
 
+    args.option(u"max-deep-duplicate", 0, Args::POSITIVE);
+    args.help(u"max-deep-duplicate",
+              u"With --no-deep-duplicate, specify the maximum number of section digests which are kept for each PID. "
+              u"When the limit is reached, the least recently seen sections are forgotten and may be reported again. "
+              u"By default, all section digests are kept since the beginning.");
+
     args.option(u"multiple-files", 'm');
     args.help(u"multiple-files",
               u"Create multiple binary output files, one per section. "
@@ -165,9 +260,9 @@ void ts::TablesLogger::defineArgs(Args& args)
     args.option(u"no-deep-duplicate");
     args.help(u"no-deep-duplicate",
               u"Do not report identical sections in the same PID, even when non-consecutive. "
-              u"A hash of each section is kept for each PID and later identical sections are not reported.\n"
-              u"Warning: This option accumulates memory for hash values of all sections since the beginning. "
-              u"Do not use that option for commands running too long or the process may crash with insufficient memory.");
+              u"A digest of each section is kept for each PID and later identical sections are not reported.\n"
+              u"Warning: By default, this option accumulates memory for digests of all sections since the beginning. "
+              u"For commands running for a long time, use --max-deep-duplicate to bound the memory usage.");
 
     args.option(u"no-duplicate");
     args.help(u"no-duplicate",
@@ -324,6 +419,7 @@ bool ts::TablesLogger::loadArgs(DuckContext& duck, Args& args)
     args.getIntValue(_log_size, u"log-size", DEFAULT_LOG_SIZE);
     _no_duplicate = args.present(u"no-duplicate");
     _no_deep_duplicate = args.present(u"no-deep-duplicate");
+    args.getIntValue(_max_deep_duplicate, u"max-deep-duplicate", 0);
     _udp_raw = args.present(u"no-encapsulation");
     _use_current = !args.present(u"exclude-current");
     _use_next = args.present(u"include-next");
@@ -363,6 +459,9 @@ bool ts::TablesLogger::loadArgs(DuckContext& duck, Args& args)
 
 bool ts::TablesLogger::open()
 {
+    // Terminate previous demux threads, if any.
+    stopDemuxThreads();
+
     // Reinitialize working data.
     _abort = _exit = false;
     _table_count = 0;
@@ -373,7 +472,7 @@ bool ts::TablesLogger::open()
     _json_doc.close();
     _short_sections.clear();
     _last_sections.clear();
-    _deep_hashes.clear();
+    _deep_digests.clear();
     _sections_once.clear();
     _x2j_conv.clear();
 
@@ -467,6 +566,8 @@ bool ts::TablesLogger::open()
         }
     }
 
+    // Start the demux threads, if required.
+    startDemuxThreads();
     return true;
 }
 
@@ -477,6 +578,9 @@ bool ts::TablesLogger::open()
 
 void ts::TablesLogger::close()
 {
+    // Process all packets which are still pending in the demux threads.
+    stopDemuxThreads();
+
     if (!_exit) {
 
         // Pack sections in incomplete tables if required.
@@ -497,6 +601,11 @@ void ts::TablesLogger::close()
             _sock.close(_report);
         }
 
+        // Report the memory usage of duplicate section tracking.
+        if (_no_duplicate || _no_deep_duplicate || _all_once) {
+            _report.debug(u"memory usage for duplicate sections tracking: %'d bytes", duplicateTrackingMemory());
+        }
+
         // Now completed.
         _exit = true;
     }
@@ -509,10 +618,235 @@ void ts::TablesLogger::close()
 
 void ts::TablesLogger::feedPacket(const TSPacket& pkt)
 {
-    if (!completed()) {
-        _demux.feedPacket(pkt);
-        _cas_mapper.feedPacket(pkt);
-        _packet_count++;
+    if (completed()) {
+        return;
+    }
+    else if (_demux_workers.empty()) {
+        processPacket(pkt);
+    }
+    else {
+        // Accumulate packets in a batch for the demux threads.
+        if (_next_batch == nullptr) {
+            _next_batch = std::make_shared<PacketBatch>();
+            _next_batch->first = _dispatch_count;
+            _next_batch->packets.reserve(DEMUX_BATCH_PACKETS);
+        }
+        _next_batch->packets.push_back(pkt);
+        _dispatch_count++;
+        if (_next_batch->packets.size() >= DEMUX_BATCH_PACKETS) {
+            dispatchBatch();
+        }
+    }
+}
+
+// Process one packet in the main thread.
+void ts::TablesLogger::processPacket(const TSPacket& pkt)
+{
+    _demux.feedPacket(pkt);
+    _cas_mapper.feedPacket(pkt);
+    _packet_count++;
+}
+
+
+//----------------------------------------------------------------------------
+// Parallel demux of sections.
+//----------------------------------------------------------------------------
+
+// Configure the demux as the demux of the logger. Only TS errors are reported by the demux.
+ts::TablesLogger::DemuxThread::DemuxThread(const TablesLogger& logger, const PIDSet& pids) :
+    Report(std::min<int>(logger._report.maxSeverity(), Severity::Verbose))
+{
+    _demux.setPIDFilter(pids);
+    _demux.setTableHandler(logger._all_sections ? nullptr : this);
+    _demux.setSectionHandler(logger._all_sections ? this : nullptr);
+    _demux.setInvalidSectionHandler(logger._invalid_sections ? this : nullptr);
+    _demux.setCurrentNext(logger._use_current, logger._use_next);
+    _demux.trackInvalidSectionVersions(logger._invalid_versions);
+    _demux.setTransportErrorLogLevel(Severity::Verbose);
+}
+
+ts::TablesLogger::DemuxThread::~DemuxThread()
+{
+    waitForTermination();
+}
+
+// Thread main code.
+void ts::TablesLogger::DemuxThread::main()
+{
+    for (;;) {
+        MessageQueue<PacketBatch>::MessagePtr batch;
+        input.dequeue(batch);
+        if (batch == nullptr) {
+            break;
+        }
+        auto events = std::make_shared<DemuxEventList>();
+        _events = events.get();
+        for (size_t i = 0; i < batch->packets.size(); ++i) {
+            _index = batch->first + i;
+            _demux.setPacketIndex(_index);
+            _demux.feedPacket(batch->packets[i]);
+            checkStandards();
+        }
+        _events = nullptr;
+        output.enqueue(events);
+    }
+}
+
+// Add an event for the current packet.
+DemuxEvent& ts::TablesLogger::DemuxThread::newEvent(DemuxEvent::Type type)
+{
+    DemuxEvent& ev(_events->emplace_back());
+    ev.type = type;
+    ev.index = _index;
+    return ev;
+}
+
+// Report new standards, as added by the demux in its context.
+void ts::TablesLogger::DemuxThread::checkStandards()
+{
+    if (_duck.standards() != _standards) {
+        newEvent(DemuxEvent::STANDARDS).standards = _duck.standards() & ~_standards;
+        _standards = _duck.standards();
+    }
+}
+
+// Collect log messages from the demux.
+void ts::TablesLogger::DemuxThread::writeLog(int severity, const UString& message)
+{
+    if (_events != nullptr) {
+        DemuxEvent& ev(newEvent(DemuxEvent::LOG));
+        ev.severity = severity;
+        ev.message = message;
+    }
+}
+
+// Collect tables and sections from the demux. The demuxed sections can be safely shared.
+void ts::TablesLogger::DemuxThread::handleTable(SectionDemux&, const BinaryTable& table)
+{
+    checkStandards();
+    newEvent(DemuxEvent::TABLE).table = std::make_shared<BinaryTable>(table, ShareMode::SHARE);
+}
+
+void ts::TablesLogger::DemuxThread::handleSection(SectionDemux&, const Section& section)
+{
+    checkStandards();
+    newEvent(DemuxEvent::SECTION).section = std::make_shared<Section>(section, ShareMode::SHARE);
+}
+
+void ts::TablesLogger::DemuxThread::handleInvalidSection(SectionDemux&, const DemuxedData& data)
+{
+    checkStandards();
+    newEvent(DemuxEvent::INVALID).data = std::make_shared<DemuxedData>(data, ShareMode::SHARE);
+}
+
+// Start the demux threads, when the PID's to filter can be distributed.
+void ts::TablesLogger::startDemuxThreads()
+{
+    _worker_pids.reset();
+    _dispatch_count = 0;
+    _workers_status.reset();
+
+    if (_demux_threads > 1 && !_pack_and_flush && !_fill_eit && _initial_pids.any()) {
+        // Distribute the initial PID's in a round-robin way.
+        std::vector<PIDSet> pids(std::min(_demux_threads, _initial_pids.count()));
+        size_t count = 0;
+        for (PID pid = 0; pid < PID_MAX; ++pid) {
+            if (_initial_pids.test(pid)) {
+                pids[count++ % pids.size()].set(pid);
+            }
+        }
+        _demux_workers.resize(pids.size());
+        for (size_t i = 0; i < pids.size(); ++i) {
+            _demux_workers[i] = std::make_unique<DemuxThread>(*this, pids[i]);
+            _demux_workers[i]->start();
+        }
+
+        // The PID's which are added later by section filters are demuxed in the main thread.
+        _worker_pids = _initial_pids;
+        _demux.setPIDFilter(NoPID());
+        _report.debug(u"demuxing %d PID's in %d threads", _worker_pids.count(), _demux_workers.size());
+    }
+}
+
+// Process all pending packets and terminate the demux threads.
+void ts::TablesLogger::stopDemuxThreads()
+{
+    if (!_demux_workers.empty()) {
+        dispatchBatch();
+        while (!_pending_batches.empty()) {
+            replayBatch();
+        }
+        for (const auto& it : _demux_workers) {
+            it->input.forceEnqueue(static_cast<PacketBatch*>(nullptr));
+            it->waitForTermination();
+            SectionDemux::Status status;
+            it->getStatus(status);
+            _workers_status += status;
+        }
+        _demux_workers.clear();
+    }
+}
+
+// Send the current batch of packets to all demux threads.
+void ts::TablesLogger::dispatchBatch()
+{
+    if (_next_batch != nullptr) {
+        for (const auto& it : _demux_workers) {
+            auto batch(_next_batch);
+            it->input.enqueue(batch);
+        }
+        _pending_batches.push_back(_next_batch);
+        _next_batch.reset();
+
+        // Limit the number of batches in progress.
+        while (_pending_batches.size() > DEMUX_MAX_BATCHES) {
+            replayBatch();
+        }
+    }
+}
+
+// Replay the oldest batch of packets, with the demux events from all demux threads.
+void ts::TablesLogger::replayBatch()
+{
+    const auto batch(_pending_batches.front());
+    _pending_batches.pop_front();
+
+    // Lists of events from all demux threads, with index of next event to replay.
+    std::vector<std::pair<MessageQueue<DemuxEventList>::MessagePtr, size_t>> events(_demux_workers.size());
+    for (size_t w = 0; w < _demux_workers.size(); ++w) {
+        _demux_workers[w]->output.dequeue(events[w].first);
+    }
+
+    // Interleave the demux events with the processing of the packets in the main thread,
+    // exactly as they would have been produced by one single demux.
+    for (size_t i = 0; !completed() && i < batch->packets.size(); ++i) {
+        const PacketCounter index = batch->first + i;
+        for (auto& it : events) {
+            const DemuxEventList& list(*it.first);
+            for (size_t& next(it.second); next < list.size() && list[next].index == index; ++next) {
+                const DemuxEvent& ev(list[next]);
+                switch (ev.type) {
+                    case DemuxEvent::STANDARDS:
+                        _duck.addStandards(ev.standards);
+                        break;
+                    case DemuxEvent::LOG:
+                        _report.log(ev.severity, ev.message);
+                        break;
+                    case DemuxEvent::TABLE:
+                        handleTable(_demux, *ev.table);
+                        break;
+                    case DemuxEvent::SECTION:
+                        handleSection(_demux, *ev.section);
+                        break;
+                    case DemuxEvent::INVALID:
+                        handleInvalidSection(_demux, *ev.data);
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+        processPacket(batch->packets[i]);
     }
 }
 
@@ -521,18 +855,18 @@ void ts::TablesLogger::feedPacket(const TSPacket& pkt)
 // Detect and track duplicate section by PID.
 //----------------------------------------------------------------------------
 
-bool ts::TablesLogger::isDuplicate(PID pid, const Section& section, std::map<PID,ByteBlock> TablesLogger::* tracker)
+bool ts::TablesLogger::isDuplicate(PID pid, const Section& section, std::unordered_map<PID,SectionDigest> TablesLogger::* tracker)
 {
-    // Get a SHA-1 for the section.
-    const ByteBlock hash(section.hash());
-    ByteBlock& last((this->*tracker)[pid]);
-    if (last.empty() || last != hash) {
-        // Not the same section, keep the hash for next time.
-        last = hash;
+    // Get a digest for the section.
+    const SectionDigest digest(section);
+    SectionDigest& last((this->*tracker)[pid]);
+    if (last.isNull() || last != digest) {
+        // Not the same section, keep the digest for next time.
+        last = digest;
         return false;
     }
     else {
-        // Same section (same hash) as previously.
+        // Same section (same digest) as previously.
         return true;
     }
 }
@@ -544,18 +878,32 @@ bool ts::TablesLogger::isDuplicate(PID pid, const Section& section, std::map<PID
 
 bool ts::TablesLogger::isDeepDuplicate(PID pid, const Section& section)
 {
-    // Get a SHA-1 for the section.
-    const ByteBlock hash(section.hash());
-    auto& set(_deep_hashes[pid]);
-    if (set.find(hash) == set.end()) {
-        // Section not yet found on that PID, keep the hash for next time.
-        set.insert(hash);
-        return false;
-    }
-    else {
-        // Section already found.
-        return true;
+    // Get the set of section digests for this PID, create it when necessary.
+    auto it = _deep_digests.find(pid);
+    if (it == _deep_digests.end()) {
+        it = _deep_digests.emplace(pid, SectionDigestSet(_max_deep_duplicate)).first;
     }
+
+    // Return true if the section was already found on that PID. Otherwise, keep the digest for next time.
+    return it->second.findOrInsert(SectionDigest(section));
+}
+
+
+//----------------------------------------------------------------------------
+// Get an estimation of the memory which is used to track duplicate sections.
+//----------------------------------------------------------------------------
+
+size_t ts::TablesLogger::duplicateTrackingMemory() const
+{
+    // Estimated size of nodes in hash tables: value, next pointer and cached hash.
+    constexpr size_t node_overhead = 2 * sizeof(void*);
+    size_t size = (_short_sections.size() + _last_sections.size()) * (sizeof(PID) + sizeof(SectionDigest) + node_overhead) +
+                  (_short_sections.bucket_count() + _last_sections.bucket_count() + _sections_once.bucket_count()) * sizeof(void*) +
+                  _sections_once.size() * (sizeof(uint64_t) + node_overhead);
+    for (const auto& it : _deep_digests) {
+        size += it.second.memorySize();
+    }
+    return size;
 }
 
 
@@ -869,12 +1217,10 @@ bool ts::TablesLogger::buildXML(xml::Document& doc, const BinaryTable& table)
 
 ts::UString ts::TablesLogger::buildJSON(const xml::Document& doc)
 {
-    // Convert the XML document into JSON.
-    // Force "tsduck" root to appear so that the path to the first table is always the same.
-    const json::ValuePtr root(_x2j_conv.convertToJSON(doc, true));
-
-    // Query the first (and only) converted table and serialize it as one line.
-    return root->query(u"#nodes[0]").oneLiner(_report);
+    // Serialize the first (and only) table in the "tsduck" root as one line.
+    // The JSON text is directly generated from the XML document, without intermediate JSON object.
+    const xml::Element* root = doc.rootElement();
+    return _x2j_conv.oneLinerJSON(root == nullptr ? nullptr : root->firstChildElement());
 }
 
 
@@ -1189,7 +1535,7 @@ bool ts::TablesLogger::isFiltered(const Section& sect, CASID cas)
         if (!it->filterSection(_duck, sect, cas, pids)) {
             status = false;
         }
-        _demux.addPIDs(pids);
+        _demux.addPIDs(pids & ~_worker_pids);
     }
     return status;
 }
@@ -1244,8 +1590,9 @@ void ts::TablesLogger::postDisplay()
 
 void ts::TablesLogger::reportDemuxErrors(std::ostream& strm)
 {
-    if (_demux.hasErrors()) {
-        SectionDemux::Status status(_demux);
+    SectionDemux::Status status(_demux);
+    status += _workers_status;
+    if (status.hasErrors()) {
         strm << "* PSI/SI analysis errors:" << std::endl;
         status.display(strm, 4, true);
     }
@@ -1253,8 +1600,9 @@ void ts::TablesLogger::reportDemuxErrors(std::ostream& strm)
 
 void ts::TablesLogger::reportDemuxErrors(Report& report, int level)
 {
-    if (_demux.hasErrors()) {
-        SectionDemux::Status status(_demux);
+    SectionDemux::Status status(_demux);
+    status += _workers_status;
+    if (status.hasErrors()) {
         status.display(report, level, UString(), true);
     }
 }
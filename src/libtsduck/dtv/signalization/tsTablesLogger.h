@@ -17,6 +17,7 @@
 #include "tsTime.h"
 #include "tsTSPacket.h"
 #include "tsSectionDemux.h"
+#include "tsSectionDigest.h"
 #include "tsSectionFormat.h"
 #include "tsUDPSocket.h"
 #include "tsCASMapper.h"
@@ -88,6 +89,20 @@ namespace ts {
         //!
         void setSectionHandler(SectionHandlerInterface* h) { _section_handler = h; }
 
+        //!
+        //! Set the number of threads which demux the sections.
+        //! By default, all sections are demuxed in the thread which feeds the packets. With more
+        //! than one thread, the PID's to filter are distributed over worker threads which reassemble
+        //! the sections. The tables and sections are still filtered and logged in the thread which
+        //! feeds the packets, in the same order as with one thread. The output is identical but it
+        //! is delayed by a few batches of packets. This is useful to process large files offline.
+        //! The worker threads are not used with --pack-and-flush and --fill-eit because these options
+        //! need the global state of the demux at the end of the stream.
+        //! @param [in] count Number of demux threads. Must be set before open().
+        //! Zero or one means that the sections are demuxed by the thread which feeds the packets.
+        //!
+        void setDemuxThreads(size_t count) { _demux_threads = count; }
+
         //!
         //! The following method feeds the logger with a TS packet.
         //! @param [in] pkt A new transport stream packet.
@@ -132,6 +147,13 @@ namespace ts {
         //!
         void reportDemuxErrors(Report& report, int level = Severity::Info);
 
+        //!
+        //! Get an estimation of the memory which is used to track duplicate sections.
+        //! This memory is used with options --no-duplicate, --no-deep-duplicate and --all-once.
+        //! @return An estimated size in bytes of the memory which is used to track duplicate sections.
+        //!
+        size_t duplicateTrackingMemory() const;
+
         //!
         //! Static routine to analyze UDP messages as sent by the table logger (option --ip-udp).
         //! @param [in] protocol Instance of TLV protocol to analyze UDP message.
@@ -193,6 +215,7 @@ namespace ts {
         size_t                   _log_size = DEFAULT_LOG_SIZE;  // Size of table to log.
         bool                     _no_duplicate = false;      // Exclude consecutive duplicated short sections on a PID.
         bool                     _no_deep_duplicate = false; // Exclude duplicated sections on a PID, even non-consecutive.
+        size_t                   _max_deep_duplicate = 0;    // Max number of tracked sections per PID with --no-deep-duplicate (0 = unlimited).
         bool                     _pack_all_sections = false; // Pack all sections as if they were one table.
         bool                     _pack_and_flush = false;    // Pack and flush incomplete tables before exiting.
         bool                     _fill_eit = false;          // Add missing empty sections to incomplete EIT's before exiting.
@@ -219,13 +242,35 @@ namespace ts {
         json::RunningDocument    _json_doc {_report};        // JSON document, built on-the-fly.
         std::ofstream            _bin_file {};               // Binary output file.
         UDPSocket                _sock {false, IP::Any, _report}; // Output socket.
-        std::map<PID,ByteBlock>  _short_sections {};         // Tracking duplicate short sections by PID with a section hash.
-        std::map<PID,ByteBlock>  _last_sections {};          // Tracking duplicate sections by PID with a section hash (with --all-sections).
-        std::map<PID,std::set<ByteBlock>> _deep_hashes {};   // Tracking of deep duplicate sections.
-        std::set<uint64_t>       _sections_once {};          // Tracking sets of PID/TID/TDIext/secnum/version with --all-once.
+        std::unordered_map<PID,SectionDigest> _short_sections {}; // Tracking duplicate short sections by PID with a section digest.
+        std::unordered_map<PID,SectionDigest> _last_sections {};  // Tracking duplicate sections by PID with a section digest (with --all-sections).
+        std::map<PID,SectionDigestSet> _deep_digests {};     // Tracking of deep duplicate sections.
+        std::unordered_set<uint64_t> _sections_once {};      // Tracking sets of PID/TID/TDIext/secnum/version with --all-once.
         TablesLoggerFilterVector _section_filters {};        // All registered section filters.
         duck::Protocol           _duck_protocol {};          // To generate UDP messages.
 
+        // Parallel demux of sections, see setDemuxThreads().
+        // The packets are sent by batches to all demux threads. Each demux thread returns the list of
+        // demux events for each batch. The events are replayed in packet order by the main thread.
+        class DemuxThread;
+        struct PacketBatch;
+        size_t                   _demux_threads = 0;         // Requested number of demux threads.
+        PIDSet                   _worker_pids {};            // PID's which are demuxed in demux threads.
+        PacketCounter            _dispatch_count = 0;        // Number of packets which were sent to demux threads.
+        SectionDemux::Status     _workers_status {};         // Demux errors from terminated demux threads.
+        std::vector<std::unique_ptr<DemuxThread>> _demux_workers {};      // Active demux threads.
+        std::shared_ptr<PacketBatch>              _next_batch {};         // Batch of packets being filled.
+        std::deque<std::shared_ptr<PacketBatch>>  _pending_batches {};    // Batches being demuxed in demux threads.
+
+        // Process one packet in the main thread.
+        void processPacket(const TSPacket& pkt);
+
+        // Manage demux threads.
+        void startDemuxThreads();
+        void stopDemuxThreads();
+        void dispatchBatch();
+        void replayBatch();
+
         // Create a binary file. On error, set _abort and return false.
         bool createBinaryFile(const fs::path& name);
 
@@ -258,7 +303,7 @@ namespace ts {
         void logInvalid(const DemuxedData&, const UString&);
 
         // Detect and track duplicate section by PID.
-        bool isDuplicate(PID pid, const Section& section, std::map<PID,ByteBlock> TablesLogger::* tracker);
+        bool isDuplicate(PID pid, const Section& section, std::unordered_map<PID,SectionDigest> TablesLogger::* tracker);
         bool isDeepDuplicate(PID pid, const Section& section);
     };
 
@@ -0,0 +1,49 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsEITView.h"
+#include "tsMJD.h"
+#include "tsBCD.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::EITView::EITView(const Section& section) :
+    AbstractTableView(section, EIT::IsEIT(section.tableId()) && section.isLongSection(), 6)
+{
+}
+
+size_t ts::EITView::Event::parse(const uint8_t* data, size_t size)
+{
+    _size = size < 12 ? 0 : 12 + (GetUInt16(data + 10) & 0x0FFF);
+    if (_size > size) {
+        _size = 0;
+    }
+    _data = _size == 0 ? nullptr : data;
+    return _size;
+}
+
+
+//----------------------------------------------------------------------------
+// Event start time and duration.
+//----------------------------------------------------------------------------
+
+ts::Time ts::EITView::Event::startTime() const
+{
+    // Same as PSIBuffer::getMJD(): invalid dates are accepted as Unix Epoch.
+    Time result;
+    DecodeMJD(_data + 2, MJD_FULL, result);
+    return result;
+}
+
+cn::seconds ts::EITView::Event::duration() const
+{
+    return cn::hours(DecodeBCD(_data[7])) + cn::minutes(DecodeBCD(_data[8])) + cn::seconds(DecodeBCD(_data[9]));
+}
@@ -0,0 +1,137 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view over a section of a DVB Event Information Table (EIT).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsAbstractTableView.h"
+#include "tsEIT.h"
+
+namespace ts {
+    //!
+    //! Read-only view over a section of a DVB Event Information Table (EIT), without copy or allocation.
+    //! @see ETSI EN 300 468, 5.2.4
+    //! @ingroup table
+    //!
+    class TSDUCKDLL EITView : public AbstractTableView
+    {
+    public:
+        //!
+        //! Read-only view over one event entry in an EIT section.
+        //!
+        class TSDUCKDLL Event
+        {
+        public:
+            //!
+            //! Get the event id.
+            //! @return The event id.
+            //!
+            uint16_t eventId() const { return GetUInt16(_data); }
+
+            //!
+            //! Get the event start time.
+            //! @return The event start time in UTC (or JST in Japan). Unix Epoch if invalid.
+            //!
+            Time startTime() const;
+
+            //!
+            //! Get the event duration.
+            //! @return The event duration in seconds.
+            //!
+            cn::seconds duration() const;
+
+            //!
+            //! Get the running status of the event.
+            //! @return The running status code.
+            //!
+            uint8_t runningStatus() const { return uint8_t(_data[10] >> 5); }
+
+            //!
+            //! Check if the event is controlled by a CA system.
+            //! @return The free_CA_mode.
+            //!
+            bool CAControlled() const { return (_data[10] & 0x10) != 0; }
+
+            //!
+            //! Get the list of descriptors of the event.
+            //! @return A view over the descriptors.
+            //!
+            DescriptorListView descs() const { return DescriptorListView(_data + 12, _size - 12); }
+
+            //!
+            //! Load the entry from a binary area.
+            //! @param [in] data Address of the binary entry.
+            //! @param [in] size Size in bytes of the binary area.
+            //! @return The size of the entry or zero if truncated.
+            //!
+            size_t parse(const uint8_t* data, size_t size);
+
+        private:
+            const uint8_t* _data = nullptr;
+            size_t         _size = 0;
+        };
+
+        //!
+        //! Constructor.
+        //! @param [in] section An EIT section. The view is invalid if this is not a valid EIT section.
+        //! The section must remain valid and unmodified while the view is in use.
+        //!
+        explicit EITView(const Section& section);
+
+        //!
+        //! Check if this is an "actual" EIT.
+        //! @return True for EIT Actual TS, false for EIT Other TS.
+        //!
+        bool isActual() const { return EIT::IsActual(tableId()); }
+
+        //!
+        //! Check if this is an EIT present/following.
+        //! @return True for EIT present/following, false for EIT schedule.
+        //!
+        bool isPresentFollowing() const { return EIT::IsPresentFollowing(tableId()); }
+
+        //!
+        //! Get the service id.
+        //! @return The service id.
+        //!
+        uint16_t serviceId() const { return tableIdExtension(); }
+
+        //!
+        //! Get the transport stream id.
+        //! @return The transport stream id.
+        //!
+        uint16_t tsId() const { return isValid() ? GetUInt16(_payload) : 0; }
+
+        //!
+        //! Get the original network id.
+        //! @return The original network id.
+        //!
+        uint16_t onId() const { return isValid() ? GetUInt16(_payload + 2) : 0; }
+
+        //!
+        //! Get the last section number in the segment.
+        //! @return The segment_last_section_number.
+        //!
+        uint8_t segmentLastSectionNumber() const { return isValid() ? _payload[4] : 0; }
+
+        //!
+        //! Get the last table id.
+        //! @return The last_table_id.
+        //!
+        TID lastTableId() const { return isValid() ? _payload[5] : TID(TID_NULL); }
+
+        //!
+        //! Get the loop of events in the section.
+        //! @return A view over the loop of events.
+        //!
+        LoopView<Event> events() const { return isValid() ? LoopView<Event>(_payload + 6, _payload_size - 6) : LoopView<Event>(); }
+    };
+}
@@ -0,0 +1,73 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsNITView.h"
+#include "tsNIT.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::NITView::NITView(const Section& section) :
+    AbstractTableView(section, (section.tableId() == TID_NIT_ACT || section.tableId() == TID_NIT_OTH) && section.isLongSection(), 4)
+{
+}
+
+size_t ts::NITView::Transport::parse(const uint8_t* data, size_t size)
+{
+    _size = size < 6 ? 0 : 6 + (GetUInt16(data + 4) & 0x0FFF);
+    if (_size > size) {
+        _size = 0;
+    }
+    _data = _size == 0 ? nullptr : data;
+    return _size;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the loop of transport streams in the section.
+//----------------------------------------------------------------------------
+
+ts::LoopView<ts::NITView::Transport> ts::NITView::transports() const
+{
+    // The transport loop is preceded by its 12-bit length, after the network descriptors.
+    const size_t start = skipLengthAt(0);
+    const size_t end = skipLengthAt(start);
+    return start + 2 > end ? LoopView<Transport>() : LoopView<Transport>(_payload + start + 2, end - start - 2);
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a binary NIT has the same content as a deserialized NIT.
+//----------------------------------------------------------------------------
+
+bool ts::NITView::SameContent(const BinaryTable& table, const NIT& nit)
+{
+    if (!nit.isValid() || table.tableId() != nit.tableId() || !AllValid<NITView>(table) || table.tableIdExtension() != nit.network_id) {
+        return false;
+    }
+
+    // The network-level descriptors may be split over several sections.
+    size_t desc_index = 0;
+    size_t count = 0;
+    for (size_t i = 0; i < table.sectionCount(); ++i) {
+        const NITView view(*table.sectionAt(i));
+        if (!view.descs().matchList(nit.descs, desc_index)) {
+            return false;
+        }
+        for (const auto& tp : view.transports()) {
+            const auto it = nit.transports.find(TransportStreamId(tp.tsId(), tp.onId()));
+            if (it == nit.transports.end() || !tp.descs().sameAs(it->second.descs)) {
+                return false;
+            }
+            count++;
+        }
+    }
+    return desc_index == nit.descs.size() && count == nit.transports.size();
+}
@@ -0,0 +1,106 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view over a section of a DVB Network Information Table (NIT).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsAbstractTableView.h"
+
+namespace ts {
+
+    class NIT;
+
+    //!
+    //! Read-only view over a section of a DVB Network Information Table (NIT), without copy or allocation.
+    //! @see ETSI EN 300 468, 5.2.1
+    //! @ingroup table
+    //!
+    class TSDUCKDLL NITView : public AbstractTableView
+    {
+    public:
+        //!
+        //! Read-only view over one transport stream entry in a NIT section.
+        //!
+        class TSDUCKDLL Transport
+        {
+        public:
+            //!
+            //! Get the transport stream id.
+            //! @return The transport stream id.
+            //!
+            uint16_t tsId() const { return GetUInt16(_data); }
+
+            //!
+            //! Get the original network id.
+            //! @return The original network id.
+            //!
+            uint16_t onId() const { return GetUInt16(_data + 2); }
+
+            //!
+            //! Get the list of descriptors of the transport stream.
+            //! @return A view over the transport descriptors.
+            //!
+            DescriptorListView descs() const { return DescriptorListView(_data + 6, _size - 6); }
+
+            //!
+            //! Load the entry from a binary area.
+            //! @param [in] data Address of the binary entry.
+            //! @param [in] size Size in bytes of the binary area.
+            //! @return The size of the entry or zero if truncated.
+            //!
+            size_t parse(const uint8_t* data, size_t size);
+
+        private:
+            const uint8_t* _data = nullptr;
+            size_t         _size = 0;
+        };
+
+        //!
+        //! Constructor.
+        //! @param [in] section A NIT section. The view is invalid if this is not a valid NIT section.
+        //! The section must remain valid and unmodified while the view is in use.
+        //!
+        explicit NITView(const Section& section);
+
+        //!
+        //! Check if this is an "actual" NIT.
+        //! @return True for NIT Actual network, false for NIT Other network.
+        //!
+        bool isActual() const { return tableId() == TID_NIT_ACT; }
+
+        //!
+        //! Get the network id.
+        //! @return The network id.
+        //!
+        uint16_t networkId() const { return tableIdExtension(); }
+
+        //!
+        //! Get the list of network-level descriptors.
+        //! @return A view over the network descriptors.
+        //!
+        DescriptorListView descs() const { return descriptorsAt(0); }
+
+        //!
+        //! Get the loop of transport streams in the section.
+        //! @return A view over the loop of transport streams.
+        //!
+        LoopView<Transport> transports() const;
+
+        //!
+        //! Check if a binary NIT has the same content as a deserialized NIT, ignoring the version.
+        //! This is a fast method to check if a new version of a NIT actually changes something.
+        //! @param [in] table A binary NIT.
+        //! @param [in] nit A deserialized NIT.
+        //! @return True if @a table and @a nit are valid and have the same content, except the version.
+        //!
+        static bool SameContent(const BinaryTable& table, const NIT& nit);
+    };
+}
@@ -0,0 +1,64 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsSDTView.h"
+#include "tsSDT.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::SDTView::SDTView(const Section& section) :
+    AbstractTableView(section, (section.tableId() == TID_SDT_ACT || section.tableId() == TID_SDT_OTH) && section.isLongSection(), 3)
+{
+}
+
+size_t ts::SDTView::Service::parse(const uint8_t* data, size_t size)
+{
+    _size = size < 5 ? 0 : 5 + (GetUInt16(data + 3) & 0x0FFF);
+    if (_size > size) {
+        _size = 0;
+    }
+    _data = _size == 0 ? nullptr : data;
+    return _size;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a binary SDT has the same content as a deserialized SDT.
+//----------------------------------------------------------------------------
+
+bool ts::SDTView::SameContent(const BinaryTable& table, const SDT& sdt)
+{
+    if (!sdt.isValid() || table.tableId() != sdt.tableId() || !AllValid<SDTView>(table) || table.tableIdExtension() != sdt.ts_id) {
+        return false;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < table.sectionCount(); ++i) {
+        const SDTView view(*table.sectionAt(i));
+        if (view.onId() != sdt.onetw_id) {
+            return false;
+        }
+        for (const auto& srv : view.services()) {
+            const auto it = sdt.services.find(srv.serviceId());
+            if (it == sdt.services.end() ||
+                it->second.EITs_present != srv.EITsPresent() ||
+                it->second.EITpf_present != srv.EITpfPresent() ||
+                it->second.running_status != srv.runningStatus() ||
+                it->second.CA_controlled != srv.CAControlled() ||
+                !srv.descs().sameAs(it->second.descs))
+            {
+                return false;
+            }
+            count++;
+        }
+    }
+    return count == sdt.services.size();
+}
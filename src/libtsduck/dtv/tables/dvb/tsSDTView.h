@@ -0,0 +1,124 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view over a section of a DVB Service Description Table (SDT).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsAbstractTableView.h"
+
+namespace ts {
+
+    class SDT;
+
+    //!
+    //! Read-only view over a section of a DVB Service Description Table (SDT), without copy or allocation.
+    //! @see ETSI EN 300 468, 5.2.3
+    //! @ingroup table
+    //!
+    class TSDUCKDLL SDTView : public AbstractTableView
+    {
+    public:
+        //!
+        //! Read-only view over one service entry in an SDT section.
+        //!
+        class TSDUCKDLL Service
+        {
+        public:
+            //!
+            //! Get the service id.
+            //! @return The service id.
+            //!
+            uint16_t serviceId() const { return GetUInt16(_data); }
+
+            //!
+            //! Check if EIT schedule are present for this service.
+            //! @return The EIT_schedule_flag.
+            //!
+            bool EITsPresent() const { return (_data[2] & 0x02) != 0; }
+
+            //!
+            //! Check if EIT present/following are present for this service.
+            //! @return The EIT_present_following_flag.
+            //!
+            bool EITpfPresent() const { return (_data[2] & 0x01) != 0; }
+
+            //!
+            //! Get the running status of the service.
+            //! @return The running status code.
+            //!
+            uint8_t runningStatus() const { return uint8_t(_data[3] >> 5); }
+
+            //!
+            //! Check if the service is controlled by a CA system.
+            //! @return The free_CA_mode.
+            //!
+            bool CAControlled() const { return (_data[3] & 0x10) != 0; }
+
+            //!
+            //! Get the list of descriptors of the service.
+            //! @return A view over the descriptors.
+            //!
+            DescriptorListView descs() const { return DescriptorListView(_data + 5, _size - 5); }
+
+            //!
+            //! Load the entry from a binary area.
+            //! @param [in] data Address of the binary entry.
+            //! @param [in] size Size in bytes of the binary area.
+            //! @return The size of the entry or zero if truncated.
+            //!
+            size_t parse(const uint8_t* data, size_t size);
+
+        private:
+            const uint8_t* _data = nullptr;
+            size_t         _size = 0;
+        };
+
+        //!
+        //! Constructor.
+        //! @param [in] section An SDT section. The view is invalid if this is not a valid SDT section.
+        //! The section must remain valid and unmodified while the view is in use.
+        //!
+        explicit SDTView(const Section& section);
+
+        //!
+        //! Check if this is an "actual" SDT.
+        //! @return True for SDT Actual TS, false for SDT Other TS.
+        //!
+        bool isActual() const { return tableId() == TID_SDT_ACT; }
+
+        //!
+        //! Get the transport stream id.
+        //! @return The transport stream id.
+        //!
+        uint16_t tsId() const { return tableIdExtension(); }
+
+        //!
+        //! Get the original network id.
+        //! @return The original network id.
+        //!
+        uint16_t onId() const { return isValid() ? GetUInt16(_payload) : 0; }
+
+        //!
+        //! Get the loop of services in the section.
+        //! @return A view over the loop of services.
+        //!
+        LoopView<Service> services() const { return isValid() ? LoopView<Service>(_payload + 3, _payload_size - 3) : LoopView<Service>(); }
+
+        //!
+        //! Check if a binary SDT has the same content as a deserialized SDT, ignoring the version.
+        //! This is a fast method to check if a new version of an SDT actually changes something.
+        //! @param [in] table A binary SDT.
+        //! @param [in] sdt A deserialized SDT.
+        //! @return True if @a table and @a sdt are valid and have the same content, except the version.
+        //!
+        static bool SameContent(const BinaryTable& table, const SDT& sdt);
+    };
+}
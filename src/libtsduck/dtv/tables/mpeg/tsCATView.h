@@ -0,0 +1,39 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view over a section of a Conditional Access Table (CAT).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsAbstractTableView.h"
+
+namespace ts {
+    //!
+    //! Read-only view over a section of a Conditional Access Table (CAT), without copy or allocation.
+    //! @see ISO/IEC 13818-1, ITU-T Rec. H.222.0, 2.4.4.6
+    //! @ingroup table
+    //!
+    class TSDUCKDLL CATView : public AbstractTableView
+    {
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] section A CAT section. The view is invalid if this is not a valid CAT section.
+        //! The section must remain valid and unmodified while the view is in use.
+        //!
+        explicit CATView(const Section& section);
+
+        //!
+        //! Get the list of descriptors.
+        //! @return A view over the descriptors of the CAT section.
+        //!
+        DescriptorListView descs() const { return DescriptorListView(_payload, _payload_size); }
+    };
+}
@@ -0,0 +1,57 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsPATView.h"
+#include "tsPAT.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::PATView::PATView(const Section& section) :
+    AbstractTableView(section, section.tableId() == TID_PAT && section.isLongSection(), 0)
+{
+}
+
+size_t ts::PATView::Program::parse(const uint8_t* data, size_t size)
+{
+    _data = size < 4 ? nullptr : data;
+    return _data == nullptr ? 0 : 4;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a binary PAT has the same content as a deserialized PAT.
+//----------------------------------------------------------------------------
+
+bool ts::PATView::SameContent(const BinaryTable& table, const PAT& pat)
+{
+    if (!pat.isValid() || !AllValid<PATView>(table) || table.tableIdExtension() != pat.ts_id) {
+        return false;
+    }
+
+    // Same semantics as PAT deserialization: the last NIT PID wins, PAT::clearContent() sets PID_NULL.
+    PID nit_pid = PID_NULL;
+    size_t count = 0;
+    for (size_t i = 0; i < table.sectionCount(); ++i) {
+        for (const auto& prog : PATView(*table.sectionAt(i)).programs()) {
+            if (prog.programNumber() == 0) {
+                nit_pid = prog.pid();
+            }
+            else {
+                const auto it = pat.pmts.find(prog.programNumber());
+                if (it == pat.pmts.end() || it->second != prog.pid()) {
+                    return false;
+                }
+                count++;
+            }
+        }
+    }
+    return nit_pid == pat.nit_pid && count == pat.pmts.size();
+}
@@ -0,0 +1,88 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view over a section of a Program Association Table (PAT).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsAbstractTableView.h"
+
+namespace ts {
+
+    class PAT;
+
+    //!
+    //! Read-only view over a section of a Program Association Table (PAT), without copy or allocation.
+    //! @see ISO/IEC 13818-1, ITU-T Rec. H.222.0, 2.4.4.3
+    //! @ingroup table
+    //!
+    class TSDUCKDLL PATView : public AbstractTableView
+    {
+    public:
+        //!
+        //! Read-only view over one program entry in a PAT section.
+        //! The program number zero designates the NIT PID.
+        //!
+        class TSDUCKDLL Program
+        {
+        public:
+            //!
+            //! Get the program number, aka service id.
+            //! @return The program number.
+            //!
+            uint16_t programNumber() const { return GetUInt16(_data); }
+
+            //!
+            //! Get the PMT PID (or NIT PID when the program number is zero).
+            //! @return The PID.
+            //!
+            PID pid() const { return GetUInt16(_data + 2) & 0x1FFF; }
+
+            //!
+            //! Load the entry from a binary area.
+            //! @param [in] data Address of the binary entry.
+            //! @param [in] size Size in bytes of the binary area.
+            //! @return The size of the entry or zero if truncated.
+            //!
+            size_t parse(const uint8_t* data, size_t size);
+
+        private:
+            const uint8_t* _data = nullptr;
+        };
+
+        //!
+        //! Constructor.
+        //! @param [in] section A PAT section. The view is invalid if this is not a valid PAT section.
+        //! The section must remain valid and unmodified while the view is in use.
+        //!
+        explicit PATView(const Section& section);
+
+        //!
+        //! Get the transport stream id.
+        //! @return The transport stream id.
+        //!
+        uint16_t tsId() const { return tableIdExtension(); }
+
+        //!
+        //! Get the loop of programs in the section.
+        //! @return A view over the loop of programs.
+        //!
+        LoopView<Program> programs() const { return LoopView<Program>(_payload, _payload_size); }
+
+        //!
+        //! Check if a binary PAT has the same content as a deserialized PAT, ignoring the version.
+        //! This is a fast method to check if a new version of a PAT actually changes something.
+        //! @param [in] table A binary PAT.
+        //! @param [in] pat A deserialized PAT.
+        //! @return True if @a table and @a pat are valid and have the same content, except the version.
+        //!
+        static bool SameContent(const BinaryTable& table, const PAT& pat);
+    };
+}
@@ -0,0 +1,71 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsPMTView.h"
+#include "tsPMT.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::PMTView::PMTView(const Section& section) :
+    AbstractTableView(section, section.tableId() == TID_PMT && section.isLongSection(), 4)
+{
+}
+
+size_t ts::PMTView::Stream::parse(const uint8_t* data, size_t size)
+{
+    _size = size < 5 ? 0 : 5 + (GetUInt16(data + 3) & 0x0FFF);
+    if (_size > size) {
+        _size = 0;
+    }
+    _data = _size == 0 ? nullptr : data;
+    return _size;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the loop of elementary streams in the section.
+//----------------------------------------------------------------------------
+
+ts::LoopView<ts::PMTView::Stream> ts::PMTView::streams() const
+{
+    const size_t start = skipLengthAt(2);
+    return LoopView<Stream>(_payload + start, _payload_size - start);
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a binary PMT has the same content as a deserialized PMT.
+//----------------------------------------------------------------------------
+
+bool ts::PMTView::SameContent(const BinaryTable& table, const PMT& pmt)
+{
+    if (!pmt.isValid() || !AllValid<PMTView>(table) || table.tableIdExtension() != pmt.service_id) {
+        return false;
+    }
+
+    // The program-level descriptors may be split over several sections.
+    size_t desc_index = 0;
+    size_t count = 0;
+    for (size_t i = 0; i < table.sectionCount(); ++i) {
+        const PMTView view(*table.sectionAt(i));
+        if (view.pcrPID() != pmt.pcr_pid || !view.descs().matchList(pmt.descs, desc_index)) {
+            return false;
+        }
+        for (const auto& str : view.streams()) {
+            const auto it = pmt.streams.find(str.pid());
+            if (it == pmt.streams.end() || it->second.stream_type != str.streamType() || !str.descs().sameAs(it->second.descs)) {
+                return false;
+            }
+            count++;
+        }
+    }
+    return desc_index == pmt.descs.size() && count == pmt.streams.size();
+}
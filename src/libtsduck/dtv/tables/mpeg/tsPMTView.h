@@ -0,0 +1,106 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view over a section of a Program Map Table (PMT).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsAbstractTableView.h"
+
+namespace ts {
+
+    class PMT;
+
+    //!
+    //! Read-only view over a section of a Program Map Table (PMT), without copy or allocation.
+    //! @see ISO/IEC 13818-1, ITU-T Rec. H.222.0, 2.4.4.8
+    //! @ingroup table
+    //!
+    class TSDUCKDLL PMTView : public AbstractTableView
+    {
+    public:
+        //!
+        //! Read-only view over one elementary stream entry in a PMT section.
+        //!
+        class TSDUCKDLL Stream
+        {
+        public:
+            //!
+            //! Get the stream type.
+            //! @return The stream type, one of ST_* (eg ts::ST_MPEG2_VIDEO).
+            //!
+            uint8_t streamType() const { return _data[0]; }
+
+            //!
+            //! Get the elementary stream PID.
+            //! @return The elementary stream PID.
+            //!
+            PID pid() const { return GetUInt16(_data + 1) & 0x1FFF; }
+
+            //!
+            //! Get the list of descriptors of the elementary stream.
+            //! @return A view over the ES_info descriptors.
+            //!
+            DescriptorListView descs() const { return DescriptorListView(_data + 5, _size - 5); }
+
+            //!
+            //! Load the entry from a binary area.
+            //! @param [in] data Address of the binary entry.
+            //! @param [in] size Size in bytes of the binary area.
+            //! @return The size of the entry or zero if truncated.
+            //!
+            size_t parse(const uint8_t* data, size_t size);
+
+        private:
+            const uint8_t* _data = nullptr;
+            size_t         _size = 0;
+        };
+
+        //!
+        //! Constructor.
+        //! @param [in] section A PMT section. The view is invalid if this is not a valid PMT section.
+        //! The section must remain valid and unmodified while the view is in use.
+        //!
+        explicit PMTView(const Section& section);
+
+        //!
+        //! Get the service id.
+        //! @return The service id, aka program number.
+        //!
+        uint16_t serviceId() const { return tableIdExtension(); }
+
+        //!
+        //! Get the PCR PID.
+        //! @return The PCR PID.
+        //!
+        PID pcrPID() const { return isValid() ? GetUInt16(_payload) & 0x1FFF : PID_NULL; }
+
+        //!
+        //! Get the list of program-level descriptors.
+        //! @return A view over the program_info descriptors.
+        //!
+        DescriptorListView descs() const { return descriptorsAt(2); }
+
+        //!
+        //! Get the loop of elementary streams in the section.
+        //! @return A view over the loop of elementary streams.
+        //!
+        LoopView<Stream> streams() const;
+
+        //!
+        //! Check if a binary PMT has the same content as a deserialized PMT, ignoring the version.
+        //! This is a fast method to check if a new version of a PMT actually changes something.
+        //! @param [in] table A binary PMT.
+        //! @param [in] pmt A deserialized PMT.
+        //! @return True if @a table and @a pmt are valid and have the same content, except the version.
+        //!
+        static bool SameContent(const BinaryTable& table, const PMT& pmt);
+    };
+}
@@ -0,0 +1,46 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsAbstractTableView.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::AbstractTableView::AbstractTableView(const Section& section, bool valid_tid, size_t min_payload_size) :
+    _payload(section.isValid() && valid_tid && section.payloadSize() >= min_payload_size ? section.payload() : nullptr),
+    _payload_size(_payload == nullptr ? 0 : section.payloadSize()),
+    _section(section)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Access structures with a 12-bit length field.
+//----------------------------------------------------------------------------
+
+size_t ts::AbstractTableView::skipLengthAt(size_t offset) const
+{
+    if (offset + 2 > _payload_size) {
+        return _payload_size;
+    }
+    else {
+        return std::min(_payload_size, offset + 2 + (GetUInt16(_payload + offset) & 0x0FFF));
+    }
+}
+
+ts::DescriptorListView ts::AbstractTableView::descriptorsAt(size_t offset) const
+{
+    if (offset + 2 > _payload_size) {
+        return DescriptorListView();
+    }
+    else {
+        return DescriptorListView(_payload + offset + 2, skipLengthAt(offset) - offset - 2);
+    }
+}
@@ -0,0 +1,141 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Abstract base class for read-only views over binary table sections.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsBinaryTable.h"
+#include "tsSection.h"
+#include "tsDescriptorListView.h"
+
+namespace ts {
+
+    //!
+    //! Abstract base class for read-only views over binary table sections.
+    //! @ingroup table
+    //!
+    //! A table view reads the fields of a table directly in the binary content of one section,
+    //! without deserialization, copy or allocation. This is useful when only a few fields of a
+    //! table are needed or to check if a table has changed before building the complete
+    //! deserialized object.
+    //!
+    //! The section must remain valid and unmodified while the view is in use. When a table
+    //! has several sections, one view shall be used per section.
+    //!
+    class TSDUCKDLL AbstractTableView
+    {
+    public:
+        //!
+        //! Check if the view is valid.
+        //! @return True if the section is valid and has the expected table id and minimum size.
+        //!
+        bool isValid() const { return _payload != nullptr; }
+
+        //!
+        //! Get the viewed section.
+        //! @return A constant reference to the viewed section.
+        //!
+        const Section& section() const { return _section; }
+
+        //!
+        //! Get the table id.
+        //! @return The table id.
+        //!
+        TID tableId() const { return _section.tableId(); }
+
+        //!
+        //! Get the table id extension.
+        //! @return The table id extension.
+        //!
+        uint16_t tableIdExtension() const { return _section.tableIdExtension(); }
+
+        //!
+        //! Get the table version.
+        //! @return The table version.
+        //!
+        uint8_t version() const { return _section.version(); }
+
+        //!
+        //! Check if the table is "current", not "next".
+        //! @return True if the table is "current", false if it is "next".
+        //!
+        bool isCurrent() const { return _section.isCurrent(); }
+
+    protected:
+        //!
+        //! Constructor for subclasses.
+        //! @param [in] section The section to view.
+        //! @param [in] valid_tid True if the table id of the section is valid for this type of table.
+        //! @param [in] min_payload_size Minimum size of the payload of the section.
+        //!
+        AbstractTableView(const Section& section, bool valid_tid, size_t min_payload_size);
+
+        //!
+        //! Address of the payload of the section, null if the view is invalid.
+        //!
+        const uint8_t* const _payload;
+
+        //!
+        //! Size of the payload of the section, zero if the view is invalid.
+        //!
+        const size_t _payload_size;
+
+        //!
+        //! Build a view over a descriptor list with a 12-bit length field.
+        //! @param [in] offset Offset of the length field in the payload.
+        //! @return A view over the descriptor list, truncated to the end of the payload.
+        //!
+        DescriptorListView descriptorsAt(size_t offset) const;
+
+        //!
+        //! Get the offset in the payload after a structure with a 12-bit length field.
+        //! @param [in] offset Offset of the length field in the payload.
+        //! @return Offset after the length field and the corresponding data, truncated to the end of the payload.
+        //!
+        size_t skipLengthAt(size_t offset) const;
+
+        //!
+        //! Check if all sections of a binary table are valid for a type of view.
+        //! @tparam VIEW A subclass of AbstractTableView.
+        //! @param [in] table The binary table to check.
+        //! @return True if the table is valid and all its sections are valid for the type of view.
+        //!
+        template <class VIEW> requires std::derived_from<VIEW, AbstractTableView>
+        static bool AllValid(const BinaryTable& table);
+
+    private:
+        const Section& _section;
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Template definitions.
+//----------------------------------------------------------------------------
+
+#if !defined(DOXYGEN)
+
+template <class VIEW> requires std::derived_from<VIEW, ts::AbstractTableView>
+bool ts::AbstractTableView::AllValid(const BinaryTable& table)
+{
+    if (!table.isValid()) {
+        return false;
+    }
+    for (size_t i = 0; i < table.sectionCount(); ++i) {
+        const SectionPtr& sec(table.sectionAt(i));
+        if (sec == nullptr || !VIEW(*sec).isValid()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif
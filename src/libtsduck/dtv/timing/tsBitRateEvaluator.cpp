@@ -0,0 +1,174 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsBitRateEvaluator.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::BitRateEvaluator::BitRateEvaluator(size_t min_pid, size_t min_pcr, size_t min_dts) :
+    _pcr_analyzer(min_pid, min_pcr)
+{
+    _dts_analyzer.resetAndUseDTS(min_pid, min_dts);
+}
+
+
+//----------------------------------------------------------------------------
+// Thread-safe init-safe static data patterns.
+//----------------------------------------------------------------------------
+
+const ts::Names& ts::BitRateEvaluator::ModeNames()
+{
+    static const Names data({
+        {u"full", Mode::FULL},
+        {u"PCR", Mode::PCR_PIDS},
+        {u"DTS", Mode::DTS_ONLY},
+        {u"external", Mode::EXTERNAL},
+    });
+    return data;
+}
+
+
+//----------------------------------------------------------------------------
+// Reset all collected information, restart a full analysis.
+//----------------------------------------------------------------------------
+
+void ts::BitRateEvaluator::reset()
+{
+    _pcr_analyzer.reset();
+    _dts_analyzer.reset();
+    _total_packets = 0;
+    _analyzed_packets = 0;
+    restart();
+}
+
+void ts::BitRateEvaluator::restart()
+{
+    // The PCR PID's are collected again during the full analysis.
+    _mode = Mode::FULL;
+    _pcr_pids.reset();
+}
+
+
+//----------------------------------------------------------------------------
+// Declare if the bitrate is provided by an external source.
+//----------------------------------------------------------------------------
+
+void ts::BitRateEvaluator::setExternalBitRate(bool external)
+{
+    if (external) {
+        _mode = Mode::EXTERNAL;
+    }
+    else if (_mode == Mode::EXTERNAL) {
+        // Some packets were not analyzed, the previous analysis is no longer valid.
+        reset();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Feed the evaluator with a contiguous set of TS packets.
+//----------------------------------------------------------------------------
+
+void ts::BitRateEvaluator::feedPackets(const TSPacket* pkt, size_t count)
+{
+    _total_packets += count;
+
+    switch (_mode) {
+        case Mode::FULL: {
+            // Analyze all packets. The DTS are useless once the PCR's are sufficient.
+            for (size_t n = 0; n < count; ++n) {
+                _pcr_analyzer.feedPacket(pkt[n]);
+                if (!_pcr_analyzer.bitrateIsValid()) {
+                    _dts_analyzer.feedPacket(pkt[n]);
+                }
+                if (pkt[n].hasPCR()) {
+                    _pcr_pids.set(pkt[n].getPID());
+                }
+            }
+            _analyzed_packets += count;
+            break;
+        }
+        case Mode::PCR_PIDS: {
+            // Analyze packets from PCR PID's only, count the others.
+            size_t skipped = 0;
+            for (size_t n = 0; n < count; ++n) {
+                if (_pcr_pids.test(pkt[n].getPID())) {
+                    if (skipped > 0) {
+                        _pcr_analyzer.skipPackets(skipped);
+                        skipped = 0;
+                    }
+                    _pcr_analyzer.feedPacket(pkt[n]);
+                    _analyzed_packets++;
+                }
+                else {
+                    skipped++;
+                }
+            }
+            _pcr_analyzer.skipPackets(skipped);
+            break;
+        }
+        case Mode::DTS_ONLY: {
+            for (size_t n = 0; n < count; ++n) {
+                _dts_analyzer.feedPacket(pkt[n]);
+            }
+            _analyzed_packets += count;
+            break;
+        }
+        case Mode::EXTERNAL:
+        default: {
+            break;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Evaluate the bitrate and adapt the mode of analysis.
+//----------------------------------------------------------------------------
+
+ts::BitRate ts::BitRateEvaluator::evaluate()
+{
+    switch (_mode) {
+        case Mode::FULL: {
+            if (_pcr_analyzer.bitrateIsValid()) {
+                // Got a bitrate from the PCR's, now analyze the PCR PID's only.
+                _mode = Mode::PCR_PIDS;
+                _pcr_discontinuities = _pcr_analyzer.discontinuityCount();
+                _dts_analyzer.reset();
+                return _pcr_analyzer.bitrate188();
+            }
+            else if (_dts_analyzer.bitrateIsValid()) {
+                // No bitrate from PCR but got one from DTS. Once used, DTS are used all the time.
+                _mode = Mode::DTS_ONLY;
+                _pcr_analyzer.reset();
+                return _dts_analyzer.bitrate188();
+            }
+            else {
+                return 0;
+            }
+        }
+        case Mode::PCR_PIDS: {
+            // After a discontinuity, the set of PCR PID's may have changed, restart the full analysis.
+            // The PCR analysis itself is still valid and the bitrate remains available.
+            if (_pcr_analyzer.discontinuityCount() != _pcr_discontinuities) {
+                restart();
+            }
+            return _pcr_analyzer.bitrate188();
+        }
+        case Mode::DTS_ONLY: {
+            return _dts_analyzer.bitrate188();
+        }
+        case Mode::EXTERNAL:
+        default: {
+            return 0;
+        }
+    }
+}
@@ -0,0 +1,126 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Adaptive evaluation of the bitrate of an input transport stream.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPCRAnalyzer.h"
+#include "tsNames.h"
+
+namespace ts {
+    //!
+    //! Adaptive evaluation of the bitrate of an input transport stream.
+    //! @ingroup mpeg
+    //! @see PCRAnalyzer
+    //!
+    //! The bitrate is evaluated from the PCR's of the stream or, when there is not enough PCR,
+    //! from the DTS of the video PID's. Once a bitrate is known, the evaluator reduces the
+    //! analysis to what is strictly necessary to keep it up to date:
+    //!
+    //! - When the bitrate is known from the PCR's, the DTS analysis is stopped and only the
+    //!   packets from the PCR PID's are analyzed. The other packets are only counted.
+    //! - When the bitrate is known from the DTS, it is used all the time and the PCR analysis
+    //!   is stopped.
+    //! - When the bitrate is provided by some external source, no analysis is done at all.
+    //!
+    //! When a discontinuity is found on the PCR PID's, the full analysis is re-armed,
+    //! to collect the new set of PCR PID's.
+    //!
+    //! The mode of analysis changes only in evaluate(), which is typically called on a
+    //! regular basis, to adjust the bitrate.
+    //!
+    class TSDUCKDLL BitRateEvaluator
+    {
+        TS_NOCOPY(BitRateEvaluator);
+    public:
+        //!
+        //! Constructor.
+        //! The parameters specify the criteria for valid bitrate analysis.
+        //! @param [in] min_pid Minimum number of PID's with PCR's or DTS's.
+        //! @param [in] min_pcr Minimum number of PCR's per PID.
+        //! @param [in] min_dts Minimum number of DTS's per PID.
+        //!
+        BitRateEvaluator(size_t min_pid = 1, size_t min_pcr = 32, size_t min_dts = 32);
+
+        //!
+        //! Current mode of analysis.
+        //!
+        enum class Mode {
+            FULL,      //!< All packets are analyzed, for PCR and DTS, until a bitrate is found.
+            PCR_PIDS,  //!< The bitrate is known from the PCR's, only PCR PID's are analyzed.
+            DTS_ONLY,  //!< The bitrate is known from the DTS's, only the DTS are analyzed.
+            EXTERNAL,  //!< The bitrate is provided by an external source, nothing is analyzed.
+        };
+
+        //!
+        //! Get the names of the modes of analysis, for logging.
+        //! @return A constant reference to the names of the modes.
+        //!
+        static const Names& ModeNames();
+
+        //!
+        //! Reset all collected information, restart a full analysis.
+        //!
+        void reset();
+
+        //!
+        //! Declare if the bitrate is provided by an external source.
+        //! When the bitrate is externally provided, the packets are no longer analyzed.
+        //! When the external bitrate is no longer available, the full analysis is restarted.
+        //! @param [in] external When true, the bitrate is provided by an external source.
+        //!
+        void setExternalBitRate(bool external);
+
+        //!
+        //! Feed the evaluator with a contiguous set of TS packets.
+        //! @param [in] pkt Address of the first packet.
+        //! @param [in] count Number of packets.
+        //!
+        void feedPackets(const TSPacket* pkt, size_t count);
+
+        //!
+        //! Evaluate the bitrate and adapt the mode of analysis.
+        //! @return The evaluated bitrate, based on 188-byte packets, zero if unknown.
+        //!
+        BitRate evaluate();
+
+        //!
+        //! Get the current mode of analysis.
+        //! @return The current mode of analysis.
+        //!
+        Mode mode() const { return _mode; }
+
+        //!
+        //! Get the number of packets which were passed to the evaluator since the last reset.
+        //! @return The total number of packets.
+        //!
+        PacketCounter totalPackets() const { return _total_packets; }
+
+        //!
+        //! Get the number of packets which were actually analyzed since the last reset.
+        //! In PCR_PIDS mode, the packets from the other PID's are not analyzed.
+        //! @return The number of analyzed packets.
+        //!
+        PacketCounter analyzedPackets() const { return _analyzed_packets; }
+
+    private:
+        Mode          _mode = Mode::FULL;
+        PCRAnalyzer   _pcr_analyzer;               // Compute bitrate from PCR's.
+        PCRAnalyzer   _dts_analyzer {};            // Compute bitrate from video DTS's.
+        PIDSet        _pcr_pids {};                // PID's with PCR's, found during the full analysis.
+        size_t        _pcr_discontinuities = 0;    // Number of PCR discontinuities when entering PCR_PIDS mode.
+        PacketCounter _total_packets = 0;          // Number of packets since last reset.
+        PacketCounter _analyzed_packets = 0;       // Number of analyzed packets since last reset.
+
+        // Restart the full analysis.
+        void restart();
+    };
+}
@@ -7,7 +7,6 @@
 //----------------------------------------------------------------------------
 
 #include "tsBitRateRegulator.h"
-#include "tsSysUtils.h"
 #include "tsNullReport.h"
 
 
@@ -42,10 +41,10 @@ void ts::BitRateRegulator::start()
     // Compute the minimum delay between two bursts, in nano-seconds. This is a
     // limitation of the operating system. If we try to use wait on durations
     // lower than the minimum, this will introduce latencies which mess up the
-    // regulation. We try to request 2 milliseconds as time precision and we
-    // keep what the operating system gives.
-    _burst_min = cn::milliseconds(2);
-    SetTimersPrecision(_burst_min);
+    // regulation. The pacing timer knows what the operating system can do. By
+    // default, without spin phase, this is 2 milliseconds or more.
+    _burst_min = _timer.precision();
+    _timer.resetStatistics();
     _report->log(_log_level, u"minimum packet burst duration is %s", _burst_min);
 
     // Initial measurement period is one second. Will be enlarged for extra-low bitrates.
@@ -107,7 +106,7 @@ void ts::BitRateRegulator::regulatePacket(bool& flush)
     // While not enough bit credit for one packet, wait until end of current burst.
     while (otherPeriod().bits + currentPeriod().bits + int64_t(PKT_SIZE_BITS) > max_bits) {
         // Wait until scheduled end of burst.
-        std::this_thread::sleep_until(_burst_end);
+        _timer.waitUntil(_burst_end);
         // Restart a new burst, use monotonic time.
         _burst_end += _burst_duration;
         // Flush current burst
@@ -14,6 +14,7 @@
 #pragma once
 #include "tsTS.h"
 #include "tsReport.h"
+#include "tsPacingTimer.h"
 
 namespace ts {
     //!
@@ -72,6 +73,23 @@ namespace ts {
         //!
         void regulate();
 
+        //!
+        //! Get the pacing timer which is used to wait between bursts.
+        //! This can be used to get statistics on the precision of the regulation.
+        //! @return A constant reference to the pacing timer.
+        //!
+        const PacingTimer& pacingTimer() const { return _timer; }
+
+        //!
+        //! Set the duration of the active spin phase before each wait.
+        //! By default, there is no spin phase. Must be called before start().
+        //! With a spin phase, the minimum burst duration is much shorter, reducing
+        //! the jitter at the expense of a much higher CPU load.
+        //! @param [in] spin Duration of the spin phase. Zero means never spin.
+        //! @see PacingTimer::setSpinDuration()
+        //!
+        void setSpinDuration(cn::nanoseconds spin) { _timer.setSpinDuration(spin); }
+
     private:
         // We accumulate the amount of passed bits over the last few seconds to evaluate if we have
         // to pass more or less packets. This is used to compensate for the fact that we pass entire
@@ -99,6 +117,7 @@ namespace ts {
         Period          _periods[2] {};       // Last two measurement periods, accumulating packets
         cn::nanoseconds _period_duration {cn::seconds(1)}; // Duration of a period of packet measurement, default: 1 second
         size_t          _cur_period = 0;      // Current period index, 0 or 1
+        PacingTimer     _timer {};            // Wait between bursts
 
         // Current and other period.
         Period& currentPeriod() { return _periods[_cur_period & 1]; }
@@ -84,7 +84,7 @@ void ts::PCRAnalyzer::reset()
         }
     }
 
-    _packet_pcr_index_map.clear();
+    _domains.clear();
 }
 
 
@@ -124,7 +124,84 @@ void ts::PCRAnalyzer::processDiscontinuity()
             _pid[i]->last_pcr_value = INVALID_PCR;
         }
     }
-    _packet_pcr_index_map.clear();
+    for (auto& dom : _domains) {
+        dom.clear();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Clock domains, ring buffers of PCR/DTS values.
+//----------------------------------------------------------------------------
+
+ts::PCRAnalyzer::ClockDomain::ClockDomain() :
+    _ring(RING_SIZE)
+{
+}
+
+void ts::PCRAnalyzer::ClockDomain::popFront()
+{
+    if (_count > 0) {
+        _first = (_first + 1) % RING_SIZE;
+        _count--;
+    }
+}
+
+void ts::PCRAnalyzer::ClockDomain::pushBack(const ClockPoint& point)
+{
+    if (_count == RING_SIZE) {
+        // Make sure that some crazy TS does not accumulate thousands of PCR values in the same second range.
+        popFront();
+    }
+    _ring[(_first + _count) % RING_SIZE] = point;
+    _count++;
+}
+
+int64_t ts::PCRAnalyzer::clockDiff(uint64_t from, uint64_t to) const
+{
+    // Forward difference, modulo the clock scale. Large values are negative differences.
+    const uint64_t diff = _use_dts ? DiffPTS(from, to) * SYSTEM_CLOCK_SUBFACTOR : DiffPCR(from, to);
+    return diff > PCR_SCALE / 2 ? int64_t(diff) - int64_t(PCR_SCALE) : int64_t(diff);
+}
+
+size_t ts::PCRAnalyzer::clockDomain(PIDAnalysis& ps, uint64_t pcr_dts)
+{
+    // Keep the current domain of the PID, as long as its clock does not jump.
+    if (ps.clock_domain != NPOS) {
+        ClockDomain& dom(_domains[ps.clock_domain]);
+        if (dom.empty() || std::abs(clockDiff(dom.back().pcr_dts, pcr_dts)) <= int64_t(SYSTEM_CLOCK_FREQ)) {
+            return ps.clock_domain;
+        }
+        // The clock of the PID jumped, leave this domain.
+        if (--dom.pid_count == 0) {
+            dom.clear();
+        }
+        ps.clock_domain = NPOS;
+    }
+
+    // Look for an existing domain with close clock values (less than one second).
+    // Otherwise, reuse an unused domain or create a new one.
+    size_t unused = NPOS;
+    for (size_t i = 0; i < _domains.size(); ++i) {
+        const ClockDomain& dom(_domains[i]);
+        if (!dom.empty() && std::abs(clockDiff(dom.back().pcr_dts, pcr_dts)) <= int64_t(SYSTEM_CLOCK_FREQ)) {
+            ps.clock_domain = i;
+            break;
+        }
+        else if (dom.pid_count == 0 && unused == NPOS) {
+            unused = i;
+        }
+    }
+    if (ps.clock_domain == NPOS) {
+        if (unused == NPOS) {
+            unused = _domains.size();
+            _domains.emplace_back();
+        }
+        ps.clock_domain = unused;
+        _domains[unused].clear();
+    }
+    _domains[ps.clock_domain].pid_count++;
+    return ps.clock_domain;
 }
 
 
@@ -269,14 +346,15 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
     // Process PCR (or DTS)
     if ((_use_dts && pkt.hasDTS()) || (!_use_dts && pkt.hasPCR())) {
 
-        // Get PCR value (or DTS)
+        // Get PCR value (or DTS) and the corresponding clock domain.
         const uint64_t pcr_dts = _use_dts ? pkt.getDTS() : pkt.getPCR();
+        ClockDomain& dom(_domains[clockDomain(*ps, pcr_dts)]);
 
         // If last PCR/DTS valid, compute transport rate between the two
         if (ps->last_pcr_value != INVALID_PCR && ps->last_pcr_value != pcr_dts) {
 
             // Compute transport rate in b/s since last PCR/DTS
-            uint64_t diff_values = _use_dts ?
+            const uint64_t diff_values = _use_dts ?
                 DiffPTS(ps->last_pcr_value, pcr_dts) * SYSTEM_CLOCK_SUBFACTOR :
                 DiffPCR(ps->last_pcr_value, pcr_dts);
 
@@ -285,22 +363,10 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
             BitRate ts_bitrate_204 = diff_values == 0 ? 0 :
                 BitRate((_ts_pkt_cnt - ps->last_pcr_packet) * SYSTEM_CLOCK_FREQ * PKT_RS_SIZE_BITS) / diff_values;
 
-            // Clear out values older than 1 second from _packet_pcr_index_map.
-            // Note that this is a map that covers PCR/DTS packets across all PIDs
-            // as long as the clocks used to generate the PCR/DTS values for different
-            // programs is the same clock, there should be no issue, but if the PCR/DTS values
-            // across the two programs are wildly different, then the following approach won't work.
-            while (!_packet_pcr_index_map.empty()) {
-                const uint64_t earliestPCR_DTS = _packet_pcr_index_map.begin()->first;
-                diff_values = _use_dts ?
-                    DiffPTS(earliestPCR_DTS, pcr_dts) * SYSTEM_CLOCK_SUBFACTOR :
-                    DiffPCR(earliestPCR_DTS, pcr_dts);
-                if (diff_values > SYSTEM_CLOCK_FREQ) {
-                    _packet_pcr_index_map.erase(_packet_pcr_index_map.begin());
-                }
-                else {
-                    break;
-                }
+            // Clear out values older than 1 second from the clock domain of the PID.
+            // PID's from other clock domains are not affected, their clock values are unrelated.
+            while (!dom.empty() && clockDiff(dom.front().pcr_dts, pcr_dts) > int64_t(SYSTEM_CLOCK_FREQ)) {
+                dom.popFront();
             }
 
             // Per-PID statistics:
@@ -319,14 +385,12 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
 
             // Transport stream instantaneous statistics.
             // For instantaneous bit rates, these are the actual bit rates, and it doesn't use the "count" approach.
-            if (!_packet_pcr_index_map.empty()) {
-                diff_values = _use_dts ?
-                    DiffPTS(_packet_pcr_index_map.begin()->first, pcr_dts) * SYSTEM_CLOCK_SUBFACTOR :
-                    DiffPCR(_packet_pcr_index_map.begin()->first, pcr_dts);
-                _inst_ts_bitrate_188 = diff_values == 0 ? 0 :
-                    BitRate((_ts_pkt_cnt - _packet_pcr_index_map.begin()->second) * SYSTEM_CLOCK_FREQ * PKT_SIZE_BITS) / diff_values;
-                _inst_ts_bitrate_204 = diff_values == 0 ? 0 :
-                    BitRate((_ts_pkt_cnt - _packet_pcr_index_map.begin()->second) * SYSTEM_CLOCK_FREQ * PKT_RS_SIZE_BITS) / diff_values;
+            // With DTS, values from distinct PID's may be slightly out of order, ignore a "future" oldest value.
+            const int64_t inst_diff = dom.empty() ? 0 : clockDiff(dom.front().pcr_dts, pcr_dts);
+            if (inst_diff > 0) {
+                const uint64_t packets = _ts_pkt_cnt - dom.front().packet;
+                _inst_ts_bitrate_188 = BitRate(packets * SYSTEM_CLOCK_FREQ * PKT_SIZE_BITS) / uint64_t(inst_diff);
+                _inst_ts_bitrate_204 = BitRate(packets * SYSTEM_CLOCK_FREQ * PKT_RS_SIZE_BITS) / uint64_t(inst_diff);
             }
 
             // Check if we got enough values for this PID
@@ -341,14 +405,8 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
             ps->last_pcr_value = pcr_dts;
             ps->last_pcr_packet = _ts_pkt_cnt;
 
-            // Also add PCR (or DTS)/packet index combo to map for use in instantaneous bit rate calculations.
-            _packet_pcr_index_map[pcr_dts] = _ts_pkt_cnt;
-
-            // Make sure that some crazy TS does not accumulate thousands of PCR values in the same second range.
-            while (_packet_pcr_index_map.size() > FOOLPROOF_MAP_LIMIT) {
-                // Erase older entries.
-                _packet_pcr_index_map.erase(_packet_pcr_index_map.begin());
-            }
+            // Also add PCR (or DTS)/packet index combo to the clock domain for use in instantaneous bit rate calculations.
+            dom.pushBack({pcr_dts, _ts_pkt_cnt});
         }
     }
 
@@ -87,6 +87,21 @@ namespace ts {
         //!
         bool feedPacket(const TSPacket& pkt);
 
+        //!
+        //! Count TS packets which are part of the stream but are not analyzed.
+        //! This can be used when the caller knows that some packets do not carry PCR's (or DTS's)
+        //! and only feeds the packets from the PCR PID's. The skipped packets are counted in the
+        //! global TS bitrate but not in any PID. Skipped packets are not checked for discontinuities.
+        //! @param [in] count Number of packets to skip.
+        //!
+        void skipPackets(PacketCounter count) { _ts_pkt_cnt += count; }
+
+        //!
+        //! Get the number of discontinuities which were detected since the creation of the analyzer.
+        //! @return The number of discontinuities.
+        //!
+        size_t discontinuityCount() const { return _discontinuities; }
+
         //!
         //! Check if we have collected enough packet to evaluate TS bitrate.
         //! @return True if we have collected enough packet to evaluate TS bitrate.
@@ -121,6 +136,8 @@ namespace ts {
 
         //!
         //! Get the evaluated TS bitrate in bits/second based on 188-byte packets for the last second.
+        //! PID's carrying PCR's (or DTS's) from unrelated clocks are grouped in distinct "clock domains".
+        //! The instantaneous bitrate is evaluated inside the clock domain of the last PCR.
         //! @return The evaluated TS bitrate in bits/second based on 188-byte packets.
         //!
         BitRate instantaneousBitrate188() const;
@@ -188,8 +205,42 @@ namespace ts {
             BitRate  ts_bitrate_188 = 0;   // Sum of all computed TS bitrates (188-byte)
             BitRate  ts_bitrate_204 = 0;   // Sum of all computed TS bitrates (204-byte)
             uint64_t ts_bitrate_cnt = 0;   // Count of computed TS bitrates
+            size_t   clock_domain = NPOS;  // Index of clock domain in _domains, NPOS if none yet
+        };
+
+        // A PCR/DTS value and the index of the packet which contains it.
+        struct ClockPoint
+        {
+            uint64_t pcr_dts = 0;          // PCR or DTS value (in PCR units)
+            uint64_t packet = 0;           // Packet index in the TS
         };
 
+        // A clock domain is a set of PID's with PCR/DTS values from the same clock.
+        // The PCR/DTS values of the last second are kept in a fixed-size ring buffer,
+        // in order of arrival, for the instantaneous bitrate.
+        class ClockDomain
+        {
+        public:
+            size_t pid_count = 0;          // Number of PID's using this clock domain
+            ClockDomain();
+            bool empty() const { return _count == 0; }
+            void clear() { _first = _count = 0; }
+            const ClockPoint& front() const { return _ring[_first]; }
+            const ClockPoint& back() const { return _ring[(_first + _count - 1) % RING_SIZE]; }
+            void popFront();
+            void pushBack(const ClockPoint& point);
+        private:
+            std::vector<ClockPoint> _ring;
+            size_t _first = 0;
+            size_t _count = 0;
+        };
+
+        // Signed difference between two PCR/DTS values in PCR units, with wrap-up.
+        int64_t clockDiff(uint64_t from, uint64_t to) const;
+
+        // Get the index of the clock domain of a PID for a new PCR/DTS value.
+        size_t clockDomain(PIDAnalysis& ps, uint64_t pcr_dts);
+
         // Private members:
         bool     _use_dts = false;         // Use DTS instead of PCR
         bool     _ignore_errors = false;   // Ignore TS errors such as discontinuities.
@@ -206,7 +257,7 @@ namespace ts {
         size_t   _pcr_pids = 0;            // Number of PIDs with PCRs
         size_t   _discontinuities = 0;     // Number of discontinuities
         PIDAnalysis* _pid[PID_MAX] {};     // Per-PID stats
-        std::map<uint64_t, uint64_t> _packet_pcr_index_map {}; // Map of PCR/DTS to packet index across entire TS
-        static constexpr size_t FOOLPROOF_MAP_LIMIT = 1000;    // Max number of entries in the PCR map
+        std::vector<ClockDomain> _domains {}; // Clock domains, for instantaneous bitrate
+        static constexpr size_t RING_SIZE = 2048; // Max number of PCR/DTS per clock domain in the last second
     };
 }
@@ -55,6 +55,7 @@ void ts::PCRRegulator::reset()
     _pid = _user_pid;
     _burst_pkt_cnt = 0;
     _started = false;
+    _timer.resetStatistics();
 }
 
 
@@ -128,7 +129,7 @@ bool ts::PCRRegulator::regulate(const TSPacket& pkt)
             if (clock_due - _clock_last >= _wait_min) {
                 // Wait until system time for current PCR.
                 _clock_last = clock_due;
-                std::this_thread::sleep_until(_clock_last);
+                _timer.waitUntil(_clock_last);
                 // Always flush after wait.
                 flush = true;
             }
@@ -14,6 +14,7 @@
 #pragma once
 #include "tsReport.h"
 #include "tsTSPacket.h"
+#include "tsPacingTimer.h"
 
 namespace ts {
     //!
@@ -82,6 +83,21 @@ namespace ts {
         //!
         bool regulate(const TSPacket& pkt);
 
+        //!
+        //! Get the pacing timer which is used to wait on PCR's.
+        //! This can be used to get statistics on the precision of the regulation.
+        //! @return A constant reference to the pacing timer.
+        //!
+        const PacingTimer& pacingTimer() const { return _timer; }
+
+        //!
+        //! Set the duration of the active spin phase before each wait.
+        //! By default, there is no spin phase. Must be called before setMinimimWait().
+        //! @param [in] spin Duration of the spin phase. Zero means never spin.
+        //! @see PacingTimer::setSpinDuration()
+        //!
+        void setSpinDuration(cn::nanoseconds spin) { _timer.setSpinDuration(spin); }
+
     private:
         Report*          _report = nullptr;
         int              _log_level = Severity::Info;
@@ -96,6 +112,7 @@ namespace ts {
         uint64_t         _pcr_offset = 0;           // Offset to add to PCR value, accumulate all PCR wrap-down sequences.
         monotonic_time   _clock_first {};           // System time at first PCR.
         monotonic_time   _clock_last {};            // System time at last wait
+        PacingTimer      _timer {};                 // Wait until due time of PCR's
     };
 }
 
@@ -112,8 +129,7 @@ void ts::PCRRegulator::setMinimimWait(const cn::duration<Rep,Period>& d)
 {
     using duration = cn::duration<Rep,Period>;
     if (d != _wait_min && d > duration::zero()) {
-        cn::microseconds precision = cn::milliseconds(2);
-        SetTimersPrecision(precision);
+        const cn::microseconds precision = cn::duration_cast<cn::microseconds>(_timer.precision());
         _wait_min = std::max(cn::duration_cast<cn::microseconds>(d), precision);
         _report->log(_log_level, u"minimum wait: %s, using %s", precision, _wait_min);
     }
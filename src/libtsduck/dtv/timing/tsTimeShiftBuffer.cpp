@@ -9,6 +9,34 @@
 #include "tsTimeShiftBuffer.h"
 #include "tsNullReport.h"
 #include "tsFileUtils.h"
+#include "tsSysUtils.h"
+#include "tsMemory.h"
+
+#if defined(TS_UNIX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/stat.h>
+    #include <sys/file.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+// Header of a memory-mapped file. The packets and their metadata follow in the file.
+// The file is used on the same system only, the header uses the native byte order.
+struct ts::TimeShiftBuffer::MapHeader
+{
+    uint8_t  magic[8];       // File identification.
+    uint32_t version;        // Format version.
+    uint32_t mdata_size;     // Size in bytes of the binary representation of TSPacketMetadata.
+    uint64_t total_packets;  // Total capacity of the buffer.
+    uint64_t cur_packets;    // Current number of packets in the buffer.
+    uint64_t next_read;      // Index in buffer of next packet to read.
+    uint64_t next_write;     // Index in buffer of next packet to write.
+};
+
+namespace {
+    constexpr uint8_t MAP_MAGIC[8] = {'T', 'S', 'S', 'H', 'I', 'F', 'T', 0};
+    constexpr uint32_t MAP_VERSION = 1;
+    constexpr size_t MAP_PAGE_SIZE = 4096;  // Alignment of areas in the mapped file.
+}
 
 
 //----------------------------------------------------------------------------
@@ -63,6 +91,63 @@ bool ts::TimeShiftBuffer::setBackupDirectory(const fs::path& directory)
     }
 }
 
+bool ts::TimeShiftBuffer::setMemoryMapped(bool on)
+{
+    if (_is_open) {
+        return false;
+    }
+    else {
+        _use_map = on;
+        return true;
+    }
+}
+
+bool ts::TimeShiftBuffer::setPersistentFile(const fs::path& filename)
+{
+    if (_is_open) {
+        return false;
+    }
+    else {
+        _persistent_file = filename;
+        return true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Layout of a memory-mapped file.
+//----------------------------------------------------------------------------
+
+size_t ts::TimeShiftBuffer::MapLayout(size_t total_packets, size_t& mdata_offset)
+{
+    // The header uses the first page, followed by the packets, then the metadata.
+    mdata_offset = round_up(MAP_PAGE_SIZE + total_packets * PKT_SIZE, MAP_PAGE_SIZE);
+    return mdata_offset + total_packets * sizeof(TSPacketMetadata);
+}
+
+
+//----------------------------------------------------------------------------
+// Get the size in packets of the buffer in an existing persistent file.
+//----------------------------------------------------------------------------
+
+size_t ts::TimeShiftBuffer::PersistentFileSize(const fs::path& filename)
+{
+    MapHeader header;
+    std::ifstream strm(filename, std::ios::in | std::ios::binary);
+    if (!strm.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        !MemEqual(header.magic, MAP_MAGIC, sizeof(MAP_MAGIC)) ||
+        header.version != MAP_VERSION ||
+        header.mdata_size != sizeof(TSPacketMetadata) ||
+        header.total_packets < MIN_TOTAL_PACKETS)
+    {
+        return 0;
+    }
+    size_t mdata_offset = 0;
+    const size_t file_size = MapLayout(size_t(header.total_packets), mdata_offset);
+    std::error_code error;
+    return fs::file_size(filename, error) == file_size && !error ? size_t(header.total_packets) : 0;
+}
+
 
 //----------------------------------------------------------------------------
 // Open the buffer.
@@ -75,12 +160,25 @@ bool ts::TimeShiftBuffer::open(Report& report)
         return false;
     }
 
+    _cur_packets = 0;
+    _next_read = _next_write = 0;
+    _wcache_next = _rcache_end = _rcache_next = 0;
+    _resumed = false;
+
     if (memoryResident()) {
         // The buffer is entirely memory-resident in _wcache.
         _wcache.resize(_total_packets);
         _wmdata.resize(_total_packets);
         _rcache.clear();
         _rmdata.clear();
+        _packets = _wcache.data();
+        _mdata = _wmdata.data();
+    }
+    else if (!_persistent_file.empty()) {
+        // The buffer is backed by a persistent memory-mapped file.
+        if (!mapFile(_persistent_file, false, report)) {
+            return false;
+        }
     }
     else {
         // The buffer is backed up on disk.
@@ -96,29 +194,162 @@ bool ts::TimeShiftBuffer::open(Report& report)
             }
         }
 
-        // Create the backup file. The flag temporary means that it will be deleted on close.
-        // Use TSDuck proprietary format to save the packet metadata.
-        if (!_file.open(filename, TSFile::READ | TSFile::WRITE | TSFile::TEMPORARY, report, TSPacketFormat::DUCK)) {
-            return false;
+        if (_use_map) {
+            // Map the complete backup file in memory.
+            if (!mapFile(filename, true, report)) {
+                return false;
+            }
         }
+        else {
+            // Create the backup file. The flag temporary means that it will be deleted on close.
+            // Use TSDuck proprietary format to save the packet metadata.
+            if (!_file.open(filename, TSFile::READ | TSFile::WRITE | TSFile::TEMPORARY, report, TSPacketFormat::DUCK)) {
+                return false;
+            }
 
-        // The read and write buffers use half of memory quota each.
-        // Since the size of the file is larger than the sum of the two,
-        // the read and write caches never overlap when the buffer is full.
-        _wcache.resize(_mem_packets / 2);
-        _wmdata.resize(_mem_packets / 2);
-        _rcache.resize(_mem_packets / 2);
-        _rmdata.resize(_mem_packets / 2);
+            // The read and write buffers use half of memory quota each.
+            // Since the size of the file is larger than the sum of the two,
+            // the read and write caches never overlap when the buffer is full.
+            _wcache.resize(_mem_packets / 2);
+            _wmdata.resize(_mem_packets / 2);
+            _rcache.resize(_mem_packets / 2);
+            _rmdata.resize(_mem_packets / 2);
+        }
     }
 
-    _cur_packets = 0;
-    _next_read = _next_write = 0;
-    _wcache_next = _rcache_end = _rcache_next = 0;
     _is_open = true;
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Create or resume the memory-mapped file.
+//----------------------------------------------------------------------------
+
+bool ts::TimeShiftBuffer::mapFile(const fs::path& filename, bool temporary, Report& report)
+{
+#if defined(TS_UNIX)
+
+    size_t mdata_offset = 0;
+    const size_t file_size = MapLayout(_total_packets, mdata_offset);
+
+    const int fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+    if (fd < 0) {
+        report.error(u"error creating time-shift file %s: %s", filename, SysErrorCodeMessage());
+        return false;
+    }
+
+    // A temporary file is immediately deleted. It remains hidden and usable until it is unmapped.
+    // A persistent file is exclusively locked as long as it is mapped, two processes cannot share it.
+    if (temporary) {
+        ::unlink(filename.c_str());
+    }
+    else if (::flock(fd, LOCK_EX | LOCK_NB) < 0) {
+        if (errno == EWOULDBLOCK) {
+            report.error(u"time-shift file %s is already used by another process", filename);
+        }
+        else {
+            report.error(u"error locking time-shift file %s: %s", filename, SysErrorCodeMessage());
+        }
+        ::close(fd);
+        return false;
+    }
+
+    // Check if a persistent file can be resumed, now that it is locked.
+    bool resume = false;
+    if (!temporary) {
+        const size_t previous = PersistentFileSize(filename);
+        resume = previous == _total_packets;
+        if (previous != 0 && !resume) {
+            report.warning(u"time-shift file %s contains %'d packets, reinitialized with %'d packets", filename, previous, _total_packets);
+        }
+    }
+
+    // Allocate all disk blocks of a new file. With a sparse file, a full disk would be
+    // reported as a SIGBUS when accessing the memory, instead of an error here.
+    if (!resume) {
+        if (::ftruncate(fd, 0) < 0) {
+            report.error(u"error resizing time-shift file %s: %s", filename, SysErrorCodeMessage());
+            ::close(fd);
+            return false;
+        }
+#if defined(TS_MAC)
+        // No posix_fallocate() on macOS.
+        const int err = ::ftruncate(fd, ::off_t(file_size)) < 0 ? LastSysErrorCode() : 0;
+#else
+        const int err = ::posix_fallocate(fd, 0, ::off_t(file_size));
+#endif
+        if (err != 0) {
+            report.error(u"error allocating %'d bytes for time-shift file %s: %s", file_size, filename, SysErrorCodeMessage(err));
+            ::close(fd);
+            return false;
+        }
+    }
+
+    void* addr = ::mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        report.error(u"error mapping time-shift file %s: %s", filename, SysErrorCodeMessage());
+        ::close(fd);
+        return false;
+    }
+
+    // The file descriptor is kept open to hold the lock.
+    _map_fd = fd;
+
+    // Packets are always accessed sequentially.
+    ::madvise(addr, file_size, MADV_SEQUENTIAL);
+
+    _map_base = reinterpret_cast<uint8_t*>(addr);
+    _map_size = file_size;
+    _map_header = reinterpret_cast<MapHeader*>(_map_base);
+    _packets = reinterpret_cast<TSPacket*>(_map_base + MAP_PAGE_SIZE);
+    _mdata = reinterpret_cast<TSPacketMetadata*>(_map_base + mdata_offset);
+
+    if (resume && _map_header->cur_packets <= _total_packets && _map_header->next_read < _total_packets && _map_header->next_write < _total_packets) {
+        _cur_packets = size_t(_map_header->cur_packets);
+        _next_read = size_t(_map_header->next_read);
+        _next_write = size_t(_map_header->next_write);
+        _resumed = true;
+        report.verbose(u"resuming time-shift buffer from %s, %'d packets", filename, _cur_packets);
+        prefetch(_next_read);
+    }
+    else {
+        MemCopy(_map_header->magic, MAP_MAGIC, sizeof(MAP_MAGIC));
+        _map_header->version = MAP_VERSION;
+        _map_header->mdata_size = uint32_t(sizeof(TSPacketMetadata));
+        _map_header->total_packets = _total_packets;
+        _map_header->cur_packets = _map_header->next_read = _map_header->next_write = 0;
+    }
+    return true;
+
+#else
+
+    report.error(u"memory-mapped time-shift files are not supported on this system");
+    return false;
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Give hints to the system on the next window of the memory-mapped file.
+//----------------------------------------------------------------------------
+
+void ts::TimeShiftBuffer::prefetch(size_t index)
+{
+#if defined(TS_UNIX)
+    if (_map_base != nullptr) {
+        // Start at page boundaries, as required by madvise().
+        const size_t count = std::min(MAP_WINDOW_PACKETS, _total_packets - index);
+        uint8_t* const pkt_start = _map_base + round_down(size_t(reinterpret_cast<uint8_t*>(_packets + index) - _map_base), MAP_PAGE_SIZE);
+        uint8_t* const md_start = _map_base + round_down(size_t(reinterpret_cast<uint8_t*>(_mdata + index) - _map_base), MAP_PAGE_SIZE);
+        ::madvise(pkt_start, reinterpret_cast<uint8_t*>(_packets + index + count) - pkt_start, MADV_WILLNEED);
+        ::madvise(md_start, reinterpret_cast<uint8_t*>(_mdata + index + count) - md_start, MADV_WILLNEED);
+    }
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Close the buffer.
 //----------------------------------------------------------------------------
@@ -129,13 +360,39 @@ bool ts::TimeShiftBuffer::close(Report& report)
         return false;
     }
 
+    bool success = true;
+
+#if defined(TS_UNIX)
+    if (_map_base != nullptr) {
+        // A persistent file is flushed on disk to be resumed later.
+        if (!_persistent_file.empty() && ::msync(_map_base, _map_size, MS_SYNC) < 0) {
+            report.error(u"error flushing time-shift file %s: %s", _persistent_file, SysErrorCodeMessage());
+            success = false;
+        }
+        if (::munmap(_map_base, _map_size) < 0) {
+            report.error(u"error unmapping time-shift file: %s", SysErrorCodeMessage());
+            success = false;
+        }
+    }
+    if (_map_fd >= 0) {
+        // Also release the lock on a persistent file.
+        ::close(_map_fd);
+        _map_fd = -1;
+    }
+#endif
+
     _is_open = false;
     _cur_packets = 0;
     _wcache.clear();
     _wmdata.clear();
     _rcache.clear();
     _rmdata.clear();
-    return !_file.isOpen() || _file.close(report);
+    _packets = nullptr;
+    _mdata = nullptr;
+    _map_base = nullptr;
+    _map_size = 0;
+    _map_header = nullptr;
+    return (!_file.isOpen() || _file.close(report)) && success;
 }
 
 
@@ -158,22 +415,31 @@ bool ts::TimeShiftBuffer::shift(TSPacket& packet, TSPacketMetadata& mdata, Repor
     assert(_next_read < _total_packets);
     assert(_next_write < _total_packets);
 
-    if (memoryResident()) {
-        // The buffer is entirely memory-resident in _wcache.
-        assert(_wcache.size() == _total_packets);
+    if (_packets != nullptr) {
+        // The buffer is entirely in memory, either resident in _wcache or in a mapped file.
         if (was_full) {
             // Buffer full: return oldest packet.
-            ret_packet = _wcache[_next_read];
-            ret_mdata = _wmdata[_next_read];
-            _next_read = (_next_read + 1) % _wcache.size();
+            ret_packet = _packets[_next_read];
+            ret_mdata = _mdata[_next_read];
+            _next_read = (_next_read + 1) % _total_packets;
+            // Prepare the next window to read in a mapped file.
+            if (_map_base != nullptr && _next_read % MAP_WINDOW_PACKETS == 0) {
+                prefetch(_next_read);
+            }
         }
         else {
             // Buffer not full, increase the packet count.
             _cur_packets++;
         }
-        _wcache[_next_write] = packet;
-        _wmdata[_next_write] = mdata;
-        _next_write = (_next_write + 1) % _wcache.size();
+        _packets[_next_write] = packet;
+        _mdata[_next_write] = mdata;
+        _next_write = (_next_write + 1) % _total_packets;
+        // Save the state in the mapped file, after the packet.
+        if (_map_header != nullptr) {
+            _map_header->cur_packets = _cur_packets;
+            _map_header->next_read = _next_read;
+            _map_header->next_write = _next_write;
+        }
     }
     else {
         // The buffer uses a backup file.
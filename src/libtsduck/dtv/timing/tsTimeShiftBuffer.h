@@ -23,9 +23,19 @@ namespace ts {
 
     //!
     //! A TS packet buffer for time shift.
-    //! The buffer is partly implemented in virtual memory and partly on disk.
     //! @ingroup mpeg
     //!
+    //! By default, the buffer is partly implemented in virtual memory and partly on disk.
+    //! A small number of packets is cached in memory and the rest of the buffer is read
+    //! and written in a backup file.
+    //!
+    //! Alternatively, the backup file can be mapped in memory (see setMemoryMapped()).
+    //! The disk space of the file is allocated when the buffer is opened and shifting
+    //! packets is a memory copy. The system pages the buffer in and out of the file.
+    //! The mapped file can be made persistent (see setPersistentFile()) so that the
+    //! content of the buffer survives a restart of the application. Memory-mapped files
+    //! are currently supported on UNIX systems only.
+    //!
     class TSDUCKDLL TimeShiftBuffer
     {
         TS_NOCOPY(TimeShiftBuffer);
@@ -46,6 +56,10 @@ namespace ts {
         //! Default number of cached packets in memory.
         //!
         static constexpr size_t DEFAULT_MEMORY_PACKETS = 128;
+        //!
+        //! Number of packets in the windows of a memory-mapped file which are prefetched from disk.
+        //!
+        static constexpr size_t MAP_WINDOW_PACKETS = 16 * 1024;
 
         //!
         //! Constructor.
@@ -86,6 +100,38 @@ namespace ts {
         //!
         bool setBackupDirectory(const fs::path& directory);
 
+        //!
+        //! Use a memory-mapped backup file.
+        //! Must be called before open().
+        //! When the buffer is not entirely resident in memory, the complete backup file
+        //! is mapped in memory instead of using read and write caches. The file is still
+        //! temporary and created in the backup directory.
+        //! @param [in] on True to use a memory-mapped backup file.
+        //! @return True on success, false if already open.
+        //!
+        bool setMemoryMapped(bool on);
+
+        //!
+        //! Use a persistent memory-mapped backup file.
+        //! Must be called before open().
+        //! The buffer is always backed by this file, which is mapped in memory and not deleted on close.
+        //! When the file already exists and contains a buffer with the same size, the buffer is
+        //! resumed with the previous content and state. Otherwise, the file is reinitialized.
+        //! The file is exclusively locked while the buffer is open. Opening the buffer fails
+        //! when the file is already used by another process.
+        //! @param [in] filename Name of the persistent file. If empty, use a temporary backup file.
+        //! @return True on success, false if already open.
+        //!
+        bool setPersistentFile(const fs::path& filename);
+
+        //!
+        //! Get the size in packets of the buffer in an existing persistent file.
+        //! @param [in] filename Name of the persistent file.
+        //! @return The total size in packets of the time-shift buffer in the file
+        //! or zero if the file does not exist or is not a valid time-shift file.
+        //!
+        static size_t PersistentFileSize(const fs::path& filename);
+
         //!
         //! Open the buffer.
         //! @param [in,out] report Where to report errors.
@@ -135,7 +181,19 @@ namespace ts {
         //! Check if the buffer is completely memory resident.
         //! @return True when the buffer is memory resident, false when it is backup by a file.
         //!
-        bool memoryResident() const { return _total_packets <= _mem_packets; }
+        bool memoryResident() const { return _total_packets <= _mem_packets && _persistent_file.empty(); }
+
+        //!
+        //! Check if the buffer is backed by a memory-mapped file.
+        //! @return True when the buffer is open and backed by a memory-mapped file.
+        //!
+        bool memoryMapped() const { return _map_base != nullptr; }
+
+        //!
+        //! Check if the buffer content was resumed from a persistent file when it was opened.
+        //! @return True if the buffer content was resumed from a persistent file.
+        //!
+        bool resumed() const { return _resumed; }
 
         //!
         //! Push a packet in the time-shift buffer and pull the oldest one.
@@ -155,7 +213,13 @@ namespace ts {
         bool shift(TSPacket& packet, TSPacketMetadata& metadata, Report& report);
 
     private:
+        // Header of a memory-mapped file, defined in implementation.
+        struct MapHeader;
+
         bool     _is_open = false;          // Buffer is open.
+        bool     _use_map = false;          // Use a memory-mapped backup file.
+        bool     _resumed = false;          // Buffer content was resumed from a persistent file.
+        fs::path _persistent_file {};       // Persistent memory-mapped file.
         size_t   _cur_packets = 0;          // Current number of packets in the buffer.
         size_t   _total_packets = DEFAULT_TOTAL_PACKETS; // Total capacity of the buffer.
         size_t   _mem_packets = DEFAULT_MEMORY_PACKETS;  // Max packets in memory.
@@ -170,6 +234,23 @@ namespace ts {
         TSPacketVector         _rcache {};  // Read cache.
         TSPacketMetadataVector _wmdata {};  // Packet metadata for _wcache.
         TSPacketMetadataVector _rmdata {};  // Packet metadata for _rcache.
+        TSPacket*         _packets = nullptr;    // Complete buffer, in memory or in mapped file, null when using caches.
+        TSPacketMetadata* _mdata = nullptr;      // Packet metadata for _packets.
+        uint8_t*          _map_base = nullptr;   // Base address of mapped file.
+        size_t            _map_size = 0;         // Size of mapped file.
+        MapHeader*        _map_header = nullptr; // Header of mapped file.
+#if defined(TS_UNIX)
+        int               _map_fd = -1;          // File descriptor of mapped file, holds the lock.
+#endif
+
+        // Compute the layout of a memory-mapped file. Return the file size.
+        static size_t MapLayout(size_t total_packets, size_t& mdata_offset);
+
+        // Create or resume the memory-mapped file.
+        bool mapFile(const fs::path& filename, bool temporary, Report& report);
+
+        // Give hints to the system on the next window of the memory-mapped file to read.
+        void prefetch(size_t index);
 
         // Seek, read, write in the backup file.
         bool seekFile(size_t index, Report& report);
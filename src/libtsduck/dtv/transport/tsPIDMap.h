@@ -0,0 +1,384 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Dense PID-indexed associative container.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTS.h"
+
+namespace ts {
+    //!
+    //! Dense PID-indexed associative container.
+    //! @ingroup mpeg
+    //!
+    //! This class is a replacement for std::map<PID,T> in packet processing paths.
+    //! The interface is a subset of std::map and can be used the same way:
+    //! the elements are pairs with a @c first field (the PID) and a @c second field
+    //! (the associated object) and they are iterated in increasing order of PID.
+    //!
+    //! Differences with std::map:
+    //! - Accessing the element of a PID is a direct O(1) indexing in a table of PID_MAX slots,
+    //!   instead of a search in a tree.
+    //! - Iterating over the elements uses a bitmap of the existing PID's, only existing
+    //!   elements are visited.
+    //! - The table of slots is allocated on the first insertion. The elements are allocated
+    //!   individually, when they are first accessed. Pointers and references to elements
+    //!   remain valid until the element is erased, as with std::map.
+    //! - PID values out of range (PID_MAX and above) are never found and cannot be inserted.
+    //!
+    //! @tparam T The type of objects which are associated with PID's.
+    //!
+    template <typename T>
+    class PIDMap
+    {
+    public:
+        using key_type = PID;                        //!< Type of the keys, always PID.
+        using mapped_type = T;                       //!< Type of the associated objects.
+        using value_type = std::pair<const PID, T>;  //!< Type of the elements.
+        using size_type = size_t;                    //!< Type of sizes.
+
+    private:
+        // Generic iterator, const or not.
+        template <typename MAP, typename VALUE>
+        class Iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::remove_const_t<VALUE>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = VALUE*;
+            using reference = VALUE&;
+
+            Iterator() = default;
+            Iterator(MAP* map, size_t pid) : _map(map), _pid(pid) {}
+            template <typename M, typename V> requires std::is_convertible_v<V*, VALUE*>
+            Iterator(const Iterator<M,V>& other) : _map(other._map), _pid(other._pid) {}
+
+            reference operator*() const { return *_map->_slots[_pid]; }
+            pointer operator->() const { return _map->_slots[_pid]; }
+            Iterator& operator++() { _pid = _map->nextPID(_pid + 1); return *this; }
+            Iterator operator++(int) { Iterator tmp(*this); ++*this; return tmp; }
+            template <typename M, typename V>
+            bool operator==(const Iterator<M,V>& other) const { return _pid == other._pid; }
+
+        private:
+            template <typename M, typename V> friend class Iterator;
+            friend class PIDMap;
+            MAP*   _map = nullptr;
+            size_t _pid = PID_MAX;
+        };
+
+    public:
+        using iterator = Iterator<PIDMap, value_type>;                    //!< Iterator type.
+        using const_iterator = Iterator<const PIDMap, const value_type>;  //!< Constant iterator type.
+
+        //!
+        //! Default constructor, an empty map.
+        //!
+        PIDMap() = default;
+
+        //!
+        //! Copy constructor.
+        //! @param [in] other Another instance to copy.
+        //!
+        PIDMap(const PIDMap& other);
+
+        //!
+        //! Move constructor.
+        //! @param [in,out] other Another instance to move. Left empty.
+        //!
+        PIDMap(PIDMap&& other) noexcept { swap(other); }
+
+        //!
+        //! Destructor.
+        //!
+        ~PIDMap() { clear(); }
+
+        //!
+        //! Assignment operator.
+        //! @param [in] other Another instance to copy.
+        //! @return A reference to this object.
+        //!
+        PIDMap& operator=(const PIDMap& other);
+
+        //!
+        //! Move assignment operator.
+        //! @param [in,out] other Another instance to move. Left empty.
+        //! @return A reference to this object.
+        //!
+        PIDMap& operator=(PIDMap&& other) noexcept { clear(); swap(other); return *this; }
+
+        //!
+        //! Swap the content of two maps.
+        //! @param [in,out] other Another instance to swap with.
+        //!
+        void swap(PIDMap& other) noexcept;
+
+        //!
+        //! Get the number of elements in the map.
+        //! @return The number of elements in the map.
+        //!
+        size_type size() const { return _size; }
+
+        //!
+        //! Check if the map is empty.
+        //! @return True if the map is empty.
+        //!
+        bool empty() const { return _size == 0; }
+
+        //!
+        //! Check if a PID is present in the map.
+        //! @param [in] pid The PID to check.
+        //! @return True if @a pid is present in the map.
+        //!
+        bool contains(PID pid) const { return pid < PID_MAX && (_bitmap[pid / 64] & (uint64_t(1) << (pid % 64))) != 0; }
+
+        //!
+        //! Count the number of elements for a PID, as in std::map.
+        //! @param [in] pid The PID to check.
+        //! @return 1 if @a pid is present in the map, 0 otherwise.
+        //!
+        size_type count(PID pid) const { return contains(pid) ? 1 : 0; }
+
+        //!
+        //! Get a pointer to the object which is associated with a PID, if there is one.
+        //! @param [in] pid The PID to search.
+        //! @return A pointer to the object or a null pointer if @a pid is not present.
+        //!
+        T* value(PID pid) { return contains(pid) ? &_slots[pid]->second : nullptr; }
+
+        //!
+        //! Get a constant pointer to the object which is associated with a PID, if there is one.
+        //! @param [in] pid The PID to search.
+        //! @return A pointer to the object or a null pointer if @a pid is not present.
+        //!
+        const T* value(PID pid) const { return contains(pid) ? &_slots[pid]->second : nullptr; }
+
+        //!
+        //! Access or create the object which is associated with a PID.
+        //! If the PID is not present, a default-constructed object is inserted.
+        //! @param [in] pid The PID to access. Must be lower than PID_MAX.
+        //! @return A reference to the associated object.
+        //!
+        T& operator[](PID pid) { return emplace(pid).first->second; }
+
+        //!
+        //! Find the element for a PID.
+        //! @param [in] pid The PID to search.
+        //! @return An iterator to the element or end() if @a pid is not present.
+        //!
+        iterator find(PID pid) { return iterator(this, contains(pid) ? pid : PID_MAX); }
+
+        //!
+        //! Find the element for a PID.
+        //! @param [in] pid The PID to search.
+        //! @return A constant iterator to the element or end() if @a pid is not present.
+        //!
+        const_iterator find(PID pid) const { return const_iterator(this, contains(pid) ? pid : PID_MAX); }
+
+        //!
+        //! Construct the object for a PID if not already present.
+        //! @param [in] pid The PID to insert. Must be lower than PID_MAX.
+        //! @param [in] args Arguments to the constructor of the object, when it does not exist.
+        //! @return A pair containing an iterator to the element and a boolean which is true when the element was inserted.
+        //!
+        template <typename... Args>
+        std::pair<iterator, bool> emplace(PID pid, Args&&... args);
+
+        //!
+        //! Insert an element if its PID is not already present.
+        //! @param [in] value The element to insert.
+        //! @return A pair containing an iterator to the element and a boolean which is true when the element was inserted.
+        //!
+        std::pair<iterator, bool> insert(const value_type& value) { return emplace(value.first, value.second); }
+
+        //!
+        //! Erase the element for a PID.
+        //! @param [in] pid The PID to erase.
+        //! @return The number of erased elements, 0 or 1.
+        //!
+        size_type erase(PID pid);
+
+        //!
+        //! Erase the element at an iterator position.
+        //! @param [in] pos Position of the element to erase.
+        //! @return An iterator to the next element.
+        //!
+        iterator erase(const_iterator pos);
+
+        //!
+        //! Erase all elements.
+        //! The table of slots is kept for future use.
+        //!
+        void clear();
+
+        //!
+        //! Get the set of PID's which are present in the map.
+        //! @return The set of PID's which are present in the map.
+        //!
+        PIDSet pidSet() const;
+
+        //!
+        //! Iterator to the first element, in PID order.
+        //! @return An iterator to the first element.
+        //!
+        iterator begin() { return iterator(this, nextPID(0)); }
+
+        //!
+        //! Iterator after the last element.
+        //! @return An iterator after the last element.
+        //!
+        iterator end() { return iterator(this, PID_MAX); }
+
+        //!
+        //! Constant iterator to the first element, in PID order.
+        //! @return A constant iterator to the first element.
+        //!
+        const_iterator begin() const { return const_iterator(this, nextPID(0)); }
+
+        //!
+        //! Constant iterator after the last element.
+        //! @return A constant iterator after the last element.
+        //!
+        const_iterator end() const { return const_iterator(this, PID_MAX); }
+
+        //!
+        //! Constant iterator to the first element, in PID order.
+        //! @return A constant iterator to the first element.
+        //!
+        const_iterator cbegin() const { return begin(); }
+
+        //!
+        //! Constant iterator after the last element.
+        //! @return A constant iterator after the last element.
+        //!
+        const_iterator cend() const { return end(); }
+
+    private:
+        static constexpr size_t WORDS = PID_MAX / 64;
+        std::vector<value_type*>     _slots {};    // PID_MAX pointers, allocated on first insertion.
+        std::array<uint64_t, WORDS>  _bitmap {};   // Bitmap of existing PID's.
+        size_type                    _size = 0;    // Number of elements.
+
+        // Get the first existing PID which is greater than or equal to 'pid'. Return PID_MAX if there is none.
+        size_t nextPID(size_t pid) const;
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Template definitions.
+//----------------------------------------------------------------------------
+
+template <typename T>
+ts::PIDMap<T>::PIDMap(const PIDMap& other)
+{
+    for (const auto& it : other) {
+        emplace(it.first, it.second);
+    }
+}
+
+template <typename T>
+ts::PIDMap<T>& ts::PIDMap<T>::operator=(const PIDMap& other)
+{
+    if (&other != this) {
+        clear();
+        for (const auto& it : other) {
+            emplace(it.first, it.second);
+        }
+    }
+    return *this;
+}
+
+template <typename T>
+void ts::PIDMap<T>::swap(PIDMap& other) noexcept
+{
+    _slots.swap(other._slots);
+    _bitmap.swap(other._bitmap);
+    std::swap(_size, other._size);
+}
+
+template <typename T>
+template <typename... Args>
+std::pair<typename ts::PIDMap<T>::iterator, bool> ts::PIDMap<T>::emplace(PID pid, Args&&... args)
+{
+    assert(pid < PID_MAX);
+    if (contains(pid)) {
+        return std::make_pair(iterator(this, pid), false);
+    }
+    if (_slots.empty()) {
+        _slots.resize(PID_MAX, nullptr);
+    }
+    _slots[pid] = new value_type(std::piecewise_construct, std::forward_as_tuple(pid), std::forward_as_tuple(std::forward<Args>(args)...));
+    _bitmap[pid / 64] |= uint64_t(1) << (pid % 64);
+    _size++;
+    return std::make_pair(iterator(this, pid), true);
+}
+
+template <typename T>
+typename ts::PIDMap<T>::size_type ts::PIDMap<T>::erase(PID pid)
+{
+    if (!contains(pid)) {
+        return 0;
+    }
+    _bitmap[pid / 64] &= ~(uint64_t(1) << (pid % 64));
+    _size--;
+    delete _slots[pid];
+    _slots[pid] = nullptr;
+    return 1;
+}
+
+template <typename T>
+typename ts::PIDMap<T>::iterator ts::PIDMap<T>::erase(const_iterator pos)
+{
+    const size_t pid = pos._pid;
+    if (pid < PID_MAX) {
+        erase(PID(pid));
+    }
+    return iterator(this, nextPID(pid + 1));
+}
+
+template <typename T>
+void ts::PIDMap<T>::clear()
+{
+    // Only visit existing elements.
+    for (size_t pid = nextPID(0); pid < PID_MAX; pid = nextPID(pid + 1)) {
+        delete _slots[pid];
+        _slots[pid] = nullptr;
+    }
+    _bitmap.fill(0);
+    _size = 0;
+}
+
+template <typename T>
+ts::PIDSet ts::PIDMap<T>::pidSet() const
+{
+    PIDSet pids;
+    for (size_t pid = nextPID(0); pid < PID_MAX; pid = nextPID(pid + 1)) {
+        pids.set(pid);
+    }
+    return pids;
+}
+
+template <typename T>
+size_t ts::PIDMap<T>::nextPID(size_t pid) const
+{
+    if (_size > 0) {
+        for (size_t index = pid / 64; index < WORDS; ++index) {
+            // Mask bits before 'pid' in its first word.
+            const uint64_t word = index == pid / 64 ? _bitmap[index] & (~uint64_t(0) << (pid % 64)) : _bitmap[index];
+            if (word != 0) {
+                return index * 64 + std::countr_zero(word);
+            }
+        }
+    }
+    return PID_MAX;
+}
@@ -0,0 +1,540 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedPacketRing.h"
+#include "tsNullReport.h"
+
+#if defined(TS_UNIX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <signal.h>
+    #include <unistd.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+
+//----------------------------------------------------------------------------
+// Layout of the shared memory.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Value of the magic number, set by the writer after initialization.
+    constexpr uint32_t RING_MAGIC = 0x54535231;  // "TSR1"
+
+    // Alignment of the areas in the shared memory, a typical cache line size.
+    constexpr size_t RING_ALIGN = 64;
+
+    // State of the writer.
+    constexpr uint32_t WRITER_OPEN   = 0;
+    constexpr uint32_t WRITER_CLOSED = 1;
+
+    // State of a reader slot.
+    constexpr uint32_t SLOT_FREE     = 0;  // Available.
+    constexpr uint32_t SLOT_CLAIMING = 1;  // Being initialized by a new reader.
+    constexpr uint32_t SLOT_ACTIVE   = 2;  // Used by a live reader.
+    constexpr uint32_t SLOT_EVICTED  = 3;  // Reader considered as dead by the writer, can be reused.
+
+    // Number of busy loops before sleeping when waiting for the peer.
+    constexpr size_t SPIN_COUNT = 64;
+    constexpr cn::microseconds POLL_INTERVAL = cn::microseconds(100);
+
+    // Round up to the alignment.
+    constexpr size_t RoundUp(size_t size) { return (size + RING_ALIGN - 1) & ~(RING_ALIGN - 1); }
+
+    // Identifier of the current process.
+    uint64_t CurrentProcessId()
+    {
+#if defined(TS_WINDOWS)
+        return uint64_t(::GetCurrentProcessId());
+#else
+        return uint64_t(::getpid());
+#endif
+    }
+
+    // Check if a process still exists. A process id may be reused after the termination
+    // of a process, this is a best effort check.
+    bool ProcessExists(uint64_t pid)
+    {
+#if defined(TS_WINDOWS)
+        const ::HANDLE handle = ::OpenProcess(SYNCHRONIZE, FALSE, ::DWORD(pid));
+        if (handle == nullptr) {
+            return ::GetLastError() == ERROR_ACCESS_DENIED;
+        }
+        const bool running = ::WaitForSingleObject(handle, 0) == WAIT_TIMEOUT;
+        ::CloseHandle(handle);
+        return running;
+#else
+        return ::kill(::pid_t(pid), 0) == 0 || errno == EPERM;
+#endif
+    }
+
+    // Generate a token which identifies a reader, unique between processes.
+    uint64_t NewToken(const void* address)
+    {
+        static std::atomic<uint64_t> counter {0};
+        return uint64_t(cn::system_clock::now().time_since_epoch().count()) ^ (uint64_t(reinterpret_cast<uintptr_t>(address)) << 16) ^ (++counter << 48);
+    }
+}
+
+// The counters are shared between processes. They must not rely on a lock.
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+// The header of the shared memory.
+struct ts::SharedPacketRing::Header
+{
+    std::atomic<uint32_t> magic {0};             // RING_MAGIC when initialized.
+    uint32_t              metadata_size = 0;     // Size of TSPacketMetadata, detect incompatible versions.
+    uint32_t              max_readers = 0;       // Number of reader slots.
+    uint32_t              policy = 0;            // Policy enum value.
+    uint64_t              capacity = 0;          // Number of packets in the ring.
+    std::atomic<uint32_t> writer_state {WRITER_OPEN};
+    uint64_t              writer_pid = 0;        // Process id of the writer, detect stale segments.
+    alignas(RING_ALIGN)
+    std::atomic<uint64_t> write_reserve {0};     // End of packets being written, always >= write_index.
+    std::atomic<uint64_t> write_index {0};       // End of completely written packets.
+};
+
+// One slot per reader, in separate cache lines.
+struct alignas(RING_ALIGN) ts::SharedPacketRing::ReaderSlot
+{
+    std::atomic<uint32_t> state {SLOT_FREE};
+    std::atomic<uint64_t> owner {0};             // Token of the reader process.
+    std::atomic<uint64_t> read_index {0};        // Next packet to read.
+    std::atomic<int64_t>  heartbeat {0};         // Last activity, in milliseconds since the epoch.
+};
+
+// Compute the layout of the shared memory.
+size_t ts::SharedPacketRing::Layout(size_t capacity, size_t max_readers, size_t& packets_offset, size_t& metadata_offset)
+{
+    packets_offset = RoundUp(RoundUp(sizeof(Header)) + max_readers * sizeof(ReaderSlot));
+    metadata_offset = RoundUp(packets_offset + capacity * PKT_SIZE);
+    return metadata_offset + capacity * sizeof(TSPacketMetadata);
+}
+
+// Map the areas after mapping the shared memory.
+void ts::SharedPacketRing::mapAreas(size_t packets_offset, size_t metadata_offset)
+{
+    uint8_t* const base = reinterpret_cast<uint8_t*>(_shm.address());
+    _header = reinterpret_cast<Header*>(base);
+    _slots = reinterpret_cast<ReaderSlot*>(base + RoundUp(sizeof(Header)));
+    _packets = reinterpret_cast<TSPacket*>(base + packets_offset);
+    _metadata = reinterpret_cast<TSPacketMetadata*>(base + metadata_offset);
+}
+
+
+//----------------------------------------------------------------------------
+// Timing utilities.
+//----------------------------------------------------------------------------
+
+int64_t ts::SharedPacketRing::Now()
+{
+    return cn::duration_cast<cn::milliseconds>(cn::system_clock::now().time_since_epoch()).count();
+}
+
+void ts::SharedPacketRing::Pause(size_t& iteration)
+{
+    if (++iteration < SPIN_COUNT) {
+        std::this_thread::yield();
+    }
+    else {
+        std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+ts::SharedPacketRing::~SharedPacketRing()
+{
+    close(NULLREP);
+}
+
+
+//----------------------------------------------------------------------------
+// Create the ring buffer, as the writer.
+//----------------------------------------------------------------------------
+
+bool ts::SharedPacketRing::create(const UString& name, size_t capacity, size_t max_readers, Policy policy, Report& report)
+{
+    if (isOpen()) {
+        report.error(u"packet ring %s already open", _shm.name());
+        return false;
+    }
+    if (capacity < 2 || max_readers == 0 || max_readers > 0xFFFF) {
+        report.error(u"invalid packet ring size: %'d packets, %'d readers", capacity, max_readers);
+        return false;
+    }
+
+    // A segment which was left by a crashed writer is removed. A segment of a live writer is never replaced.
+    removeStale(name, report);
+
+    size_t packets_offset = 0;
+    size_t metadata_offset = 0;
+    if (!_shm.create(name, Layout(capacity, max_readers, packets_offset, metadata_offset), report)) {
+        return false;
+    }
+    mapAreas(packets_offset, metadata_offset);
+
+    // Initialize the shared memory. The magic number is set last, when everything is ready.
+    new (_header) Header;
+    for (size_t i = 0; i < max_readers; ++i) {
+        new (_slots + i) ReaderSlot;
+    }
+    _header->metadata_size = uint32_t(sizeof(TSPacketMetadata));
+    _header->max_readers = uint32_t(max_readers);
+    _header->policy = uint32_t(policy);
+    _header->capacity = uint64_t(capacity);
+    _header->writer_pid = CurrentProcessId();
+    _header->magic.store(RING_MAGIC, std::memory_order_release);
+
+    _capacity = capacity;
+    _max_readers = max_readers;
+    _slot_index = NPOS;
+    _read_index = 0;
+    _lost_packets = 0;
+    _writer_terminated = false;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Remove a stale ring buffer, left by a terminated writer.
+//----------------------------------------------------------------------------
+
+void ts::SharedPacketRing::removeStale(const UString& name, Report& report)
+{
+    SharedMemory shm;
+    if (shm.open(name, NULLREP)) {
+        const Header* header = reinterpret_cast<const Header*>(shm.address());
+        const bool stale = shm.size() >= sizeof(Header) &&
+            header->magic.load(std::memory_order_acquire) == RING_MAGIC &&
+            header->writer_pid != 0 &&
+            !ProcessExists(header->writer_pid);
+        shm.close(NULLREP);
+        if (stale) {
+            report.verbose(u"removing stale packet ring %s", name);
+            SharedMemory::Remove(name, report);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Open an existing ring buffer, as a reader.
+//----------------------------------------------------------------------------
+
+bool ts::SharedPacketRing::open(const UString& name, Report& report)
+{
+    if (isOpen()) {
+        report.error(u"packet ring %s already open", _shm.name());
+        return false;
+    }
+    if (!_shm.open(name, report)) {
+        return false;
+    }
+
+    // Check the consistency of the shared memory.
+    const Header* header = reinterpret_cast<const Header*>(_shm.address());
+    size_t packets_offset = 0;
+    size_t metadata_offset = 0;
+    if (_shm.size() < sizeof(Header) || header->magic.load(std::memory_order_acquire) != RING_MAGIC) {
+        report.error(u"shared memory %s is not a TS packet ring", name);
+        _shm.close(NULLREP);
+        return false;
+    }
+    if (header->metadata_size != sizeof(TSPacketMetadata)) {
+        report.error(u"packet ring %s was created by an incompatible version of TSDuck", name);
+        _shm.close(NULLREP);
+        return false;
+    }
+    if (_shm.size() < Layout(size_t(header->capacity), size_t(header->max_readers), packets_offset, metadata_offset)) {
+        report.error(u"invalid packet ring %s, shared memory too small", name);
+        _shm.close(NULLREP);
+        return false;
+    }
+    _capacity = size_t(header->capacity);
+    _max_readers = size_t(header->max_readers);
+    _lost_packets = 0;
+    _writer_terminated = false;
+    mapAreas(packets_offset, metadata_offset);
+
+    // Get a reader slot.
+    if (!claimSlot()) {
+        report.error(u"too many readers on packet ring %s, max: %d", name, _max_readers);
+        close(NULLREP);
+        return false;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Claim a reader slot and start from the current write cursor.
+//----------------------------------------------------------------------------
+
+bool ts::SharedPacketRing::claimSlot()
+{
+    _slot_index = NPOS;
+    for (size_t i = 0; i < _max_readers; ++i) {
+        ReaderSlot& slot(_slots[i]);
+        uint32_t state = slot.state.load(std::memory_order_relaxed);
+        if ((state == SLOT_FREE || state == SLOT_EVICTED) && slot.state.compare_exchange_strong(state, SLOT_CLAIMING, std::memory_order_acquire)) {
+            _read_index = _header->write_index.load(std::memory_order_acquire);
+            slot.owner.store(NewToken(this), std::memory_order_relaxed);
+            slot.read_index.store(_read_index, std::memory_order_relaxed);
+            slot.heartbeat.store(Now(), std::memory_order_relaxed);
+            slot.state.store(SLOT_ACTIVE, std::memory_order_release);
+            _slot_index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Close the ring buffer.
+//----------------------------------------------------------------------------
+
+bool ts::SharedPacketRing::close(Report& report)
+{
+    if (!isOpen()) {
+        return true;
+    }
+    if (isWriter()) {
+        // Signal the end of stream to the readers.
+        _header->writer_state.store(WRITER_CLOSED, std::memory_order_release);
+    }
+    else if (_slot_index < _max_readers) {
+        // Release our reader slot, unless it was reused by another reader after eviction.
+        ReaderSlot& slot(_slots[_slot_index]);
+        uint32_t state = SLOT_ACTIVE;
+        slot.state.compare_exchange_strong(state, SLOT_FREE, std::memory_order_release);
+    }
+    _header = nullptr;
+    _slots = nullptr;
+    _packets = nullptr;
+    _metadata = nullptr;
+    _slot_index = NPOS;
+    return _shm.close(report);
+}
+
+
+//----------------------------------------------------------------------------
+// Get the number of active readers.
+//----------------------------------------------------------------------------
+
+size_t ts::SharedPacketRing::readerCount() const
+{
+    size_t count = 0;
+    for (size_t i = 0; isOpen() && i < _max_readers; ++i) {
+        if (_slots[i].state.load(std::memory_order_relaxed) == SLOT_ACTIVE) {
+            count++;
+        }
+    }
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the lowest read cursor of all live readers.
+//----------------------------------------------------------------------------
+
+uint64_t ts::SharedPacketRing::lowestReadIndex(uint64_t write_index)
+{
+    uint64_t lowest = write_index;
+    int64_t now = 0;
+    for (size_t i = 0; i < _max_readers; ++i) {
+        ReaderSlot& slot(_slots[i]);
+        if (slot.state.load(std::memory_order_acquire) == SLOT_ACTIVE) {
+            const uint64_t index = slot.read_index.load(std::memory_order_acquire);
+            if (index < lowest) {
+                // The reader is late. Check if it is still alive.
+                if (now == 0) {
+                    now = Now();
+                }
+                uint32_t state = SLOT_ACTIVE;
+                if (now - slot.heartbeat.load(std::memory_order_relaxed) > _reader_timeout.count() &&
+                    slot.state.compare_exchange_strong(state, SLOT_EVICTED, std::memory_order_relaxed))
+                {
+                    continue;
+                }
+                lowest = index;
+            }
+        }
+    }
+    return lowest;
+}
+
+
+//----------------------------------------------------------------------------
+// Write packets in the ring buffer.
+//----------------------------------------------------------------------------
+
+size_t ts::SharedPacketRing::write(const TSPacket* packets, const TSPacketMetadata* metadata, size_t count, const AbortInterface* abort)
+{
+    if (!isOpen() || !isWriter()) {
+        return 0;
+    }
+
+    const bool wait = _header->policy == uint32_t(Policy::WAIT);
+    size_t done = 0;
+    size_t iteration = 0;
+
+    while (done < count) {
+        // Only the writer modifies the write cursor, no need to synchronize.
+        const uint64_t windex = _header->write_index.load(std::memory_order_relaxed);
+        size_t free = _capacity;
+        if (wait) {
+            free -= size_t(windex - lowestReadIndex(windex));
+            if (free == 0) {
+                if (abort != nullptr && abort->aborting()) {
+                    break;
+                }
+                Pause(iteration);
+                continue;
+            }
+        }
+        iteration = 0;
+        const size_t n = std::min(free, count - done);
+
+        // Readers which were late detect the overwritten packets using write_reserve.
+        _header->write_reserve.store(windex + n, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        // Copy packets and metadata, in at most two parts because of the wrap-around.
+        const size_t first = size_t(windex % _capacity);
+        const size_t n1 = std::min(n, _capacity - first);
+        TSPacket::Copy(_packets + first, packets + done, n1);
+        TSPacket::Copy(_packets, packets + done + n1, n - n1);
+        if (metadata != nullptr) {
+            TSPacketMetadata::Copy(_metadata + first, metadata + done, n1);
+            TSPacketMetadata::Copy(_metadata, metadata + done + n1, n - n1);
+        }
+        else {
+            TSPacketMetadata::Reset(_metadata + first, n1);
+            TSPacketMetadata::Reset(_metadata, n - n1);
+        }
+
+        // Publish the new packets.
+        _header->write_index.store(windex + n, std::memory_order_release);
+        done += n;
+    }
+    return done;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if the end of stream was reached.
+//----------------------------------------------------------------------------
+
+bool ts::SharedPacketRing::endOfStream() const
+{
+    return !isOpen() ||
+        (_header->writer_state.load(std::memory_order_acquire) == WRITER_CLOSED &&
+         _read_index >= _header->write_index.load(std::memory_order_acquire));
+}
+
+
+//----------------------------------------------------------------------------
+// Read packets from the ring buffer.
+//----------------------------------------------------------------------------
+
+size_t ts::SharedPacketRing::read(TSPacket* packets, TSPacketMetadata* metadata, size_t max_count, const AbortInterface* abort, cn::milliseconds timeout)
+{
+    if (!isOpen() || isWriter() || max_count == 0) {
+        return 0;
+    }
+
+    const cn::steady_clock::time_point deadline(cn::steady_clock::now() + timeout);
+    size_t iteration = 0;
+
+    for (;;) {
+        ReaderSlot* slot = _slot_index < _max_readers ? &_slots[_slot_index] : nullptr;
+        const uint64_t windex = _header->write_index.load(std::memory_order_acquire);
+
+        // If we were evicted by the writer, restart from the current position, our packets are lost.
+        if (slot == nullptr || slot->state.load(std::memory_order_acquire) != SLOT_ACTIVE) {
+            const uint64_t previous = _read_index;
+            if (!claimSlot()) {
+                return 0;
+            }
+            _lost_packets += _read_index - previous;
+            continue;
+        }
+
+        if (_read_index >= windex) {
+            // Nothing to read. Check end of stream, timeout and abort.
+            if (_header->writer_state.load(std::memory_order_acquire) == WRITER_CLOSED &&
+                _read_index >= _header->write_index.load(std::memory_order_acquire))
+            {
+                return 0;
+            }
+            if ((abort != nullptr && abort->aborting()) || (timeout > cn::milliseconds::zero() && cn::steady_clock::now() >= deadline)) {
+                return 0;
+            }
+            if (iteration % SPIN_COUNT == 0) {
+                slot->heartbeat.store(Now(), std::memory_order_relaxed);
+                // Don't wait forever for a writer which terminated without closing the ring buffer.
+                if (!ProcessExists(_header->writer_pid)) {
+                    _writer_terminated = true;
+                    return 0;
+                }
+            }
+            Pause(iteration);
+            continue;
+        }
+
+        // If we are more than a full ring late, skip to the most recent packets.
+        if (windex - _read_index > _capacity) {
+            _lost_packets += windex - _read_index;
+            _read_index = windex;
+            slot->read_index.store(_read_index, std::memory_order_release);
+            continue;
+        }
+
+        // Copy packets and metadata, in at most two parts because of the wrap-around.
+        size_t n = std::min(max_count, size_t(windex - _read_index));
+        const size_t first = size_t(_read_index % _capacity);
+        const size_t n1 = std::min(n, _capacity - first);
+        TSPacket::Copy(packets, _packets + first, n1);
+        TSPacket::Copy(packets + n1, _packets, n - n1);
+        if (metadata != nullptr) {
+            TSPacketMetadata::Copy(metadata, _metadata + first, n1);
+            TSPacketMetadata::Copy(metadata + n1, _metadata, n - n1);
+        }
+
+        // Check if the writer overwrote some of these packets while we were copying them (DROP policy
+        // or after eviction). Only the packets at or after write_reserve - capacity are reliable.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t reserve = _header->write_reserve.load(std::memory_order_relaxed);
+        if (reserve > _read_index + _capacity) {
+            const size_t lost = size_t(std::min<uint64_t>(n, reserve - _capacity - _read_index));
+            _lost_packets += lost;
+            _read_index += lost;
+            n -= lost;
+            if (n > 0) {
+                std::memmove(packets, packets + lost, n * PKT_SIZE);
+                if (metadata != nullptr) {
+                    std::memmove(static_cast<void*>(metadata), metadata + lost, n * sizeof(TSPacketMetadata));
+                }
+            }
+        }
+
+        // Release the space in the ring.
+        _read_index += n;
+        slot->read_index.store(_read_index, std::memory_order_release);
+        slot->heartbeat.store(Now(), std::memory_order_relaxed);
+
+        if (n > 0) {
+            return n;
+        }
+    }
+}
@@ -0,0 +1,220 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Ring buffer of TS packets in shared memory, between processes.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsSharedMemory.h"
+#include "tsTSPacket.h"
+#include "tsTSPacketMetadata.h"
+#include "tsAbortInterface.h"
+
+namespace ts {
+    //!
+    //! Ring buffer of TS packets and their metadata in a named shared memory segment.
+    //! @ingroup mpeg
+    //!
+    //! The ring buffer is used to transfer TS packets from one writer process to one or
+    //! more reader processes on the same host, without system call. The writer process
+    //! creates the ring buffer. The reader processes open it using the same name.
+    //! Each reader receives all packets (fan-out).
+    //!
+    //! The read and write cursors are lock-free atomic counters in the shared memory.
+    //! When the ring buffer is empty, a reader waits by polling the write cursor.
+    //!
+    //! When a reader is slower than the writer, two policies are possible:
+    //! - WAIT: the writer waits for the slowest reader (back-pressure). Readers which
+    //!   do not read packets for a long time (see setReaderTimeout()) are considered
+    //!   as dead and ignored.
+    //! - DROP: the writer never waits. A slow reader loses the overwritten packets and
+    //!   resynchronizes on the most recent packets.
+    //!
+    //! The writer process id is stored in the shared memory. A reader stops waiting for
+    //! packets when the writer process terminated without closing the ring buffer. When
+    //! a writer creates a ring buffer, a segment with the same name which was left by a
+    //! terminated writer is removed. A ring buffer of a live writer is never replaced.
+    //! Since process ids can be reused by the system, this detection is only a best effort.
+    //!
+    //! The layout of the shared memory depends on the binary representation of the
+    //! metadata. Therefore, all processes must use the same version of TSDuck.
+    //!
+    class TSDUCKDLL SharedPacketRing
+    {
+        TS_NOCOPY(SharedPacketRing);
+    public:
+        //!
+        //! Policy of the writer when a reader is too slow.
+        //!
+        enum class Policy : uint32_t {
+            WAIT = 0,  //!< Wait for the slowest reader (back-pressure).
+            DROP = 1,  //!< Never wait, slow readers lose packets.
+        };
+
+        static constexpr size_t DEFAULT_CAPACITY = 50'000;  //!< Default ring buffer size in packets.
+        static constexpr size_t DEFAULT_MAX_READERS = 16;   //!< Default maximum number of simultaneous readers.
+        static constexpr cn::milliseconds DEFAULT_READER_TIMEOUT = cn::seconds(5);  //!< Default inactivity timeout of readers.
+
+        //!
+        //! Default constructor.
+        //!
+        SharedPacketRing() = default;
+
+        //!
+        //! Destructor.
+        //!
+        ~SharedPacketRing();
+
+        //!
+        //! Create the ring buffer, as the writer.
+        //! @param [in] name Name of the shared memory segment.
+        //! @param [in] capacity Size of the ring buffer in packets.
+        //! @param [in] max_readers Maximum number of simultaneous readers.
+        //! @param [in] policy Policy of the writer when a reader is too slow.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool create(const UString& name, size_t capacity, size_t max_readers, Policy policy, Report& report = CERR);
+
+        //!
+        //! Open an existing ring buffer, as a reader.
+        //! The reader starts with the next packet which is written.
+        //! @param [in] name Name of the shared memory segment.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool open(const UString& name, Report& report = CERR);
+
+        //!
+        //! Close the ring buffer.
+        //! When the writer closes the ring buffer, the readers get an end of stream
+        //! after reading the remaining packets.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool close(Report& report = CERR);
+
+        //!
+        //! Check if the ring buffer is open.
+        //! @return True if the ring buffer is open.
+        //!
+        bool isOpen() const { return _header != nullptr; }
+
+        //!
+        //! Check if this object is the writer of the ring buffer.
+        //! @return True if this object is the writer.
+        //!
+        bool isWriter() const { return _shm.isOwner(); }
+
+        //!
+        //! Set the inactivity timeout of readers.
+        //! With the WAIT policy, the writer ignores the readers which did not read packets
+        //! for that duration. This avoids blocking the writer forever when a reader is dead.
+        //! @param [in] timeout Inactivity timeout.
+        //!
+        void setReaderTimeout(cn::milliseconds timeout) { _reader_timeout = timeout; }
+
+        //!
+        //! Write packets in the ring buffer (writer only).
+        //! With the WAIT policy, the method waits until there is enough space for all packets.
+        //! @param [in] packets Address of the packets to write.
+        //! @param [in] metadata Address of the packet metadata. If null, default metadata are written.
+        //! @param [in] count Number of packets to write.
+        //! @param [in] abort If not null, invoked regularly while waiting for free space.
+        //! @return The number of written packets. Less than @a count only on abort or error.
+        //!
+        size_t write(const TSPacket* packets, const TSPacketMetadata* metadata, size_t count, const AbortInterface* abort = nullptr);
+
+        //!
+        //! Read packets from the ring buffer (reader only).
+        //! The method waits until at least one packet is available.
+        //! @param [out] packets Address of the packet buffer.
+        //! @param [out] metadata Address of the packet metadata buffer. Can be null.
+        //! @param [in] max_count Maximum number of packets to read.
+        //! @param [in] abort If not null, invoked regularly while waiting for packets.
+        //! @param [in] timeout Maximum time to wait for packets. Zero means infinite.
+        //! @return The number of read packets. Zero at end of stream (the writer closed the
+        //! ring buffer and all packets were read), when the writer process terminated
+        //! without closing the ring buffer, on timeout, on abort or on error.
+        //!
+        size_t read(TSPacket* packets, TSPacketMetadata* metadata, size_t max_count, const AbortInterface* abort = nullptr, cn::milliseconds timeout = cn::milliseconds::zero());
+
+        //!
+        //! Check if the end of stream was reached (reader only).
+        //! @return True if the writer closed the ring buffer and all packets were read.
+        //!
+        bool endOfStream() const;
+
+        //!
+        //! Check if the writer process terminated without closing the ring buffer (reader only).
+        //! @return True if read() detected that the writer process no longer exists.
+        //!
+        bool writerTerminated() const { return _writer_terminated; }
+
+        //!
+        //! Get the number of packets which were lost by this reader.
+        //! Packets are lost when they are overwritten before being read (DROP policy)
+        //! or when the reader was ignored after the inactivity timeout (WAIT policy).
+        //! @return The number of lost packets.
+        //!
+        PacketCounter lostPackets() const { return _lost_packets; }
+
+        //!
+        //! Get the number of active readers.
+        //! @return The number of active readers.
+        //!
+        size_t readerCount() const;
+
+        //!
+        //! Get the capacity of the ring buffer.
+        //! @return The size of the ring buffer in packets.
+        //!
+        size_t capacity() const { return _capacity; }
+
+    private:
+        // Opaque descriptions of the shared memory areas.
+        struct Header;
+        struct ReaderSlot;
+
+        SharedMemory     _shm {};
+        Header*          _header = nullptr;
+        ReaderSlot*      _slots = nullptr;
+        TSPacket*        _packets = nullptr;
+        TSPacketMetadata* _metadata = nullptr;
+        size_t           _capacity = 0;
+        size_t           _max_readers = 0;
+        size_t           _slot_index = NPOS;   // Index of reader slot, NPOS for the writer.
+        uint64_t         _read_index = 0;      // Reader cursor, local copy.
+        PacketCounter    _lost_packets = 0;
+        bool             _writer_terminated = false;
+        cn::milliseconds _reader_timeout = DEFAULT_READER_TIMEOUT;
+
+        // Compute the layout of the shared memory. Return the total size.
+        static size_t Layout(size_t capacity, size_t max_readers, size_t& packets_offset, size_t& metadata_offset);
+
+        // Remove a ring buffer with the same name which was left by a terminated writer.
+        static void removeStale(const UString& name, Report& report);
+
+        // Map the areas after mapping the shared memory.
+        void mapAreas(size_t packets_offset, size_t metadata_offset);
+
+        // Claim a reader slot and start from the current write cursor. Return false if there is no free slot.
+        bool claimSlot();
+
+        // Get the lowest read cursor of all live readers, or the write cursor if there is none.
+        uint64_t lowestReadIndex(uint64_t write_index);
+
+        // Current time in milliseconds, shared between processes.
+        static int64_t Now();
+
+        // Wait a bit between two polling of the cursors.
+        static void Pause(size_t& iteration);
+    };
+}
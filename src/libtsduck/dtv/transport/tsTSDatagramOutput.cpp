@@ -59,7 +59,8 @@ void ts::TSDatagramOutput::defineArgs(Args& args)
 
         args.option(u"pcr-pid", 0, Args::PIDVAL);
         args.help(u"pcr-pid",
-                  u"With --rtp, specify the PID containing the PCR's which are used as reference for RTP timestamps. "
+                  u"With --rtp or --pcr-based, specify the PID containing the PCR's which are used as reference "
+                  u"for RTP timestamps and datagram pacing. "
                   u"By default, use the first PID containing PCR's.");
 
         args.option(u"start-sequence-number", 0, Args::UINT16);
@@ -123,6 +124,30 @@ void ts::TSDatagramOutput::defineArgs(Args& args)
                   u"Specify the local UDP source port for outgoing packets. "
                   u"By default, a random source port is used.");
 
+        args.option(u"pcr-based");
+        args.help(u"pcr-based",
+                  u"Send each datagram at the time of its position in the stream, as computed from the PCR's "
+                  u"(see also --pcr-pid). Between PCR's, the position is extrapolated using the TS bitrate. "
+                  u"This option regulates the output and reduces the jitter of the datagrams, "
+                  u"for receivers which are sensitive to PCR jitter. "
+                  u"By default, the datagrams are sent as soon as possible.");
+
+        args.option(u"transmit-time", 0, Names({
+            {u"monotonic", TransmitClock::MONOTONIC},
+            {u"tai",       TransmitClock::TAI},
+        }), 0, 1, true);
+        args.help(u"transmit-time", u"clock",
+                  u"With --pcr-based, pass the transmit time of each datagram to the kernel (socket option SO_TXTIME). "
+                  u"Each datagram is passed to the kernel " + UString::Chrono(TRANSMIT_TIME_LEAD, true) + u" in advance "
+                  u"and is sent at its exact transmit time by the queuing discipline of the network interface. "
+                  u"The network interface must use a queuing discipline which supports transmit times. "
+                  u"Otherwise, the datagrams are sent immediately. "
+                  u"The optional value is the reference clock of the transmit times and must be the clock of the queuing discipline. "
+                  u"Use \"monotonic\" (the default) with the \"fq\" queuing discipline. "
+                  u"Use \"tai\" with the \"etf\" queuing discipline when it is configured with \"clockid CLOCK_TAI\". "
+                  u"Datagrams with a transmit time on another clock are dropped by the queuing discipline. "
+                  u"This option is supported on Linux only.");
+
         args.option(u"tos", 's', Args::INTEGER, 0, 1, 1, 255);
         args.help(u"tos",
                   u"Specifies the TOS (Type-Of-Service) socket option. Setting this value "
@@ -166,6 +191,13 @@ bool ts::TSDatagramOutput::loadArgs(DuckContext& duck, Args& args)
         args.getIntValue(_send_bufsize, u"buffer-size", 0);
         _mc_loopback = !args.present(u"disable-multicast-loop");
         _force_mc_local = args.present(u"force-local-multicast-outgoing");
+        _pcr_based = args.present(u"pcr-based");
+        _tx_time = args.present(u"transmit-time");
+        args.getIntValue(_tx_clock, u"transmit-time", TransmitClock::MONOTONIC);
+        if (_tx_time && !_pcr_based) {
+            args.error(u"--transmit-time requires --pcr-based");
+            return false;
+        }
     }
 
     if (bool(_flags & TSDatagramOutputOptions::ALLOW_RS204)) {
@@ -188,11 +220,9 @@ bool ts::TSDatagramOutput::open(Report& report)
     }
 
     // The output buffer is empty.
-    if (_enforce_burst) {
-        _out_buffer.resize(_pkt_burst);
-        _out_buffer_rs.resize(int(_rs204_format) * _pkt_burst);
-        _out_count = 0;
-    }
+    _out_buffer.resize(_pkt_burst);
+    _out_buffer_rs.resize(int(_rs204_format) * _pkt_burst);
+    _out_count = 0;
 
     // Initialize RTP parameters.
     if (_use_rtp) {
@@ -229,7 +259,8 @@ bool ts::TSDatagramOutput::open(Report& report)
             (_force_mc_local && _destination.isMulticast() && _local_addr.hasAddress() && !_sock.setOutgoingMulticast(_local_addr, report)) ||
             (_send_bufsize > 0 && !_sock.setSendBufferSize(_send_bufsize, report)) ||
             (_tos >= 0 && !_sock.setTOS(_tos, report)) ||
-            (_ttl > 0 && !_sock.setTTL(_ttl, report)))
+            (_ttl > 0 && !_sock.setTTL(_ttl, report)) ||
+            (_tx_time && !_sock.setTransmitTime(_tx_clock, report)))
         {
             _sock.close(report);
             return false;
@@ -243,6 +274,8 @@ bool ts::TSDatagramOutput::open(Report& report)
     _last_rtp_pcr_pkt = 0;
     _rtp_pcr_offset = 0;
     _pkt_count = 0;
+    _pacing_started = false;
+    _pacer.resetStatistics();
 
     _is_open = true;
     return true;
@@ -265,6 +298,9 @@ bool ts::TSDatagramOutput::close(const BitRate& bitrate, bool abort, Report& rep
         if (_raw_udp) {
             _sock.close(report);
         }
+        if (_pcr_based) {
+            report.debug(u"datagram pacing: %s", _pacer.statistics());
+        }
         _is_open = false;
     }
     return success;
@@ -277,7 +313,6 @@ bool ts::TSDatagramOutput::close(const BitRate& bitrate, bool abort, Report& rep
 
 void ts::TSDatagramOutput::bufferPackets(const TSPacket* packet, const TSPacketMetadata* metadata, size_t count)
 {
-    assert(_enforce_burst);
     assert(_out_count + count <= _pkt_burst);
 
     TSPacket::Copy(&_out_buffer[_out_count], packet, count);
@@ -374,6 +409,169 @@ bool ts::TSDatagramOutput::send(const TSPacket* pkt, const TSPacketMetadata* met
 }
 
 
+//----------------------------------------------------------------------------
+// Send several ranges of TS packets.
+//----------------------------------------------------------------------------
+
+bool ts::TSDatagramOutput::send(const TSPacketRange* ranges, size_t range_count, const BitRate& bitrate, Report& report)
+{
+    if (!_is_open) {
+        report.error(u"TSDatagramOutput is not open");
+        return false;
+    }
+
+    assert(_pkt_burst > 0);
+    for (size_t i = 0; i < range_count; ++i) {
+        const TSPacket* pkt = ranges[i].packets;
+        const TSPacketMetadata* metadata = ranges[i].metadata;
+        size_t packet_count = ranges[i].count;
+
+        while (packet_count > 0) {
+            size_t count = 0;
+            if (_out_count == 0 && packet_count >= _pkt_burst) {
+                // Send a full datagram directly from the range.
+                count = _pkt_burst;
+                if (!sendPackets(pkt, metadata, count, bitrate, report)) {
+                    return false;
+                }
+            }
+            else {
+                // Pack the packets from several ranges in the output buffer.
+                count = std::min(packet_count, _pkt_burst - _out_count);
+                bufferPackets(pkt, metadata, count);
+                if (_out_count == _pkt_burst) {
+                    if (!sendPackets(_out_buffer.data(), _out_buffer_rs.data(), _out_count, bitrate, report)) {
+                        return false;
+                    }
+                    _out_count = 0;
+                }
+            }
+            pkt += count;
+            if (metadata != nullptr) {
+                metadata += count;
+            }
+            packet_count -= count;
+        }
+    }
+
+    // Without --enforce-burst, don't keep packets for later, send a shorter datagram.
+    if (!_enforce_burst && _out_count > 0) {
+        if (!sendPackets(_out_buffer.data(), _out_buffer_rs.data(), _out_count, bitrate, report)) {
+            return false;
+        }
+        _out_count = 0;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Compute the timestamp of a datagram in PCR units.
+//----------------------------------------------------------------------------
+
+uint64_t ts::TSDatagramOutput::datagramTimestamp(const TSPacket* pkt, size_t packet_count, const BitRate& bitrate, Report& report)
+{
+    // We cannot use the wall clock time because the plugin is likely to burst its output.
+    // So, we try to synchronize timestamps with PCR's from one PID.
+    // But this is not trivial since the PCR may not be accurate or may loop back.
+    // As long as the first PCR is not seen, increment timestamps from zero, using TS bitrate as reference.
+    // At the first PCR, compute the difference between the current timestamp and this PCR.
+    // Then keep this difference and resynchronize at each PCR.
+    // But never jump back in timestamps, only increase "more slowly" when adjusting.
+
+    // Look for a PCR in one of the packets to send.
+    // If found, we adjust this PCR for the first packet in the datagram.
+    uint64_t pcr = INVALID_PCR;
+    for (size_t i = 0; i < packet_count; i++) {
+        const bool hasPCR = pkt[i].hasPCR();
+        const PID pid = pkt[i].getPID();
+
+        // Detect PCR PID if not yet known.
+        if (hasPCR && _pcr_pid == PID_NULL) {
+            _pcr_pid = pid;
+        }
+
+        // Detect PCR presence.
+        if (hasPCR && pid == _pcr_pid) {
+            pcr = pkt[i].getPCR();
+            // If the bitrate is known and the packet containing the PCR is not the first one,
+            // compute the theoretical timestamp of the first packet in the datagram.
+            if (i > 0 && bitrate > 0) {
+                pcr -= ((i * PKT_SIZE_BITS * uint64_t(SYSTEM_CLOCK_FREQ)) / bitrate).toInt();
+            }
+            break;
+        }
+    }
+
+    // Extrapolate the timestamp from the previous one, using current bitrate.
+    // This value may be replaced if a valid PCR is present in this datagram.
+    uint64_t rtp_pcr = _last_rtp_pcr;
+    if (bitrate > 0) {
+        rtp_pcr += (((_pkt_count - _last_rtp_pcr_pkt) * PKT_SIZE_BITS * uint64_t(SYSTEM_CLOCK_FREQ)) / bitrate).toInt();
+    }
+
+    // If the current datagram contains a PCR, recompute the timestamp more precisely.
+    if (pcr != INVALID_PCR) {
+        if (_last_pcr == INVALID_PCR || pcr < _last_pcr) {
+            // This is the first PCR in the stream or the PCR has jumped back in the past.
+            // For this time only, we keep the extrapolated PCR.
+            // Compute the difference between PCR and timestamps.
+            _rtp_pcr_offset = pcr - rtp_pcr;
+            report.verbose(u"%s timestamps resynchronized with PCR PID %n", _use_rtp ? u"RTP" : u"datagram", _pcr_pid);
+            report.debug(u"new PCR-timestamp offset: %d", _rtp_pcr_offset);
+        }
+        else {
+            // PCR are normally increasing, drop extrapolated value, resynchronize with PCR.
+            uint64_t adjusted_rtp_pcr = pcr - _rtp_pcr_offset;
+            if (adjusted_rtp_pcr <= _last_rtp_pcr) {
+                // The adjustment would make the timestamp go backward. We do not want that.
+                // We increase the timestamp "more slowly", by 25% of the extrapolated value.
+                report.debug(u"timestamp adjustment from PCR would step backward by %d", ((_last_rtp_pcr - adjusted_rtp_pcr) * RTP_RATE_MP2T) / SYSTEM_CLOCK_FREQ);
+                adjusted_rtp_pcr = _last_rtp_pcr + (rtp_pcr - _last_rtp_pcr) / 4;
+            }
+            rtp_pcr = adjusted_rtp_pcr;
+        }
+
+        // Keep last PCR value.
+        _last_pcr = pcr;
+    }
+
+    // Remember position and value of last datagram.
+    _last_rtp_pcr = rtp_pcr;
+    _last_rtp_pcr_pkt = _pkt_count;
+    return rtp_pcr;
+}
+
+
+//----------------------------------------------------------------------------
+// With --pcr-based, wait until the due time of a datagram.
+//----------------------------------------------------------------------------
+
+void ts::TSDatagramOutput::pace(uint64_t timestamp, Report& report)
+{
+    const monotonic_time now = monotonic_time::clock::now();
+    const monotonic_time::duration offset = cn::duration_cast<monotonic_time::duration>(PCR(timestamp));
+
+    // The first datagram defines the time origin.
+    if (!_pacing_started) {
+        _pacing_started = true;
+        _pacing_start = now - offset;
+    }
+    _due_time = _pacing_start + offset;
+
+    // If we are late by more than one second, the input was probably interrupted.
+    // Restart the time origin instead of bursting to catch up.
+    if (now - _due_time > cn::seconds(1)) {
+        report.debug(u"datagram pacing late by %s, resynchronizing", cn::duration_cast<cn::milliseconds>(now - _due_time));
+        _pacing_start = now - offset;
+        _due_time = now;
+    }
+
+    // With --transmit-time, the kernel will send the datagram at its due time.
+    _pacer.waitUntil(_tx_time ? _due_time - TRANSMIT_TIME_LEAD : _due_time);
+}
+
+
 //----------------------------------------------------------------------------
 // Send contiguous packets in one single datagram.
 //----------------------------------------------------------------------------
@@ -382,16 +580,16 @@ bool ts::TSDatagramOutput::sendPackets(const TSPacket* pkt, const TSPacketMetada
 {
     bool status = true;
 
-    if (_use_rtp) {
-        // RTP datagram are relatively trivial to build, except the time stamp.
-        // We cannot use the wall clock time because the plugin is likely to burst its output.
-        // So, we try to synchronize RTP timestamps with PCR's from one PID.
-        // But this is not trivial since the PCR may not be accurate or may loop back.
-        // As long as the first PCR is not seen, increment timestamps from zero, using TS bitrate as reference.
-        // At the first PCR, compute the difference between the current RTP timestamp and this PCR.
-        // Then keep this difference and resynchronize at each PCR.
-        // But never jump back in RTP timestamps, only increase "more slowly" when adjusting.
+    // Timestamp of the datagram, in PCR units, for RTP and pacing.
+    uint64_t rtp_pcr = 0;
+    if (_use_rtp || _pcr_based) {
+        rtp_pcr = datagramTimestamp(pkt, packet_count, bitrate, report);
+    }
+    if (_pcr_based) {
+        pace(rtp_pcr, report);
+    }
 
+    if (_use_rtp) {
         // Build an RTP datagram. Use a simple RTP header without options nor extensions.
         ByteBlock buffer(RTP_HEADER_SIZE + packet_count * PKT_RS_SIZE);
 
@@ -401,70 +599,9 @@ bool ts::TSDatagramOutput::sendPackets(const TSPacket* pkt, const TSPacketMetada
         PutUInt16(&buffer[2], _rtp_sequence++);
         PutUInt32(&buffer[8], _rtp_ssrc);
 
-        // Look for a PCR in one of the packets to send.
-        // If found, we adjust this PCR for the first packet in the datagram.
-        uint64_t pcr = INVALID_PCR;
-        for (size_t i = 0; i < packet_count; i++) {
-            const bool hasPCR = pkt[i].hasPCR();
-            const PID pid = pkt[i].getPID();
-
-            // Detect PCR PID if not yet known.
-            if (hasPCR && _pcr_pid == PID_NULL) {
-                _pcr_pid = pid;
-            }
-
-            // Detect PCR presence.
-            if (hasPCR && pid == _pcr_pid) {
-                pcr = pkt[i].getPCR();
-                // If the bitrate is known and the packet containing the PCR is not the first one,
-                // compute the theoretical timestamp of the first packet in the datagram.
-                if (i > 0 && bitrate > 0) {
-                    pcr -= ((i * PKT_SIZE_BITS * uint64_t(SYSTEM_CLOCK_FREQ)) / bitrate).toInt();
-                }
-                break;
-            }
-        }
-
-        // Extrapolate the RTP timestamp from the previous one, using current bitrate.
-        // This value may be replaced if a valid PCR is present in this datagram.
-        uint64_t rtp_pcr = _last_rtp_pcr;
-        if (bitrate > 0) {
-            rtp_pcr += (((_pkt_count - _last_rtp_pcr_pkt) * PKT_SIZE_BITS * uint64_t(SYSTEM_CLOCK_FREQ)) / bitrate).toInt();
-        }
-
-        // If the current datagram contains a PCR, recompute the RTP timestamp more precisely.
-        if (pcr != INVALID_PCR) {
-            if (_last_pcr == INVALID_PCR || pcr < _last_pcr) {
-                // This is the first PCR in the stream or the PCR has jumped back in the past.
-                // For this time only, we keep the extrapolated PCR.
-                // Compute the difference between PCR and RTP timestamps.
-                _rtp_pcr_offset = pcr - rtp_pcr;
-                report.verbose(u"RTP timestamps resynchronized with PCR PID %n", _pcr_pid);
-                report.debug(u"new PCR-RTP offset: %d", _rtp_pcr_offset);
-            }
-            else {
-                // PCR are normally increasing, drop extrapolated value, resynchronize with PCR.
-                uint64_t adjusted_rtp_pcr = pcr - _rtp_pcr_offset;
-                if (adjusted_rtp_pcr <= _last_rtp_pcr) {
-                    // The adjustment would make the RTP timestamp go backward. We do not want that.
-                    // We increase the RTP timestamp "more slowly", by 25% of the extrapolated value.
-                    report.debug(u"RTP adjustment from PCR would step backward by %d", ((_last_rtp_pcr - adjusted_rtp_pcr) * RTP_RATE_MP2T) / SYSTEM_CLOCK_FREQ);
-                    adjusted_rtp_pcr = _last_rtp_pcr + (rtp_pcr - _last_rtp_pcr) / 4;
-                }
-                rtp_pcr = adjusted_rtp_pcr;
-            }
-
-            // Keep last PCR value.
-            _last_pcr = pcr;
-        }
-
         // Insert the RTP timestamp in RTP clock units.
         PutUInt32(&buffer[4], uint32_t((rtp_pcr * RTP_RATE_MP2T) / SYSTEM_CLOCK_FREQ));
 
-        // Remember position and value of last datagram.
-        _last_rtp_pcr = rtp_pcr;
-        _last_rtp_pcr_pkt = _pkt_count;
-
         // Copy the TS packets after the RTP header and send the packets.
         uint8_t* buf = buffer.data() + RTP_HEADER_SIZE;
         if (_rs204_format) {
@@ -503,5 +640,5 @@ bool ts::TSDatagramOutput::sendPackets(const TSPacket* pkt, const TSPacketMetada
 
 bool ts::TSDatagramOutput::sendDatagram(const void* address, size_t size, Report& report)
 {
-    return _sock.send(address, size, report);
+    return _tx_time ? _sock.sendAt(address, size, _due_time, report) : _sock.send(address, size, report);
 }
@@ -15,7 +15,9 @@
 #include "tsTSDatagramOutputHandlerInterface.h"
 #include "tsTSPacket.h"
 #include "tsTSPacketMetadata.h"
+#include "tsTSPacketRange.h"
 #include "tsUDPSocket.h"
+#include "tsPacingTimer.h"
 #include "tsIPProtocols.h"
 #include "tsEnumUtils.h"
 
@@ -60,6 +62,12 @@ namespace ts {
         //!
         static constexpr size_t MAX_PACKET_BURST = 128;
 
+        //!
+        //! With option -\-transmit-time, datagrams are passed to the kernel this time in advance.
+        //! The kernel queuing discipline sends them at their exact transmit time.
+        //!
+        static constexpr cn::milliseconds TRANSMIT_TIME_LEAD = cn::milliseconds(2);
+
         //!
         //! Constructor.
         //! @param [in] flags List of options.
@@ -111,6 +119,19 @@ namespace ts {
         //!
         bool send(const TSPacket* packets, const TSPacketMetadata* metadata, size_t packet_count, const BitRate& bitrate, Report& report);
 
+        //!
+        //! Send several ranges of TS packets, in sequence.
+        //! The packets from all ranges are packed together in full datagrams.
+        //! Without --enforce-burst, the last datagram can be shorter and all packets are sent.
+        //! With --enforce-burst, the remaining packets are buffered and sent later.
+        //! @param [in] ranges Address of an array of packet ranges.
+        //! @param [in] range_count Number of ranges in @a ranges.
+        //! @param [in] bitrate Current bitrate to compute timestamps. Ignored if zero.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool send(const TSPacketRange* ranges, size_t range_count, const BitRate& bitrate, Report& report);
+
         //!
         //! Get the maximum datagram payload size, according to options --packet-burst and --rs204.
         //! @return The maximum datagram payload size.
@@ -134,6 +155,9 @@ namespace ts {
         uint32_t        _rtp_user_ssrc = 0;          // RTP user-specified SSRC id
         PID             _pcr_user_pid = PID_NULL;    // User-specified PCR PID.
         bool            _rs204_format = false;       // Generate packets in 204-byte format.
+        bool            _pcr_based = false;          // Pace datagrams according to PCR's.
+        bool            _tx_time = false;            // Pass transmit time of datagrams to the kernel.
+        TransmitClock   _tx_clock = TransmitClock::MONOTONIC; // Reference clock of transmit time.
 
         // Command line options for raw UDP.
         IPSocketAddress _destination {};             // Destination address/port.
@@ -156,9 +180,13 @@ namespace ts {
         uint64_t        _rtp_pcr_offset = 0;         // Value to substract from PCR to get RTP timestamp
         PacketCounter   _pkt_count = 0;              // Total packet counter for output packets
         size_t          _out_count = 0;              // Number of packets in _out_buffer
-        TSPacketVector  _out_buffer {};              // Buffered packets for output with --enforce-burst
-        TSPacketMetadataVector _out_buffer_rs {};    // Buffered RS trailers with --enforce-burst --rs204
+        TSPacketVector  _out_buffer {};              // Buffered packets for output with --enforce-burst or packet ranges
+        TSPacketMetadataVector _out_buffer_rs {};    // Buffered RS trailers with --rs204
         UDPSocket       _sock {};                    // Outgoing socket for raw UDP
+        PacingTimer     _pacer {};                   // Wait for due time of datagrams with --pcr-based
+        bool            _pacing_started = false;     // First datagram was sent with --pcr-based
+        monotonic_time  _pacing_start {};            // System time of PCR-based timestamp zero
+        monotonic_time  _due_time {};                // Due time of current datagram with --pcr-based
 
         // Implementation of TSDatagramOutputHandlerInterface.
         // The object is its own handler in case of raw UDP output.
@@ -170,6 +198,12 @@ namespace ts {
         // Serialize a set of packets and RS trailers in a buffer.
         void serialize(uint8_t* buffer, size_t buffer_size, const TSPacket* packet, const TSPacketMetadata* metadata, size_t count);
 
+        // Compute the timestamp of a datagram in PCR units, synchronized with PCR's from one PID.
+        uint64_t datagramTimestamp(const TSPacket* packet, size_t count, const BitRate& bitrate, Report& report);
+
+        // With --pcr-based, wait until the due time of a datagram.
+        void pace(uint64_t timestamp, Report& report);
+
         // Send contiguous packets in one single datagram.
         bool sendPackets(const TSPacket* packet, const TSPacketMetadata* metadata, size_t count, const BitRate& bitrate, Report& report);
     };
@@ -51,6 +51,9 @@ ts::TSFile::TSFile(TSFile&& other) noexcept :
     _rewindable(other._rewindable),
     _regular(other._regular),
     _std_inout(other._std_inout),
+    _indexing(other._indexing),
+    _index_loaded(other._index_loaded),
+    _index(std::move(other._index)),
 #if defined(TS_WINDOWS)
     _handle(other._handle)
 #else
@@ -381,9 +384,12 @@ bool ts::TSFile::openInternal(bool reopen, Report& report)
 
 #endif
 
-    // Reset counters only if not a reopen.
+    // Reset counters and index only if not a reopen.
     if (!reopen) {
         _total_read = _total_write = 0;
+        _index.reset();
+        _index_loaded = false;
+        _indexing = write_access && !read_access && !append_access && !temporary && !_std_inout && (_flags & INDEX) != 0;
     }
 
     // Clean initial state.
@@ -452,6 +458,7 @@ bool ts::TSFile::seekInternal(uint64_t index, Report& report)
     }
     else {
         _at_eof = false;
+        discardReadAhead();
         return true;
     }
 }
@@ -472,7 +479,88 @@ bool ts::TSFile::seek(PacketCounter packet_index, Report& report)
         return false;
     }
     else {
-        return seekInternal(packet_index * (packetHeaderSize() + PKT_SIZE), report);
+        return seekInternal(packet_index * (packetHeaderSize() + PKT_SIZE + packetTrailerSize()), report);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Load or build the index of the file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::loadIndex(Report& report, bool save_sidecar)
+{
+    if (!_is_open) {
+        report.log(_severity, u"not open");
+        return false;
+    }
+    else if (_std_inout || !_regular) {
+        report.log(_severity, u"file %s is not a regular file, cannot be indexed", getDisplayFileName());
+        return false;
+    }
+    else if (!_index_loaded) {
+        // When the file is written, the packets are not yet completely written.
+        _index_loaded = (_flags & WRITE) == 0 && _index.loadOrBuild(_filename, save_sidecar, report, packetFormat());
+        if (!_index_loaded) {
+            report.log(_severity, u"cannot index file %s", getDisplayFileName());
+        }
+    }
+    return _index_loaded;
+}
+
+
+//----------------------------------------------------------------------------
+// Seek the file at a specified playout time or PCR value.
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::seekTime(PCR time, Report& report)
+{
+    PacketCounter packet_index = 0;
+    if (!loadIndex(report)) {
+        return false;
+    }
+    else if (!_index.findTime(time, packet_index)) {
+        report.log(_severity, u"time %s not found in %s", time, getDisplayFileName());
+        return false;
+    }
+    else {
+        return seekIndex(packet_index, report);
+    }
+}
+
+bool ts::TSFile::seekPCR(uint64_t pcr, Report& report)
+{
+    PacketCounter packet_index = 0;
+    if (!loadIndex(report)) {
+        return false;
+    }
+    else if (!_index.findPCR(pcr, packet_index)) {
+        report.log(_severity, u"PCR %d not found in %s", pcr, getDisplayFileName());
+        return false;
+    }
+    else {
+        return seekIndex(packet_index, report);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Seek at a packet index from the index, relative to the beginning of the file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::seekIndex(PacketCounter packet_index, Report& report)
+{
+    const uint64_t offset = _index.byteOffset(packet_index);
+    if (!_rewindable) {
+        report.log(_severity, u"file %s is not rewindable", getDisplayFileName());
+        return false;
+    }
+    else if (offset < _start_offset) {
+        report.log(_severity, u"packet %'d is before the start offset in %s", packet_index, getDisplayFileName());
+        return false;
+    }
+    else {
+        return seekInternal(offset - _start_offset, report);
     }
 }
 
@@ -501,14 +589,24 @@ bool ts::TSFile::close(Report& report)
 #endif
     }
 
+    // Save the index of written packets after closing the file, when its size and time are final.
+    bool success = true;
+    if (_indexing && !_aborted) {
+        _index.setPacketSize(packetHeaderSize() + PKT_SIZE + packetTrailerSize());
+        success = _index.save(_filename, report);
+    }
+
     _is_open = false;
     _at_eof = false;
     _aborted = false;
     _flags = NONE;
     _filename.clear();
     _std_inout = false;
+    _indexing = false;
+    _index_loaded = false;
+    _index.reset();
 
-    return true;
+    return success;
 }
 
 
@@ -648,6 +746,41 @@ size_t ts::TSFile::readPackets(TSPacket* buffer, TSPacketMetadata* metadata, siz
 }
 
 
+//----------------------------------------------------------------------------
+// Write TS packets, build the index when necessary.
+// Override TSPacketStream implementation
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::writePackets(const TSPacket* buffer, const TSPacketMetadata* metadata, size_t packet_count, Report& report)
+{
+    const bool success = TSPacketStream::writePackets(buffer, metadata, packet_count, report);
+    if (_indexing) {
+        // Stop indexing on error, the written packets are unknown.
+        _indexing = success;
+        for (size_t i = 0; success && i < packet_count; ++i) {
+            _index.feedPacket(buffer[i]);
+        }
+    }
+    return success;
+}
+
+bool ts::TSFile::writePacketRanges(const TSPacketRange* ranges, size_t range_count, Report& report)
+{
+    // In non-TS formats, the superclass writes the ranges using writePackets(), where the packets are indexed.
+    const bool ts_format = packetFormat() == TSPacketFormat::AUTODETECT || packetFormat() == TSPacketFormat::TS;
+    const bool success = TSPacketStream::writePacketRanges(ranges, range_count, report);
+    if (_indexing && ts_format) {
+        _indexing = success;
+        for (size_t r = 0; success && r < range_count; ++r) {
+            for (size_t i = 0; i < ranges[r].count; ++i) {
+                _index.feedPacket(ranges[r].packets[i]);
+            }
+        }
+    }
+    return success;
+}
+
+
 //----------------------------------------------------------------------------
 // Implementation of AbstractWriteStreamInterface
 //----------------------------------------------------------------------------
@@ -719,6 +852,26 @@ bool ts::TSFile::writeStream(const void* buffer, size_t data_size, size_t& writt
 }
 
 
+bool ts::TSFile::writeStreamChunks(const Chunk* chunks, size_t chunk_count, size_t& written_size, Report& report)
+{
+#if defined(TS_WINDOWS)
+
+    // No vectored write on Windows files, use the default implementation.
+    return AbstractWriteStreamInterface::writeStreamChunks(chunks, chunk_count, written_size, report);
+
+#else
+
+    // UNIX implementation: use writev(). Don't report error on broken pipe.
+    const int errcode = WriteChunksToDescriptor(_fd, chunks, chunk_count, written_size);
+    if (errcode != 0 && errcode != EPIPE) {
+        report.log(_severity, u"error writing %s: %s", getDisplayFileName(), SysErrorCodeMessage(errcode));
+    }
+    return errcode == 0;
+
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Read/write artificial stuffing.
 //----------------------------------------------------------------------------
@@ -13,6 +13,7 @@
 
 #pragma once
 #include "tsTSPacketStream.h"
+#include "tsTSFileIndex.h"
 #include "tsAbstractReadStreamInterface.h"
 #include "tsAbstractWriteStreamInterface.h"
 #include "tsEnumUtils.h"
@@ -93,6 +94,7 @@ namespace ts {
             TEMPORARY   = 0x0020,   //!< Temporary file, deleted on close, not always visible in the file system.
             REOPEN      = 0x0040,   //!< Close and reopen the file instead of rewind to start of file when looping on input file.
             REOPEN_SPEC = 0x0080,   //!< Force REOPEN when the file is not a regular file.
+            INDEX       = 0x0100,   //!< Write a sidecar index file on close. Ignored with READ, APPEND, TEMPORARY or standard output.
         };
 
         //!
@@ -177,8 +179,50 @@ namespace ts {
         //!
         bool seek(PacketCounter packet_index, Report& report);
 
+        //!
+        //! Load or build the index of the file, as used by seekTime() and seekPCR().
+        //! The index is loaded from the sidecar file when it exists and is up to date.
+        //! Otherwise, the index is built by reading the complete file.
+        //! This is automatically done by seekTime() and seekPCR() the first time they are used.
+        //! @param [in,out] report Where to report errors.
+        //! @param [in] save_sidecar If true, save the sidecar file when the index was built.
+        //! @return True on success, false on error.
+        //! @see TSFileIndex
+        //!
+        bool loadIndex(Report& report, bool save_sidecar = false);
+
+        //!
+        //! Get the index of the file.
+        //! @return A constant reference to the index of the file. It is empty when the index was not loaded.
+        //!
+        const TSFileIndex& index() const { return _index; }
+
+        //!
+        //! Seek the file at a specified playout time.
+        //! The file must have been opened in rewindable mode and must be a named file.
+        //! @param [in] time Playout time since the first PCR in the file.
+        //! The index of the file is used to locate the corresponding packet.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //! @see loadIndex()
+        //!
+        bool seekTime(PCR time, Report& report);
+
+        //!
+        //! Seek the file at the first packet with a given PCR value on the reference PCR PID.
+        //! The file must have been opened in rewindable mode and must be a named file.
+        //! @param [in] pcr PCR value, as found in the file.
+        //! The index of the file is used to locate the corresponding packet.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //! @see loadIndex()
+        //!
+        bool seekPCR(uint64_t pcr, Report& report);
+
         // Override TSPacketStream implementation
         virtual size_t readPackets(TSPacket* buffer, TSPacketMetadata* metadata, size_t max_packets, Report& report) override;
+        virtual bool writePackets(const TSPacket* buffer, const TSPacketMetadata* metadata, size_t packet_count, Report& report) override;
+        virtual bool writePacketRanges(const TSPacketRange* ranges, size_t range_count, Report& report) override;
 
     private:
         fs::path      _filename {};          //!< Input file name.
@@ -197,6 +241,9 @@ namespace ts {
         bool          _rewindable = false;   //!< Opened in rewindable mode
         bool          _regular = false;      //!< Is a regular file (ie. not a pipe or special device)
         bool          _std_inout = false;    //!< File is standard input or output.
+        bool          _indexing = false;     //!< Build the index of written packets.
+        bool          _index_loaded = false; //!< The index of the file is loaded.
+        TSFileIndex   _index {};             //!< Index of the file.
 #if defined(TS_WINDOWS)
         ::HANDLE      _handle = INVALID_HANDLE_VALUE;
 #else
@@ -209,6 +256,7 @@ namespace ts {
 
         // Implementation of AbstractWriteStreamInterface
         virtual bool writeStream(const void* addr, size_t size, size_t& written_size, Report& report) override;
+        virtual bool writeStreamChunks(const Chunk* chunks, size_t chunk_count, size_t& written_size, Report& report) override;
 
         // Read/write artificial stuffing.
         void readStuffing(TSPacket*& buffer, TSPacketMetadata*& metadata, size_t count, Report& report);
@@ -218,6 +266,7 @@ namespace ts {
         bool openInternal(bool reopen, Report& report);
         bool seekCheck(Report& report);
         bool seekInternal(uint64_t index, Report& report);
+        bool seekIndex(PacketCounter packet_index, Report& report);
 
         // Inaccessible operations. Same as TS_NOCOPY() except that we keep the move constructor (required for vectors).
         TSFile(const TSFile&) = delete;
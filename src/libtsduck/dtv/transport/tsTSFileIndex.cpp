@@ -0,0 +1,315 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSFileIndex.h"
+#include "tsTSFile.h"
+#include "tsByteBlock.h"
+#include "tsMemory.h"
+#include "tsErrCodeReport.h"
+
+// Layout of a sidecar file. All integers are big endian.
+//
+//   8 bytes  : magic "TSINDEX\0"
+//   4 bytes  : format version
+//   4 bytes  : size in bytes of a packet in the TS file, including header and trailer
+//   8 bytes  : size in bytes of the TS file
+//   8 bytes  : modification time of the TS file (system-specific unit)
+//   8 bytes  : interval between checkpoints in packets
+//   8 bytes  : number of indexed packets
+//   2 bytes  : reference PCR PID
+//   8 bytes  : last PCR interval per packet
+//  24 bytes  : last PCR on the reference PCR PID
+//   8 bytes  : number of checkpoints
+//  24 bytes  : each checkpoint: packet index, PCR value, playout time
+
+namespace {
+    constexpr uint8_t INDEX_MAGIC[8] = {'T', 'S', 'I', 'N', 'D', 'E', 'X', 0};
+    constexpr uint32_t INDEX_VERSION = 1;
+    constexpr size_t INDEX_HEADER_SIZE = 8 + 4 + 4 + 8 + 8 + 8 + 8 + 2 + 8 + 24 + 8;
+    constexpr size_t INDEX_ENTRY_SIZE = 24;
+
+    // Larger intervals between two PCR's are considered as discontinuities.
+    constexpr ts::PCR MAX_PCR_INTERVAL = cn::seconds(1);
+
+    // Number of packets per read operation when building an index.
+    constexpr size_t READ_PACKETS = 1024;
+}
+
+
+//----------------------------------------------------------------------------
+// Constructor and reset.
+//----------------------------------------------------------------------------
+
+ts::TSFileIndex::TSFileIndex(PacketCounter interval) :
+    _interval(std::max<PacketCounter>(interval, 1))
+{
+}
+
+void ts::TSFileIndex::reset(PacketCounter interval)
+{
+    _interval = std::max<PacketCounter>(interval, 1);
+    _packet_size = PKT_SIZE;
+    _packet_count = 0;
+    _pcr_pid = PID_NULL;
+    _last = Entry();
+    _pcr_per_packet = PCR::zero();
+    _entries.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Index the next packet of the file.
+//----------------------------------------------------------------------------
+
+void ts::TSFileIndex::feedPacket(const TSPacket& pkt)
+{
+    if (pkt.hasPCR() && (_pcr_pid == PID_NULL || pkt.getPID() == _pcr_pid)) {
+        const uint64_t pcr = pkt.getPCR();
+        if (_pcr_pid == PID_NULL) {
+            // First PCR in the file, this is the reference PCR PID and the origin of time.
+            _pcr_pid = pkt.getPID();
+            _last.packet = _packet_count;
+            _last.pcr = pcr;
+            _last.time = PCR::zero();
+            _entries.push_back(_last);
+        }
+        else {
+            // Compute the playout time. Bridge discontinuities using the last PCR interval per packet.
+            const PacketCounter distance = _packet_count - _last.packet;
+            const uint64_t diff = DiffPCR(_last.pcr, pcr);
+            if (diff != INVALID_PCR && PCR(diff) <= MAX_PCR_INTERVAL && !pkt.getDiscontinuityIndicator()) {
+                _pcr_per_packet = PCR(int64_t(diff)) / int64_t(distance);
+                _last.time += PCR(int64_t(diff));
+            }
+            else {
+                _last.time += _pcr_per_packet * int64_t(distance);
+            }
+            _last.packet = _packet_count;
+            _last.pcr = pcr;
+            if (_last.packet >= _entries.back().packet + _interval) {
+                _entries.push_back(_last);
+            }
+        }
+    }
+    _packet_count++;
+}
+
+
+//----------------------------------------------------------------------------
+// Find packets in the index.
+//----------------------------------------------------------------------------
+
+ts::PacketCounter ts::TSFileIndex::Interpolate(const Entry& first, const Entry& second, PCR time)
+{
+    if (second.time <= first.time || time <= first.time) {
+        return first.packet;
+    }
+    else if (time >= second.time) {
+        return second.packet;
+    }
+    else {
+        return first.packet + (second.packet - first.packet) * PacketCounter((time - first.time).count()) / PacketCounter((second.time - first.time).count());
+    }
+}
+
+bool ts::TSFileIndex::findTime(PCR time, PacketCounter& packet_index) const
+{
+    if (_entries.empty() || time < PCR::zero() || time > _last.time) {
+        return false;
+    }
+
+    // Find the last checkpoint at or before the requested time.
+    const auto it = std::upper_bound(_entries.begin(), _entries.end(), time, [](PCR t, const Entry& e) { return t < e.time; });
+    const size_t index = it == _entries.begin() ? 0 : size_t(it - _entries.begin()) - 1;
+    packet_index = Interpolate(_entries[index], nextEntry(index), time);
+    return true;
+}
+
+bool ts::TSFileIndex::findPCR(uint64_t pcr, PacketCounter& packet_index) const
+{
+    if (pcr > MAX_PCR) {
+        return false;
+    }
+
+    // Find the first interval between two checkpoints which contains the PCR value.
+    // The PCR may wrap up between two checkpoints.
+    for (size_t index = 0; index < _entries.size(); ++index) {
+        const Entry& first(_entries[index]);
+        const Entry& second(nextEntry(index));
+        const PCR diff(int64_t(DiffPCR(first.pcr, pcr)));
+        if (diff <= second.time - first.time) {
+            packet_index = Interpolate(first, second, first.time + diff);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Build the index of a TS file by reading it entirely.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileIndex::build(const fs::path& filename, Report& report, TSPacketFormat format)
+{
+    reset(_interval);
+
+    TSFile file;
+    if (!file.openRead(filename, 0, report, format)) {
+        return false;
+    }
+
+    report.verbose(u"indexing %s", filename);
+    TSPacketVector packets(READ_PACKETS);
+    size_t count = 0;
+    while ((count = file.readPackets(packets.data(), nullptr, packets.size(), report)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            feedPacket(packets[i]);
+        }
+    }
+    _packet_size = file.packetHeaderSize() + PKT_SIZE + file.packetTrailerSize();
+    report.debug(u"%s: %'d packets, %d checkpoints, PCR PID %n", filename, _packet_count, _entries.size(), _pcr_pid);
+    return file.close(report);
+}
+
+
+//----------------------------------------------------------------------------
+// Get the name of the sidecar index file of a TS file.
+//----------------------------------------------------------------------------
+
+fs::path ts::TSFileIndex::SidecarFileName(const fs::path& filename)
+{
+    return UString(filename) + SIDECAR_SUFFIX;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the size and modification time of a TS file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileIndex::FileCharacteristics(const fs::path& filename, uint64_t& size, uint64_t& mtime, Report& report)
+{
+    bool success = true;
+    size = fs::file_size(filename, &ErrCodeReport(success, report, u"cannot get size of", filename));
+    if (success) {
+        mtime = uint64_t(fs::last_write_time(filename, &ErrCodeReport(success, report, u"cannot get modification time of", filename)).time_since_epoch().count());
+    }
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Save the index in the sidecar file of a TS file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileIndex::save(const fs::path& filename, Report& report) const
+{
+    uint64_t size = 0;
+    uint64_t mtime = 0;
+    if (!FileCharacteristics(filename, size, mtime, report)) {
+        return false;
+    }
+
+    ByteBlock data;
+    data.reserve(INDEX_HEADER_SIZE + INDEX_ENTRY_SIZE * _entries.size());
+    data.append(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    data.appendUInt32(INDEX_VERSION);
+    data.appendUInt32(uint32_t(_packet_size));
+    data.appendUInt64(size);
+    data.appendUInt64(mtime);
+    data.appendUInt64(_interval);
+    data.appendUInt64(_packet_count);
+    data.appendUInt16(_pcr_pid);
+    data.appendUInt64(uint64_t(_pcr_per_packet.count()));
+    data.appendUInt64(_last.packet);
+    data.appendUInt64(_last.pcr);
+    data.appendUInt64(uint64_t(_last.time.count()));
+    data.appendUInt64(_entries.size());
+    for (const auto& e : _entries) {
+        data.appendUInt64(e.packet);
+        data.appendUInt64(e.pcr);
+        data.appendUInt64(uint64_t(e.time.count()));
+    }
+
+    const fs::path sidecar(SidecarFileName(filename));
+    report.debug(u"saving index %s, %d checkpoints", sidecar, _entries.size());
+    return data.saveToFile(sidecar, &report);
+}
+
+
+//----------------------------------------------------------------------------
+// Load the index from the sidecar file of a TS file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileIndex::load(const fs::path& filename, Report& report)
+{
+    const fs::path sidecar(SidecarFileName(filename));
+    uint64_t size = 0;
+    uint64_t mtime = 0;
+    ByteBlock data;
+
+    if (!fs::exists(sidecar)) {
+        report.debug(u"no index file %s", sidecar);
+        return false;
+    }
+    if (!FileCharacteristics(filename, size, mtime, report) || !data.loadFromFile(sidecar, std::numeric_limits<size_t>::max(), &report)) {
+        return false;
+    }
+
+    const uint8_t* p = data.data();
+    if (data.size() < INDEX_HEADER_SIZE || !MemEqual(p, INDEX_MAGIC, sizeof(INDEX_MAGIC)) || GetUInt32(p + 8) != INDEX_VERSION) {
+        report.error(u"invalid index file %s", sidecar);
+        return false;
+    }
+    if (GetUInt64(p + 16) != size || GetUInt64(p + 24) != mtime) {
+        report.debug(u"index file %s is obsolete", sidecar);
+        return false;
+    }
+    const uint64_t count = GetUInt64(p + INDEX_HEADER_SIZE - 8);
+    if (count > (data.size() - INDEX_HEADER_SIZE) / INDEX_ENTRY_SIZE || data.size() != INDEX_HEADER_SIZE + count * INDEX_ENTRY_SIZE) {
+        report.error(u"invalid index file %s", sidecar);
+        return false;
+    }
+
+    _packet_size = GetUInt32(p + 12);
+    _interval = GetUInt64(p + 32);
+    _packet_count = GetUInt64(p + 40);
+    _pcr_pid = GetUInt16(p + 48);
+    _pcr_per_packet = PCR(int64_t(GetUInt64(p + 50)));
+    _last.packet = GetUInt64(p + 58);
+    _last.pcr = GetUInt64(p + 66);
+    _last.time = PCR(int64_t(GetUInt64(p + 74)));
+    _entries.resize(size_t(count));
+    p += INDEX_HEADER_SIZE;
+    for (auto& e : _entries) {
+        e.packet = GetUInt64(p);
+        e.pcr = GetUInt64(p + 8);
+        e.time = PCR(int64_t(GetUInt64(p + 16)));
+        p += INDEX_ENTRY_SIZE;
+    }
+    report.debug(u"loaded index %s, %d checkpoints", sidecar, _entries.size());
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Load the index from the sidecar file or build it.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileIndex::loadOrBuild(const fs::path& filename, bool save_sidecar, Report& report, TSPacketFormat format)
+{
+    if (load(filename, report)) {
+        return true;
+    }
+    else if (!build(filename, report, format)) {
+        return false;
+    }
+    else {
+        return !save_sidecar || save(filename, report);
+    }
+}
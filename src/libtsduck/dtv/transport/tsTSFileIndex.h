@@ -0,0 +1,202 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Packet index of a transport stream file, for time-based random access.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+#include "tsTSPacketFormat.h"
+#include "tsReport.h"
+
+namespace ts {
+    //!
+    //! Packet index of a transport stream file, for time-based random access.
+    //! @ingroup mpeg
+    //!
+    //! The index is a list of checkpoints, at coarse intervals in the file. Each checkpoint
+    //! is a packet of the reference PCR PID, the first PID which carries a PCR in the file.
+    //! A checkpoint records the packet index in the file, its PCR value and the playout time
+    //! since the beginning of the file. The playout time is continuous across PCR wrap-up
+    //! and discontinuities.
+    //!
+    //! The index can be persistently stored in a "sidecar" file, next to the TS file.
+    //! The sidecar file records the size and modification time of the TS file. It is ignored
+    //! when the TS file is modified after the creation of the index.
+    //!
+    class TSDUCKDLL TSFileIndex
+    {
+    public:
+        //!
+        //! Default interval between checkpoints in packets.
+        //! With 10,000 packets (1.88 MB), a 100 GB file has around 53,000 checkpoints, 1.3 MB of index.
+        //!
+        static constexpr PacketCounter DEFAULT_INTERVAL = 10'000;
+
+        //!
+        //! Suffix which is appended to the name of a TS file to build the name of its index file.
+        //!
+        static constexpr const UChar* SIDECAR_SUFFIX = u".tsidx";
+
+        //!
+        //! Definition of a checkpoint in the index.
+        //!
+        class Entry
+        {
+        public:
+            PacketCounter packet = 0;        //!< Packet index in the file.
+            uint64_t      pcr = INVALID_PCR; //!< PCR value in that packet.
+            PCR           time {};           //!< Playout time since the first PCR in the file.
+        };
+
+        //!
+        //! Constructor.
+        //! @param [in] interval Minimum interval between checkpoints in packets.
+        //!
+        TSFileIndex(PacketCounter interval = DEFAULT_INTERVAL);
+
+        //!
+        //! Reset the index, before indexing a new file.
+        //! @param [in] interval Minimum interval between checkpoints in packets.
+        //!
+        void reset(PacketCounter interval = DEFAULT_INTERVAL);
+
+        //!
+        //! Index the next packet of the file.
+        //! All packets of the file must be passed in sequence, starting at the first one.
+        //! @param [in] pkt The next TS packet.
+        //!
+        void feedPacket(const TSPacket& pkt);
+
+        //!
+        //! Get the number of indexed packets.
+        //! @return The number of indexed packets, the size of the file in packets.
+        //!
+        PacketCounter packetCount() const { return _packet_count; }
+
+        //!
+        //! Set the size of packets in the TS file.
+        //! This is required before save() when the index was built using feedPacket() on a non-TS file format.
+        //! @param [in] size Size in bytes of a packet in the TS file, including header and trailer.
+        //!
+        void setPacketSize(size_t size) { _packet_size = size; }
+
+        //!
+        //! Get the size of packets in the TS file.
+        //! @return Size in bytes of a packet in the TS file, including header and trailer.
+        //!
+        size_t packetSize() const { return _packet_size; }
+
+        //!
+        //! Get the byte offset of a packet in the TS file.
+        //! @param [in] packet_index Packet index in the file.
+        //! @return Byte offset of the packet in the TS file.
+        //!
+        uint64_t byteOffset(PacketCounter packet_index) const { return packet_index * _packet_size; }
+
+        //!
+        //! Get the reference PCR PID of the file.
+        //! @return The reference PCR PID or PID_NULL if there is no PCR in the file.
+        //!
+        PID pcrPID() const { return _pcr_pid; }
+
+        //!
+        //! Get the checkpoints of the index.
+        //! The last PCR of the reference PCR PID is not included when it is not a checkpoint.
+        //! @return A constant reference to the list of checkpoints.
+        //!
+        const std::vector<Entry>& entries() const { return _entries; }
+
+        //!
+        //! Get the playout duration of the indexed file, from first to last PCR.
+        //! @return The playout duration.
+        //!
+        PCR duration() const { return _last.time; }
+
+        //!
+        //! Find the packet at a given playout time.
+        //! The packet index is interpolated between the surrounding checkpoints.
+        //! @param [in] time Playout time since the first PCR in the file.
+        //! @param [out] packet_index Packet index in the file.
+        //! @return True on success, false if @a time is beyond the end of the file or there is no PCR.
+        //!
+        bool findTime(PCR time, PacketCounter& packet_index) const;
+
+        //!
+        //! Find the first packet with a given PCR value on the reference PCR PID.
+        //! The packet index is interpolated between the surrounding checkpoints.
+        //! @param [in] pcr PCR value, as found in the file.
+        //! @param [out] packet_index Packet index in the file.
+        //! @return True on success, false if @a pcr is not found in the file.
+        //!
+        bool findPCR(uint64_t pcr, PacketCounter& packet_index) const;
+
+        //!
+        //! Build the index of a TS file by reading it entirely.
+        //! @param [in] filename Name of the TS file.
+        //! @param [in,out] report Where to report errors.
+        //! @param [in] format Format of the TS file.
+        //! @return True on success, false on error.
+        //!
+        bool build(const fs::path& filename, Report& report, TSPacketFormat format = TSPacketFormat::AUTODETECT);
+
+        //!
+        //! Save the index in the sidecar file of a TS file.
+        //! @param [in] filename Name of the TS file (not the sidecar file).
+        //! The TS file shall be complete and closed.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool save(const fs::path& filename, Report& report) const;
+
+        //!
+        //! Load the index from the sidecar file of a TS file.
+        //! @param [in] filename Name of the TS file (not the sidecar file).
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error or if the sidecar file is missing or obsolete.
+        //!
+        bool load(const fs::path& filename, Report& report);
+
+        //!
+        //! Load the index from the sidecar file of a TS file or build it when the sidecar file is missing or obsolete.
+        //! @param [in] filename Name of the TS file (not the sidecar file).
+        //! @param [in] save_sidecar If true, save the sidecar file when the index was built.
+        //! @param [in,out] report Where to report errors.
+        //! @param [in] format Format of the TS file.
+        //! @return True on success, false on error.
+        //!
+        bool loadOrBuild(const fs::path& filename, bool save_sidecar, Report& report, TSPacketFormat format = TSPacketFormat::AUTODETECT);
+
+        //!
+        //! Get the name of the sidecar index file of a TS file.
+        //! @param [in] filename Name of the TS file.
+        //! @return Name of the sidecar index file.
+        //!
+        static fs::path SidecarFileName(const fs::path& filename);
+
+    private:
+        PacketCounter      _interval = DEFAULT_INTERVAL;  // Minimum interval between checkpoints.
+        size_t             _packet_size = PKT_SIZE;       // Size of packets in the TS file.
+        PacketCounter      _packet_count = 0;             // Number of indexed packets.
+        PID                _pcr_pid = PID_NULL;           // Reference PCR PID.
+        Entry              _last {};                      // Last PCR on the reference PID.
+        PCR                _pcr_per_packet {};            // Last PCR interval per packet, to bridge discontinuities.
+        std::vector<Entry> _entries {};                   // Checkpoints in the file.
+
+        // Get the checkpoint following a given one, the last PCR after the last checkpoint.
+        const Entry& nextEntry(size_t index) const { return index + 1 < _entries.size() ? _entries[index + 1] : _last; }
+
+        // Interpolate a packet index between two checkpoints.
+        static PacketCounter Interpolate(const Entry& first, const Entry& second, PCR time);
+
+        // Get the size and modification time of a TS file, as stored in the sidecar file.
+        static bool FileCharacteristics(const fs::path& filename, uint64_t& size, uint64_t& mtime, Report& report);
+    };
+}
@@ -7,6 +7,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsTSFileInputArgs.h"
+#include "tsTSFileIndex.h"
 #include "tsAlgorithm.h"
 
 
@@ -75,6 +76,15 @@ void ts::TSFileInputArgs::defineArgs(Args& args)
               u"Start reading each file at the specified TS packet (default: 0). "
               u"This option is allowed only if all input files are regular files.");
 
+    args.option<cn::milliseconds>(u"time-offset");
+    args.help(u"time-offset",
+              u"Start reading each file at the specified playout time, from the first PCR in the file. "
+              u"The packet at this time is located using the sidecar index file of the input file, "
+              u"as created by option --index of the file output plugin. "
+              u"When there is no index file or when it is obsolete, the input file is read once to build the index. "
+              u"This option is allowed only if all input files are regular files. "
+              u"The options --byte-offset, --packet-offset and --time-offset are mutually exclusive.");
+
     args.option(u"repeat", 'r', Args::POSITIVE);
     args.help(u"repeat",
               u"Repeat the playout of each file the specified number of times (default: only once). "
@@ -93,6 +103,7 @@ bool ts::TSFileInputArgs::loadArgs(DuckContext& duck, Args& args)
     _start_offset = args.intValue<uint64_t>(u"byte-offset", args.intValue<uint64_t>(u"packet-offset", 0) * PKT_SIZE);
     _interleave = args.present(u"interleave");
     _first_terminate = args.present(u"first-terminate");
+    args.getChronoValue(_time_offset, u"time-offset");
     args.getIntValue(_interleave_chunk, u"interleave", 1);
     args.getIntValue(_base_label, u"label-base", TSPacketLabelSet::MAX + 1);
     args.getIntValues(_start_stuffing, u"add-start-stuffing");
@@ -112,6 +123,10 @@ bool ts::TSFileInputArgs::loadArgs(DuckContext& duck, Args& args)
     }
 
     // Check option consistency.
+    if (args.present(u"time-offset") && (args.present(u"byte-offset") || args.present(u"packet-offset"))) {
+        args.error(u"--byte-offset, --packet-offset and --time-offset are mutually exclusive");
+        return false;
+    }
     if (_filenames.size() > 1 && _repeat_count == 0 && !_interleave) {
         args.error(u"specifying --infinite is meaningless with more than one file");
         return false;
@@ -145,8 +160,28 @@ bool ts::TSFileInputArgs::openFile(size_t name_index, size_t file_index, Report&
     // Preset artificial stuffing.
     _files[file_index].setStuffing(_start_stuffing[name_index], _stop_stuffing[name_index]);
 
+    // With a time offset, locate the start of the file using its index.
+    uint64_t start_offset = _start_offset;
+    if (_time_offset > cn::milliseconds::zero()) {
+        TSFileIndex index;
+        PacketCounter packet_index = 0;
+        if (name.empty()) {
+            report.error(u"--time-offset cannot be used on standard input");
+            return false;
+        }
+        else if (!index.loadOrBuild(name, false, report, _file_format)) {
+            return false;
+        }
+        else if (!index.findTime(cn::duration_cast<PCR>(_time_offset), packet_index)) {
+            report.error(u"time offset %s is beyond the end of %s", _time_offset, name);
+            return false;
+        }
+        start_offset = index.byteOffset(packet_index);
+        report.debug(u"%s: time offset %s is at packet %'d", name, _time_offset, packet_index);
+    }
+
     // Actually open the file.
-    return _files[file_index].openRead(name, _repeat_count, _start_offset, report, _file_format);
+    return _files[file_index].openRead(name, _repeat_count, start_offset, report, _file_format);
 }
 
 
@@ -90,6 +90,7 @@ namespace ts {
         size_t              _current_file = 0;        // Current file index in _files. Depends on _interleave.
         size_t              _repeat_count = 1;
         uint64_t            _start_offset = 0;
+        cn::milliseconds    _time_offset {};
         size_t              _base_label = 0;
         TSPacketFormat      _file_format = TSPacketFormat::AUTODETECT;
         std::vector<fs::path> _filenames {};
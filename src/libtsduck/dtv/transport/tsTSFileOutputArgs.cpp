@@ -48,6 +48,13 @@ void ts::TSFileOutputArgs::defineArgs(Args& args)
     args.option(u"append", 'a');
     args.help(u"append", u"If the file already exists, append to the end of the file. By default, existing files are overwritten.");
 
+    args.option(u"index");
+    args.help(u"index",
+              u"Create a sidecar index file next to each output file, with the same name plus suffix \"" + UString(TSFileIndex::SIDECAR_SUFFIX) + u"\". "
+              u"The index records the position of PCR's at coarse intervals. "
+              u"It is used to quickly seek into the file by time, for instance using option --time-offset on input. "
+              u"The index is not created with --append or on standard output.");
+
     args.option(u"keep", 'k');
     args.help(u"keep", u"Keep existing file (abort if the specified file already exists). By default, existing files are overwritten.");
 
@@ -120,6 +127,9 @@ bool ts::TSFileOutputArgs::loadArgs(DuckContext& duck, Args& args)
     if (args.present(u"keep")) {
         _flags |= TSFile::KEEP;
     }
+    if (args.present(u"index")) {
+        _flags |= TSFile::INDEX;
+    }
 
     if (_max_size > 0 && _max_duration > cn::seconds::zero()) {
         args.error(u"--max-duration and --max-size are mutually exclusive");
@@ -245,6 +255,13 @@ bool ts::TSFileOutputArgs::closeAndCleanup(Report& report)
             // Failed to delete, keep it to retry later.
             failed_delete.push_back(name);
         }
+        else {
+            // Also delete the sidecar index file, if any.
+            const fs::path sidecar(TSFileIndex::SidecarFileName(name));
+            if (fs::exists(sidecar)) {
+                fs::remove(sidecar, &ErrCodeReport(report, u"error deleting", sidecar));
+            }
+        }
     }
 
     // Re-insert files we failed to delete at head of list so that we will retry to delete them next time.
@@ -302,3 +319,27 @@ bool ts::TSFileOutputArgs::write(const TSPacket* buffer, const TSPacketMetadata*
         done_once = true;
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Write several ranges of packets.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileOutputArgs::write(const TSPacketRange* ranges, size_t range_count, Report& report, AbortInterface* abort)
+{
+    // File rotation and reopen on error are checked range by range.
+    if (_reopen || _max_size > 0 || _max_duration > cn::seconds::zero()) {
+        bool success = true;
+        for (size_t i = 0; success && i < range_count; ++i) {
+            success = write(ranges[i].packets, ranges[i].metadata, ranges[i].count, report, abort);
+        }
+        return success;
+    }
+    else {
+        // Vectored write of all ranges at once.
+        const PacketCounter where = _file.writePacketsCount();
+        const bool success = _file.writePacketRanges(ranges, range_count, report);
+        _current_size += (_file.writePacketsCount() - where) * PKT_SIZE;
+        return success;
+    }
+}
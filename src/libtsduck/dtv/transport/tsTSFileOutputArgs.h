@@ -78,6 +78,16 @@ namespace ts {
         //!
         bool write(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count, Report& report, AbortInterface* abort = nullptr);
 
+        //!
+        //! Write several ranges of packets, in sequence.
+        //! @param [in] ranges Address of an array of packet ranges.
+        //! @param [in] range_count Number of ranges in @a ranges.
+        //! @param [in,out] report Where to report errors.
+        //! @param [in] abort An optional abort interface to detect abort requests.
+        //! @return True on success, false on error.
+        //!
+        bool write(const TSPacketRange* ranges, size_t range_count, Report& report, AbortInterface* abort = nullptr);
+
         //!
         //! Default retry interval in milliseconds.
         //!
@@ -0,0 +1,23 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSPacketRange.h"
+
+
+//----------------------------------------------------------------------------
+// Get the total number of packets in a set of ranges.
+//----------------------------------------------------------------------------
+
+size_t ts::TSPacketRange::PacketCount(const TSPacketRange* ranges, size_t range_count)
+{
+    size_t count = 0;
+    for (size_t i = 0; ranges != nullptr && i < range_count; ++i) {
+        count += ranges[i].count;
+    }
+    return count;
+}
@@ -0,0 +1,56 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  A range of contiguous TS packets and their metadata.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+#include "tsTSPacketMetadata.h"
+
+namespace ts {
+    //!
+    //! A range of contiguous TS packets and their metadata.
+    //! @ingroup mpeg
+    //!
+    //! A vector of ranges describes a sparse set of packets in a larger buffer, typically
+    //! the packets to output after some packets were dropped. Vectored output operations
+    //! process all ranges at once, without one system call per range.
+    //!
+    class TSDUCKDLL TSPacketRange
+    {
+    public:
+        const TSPacket*         packets = nullptr;   //!< Address of the first packet in the range.
+        const TSPacketMetadata* metadata = nullptr;  //!< Address of the first packet metadata, can be null.
+        size_t                  count = 0;           //!< Number of packets in the range.
+
+        //!
+        //! Constructor.
+        //! @param [in] pkt Address of the first packet in the range.
+        //! @param [in] mdata Address of the first packet metadata, can be null.
+        //! @param [in] cnt Number of packets in the range.
+        //!
+        TSPacketRange(const TSPacket* pkt = nullptr, const TSPacketMetadata* mdata = nullptr, size_t cnt = 0) :
+            packets(pkt), metadata(mdata), count(cnt) {}
+
+        //!
+        //! Get the total number of packets in a set of ranges.
+        //! @param [in] ranges Address of an array of packet ranges.
+        //! @param [in] range_count Number of ranges in @a ranges.
+        //! @return The total number of packets.
+        //!
+        static size_t PacketCount(const TSPacketRange* ranges, size_t range_count);
+    };
+
+    //!
+    //! Vector of packet ranges.
+    //!
+    using TSPacketRangeVector = std::vector<TSPacketRange>;
+}
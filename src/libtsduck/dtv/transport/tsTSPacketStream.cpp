@@ -339,3 +339,39 @@ bool ts::TSPacketStream::writePackets(const TSPacket* buffer, const TSPacketMeta
 
     return success;
 }
+
+
+//----------------------------------------------------------------------------
+// Write several ranges of TS packets.
+//----------------------------------------------------------------------------
+
+bool ts::TSPacketStream::writePacketRanges(const TSPacketRange* ranges, size_t range_count, Report& report)
+{
+    if (_writer == nullptr) {
+        report.error(u"internal error, cannot write TS packets to this stream");
+        return false;
+    }
+
+    // Non-TS formats interleave headers or trailers, write range by range.
+    if (_format != TSPacketFormat::AUTODETECT && _format != TSPacketFormat::TS) {
+        bool success = true;
+        for (size_t i = 0; success && i < range_count; ++i) {
+            success = writePackets(ranges[i].packets, ranges[i].metadata, ranges[i].count, report);
+        }
+        return success;
+    }
+
+    // If file format is not yet known, force it as TS, the default.
+    _format = TSPacketFormat::TS;
+
+    // Vectored write in TS format.
+    _chunks.resize(range_count);
+    for (size_t i = 0; i < range_count; ++i) {
+        _chunks[i].addr = ranges[i].packets;
+        _chunks[i].size = ranges[i].count * PKT_SIZE;
+    }
+    size_t written_size = 0;
+    const bool success = _writer->writeStreamChunks(_chunks.data(), _chunks.size(), written_size, report);
+    _total_write += written_size / PKT_SIZE;
+    return success;
+}
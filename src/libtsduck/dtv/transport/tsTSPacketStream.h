@@ -17,6 +17,7 @@
 #include "tsTSPacketFormat.h"
 #include "tsTSPacketMetadata.h"
 #include "tsTSPacket.h"
+#include "tsTSPacketRange.h"
 #include "tsNames.h"
 
 namespace ts {
@@ -70,6 +71,18 @@ namespace ts {
         //!
         virtual bool writePackets(const TSPacket* buffer, const TSPacketMetadata* metadata, size_t packet_count, Report& report);
 
+        //!
+        //! Write several ranges of TS packets to the stream, in sequence.
+        //! In TS format, all ranges are written using one vectored write operation when the
+        //! underlying stream supports it. In other formats, each range is written using
+        //! writePackets().
+        //! @param [in] ranges Address of an array of packet ranges.
+        //! @param [in] range_count Number of ranges in @a ranges.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        virtual bool writePacketRanges(const TSPacketRange* ranges, size_t range_count, Report& report);
+
         //!
         //! Get the number of read packets.
         //! @return The number of read packets.
@@ -129,6 +142,12 @@ namespace ts {
         //!
         void resetPacketStream(TSPacketFormat format, AbstractReadStreamInterface* reader, AbstractWriteStreamInterface* writer);
 
+        //!
+        //! Discard the data which were read in advance from the stream during the detection of the format.
+        //! Must be called when the read position is moved in the underlying stream.
+        //!
+        void discardReadAhead() { _trail_size = 0; }
+
         PacketCounter _total_read = 0;   //!< Total read packets.
         PacketCounter _total_write = 0;  //!< Total written packets.
 
@@ -138,6 +157,7 @@ namespace ts {
         AbstractWriteStreamInterface* _writer = nullptr;
         PCR     _last_timestamp {};              // Last write time stamp in PCR units (M2TS files).
         size_t  _trail_size = 0;                 // Number of meaningful bytes in _trail
+        std::vector<AbstractWriteStreamInterface::Chunk> _chunks {};  // Chunks for vectored write.
         uint8_t _trail[MAX_TRAILER_SIZE+1] {};   // Transient buffer for auto-detection of trailer
     };
 }
@@ -13,6 +13,7 @@
 
 #pragma once
 #include "tsProcessorPlugin.h"
+#include "tsPIDMap.h"
 
 namespace ts {
     //!
@@ -37,10 +38,9 @@ namespace ts {
         //!
         AbstractDuplicateRemapPlugin(bool remap, TSP* tsp, const UString& description = UString(), const UString& syntax = UString());
 
-        using PIDMap = std::map<PID, PID>;    //!< A map from PID to PID.
         bool             _unchecked = false;  //!< Ignore conflicting input/output PID's.
         PIDSet           _newPIDs {};         //!< Set of output (duplicated or remapped) PID values.
-        PIDMap           _pidMap {};          //!< Key = input pid, value = output PID.
+        PIDMap<PID>      _pidMap {};          //!< Key = input pid, value = output PID.
         TSPacketLabelSet _setLabels {};       //!< Labels to set on output packets.
         TSPacketLabelSet _resetLabels {};     //!< Labels to reset on output packets.
 
@@ -46,3 +46,8 @@ bool ts::FileOutputPlugin::send(const TSPacket* buffer, const TSPacketMetadata*
 {
     return _file.write(buffer, pkt_data, packet_count, *this, tsp);
 }
+
+bool ts::FileOutputPlugin::sendVector(const TSPacketRange* ranges, size_t range_count)
+{
+    return _file.write(ranges, range_count, *this, tsp);
+}
@@ -29,6 +29,7 @@ namespace ts {
         virtual bool start() override;
         virtual bool stop() override;
         virtual bool send(const TSPacket*, const TSPacketMetadata*, size_t) override;
+        virtual bool sendVector(const TSPacketRange*, size_t) override;
 
     private:
         TSFileOutputArgs _file {true}; // stdout allowed
@@ -68,3 +68,8 @@ bool ts::ForkOutputPlugin::send(const TSPacket* buffer, const TSPacketMetadata*
 {
     return _pipe.writePackets(buffer, pkt_data, packet_count, *this);
 }
+
+bool ts::ForkOutputPlugin::sendVector(const TSPacketRange* ranges, size_t range_count)
+{
+    return _pipe.writePacketRanges(ranges, range_count, *this);
+}
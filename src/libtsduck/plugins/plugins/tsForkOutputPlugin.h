@@ -31,6 +31,7 @@ namespace ts {
         virtual bool start() override;
         virtual bool stop() override;
         virtual bool send(const TSPacket*, const TSPacketMetadata*, size_t) override;
+        virtual bool sendVector(const TSPacketRange*, size_t) override;
 
     private:
         UString        _command {};       // The command to run.
@@ -51,3 +51,8 @@ bool ts::IPOutputPlugin::send(const TSPacket* packets, const TSPacketMetadata* m
 {
     return _datagram.send(packets, metadata, packet_count, tsp->bitrate(), *this);
 }
+
+bool ts::IPOutputPlugin::sendVector(const TSPacketRange* ranges, size_t range_count)
+{
+    return _datagram.send(ranges, range_count, tsp->bitrate(), *this);
+}
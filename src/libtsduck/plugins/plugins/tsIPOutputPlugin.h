@@ -30,6 +30,7 @@ namespace ts {
         virtual bool stop() override;
         virtual bool isRealTime() override;
         virtual bool send(const TSPacket*, const TSPacketMetadata*, size_t) override;
+        virtual bool sendVector(const TSPacketRange*, size_t) override;
 
     private:
         TSDatagramOutput _datagram {TSDatagramOutputOptions::ALLOW_RTP | TSDatagramOutputOptions::ALLOW_RS204};
@@ -8,11 +8,25 @@
 
 #include "tsMemoryOutputPlugin.h"
 #include "tsPluginRepository.h"
-#include "tsPluginEventData.h"
 
 TS_REGISTER_OUTPUT_PLUGIN(u"memory", ts::MemoryOutputPlugin);
 
 
+//----------------------------------------------------------------------------
+// Event data constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::MemoryOutputEventData::MemoryOutputEventData(const TSPacket* packets, const TSPacketMetadata* metadata, size_t packet_count) :
+    PluginEventData(packets == nullptr ? nullptr : packets->b, PKT_SIZE * packet_count),
+    _metadata(metadata)
+{
+}
+
+ts::MemoryOutputEventData::~MemoryOutputEventData()
+{
+}
+
+
 //----------------------------------------------------------------------------
 // Constructor
 //----------------------------------------------------------------------------
@@ -28,6 +42,7 @@ ts::MemoryOutputPlugin::MemoryOutputPlugin(TSP* tsp_) :
     help(u"event-code",
          u"Signal a plugin event with the specified code each time the plugin output packets. "
          u"The event data is an instance of PluginEventData pointing to the output packets. "
+         u"It is more precisely an instance of its subclass MemoryOutputEventData which also references the packet metadata. "
          u"If an event handler sets the error indicator in the event data, the transmission is aborted.");
 }
 
@@ -50,7 +65,7 @@ bool ts::MemoryOutputPlugin::getOptions()
 bool ts::MemoryOutputPlugin::send(const TSPacket* packets, const TSPacketMetadata* metadata, size_t packet_count)
 {
     // Prepare an event data block pointing to the output packets.
-    PluginEventData data(packets->b, PKT_SIZE * packet_count);
+    MemoryOutputEventData data(packets, metadata, packet_count);
     tsp->signalPluginEvent(_event_code, &data);
     return !data.hasError();
 }
@@ -13,8 +13,56 @@
 
 #pragma once
 #include "tsOutputPlugin.h"
+#include "tsPluginEventData.h"
 
 namespace ts {
+    //!
+    //! Plugin event data which are signalled by the memory output plugin.
+    //! @ingroup plugin
+    //!
+    //! This subclass of PluginEventData points to the output packets. It also references
+    //! the metadata of the output packets (labels, timestamps), for applications which
+    //! need them. Applications which only need the packets can use it as a PluginEventData.
+    //!
+    class TSDUCKDLL MemoryOutputEventData : public PluginEventData
+    {
+        TS_NOBUILD_NOCOPY(MemoryOutputEventData);
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] packets Address of the output packets.
+        //! @param [in] metadata Address of the metadata of the output packets.
+        //! @param [in] packet_count Number of output packets.
+        //!
+        MemoryOutputEventData(const TSPacket* packets, const TSPacketMetadata* metadata, size_t packet_count);
+
+        //!
+        //! Destructor.
+        //!
+        virtual ~MemoryOutputEventData() override;
+
+        //!
+        //! Get the address of the output packets.
+        //! @return The address of the output packets.
+        //!
+        const TSPacket* packets() const { return reinterpret_cast<const TSPacket*>(data()); }
+
+        //!
+        //! Get the address of the metadata of the output packets.
+        //! @return The address of the metadata of the output packets, in the same order as packets().
+        //!
+        const TSPacketMetadata* metadata() const { return _metadata; }
+
+        //!
+        //! Get the number of output packets.
+        //! @return The number of output packets.
+        //!
+        size_t packetCount() const { return size() / PKT_SIZE; }
+
+    private:
+        const TSPacketMetadata* _metadata;
+    };
+
     //!
     //! Memory output plugin for tsp.
     //! @ingroup plugin
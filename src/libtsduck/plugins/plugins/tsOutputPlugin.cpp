@@ -27,3 +27,12 @@ ts::PluginType ts::OutputPlugin::type() const
 {
     return PluginType::OUTPUT;
 }
+
+bool ts::OutputPlugin::sendVector(const TSPacketRange* ranges, size_t range_count)
+{
+    bool success = true;
+    for (size_t i = 0; success && i < range_count; ++i) {
+        success = send(ranges[i].packets, ranges[i].metadata, ranges[i].count);
+    }
+    return success;
+}
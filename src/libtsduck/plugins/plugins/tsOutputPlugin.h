@@ -15,6 +15,7 @@
 #include "tsPlugin.h"
 #include "tsTSPacket.h"
 #include "tsTSPacketMetadata.h"
+#include "tsTSPacketRange.h"
 
 namespace ts {
     //!
@@ -43,6 +44,23 @@ namespace ts {
         //!
         virtual bool send(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count) = 0;
 
+        //!
+        //! Vectored packet output interface.
+        //!
+        //! The main application invokes sendVector() to output several non-contiguous
+        //! ranges of packets at once, typically when some packets were dropped in the
+        //! middle of the buffer. The ranges must be output in sequence.
+        //!
+        //! The default implementation invokes send() once per range. Plugins which can
+        //! output sparse packets more efficiently (vectored I/O, packing in datagrams)
+        //! should override this method.
+        //!
+        //! @param [in] ranges Address of an array of packet ranges.
+        //! @param [in] range_count Number of ranges in @a ranges.
+        //! @return True on success, false on error.
+        //!
+        virtual bool sendVector(const TSPacketRange* ranges, size_t range_count);
+
         // Implementation of inherited interface.
         virtual PluginType type() const override;
 
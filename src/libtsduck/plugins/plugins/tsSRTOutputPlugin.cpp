@@ -106,6 +106,11 @@ bool ts::SRTOutputPlugin::send(const TSPacket* packets, const TSPacketMetadata*
     return _datagram.send(packets, metadata, packet_count, tsp->bitrate(), *this);
 }
 
+bool ts::SRTOutputPlugin::sendVector(const TSPacketRange* ranges, size_t range_count)
+{
+    return _datagram.send(ranges, range_count, tsp->bitrate(), *this);
+}
+
 
 //----------------------------------------------------------------------------
 // Implementation of TSDatagramOutputHandlerInterface: send one datagram.
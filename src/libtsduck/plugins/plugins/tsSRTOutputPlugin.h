@@ -31,6 +31,7 @@ namespace ts {
         virtual bool stop() override;
         virtual bool isRealTime() override;
         virtual bool send(const TSPacket*, const TSPacketMetadata*, size_t) override;
+        virtual bool sendVector(const TSPacketRange*, size_t) override;
 
     private:
         bool             _multiple = false;  // Accept multiple (sequential) connections.
@@ -101,6 +101,14 @@ ts::hls::InputPlugin::InputPlugin(TSP* tsp_) :
          u"When the URL is a master playlist, select a content the resolution of which has a "
          u"lower height than the specified maximum.");
 
+    option(u"prefetch", 'p', UNSIGNED);
+    help(u"prefetch", u"count",
+         u"Download the specified number of media segments in advance, in parallel. "
+         u"Each segment is entirely downloaded in memory before being passed to the next plugin. "
+         u"With live streams, the playlist is reloaded in parallel with the segment downloads. "
+         u"This reduces the risk of input stall when the server is slow to respond. "
+         u"By default, the media segments are downloaded one after the other.");
+
     option(u"save-files", 0, DIRECTORY);
     help(u"save-files",
          u"Specify a directory where all downloaded files, media segments and playlists, are saved "
@@ -146,7 +154,8 @@ bool ts::hls::InputPlugin::isRealTime()
 bool ts::hls::InputPlugin::getOptions()
 {
     _url.setURL(value(u""));
-    const UString saveDirectory(value(u"save-files"));
+    getValue(_saveDirectory, u"save-files");
+    getIntValue(_prefetch, u"prefetch", 0);
     getIntValue(_maxSegmentCount, u"segment-count");
     getValue(_minRate, u"min-bitrate");
     getValue(_maxRate, u"max-bitrate");
@@ -207,8 +216,8 @@ bool ts::hls::InputPlugin::getOptions()
     }
 
     // Automatically save media segments and playlists.
-    setAutoSaveDirectory(saveDirectory);
-    _playlist.setAutoSaveDirectory(saveDirectory);
+    setAutoSaveDirectory(_saveDirectory);
+    _playlist.setAutoSaveDirectory(_saveDirectory);
 
     return true;
 }
@@ -351,6 +360,13 @@ bool ts::hls::InputPlugin::start()
 
     _segmentCount = 0;
 
+    // With --prefetch, the segments are downloaded in background threads.
+    if (_prefetch > 0) {
+        _segmentData.clear();
+        _segmentOffset = 0;
+        return _prefetcher.start(_playlist, webArgs, _prefetch, _maxSegmentCount);
+    }
+
     // Invoke superclass.
     return AbstractHTTPInputPlugin::start();
 }
@@ -363,13 +379,71 @@ bool ts::hls::InputPlugin::start()
 bool ts::hls::InputPlugin::stop()
 {
     // Invoke superclass first.
-    const bool stopped = AbstractHTTPInputPlugin::stop();
+    bool stopped = true;
+    if (_prefetch > 0) {
+        _prefetcher.stop();
+    }
+    else {
+        stopped = AbstractHTTPInputPlugin::stop();
+    }
 
     // Then delete the cookie file. Must be done after complete stop to avoid recreation.
     return deleteCookiesFile() && stopped;
 }
 
 
+//----------------------------------------------------------------------------
+// Input abort method
+//----------------------------------------------------------------------------
+
+bool ts::hls::InputPlugin::abortInput()
+{
+    if (_prefetch > 0) {
+        _prefetcher.abort();
+        return true;
+    }
+    else {
+        return AbstractHTTPInputPlugin::abortInput();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Input method
+//----------------------------------------------------------------------------
+
+size_t ts::hls::InputPlugin::receive(TSPacket* buffer, TSPacketMetadata* metadata, size_t maxPackets)
+{
+    // Without --prefetch, directly receive from the current transfer in the superclass.
+    if (_prefetch == 0) {
+        return AbstractHTTPInputPlugin::receive(buffer, metadata, maxPackets);
+    }
+
+    // Get next segment when the current one is exhausted. Trailing bytes after the last complete packet are dropped.
+    while (_segmentData.size() < _segmentOffset + PKT_SIZE) {
+        hls::MediaSegment seg;
+        _segmentOffset = 0;
+        if (tsp->aborting() || !_prefetcher.getNextSegment(seg, _segmentData)) {
+            _segmentData.clear();
+            return 0;
+        }
+        verbose(u"downloaded %s, %'d bytes", seg.urlString(), _segmentData.size());
+
+        // Display errors but do not fail, this is just auto save.
+        const UString name(BaseName(URL(seg.urlString()).getPath()));
+        if (!_saveDirectory.empty() && !name.empty()) {
+            _segmentData.saveToFile(_saveDirectory + fs::path::preferred_separator + name, this);
+        }
+    }
+
+    // Return packets from the current segment.
+    const size_t count = std::min(maxPackets, (_segmentData.size() - _segmentOffset) / PKT_SIZE);
+    MemCopy(buffer, _segmentData.data() + _segmentOffset, count * PKT_SIZE);
+    _segmentOffset += count * PKT_SIZE;
+    return count;
+}
+
+
 //----------------------------------------------------------------------------
 // Called by AbstractHTTPInputPlugin to open an URL.
 //----------------------------------------------------------------------------
@@ -421,6 +495,8 @@ bool ts::hls::InputPlugin::openURL(WebRequest& request)
 
     // Open the segment.
     debug(u"downloading segment %s", seg.urlString());
+    // All segments usually come from the same server, keep the connection between segments.
     request.enableCookies(webArgs.cookiesFile);
+    request.setKeepConnections(true);
     return request.open(seg.urlString());
 }
@@ -14,6 +14,7 @@
 #pragma once
 #include "tsAbstractHTTPInputPlugin.h"
 #include "tshlsPlayList.h"
+#include "tshlsSegmentPrefetcher.h"
 #include "tsURL.h"
 
 namespace ts {
@@ -33,7 +34,9 @@ namespace ts {
             virtual bool getOptions() override;
             virtual bool start() override;
             virtual bool stop() override;
+            virtual bool abortInput() override;
             virtual bool isRealTime() override;
+            virtual size_t receive(TSPacket*, TSPacketMetadata*, size_t) override;
 
         protected:
             // Implementation of AbstractHTTPInputPlugin
@@ -60,10 +63,17 @@ namespace ts {
             UString  _altName {};
             UString  _altGroupId {};
             UString  _altLanguage {};
+            UString  _saveDirectory {};
+            size_t   _prefetch = 0;
 
             // Working data:
             size_t   _segmentCount = 0;
             PlayList _playlist {};
+
+            // Working data with --prefetch:
+            SegmentPrefetcher _prefetcher {*this};
+            ByteBlock         _segmentData {};     // Content of current media segment.
+            size_t            _segmentOffset = 0;  // Next packet to read in _segmentData.
         };
     }
 }
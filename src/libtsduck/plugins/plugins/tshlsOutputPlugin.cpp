@@ -23,8 +23,7 @@ TS_REGISTER_OUTPUT_PLUGIN(u"hls", ts::hls::OutputPlugin);
 
 ts::hls::OutputPlugin::OutputPlugin(TSP* tsp_) :
     ts::OutputPlugin(tsp_, u"Generate HTTP Live Streaming (HLS) media", u"[options] filename"),
-    _demux(duck, this),
-    _ccFixer(NoPID(), this)
+    _demux(duck, this)
 {
     option(u"", 0, FILENAME, 1, 1);
     help(u"",
@@ -35,7 +34,9 @@ ts::hls::OutputPlugin::OutputPlugin(TSP* tsp_) :
          u"If the specified template already contains trailing digits, this unmodified "
          u"name is used for the first segment. Then, the integer part is incremented. "
          u"Example: if the specified file name is foo-027.ts, the various segment files "
-         u"are named foo-027.ts, foo-028.ts, etc.");
+         u"are named foo-027.ts, foo-028.ts, etc.\n\n"
+         u"Segment files are created with an additional \".tmp\" suffix and renamed with their final "
+         u"name when complete. Therefore, an HTTP server never serves incomplete segment files.");
 
     option(u"align-first-segment", 'a');
     help(u"align-first-segment",
@@ -117,8 +118,26 @@ ts::hls::OutputPlugin::OutputPlugin(TSP* tsp_) :
          u"The playlist file is rewritten each time a new segment file is completed or an obsolete one is deleted. "
          u"The playlist and the segment files can be written to distinct directories but, in all cases, "
          u"the URI of the segment files in the playlist are always relative to the playlist location. "
+         u"With --rendition, this is the name of the master playlist. "
          u"By default, no playlist file is created (media segments only).");
 
+    option(u"rendition", 'r', UINT16, 0, UNLIMITED_COUNT);
+    help(u"rendition", u"service-id",
+         u"Generate a separate rendition for the specified service. "
+         u"Several --rendition options can be specified, typically one per bitrate of the same content "
+         u"from an adaptive bitrate encoder. All renditions are generated in one single pass.\n\n"
+         u"Each rendition contains the packets of the service only, including its ECM PID's, with a PAT which references this service only. "
+         u"The service id is inserted in the names of the segment files and media playlist of the rendition. "
+         u"Example: with segment files foo.ts and --playlist index.m3u8, the rendition for service 257 "
+         u"uses segment files named foo-257-000000.ts, foo-257-000001.ts, etc. and the media playlist index-257.m3u8. "
+         u"The file which is specified in --playlist is a master playlist which references the media playlists "
+         u"of all renditions.\n\n"
+         u"The segments of all renditions are aligned. When the current segment of the first rendition reaches "
+         u"its target duration, all renditions start a new segment on the next PES packet (or intra-coded image "
+         u"with --intra-close) of their own video PID. With aligned GOP's in all renditions, all segments start "
+         u"on the same image. "
+         u"By default, one single rendition is generated with the complete transport stream.");
+
     option(u"slice-only");
     help(u"slice-only",
          u"Disable the insertion of the PAT and PMT at start of each segment. "
@@ -161,6 +180,7 @@ bool ts::hls::OutputPlugin::getOptions()
     getIntValue(_initialMediaSeq, u"start-media-sequence", 0);
     getIntValues(_closeLabels, u"label-close");
     getValues(_customTags, u"custom-tag");
+    getIntValues(_renditionServices, u"rendition");
 
     if (present(u"event")) {
         _playlistType = hls::PlayListType::EVENT;
@@ -186,48 +206,91 @@ bool ts::hls::OutputPlugin::getOptions()
         return false;
     }
 
+    if (!_renditionServices.empty()) {
+        if (_fixedSegmentSize > 0 || _sliceOnly) {
+            error(u"option --rendition is incompatible with --fixed-segment-size and --slice-only");
+            return false;
+        }
+        const std::set<uint16_t> services(_renditionServices.begin(), _renditionServices.end());
+        if (services.size() != _renditionServices.size()) {
+            error(u"duplicate service in --rendition");
+            return false;
+        }
+    }
+
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Build the name of a rendition file from a base name.
+//----------------------------------------------------------------------------
+
+fs::path ts::hls::OutputPlugin::RenditionFileName(const fs::path& base, uint16_t service_id, const UString& separator)
+{
+    fs::path name(base);
+    name.replace_extension();
+    name += UString::Format(u"-%d%s", service_id, separator);
+    name += base.extension();
+    return name;
+}
+
+
 //----------------------------------------------------------------------------
 // Output start method
 //----------------------------------------------------------------------------
 
 bool ts::hls::OutputPlugin::start()
 {
-    // Analyze the segment file name template to isolate segments.
-    _nameGenerator.initCounter(_segmentTemplate);
+    // Terminate a previous session, if any.
+    _writer.reset();
+    _writeError = false;
 
     // Initialize the demux to get the PAT and PMT.
     _demux.reset();
     _demux.setPIDFilter(NoPID());
     _demux.addPID(PID_PAT);
-    _patPackets.clear();
-    _pmtPackets.clear();
-    _pmtPID = PID_NULL;
-    _videoPID = PID_NULL;
-    _videoStreamType = ST_NULL;
-    _pcrAnalyzer.reset();
-    _previousBitrate = 0;
-
-    // Fix continuity counters in PAT PID. Will add the PMT PID when found.
-    _ccFixer.reset();
-    _ccFixer.setGenerator(true);
-    _ccFixer.setPIDFilter(NoPID());
-    _ccFixer.addPID(PID_PAT);
-
-    // Initialize the segment and playlist files.
-    _liveSegmentFiles.clear();
-    _segStarted = false;
-    _segClosePending = false;
-    if (_segmentFile.isOpen()) {
-        _segmentFile.close(*this);
-    }
-    if (!_playlistFile.empty()) {
-        _playlist.reset(_playlistType, _playlistFile);
-        _playlist.setTargetDuration(_targetDuration, *this);
-        _playlist.setMediaSequence(_initialMediaSeq, *this);
+
+    // Build the list of renditions. By default, there is only one rendition with the full TS.
+    _renditions.clear();
+    if (_renditionServices.empty()) {
+        _renditions.push_back(std::make_unique<Rendition>(*this, true, 0));
+    }
+    else {
+        for (auto id : _renditionServices) {
+            _renditions.push_back(std::make_unique<Rendition>(*this, false, id));
+        }
+    }
+
+    for (auto& r : _renditions) {
+        // Analyze the segment file name template to isolate segments.
+        r->name_generator.initCounter(r->full_ts ? _segmentTemplate : RenditionFileName(_segmentTemplate, r->service_id, u"-"));
+
+        // Fix continuity counters in PAT PID. Will add the PMT PID when found.
+        r->cc_fixer.setGenerator(true);
+        r->cc_fixer.addPID(PID_PAT);
+
+        // Initialize the media playlist.
+        if (!_playlistFile.empty()) {
+            r->playlist_file = r->full_ts ? _playlistFile : RenditionFileName(_playlistFile, r->service_id, u"");
+            r->playlist.reset(_playlistType, r->playlist_file);
+            r->playlist.setTargetDuration(_targetDuration, *this);
+            r->playlist.setMediaSequence(_initialMediaSeq, *this);
+            for (const auto& tag : _customTags) {
+                r->playlist.addCustomTag(tag);
+            }
+            // Use #EXT-X-INDEPENDENT-SEGMENTS if all segments are really independent.
+            if (!_sliceOnly) {
+                r->playlist.addCustomTag(u"EXT-X-INDEPENDENT-SEGMENTS");
+            }
+        }
+    }
+
+    // Start the thread which performs all file operations.
+    _writer = std::make_unique<Writer>();
+    if (!_writer->start()) {
+        error(u"error starting HLS writer thread");
+        return false;
     }
     return true;
 }
@@ -239,8 +302,67 @@ bool ts::hls::OutputPlugin::start()
 
 bool ts::hls::OutputPlugin::stop()
 {
-    // Simply close the current segment (and generate the corresponding playlist).
-    return closeCurrentSegment(true);
+    // Simply close the current segments (and generate the corresponding playlists).
+    bool ok = true;
+    for (auto& r : _renditions) {
+        ok = closeCurrentSegment(*r, true) && ok;
+    }
+
+    // Wait for the completion of all file operations.
+    _writer.reset();
+    return ok && !_writeError;
+}
+
+
+//----------------------------------------------------------------------------
+// Writer thread.
+//----------------------------------------------------------------------------
+
+ts::hls::OutputPlugin::Writer::~Writer()
+{
+    // Request the termination of the thread after all pending jobs.
+    _jobs.forceEnqueue(static_cast<Job*>(nullptr));
+    waitForTermination();
+}
+
+void ts::hls::OutputPlugin::Writer::main()
+{
+    for (;;) {
+        MessageQueue<Job>::MessagePtr job;
+        _jobs.dequeue(job);
+        if (job == nullptr) {
+            break;
+        }
+        (*job)();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Add the ECM PID's from the CA descriptors in a list of descriptors.
+//----------------------------------------------------------------------------
+
+void ts::hls::OutputPlugin::AddECMPIDs(PIDSet& pids, const DescriptorList& descs)
+{
+    // Loop on all CA descriptors (MPEG and ISDB).
+    for (size_t index = 0; index < descs.size(); ++index) {
+        if (descs[index]->tag() == DID_MPEG_CA || descs[index]->tag() == DID_ISDB_CA) {
+            // The fixed part of a CA descriptor is 4 bytes long.
+            if (descs[index]->payloadSize() >= 4) {
+                pids.set(GetUInt16(descs[index]->payload() + 2) & 0x1FFF);
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a packet contains the start of an intra-coded image.
+//----------------------------------------------------------------------------
+
+bool ts::hls::OutputPlugin::IsIntraImage(const Rendition& r, const TSPacket& pkt)
+{
+    return pkt.isClear() && PESPacket::FindIntraImage(pkt.getPayload(), pkt.getPayloadSize(), r.video_stream_type) != NPOS;
 }
 
 
@@ -248,31 +370,30 @@ bool ts::hls::OutputPlugin::stop()
 // Create the next segment file (also close the previous one if necessary).
 //----------------------------------------------------------------------------
 
-bool ts::hls::OutputPlugin::createNextSegment()
+bool ts::hls::OutputPlugin::createNextSegment(Rendition& r)
 {
     // Close the previous segment file.
-    if (!closeCurrentSegment(false)) {
+    if (!closeCurrentSegment(r, false)) {
         return false;
     }
 
     // Generate a new segment file name.
-    const UString fileName(_nameGenerator.newFileName());
+    r.segment_name = r.name_generator.newFileName();
+    r.segment_packets = 0;
 
-    // Create the segment file.
-    verbose(u"creating media segment %s", fileName);
-    if (!_segmentFile.open(fileName, TSFile::WRITE | TSFile::SHARED, *this)) {
-        return false;
-    }
+    // Create the segment file in the writer thread.
+    verbose(u"creating media segment %s", r.segment_name);
+    _writer->submit([this, &r, name = r.segment_name]() { openSegment(r, name); });
 
     // Reset the PCR analysis in each segment to get to bitrate of this segment.
-    _pcrAnalyzer.reset();
+    r.pcr_analyzer.reset();
 
     // Reset the indication to close the segment file.
-    _segClosePending = false;
+    r.close_pending = false;
 
     // Add a copy of the PAT and PMT at the beginning of each segment.
     if (!_sliceOnly) {
-        return writePackets(_patPackets.data(), _patPackets.size()) && writePackets(_pmtPackets.data(), _pmtPackets.size());
+        return writePackets(r, r.pat_packets.data(), r.pat_packets.size()) && writePackets(r, r.pmt_packets.data(), r.pmt_packets.size());
     }
 
     return true;
@@ -284,111 +405,96 @@ bool ts::hls::OutputPlugin::createNextSegment()
 // Also purge obsolete segment files and regenerate playlist.
 //----------------------------------------------------------------------------
 
-bool ts::hls::OutputPlugin::closeCurrentSegment(bool endOfStream)
+bool ts::hls::OutputPlugin::closeCurrentSegment(Rendition& r, bool endOfStream)
 {
     // If no segment file is open, there is nothing to do.
-    if (!_segmentFile.isOpen()) {
+    if (r.segment_name.empty()) {
         return true;
     }
 
     // Get the segment file name and size (to be inserted in the playlist).
-    const UString segName(_segmentFile.getFileName());
-    const PacketCounter segPackets = _segmentFile.writePacketsCount();
-
-    // Close the TS file.
-    if (!_segmentFile.close(*this)) {
-        return false;
-    }
-
-    // On live streams, we need to maintain a list of active segments.
-    if (_liveDepth > 0) {
-        _liveSegmentFiles.push_back(segName);
-    }
-
-    // Create or regenerate the playlist file.
-    if (!_playlistFile.empty()) {
+    const UString segName(r.segment_name);
+    const PacketCounter segPackets = r.segment_packets;
+    r.segment_name.clear();
 
-        // Set end of stream indicator in the playlist.
-        _playlist.setEndList(endOfStream, *this);
+    // Pass the last packets to the writer thread.
+    flushPackets(r);
 
-        // Declare a new segment.
-        hls::MediaSegment seg;
-        _playlist.buildURL(seg, segName);
+    // Describe the new segment for the playlist.
+    const bool withPlaylist = !r.playlist_file.empty();
+    hls::MediaSegment seg;
+    if (withPlaylist) {
 
         // Estimate duration and bitrate of the segment. We use PCR's from the
         // segment to compute the average bitrate. Then we compute the duration
         // from the bitrate and segment file size. If we cannot get the bitrate
         // of a segment but got one from previous segment, assume that bitrate
         // did not change and reuse previous one.
-        if (_pcrAnalyzer.bitrateIsValid()) {
+        BitRate segBitrate = 0;
+        if (r.pcr_analyzer.bitrateIsValid()) {
             // We have an estimation of the bitrate of the segment file.
-            _previousBitrate = _pcrAnalyzer.bitrate188();
+            r.previous_bitrate = r.pcr_analyzer.bitrate188();
         }
-        if (_previousBitrate > 0) {
+        if (r.previous_bitrate > 0) {
             // Compute duration based on segment bitrate (or previous one).
-            seg.bitrate = _useBitrateTag ? _previousBitrate : 0;
-            seg.duration = PacketInterval(_previousBitrate, segPackets);
+            segBitrate = r.previous_bitrate;
+            seg.duration = PacketInterval(r.previous_bitrate, segPackets);
         }
         else {
             // Completely unknown bitrate, we build a fake one based on the target duration.
             seg.duration = cn::duration_cast<cn::milliseconds>(_targetDuration);
-            seg.bitrate = _useBitrateTag ? PacketBitRate(segPackets, seg.duration) : 0;
+            segBitrate = PacketBitRate(segPackets, seg.duration);
         }
-        _playlist.addSegment(seg, *this);
+        seg.bitrate = _useBitrateTag ? segBitrate : 0;
 
-        // With live playlists, remove obsolete segments from the playlist.
-        while (_liveDepth > 0 && _playlist.segmentCount() > _liveDepth) {
-            _playlist.popFirstSegment();
-        }
-
-        // Add custom tags.
-        _playlist.clearCustomTags();
-        for (const auto& tag : _customTags) {
-            _playlist.addCustomTag(tag);
-        }
-
-        // Use #EXT-X-INDEPENDENT-SEGMENTS if all segments are really independent.
-        if (!_sliceOnly) {
-            _playlist.addCustomTag(u"EXT-X-INDEPENDENT-SEGMENTS");
-        }
+        // Accumulate statistics for the master playlist.
+        r.peak_bitrate = std::max(r.peak_bitrate, segBitrate);
+        r.total_packets += segPackets;
+        r.total_duration += seg.duration;
+    }
 
-        // Write the playlist file.
-        if (!_playlist.saveFile(UString(), *this)) {
-            return false;
-        }
+    // Close and publish the segment file, update the playlist and purge obsolete segments in the writer thread.
+    // The media playlist is owned by the writer thread, only the description of the new segment is passed.
+    _writer->submit([this, &r, segName, withPlaylist, seg, endOfStream]() {
+        finalizeSegment(r, segName, withPlaylist ? &seg : nullptr, endOfStream);
+    });
 
-        // WARNING: suggested improvement:
-        //   On Windows, if we overwrite the playlist file while a client is downloading it,
-        //   the file is locked by the HTTP server and the replacement will fail. We should
-        //   keep a list of failed deletions to retry these deletions later. On Unix systems,
-        //   we should not have the problem since the deletion succeeds even if the file
-        //   is already open (the file actually disappears when the file is closed).
+    // With several renditions, the master playlist references the new media playlist.
+    if (withPlaylist && !_renditionServices.empty()) {
+        updateMasterPlaylist();
     }
 
-    // Keep a list of segments we fail to delete (maybe because they are locked by the Web server).
-    UStringList failedDelete;
+    return !_writeError;
+}
 
-    // On live streams, purge obsolete segment files.
-    while (_liveDepth > 0 && _liveSegmentFiles.size() > _liveDepth + _liveExtraDepth) {
 
-        // Remove name of the file to delete from the list of active segment.
-        const UString name(_liveSegmentFiles.front());
-        _liveSegmentFiles.pop_front();
+//----------------------------------------------------------------------------
+// Regenerate the master playlist.
+//----------------------------------------------------------------------------
 
-        // Delete the segment file.
-        verbose(u"deleting obsolete segment file %s", name);
-        if (!fs::remove(name, &ErrCodeReport(*this, u"error deleting", name)) && fs::exists(name)) {
-            // Failed to delete, keep it to retry later.
-            failedDelete.push_back(name);
+void ts::hls::OutputPlugin::updateMasterPlaylist()
+{
+    _masterPlaylist.reset(hls::PlayListType::MASTER, _playlistFile);
+
+    // Reference all renditions for which a media playlist exists.
+    for (const auto& r : _renditions) {
+        if (r->total_packets > 0) {
+            hls::MediaPlayList mpl;
+            _masterPlaylist.buildURL(mpl, r->playlist_file);
+            mpl.bandwidth = r->peak_bitrate;
+            if (r->total_duration > cn::milliseconds::zero()) {
+                mpl.average_bandwidth = PacketBitRate(r->total_packets, r->total_duration);
+            }
+            _masterPlaylist.addPlayList(mpl, *this);
         }
     }
 
-    // Re-insert segments we failed to delete at head of list so that we will retry to delete them next time.
-    if (!failedDelete.empty()) {
-        _liveSegmentFiles.insert(_liveSegmentFiles.begin(), failedDelete.begin(), failedDelete.end());
-    }
-
-    return true;
+    // Write the master playlist after the media playlists.
+    _writer->submit([this, playlist = _masterPlaylist]() {
+        if (!_writeError && !savePlaylist(playlist, _playlistFile)) {
+            _writeError = true;
+        }
+    });
 }
 
 
@@ -398,21 +504,41 @@ bool ts::hls::OutputPlugin::closeCurrentSegment(bool endOfStream)
 
 void ts::hls::OutputPlugin::handleTable(SectionDemux& demux, const BinaryTable& table)
 {
-    // We need to collect the PAT and the (first) PMT.
-    TSPacketVector* packets = nullptr;
-
     switch (table.tableId()) {
         case TID_PAT: {
             const PAT pat(duck, table);
             if (pat.isValid()) {
-                packets = &_patPackets;
-                // Get the PMT of the first service.
-                if (!pat.pmts.empty()) {
-                    const uint16_t srv(pat.pmts.begin()->first);
-                    _pmtPID = pat.pmts.begin()->second;
-                    _demux.addPID(_pmtPID);
-                    _ccFixer.addPID(_pmtPID);
-                    verbose(u"using service id %n as reference, PMT PID %n", srv, _pmtPID);
+                for (auto& r : _renditions) {
+                    PID pmtPID = PID_NULL;
+                    OneShotPacketizer pzer(duck, PID_PAT);
+                    if (r->full_ts) {
+                        // Keep the complete PAT and get the PMT of the first service.
+                        pzer.addTable(table);
+                        if (!pat.pmts.empty()) {
+                            r->service_id = pat.pmts.begin()->first;
+                            pmtPID = pat.pmts.begin()->second;
+                        }
+                    }
+                    else {
+                        // Build a PAT which references the service of the rendition only.
+                        const auto it = pat.pmts.find(r->service_id);
+                        if (it == pat.pmts.end()) {
+                            warning(u"service %n not found in PAT", r->service_id);
+                            continue;
+                        }
+                        pmtPID = it->second;
+                        PAT rpat(pat.version, pat.is_current, pat.ts_id, pat.nit_pid);
+                        rpat.pmts[r->service_id] = pmtPID;
+                        pzer.addTable(duck, rpat);
+                    }
+                    pzer.getPackets(r->pat_packets);
+                    if (pmtPID != PID_NULL && pmtPID != r->pmt_pid) {
+                        r->pmt_pid = pmtPID;
+                        r->pids.set(pmtPID);
+                        _demux.addPID(pmtPID);
+                        r->cc_fixer.addPID(pmtPID);
+                        verbose(u"using service id %n as reference, PMT PID %n", r->service_id, pmtPID);
+                    }
                 }
             }
             break;
@@ -420,14 +546,34 @@ void ts::hls::OutputPlugin::handleTable(SectionDemux& demux, const BinaryTable&
         case TID_PMT: {
             const PMT pmt(duck, table);
             if (pmt.isValid()) {
-                packets = &_pmtPackets;
-                _videoPID = pmt.firstVideoPID(duck);
-                if (_videoPID == PID_NULL) {
-                    warning(u"no video PID found in service %n", pmt.service_id);
-                }
-                else {
-                    _videoStreamType = pmt.streams[_videoPID].stream_type;
-                    verbose(u"using video PID %n as reference", _videoPID);
+                for (auto& r : _renditions) {
+                    if (r->pmt_pid != table.sourcePID() || r->service_id != pmt.service_id) {
+                        continue;
+                    }
+                    OneShotPacketizer pzer(duck, table.sourcePID());
+                    pzer.addTable(table);
+                    pzer.getPackets(r->pmt_packets);
+                    r->video_pid = pmt.firstVideoPID(duck);
+                    if (r->video_pid == PID_NULL) {
+                        warning(u"no video PID found in service %n", pmt.service_id);
+                    }
+                    else {
+                        r->video_stream_type = pmt.streams[r->video_pid].stream_type;
+                        verbose(u"using video PID %n as reference", r->video_pid);
+                    }
+                    // In a service rendition, keep the PID's of the service only.
+                    if (!r->full_ts) {
+                        r->pids.reset();
+                        r->pids.set(r->pmt_pid);
+                        if (pmt.pcr_pid != PID_NULL) {
+                            r->pids.set(pmt.pcr_pid);
+                        }
+                        AddECMPIDs(r->pids, pmt.descs);
+                        for (const auto& it : pmt.streams) {
+                            r->pids.set(it.first);
+                            AddECMPIDs(r->pids, it.second.descs);
+                        }
+                    }
                 }
             }
             break;
@@ -437,13 +583,6 @@ void ts::hls::OutputPlugin::handleTable(SectionDemux& demux, const BinaryTable&
             break;
         }
     }
-
-    // If we need to packetize the table, do it now.
-    if (packets != nullptr) {
-        OneShotPacketizer pzer(duck, table.sourcePID());
-        pzer.addTable(table);
-        pzer.getPackets(*packets);
-    }
 }
 
 
@@ -451,38 +590,217 @@ void ts::hls::OutputPlugin::handleTable(SectionDemux& demux, const BinaryTable&
 // Write packets into the current segment file, adjust CC in PAT and PMT PID.
 //----------------------------------------------------------------------------
 
-bool ts::hls::OutputPlugin::writePackets(const TSPacket* pkt, size_t packetCount)
+bool ts::hls::OutputPlugin::writePackets(Rendition& r, const TSPacket* pkt, size_t packetCount)
 {
-    // Temporary packet buffer if a packet needs to be modified.
-    TSPacket tmp;
-
-    // Loop on all packets.
     for (size_t i = 0; i < packetCount; ++i) {
-
-        // Address of the next packet to write.
-        const TSPacket* p = pkt + i;
-
-        // If the packet comes from the PAT or PMT, get a copy and fix continuity counter.
+        r.buffer.push_back(pkt[i]);
+        // If the packet comes from the PAT or PMT, fix continuity counter in the copy.
         if (!_sliceOnly) {
             const PID pid = pkt[i].getPID();
-            if (pid == PID_PAT) {
-                tmp = *p;
-                _ccFixer.feedPacket(tmp);
-                p = &tmp;
-            }
-            else if (_pmtPID != PID_NULL && pid == _pmtPID) {
-                tmp = *p;
-                _ccFixer.feedPacket(tmp);
-                p = &tmp;
+            if (pid == PID_PAT || (r.pmt_pid != PID_NULL && pid == r.pmt_pid)) {
+                r.cc_fixer.feedPacket(r.buffer.back());
             }
         }
+    }
+    r.segment_packets += packetCount;
+
+    // Write the packets by batches in the writer thread.
+    if (r.buffer.size() >= WRITE_BATCH_PACKETS) {
+        flushPackets(r);
+    }
+    return !_writeError;
+}
+
+
+//----------------------------------------------------------------------------
+// Pass the buffered packets of a rendition to the writer thread.
+//----------------------------------------------------------------------------
+
+void ts::hls::OutputPlugin::flushPackets(Rendition& r)
+{
+    if (!r.buffer.empty()) {
+        _writer->submit([this, &r, packets = std::move(r.buffer)]() { writeSegment(r, packets); });
+        r.buffer.clear();
+        r.buffer.reserve(WRITE_BATCH_PACKETS);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Operations in the writer thread.
+//----------------------------------------------------------------------------
+
+void ts::hls::OutputPlugin::openSegment(Rendition& r, const UString& name)
+{
+    // The segment is written under a temporary name, until it is complete.
+    if (!_writeError && !r.file.open(name + TEMP_SUFFIX, TSFile::WRITE | TSFile::SHARED, *this)) {
+        _writeError = true;
+    }
+}
+
+void ts::hls::OutputPlugin::writeSegment(Rendition& r, const TSPacketVector& packets)
+{
+    if (!_writeError && r.file.isOpen() && !r.file.writePackets(packets.data(), nullptr, packets.size(), *this)) {
+        _writeError = true;
+    }
+}
+
+bool ts::hls::OutputPlugin::savePlaylist(const hls::PlayList& playlist, const UString& name)
+{
+    // Write the playlist under a temporary name and atomically replace the previous one.
+    const UString tempName(name + TEMP_SUFFIX);
+    bool success = playlist.saveFile(tempName, *this);
+    if (success) {
+        fs::rename(tempName, name, &ErrCodeReport(success, *this, u"error renaming", tempName));
+    }
+    return success;
+}
+
+void ts::hls::OutputPlugin::finalizeSegment(Rendition& r, const UString& name, const hls::MediaSegment* seg, bool endOfStream)
+{
+    if (_writeError || !r.file.isOpen()) {
+        return;
+    }
+
+    // Close the TS file and make it visible under its final name.
+    const UString tempName(r.file.getFileName());
+    bool success = r.file.close(*this);
+    if (success) {
+        fs::rename(tempName, name, &ErrCodeReport(success, *this, u"error renaming", tempName));
+    }
+
+    if (!success) {
+        _writeError = true;
+        return;
+    }
+
+    // Add the segment in the playlist and regenerate the playlist file.
+    if (seg != nullptr) {
+        hls::MediaSegment mseg(*seg);
+        r.playlist.buildURL(mseg, name);
+        r.playlist.setEndList(endOfStream, *this);
+        r.playlist.addSegment(mseg, *this);
+
+        // With live playlists, remove obsolete segments from the playlist.
+        while (_liveDepth > 0 && r.playlist.segmentCount() > _liveDepth) {
+            r.playlist.popFirstSegment();
+        }
+
+        if (!savePlaylist(r.playlist, r.playlist_file)) {
+            _writeError = true;
+            return;
+        }
+    }
+
+    // On live streams, we need to maintain a list of active segments.
+    if (_liveDepth > 0) {
+        r.live_segment_files.push_back(name);
+    }
+
+    // Keep a list of segments we fail to delete (maybe because they are locked by the Web server).
+    UStringList failedDelete;
+
+    // On live streams, purge obsolete segment files.
+    while (_liveDepth > 0 && r.live_segment_files.size() > _liveDepth + _liveExtraDepth) {
+
+        // Remove name of the file to delete from the list of active segment.
+        const UString obsolete(r.live_segment_files.front());
+        r.live_segment_files.pop_front();
 
-        // Write the packet in the segment file.
-        if (!_segmentFile.writePackets(p, nullptr, 1, *this)) {
+        // Delete the segment file.
+        verbose(u"deleting obsolete segment file %s", obsolete);
+        if (!fs::remove(obsolete, &ErrCodeReport(*this, u"error deleting", obsolete)) && fs::exists(obsolete)) {
+            // Failed to delete, keep it to retry later.
+            failedDelete.push_back(obsolete);
+        }
+    }
+
+    // Re-insert segments we failed to delete at head of list so that we will retry to delete them next time.
+    if (!failedDelete.empty()) {
+        r.live_segment_files.insert(r.live_segment_files.begin(), failedDelete.begin(), failedDelete.end());
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Process one packet in a rendition.
+//----------------------------------------------------------------------------
+
+bool ts::hls::OutputPlugin::sendPacket(Rendition& r, const TSPacket& pkt)
+{
+    const PID pid = pkt.getPID();
+
+    // In a service rendition, drop packets from other services and replace the PAT.
+    if (!r.full_ts) {
+        if (pid == PID_PAT) {
+            return !r.started || !pkt.getPUSI() || writePackets(r, r.pat_packets.data(), r.pat_packets.size());
+        }
+        else if (!r.pids.test(pid)) {
+            return true;
+        }
+    }
+
+    // Analyze PCR's from all packets.
+    r.pcr_analyzer.feedPacket(pkt);
+
+    // Check if we can start the generation of output segments.
+    if (!r.started) {
+        if (!_alignFirstSegment) {
+            // Without --align-first-segment, always start immediately (a service needs its PMT first).
+            r.started = r.full_ts || !r.pmt_packets.empty();
+        }
+        else if (!r.pat_packets.empty() && !r.pmt_packets.empty() && r.video_pid != PID_NULL && pid == r.video_pid && pkt.getPUSI()) {
+            // With --align-first-segment, need at least a PAT, PMT, PES packet on video PID.
+            // When --intra-close is also specified, start on intra image.
+            r.started = !_intraClose || IsIntraImage(r, pkt);
+        }
+        if (!r.started) {
+            return true;
+        }
+        // Create the first segment file.
+        if (!createNextSegment(r)) {
             return false;
         }
     }
-    return true;
+
+    // Check if we should close the current segment and create a new one.
+    bool renewNow = false;
+    bool renewOnPUSI = false;
+    if (_fixedSegmentSize > 0) {
+        // Each segment shall have a fixed size.
+        renewNow = r.segment_packets >= _fixedSegmentSize;
+    }
+    else if (r.close_pending && r.pcr_analyzer.bitrateIsValid()) {
+        // With --intra-close, force renew on next PES packet if extra duration is exceeded.
+        renewOnPUSI = PacketInterval(r.pcr_analyzer.bitrate188(), r.segment_packets) >= _targetDuration + _maxExtraDuration;
+    }
+
+    // We close only when we start a new PES packet or new intra-image on the video PID.
+    if (r.close_pending) {
+        if (r.video_pid == PID_NULL) {
+            debug(u"closing segment, no video PID was identified for synchronization");
+            renewNow = true;
+        }
+        else if (pid == r.video_pid && pkt.getPUSI()) {
+            // On a new video PES packet.
+            if (!_intraClose) {
+                debug(u"starting new segment on new PES packet");
+                renewNow = true;
+            }
+            else if (renewOnPUSI) {
+                debug(u"no I-frame found in last %s, starting new segment on new PES packet", _maxExtraDuration);
+                renewNow = true;
+            }
+            else if (IsIntraImage(r, pkt)) {
+                debug(u"starting new segment on new I-frame");
+                renewNow = true;
+            }
+        }
+    }
+
+    // Close current segment and recreate a new one when necessary.
+    // Finally write the packet.
+    return (!renewNow || createNextSegment(r)) && writePackets(r, &pkt, 1);
 }
 
 
@@ -493,7 +811,7 @@ bool ts::hls::OutputPlugin::writePackets(const TSPacket* pkt, size_t packetCount
 bool ts::hls::OutputPlugin::send(const TSPacket* pkt, const TSPacketMetadata* pktData, size_t packetCount)
 {
     const TSPacket* const lastPkt = pkt + packetCount;
-    bool ok = true;
+    bool ok = !_writeError;
 
     // Process packets one by one.
     while (ok && pkt < lastPkt) {
@@ -503,76 +821,24 @@ bool ts::hls::OutputPlugin::send(const TSPacket* pkt, const TSPacketMetadata* pk
             _demux.feedPacket(*pkt);
         }
 
-        // Analyze PCR's from all packets.
-        _pcrAnalyzer.feedPacket(*pkt);
-
-        // Check if we can start the generation of output segments.
-        if (!_segStarted) {
-            if (!_alignFirstSegment) {
-                // Without --align-first-segment, always start immediately.
-                _segStarted = true;
-            }
-            else if (!_patPackets.empty() && !_pmtPackets.empty() && _videoPID != PID_NULL && pkt->getPID() == _videoPID && pkt->getPUSI()) {
-                // With --align-first-segment, need at least a PAT, PMT, PES packet on video PID.
-                // When --intra-close is also specified, start on intra image.
-                _segStarted = !_intraClose || (pkt->isClear() && PESPacket::FindIntraImage(pkt->getPayload(), pkt->getPayloadSize(), _videoStreamType) != NPOS);
-            }
-            if (_segStarted) {
-                // Create the first segment file.
-                ok = createNextSegment();
-            }
-        }
-
-        // Process output packet only when the generation of segments is started.
-        if (ok && _segStarted) {
-
-            // Check if we should close the current segment and create a new one.
-            bool renewNow = false;
-            bool renewOnPUSI = false;
-            if (_fixedSegmentSize > 0) {
-                // Each segment shall have a fixed size.
-                renewNow = _segmentFile.writePacketsCount() >= _fixedSegmentSize;
-            }
-            else if (!_segClosePending) {
-                if (pktData->hasAnyLabel(_closeLabels)) {
-                    // This packet is a trigger to close the segment as soon as possible.
-                    _segClosePending = true;
-                }
-                else if (_pcrAnalyzer.bitrateIsValid()) {
-                    // The segment file shall be closed when the estimated duration exceeds the target duration.
-                    const cn::milliseconds segDuration = PacketInterval(_pcrAnalyzer.bitrate188(), _segmentFile.writePacketsCount());
-                    _segClosePending = segDuration >= _targetDuration;
-                    // With --intra-close, force renew on next PES packet if extra duration is exceeded.
-                    renewOnPUSI = segDuration >= _targetDuration + _maxExtraDuration;
-                }
-            }
-
-            // We close only when we start a new PES packet or new intra-image on the video PID.
-            if (_segClosePending) {
-                if (_videoPID == PID_NULL) {
-                    debug(u"closing segment, no video PID was identified for synchronization");
-                    renewNow = true;
-                }
-                else if (pkt->getPID() == _videoPID && pkt->getPUSI()) {
-                    // On a new video PES packet.
-                    if (!_intraClose) {
-                        debug(u"starting new segment on new PES packet");
-                        renewNow = true;
-                    }
-                    else if (renewOnPUSI) {
-                        debug(u"no I-frame found in last %s, starting new segment on new PES packet", _maxExtraDuration);
-                        renewNow = true;
-                    }
-                    else if (pkt->isClear() && PESPacket::FindIntraImage(pkt->getPayload(), pkt->getPayloadSize(), _videoStreamType) != NPOS) {
-                        debug(u"starting new segment on new I-frame");
-                        renewNow = true;
-                    }
+        // The decision to close the current segments is taken on the first rendition. All renditions
+        // are then renewed on their next video PES packet or intra image, keeping segments aligned.
+        const Rendition& ref(*_renditions.front());
+        if (_fixedSegmentSize == 0 && ref.started && !ref.close_pending) {
+            // A labelled packet is a trigger to close the segment as soon as possible.
+            // Otherwise, the segment file shall be closed when the estimated duration exceeds the target duration.
+            const bool closeAll = pktData->hasAnyLabel(_closeLabels) ||
+                (ref.pcr_analyzer.bitrateIsValid() && PacketInterval(ref.pcr_analyzer.bitrate188(), ref.segment_packets) >= _targetDuration);
+            if (closeAll) {
+                for (auto& r : _renditions) {
+                    r->close_pending = r->close_pending || r->started;
                 }
             }
+        }
 
-            // Close current segment and recreate a new one when necessary.
-            // Finally write the packet.
-            ok = (!renewNow || createNextSegment()) && writePackets(pkt, 1);
+        // Process the packet in all renditions.
+        for (size_t i = 0; ok && i < _renditions.size(); ++i) {
+            ok = sendPacket(*_renditions[i], *pkt);
         }
 
         // Process next packet.
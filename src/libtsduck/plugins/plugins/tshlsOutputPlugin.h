@@ -18,8 +18,11 @@
 #include "tsPCRAnalyzer.h"
 #include "tsContinuityAnalyzer.h"
 #include "tsFileNameGenerator.h"
+#include "tsMessageQueue.h"
+#include "tsThread.h"
 #include "tshlsPlayList.h"
 #include "tsStreamType.h"
+#include <functional>
 
 namespace ts {
     namespace hls {
@@ -32,6 +35,14 @@ namespace ts {
         //! playlists. To setup a complete HLS server, it is necessary to setup an
         //! external HTTP server such as Apache which simply serves these files.
         //!
+        //! Several renditions (one per service of the input TS) can be generated in
+        //! one single pass, with a master playlist referencing their media playlists.
+        //!
+        //! All file operations (writing, closing and renaming segments, regenerating
+        //! playlists, purging obsolete segments) are performed in a background thread.
+        //! Segment and playlist files are written under a temporary name and atomically
+        //! renamed when complete. Therefore, an HTTP server never serves incomplete files.
+        //!
         class TSDUCKDLL OutputPlugin: public ts::OutputPlugin, private TableHandlerInterface
         {
             TS_PLUGIN_CONSTRUCTORS(OutputPlugin);
@@ -44,9 +55,60 @@ namespace ts {
             virtual bool send(const TSPacket*, const TSPacketMetadata* pkt_data, size_t) override;
 
         private:
+            // Description of one output rendition: the full TS or a service. The fields are used
+            // in the plugin thread, except when marked as "writer thread".
+            class Rendition
+            {
+                TS_NOBUILD_NOCOPY(Rendition);
+            public:
+                Rendition(Report& report, bool full, uint16_t id) : full_ts(full), service_id(id), cc_fixer(NoPID(), &report) {}
+
+                const bool         full_ts;                    // Full TS, not a service subset.
+                uint16_t           service_id;                 // Reference service id.
+                PIDSet             pids {};                    // PID's of the service, including ECM PID's (service subset only).
+                PID                pmt_pid = PID_NULL;         // PID of the PMT of the reference service.
+                PID                video_pid = PID_NULL;       // Video PID on which the segmentation is evaluated.
+                uint8_t            video_stream_type = ST_NULL;// Stream type for video PID in PMT.
+                TSPacketVector     pat_packets {};             // TS packets for the PAT at start of each segment file.
+                TSPacketVector     pmt_packets {};             // TS packets for the PMT at start of each segment file, after the PAT.
+                ContinuityAnalyzer cc_fixer;                   // To fix continuity counters in PAT and PMT PID's.
+                FileNameGenerator  name_generator {};          // Generate the segment file names.
+                UString            playlist_file {};           // Media playlist file name.
+                PCRAnalyzer        pcr_analyzer {1, 4};        // PCR analyzer to compute bitrates. Minimum required: 1 PID, 4 PCR.
+                BitRate            previous_bitrate = 0;       // Bitrate of previous segment.
+                BitRate            peak_bitrate = 0;           // Peak bitrate of all segments.
+                PacketCounter      total_packets = 0;          // Total number of packets in all segments.
+                cn::milliseconds   total_duration {};          // Total duration of all segments.
+                bool               started = false;            // Generation of output segments has started.
+                bool               close_pending = false;      // Close the current segment when possible.
+                UString            segment_name {};            // Name of current segment, empty if none.
+                PacketCounter      segment_packets = 0;        // Number of packets in current segment.
+                TSPacketVector     buffer {};                  // Packets waiting to be passed to the writer thread.
+                TSFile             file {};                    // Output segment file (writer thread).
+                hls::PlayList      playlist {};                // Generated media playlist (writer thread).
+                UStringList        live_segment_files {};      // List of current segments in a live stream (writer thread).
+            };
+            using RenditionPtr = std::unique_ptr<Rendition>;
+
+            // A file operation to execute in the writer thread.
+            using Job = std::function<void()>;
+
+            // The thread which executes all file operations, in sequence.
+            class Writer: public Thread
+            {
+                TS_NOCOPY(Writer);
+            public:
+                Writer() : _jobs(MAX_JOBS) {}
+                virtual ~Writer() override;
+                void submit(Job&& job) { _jobs.enqueue(new Job(std::move(job))); }
+            private:
+                MessageQueue<Job> _jobs;
+                virtual void main() override;
+            };
+
             // Command line options.
             fs::path           _segmentTemplate {};         // Command line segment file names template.
-            fs::path           _playlistFile {};            // Playlist file name.
+            fs::path           _playlistFile {};            // Playlist file name (master playlist with renditions).
             bool               _intraClose = false;         // Try to start segments on intra images.
             bool               _useBitrateTag = false;      // Specify EXT-X-BITRATE tags for each segment in the playlist.
             bool               _alignFirstSegment = false;  // Align first segment to the first PAT and PMT.
@@ -60,40 +122,60 @@ namespace ts {
             size_t             _initialMediaSeq = 0;        // Initial media sequence value.
             UStringVector      _customTags {};              // Additional custom tags.
             TSPacketLabelSet   _closeLabels {};             // Close segment on packets with any of these labels.
+            std::vector<uint16_t> _renditionServices {};    // Service ids of the renditions.
 
             // Working data.
-            FileNameGenerator  _nameGenerator {};           // Generate the segment file names.
             SectionDemux       _demux;                      // Demux to extract PAT and PMT.
-            TSPacketVector     _patPackets {};              // TS packets for the PAT at start of each segment file.
-            TSPacketVector     _pmtPackets {};              // TS packets for the PMT at start of each segment file, after the PAT.
-            PID                _pmtPID = PID_NULL;          // PID of the PMT of the reference service.
-            PID                _videoPID = PID_NULL;        // Video PID on which the segmentation is evaluated.
-            uint8_t            _videoStreamType = ST_NULL;  // Stream type for video PID in PMT.
-            bool               _segStarted = false;         // Generation of output segments has started.
-            bool               _segClosePending = false;    // Close the current segment when possible.
-            TSFile             _segmentFile {};             // Output segment file.
-            UStringList        _liveSegmentFiles {};        // List of current segments in a live stream.
-            hls::PlayList      _playlist {};                // Generated playlist.
-            PCRAnalyzer        _pcrAnalyzer {1, 4};         // PCR analyzer to compute bitrates. Minimum required: 1 PID, 4 PCR.
-            BitRate            _previousBitrate = 0;        // Bitrate of previous segment.
-            ContinuityAnalyzer _ccFixer;                    // To fix continuity counters in PAT and PMT PID's.
+            std::vector<RenditionPtr> _renditions {};       // Output renditions, the first one is the reference for segmentation.
+            hls::PlayList      _masterPlaylist {};          // Generated master playlist, with renditions only.
+            std::atomic_bool   _writeError {false};         // An error occurred in the writer thread.
+            std::unique_ptr<Writer> _writer {};             // Writer thread, destroyed first.
 
             static constexpr cn::seconds DEFAULT_OUT_DURATION      = cn::seconds(10); // Default segment target duration for output streams.
             static constexpr cn::seconds DEFAULT_OUT_LIVE_DURATION = cn::seconds(5);  // Default segment target duration for output live streams.
             static constexpr cn::seconds DEFAULT_EXTRA_DURATION    = cn::seconds(2);  // Default segment extra duration when intra image is not found.
             static constexpr size_t      DEFAULT_LIVE_EXTRA_DEPTH  = 1;               // Default additional segments to keep in live streams.
+            static constexpr size_t      WRITE_BATCH_PACKETS       = 512;             // Number of packets which are passed at once to the writer thread.
+            static constexpr size_t      MAX_JOBS                  = 64;              // Maximum number of pending jobs in the writer thread.
+
+            // Suffix of temporary files, before atomic rename.
+            static constexpr const UChar* TEMP_SUFFIX = u".tmp";
+
+            // Build the name of a rendition file from a base name.
+            static fs::path RenditionFileName(const fs::path& base, uint16_t service_id, const UString& separator);
+
+            // Process one packet in a rendition.
+            bool sendPacket(Rendition&, const TSPacket&);
+
+            // Add the ECM PID's from the CA descriptors in a list of descriptors.
+            static void AddECMPIDs(PIDSet& pids, const DescriptorList& descs);
+
+            // Check if a packet contains the start of an intra-coded image on the video PID of a rendition.
+            static bool IsIntraImage(const Rendition&, const TSPacket&);
 
             // Create the next segment file (also close the previous one if necessary).
-            bool createNextSegment();
+            bool createNextSegment(Rendition&);
 
             // Close current segment file (also purge obsolete segment files and regenerate playlist).
-            bool closeCurrentSegment(bool endOfStream);
+            bool closeCurrentSegment(Rendition&, bool endOfStream);
+
+            // Regenerate the master playlist.
+            void updateMasterPlaylist();
 
             // Implementation of TableHandlerInterface.
             virtual void handleTable(SectionDemux&, const BinaryTable&) override;
 
             // Write packets into the current segment file, adjust CC in PAT and PMT PID.
-            bool writePackets(const TSPacket*, size_t);
+            bool writePackets(Rendition&, const TSPacket*, size_t);
+
+            // Pass the buffered packets of a rendition to the writer thread.
+            void flushPackets(Rendition&);
+
+            // Operations in the writer thread.
+            void openSegment(Rendition&, const UString& name);
+            void writeSegment(Rendition&, const TSPacketVector& packets);
+            void finalizeSegment(Rendition&, const UString& name, const hls::MediaSegment* seg, bool endOfStream);
+            bool savePlaylist(const hls::PlayList& playlist, const UString& name);
         };
     }
 }
@@ -197,6 +197,7 @@ void ts::tsmux::Core::main()
     PacketCounter next_sdt_packet = 0;
 
     // Insertion is cadenced using a monotonic clock.
+    _pacer.resetStatistics();
     const monotonic_time start(monotonic_time::clock::now());
     monotonic_time clock(start);
 
@@ -277,7 +278,7 @@ void ts::tsmux::Core::main()
 
         // Wait until next muxing period.
         if (!_terminate) {
-            std::this_thread::sleep_until(clock);
+            _pacer.waitUntil(clock);
         }
     }
 
@@ -287,7 +288,7 @@ void ts::tsmux::Core::main()
     // Or if the output thread terminated on error, we must terminate all input threads.
     stop();
 
-    _log.debug(u"core thread terminated");
+    _log.debug(u"core thread terminated, cadence: %s", _pacer.statistics());
 }
 
 
@@ -17,7 +17,9 @@
 #include "tstsmuxInputExecutor.h"
 #include "tstsmuxOutputExecutor.h"
 #include "tsTime.h"
+#include "tsPacingTimer.h"
 #include "tsSectionDemux.h"
+#include "tsPIDMap.h"
 #include "tsCyclingPacketizer.h"
 #include "tsPCRMerger.h"
 #include "tsPAT.h"
@@ -98,6 +100,7 @@ namespace ts {
             std::vector<Input*> _inputs;                   // Input plugins threads.
             OutputExecutor      _output {_opt, _handlers, _log}; // Output plugin thread.
             std::set<size_t>    _terminated_inputs {};     // Set of terminated input plugins.
+            PacingTimer         _pacer {};                 // Wait between muxing periods.
             CyclingPacketizer   _pat_pzer {_duck, PID_PAT, CyclingPacketizer::StuffingPolicy::ALWAYS};     // Packetizer for output PAT.
             CyclingPacketizer   _cat_pzer {_duck, PID_CAT, CyclingPacketizer::StuffingPolicy::ALWAYS};     // Packetizer for output CAT.
             CyclingPacketizer   _nit_pzer {_duck, PID_NIT, CyclingPacketizer::StuffingPolicy::ALWAYS};     // Packetizer for output NIT's.
@@ -109,7 +112,7 @@ namespace ts {
             NIT                 _output_nit {};            // NIT Actual for output stream.
             size_t              _max_eits = 128;           // Maximum number of buffered EIT sections, hard-coded for now.
             std::list<SectionPtr>     _eits {};            // List of EIT sections to insert.
-            std::map<PID,Origin>      _pid_origin {};      // Map of PID's to original input stream.
+            PIDMap<Origin>            _pid_origin {};      // Map of PID's to original input stream.
             std::map<uint16_t,Origin> _service_origin {};  // Map of service ids to original input stream.
 
             // Implementation of Thread.
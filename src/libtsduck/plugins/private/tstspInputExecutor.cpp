@@ -30,7 +30,7 @@ ts::tsp::InputExecutor::InputExecutor(const TSProcessorArgs& options,
     _input(dynamic_cast<InputPlugin*>(PluginThread::plugin())),
     _instuff_start_remain(options.instuff_start),
     _instuff_stop_remain(options.instuff_stop),
-    _pcr_analyzer(MIN_ANALYZE_PID, MIN_ANALYZE_PCR),
+    _bitrate_evaluator(MIN_ANALYZE_PID, MIN_ANALYZE_PCR, MIN_ANALYZE_DTS),
     _watchdog(this, options.receive_timeout, 0, *this)
 {
     if (options.log_plugin_index) {
@@ -38,8 +38,8 @@ ts::tsp::InputExecutor::InputExecutor(const TSProcessorArgs& options,
         setLogName(UString::Format(u"%s[0]", pluginName()));
     }
 
-    // Configure PTS/DTS analyze
-    _dts_analyzer.resetAndUseDTS(MIN_ANALYZE_PID, MIN_ANALYZE_DTS);
+    // With a fixed bitrate, there is no need to analyze the input packets.
+    _bitrate_evaluator.setExternalBitRate(options.fixed_bitrate > 0);
 
     // Propose receive timeout to input plugin.
     if (options.receive_timeout.count() > 0 && !_input->setReceiveTimeout(options.receive_timeout)) {
@@ -120,6 +120,9 @@ void ts::tsp::InputExecutor::getBitrate(BitRate& bitrate, BitRateConfidence& con
         confidence = _input->getBitrateConfidence();
     }
 
+    // The bitrate evaluator stops the analysis of input packets as long as the bitrate is externally provided.
+    _bitrate_evaluator.setExternalBitRate(bitrate != 0);
+
     if (bitrate != 0) {
         // Got a bitrate value from command line or plugin.
         if (_options.instuff_inpkt != 0) {
@@ -127,18 +130,16 @@ void ts::tsp::InputExecutor::getBitrate(BitRate& bitrate, BitRateConfidence& con
             bitrate = (bitrate * (_options.instuff_nullpkt + _options.instuff_inpkt)) / _options.instuff_inpkt;
         }
     }
-    else if (!_use_dts_analyzer && _pcr_analyzer.bitrateIsValid()) {
-        // Got a bitrate from the PCR's, continuously re-evaluated.
-        bitrate = _pcr_analyzer.bitrate188();
-        confidence = BitRateConfidence::PCR_CONTINUOUS;
-    }
     else {
-        // Still no bitrate available from PCR, try DTS from video PID's.
-        // If DTS are used at least once, continue to use them all the time.
-        _use_dts_analyzer = _use_dts_analyzer || _dts_analyzer.bitrateIsValid();
-        // Return the bitrate from DTS.
-        bitrate = _use_dts_analyzer ? _dts_analyzer.bitrate188() : 0;
+        // Get a bitrate from the PCR's or, if not available, the DTS from video PID's, continuously re-evaluated.
+        const BitRateEvaluator::Mode previous_mode = _bitrate_evaluator.mode();
+        bitrate = _bitrate_evaluator.evaluate();
         confidence = BitRateConfidence::PCR_CONTINUOUS;
+        if (_bitrate_evaluator.mode() != previous_mode) {
+            debug(u"input bitrate analysis switched from %s to %s mode, %'d packets analyzed out of %'d",
+                  BitRateEvaluator::ModeNames().name(previous_mode), BitRateEvaluator::ModeNames().name(_bitrate_evaluator.mode()),
+                  _bitrate_evaluator.analyzedPackets(), _bitrate_evaluator.totalPackets());
+        }
     }
 }
 
@@ -195,11 +196,10 @@ size_t ts::tsp::InputExecutor::receiveNullPackets(size_t index, size_t max_packe
     // Fill the buffer with null packets.
     for (size_t n = 0; n < max_packets; ++n) {
         pkt[n] = NullPacket;
-        _pcr_analyzer.feedPacket(pkt[n]);
-        _dts_analyzer.feedPacket(pkt[n]);
         data[n].reset();
         data[n].setInputStuffing(true);
     }
+    _bitrate_evaluator.feedPackets(pkt, max_packets);
 
     // Count those packets as not coming from the real input plugin.
     addNonPluginPackets(max_packets);
@@ -252,10 +252,6 @@ size_t ts::tsp::InputExecutor::receiveAndValidate(size_t index, size_t max_packe
         if (pkt[n].hasValidSync()) {
             // Count good packets from plugin
             addPluginPackets(1);
-
-            // Include packet in bitrate analysis.
-            _pcr_analyzer.feedPacket(pkt[n]);
-            _dts_analyzer.feedPacket(pkt[n]);
         }
         else {
             // Report error
@@ -277,6 +273,8 @@ size_t ts::tsp::InputExecutor::receiveAndValidate(size_t index, size_t max_packe
         }
     }
 
+    // Include valid packets in bitrate analysis.
+    _bitrate_evaluator.feedPackets(pkt, count);
     return count;
 }
 
@@ -14,7 +14,7 @@
 #pragma once
 #include "tstspPluginExecutor.h"
 #include "tsInputPlugin.h"
-#include "tsPCRAnalyzer.h"
+#include "tsBitRateEvaluator.h"
 #include "tsWatchDog.h"
 
 namespace ts {
@@ -76,9 +76,7 @@ namespace ts {
             size_t         _instuff_stop_remain = 0;
             size_t         _instuff_nullpkt_remain = 0;
             size_t         _instuff_inpkt_remain = 0;
-            PCRAnalyzer    _pcr_analyzer {};           // Compute input bitrate from PCR's.
-            PCRAnalyzer    _dts_analyzer {};           // Compute input bitrate from video DTS's.
-            bool           _use_dts_analyzer = false;  // Use DTS analyzer, not PCR analyzer.
+            BitRateEvaluator _bitrate_evaluator;       // Compute input bitrate from PCR's or video DTS's.
             WatchDog       _watchdog {};               // Watchdog when plugin does not support receive timeout.
             bool           _use_watchdog = false;      // The watchdog shall be used.
             monotonic_time _start_time {monotonic_time::clock::now()}; // Creation time, initialized with current system time.
@@ -99,7 +97,7 @@ namespace ts {
             size_t receiveAndStuff(size_t index, size_t max_packets);
 
             // Encapsulation of the plugin's getBitrate() method, taking into account the tsp input
-            // stuffing options. Use PCR analysis if bitrate not otherwise available.
+            // stuffing options. Use PCR/DTS analysis if bitrate not otherwise available.
             void getBitrate(BitRate& bitrate, BitRateConfidence& confidence);
 
             // Encapsulation of passPackets().
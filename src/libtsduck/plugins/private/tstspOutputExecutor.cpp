@@ -96,50 +96,60 @@ void ts::tsp::OutputExecutor::main()
             aborted = true;
         }
 
-        // Output the packets. Output may be segmented if dropped packets
-        // (ie. starting with a zero byte) are in the middle of the buffer.
-        TSPacket* pkt = _buffer->base() + pkt_first;
-        TSPacketMetadata* data = _metadata->base() + pkt_first;
+        // Output the packets. Dropped packets (ie. starting with a zero byte) may be in the
+        // middle of the buffer. The ranges of non-dropped packets are output together, using
+        // the vectored output interface, with respect to --max-output-packets.
+        const TSPacket* pkt = _buffer->base() + pkt_first;
+        const TSPacketMetadata* data = _metadata->base() + pkt_first;
         size_t pkt_remain = pkt_cnt;
 
         while (!aborted && pkt_remain > 0) {
 
-            // Skip dropped packets
-            size_t drop_cnt;
-            for (drop_cnt = 0; drop_cnt < pkt_remain && pkt[drop_cnt].b[0] == 0; drop_cnt++) {}
+            // Collect ranges of non-dropped packets.
+            size_t out_total = 0;
+            _ranges.clear();
 
-            pkt += drop_cnt;
-            data += drop_cnt;
-            pkt_remain -= drop_cnt;
-            addNonPluginPackets(drop_cnt);
+            while (pkt_remain > 0 && out_total < _options.max_output_pkt) {
 
-            // Find last non-dropped packet
-            size_t out_cnt = 0;
-            while (out_cnt < pkt_remain && pkt[out_cnt].b[0] != 0) {
-                out_cnt++;
-            }
+                // Skip dropped packets
+                size_t drop_cnt;
+                for (drop_cnt = 0; drop_cnt < pkt_remain && pkt[drop_cnt].b[0] == 0; drop_cnt++) {}
 
-            // Output contiguous ranges of non-dropped packets with respect to --max-output-packets.
-            while (!aborted && out_cnt > 0) {
-                const size_t out_subcnt = std::min(out_cnt, _options.max_output_pkt);
-                if (_suspended) {
-                    // Don't output packet when the plugin is suspended.
-                    addNonPluginPackets(out_subcnt);
-                }
-                else if (_output->send(pkt, data, out_subcnt)) {
-                    // Packet successfully sent.
-                    addPluginPackets(out_subcnt);
-                    output_packets += out_subcnt;
+                pkt += drop_cnt;
+                data += drop_cnt;
+                pkt_remain -= drop_cnt;
+                addNonPluginPackets(drop_cnt);
+
+                // Find last non-dropped packet
+                size_t out_cnt = 0;
+                while (out_cnt < pkt_remain && out_total + out_cnt < _options.max_output_pkt && pkt[out_cnt].b[0] != 0) {
+                    out_cnt++;
                 }
-                else {
-                    // Send error.
-                    aborted = true;
-                    break;
+                if (out_cnt > 0) {
+                    _ranges.emplace_back(pkt, data, out_cnt);
+                    pkt += out_cnt;
+                    data += out_cnt;
+                    pkt_remain -= out_cnt;
+                    out_total += out_cnt;
                 }
-                pkt += out_subcnt;
-                data += out_subcnt;
-                pkt_remain -= out_subcnt;
-                out_cnt -= out_subcnt;
+            }
+
+            // Output the collected ranges.
+            if (out_total == 0) {
+                // Only dropped packets.
+            }
+            else if (_suspended) {
+                // Don't output packet when the plugin is suspended.
+                addNonPluginPackets(out_total);
+            }
+            else if (_ranges.size() == 1 ? _output->send(_ranges[0].packets, _ranges[0].metadata, out_total) : _output->sendVector(_ranges.data(), _ranges.size())) {
+                // Packets successfully sent.
+                addPluginPackets(out_total);
+                output_packets += out_total;
+            }
+            else {
+                // Send error.
+                aborted = true;
             }
         }
 
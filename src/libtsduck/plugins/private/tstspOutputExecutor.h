@@ -51,7 +51,8 @@ namespace ts {
             virtual size_t pluginIndex() const override;
 
         private:
-            OutputPlugin* _output = nullptr;
+            OutputPlugin*       _output = nullptr;
+            TSPacketRangeVector _ranges {};  // Ranges of non-dropped packets to output.
 
             // Inherited from Thread
             virtual void main() override;
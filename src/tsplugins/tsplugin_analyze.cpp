@@ -194,6 +194,7 @@ bool ts::AnalyzePlugin::produceReport()
         // Produce the report
         _analyzer.report(*_output, _analyzer_options, *this);
         closeOutput();
+        verbose(u"analysis memory footprint: %'d bytes", _analyzer.memoryFootprint());
         return true;
     }
 }
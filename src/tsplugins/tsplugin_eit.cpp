@@ -99,6 +99,9 @@ ts::EITPlugin::EITPlugin(TSP* tsp_) :
 {
     option(u"output-file", 'o', FILENAME);
     help(u"output-file", u"Specify the output file for the report (default: standard output).");
+
+    // All EIT sections are individually analyzed, allocate them from a memory arena.
+    _demux.useSectionArena(true);
 }
 
 ts::EITPlugin::ServiceDesc::~ServiceDesc()
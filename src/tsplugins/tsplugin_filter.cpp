@@ -12,10 +12,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsPluginRepository.h"
-#include "tsSignalizationDemux.h"
-#include "tsISDBTInformation.h"
-#include "tsAlgorithm.h"
-#include "tsMemory.h"
+#include "tsPacketClassifier.h"
 
 
 //----------------------------------------------------------------------------
@@ -23,7 +20,7 @@
 //----------------------------------------------------------------------------
 
 namespace ts {
-    class FilterPlugin: public ProcessorPlugin, private SignalizationHandlerInterface
+    class FilterPlugin: public ProcessorPlugin
     {
         TS_PLUGIN_CONSTRUCTORS(FilterPlugin);
     public:
@@ -34,52 +31,10 @@ namespace ts {
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
-        // Packet intervals and list of them.
-        using PacketRange = std::pair<PacketCounter, PacketCounter>;
-        using PacketRangeList = std::list<PacketRange>;
-
         // Command line options:
         Status             _drop_status = TSP_DROP;     // Return status for unselected packets
-        int                _scrambling_ctrl = 0;        // Scrambling control value (<0: no filter)
-        bool               _need_demux = false;         // Need the help of the signalization demux.
-        bool               _with_payload = false;       // Packets with payload
-        bool               _with_af = false;            // Packets with adaptation field
-        bool               _with_pes = false;           // Packets with clear PES headers
-        bool               _with_pcr = false;           // Packets with PCR or OPCR
-        bool               _with_splice = false;        // Packets with splice_countdown in adaptation field
-        bool               _unit_start = false;         // Packets with payload unit start
-        bool               _intra_frame = false;        // Packets with start of video intra-frame
-        bool               _nullified = false;          // Packets which were nullified by a previous plugin
-        bool               _input_stuffing = false;     // Null packets which were artificially inserted
-        bool               _valid = false;              // Packets with valid sync byte and error ind
         bool               _negate = false;             // Negate filter (exclude selected packets)
-        bool               _video = false;              // Part of a video PID
-        bool               _audio = false;              // Part of an audio PID
-        bool               _subtitles = false;          // Part of a subtitles PID
-        bool               _ecm = false;                // Part of an ECM PID
-        bool               _emm = false;                // Part of an EMM PID
-        bool               _psi = false;                // Part of global PSI/SI PID.
-        int                _min_payload = 0;            // Minimum payload size (<0: no filter)
-        int                _max_payload = 0;            // Maximum payload size (<0: no filter)
-        int                _min_af = 0;                 // Minimum adaptation field size (<0: no filter)
-        int                _max_af = 0;                 // Maximum adaptation field size (<0: no filter)
-        int                _splice = 0;                 // Exact splice_countdown value (<-128: no filter)
-        int                _min_splice = 0;             // Minimum splice_countdown value (<-128: no filter)
-        int                _max_splice = 0;             // Maximum splice_countdown value (<-128: no filter)
         PacketCounter      _after_packets = 0;          // Number of initial packets to skip
-        PacketCounter      _every_packets = 0;          // Filter 1 out of this number of packets
-        CodecType          _codec = CodecType::UNDEFINED; // Filter on codec type
-        PIDSet             _explicit_pid {};            // Explicit PID values to filter
-        ByteBlock          _pattern {};                 // Byte pattern to search.
-        bool               _search_payload = false;     // Search pattern in payload only
-        bool               _use_search_offset = false;  // Search at specified offset only
-        size_t             _search_offset = 0;          // Offset where to search.
-        PacketRangeList    _ranges {};                  // Ranges of packets to filter.
-        std::set<uint8_t>  _stream_ids {};              // PES stream ids to filter
-        std::set<uint8_t>  _isdb_layers {};             // ISDB layers to filter
-        std::set<uint16_t> _service_ids {};             // Service ids to filter
-        UStringVector      _service_names {};           // Service names to filter.
-        TSPacketLabelSet   _labels {};                  // Select packets with any of these labels
         TSPacketLabelSet   _set_labels {};              // Labels to set on filtered packets
         TSPacketLabelSet   _reset_labels {};            // Labels to reset on filtered packets
         TSPacketLabelSet   _set_perm_labels {};         // Labels to set on all packets after getting one packet
@@ -87,12 +42,11 @@ namespace ts {
 
         // Working data:
         PacketCounter      _filtered_packets = 0;       // Number of filtered packets
-        PIDSet             _stream_id_pid {};           // PID values selected from stream ids
-        std::set<uint16_t> _all_service_ids {};         // All service ids to filter, after service name resolution
-        SignalizationDemux _demux {duck};               // Full signalization demux
+        PacketClassifier   _classifier {duck};          // Compiled selection criteria.
 
-        // Implementation of SignalizationHandlerInterface
-        virtual void handleService(uint16_t ts_id, const Service& service, const PMT& pmt, bool removed) override;
+        // Add a per-packet predicate when an option is present.
+        void addPredicate(const UChar* name, PacketClassifier::Predicate pred);
+        void addIntPredicate(const UChar* name, PacketClassifier::Predicate pred);
     };
 }
 
@@ -328,63 +282,102 @@ ts::FilterPlugin::FilterPlugin(TSP* tsp_) :
 
 bool ts::FilterPlugin::getOptions()
 {
-    _scrambling_ctrl = present(u"clear") ? 0 : intValue(u"scrambling-control", -1);
-    _with_payload = present(u"payload");
-    _with_af = present(u"adaptation-field");
-    _with_pes = present(u"pes");
-    _with_pcr = present(u"pcr");
-    _with_splice = present(u"has-splice-countdown");
-    _unit_start = present(u"unit-start");
-    _intra_frame = present(u"intra-frame");
-    _nullified = present(u"nullified");
-    _input_stuffing = present(u"input-stuffing");
-    _valid = present(u"valid");
-    _audio = present(u"audio");
-    _video = present(u"video");
-    _subtitles = present(u"subtitles");
-    _ecm = present(u"ecm");
-    _emm = present(u"emm");
-    _psi = present(u"psi-si");
+    using Predicate = PacketClassifier::Predicate;
+
     _negate = present(u"negate");
-    getValues(_service_names, u"service");
-    getIntValue(_min_payload, u"min-payload-size", -1);
-    getIntValue(_max_payload, u"max-payload-size", -1);
-    getIntValue(_min_af, u"min-adaptation-field-size", -1);
-    getIntValue(_max_af, u"max-adaptation-field-size", -1);
-    getIntValue(_splice, u"splice-countdown", INT_MIN);
-    getIntValue(_min_splice, u"min-splice-countdown", INT_MIN);
-    getIntValue(_max_splice, u"max-splice-countdown", INT_MIN);
     getIntValue(_after_packets, u"after-packets");
-    getIntValue(_every_packets, u"every");
-    getIntValue(_codec, u"codec", CodecType::UNDEFINED);
-    getIntValues(_explicit_pid, u"pid");
-    getIntValues(_stream_ids, u"stream-id");
-    getIntValues(_isdb_layers, u"isdb-layer");
-    getIntValues(_labels, u"label");
     getIntValues(_set_labels, u"set-label");
     getIntValues(_reset_labels, u"reset-label");
     getIntValues(_set_perm_labels, u"set-permanent-label");
     getIntValues(_reset_perm_labels, u"reset-permanent-label");
-    _search_payload = present(u"search-payload");
-    _use_search_offset = present(u"search-offset");
-    getIntValue(_search_offset, u"search-offset");
-    getHexaValue(_pattern, u"pattern");
+
+    // Compile all selection criteria in the packet classifier.
+    _classifier.clear();
+
+    // PID-level criteria.
+    PIDSet pids;
+    getIntValues(pids, u"pid");
+    _classifier.setVerdict(pids, PacketClassifier::PASS);
+    if (present(u"audio")) {
+        _classifier.selectPIDClass(PIDClass::AUDIO);
+    }
+    if (present(u"video")) {
+        _classifier.selectPIDClass(PIDClass::VIDEO);
+    }
+    if (present(u"subtitles")) {
+        _classifier.selectPIDClass(PIDClass::SUBTITLES);
+    }
+    if (present(u"ecm")) {
+        _classifier.selectPIDClass(PIDClass::ECM);
+    }
+    if (present(u"emm")) {
+        _classifier.selectPIDClass(PIDClass::EMM);
+    }
+    if (present(u"psi-si")) {
+        _classifier.selectPIDClass(PIDClass::PSI);
+    }
+    if (present(u"codec")) {
+        _classifier.selectCodec(intValue(u"codec", CodecType::UNDEFINED));
+    }
+    UStringVector services;
+    getValues(services, u"service");
+    for (const auto& srv : services) {
+        _classifier.selectService(srv);
+    }
+
+    // Per-packet criteria.
+    addPredicate(u"payload", Predicate::PAYLOAD);
+    addPredicate(u"adaptation-field", Predicate::ADAPTATION_FIELD);
+    addPredicate(u"unit-start", Predicate::UNIT_START);
+    addPredicate(u"pes", Predicate::PES_START);
+    addPredicate(u"pcr", Predicate::HAS_PCR);
+    addPredicate(u"has-splice-countdown", Predicate::SPLICE_COUNTDOWN);
+    addPredicate(u"valid", Predicate::VALID);
+    addPredicate(u"nullified", Predicate::NULLIFIED);
+    addPredicate(u"input-stuffing", Predicate::INPUT_STUFFING);
+    addPredicate(u"intra-frame", Predicate::INTRA_FRAME);
+    addIntPredicate(u"splice-countdown", Predicate::SPLICE_EQUAL);
+    addIntPredicate(u"min-splice-countdown", Predicate::SPLICE_MIN);
+    addIntPredicate(u"max-splice-countdown", Predicate::SPLICE_MAX);
+    addIntPredicate(u"min-payload-size", Predicate::MIN_PAYLOAD);
+    addIntPredicate(u"max-payload-size", Predicate::MAX_PAYLOAD);
+    addIntPredicate(u"min-adaptation-field-size", Predicate::MIN_AF);
+    addIntPredicate(u"max-adaptation-field-size", Predicate::MAX_AF);
+    if (present(u"clear")) {
+        _classifier.selectPredicate(Predicate::SCRAMBLING, SC_CLEAR);
+    }
+    else {
+        addIntPredicate(u"scrambling-control", Predicate::SCRAMBLING);
+    }
+
+    TSPacketLabelSet labels;
+    getIntValues(labels, u"label");
+    _classifier.selectLabels(labels);
+
+    std::set<uint8_t> ids;
+    getIntValues(ids, u"stream-id");
+    _classifier.selectStreamIds(ids);
+    getIntValues(ids, u"isdb-layer");
+    _classifier.selectISDBLayers(ids);
+
+    PacketCounter every = 0;
+    getIntValue(every, u"every");
+    _classifier.selectEvery(every, _after_packets);
 
     // Decode all index ranges.
-    _ranges.clear();
     UStringVector intervals;
     getValues(intervals, u"interval");
     for (const auto& it : intervals) {
         PacketCounter first = 0;
         PacketCounter second = 0;
         if (it.scan(u"%d-%d", &first, &second)) {
-            _ranges.push_back(std::make_pair(first, second));
+            _classifier.selectPacketRange(first, second);
         }
         else if (it.scan(u"%d-", &first)) {
-            _ranges.push_back(std::make_pair(first, std::numeric_limits<PacketCounter>::max()));
+            _classifier.selectPacketRange(first, std::numeric_limits<PacketCounter>::max());
         }
         else if (it.scan(u"%d", &first)) {
-            _ranges.push_back(std::make_pair(first, first));
+            _classifier.selectPacketRange(first, first);
         }
         else {
             error(u"invalid packet range %s", it);
@@ -393,10 +386,18 @@ bool ts::FilterPlugin::getOptions()
     }
 
     // Check that the pattern to search is not larger than the packet.
-    if (_pattern.size() > PKT_SIZE || (_use_search_offset && _search_offset + _pattern.size() > PKT_SIZE)) {
+    ByteBlock pattern;
+    size_t search_offset = 0;
+    const bool use_search_offset = present(u"search-offset");
+    getHexaValue(pattern, u"pattern");
+    getIntValue(search_offset, u"search-offset");
+    if (pattern.size() > PKT_SIZE || (use_search_offset && search_offset + pattern.size() > PKT_SIZE)) {
         error(u"search pattern too large for TS packets");
         return false;
     }
+    if (!pattern.empty()) {
+        _classifier.selectPattern(pattern, present(u"search-payload"), use_search_offset, search_offset);
+    }
 
     // Status for unselected packets.
     if (_set_labels.any() || _reset_labels.any() || _set_perm_labels.any() || _reset_perm_labels.any()) {
@@ -412,30 +413,26 @@ bool ts::FilterPlugin::getOptions()
         _drop_status = TSP_DROP;
     }
 
-    // Sort service names and service ids.
-    _service_ids.clear();
-    for (auto it = _service_names.begin(); it != _service_names.end(); ) {
-        uint16_t srvid = 0;
-        if (it->toInteger(srvid, UString::DEFAULT_THOUSANDS_SEPARATOR)) {
-            // This is a service id, remove it from service names.
-            _service_ids.insert(srvid);
-            it = _service_names.erase(it);
-        }
-        else {
-            // Keep service name, move to next.
-            ++it;
-        }
-    }
+    return true;
+}
 
-    // These options need the assistance of a full signalization demux:
-    _need_demux =
-        _audio || _video || _subtitles || _ecm || _emm || _psi || _intra_frame ||
-        _codec != CodecType::UNDEFINED || !_service_ids.empty() || !_service_names.empty();
 
-    // If we look for service names, we also need to be notified of changes in service list.
-    _demux.setHandler(_service_names.empty() ? nullptr : this);
+//----------------------------------------------------------------------------
+// Add a per-packet predicate when an option is present.
+//----------------------------------------------------------------------------
 
-    return true;
+void ts::FilterPlugin::addPredicate(const UChar* name, PacketClassifier::Predicate pred)
+{
+    if (present(name)) {
+        _classifier.selectPredicate(pred);
+    }
+}
+
+void ts::FilterPlugin::addIntPredicate(const UChar* name, PacketClassifier::Predicate pred)
+{
+    if (present(name)) {
+        _classifier.selectPredicate(pred, intValue<int>(name));
+    }
 }
 
 
@@ -446,9 +443,7 @@ bool ts::FilterPlugin::getOptions()
 bool ts::FilterPlugin::start()
 {
     _filtered_packets = 0;
-    _all_service_ids = _service_ids;
-    _stream_id_pid.reset();
-    _demux.reset();
+    _classifier.restart();
     return true;
 }
 
@@ -470,12 +465,8 @@ bool ts::FilterPlugin::stop()
 
 ts::ProcessorPlugin::Status ts::FilterPlugin::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
 {
-    const PID pid = pkt.getPID();
-
-    // Pass packets in the signalization demux only if needed.
-    if (_need_demux) {
-        _demux.feedPacket(pkt);
-    }
+    // Pass packets in the signalization demux (only if needed).
+    _classifier.feedPacket(pkt);
 
     // Pass initial packets without filtering.
     const PacketCounter packetIndex = tsp->pluginPackets();
@@ -483,71 +474,8 @@ ts::ProcessorPlugin::Status ts::FilterPlugin::processPacket(TSPacket& pkt, TSPac
         return TSP_OK;
     }
 
-    // Check stream ids of PES packets. The stream id is in the fourth byte of
-    // the payload of a TS packet containing the start of a PES packet.
-    if (!_stream_ids.empty() && pkt.startPES() && pkt.getPayloadSize() >= 4) {
-        const uint8_t id = pkt.getPayload()[3];
-        const bool selected = _stream_ids.contains(id);
-        _stream_id_pid.set(pid, selected);
-    }
-
     // Check if the packet matches one of the selected criteria.
-    const PIDClass pidclass = _demux.pidClass(pid);
-    bool ok = _explicit_pid[pid] ||
-        pkt_data.hasAnyLabel(_labels) ||
-        _stream_id_pid[pid] ||
-        _demux.inAnyService(pid, _all_service_ids) ||
-        (_with_payload && pkt.hasPayload()) ||
-        (_with_af && pkt.hasAF()) ||
-        (_unit_start && pkt.getPUSI()) ||
-        (_codec != CodecType::UNDEFINED && _demux.codecType(pid) == _codec) ||
-        (_audio && pidclass == PIDClass::AUDIO) ||
-        (_video && pidclass == PIDClass::VIDEO) ||
-        (_subtitles && pidclass == PIDClass::SUBTITLES) ||
-        (_ecm && pidclass == PIDClass::ECM) ||
-        (_emm && pidclass == PIDClass::EMM) ||
-        (_psi && pidclass == PIDClass::PSI) ||
-        (_intra_frame && _demux.atIntraFrame(pid)) ||
-        (_nullified && pkt_data.getNullified()) ||
-        (_input_stuffing && pkt_data.getInputStuffing()) ||
-        (_valid && pkt.hasValidSync() && !pkt.getTEI()) ||
-        (_scrambling_ctrl == pkt.getScrambling()) ||
-        (_with_pcr && (pkt.hasPCR() || pkt.hasOPCR())) ||
-        (_with_splice && pkt.hasSpliceCountdown()) ||
-        (_splice >= -128 && pkt.hasSpliceCountdown() && pkt.getSpliceCountdown() == _splice) ||
-        (_min_splice >= -128 && pkt.hasSpliceCountdown() && pkt.getSpliceCountdown() >= _min_splice) ||
-        (_max_splice >= -128 && pkt.hasSpliceCountdown() && pkt.getSpliceCountdown() <= _max_splice) ||
-        (_min_payload >= 0 && int(pkt.getPayloadSize()) >= _min_payload) ||
-        (int(pkt.getPayloadSize()) <= _max_payload) ||
-        (_min_af >= 0 && int(pkt.getAFSize()) >= _min_af) ||
-        (int(pkt.getAFSize()) <= _max_af) ||
-        (_every_packets > 0 && (tsp->pluginPackets() - _after_packets) % _every_packets == 0) ||
-        (_with_pes && pkt.startPES());
-
-    // Get ISDB layer if required.
-    if (!ok && !_isdb_layers.empty()) {
-        // Do not check if ISDB is part of the standards, assume it if option --isdb-layer is present.
-        const ISDBTInformation info(duck, pkt_data, false);
-        ok = info.is_valid && _isdb_layers.contains(info.layer_indicator);
-    }
-
-    // Search binary patterns in packets.
-    if (!ok && !_pattern.empty()) {
-        const size_t start = _search_payload ? pkt.getHeaderSize() : 0;
-        if (start + _search_offset + _pattern.size() <= PKT_SIZE) {
-            if (_use_search_offset) {
-                ok = MemEqual(pkt.b + start + _search_offset, _pattern.data(), _pattern.size());
-            }
-            else {
-                ok = LocatePattern(pkt.b + start, PKT_SIZE - start, _pattern.data(), _pattern.size()) != nullptr;
-            }
-        }
-    }
-
-    // Search if packet is in one selected range.
-    for (auto it = _ranges.begin(); !ok && it != _ranges.end(); ++it) {
-        ok = packetIndex >= it->first && packetIndex <= it->second;
-    }
+    bool ok = _classifier.isSelected(pkt, pkt_data, packetIndex);
 
     // Reverse selection criteria with --negate.
     if (_negate) {
@@ -570,21 +498,3 @@ ts::ProcessorPlugin::Status ts::FilterPlugin::processPacket(TSPacket& pkt, TSPac
     return ok ? TSP_OK : _drop_status;
 }
 
-
-//----------------------------------------------------------------------------
-// Handle potential changes in the service list.
-//----------------------------------------------------------------------------
-
-void ts::FilterPlugin::handleService(uint16_t ts_id, const Service& service, const PMT& pmt, bool removed)
-{
-    const UString service_name(service.getName());
-    debug(u"handling updated services, TS id: %n, service: %n, \"%s\"", ts_id, service.getId(), service_name);
-
-    // If the service is filtered by name from the command line, add its service id in the filters.
-    for (const auto& name : _service_names) {
-        if (service.hasId() && name.similar(service_name)) {
-            _all_service_ids.insert(service.getId());
-            break;
-        }
-    }
-}
@@ -14,6 +14,7 @@
 #include "tsPluginRepository.h"
 #include "tsBinaryTable.h"
 #include "tsSectionDemux.h"
+#include "tsPIDMap.h"
 #include "tsPESPacket.h"
 #include "tsTime.h"
 #include "tsCAS.h"
@@ -78,7 +79,7 @@ namespace ts {
         bool          _last_tdt_reported = false; // Last TDT already reported
         bool          _bitrate_error = false;     // Already reported an "unknown bitrate" error
         SectionDemux  _demux {duck, this, this};  // Section filter
-        std::map<PID,PIDContext> _cpids {};       // Description of each PID
+        PIDMap<PIDContext>       _cpids {};       // Description of each PID
 
         // Number of packets after which we report a warning if the bitrate is unknown.
         // This is one second of content at 10 Mb/s.
@@ -13,6 +13,7 @@
 
 #include "tsPluginRepository.h"
 #include "tsSectionDemux.h"
+#include "tsPIDMap.h"
 #include "tsBinaryTable.h"
 #include "tsPAT.h"
 #include "tsPMT.h"
@@ -42,7 +43,7 @@ namespace ts {
         // Context per PID in the TS.
         class PIDContext;
         using PIDContextPtr = std::shared_ptr<PIDContext>;
-        using PIDContextMap = std::map<PID, PIDContextPtr>;
+        using PIDContextMap = PIDMap<PIDContextPtr>;
 
         // Plugin fields.
         bool           _useWallClock = false;
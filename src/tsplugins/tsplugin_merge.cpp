@@ -11,7 +11,8 @@
 //
 //  Definitions:
 //  - Main stream: the TS which is processed by tsp, including this plugin.
-//  - Merged stream: the additional TS which is read by this plugin through a pipe.
+//  - Merged stream: the additional TS which is read by this plugin through a pipe
+//    or produced by an in-process chain of plugins.
 //
 //----------------------------------------------------------------------------
 
@@ -20,6 +21,10 @@
 #include "tsPSIMerger.h"
 #include "tsTSForkPipe.h"
 #include "tsTSPacketQueue.h"
+#include "tsTSProcessor.h"
+#include "tsArgsWithPlugins.h"
+#include "tsPluginEventHandlerInterface.h"
+#include "tsMemoryOutputPlugin.h"
 #include "tsPacketInsertionController.h"
 #include "tsThread.h"
 #include "tsFatal.h"
@@ -33,7 +38,7 @@
 //----------------------------------------------------------------------------
 
 namespace ts {
-    class MergePlugin: public ProcessorPlugin, private Thread
+    class MergePlugin: public ProcessorPlugin, private Thread, private PluginEventHandlerInterface
     {
         TS_PLUGIN_CONSTRUCTORS(MergePlugin);
     public:
@@ -50,6 +55,7 @@ namespace ts {
         size_t           _max_queue = DEFAULT_MAX_QUEUED_PACKETS;           // Maximum number of queued packets.
         size_t           _accel_threshold = DEFAULT_MAX_QUEUED_PACKETS / 2; // Queue threshold after which insertion is accelerated.
         bool             _no_wait = false;              // Do not wait for command completion.
+        bool             _in_process = false;           // Run the merged stream as an in-process plugin chain.
         bool             _merge_psi = false;            // Merge PSI/SI information.
         bool             _pcr_restamp = false;          // Restamp PCR from the merged stream.
         bool             _incremental_pcr = false;      // Use incremental method to restamp PCR's.
@@ -63,6 +69,7 @@ namespace ts {
         PIDSet           _allowed_pids {};              // List of PID's to merge (other PID's from the merged stream are dropped).
         TSPacketLabelSet _set_labels {};                // Labels to set on output packets.
         TSPacketLabelSet _reset_labels {};              // Labels to reset on output packets.
+        TSProcessorArgs  _chain_args {};                // Plugin chain, with --in-process.
 
         // The ForkPipe is dynamically allocated to avoid reusing the same object when the command is restarted.
         using TSForkPipePtr = std::shared_ptr<TSForkPipe>;
@@ -80,6 +87,8 @@ namespace ts {
         PCRMerger     _pcr_merger {duck};  // Adjust PCR's in merged stream.
         PSIMerger     _psi_merger {duck, PSIMerger::NONE};  // Used to merge PSI/SI from both streams.
         PacketInsertionController _insert_control {*this};  // Used to control insertion points for the merge
+        std::mutex    _chain_mutex {};     // Protect _chain.
+        TSProcessor*  _chain = nullptr;    // Running in-process plugin chain, with --in-process.
 
         // Start/restart/stop the merge command.
         bool startStopCommand(bool do_close, bool do_start);
@@ -88,6 +97,12 @@ namespace ts {
         // them to the main plugin thread. The following method is the thread main code.
         virtual void main() override;
 
+        // With --in-process, the thread runs the plugin chain instead of reading the pipe.
+        void chainMain();
+
+        // Receive packets from the output of the in-process plugin chain.
+        virtual void handlePluginEvent(const PluginEventContext& context) override;
+
         // Process one packet coming from the merged stream.
         Status processMergePacket(TSPacket&, TSPacketMetadata&);
     };
@@ -111,7 +126,8 @@ ts::MergePlugin::MergePlugin(TSP* tsp_) :
 
     option(u"", 0, STRING, 1, 1);
     help(u"",
-         u"Specifies the command line to execute in the created process.");
+         u"Specifies the command line to execute in the created process. "
+         u"With --in-process, specifies the chain of plugins which produces the merged stream.");
 
     option(u"acceleration-threshold", 0, UNSIGNED);
     help(u"acceleration-threshold",
@@ -151,6 +167,20 @@ ts::MergePlugin::MergePlugin(TSP* tsp_) :
          u"bitrate (CBR) streams. The incremental method gives better results on "
          u"variable bitrate (VBR) streams. See also option --no-pcr-restamp.");
 
+    option(u"in-process");
+    help(u"in-process",
+         u"Run the merged stream as a chain of plugins inside the tsp process, instead of a separate command. "
+         u"The parameter is then a list of tsp plugins, starting with one input plugin, optionally followed by "
+         u"packet processing plugins, without output plugin. "
+         u"Since the parameter starts with a dash, it must be preceded by \"--\". "
+         u"Example: merge --in-process -- \"-I file foo.ts -P pcrbitrate\".\n\n"
+         u"The packets and their metadata (including labels) are directly copied from the output of the plugin "
+         u"chain into the packet queue of the merge plugin, without process switching and pipe. "
+         u"This packet queue is the same as with an external command, a circular buffer which is protected by a mutex. "
+         u"There is no system call as long as the queue is neither full nor empty. "
+         u"This is more efficient when many merge plugins are used in the same tsp command. "
+         u"With --restart, the plugin chain is restarted when its input terminates.");
+
     option(u"joint-termination", 'j');
     help(u"joint-termination",
         u"Perform a \"joint termination\" when the merged stream is terminated. "
@@ -269,12 +299,32 @@ bool ts::MergePlugin::getOptions()
     getIntValues(_set_labels, u"set-label");
     getIntValues(_reset_labels, u"reset-label");
     _format = LoadTSPacketFormatInputOption(*this);
+    _in_process = present(u"in-process");
 
     if (_restart + _terminate + tsp->useJointTermination() > 1) {
         error(u"--restart, --terminate and --joint-termination are mutually exclusive");
         return false;
     }
 
+    // With --in-process, analyze the plugin chain: one input, packet processors, no output.
+    if (_in_process) {
+        ArgsWithPlugins chain(1, 1, 0, UNLIMITED_COUNT, 0, 0, UString(), UString(),
+                              Args::NO_EXIT_ON_ERROR | Args::NO_EXIT_ON_HELP | Args::NO_EXIT_ON_VERSION | Args::NO_ERROR_DISPLAY);
+        chain.delegateReport(this);
+        if (!chain.analyze(u"merge " + _command, false)) {
+            error(u"invalid in-process plugin chain: %s", _command);
+            return false;
+        }
+        _chain_args = TSProcessorArgs();
+        _chain_args.app_name = u"merge";
+        _chain_args.ignore_jt = true;
+        chain.getPlugin(_chain_args.input, PluginType::INPUT);
+        chain.getPlugins(_chain_args.plugins, PluginType::PROCESSOR);
+        _chain_args.output.set(u"memory");
+        // The global buffer of the chain does not need to be larger than the merge queue.
+        _chain_args.ts_buffer_size = std::max(TSProcessorArgs::MIN_BUFFER_SIZE, 2 * PKT_SIZE * _max_queue);
+    }
+
     // Compute list of allowed PID's from the merged stream. Start with all PID's allowed.
     _allowed_pids.set();
 
@@ -392,6 +442,12 @@ bool ts::MergePlugin::start()
     _got_eof = false;
     _stopping = false;
 
+    // With --in-process, the internal thread runs the plugin chain.
+    if (_in_process) {
+        _chain_args.applyDefaults(tsp->realtime());
+        return Thread::start();
+    }
+
     // Create pipe & process, then start the internal thread which receives the TS to merge.
     return startStopCommand(false, true) && Thread::start();
 }
@@ -410,9 +466,17 @@ bool ts::MergePlugin::stop()
     // Send the stop condition to the internal packet queue.
     _queue.stop();
 
-    // Close the pipe and terminate the created process.
+    // Close the pipe and terminate the created process or abort the plugin chain.
     _stopping = true;
-    startStopCommand(true, false);
+    if (_in_process) {
+        std::lock_guard<std::mutex> lock(_chain_mutex);
+        if (_chain != nullptr) {
+            _chain->abort();
+        }
+    }
+    else {
+        startStopCommand(true, false);
+    }
 
     // Wait for actual thread termination.
     Thread::waitForTermination();
@@ -427,6 +491,11 @@ bool ts::MergePlugin::stop()
 
 void ts::MergePlugin::main()
 {
+    if (_in_process) {
+        chainMain();
+        return;
+    }
+
     debug(u"receiver thread started");
 
     // Specify the bitrate of the incoming stream.
@@ -483,6 +552,98 @@ void ts::MergePlugin::main()
 }
 
 
+//----------------------------------------------------------------------------
+// Implementation of the receiver thread with --in-process.
+// It runs the plugin chain, the output packets are received in handlePluginEvent().
+//----------------------------------------------------------------------------
+
+void ts::MergePlugin::chainMain()
+{
+    debug(u"plugin chain thread started");
+
+    // Specify the bitrate of the incoming stream.
+    // When zero, packet queue will compute it from the PCR.
+    _queue.setBitrate(_user_bitrate);
+
+    bool restart = false;
+    while (!_stopping && !_queue.stopped()) {
+
+        if (restart) {
+            // Optionally wait before restart.
+            std::this_thread::sleep_for(_restart_interval);
+            info(u"restarting merge plugin chain");
+        }
+
+        // Run the plugin chain until its input terminates.
+        TSProcessor chain(*this);
+        chain.registerEventHandler(this, PluginType::OUTPUT);
+        {
+            std::lock_guard<std::mutex> lock(_chain_mutex);
+            if (_stopping || !chain.start(_chain_args)) {
+                break;
+            }
+            _chain = &chain;
+        }
+        chain.waitForTermination();
+        {
+            std::lock_guard<std::mutex> lock(_chain_mutex);
+            _chain = nullptr;
+        }
+
+        if (!_restart) {
+            break;
+        }
+        restart = true;
+    }
+
+    // Signal end-of-file to plugin thread.
+    _queue.setEOF();
+    debug(u"plugin chain thread completed");
+}
+
+
+//----------------------------------------------------------------------------
+// Receive packets from the output of the in-process plugin chain.
+// Invoked in the context of the output thread of the chain.
+//----------------------------------------------------------------------------
+
+void ts::MergePlugin::handlePluginEvent(const PluginEventContext& context)
+{
+    MemoryOutputEventData* data = dynamic_cast<MemoryOutputEventData*>(context.pluginData());
+    if (data == nullptr) {
+        return;
+    }
+
+    const TSPacket* pkt = data->packets();
+    const TSPacketMetadata* pkt_data = data->metadata();
+    size_t count = data->packetCount();
+
+    // Directly copy the packets and their metadata (labels, timestamps) into the inter-thread packet queue.
+    while (count > 0) {
+        TSPacket* buffer = nullptr;
+        TSPacketMetadata* mdata = nullptr;
+        size_t max_pkt_count = 0;
+        if (!_queue.lockWriteBuffer(buffer, mdata, max_pkt_count, std::min(count, size_t(16)))) {
+            // The plugin thread has signalled a stop condition, abort the plugin chain.
+            data->setError(true);
+            return;
+        }
+        const size_t n = std::min(count, max_pkt_count);
+        TSPacket::Copy(buffer, pkt, n);
+        if (pkt_data != nullptr) {
+            TSPacketMetadata::Copy(mdata, pkt_data, n);
+            pkt_data += n;
+        }
+        else {
+            TSPacketMetadata::Reset(mdata, n);
+        }
+        _queue.releaseWriteBuffer(n);
+        pkt += n;
+        count -= n;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Packet processing method
 //----------------------------------------------------------------------------
@@ -58,6 +58,8 @@ namespace ts {
         IPSocketAddress    _actual_dest {};       // Actual destination UDP socket address.
         IPSocketAddress    _actual_source {};     // Actual source TCP socket address for HTTP mode.
         IPSocketAddressSet _all_sources {};       // All source addresses.
+        IPPacket           _ip {};                // Last IP packet, references the pcap file when memory-mapped.
+        VLANIdStack        _vlans {};             // VLAN stack of last IP packet.
         emmgmux::Protocol  _emmgmux {};           // EMMG/PDG <=> MUX protocol instance to decode TCP stream.
         ByteBlock          _data {};              // Session data buffer, for HTTP mode.
         size_t             _data_next = 0;        // Next index in _data.
@@ -220,8 +222,11 @@ bool ts::PcapInputPlugin::start()
             _pcap_tcp.setReportAddressesFilterSeverity(Severity::Verbose);
         }
         else {
+            // Let the pcap filter select the UDP flows, its decisions are cached per flow.
             ok = _pcap_udp.open(_file_name, *this);
             _pcap_udp.setProtocolFilterUDP();
+            _pcap_udp.setSourceFilter(_source);
+            _pcap_udp.setDestinationFilter(_destination);
         }
     }
     return ok;
@@ -238,6 +243,7 @@ bool ts::PcapInputPlugin::stop()
     if (max > 0) {
         debug(u"max TCP reassembly queue size: %d data blocks", max);
     }
+    _ip.clear();
     _pcap_udp.close();
     _pcap_tcp.close();
     return AbstractDatagramInputPlugin::stop();
@@ -262,25 +268,18 @@ bool ts::PcapInputPlugin::receiveDatagram(uint8_t* buffer, size_t buffer_size, s
 
 bool ts::PcapInputPlugin::receiveUDP(uint8_t *buffer, size_t buffer_size, size_t &ret_size, cn::microseconds &timestamp)
 {
-    IPPacket ip;
-    VLANIdStack vlans;
-
     // Loop on IPv4 datagrams from the pcap file until a matching UDP packet is found (or end of file).
+    // The source and destination socket addresses are filtered by the pcap filter.
     for (;;) {
 
         // Read one IPv4 datagram.
-        if (!_pcap_udp.readIP(ip, vlans, timestamp, *this)) {
+        if (!_pcap_udp.readIP(_ip, _vlans, timestamp, *this)) {
             return 0; // end of file, invalid pcap file format or other i/o error
         }
 
         // Get IP addresses and UDP ports.
-        const IPSocketAddress src(ip.source());
-        const IPSocketAddress dst(ip.destination());
-
-        // Filter source or destination socket address if one was specified.
-        if (!src.match(_source) || !dst.match(_actual_dest)) {
-            continue; // not a matching address
-        }
+        const IPSocketAddress& src(_ip.source());
+        const IPSocketAddress& dst(_ip.destination());
 
         // If the destination is not yet found, filter multicast addresses if required.
         if (!_actual_dest.hasAddress() && _multicast && !dst.isMulticast()) {
@@ -288,8 +287,8 @@ bool ts::PcapInputPlugin::receiveUDP(uint8_t *buffer, size_t buffer_size, size_t
         }
 
         // Locate UDP payload.
-        const uint8_t* const udp_data = ip.protocolData();
-        const size_t udp_size = ip.protocolDataSize();
+        const uint8_t* const udp_data = _ip.protocolData();
+        const size_t udp_size = _ip.protocolDataSize();
 
         // DVB SimulCrypt vs. raw TS.
         // The destination can be dynamically selected (address, port or both) by the first UDP datagram containing TS packets.
@@ -304,6 +303,7 @@ bool ts::PcapInputPlugin::receiveUDP(uint8_t *buffer, size_t buffer_size, size_t
                 }
                 // We just found the first UDP datagram with a data_provision message, now use this destination address all the time.
                 _actual_dest = dst;
+                _pcap_udp.setDestinationFilter(_actual_dest);
                 verbose(u"using UDP destination address %s", dst);
             }
 
@@ -323,17 +323,18 @@ bool ts::PcapInputPlugin::receiveUDP(uint8_t *buffer, size_t buffer_size, size_t
                 size_t start_index = 0;
                 size_t packet_count = 0;
                 size_t packet_size = 0;
-                if (!TSPacket::Locate(ip.protocolData(), ip.protocolDataSize(), start_index, packet_count, packet_size)) {
+                if (!TSPacket::Locate(udp_data, udp_size, start_index, packet_count, packet_size)) {
                     continue; // no TS packet in this UDP datagram.
                 }
                 // We just found the first UDP datagram with TS packets, now use this destination address all the time.
                 _actual_dest = dst;
+                _pcap_udp.setDestinationFilter(_actual_dest);
                 verbose(u"using UDP destination address %s", dst);
             }
 
             // Now we have a valid UDP packet.
-            ret_size = std::min(ip.protocolDataSize(), buffer_size);
-            MemCopy(buffer, ip.protocolData(), ret_size);
+            ret_size = std::min(udp_size, buffer_size);
+            MemCopy(buffer, udp_data, ret_size);
         }
 
         // List all source addresses as they appear.
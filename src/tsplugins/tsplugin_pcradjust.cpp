@@ -47,6 +47,7 @@
 
 #include "tsPluginRepository.h"
 #include "tsSectionDemux.h"
+#include "tsPIDMap.h"
 #include "tsBinaryTable.h"
 #include "tsPAT.h"
 #include "tsPMT.h"
@@ -70,7 +71,7 @@ namespace ts {
         // Description of PID's. Map of safe pointers to PID contexts, indexed by PID.
         class PIDContext;
         using PIDContextPtr = std::shared_ptr<PIDContext>;
-        using PIDContextMap = std::map<PID, PIDContextPtr>;
+        using PIDContextMap = PIDMap<PIDContextPtr>;
 
         // PCRAdjustPlugin private members
         BitRate       _user_bitrate = 0;          // User-specified bitrate.
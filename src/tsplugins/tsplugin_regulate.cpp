@@ -30,6 +30,7 @@ namespace ts {
         // Implementation of plugin API
         virtual bool getOptions() override;
         virtual bool start() override;
+        virtual bool stop() override;
         virtual bool isRealTime() override {return true;}
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
@@ -39,6 +40,7 @@ namespace ts {
         BitRate          _bitrate = 0;
         PacketCounter    _burst = 0;
         cn::milliseconds _wait_min {};
+        cn::microseconds _spin {};
         PID              _pid_pcr = PID_NULL;
 
         // Working data:
@@ -79,6 +81,13 @@ ts::RegulatePlugin::RegulatePlugin(TSP* tsp_) :
          u"With --pcr-synchronous, specify the reference PID for PCR's. By default, "
          u"use the first PID containing PCR's.");
 
+    option<cn::microseconds>(u"spin-duration");
+    help(u"spin-duration",
+         u"Specify the duration in microseconds of an active wait (busy loop) before each regulation deadline. "
+         u"With a spin phase, the regulation is more precise and the packet bursts can be shorter. "
+         u"However, with high bitrates, one CPU core is almost permanently busy. "
+         u"By default, there is no active wait and the minimum duration of a packet burst is 2 milliseconds.");
+
     option<cn::milliseconds>(u"wait-min", 'w');
     help(u"wait-min",
          u"With --pcr-synchronous, specify the minimum wait time in milli-seconds. "
@@ -95,6 +104,7 @@ bool ts::RegulatePlugin::getOptions()
     getValue(_bitrate, u"bitrate", 0);
     getIntValue(_burst, u"packet-burst", DEF_PACKET_BURST);
     getChronoValue(_wait_min, u"wait-min", PCRRegulator::DEFAULT_MIN_WAIT);
+    getChronoValue(_spin, u"spin-duration");
     getIntValue(_pid_pcr, u"pid-pcr", PID_NULL);
     _pcr_synchronous = present(u"pcr-synchronous");
 
@@ -122,18 +132,33 @@ bool ts::RegulatePlugin::start()
         _pcr_regulator.reset();
         _pcr_regulator.setBurstPacketCount(_burst);
         _pcr_regulator.setReferencePID(_pid_pcr);
+        _pcr_regulator.setSpinDuration(_spin);
         _pcr_regulator.setMinimimWait(_wait_min);
     }
     else {
         debug(u"starting bitrate-based regulation");
         _bitrate_regulator.setBurstPacketCount(_burst);
         _bitrate_regulator.setFixedBitRate(_bitrate);
+        _bitrate_regulator.setSpinDuration(_spin);
         _bitrate_regulator.start();
     }
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Stop method
+//----------------------------------------------------------------------------
+
+bool ts::RegulatePlugin::stop()
+{
+    // Report the precision of the regulation.
+    const PacingTimer& timer(_pcr_synchronous ? _pcr_regulator.pacingTimer() : _bitrate_regulator.pacingTimer());
+    verbose(u"regulation: %s", timer.statistics());
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Packet processing method
 //----------------------------------------------------------------------------
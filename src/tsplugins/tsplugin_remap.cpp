@@ -14,6 +14,7 @@
 #include "tsAbstractDuplicateRemapPlugin.h"
 #include "tsPluginRepository.h"
 #include "tsSectionDemux.h"
+#include "tsPIDMap.h"
 #include "tsCyclingPacketizer.h"
 #include "tsPAT.h"
 #include "tsCAT.h"
@@ -37,7 +38,7 @@ namespace ts {
 
     private:
         using CyclingPacketizerPtr = std::shared_ptr<CyclingPacketizer>;
-        using PacketizerMap = std::map<PID, CyclingPacketizerPtr>;
+        using PacketizerMap = PIDMap<CyclingPacketizerPtr>;
 
         bool          _update_psi = false;  // Update all PSI
         bool          _pmt_ready = false;   // All PMT PID's are known
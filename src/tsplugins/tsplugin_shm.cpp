@@ -0,0 +1,235 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  Transport stream processor shared library:
+//  Transfer TS packets between tsp processes using shared memory.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPluginRepository.h"
+#include "tsSharedPacketRing.h"
+
+
+//----------------------------------------------------------------------------
+// Input plugin definition
+//----------------------------------------------------------------------------
+
+namespace ts {
+    class SharedMemoryInputPlugin: public InputPlugin, private AbortInterface
+    {
+        TS_PLUGIN_CONSTRUCTORS(SharedMemoryInputPlugin);
+    public:
+        // Implementation of plugin API
+        virtual bool getOptions() override;
+        virtual bool start() override;
+        virtual bool stop() override;
+        virtual size_t receive(TSPacket*, TSPacketMetadata*, size_t) override;
+        virtual bool abortInput() override;
+        virtual bool setReceiveTimeout(cn::milliseconds timeout) override;
+
+    private:
+        // Command line options:
+        UString          _name {};
+        cn::milliseconds _timeout {};
+
+        // Working data:
+        SharedPacketRing  _ring {};
+        PacketCounter     _lost_packets = 0;
+        volatile bool     _aborted = false;
+
+        // Implementation of AbortInterface.
+        virtual bool aborting() const override;
+    };
+}
+
+TS_REGISTER_INPUT_PLUGIN(u"shm", ts::SharedMemoryInputPlugin);
+
+
+//----------------------------------------------------------------------------
+// Output plugin definition
+//----------------------------------------------------------------------------
+
+namespace ts {
+    class SharedMemoryOutputPlugin: public OutputPlugin
+    {
+        TS_PLUGIN_CONSTRUCTORS(SharedMemoryOutputPlugin);
+    public:
+        // Implementation of plugin API
+        virtual bool getOptions() override;
+        virtual bool start() override;
+        virtual bool stop() override;
+        virtual bool send(const TSPacket*, const TSPacketMetadata*, size_t) override;
+
+    private:
+        // Command line options:
+        UString                  _name {};
+        size_t                   _capacity = 0;
+        size_t                   _max_readers = 0;
+        SharedPacketRing::Policy _policy = SharedPacketRing::Policy::WAIT;
+        cn::milliseconds         _reader_timeout {};
+
+        // Working data:
+        SharedPacketRing _ring {};
+    };
+}
+
+TS_REGISTER_OUTPUT_PLUGIN(u"shm", ts::SharedMemoryOutputPlugin);
+
+
+//----------------------------------------------------------------------------
+// Input constructor
+//----------------------------------------------------------------------------
+
+ts::SharedMemoryInputPlugin::SharedMemoryInputPlugin(TSP* tsp_) :
+    InputPlugin(tsp_, u"Receive TS packets from another tsp process using shared memory", u"[options] name")
+{
+    option(u"", 0, STRING, 1, 1);
+    help(u"",
+         u"Name of the shared memory area. "
+         u"It must be the same name as in the shm output plugin of the sending tsp process.");
+
+    option<cn::milliseconds>(u"timeout", 't');
+    help(u"timeout",
+         u"Specify the input timeout in milliseconds. "
+         u"When no packet is received during that time, the input is considered terminated. "
+         u"By default, wait forever for packets from the sending process.");
+}
+
+
+//----------------------------------------------------------------------------
+// Input methods
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryInputPlugin::getOptions()
+{
+    getValue(_name, u"");
+    getChronoValue(_timeout, u"timeout");
+    return true;
+}
+
+bool ts::SharedMemoryInputPlugin::setReceiveTimeout(cn::milliseconds timeout)
+{
+    if (timeout > cn::milliseconds::zero()) {
+        _timeout = timeout;
+    }
+    return true;
+}
+
+bool ts::SharedMemoryInputPlugin::start()
+{
+    _aborted = false;
+    _lost_packets = 0;
+    return _ring.open(_name, *this);
+}
+
+bool ts::SharedMemoryInputPlugin::stop()
+{
+    if (_ring.lostPackets() > 0) {
+        verbose(u"%'d packets lost on shared memory %s", _ring.lostPackets(), _name);
+    }
+    return _ring.close(*this);
+}
+
+bool ts::SharedMemoryInputPlugin::abortInput()
+{
+    _aborted = true;
+    return true;
+}
+
+bool ts::SharedMemoryInputPlugin::aborting() const
+{
+    return _aborted || tsp->aborting();
+}
+
+size_t ts::SharedMemoryInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
+{
+    const size_t count = _ring.read(buffer, pkt_data, max_packets, this, _timeout);
+
+    // Report lost packets, when a previous reader was too slow.
+    if (_ring.lostPackets() > _lost_packets) {
+        warning(u"lost %'d packets, input too slow", _ring.lostPackets() - _lost_packets);
+        _lost_packets = _ring.lostPackets();
+    }
+    // Nothing to report on abort or normal end of stream.
+    if (count == 0 && !aborting()) {
+        if (_ring.writerTerminated()) {
+            error(u"sending process terminated without closing shared memory %s", _name);
+        }
+        else if (!_ring.endOfStream()) {
+            error(u"receive timeout on shared memory %s", _name);
+        }
+    }
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Output constructor
+//----------------------------------------------------------------------------
+
+ts::SharedMemoryOutputPlugin::SharedMemoryOutputPlugin(TSP* tsp_) :
+    OutputPlugin(tsp_, u"Send TS packets to other tsp processes using shared memory", u"[options] name")
+{
+    option(u"", 0, STRING, 1, 1);
+    help(u"",
+         u"Name of the shared memory area. "
+         u"Other tsp processes receive the packets using the shm input plugin with the same name.");
+
+    option(u"capacity", 'c', POSITIVE);
+    help(u"capacity", u"packets",
+         u"Size of the shared memory ring buffer, in TS packets. "
+         u"The default is " + UString::Decimal(SharedPacketRing::DEFAULT_CAPACITY) + u" packets.");
+
+    option(u"drop", 'd');
+    help(u"drop",
+         u"Never wait for slow receivers. "
+         u"When a receiving process is too slow, it loses the oldest packets and restarts with the most recent ones. "
+         u"By default, the output waits for the slowest receiver.");
+
+    option(u"max-receivers", 'm', INTEGER, 0, 1, 1, 0xFFFF);
+    help(u"max-receivers",
+         u"Maximum number of simultaneous receiving processes. "
+         u"The default is " + UString::Decimal(SharedPacketRing::DEFAULT_MAX_READERS) + u".");
+
+    option<cn::milliseconds>(u"receiver-timeout", 'r');
+    help(u"receiver-timeout",
+         u"Without --drop, a receiving process which does not read packets during that time is considered as dead "
+         u"and is no longer waited for. "
+         u"The default is " + UString::Chrono(SharedPacketRing::DEFAULT_READER_TIMEOUT, true) + u".");
+}
+
+
+//----------------------------------------------------------------------------
+// Output methods
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryOutputPlugin::getOptions()
+{
+    getValue(_name, u"");
+    getIntValue(_capacity, u"capacity", SharedPacketRing::DEFAULT_CAPACITY);
+    getIntValue(_max_readers, u"max-receivers", SharedPacketRing::DEFAULT_MAX_READERS);
+    getChronoValue(_reader_timeout, u"receiver-timeout", SharedPacketRing::DEFAULT_READER_TIMEOUT);
+    _policy = present(u"drop") ? SharedPacketRing::Policy::DROP : SharedPacketRing::Policy::WAIT;
+    return true;
+}
+
+bool ts::SharedMemoryOutputPlugin::start()
+{
+    _ring.setReaderTimeout(_reader_timeout);
+    return _ring.create(_name, _capacity, _max_readers, _policy, *this);
+}
+
+bool ts::SharedMemoryOutputPlugin::stop()
+{
+    return _ring.close(*this);
+}
+
+bool ts::SharedMemoryOutputPlugin::send(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count)
+{
+    return _ring.write(buffer, pkt_data, packet_count, tsp) == packet_count;
+}
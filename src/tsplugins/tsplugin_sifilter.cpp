@@ -13,8 +13,7 @@
 
 #include "tsPluginRepository.h"
 #include "tsCASSelectionArgs.h"
-#include "tsBinaryTable.h"
-#include "tsSectionDemux.h"
+#include "tsPacketClassifier.h"
 #include "tsPAT.h"
 
 
@@ -23,7 +22,7 @@
 //----------------------------------------------------------------------------
 
 namespace ts {
-    class SIFilterPlugin: public ProcessorPlugin, private TableHandlerInterface
+    class SIFilterPlugin: public ProcessorPlugin, private SignalizationHandlerInterface
     {
         TS_PLUGIN_CONSTRUCTORS(SIFilterPlugin);
     public:
@@ -35,14 +34,12 @@ namespace ts {
         CASSelectionArgs _cas_args {};            // CAS selection
         bool             _pass_pmt = false;       // Pass PIDs containing PMT
         Status           _drop_status = TSP_DROP; // Status for dropped packets
-        PIDSet           _pass_pids {};           // List of PIDs to pass
-        SectionDemux     _demux {duck, this};     // Section filter
+        PacketClassifier _classifier {duck};      // PIDs to pass (verdict PASS) and signalization demux
 
-        // Invoked by the demux when a complete table is available.
-        virtual void handleTable(SectionDemux&, const BinaryTable&) override;
-
-        // Process specific tables
-        void processPAT(const PAT&);
+        // Implementation of SignalizationHandlerInterface, notified by the demux of the classifier.
+        virtual void handlePAT(const PAT&, PID) override;
+        virtual void handleCAT(const CAT&, PID) override;
+        virtual void handlePMT(const PMT&, PID) override;
     };
 }
 
@@ -110,105 +107,76 @@ bool ts::SIFilterPlugin::start()
     _pass_pmt = present(u"pmt");
     _drop_status = present(u"stuffing") ? TSP_NULL : TSP_DROP;
 
-    _pass_pids.reset();
+    // All PIDs are dropped by default. The classifier is used for its signalization demux.
+    _classifier.clear();
+    _classifier.setSignalizationHandler(this);
+
+    PIDSet pids;
     if (present(u"bat")) {
-        _pass_pids.set(PID_BAT);
+        pids.set(PID_BAT);
     }
     if (present(u"cat")) {
-        _pass_pids.set(PID_CAT);
+        pids.set(PID_CAT);
     }
     if (present(u"eit")) {
-        _pass_pids.set(PID_EIT);
+        pids.set(PID_EIT);
     }
     if (present(u"nit")) {
-        _pass_pids.set(PID_NIT);
+        pids.set(PID_NIT);
     }
     if (present(u"pat")) {
-        _pass_pids.set(PID_PAT);
+        pids.set(PID_PAT);
     }
     if (present(u"rst")) {
-        _pass_pids.set(PID_RST);
+        pids.set(PID_RST);
     }
     if (present(u"sdt")) {
-        _pass_pids.set(PID_SDT);
+        pids.set(PID_SDT);
     }
     if (present(u"tdt")) {
-        _pass_pids.set(PID_TDT);
+        pids.set(PID_TDT);
     }
     if (present(u"tot")) {
-        _pass_pids.set(PID_TOT);
+        pids.set(PID_TOT);
     }
     if (present(u"tsdt")) {
-        _pass_pids.set(PID_TSDT);
-    }
-
-    // Reinitialize the demux
-    _demux.reset();
-    _demux.addPID(PID_PAT);
-    if (_cas_args.pass_emm) {
-        _demux.addPID(PID_CAT);
+        pids.set(PID_TSDT);
     }
 
+    _classifier.setVerdict(pids, PacketClassifier::PASS);
     return true;
 }
 
 
 //----------------------------------------------------------------------------
-// Invoked by the demux when a complete table is available.
+// Invoked by the signalization demux when a new table is available.
 //----------------------------------------------------------------------------
 
-void ts::SIFilterPlugin::handleTable(SectionDemux& demux, const BinaryTable& table)
+void ts::SIFilterPlugin::handlePAT(const PAT& pat, PID)
 {
-    switch (table.tableId()) {
-
-        case TID_PAT: {
-            PAT pat(duck, table);
-            if (pat.isValid()) {
-                processPAT(pat);
-            }
-            break;
-        }
-
-        case TID_CAT: {
-            CAT cat(duck, table);
-            if (cat.isValid()) {
-                _cas_args.addMatchingPIDs(_pass_pids, cat, *this);
-            }
-            break;
-        }
-
-        case TID_PMT: {
-            PMT pmt(duck, table);
-            if (pmt.isValid()) {
-                _cas_args.addMatchingPIDs(_pass_pids, pmt, *this);
+    // Pass the PMT PIDs if PMT are required. The PMT's are demuxed by the classifier.
+    if (_pass_pmt) {
+        for (const auto& it : pat.pmts) {
+            if (_classifier.verdict(it.second) != PacketClassifier::PASS) {
+                verbose(u"Filtering PMT PID %n", it.second);
+                _classifier.setVerdict(it.second, PacketClassifier::PASS);
             }
-            break;
-        }
-
-        default: {
-            break;
         }
     }
 }
 
+void ts::SIFilterPlugin::handleCAT(const CAT& cat, PID)
+{
+    PIDSet pids;
+    _cas_args.addMatchingPIDs(pids, cat, *this);
+    _classifier.setVerdict(pids, PacketClassifier::PASS);
+}
 
-//----------------------------------------------------------------------------
-//  This method processes a Program Association Table (PAT).
-//----------------------------------------------------------------------------
-
-void ts::SIFilterPlugin::processPAT(const PAT& pat)
+void ts::SIFilterPlugin::handlePMT(const PMT& pmt, PID)
 {
-    for (const auto& it : pat.pmts) {
-        // Add PMT PID to section filter if ECM are required
-        if (_cas_args.pass_ecm) {
-            _demux.addPID(it.second);
-        }
-        // Pass this PMT PID if PMT are required
-        if (_pass_pmt && !_pass_pids[it.second]) {
-            verbose(u"Filtering PMT PID %n", it.second);
-            _pass_pids.set(it.second);
-        }
-    }
+    PIDSet pids;
+    _cas_args.addMatchingPIDs(pids, pmt, *this);
+    _classifier.setVerdict(pids, PacketClassifier::PASS);
 }
 
 
@@ -218,6 +186,6 @@ void ts::SIFilterPlugin::processPAT(const PAT& pat)
 
 ts::ProcessorPlugin::Status ts::SIFilterPlugin::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
 {
-    _demux.feedPacket(pkt);
-    return _pass_pids[pkt.getPID()] ? TSP_OK : _drop_status;
+    _classifier.feedPacket(pkt);
+    return _classifier.classify(pkt, pkt_data, tsp->pluginPackets()) == PacketClassifier::PASS ? TSP_OK : _drop_status;
 }
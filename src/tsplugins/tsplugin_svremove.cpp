@@ -13,6 +13,7 @@
 
 #include "tsPluginRepository.h"
 #include "tsService.h"
+#include "tsPacketClassifier.h"
 #include "tsSectionDemux.h"
 #include "tsCyclingPacketizer.h"
 #include "tsAlgorithm.h"
@@ -39,6 +40,14 @@ namespace ts {
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
+        // Verdicts of the packet classifier for PID's which need a specific processing.
+        enum : PacketClassifier::Verdict {
+            VERDICT_PAT = PacketClassifier::FIRST_USER_VERDICT,  // Replace packets from the PAT packetizer.
+            VERDICT_SDT_BAT,                                     // Replace packets from the SDT/BAT packetizer.
+            VERDICT_NIT,                                         // Replace packets from the NIT packetizer.
+            VERDICT_EIT,                                         // Process packets in the EIT processor.
+        };
+
         bool              _abort = false;          // Error (service not found, etc)
         bool              _ready = false;          // Ready to pass packets
         bool              _transparent = false;    // Transparent mode, pass all packets
@@ -50,6 +59,7 @@ namespace ts {
         Status            _drop_status = TSP_DROP; // Status for dropped packets
         PIDSet            _drop_pids {};           // List of PIDs to drop
         PIDSet            _ref_pids {};            // List of other referenced PIDs
+        PacketClassifier  _classifier {duck};      // Compiled verdicts per PID
         SectionDemux      _demux {duck, this};     // Section demux
         CyclingPacketizer _pzer_pat {duck, PID_PAT, CyclingPacketizer::StuffingPolicy::ALWAYS};
         CyclingPacketizer _pzer_sdt_bat {duck, PID_SDT, CyclingPacketizer::StuffingPolicy::ALWAYS};
@@ -66,6 +76,9 @@ namespace ts {
         void processNITBAT(AbstractTransportListTable&);
         void processNITBATDescriptorList(DescriptorList&);
 
+        // Recompile the verdicts of all PID's.
+        void updateVerdicts();
+
         // Mark all ECM PIDs from the specified descriptor list in the specified PID set
         void addECMPID(const DescriptorList&, PIDSet&);
     };
@@ -173,6 +186,7 @@ bool ts::SVRemovePlugin::start()
     _pzer_pat.reset();
     _pzer_sdt_bat.reset();
     _pzer_nit.reset();
+    updateVerdicts();
 
     return true;
 }
@@ -289,6 +303,39 @@ void ts::SVRemovePlugin::handleTable(SectionDemux& demux, const BinaryTable& tab
             break;
         }
     }
+
+    // The lists of PID's and the packetizers may have changed.
+    updateVerdicts();
+}
+
+
+//----------------------------------------------------------------------------
+// Recompile the verdicts of all PID's.
+//----------------------------------------------------------------------------
+
+void ts::SVRemovePlugin::updateVerdicts()
+{
+    _classifier.clear();
+    _classifier.setDefaultVerdict(PacketClassifier::PASS);
+
+    // Packets from removed PIDs are either dropped or nullified
+    const PIDSet drop(_drop_pids & ~_ref_pids);
+    _classifier.setVerdict(drop, PacketClassifier::DROP);
+
+    // Packets to replace or process, in reverse order of precedence.
+    const auto set = [this, &drop](PID pid, PacketClassifier::Verdict verdict) {
+        if (!drop.test(pid)) {
+            _classifier.setVerdict(pid, verdict);
+        }
+    };
+    if (!_ignore_eit) {
+        set(PID_EIT, VERDICT_EIT);
+    }
+    if (!_ignore_nit) {
+        set(_pzer_nit.getPID(), VERDICT_NIT);
+    }
+    set(_pzer_sdt_bat.getPID(), VERDICT_SDT_BAT);
+    set(_pzer_pat.getPID(), VERDICT_PAT);
 }
 
 
@@ -535,8 +582,6 @@ void ts::SVRemovePlugin::processNITBATDescriptorList(DescriptorList& dlist)
 
 ts::ProcessorPlugin::Status ts::SVRemovePlugin::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
 {
-    const PID pid = pkt.getPID();
-
     // Pass packets in transparent mode
     if (_transparent) {
         return TSP_OK;
@@ -555,23 +600,24 @@ ts::ProcessorPlugin::Status ts::SVRemovePlugin::processPacket(TSPacket& pkt, TSP
         return _drop_status;
     }
 
-    // Packets from removed PIDs are either dropped or nullified
-    if (_drop_pids[pid] && !_ref_pids[pid]) {
-        return _drop_status;
-    }
-
-    // Replace packets using packetizers
-    if (pid == _pzer_pat.getPID()) {
-        _pzer_pat.getNextPacket (pkt);
-    }
-    else if (pid == _pzer_sdt_bat.getPID()) {
-        _pzer_sdt_bat.getNextPacket(pkt);
-    }
-    else if (!_ignore_nit && pid == _pzer_nit.getPID()) {
-        _pzer_nit.getNextPacket(pkt);
-    }
-    else if (!_ignore_eit && pid == PID_EIT) {
-        _eit_process.processPacket(pkt);
+    // Packets from removed PIDs are either dropped or nullified, replace packets using packetizers.
+    switch (_classifier.verdict(pkt.getPID())) {
+        case PacketClassifier::DROP:
+            return _drop_status;
+        case VERDICT_PAT:
+            _pzer_pat.getNextPacket(pkt);
+            break;
+        case VERDICT_SDT_BAT:
+            _pzer_sdt_bat.getNextPacket(pkt);
+            break;
+        case VERDICT_NIT:
+            _pzer_nit.getNextPacket(pkt);
+            break;
+        case VERDICT_EIT:
+            _eit_process.processPacket(pkt);
+            break;
+        default:
+            break;
     }
 
     return TSP_OK;
@@ -33,11 +33,16 @@ namespace ts {
     private:
         bool             _drop_initial = false;  // Drop initial packets instead of null.
         cn::milliseconds _time_shift_ms {};      // Time-shift in milliseconds.
+        fs::path         _persistent_file {};    // Persistent buffer file.
+        bool             _check_resumed = false; // Check the size of a resumed persistent buffer against --time.
         TimeShiftBuffer  _buffer {};             // The timeshift buffer logic.
 
         // Try to initialize the buffer using the time as size.
         // Return false on fatal error only.
         bool initBufferByTime();
+
+        // Check the size of a resumed persistent buffer against --time, when the bitrate is known.
+        void checkResumedSize();
     };
 }
 
@@ -64,6 +69,13 @@ ts::TimeShiftPlugin::TimeShiftPlugin (TSP* tsp_) :
          u"Drop output packets during the initial phase, while the time-shift buffer is filling. "
          u"By default, initial packets are replaced by null packets.");
 
+    option(u"memory-map");
+    help(u"memory-map",
+         u"Map the complete temporary buffer file in memory instead of reading and writing packets in the file. "
+         u"The disk space of the file is allocated on start and the system pages the buffer in and out of the file as needed. "
+         u"This is more efficient with large buffers. The option --memory-packets is then ignored. "
+         u"This option is currently supported on UNIX systems only.");
+
     option(u"memory-packets", 'm', UNSIGNED);
     help(u"memory-packets",
          u"Specify the number of packets which are cached in memory. "
@@ -76,6 +88,16 @@ ts::TimeShiftPlugin::TimeShiftPlugin (TSP* tsp_) :
          u"Specify the size of the time-shift buffer in packets. "
          u"There is no default, the size of the buffer shall be specified either using --packets or --time.");
 
+    option(u"persistent-file", 0, FILENAME);
+    help(u"persistent-file",
+         u"Store the time-shift buffer in the specified file, which is mapped in memory and not deleted on termination. "
+         u"When the file already exists and contains a time-shift buffer of the same size, "
+         u"the buffer is resumed with its previous content and the time-shifted stream continues where it was stopped. "
+         u"With --time, the size of an existing buffer file is reused and a warning is reported "
+         u"when it does not match the specified time at the current bitrate. "
+         u"The file is locked while in use, two processes cannot use the same persistent file. "
+         u"This option is currently supported on UNIX systems only.");
+
     option<cn::milliseconds>(u"time", 't');
     help(u"time",
          u"Specify the size of the time-shift buffer in milliseconds. "
@@ -97,6 +119,9 @@ bool ts::TimeShiftPlugin::getOptions()
     const size_t packets = intValue<size_t>(u"packets", 0);
     _buffer.setBackupDirectory(value(u"directory"));
     _buffer.setMemoryPackets(intValue<size_t>(u"memory-packets", TimeShiftBuffer::DEFAULT_MEMORY_PACKETS));
+    _buffer.setMemoryMapped(present(u"memory-map"));
+    getPathValue(_persistent_file, u"persistent-file");
+    _buffer.setPersistentFile(_persistent_file);
 
     if ((packets > 0 && _time_shift_ms > cn::milliseconds::zero()) || (packets == 0 && _time_shift_ms == cn::milliseconds::zero())) {
         error(u"specify exactly one of --packets and --time for time-shift buffer sizing");
@@ -136,12 +161,48 @@ bool ts::TimeShiftPlugin::initBufferByTime()
 }
 
 
+//----------------------------------------------------------------------------
+// Check the size of a resumed persistent buffer against --time.
+//----------------------------------------------------------------------------
+
+void ts::TimeShiftPlugin::checkResumedSize()
+{
+    const BitRate bitrate = tsp->bitrate();
+    if (_check_resumed && bitrate > 0) {
+        _check_resumed = false;
+        // Tolerate small variations of the bitrate, typically with an estimated bitrate.
+        const PacketCounter expected = PacketDistance(bitrate, _time_shift_ms);
+        const PacketCounter actual = _buffer.size();
+        if (expected > 0 && std::max(expected, actual) - std::min(expected, actual) > expected / 20) {
+            warning(u"persistent buffer %s contains %'d packets (%'d ms at %'d b/s), --time %'d ms would require %'d packets, using the persistent buffer",
+                    _persistent_file, actual, PacketInterval<cn::milliseconds>(bitrate, actual).count(), bitrate, _time_shift_ms.count(), expected);
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Start method
 //----------------------------------------------------------------------------
 
 bool ts::TimeShiftPlugin::start()
 {
+    _check_resumed = false;
+
+    // With --time, an existing persistent buffer is resumed with its previous size, without waiting for the bitrate.
+    if (_time_shift_ms > cn::milliseconds::zero() && !_persistent_file.empty()) {
+        const size_t packets = TimeShiftBuffer::PersistentFileSize(_persistent_file);
+        if (packets > 0) {
+            _buffer.setTotalPackets(packets);
+            if (!_buffer.open(*this)) {
+                return false;
+            }
+            _check_resumed = true;
+            checkResumedSize();
+            return true;
+        }
+    }
+
     // Initialize the buffer only when its size is specified in packets or the bitrate is already known.
     return _time_shift_ms == cn::milliseconds::zero() ? _buffer.open(*this) : initBufferByTime();
 }
@@ -179,6 +240,11 @@ ts::ProcessorPlugin::Status ts::TimeShiftPlugin::processPacket(TSPacket& pkt, TS
         }
     }
 
+    // A resumed persistent buffer is checked when the bitrate becomes known.
+    if (_check_resumed) {
+        checkResumedSize();
+    }
+
     if (!_buffer.isOpen()) {
         // Still waiting to set a buffer size, discarding packets.
         return _drop_initial ? TSP_DROP : TSP_NULL;
@@ -12,15 +12,14 @@
 //----------------------------------------------------------------------------
 
 #include "tsPluginRepository.h"
-#include "tsSectionDemux.h"
+#include "tsPacketClassifier.h"
 #include "tsCyclingPacketizer.h"
 #include "tsEITProcessor.h"
 #include "tsPAT.h"
 #include "tsCAT.h"
 #include "tsPMT.h"
 #include "tsSDT.h"
-#include "tsCVCT.h"
-#include "tsTVCT.h"
+#include "tsVCT.h"
 #include "tsAlgorithm.h"
 
 
@@ -29,7 +28,7 @@
 //----------------------------------------------------------------------------
 
 namespace ts {
-    class ZapPlugin: public ProcessorPlugin, private TableHandlerInterface
+    class ZapPlugin: public ProcessorPlugin, private SignalizationHandlerInterface
     {
         TS_PLUGIN_CONSTRUCTORS(ZapPlugin);
     public:
@@ -61,16 +60,15 @@ namespace ts {
         using ServiceContextPtr = std::shared_ptr<ServiceContext>;
         using ServiceContextVector = std::vector<ServiceContextPtr>;
 
-        // Each PID is described by one byte
-        enum : uint8_t {
-            TSPID_DROP,   // Remove all packets from this PID
-            TSPID_PASS,   // Always pass, unmodified (CAT, TOT/TDT, ATSC PSIP)
-            TSPID_PAT,    // PAT, modified
-            TSPID_SDT,    // SDT/BAT, modified (SDT Other & BAT removed)
-            TSPID_PMT,    // PMT of the service, unmodified
-            TSPID_PES,    // A PES component of the service, unmodified
-            TSPID_DATA,   // A non-PES component of the service, unmodified
-            TSPID_EMM,    // EMM's, unmodified
+        // Verdict of the packet classifier for each PID, in addition to DROP (remove all packets
+        // from this PID) and PASS (always pass, unmodified: CAT, TOT/TDT, ATSC PSIP).
+        enum : PacketClassifier::Verdict {
+            VERDICT_PAT = PacketClassifier::FIRST_USER_VERDICT,  // PAT, modified
+            VERDICT_SDT,   // SDT/BAT, modified (SDT Other & BAT removed)
+            VERDICT_PMT,   // PMT of the service, modified
+            VERDICT_PES,   // A PES component of the service, unmodified
+            VERDICT_DATA,  // A non-PES component of the service, unmodified
+            VERDICT_EMM,   // EMM's, unmodified
         };
 
         // Plugin command line options:
@@ -91,22 +89,20 @@ namespace ts {
         bool                 _abort = false;           // Error (service not found, etc)
         uint8_t              _pat_version = 0;         // Version of next PAT.
         uint8_t              _sdt_version = 0;         // Version of next SDT.
-        PAT                  _last_pat {};             // Last received PAT.
-        SectionDemux         _demux {duck, this};
+        PacketClassifier     _classifier {duck};       // Signalization demux and verdict of each PID.
         CyclingPacketizer    _pzer_sdt {duck, PID_SDT, CyclingPacketizer::StuffingPolicy::ALWAYS};
         CyclingPacketizer    _pzer_pat {duck, PID_PAT, CyclingPacketizer::StuffingPolicy::ALWAYS};
         EITProcessor         _eit_process {duck, PID_EIT};
-        uint8_t              _pid_state[PID_MAX] {};   // Status of each PID.
 
-        // Implementation of TableHandlerInterface.
-        virtual void handleTable(SectionDemux& demux, const BinaryTable& table) override;
+        // Implementation of SignalizationHandlerInterface, notified by the demux of the classifier.
+        virtual void handlePAT(const PAT&, PID) override;
+        virtual void handleCAT(const CAT&, PID) override;
+        virtual void handlePMT(const PMT&, PID) override;
+        virtual void handleSDT(const SDT&, PID) override;
+        virtual void handleVCT(const VCT&, PID) override;
 
-        // Handle specific tables.
-        void handlePAT(PAT&);
-        void handleCAT(CAT&);
-        void handlePMT(PMT&, PID);
-        void handleSDT(SDT&);
-        void handleVCT(VCT&);
+        // Filter the components of a selected service and build its modified PMT.
+        void processPMT(ServiceContext& ctx, PMT pmt);
 
         // Send a new PAT.
         void sendNewPAT();
@@ -124,8 +120,8 @@ namespace ts {
         void processECM(ServiceContext& ctx, DescriptorList& descs);
 
         // Analyze a list of descriptors, looking for CA descriptors, collect CA PID's.
-        // All PIDs which are referenced in CA descriptors are set with the specified state.
-        void analyzeCADescriptors(std::set<PID>& pids, const DescriptorList& descs, uint8_t pid_state);
+        // All PIDs which are referenced in CA descriptors are set with the specified verdict.
+        void analyzeCADescriptors(std::set<PID>& pids, const DescriptorList& descs, PacketClassifier::Verdict verdict);
 
         // Check if a service component PID (audio or subtitles) shall be kept.
         bool keepComponent(PID pid, const DescriptorList& descs, const UStringVector& languages, const std::set<PID>& pids);
@@ -273,68 +269,51 @@ ts::ZapPlugin::ServiceContext::ServiceContext(DuckContext& duck, const UString&
 
 bool ts::ZapPlugin::start()
 {
-    // Initialize the demux and EIT processor.
-    _demux.reset();
+    // Initialize the classifier and EIT processor. All PIDs are dropped by default.
+    // Selected PIDs will be added when discovered in the signalization.
+    _classifier.clear();
+    _classifier.setSignalizationHandler(this);
     _eit_process.reset();
     _eit_process.removeOther();
 
     // Initialize service descriptions.
-    bool all_ids_known = true;
     for (size_t i = 0; i < _services.size(); ++i) {
         ServiceContext& ctx(*_services[i]);
         ctx.id_known = ctx.spec_by_id;
         ctx.pzer_pmt.reset();
         ctx.pids.clear();
         ctx.pmt_pid = PID_NULL;
-        all_ids_known = all_ids_known && ctx.id_known;
         if (ctx.spec_by_id && _include_eit) {
             _eit_process.keepService(ctx.service_id);
         }
     }
 
-    // All PIDs are dropped by default.
-    // Selected PIDs will be added when discovered.
-    MemSet(_pid_state, TSPID_DROP, sizeof(_pid_state));
-
     // The TOT and TDT are always passed (same PID).
-    _pid_state[PID_TOT] = TSPID_PASS;
-
-    if (all_ids_known) {
-        // When all service ids are known, we can immediately process the PAT.
-        // If any service id is not yet known (only the service name is known), we do not know
-        // how to modify the PAT. We will handle it after receiving the DVB-SDT or ATSC-VCT.
-        _demux.addPID(PID_PAT);
-    }
-    else {
-        // Handle the ATSC-VCT only when a service is specified by name.
-        // We won't modify the VCT, so there is no need to get them if all service ids are known.
-        _demux.addPID(PID_PSIP);
-    }
+    _classifier.setVerdict(PID_TOT, PacketClassifier::PASS);
 
-    // Replace the PAT PID with modified PAT.
-    _pid_state[PID_PAT] = TSPID_PAT;
+    // Replace the PAT PID with modified PAT. As long as a service id is not yet known (only the
+    // service name is known), it is not included in the PAT. The PAT is reprocessed after
+    // receiving the DVB-SDT or ATSC-VCT.
+    _classifier.setVerdict(PID_PAT, VERDICT_PAT);
 
     // Always handle the SDT Actual and replace the SDT/BAT PID with modified SDT Actual.
-    _demux.addPID(PID_SDT);
-    _pid_state[PID_SDT] = TSPID_SDT;
+    _classifier.setVerdict(PID_SDT, VERDICT_SDT);
 
     // Unlike the DVB-SDT, the ATSC-VCT is not modified to include only the zapped channel
     // because the same PID contains too many distinct tables, some being cycled, some others
     // being one-shot and we do not want to address this complexity here.
     // So, the complete PSIP PID is passed unmodified.
-    _pid_state[PID_PSIP] = TSPID_PASS;
+    _classifier.setVerdict(PID_PSIP, PacketClassifier::PASS);
 
     // Include CAT and EMM if required
     if (_include_cas) {
-        _demux.addPID(PID_CAT);
-        _pid_state[PID_CAT] = TSPID_PASS;
+        _classifier.setVerdict(PID_CAT, PacketClassifier::PASS);
     }
 
     // Reset other states
     _abort = false;
     _pat_version = 0;
     _sdt_version = 0;
-    _last_pat.invalidate();
     _pzer_pat.reset();
     _pzer_sdt.reset();
 
@@ -352,7 +331,7 @@ void ts::ZapPlugin::sendNewPAT()
     _pat_version = (_pat_version + 1) & SVERSION_MASK;
 
     // Create the new PAT. Set no NIT PID (this is an SPTS in most cases).
-    PAT pat(_pat_version, true, _last_pat.ts_id, PID_NULL);
+    PAT pat(_pat_version, true, _classifier.demux().lastPAT().ts_id, PID_NULL);
 
     // Add known services in the PAT.
     // If all services are unknown, send an empty PAT (typically with --ignore-absent).
@@ -390,7 +369,7 @@ void ts::ZapPlugin::forgetServiceComponents(ServiceContext& ctx)
 
         // If the PID is not shared, we no longer need to pass it.
         if (!shared) {
-            _pid_state[pid] = TSPID_DROP;
+            _classifier.setVerdict(pid, PacketClassifier::DROP);
         }
     }
 
@@ -408,11 +387,8 @@ void ts::ZapPlugin::serviceNotPresent(ServiceContext& ctx, const UChar* table_na
     if (_ignore_absent) {
         // Service not present is not an error, waiting for it to reappear.
         verbose(u"service %s not found in %s, waiting for the service...", ctx.service_spec, table_name);
-        // Make sure the service PMT will be notified again if on the same PID.
-        if (ctx.pmt_pid != PID_NULL) {
-            _demux.resetPID(ctx.pmt_pid);
-            ctx.pmt_pid = PID_NULL;
-        }
+        // The PMT of the service is reprocessed when the service reappears.
+        ctx.pmt_pid = PID_NULL;
         // Forget components that may change when the service reappears.
         forgetServiceComponents(ctx);
         // If the service is specified by name, forget its service id.
@@ -453,70 +429,16 @@ void ts::ZapPlugin::setServiceId(ServiceContext& ctx, uint16_t service_id)
             _eit_process.keepService(service_id);
         }
 
-        // At least one service id is known, we need the PAT, if not already done.
-        _demux.addPID(TID_PAT);
-
-        // Reprocess last PAT if present to collect new PMT.
-        if (_last_pat.isValid()) {
-            handlePAT(_last_pat);
+        // Reprocess last PAT if present to collect new PMT PID.
+        const SignalizationDemux& demux(_classifier.demux());
+        if (demux.hasPAT()) {
+            handlePAT(demux.lastPAT(), PID_PAT);
         }
-    }
-}
-
 
-//----------------------------------------------------------------------------
-// Implementation of TableHandlerInterface: receive all new tables.
-//----------------------------------------------------------------------------
-
-void ts::ZapPlugin::handleTable(SectionDemux& demux, const BinaryTable& table)
-{
-    const PID pid = table.sourcePID();
-    switch (table.tableId()) {
-        case TID_PAT: {
-            PAT pat(duck, table);
-            if (pat.isValid() && pid == PID_PAT) {
-                handlePAT(pat);
-            }
-            break;
-        }
-        case TID_CAT: {
-            CAT cat(duck, table);
-            if (cat.isValid() && pid == PID_CAT) {
-                handleCAT(cat);
-            }
-            break;
-        }
-        case TID_PMT: {
-            PMT pmt(duck, table);
-            if (pmt.isValid()) {
-                handlePMT(pmt, pid);
-            }
-            break;
-        }
-        case TID_SDT_ACT: {
-            SDT sdt(duck, table);
-            if (sdt.isValid() && pid == PID_SDT) {
-                handleSDT(sdt);
-            }
-            break;
-        }
-        case TID_TVCT: {
-            TVCT vct(duck, table);
-            if (vct.isValid() && pid == PID_PSIP) {
-                handleVCT(vct);
-            }
-            break;
-        }
-        case TID_CVCT: {
-            CVCT vct(duck, table);
-            if (vct.isValid() && pid == PID_PSIP) {
-                handleVCT(vct);
-            }
-            break;
-        }
-        default: {
-            // Not interested in that table.
-            break;
+        // The PMT of the service may have been already received by the signalization demux.
+        PMT pmt;
+        if (ctx.pmt_pid != PID_NULL && demux.getPMT(pmt, service_id)) {
+            processPMT(ctx, pmt);
         }
     }
 }
@@ -526,13 +448,8 @@ void ts::ZapPlugin::handleTable(SectionDemux& demux, const BinaryTable& table)
 // This method processes a Program Association Table (PAT).
 //----------------------------------------------------------------------------
 
-void ts::ZapPlugin::handlePAT(PAT& pat)
+void ts::ZapPlugin::handlePAT(const PAT& pat, PID)
 {
-    // Remember last PAT (unless we reprocess it).
-    if (&pat != &_last_pat) {
-        _last_pat = pat;
-    }
-
     // Search selected services in the PAT.
     bool need_new_pat = false;
     for (size_t i = 0; i < _services.size(); ++i) {
@@ -550,9 +467,8 @@ void ts::ZapPlugin::handlePAT(PAT& pat)
                     // The PMT PID was previously known but has changed.
                     forgetServiceComponents(ctx);
                 }
-                // Need to process the PMT on that PID.
+                // The PMT on that PID will be notified by the signalization demux.
                 ctx.pmt_pid = it->second;
-                _demux.addPID(ctx.pmt_pid);
                 verbose(u"found service id 0x%X, PMT PID is 0x%X", ctx.service_id, ctx.pmt_pid);
                 need_new_pat = true;
             }
@@ -568,8 +484,11 @@ void ts::ZapPlugin::handlePAT(PAT& pat)
 // This method processes a Service Description Table (SDT).
 //----------------------------------------------------------------------------
 
-void ts::ZapPlugin::handleSDT(SDT& sdt)
+void ts::ZapPlugin::handleSDT(const SDT& table, PID)
 {
+    // The SDT is modified, work on a copy.
+    SDT sdt(table);
+
     // Loop on all selected services, checking those which are specified by name.
     for (size_t i = 0; i < _services.size(); ++i) {
         ServiceContext& ctx(*_services[i]);
@@ -619,7 +538,7 @@ void ts::ZapPlugin::handleSDT(SDT& sdt)
 // contains many other tables, including one-shot tables.
 //----------------------------------------------------------------------------
 
-void ts::ZapPlugin::handleVCT(VCT& vct)
+void ts::ZapPlugin::handleVCT(const VCT& vct, PID)
 {
     // Loop on all selected services, checking those which are specified by name.
     for (size_t i = 0; i < _services.size(); ++i) {
@@ -641,7 +560,7 @@ void ts::ZapPlugin::handleVCT(VCT& vct)
 // This method processes a Program Map Table (PMT).
 //----------------------------------------------------------------------------
 
-void ts::ZapPlugin::handlePMT(PMT& pmt, PID pmt_pid)
+void ts::ZapPlugin::handlePMT(const PMT& pmt, PID pmt_pid)
 {
     // Filter out any unexpected PMT.
     ServiceContextPtr ctx;
@@ -662,16 +581,26 @@ void ts::ZapPlugin::handlePMT(PMT& pmt, PID pmt_pid)
         sendNewPAT();
     }
 
+    processPMT(*ctx, pmt);
+}
+
+
+//----------------------------------------------------------------------------
+// Filter the components of a selected service and build its modified PMT.
+//----------------------------------------------------------------------------
+
+void ts::ZapPlugin::processPMT(ServiceContext& ctx, PMT pmt)
+{
     // Forget previous component PID's of the service.
-    forgetServiceComponents(*ctx);
+    forgetServiceComponents(ctx);
 
     // Record the PCR PID as a PES component of the service
     if (pmt.pcr_pid != PID_NULL) {
-        _pid_state[pmt.pcr_pid] = TSPID_PES;
+        _classifier.setVerdict(pmt.pcr_pid, VERDICT_PES);
     }
 
     // Record or remove ECMs PIDs at service level.
-    processECM(*ctx, pmt.descs);
+    processECM(ctx, pmt.descs);
 
     // Loop on all elementary streams of the PMT and remove streams we do not need.
     // Note: no "++i" in "for" expression since "it" can be updated by erase().
@@ -693,10 +622,10 @@ void ts::ZapPlugin::handlePMT(PMT& pmt, PID pmt_pid)
         // Keep or remove the component.
         if (keep) {
             // We keep this component, record component PID
-            _pid_state[cpid] = uint8_t(StreamTypeIsPES(stream.stream_type) ? TSPID_PES : TSPID_DATA);
+            _classifier.setVerdict(cpid, StreamTypeIsPES(stream.stream_type) ? VERDICT_PES : VERDICT_DATA);
 
             // Record or remove ECMs PIDs at component level.
-            processECM(*ctx, stream.descs);
+            processECM(ctx, stream.descs);
 
             // Now iterate to next stream.
             ++it;
@@ -709,12 +638,12 @@ void ts::ZapPlugin::handlePMT(PMT& pmt, PID pmt_pid)
 
     // Build the list of TS packets containing the new PMT.
     // These packets will replace everything on the PMT PID.
-    ctx->pzer_pmt.removeAll();
-    ctx->pzer_pmt.setPID(ctx->pmt_pid);
-    ctx->pzer_pmt.addTable(duck, pmt);
+    ctx.pzer_pmt.removeAll();
+    ctx.pzer_pmt.setPID(ctx.pmt_pid);
+    ctx.pzer_pmt.addTable(duck, pmt);
 
     // Now allow transmission of (modified) packets from PMT PID
-    _pid_state[ctx->pmt_pid] = TSPID_PMT;
+    _classifier.setVerdict(ctx.pmt_pid, VERDICT_PMT);
 }
 
 
@@ -722,18 +651,23 @@ void ts::ZapPlugin::handlePMT(PMT& pmt, PID pmt_pid)
 // This method processes a Conditional Access Table (CAT).
 //----------------------------------------------------------------------------
 
-void ts::ZapPlugin::handleCAT(CAT& cat)
+void ts::ZapPlugin::handleCAT(const CAT& cat, PID)
 {
+    // EMM's are passed only with --cas.
+    if (!_include_cas) {
+        return;
+    }
+
     // Erase all previously known EMM PIDs
-    for (size_t epid = 0; epid < PID_MAX; epid++) {
-        if (_pid_state[epid] == TSPID_EMM) {
-            _pid_state[epid] = TSPID_DROP;
+    for (PID epid = 0; epid < PID_MAX; epid++) {
+        if (_classifier.verdict(epid) == VERDICT_EMM) {
+            _classifier.setVerdict(epid, PacketClassifier::DROP);
         }
     }
 
     // Register all new EMM PIDs
     std::set<PID> pids;
-    analyzeCADescriptors(pids, cat.descs, TSPID_EMM);
+    analyzeCADescriptors(pids, cat.descs, VERDICT_EMM);
 }
 
 
@@ -750,7 +684,7 @@ void ts::ZapPlugin::processECM(ServiceContext& ctx, DescriptorList& descs)
     }
     else {
         // Locate all ECM PID's and add them as components of the service.
-        analyzeCADescriptors(ctx.pids, descs, TSPID_DATA);
+        analyzeCADescriptors(ctx.pids, descs, VERDICT_DATA);
     }
 }
 
@@ -759,7 +693,7 @@ void ts::ZapPlugin::processECM(ServiceContext& ctx, DescriptorList& descs)
 // Analyze a list of descriptors, looking for CA descriptors.
 //----------------------------------------------------------------------------
 
-void ts::ZapPlugin::analyzeCADescriptors(std::set<PID>& pids, const DescriptorList& descs, uint8_t pid_state)
+void ts::ZapPlugin::analyzeCADescriptors(std::set<PID>& pids, const DescriptorList& descs, PacketClassifier::Verdict verdict)
 {
     // Loop on all CA descriptors (MPEG and ISDB).
     for (size_t index = 0; index < descs.size(); ++index) {
@@ -768,7 +702,7 @@ void ts::ZapPlugin::analyzeCADescriptors(std::set<PID>& pids, const DescriptorLi
             if (descs[index]->payloadSize() >= 4) {
                 const uint16_t pid = GetUInt16(descs[index]->payload() + 2) & 0x1FFF;
                 pids.insert(pid);
-                _pid_state[pid] = pid_state;
+                _classifier.setVerdict(pid, verdict);
             }
         }
     }
@@ -811,8 +745,8 @@ ts::ProcessorPlugin::Status ts::ZapPlugin::processPacket(TSPacket& pkt, TSPacket
 {
     const PID pid = pkt.getPID();
 
-    // Filter interesting sections
-    _demux.feedPacket(pkt);
+    // Analyze the signalization.
+    _classifier.feedPacket(pkt);
 
     // If a fatal error occured during section analysis, give up.
     if (_abort) {
@@ -826,26 +760,29 @@ ts::ProcessorPlugin::Status ts::ZapPlugin::processPacket(TSPacket& pkt, TSPacket
         return pkt.getPID() == PID_NULL ? _drop_status : TSP_OK;
     }
 
+    // Get the verdict of the packet.
+    const PacketClassifier::Verdict verdict = _classifier.classify(pkt, pkt_data, tsp->pluginPackets());
+
     // Remove all non-PES packets if option --pes-only
-    if (_pes_only && _pid_state[pid] != TSPID_PES) {
+    if (_pes_only && verdict != VERDICT_PES) {
         return _drop_status;
     }
 
     // Pass, modify or drop the packets
-    switch (_pid_state[pid]) {
+    switch (verdict) {
 
-        case TSPID_DROP:
+        case PacketClassifier::DROP:
             // Packet must be dropped or replaced by a null packet
             return _drop_status;
 
-        case TSPID_PASS:
-        case TSPID_DATA:
-        case TSPID_PES:
-        case TSPID_EMM:
+        case PacketClassifier::PASS:
+        case VERDICT_DATA:
+        case VERDICT_PES:
+        case VERDICT_EMM:
             // Packet is passed unmodified.
             return TSP_OK;
 
-        case TSPID_PMT:
+        case VERDICT_PMT:
             // Replace all PMT packets with modified PMT. Look for the right PMT.
             for (size_t i = 0; i < _services.size(); ++i) {
                 ServiceContext& ctx(*_services[i]);
@@ -856,17 +793,17 @@ ts::ProcessorPlugin::Status ts::ZapPlugin::processPacket(TSPacket& pkt, TSPacket
             // If PMT not found, drop the packet.
             return _drop_status;
 
-        case TSPID_PAT:
+        case VERDICT_PAT:
             // Replace all PAT packets with modified PAT.
             return _pzer_pat.getNextPacket(pkt) ? TSP_OK : _drop_status;
 
-        case TSPID_SDT:
+        case VERDICT_SDT:
             // Replace all SDT/BAT packets with modified SDT Actual. SDT Other and BAT are overwritten.
             return _pzer_sdt.getNextPacket(pkt) ? TSP_OK : _drop_status;
 
         default:
             // Should never get there...
-            error(u"internal error, invalid PID state %d", _pid_state[pid]);
+            error(u"internal error, invalid PID verdict %d", verdict);
             return TSP_END;
     }
 }
@@ -16,8 +16,16 @@
 #include "tsTSFile.h"
 #include "tsPagerArgs.h"
 #include "tsDuckContext.h"
+#include "tsThread.h"
+#include "tsErrCodeReport.h"
 TS_MAIN(MainCode);
 
+// Number of packets per read operation.
+#define READ_PACKETS 1024
+
+// Minimum number of packets per chunk in parallel analysis.
+#define MIN_CHUNK_PACKETS 100000
+
 
 //----------------------------------------------------------------------------
 //  Command line options
@@ -36,6 +44,8 @@ namespace {
         ts::TSPacketFormat    format = ts::TSPacketFormat::AUTODETECT; // Input file format.
         ts::TSAnalyzerOptions analysis {};         // Analysis options.
         ts::PagerArgs         pager {true, true};  // Output paging options.
+        size_t                threads = 1;         // Number of analysis threads.
+        ts::DuckContext::SavedArgs duck_args {};   // DuckContext options, reapplied in each thread.
     };
 }
 
@@ -60,6 +70,18 @@ Options::Options(int argc, char *argv[]) :
          u"(based on 188-byte packets). By default, the bitrate is "
          u"evaluated using the PCR in the transport stream.");
 
+    option(u"threads", 0, POSITIVE);
+    help(u"threads", u"count",
+         u"Analyze the input file in parallel, using the specified number of threads. "
+         u"The input file must be a regular file. It is split in packet-aligned chunks "
+         u"which are concurrently analyzed. The results are merged into one report which is "
+         u"equivalent to a sequential analysis, with a few approximations at the boundaries "
+         u"between chunks: the PCR interval and the crypto-period which span a boundary are "
+         u"not used in the bitrate and crypto-period evaluations, a section or a PES packet "
+         u"which spans a boundary is lost, the sections of a PMT are ignored at the beginning "
+         u"of a chunk, until the PAT is found. "
+         u"By default, the file is sequentially analyzed.");
+
     analyze(argc, argv);
 
     // Define all standard analysis options.
@@ -69,12 +91,160 @@ Options::Options(int argc, char *argv[]) :
 
     getPathValue(infile, u"");
     getValue(bitrate, u"bitrate");
+    getIntValue(threads, u"threads", 1);
     format = ts::LoadTSPacketFormatInputOption(*this);
 
+    // The DuckContext options are reapplied in the context of each thread.
+    duck.saveArgs(duck_args);
+
     exitOnError();
 }
 
 
+//----------------------------------------------------------------------------
+// Analyze a range of packets from the input file.
+//----------------------------------------------------------------------------
+
+namespace {
+    bool AnalyzeFile(ts::TSAnalyzer& analyzer, const Options& opt, ts::Report& report, ts::TSPacketFormat format, uint64_t start_offset, ts::PacketCounter max_packets)
+    {
+        ts::TSFile file;
+        if (!file.openRead(opt.infile, 1, start_offset, report, format)) {
+            return false;
+        }
+        ts::TSPacketVector packets(READ_PACKETS);
+        ts::TSPacketMetadataVector mdata(READ_PACKETS);
+        size_t count = 0;
+        while (max_packets > 0 && (count = file.readPackets(packets.data(), mdata.data(), size_t(std::min<ts::PacketCounter>(READ_PACKETS, max_packets)), report)) > 0) {
+            for (size_t i = 0; i < count; ++i) {
+                analyzer.feedPacket(packets[i], mdata[i]);
+            }
+            max_packets -= count;
+        }
+        file.close(report);
+        return true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Analysis of one chunk of the input file, in a separate thread.
+//----------------------------------------------------------------------------
+
+namespace {
+    class ChunkThread: public ts::Thread
+    {
+        TS_NOBUILD_NOCOPY(ChunkThread);
+    public:
+        // Constructor and destructor.
+        ChunkThread(Options& opt, ts::TSPacketFormat format, uint64_t start_offset, ts::PacketCounter packet_count);
+        virtual ~ChunkThread() override;
+
+        // Access the analysis and the status, when the thread is terminated.
+        const ts::TSAnalyzer& analyzer() const { return _analyzer; }
+        bool success() const { return _success; }
+
+    private:
+        Options&                 _opt;
+        const ts::TSPacketFormat _format;
+        const uint64_t           _start_offset;
+        const ts::PacketCounter  _packet_count;
+        ts::Report               _report;
+        ts::DuckContext          _duck {&_report};
+        ts::TSAnalyzerReport     _analyzer {_duck, _opt.bitrate, ts::BitRateConfidence::OVERRIDE};
+        bool                     _success = false;
+
+        // Implementation of Thread.
+        virtual void main() override;
+    };
+}
+
+ChunkThread::ChunkThread(Options& opt, ts::TSPacketFormat format, uint64_t start_offset, ts::PacketCounter packet_count) :
+    _opt(opt),
+    _format(format),
+    _start_offset(start_offset),
+    _packet_count(packet_count),
+    _report(opt.maxSeverity(), ts::UString(), &opt)
+{
+    _duck.restoreArgs(_opt.duck_args);
+    _analyzer.setAnalysisOptions(_opt.analysis);
+}
+
+ChunkThread::~ChunkThread()
+{
+    waitForTermination();
+}
+
+void ChunkThread::main()
+{
+    _success = AnalyzeFile(_analyzer, _opt, _report, _format, _start_offset, _packet_count);
+}
+
+
+//----------------------------------------------------------------------------
+// Parallel analysis of a regular file. Return false if not applicable.
+//----------------------------------------------------------------------------
+
+namespace {
+    bool ParallelAnalysis(ts::TSAnalyzer& analyzer, Options& opt, bool& success)
+    {
+        if (opt.threads < 2) {
+            return false;
+        }
+        if (opt.infile.empty() || !fs::is_regular_file(opt.infile)) {
+            opt.verbose(u"input is not a regular file, sequential analysis");
+            return false;
+        }
+
+        // Read the first packet to get the packet format and size.
+        ts::TSFile file;
+        ts::TSPacket pkt;
+        if (!file.openRead(opt.infile, 1, 0, opt, opt.format)) {
+            success = false;
+            return true;
+        }
+        file.readPackets(&pkt, nullptr, 1, opt);
+        const ts::TSPacketFormat format = file.packetFormat();
+        const size_t packet_size = file.packetHeaderSize() + ts::PKT_SIZE + file.packetTrailerSize();
+        file.close(opt);
+
+        // Split the file in packet-aligned chunks, at most one per thread.
+        bool size_ok = true;
+        const std::uintmax_t file_size = fs::file_size(opt.infile, &ts::ErrCodeReport(size_ok, opt, u"error getting size of", opt.infile));
+        if (!size_ok) {
+            success = false;
+            return true;
+        }
+        const ts::PacketCounter total = file_size / packet_size;
+        const size_t chunks = size_t(std::min<ts::PacketCounter>(opt.threads, std::max<ts::PacketCounter>(1, total / MIN_CHUNK_PACKETS)));
+        if (chunks < 2) {
+            opt.verbose(u"input file is too small, sequential analysis");
+            return false;
+        }
+        opt.verbose(u"analyzing %'d packets in %d chunks", total, chunks);
+
+        // Start one thread per chunk, except the first one which is analyzed in the main thread.
+        std::vector<std::unique_ptr<ChunkThread>> threads;
+        for (size_t i = 1; i < chunks; ++i) {
+            const ts::PacketCounter first = (total * i) / chunks;
+            const ts::PacketCounter count = (total * (i + 1)) / chunks - first;
+            threads.push_back(std::make_unique<ChunkThread>(opt, format, first * packet_size, count));
+            threads.back()->start();
+        }
+        success = AnalyzeFile(analyzer, opt, opt, format, 0, total / chunks);
+
+        // Merge the analyses of all chunks, in order.
+        for (auto& thread : threads) {
+            thread->waitForTermination();
+            success = success && thread->success();
+            analyzer.merge(thread->analyzer());
+            thread.reset();
+        }
+        return true;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 //  Program entry point
 //----------------------------------------------------------------------------
@@ -88,19 +258,14 @@ int MainCode(int argc, char *argv[])
     ts::TSAnalyzerReport analyzer(opt.duck, opt.bitrate, ts::BitRateConfidence::OVERRIDE);
     analyzer.setAnalysisOptions(opt.analysis);
 
-    // Open the TS file.
-    ts::TSFile file;
-    if (!file.openRead(opt.infile, 1, 0, opt, opt.format)) {
-        return EXIT_FAILURE;
+    // Analyze all packets in the file, in parallel when possible.
+    bool success = true;
+    if (!ParallelAnalysis(analyzer, opt, success)) {
+        success = AnalyzeFile(analyzer, opt, opt, opt.format, 0, std::numeric_limits<ts::PacketCounter>::max());
     }
-
-    // Analyze all packets in the file.
-    ts::TSPacket pkt;
-    ts::TSPacketMetadata mdata;
-    while (file.readPackets(&pkt, &mdata, 1, opt) > 0) {
-        analyzer.feedPacket(pkt, mdata);
+    if (!success) {
+        return EXIT_FAILURE;
     }
-    file.close(opt);
 
     // Display analysis results.
     analyzer.report(opt.pager.output(opt), opt.analysis, opt);
@@ -16,9 +16,11 @@
 #include "tsNullReport.h"
 #include "tsFatal.h"
 #include "tsThread.h"
+#include "tsMessageQueue.h"
 #include "tsSysUtils.h"
 #include "tsECMGSCS.h"
 #include "tsTCPServer.h"
+#include "tsSocketReactor.h"
 #include "tstlvConnection.h"
 #include "tsDuckProtocol.h"
 #include "tsOneShotPacketizer.h"
@@ -33,11 +35,14 @@ namespace {
     static const int16_t  DEFAULT_TRANS_DELAY_START = -500;
     static const int16_t  DEFAULT_TRANS_DELAY_STOP  = 0;
 
-    // Stack size for execution of the client connection thread
-    static constexpr size_t CLIENT_STACK_SIZE = 128 * 1024;
+    static const size_t   DEFAULT_WORKERS           = 4;
 
-    // Instantiation of a TCP connection in a multi-thread context for TLV messages.
-    using ECMGConnection = ts::tlv::Connection<ts::ThreadSafety::Full>;
+    // Stack size for execution of the ECM generation threads.
+    static constexpr size_t WORKER_STACK_SIZE = 128 * 1024;
+
+    // Instantiation of a TCP connection for TLV messages.
+    // All connections are exclusively managed in the reactor thread.
+    using ECMGConnection = ts::tlv::Connection<ts::ThreadSafety::None>;
     using ECMGConnectionPtr = std::shared_ptr<ECMGConnection>;
 }
 
@@ -60,6 +65,7 @@ namespace {
         int                        logData = ts::Severity::Debug;      // Log level for CW/ECM data messages.
         bool                       once = false;            // Accept only one client.
         bool                       reusePort = false;       // Socket option.
+        size_t                     workers = 0;             // Number of ECM generation threads.
         cn::milliseconds           ecmCompTime {};          // ECM computation time.
         ts::IPSocketAddress        serverAddress {};        // TCP server local address.
         ts::ecmgscs::ChannelStatus channelStatus {ecmgscs}; // Standard parameters required by this ECMG.
@@ -159,12 +165,21 @@ ECMGOptions::ECMGOptions(int argc, char *argv[]) :
          u"This option sets the DVB SimulCrypt option 'transition_delay_stop', in "
          u"milliseconds. Default: " + ts::UString::Decimal(DEFAULT_TRANS_DELAY_STOP) + u" ms.");
 
+    option(u"workers", 'w', POSITIVE);
+    help(u"workers",
+         u"Specify the number of threads which generate ECM's. All client connections are "
+         u"handled by one single thread and the ECM generation is dispatched to a pool of "
+         u"worker threads. All ECM's of a given stream are built by the same worker thread, "
+         u"so that the responses are returned in the order of the requests. "
+         u"Default: " + ts::UString::Decimal(DEFAULT_WORKERS) + u".");
+
     analyze(argc, argv);
 
     logArgs.loadArgs(duck, *this);
     serverAddress.setPort(intValue<uint16_t>(u"port", DEFAULT_SERVER_PORT));
     once = present(u"once");
     reusePort = !present(u"no-reuse-port");
+    getIntValue(workers, u"workers", DEFAULT_WORKERS);
     getChronoValue(ecmCompTime, u"comp-time");
     logProtocol = present(u"log-protocol") ? intValue<int>(u"log-protocol", ts::Severity::Info) : ts::Severity::Debug;
     logData = present(u"log-data") ? intValue<int>(u"log-data", ts::Severity::Info) : logProtocol;
@@ -200,6 +215,24 @@ ECMGOptions::ECMGOptions(int argc, char *argv[]) :
 }
 
 
+//----------------------------------------------------------------------------
+// An ECM generation request, processed by a worker thread.
+//----------------------------------------------------------------------------
+
+class ECMGClientSession;
+using ECMGClientSessionPtr = std::shared_ptr<ECMGClientSession>;
+
+class ECMRequest
+{
+public:
+    std::weak_ptr<ECMGClientSession> session {};             // Requesting session, may disappear before the ECM is ready.
+    std::shared_ptr<const ts::ecmgscs::CWProvision> msg {};  // The CW_provision message.
+    cn::steady_clock::time_point received {};                // Reception time of the request.
+};
+
+using ECMRequestQueue = ts::MessageQueue<ECMRequest>;
+
+
 //----------------------------------------------------------------------------
 // A class implementing the ECMG shared data, used from all threads.
 //----------------------------------------------------------------------------
@@ -223,9 +256,27 @@ public:
     // Get the shared asynchronous protocol message logger.
     ts::tlv::Logger& logger() { return _logger; }
 
+    // Get the reactor which manages all client connections.
+    ts::SocketReactor& reactor() { return _reactor; }
+
+    // Get the number of worker threads.
+    size_t workerCount() const { return _requests.size(); }
+
+    // Get the queue of ECM requests of a worker thread.
+    ECMRequestQueue& workerRequests(size_t index) { return *_requests[index]; }
+
+    // Get the queue of ECM requests for a stream. All requests of a stream are
+    // processed by the same worker thread to preserve the order of the responses.
+    ECMRequestQueue& streamRequests(uint16_t channel_id, uint16_t stream_id)
+    {
+        return *_requests[((size_t(channel_id) << 16) | stream_id) % _requests.size()];
+    }
+
 private:
     ts::AsyncReport    _report;       // Asynchronous message report.
     ts::tlv::Logger    _logger;       // Protocol message logger.
+    ts::SocketReactor  _reactor {};   // Reactor for client connections.
+    std::vector<std::unique_ptr<ECMRequestQueue>> _requests {};  // ECM requests to process, one queue per worker.
     std::mutex         _mutex {};     // Protect shared data.
     std::set<uint16_t> _channels {};  // Active channels.
 };
@@ -243,6 +294,11 @@ ECMGSharedData::ECMGSharedData(const ECMGOptions& opt) :
     // The CW/ECM data messages have a distinct log level.
     _logger.setSeverity(ts::ecmgscs::Tags::CW_provision, opt.logData);
     _logger.setSeverity(ts::ecmgscs::Tags::ECM_response, opt.logData);
+
+    // One queue of requests per worker thread.
+    for (size_t i = 0; i < std::max<size_t>(opt.workers, 1); ++i) {
+        _requests.push_back(std::make_unique<ECMRequestQueue>());
+    }
 }
 
 // Declare a new ECM_channel_id. Return false if already active.
@@ -265,32 +321,79 @@ bool ECMGSharedData::closeChannel(uint16_t id)
 
 
 //----------------------------------------------------------------------------
-// A class implementing a thread which manages a client connection.
+// A class implementing the TCP server, accepting client connections.
 //----------------------------------------------------------------------------
 
-class ECMGClientHandler: public ts::Thread
+class ECMGServer: private ts::SocketReactorHandlerInterface
 {
-    TS_NOBUILD_NOCOPY(ECMGClientHandler);
+    TS_NOBUILD_NOCOPY(ECMGServer);
 public:
     // Constructor.
-    // When deleteWhenTerminated is true, this object is automatically deleted when the thread terminates.
-    ECMGClientHandler(const ECMGOptions& opt, const ECMGConnectionPtr& conn, ECMGSharedData* shared, bool deleteWhenTerminated);
+    ECMGServer(const ECMGOptions& opt, ECMGSharedData& shared, ts::TCPServer& server);
 
-    // Destructor.
-    virtual ~ECMGClientHandler() override;
+    // Start accepting client connections.
+    bool start();
 
-    // Main code of the thread.
-    // Make it a public methof to invoke it synchronously with --once.
-    virtual void main() override;
+    // Close all client sessions.
+    void closeAll();
+
+    // Invoked by a client session when it is terminated. The session is deallocated later.
+    void sessionTerminated(const ECMGClientSessionPtr& session);
 
 private:
-    const ECMGOptions&          _opt;
-    ts::duck::Protocol          _protocol {};   // To encode ECM structure.
-    ECMGSharedData*             _shared = nullptr;
-    ECMGConnectionPtr           _conn {};
-    ts::UString                 _peer {};
-    std::optional<uint16_t>     _channel {};    // Current channel id.
-    std::map<uint16_t,uint16_t> _streams {};    // Map of current stream id => ECM id.
+    const ECMGOptions&             _opt;
+    ECMGSharedData&                _shared;
+    ts::TCPServer&                 _server;
+    std::set<ECMGClientSessionPtr> _sessions {};
+
+    // Implementation of SocketReactorHandlerInterface: accept incoming connections.
+    virtual void handleSocketEvents(ts::SocketReactor& reactor, ts::SysSocketType sock, ts::SocketEvents events) override;
+
+    // Delay before accepting new connections after an accept error.
+    static constexpr cn::milliseconds ACCEPT_RETRY_DELAY = cn::milliseconds(100);
+};
+
+
+//----------------------------------------------------------------------------
+// A class managing a client connection in the context of the reactor.
+//----------------------------------------------------------------------------
+
+class ECMGClientSession: private ts::SocketReactorHandlerInterface
+{
+    TS_NOBUILD_NOCOPY(ECMGClientSession);
+public:
+    // Constructor.
+    ECMGClientSession(const ECMGOptions& opt, const ECMGConnectionPtr& conn, ECMGSharedData& shared, ECMGServer& server);
+
+    // Register the session in the reactor. The self pointer is used by asynchronous operations.
+    bool start(const ECMGClientSessionPtr& self);
+
+    // Terminate the session.
+    void close();
+
+    // Send an ECM response (or an error) which was computed by a worker thread.
+    void sendECMResponse(const ts::tlv::MessagePtr& msg);
+
+private:
+    const ECMGOptions&               _opt;
+    ECMGSharedData&                  _shared;
+    ECMGServer&                      _server;
+    ECMGConnectionPtr                _conn {};
+    std::weak_ptr<ECMGClientSession> _self {};
+    ts::SysSocketType                _sock = ts::SYS_SOCKET_INVALID;
+    bool                             _closed = false;
+    ts::UString                      _peer {};
+    std::optional<uint16_t>          _channel {};    // Current channel id.
+    std::map<uint16_t,uint16_t>      _streams {};    // Map of current stream id => ECM id.
+
+    // Implementation of SocketReactorHandlerInterface.
+    virtual void handleSocketEvents(ts::SocketReactor& reactor, ts::SysSocketType sock, ts::SocketEvents events) override;
+
+    // Monitor write events only when some output is pending.
+    bool updateEvents();
+
+    // Handle one incoming message.
+    bool handleMessage(const ts::tlv::MessagePtr& msg);
 
     // Handle the various ECMG client messages.
     bool handleChannelSetup(ts::ecmgscs::ChannelSetup* msg);
@@ -299,12 +402,12 @@ private:
     bool handleStreamSetup(ts::ecmgscs::StreamSetup* msg);
     bool handleStreamTest(ts::ecmgscs::StreamTest* msg);
     bool handleStreamCloseRequest(ts::ecmgscs::StreamCloseRequest* msg);
-    bool handleCWProvision(ts::ecmgscs::CWProvision* msg);
+    bool handleCWProvision(const ts::tlv::MessagePtr& msg);
 
     // Send a response message.
     bool send(const ts::tlv::Message* msg)
     {
-        return _conn->send(*msg, _shared->logger());
+        return _conn->sendNonBlocking(*msg, _shared.logger());
     }
 
     // Send an error related to the msg.
@@ -313,92 +416,228 @@ private:
 
 
 //----------------------------------------------------------------------------
-// ECMG client constructor and destructor.
+// A class implementing a worker thread which generates ECM's.
+//----------------------------------------------------------------------------
+
+class ECMGWorker: public ts::Thread
+{
+    TS_NOBUILD_NOCOPY(ECMGWorker);
+public:
+    // Constructor and destructor.
+    ECMGWorker(const ECMGOptions& opt, ECMGSharedData& shared, size_t index);
+    virtual ~ECMGWorker() override;
+
+private:
+    const ECMGOptions& _opt;
+    ECMGSharedData&    _shared;
+    ECMRequestQueue&   _requests;      // Queue of requests for this worker.
+    ts::duck::Protocol _protocol {};   // To encode ECM structure.
+
+    // Main code of the thread.
+    virtual void main() override;
+
+    // Build the response to a CW_provision, either an ECM_response or a stream_error.
+    ts::tlv::MessagePtr buildResponse(const ts::ecmgscs::CWProvision& msg);
+};
+
+
+//----------------------------------------------------------------------------
+// Implementation of ECMGServer.
 //----------------------------------------------------------------------------
 
-ECMGClientHandler::ECMGClientHandler(const ECMGOptions& opt, const ECMGConnectionPtr& conn, ECMGSharedData* shared, bool deleteWhenTerminated) :
+ECMGServer::ECMGServer(const ECMGOptions& opt, ECMGSharedData& shared, ts::TCPServer& server) :
     _opt(opt),
     _shared(shared),
-    _conn(conn)
+    _server(server)
 {
-    // Set thread attributes. Beware of deleteWhenTerminated...
-    ts::ThreadAttributes attr;
-    attr.setStackSize(CLIENT_STACK_SIZE);
-    attr.setDeleteWhenTerminated(deleteWhenTerminated);
-    setAttributes(attr);
 }
 
-ECMGClientHandler::~ECMGClientHandler()
+// Start accepting client connections.
+bool ECMGServer::start()
 {
-    // Wait for completion of the thread.
-    waitForTermination();
+    return _shared.reactor().add(_server.getSocket(), this, ts::SocketEvents::READ, _shared.report());
+}
+
+// Close all client sessions.
+void ECMGServer::closeAll()
+{
+    // Closing a session removes it from the set later, iterate on a copy.
+    const std::set<ECMGClientSessionPtr> sessions(_sessions);
+    for (const auto& session : sessions) {
+        session->close();
+    }
+    _sessions.clear();
+}
+
+// Invoked by a client session when it is terminated.
+void ECMGServer::sessionTerminated(const ECMGClientSessionPtr& session)
+{
+    // We are probably in a handler of the session, deallocate it later.
+    _shared.reactor().post([this, session]() {
+        _sessions.erase(session);
+        if (_opt.once) {
+            // With --once, the server terminates at the end of the session.
+            _shared.reactor().stop();
+        }
+    });
+}
+
+// Accept incoming connections.
+void ECMGServer::handleSocketEvents(ts::SocketReactor& reactor, ts::SysSocketType sock, ts::SocketEvents events)
+{
+    ts::IPSocketAddress clientAddress;
+    ECMGConnectionPtr conn(new ECMGConnection(_opt.ecmgscs, true, 3));
+    ts::CheckNonNull(conn.get());
+    if (!_server.accept(*conn, clientAddress, _shared.report())) {
+        if (!_server.isOpen()) {
+            // The server socket is closed, cannot accept any other client.
+            reactor.stop();
+        }
+        else {
+            // Transient error (too many open files, connection aborted by the client, etc.)
+            // The pending connection may still be in the backlog. Stop monitoring the server
+            // socket for some time, to avoid looping on the same error.
+            _shared.report().warning(u"suspending incoming connections for %s", ACCEPT_RETRY_DELAY);
+            reactor.remove(sock, _shared.report());
+            reactor.postAfter(ACCEPT_RETRY_DELAY, [this, &reactor, sock]() {
+                if (_server.isOpen()) {
+                    reactor.add(sock, this, ts::SocketEvents::READ, _shared.report());
+                }
+            });
+        }
+        return;
+    }
+
+    // All client connections are non-blocking and managed by the reactor.
+    ECMGClientSessionPtr session(new ECMGClientSession(_opt, conn, _shared, *this));
+    ts::CheckNonNull(session.get());
+    if (conn->setNonBlocking(true, _shared.report()) && session->start(session)) {
+        _sessions.insert(session);
+    }
+    else {
+        conn->close(_shared.report());
+    }
+
+    // With --once, don't accept any other connection.
+    if (_opt.once) {
+        reactor.remove(sock, _shared.report());
+    }
 }
 
 
 //----------------------------------------------------------------------------
-// Main code of the client connection thread.
+// ECMG client session constructor, start and stop.
 //----------------------------------------------------------------------------
 
-void ECMGClientHandler::main()
+ECMGClientSession::ECMGClientSession(const ECMGOptions& opt, const ECMGConnectionPtr& conn, ECMGSharedData& shared, ECMGServer& server) :
+    _opt(opt),
+    _shared(shared),
+    _server(server),
+    _conn(conn),
+    _sock(conn->getSocket()),
+    _peer(conn->peerName())
+{
+}
+
+bool ECMGClientSession::start(const ECMGClientSessionPtr& self)
 {
-    _peer = _conn->peerName();
-    _shared->report().verbose(u"%s: session started", _peer);
+    _self = self;
+    _shared.report().verbose(u"%s: session started", _peer);
+    return _shared.reactor().add(_sock, this, ts::SocketEvents::READ, _shared.report());
+}
+
+void ECMGClientSession::close()
+{
+    if (!_closed) {
+        _closed = true;
+
+        // The socket must be removed from the reactor before being closed.
+        _shared.reactor().remove(_sock, NULLREP);
+        _conn->disconnect(NULLREP);
+        _conn->close(_shared.report());
+
+        // Make sure to release the channel if not done by the clients.
+        if (_channel.has_value()) {
+            _shared.closeChannel(_channel.value());
+            _channel.reset();
+        }
+        _streams.clear();
+
+        _shared.report().verbose(u"%s: session completed", _peer);
+        _server.sessionTerminated(_self.lock());
+    }
+}
+
 
-    // Normally, an ECMG should handle incoming and outgoing messages independently.
-    // However, here we have a minimal implementation. We never send any request to
-    // the client and the ECM generation is instantaneous. So, we simply wait for
-    // requests from the client and respond to them immediately.
+//----------------------------------------------------------------------------
+// Process events on the client connection.
+//----------------------------------------------------------------------------
 
-    // Loop on message reception
-    ts::tlv::MessagePtr msg;
+void ECMGClientSession::handleSocketEvents(ts::SocketReactor& reactor, ts::SysSocketType sock, ts::SocketEvents events)
+{
     bool ok = true;
-    while (ok && _conn->receive(msg, nullptr, _shared->logger())) {
-        switch (msg->tag()) {
-            case ts::ecmgscs::Tags::channel_setup:
-                ok = handleChannelSetup(dynamic_cast<ts::ecmgscs::ChannelSetup*>(msg.get()));
-                break;
-            case ts::ecmgscs::Tags::channel_test:
-                ok = handleChannelTest(dynamic_cast<ts::ecmgscs::ChannelTest*>(msg.get()));
-                break;
-            case ts::ecmgscs::Tags::channel_close:
-                ok = handleChannelClose(dynamic_cast<ts::ecmgscs::ChannelClose*>(msg.get()));
-                break;
-            case ts::ecmgscs::Tags::stream_setup:
-                ok = handleStreamSetup(dynamic_cast<ts::ecmgscs::StreamSetup*>(msg.get()));
-                break;
-            case ts::ecmgscs::Tags::stream_test:
-                ok = handleStreamTest(dynamic_cast<ts::ecmgscs::StreamTest*>(msg.get()));
-                break;
-            case ts::ecmgscs::Tags::stream_close_request:
-                ok = handleStreamCloseRequest(dynamic_cast<ts::ecmgscs::StreamCloseRequest*>(msg.get()));
-                break;
-            case ts::ecmgscs::Tags::CW_provision:
-                ok = handleCWProvision(dynamic_cast<ts::ecmgscs::CWProvision*>(msg.get()));
-                break;
-            case ts::ecmgscs::Tags::channel_status:
-            case ts::ecmgscs::Tags::stream_status:
-            case ts::ecmgscs::Tags::channel_error:
-            case ts::ecmgscs::Tags::stream_error:
-                // Silently ignore unsollicited status or error messages.
-                break;
-            default:
-                // Received an invalid message for ECMG.
-                ok = sendErrorResponse(msg.get(), ts::ecmgscs::Errors::inv_message);
-                break;
+
+    // Receive and process all available messages. Hang-up is detected by the receive operation.
+    if (bool(events & (ts::SocketEvents::READ | ts::SocketEvents::HANGUP))) {
+        std::list<ts::tlv::MessagePtr> msgs;
+        ok = _conn->receiveNonBlocking(msgs, _shared.logger());
+        for (auto it = msgs.begin(); it != msgs.end() && !_closed; ++it) {
+            ok = handleMessage(*it) && ok;
         }
     }
 
+    // Send pending responses.
+    if (ok && !_closed && bool(events & ts::SocketEvents::WRITE)) {
+        ok = _conn->flushOutput(_shared.report());
+    }
+
     // Error while receiving or sending messages, most likely a client disconnection.
-    _conn->disconnect(NULLREP);
-    _conn->close(_shared->report());
+    if (!ok || !updateEvents()) {
+        close();
+    }
+}
 
-    // Make sure to release the channel if not done by the clients.
-    if (_channel.has_value()) {
-        _shared->closeChannel(_channel.value());
-        _channel.reset();
+// Monitor write events only when some output is pending.
+bool ECMGClientSession::updateEvents()
+{
+    if (_closed) {
+        return true;
+    }
+    ts::SocketEvents events = ts::SocketEvents::READ;
+    if (_conn->hasPendingOutput()) {
+        events |= ts::SocketEvents::WRITE;
     }
+    return _shared.reactor().modify(_sock, events, _shared.report());
+}
 
-    _shared->report().verbose(u"%s: session completed", _peer);
+// Handle one incoming message.
+bool ECMGClientSession::handleMessage(const ts::tlv::MessagePtr& msg)
+{
+    switch (msg->tag()) {
+        case ts::ecmgscs::Tags::channel_setup:
+            return handleChannelSetup(dynamic_cast<ts::ecmgscs::ChannelSetup*>(msg.get()));
+        case ts::ecmgscs::Tags::channel_test:
+            return handleChannelTest(dynamic_cast<ts::ecmgscs::ChannelTest*>(msg.get()));
+        case ts::ecmgscs::Tags::channel_close:
+            return handleChannelClose(dynamic_cast<ts::ecmgscs::ChannelClose*>(msg.get()));
+        case ts::ecmgscs::Tags::stream_setup:
+            return handleStreamSetup(dynamic_cast<ts::ecmgscs::StreamSetup*>(msg.get()));
+        case ts::ecmgscs::Tags::stream_test:
+            return handleStreamTest(dynamic_cast<ts::ecmgscs::StreamTest*>(msg.get()));
+        case ts::ecmgscs::Tags::stream_close_request:
+            return handleStreamCloseRequest(dynamic_cast<ts::ecmgscs::StreamCloseRequest*>(msg.get()));
+        case ts::ecmgscs::Tags::CW_provision:
+            return handleCWProvision(msg);
+        case ts::ecmgscs::Tags::channel_status:
+        case ts::ecmgscs::Tags::stream_status:
+        case ts::ecmgscs::Tags::channel_error:
+        case ts::ecmgscs::Tags::stream_error:
+            // Silently ignore unsollicited status or error messages.
+            return true;
+        default:
+            // Received an invalid message for ECMG.
+            return sendErrorResponse(msg.get(), ts::ecmgscs::Errors::inv_message);
+    }
 }
 
 
@@ -406,7 +645,7 @@ void ECMGClientHandler::main()
 // Send an error related to the msg.
 //----------------------------------------------------------------------------
 
-bool ECMGClientHandler::sendErrorResponse(const ts::tlv::Message* msg, uint16_t errorStatus)
+bool ECMGClientSession::sendErrorResponse(const ts::tlv::Message* msg, uint16_t errorStatus)
 {
     const ts::tlv::ChannelMessage* channelMsg = nullptr;
     const ts::tlv::StreamMessage* streamMsg = nullptr;
@@ -438,20 +677,18 @@ bool ECMGClientHandler::sendErrorResponse(const ts::tlv::Message* msg, uint16_t
     // Send the response.
     return send(resp);
 }
-
-
 //----------------------------------------------------------------------------
 // Handle the various types of messages from the client.
 //----------------------------------------------------------------------------
 
-bool ECMGClientHandler::handleChannelSetup(ts::ecmgscs::ChannelSetup* msg)
+bool ECMGClientSession::handleChannelSetup(ts::ecmgscs::ChannelSetup* msg)
 {
     assert(msg != nullptr);
     if (_channel.has_value()) {
         // Channel already set in this session.
         return sendErrorResponse(msg, ts::ecmgscs::Errors::inv_channel_id);
     }
-    else if (!_shared->openChannel(msg->channel_id)) {
+    else if (!_shared.openChannel(msg->channel_id)) {
         // Channel id already in use.
         return sendErrorResponse(msg, ts::ecmgscs::Errors::channel_id_in_use);
     }
@@ -465,7 +702,7 @@ bool ECMGClientHandler::handleChannelSetup(ts::ecmgscs::ChannelSetup* msg)
 }
 
 
-bool ECMGClientHandler::handleChannelTest(ts::ecmgscs::ChannelTest* msg)
+bool ECMGClientSession::handleChannelTest(ts::ecmgscs::ChannelTest* msg)
 {
     assert(msg != nullptr);
     if (_channel != msg->channel_id) {
@@ -482,7 +719,7 @@ bool ECMGClientHandler::handleChannelTest(ts::ecmgscs::ChannelTest* msg)
 }
 
 
-bool ECMGClientHandler::handleChannelClose(ts::ecmgscs::ChannelClose* msg)
+bool ECMGClientSession::handleChannelClose(ts::ecmgscs::ChannelClose* msg)
 {
     assert(msg != nullptr);
     if (_channel != msg->channel_id) {
@@ -491,7 +728,7 @@ bool ECMGClientHandler::handleChannelClose(ts::ecmgscs::ChannelClose* msg)
     }
     else {
         // Channel ok, close everything, no response expected.
-        _shared->closeChannel(msg->channel_id);
+        _shared.closeChannel(msg->channel_id);
         _channel.reset();
         _streams.clear();
         return true;
@@ -499,7 +736,7 @@ bool ECMGClientHandler::handleChannelClose(ts::ecmgscs::ChannelClose* msg)
 }
 
 
-bool ECMGClientHandler::handleStreamSetup(ts::ecmgscs::StreamSetup* msg)
+bool ECMGClientSession::handleStreamSetup(ts::ecmgscs::StreamSetup* msg)
 {
     assert(msg != nullptr);
     if (_channel != msg->channel_id) {
@@ -522,7 +759,7 @@ bool ECMGClientHandler::handleStreamSetup(ts::ecmgscs::StreamSetup* msg)
 }
 
 
-bool ECMGClientHandler::handleStreamTest(ts::ecmgscs::StreamTest* msg)
+bool ECMGClientSession::handleStreamTest(ts::ecmgscs::StreamTest* msg)
 {
     assert(msg != nullptr);
     if (_channel != msg->channel_id) {
@@ -544,7 +781,7 @@ bool ECMGClientHandler::handleStreamTest(ts::ecmgscs::StreamTest* msg)
 }
 
 
-bool ECMGClientHandler::handleStreamCloseRequest(ts::ecmgscs::StreamCloseRequest* msg)
+bool ECMGClientSession::handleStreamCloseRequest(ts::ecmgscs::StreamCloseRequest* msg)
 {
     assert(msg != nullptr);
     if (_channel != msg->channel_id) {
@@ -566,94 +803,173 @@ bool ECMGClientHandler::handleStreamCloseRequest(ts::ecmgscs::StreamCloseRequest
 }
 
 
-bool ECMGClientHandler::handleCWProvision(ts::ecmgscs::CWProvision* msg)
+
+bool ECMGClientSession::handleCWProvision(const ts::tlv::MessagePtr& msg)
 {
-    assert(msg != nullptr);
-    if (_channel != msg->channel_id) {
+    const auto cwp = std::dynamic_pointer_cast<const ts::ecmgscs::CWProvision>(msg);
+    assert(cwp != nullptr);
+    if (_channel != cwp->channel_id) {
         // Not the right channel.
-        return sendErrorResponse(msg, ts::ecmgscs::Errors::inv_channel_id);
+        return sendErrorResponse(cwp.get(), ts::ecmgscs::Errors::inv_channel_id);
     }
-    else if (_streams.count(msg->stream_id) == 0) {
+    else if (_streams.count(cwp->stream_id) == 0) {
         // Stream not in use in this channel.
-        return sendErrorResponse(msg, ts::ecmgscs::Errors::inv_stream_id);
+        return sendErrorResponse(cwp.get(), ts::ecmgscs::Errors::inv_stream_id);
     }
-    else if (msg->CP_CW_combination.size() != _opt.channelStatus.CW_per_msg) {
+    else if (cwp->CP_CW_combination.size() != _opt.channelStatus.CW_per_msg) {
         // Not the right number of CW in the request.
-        return sendErrorResponse(msg, ts::ecmgscs::Errors::not_enough_CW);
+        return sendErrorResponse(cwp.get(), ts::ecmgscs::Errors::not_enough_CW);
     }
     else {
-        // Start to build the response.
-        ts::ecmgscs::ECMResponse resp(_opt.ecmgscs);
-        resp.channel_id = msg->channel_id;
-        resp.stream_id = msg->stream_id;
-        resp.CP_number = msg->CP_number;
-
-        // Check if 16-bit crypto-period numbers wrap over 0xFFFF.
-        const uint16_t cpMax = msg->CP_number + _opt.channelStatus.lead_CW;
-        const bool cpWrap = cpMax < msg->CP_number;
-
-        // Add all CW's in the ECM (in the clear, yeah, but that's a fake/test ECMG).
-        ts::duck::ClearECM ecm(_protocol);
-        for (auto it = msg->CP_CW_combination.begin(); it != msg->CP_CW_combination.end(); ++it) {
-            if ((!cpWrap && (it->CP < msg->CP_number || it->CP > cpMax)) || (cpWrap && it->CP > cpMax && it->CP < msg->CP_number)) {
-                // Incorrect CP/CW combination.
-                return sendErrorResponse(msg, ts::ecmgscs::Errors::not_enough_CW);
-            }
-            if ((it->CP & 0x01) == 0) {
-                ecm.cw_even = it->CW;
-            }
-            else {
-                ecm.cw_odd = it->CW;
-            }
-            // In debug mode, display if CW has reduced entropy.
-            _shared->report().debug(u"incoming CW entropy: %s", it->CW.size() == ts::DVBCSA2::KEY_SIZE && ts::DVBCSA2::IsReducedCW(it->CW.data()) ? u"reduced" : u"not reduced");
+        // The ECM is built by a worker thread, the response is sent later.
+        std::shared_ptr<ECMRequest> req(new ECMRequest);
+        req->session = _self;
+        req->msg = cwp;
+        req->received = cn::steady_clock::now();
+        _shared.streamRequests(cwp->channel_id, cwp->stream_id).forceEnqueue(req);
+        return true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Send an ECM response which was computed by a worker thread.
+//----------------------------------------------------------------------------
+
+void ECMGClientSession::sendECMResponse(const ts::tlv::MessagePtr& msg)
+{
+    // Drop the response if the stream was closed in the meantime.
+    const ts::tlv::StreamMessage* resp = dynamic_cast<const ts::tlv::StreamMessage*>(msg.get());
+    if (!_closed && resp != nullptr && _channel == resp->channel_id && _streams.count(resp->stream_id) != 0) {
+        if (!send(resp) || !updateEvents()) {
+            close();
         }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// ECM generation thread.
+//----------------------------------------------------------------------------
+
+ECMGWorker::ECMGWorker(const ECMGOptions& opt, ECMGSharedData& shared, size_t index) :
+    _opt(opt),
+    _shared(shared),
+    _requests(shared.workerRequests(index))
+{
+    ts::ThreadAttributes attr;
+    attr.setStackSize(WORKER_STACK_SIZE);
+    setAttributes(attr);
+}
 
-        // Add optional access criteria in ECM.
-        if (msg->has_access_criteria) {
-            ecm.access_criteria = msg->access_criteria;
+ECMGWorker::~ECMGWorker()
+{
+    // Wait for completion of the thread.
+    waitForTermination();
+}
+
+void ECMGWorker::main()
+{
+    // Loop on ECM requests. A null request means terminate.
+    for (;;) {
+        std::shared_ptr<ECMRequest> req;
+        _requests.dequeue(req);
+        if (req == nullptr) {
+            break;
         }
 
-        // Serialize the ECM section payload.
-        ts::ByteBlockPtr ecmBin(new ts::ByteBlock);
-        ts::tlv::Serializer serial(ecmBin);
-        ecm.serialize(serial);
-
-        // Compute the table id for the ECM, 0x80 or 0x81. There are two incompatible possibilities.
-        // First method is to copy the parity of the crypto period number. Second method is to
-        // alternate between the two, request after request in the stream. There is no requirement
-        // that the table id has the same parity as the CP. However, it is safe to do it just in
-        // case some CAS relies on it. On the other hand, if the SCS sends non-consecutive CP
-        // numbers, it is possible that two adjacent CP have the same parity. Anyway, since there
-        // is no perfect solution, we use the first one since it is simpler.
-        const ts::TID tid = ts::TID(ts::TID_ECM_80 | (msg->CP_number & 0x01));
-
-        // Build the ECM section.
-        ts::SectionPtr ecmSection(new ts::Section(tid, true, ecmBin->data(), ecmBin->size()));
-
-        // Format ECM for the response message.
-        if (_opt.channelStatus.section_TSpkt_flag) {
-            // Send ECM as TS packets, packetize the section.
-            ts::TSPacketVector ecmPackets;
-            ts::OneShotPacketizer zer(_opt.duck);
-            zer.addSection(ecmSection);
-            zer.getPackets(ecmPackets);
-            if (!ecmPackets.empty()) {
-                resp.ECM_datagram.copy(ecmPackets[0].b, ecmPackets.size() * ts::PKT_SIZE);
+        const ts::tlv::MessagePtr resp(buildResponse(*req->msg));
+
+        // Emulate the computation time of a real ECMG without blocking any thread:
+        // the response is sent by the reactor when the computation time has elapsed.
+        const auto delay = cn::duration_cast<cn::microseconds>(_opt.ecmCompTime - (cn::steady_clock::now() - req->received));
+        const std::weak_ptr<ECMGClientSession> session(req->session);
+        _shared.reactor().postAfter(std::max(delay, cn::microseconds::zero()), [session, resp]() {
+            const ECMGClientSessionPtr s(session.lock());
+            if (s != nullptr) {
+                s->sendECMResponse(resp);
             }
+        });
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build the response to a CW_provision.
+//----------------------------------------------------------------------------
+
+ts::tlv::MessagePtr ECMGWorker::buildResponse(const ts::ecmgscs::CWProvision& msg)
+{
+    // Start to build the response.
+    std::shared_ptr<ts::ecmgscs::ECMResponse> resp(new ts::ecmgscs::ECMResponse(_opt.ecmgscs));
+    resp->channel_id = msg.channel_id;
+    resp->stream_id = msg.stream_id;
+    resp->CP_number = msg.CP_number;
+
+    // Check if 16-bit crypto-period numbers wrap over 0xFFFF.
+    const uint16_t cpMax = msg.CP_number + _opt.channelStatus.lead_CW;
+    const bool cpWrap = cpMax < msg.CP_number;
+
+    // Add all CW's in the ECM (in the clear, yeah, but that's a fake/test ECMG).
+    ts::duck::ClearECM ecm(_protocol);
+    for (auto it = msg.CP_CW_combination.begin(); it != msg.CP_CW_combination.end(); ++it) {
+        if ((!cpWrap && (it->CP < msg.CP_number || it->CP > cpMax)) || (cpWrap && it->CP > cpMax && it->CP < msg.CP_number)) {
+            // Incorrect CP/CW combination.
+            std::shared_ptr<ts::ecmgscs::StreamError> err(new ts::ecmgscs::StreamError(_opt.ecmgscs));
+            err->channel_id = msg.channel_id;
+            err->stream_id = msg.stream_id;
+            err->error_status.push_back(ts::ecmgscs::Errors::not_enough_CW);
+            return err;
+        }
+        if ((it->CP & 0x01) == 0) {
+            ecm.cw_even = it->CW;
         }
         else {
-            // Send ECM as a section.
-            resp.ECM_datagram.copy(ecmSection->content(), ecmSection->size());
+            ecm.cw_odd = it->CW;
         }
+        // In debug mode, display if CW has reduced entropy.
+        _shared.report().debug(u"incoming CW entropy: %s", it->CW.size() == ts::DVBCSA2::KEY_SIZE && ts::DVBCSA2::IsReducedCW(it->CW.data()) ? u"reduced" : u"not reduced");
+    }
 
-        // Emulate the computation time of a real ECMG.
-        if (_opt.ecmCompTime > cn::milliseconds::zero()) {
-            std::this_thread::sleep_for(_opt.ecmCompTime);
-        }
+    // Add optional access criteria in ECM.
+    if (msg.has_access_criteria) {
+        ecm.access_criteria = msg.access_criteria;
+    }
 
-        return send(&resp);
+    // Serialize the ECM section payload.
+    ts::ByteBlockPtr ecmBin(new ts::ByteBlock);
+    ts::tlv::Serializer serial(ecmBin);
+    ecm.serialize(serial);
+
+    // Compute the table id for the ECM, 0x80 or 0x81. There are two incompatible possibilities.
+    // First method is to copy the parity of the crypto period number. Second method is to
+    // alternate between the two, request after request in the stream. There is no requirement
+    // that the table id has the same parity as the CP. However, it is safe to do it just in
+    // case some CAS relies on it. On the other hand, if the SCS sends non-consecutive CP
+    // numbers, it is possible that two adjacent CP have the same parity. Anyway, since there
+    // is no perfect solution, we use the first one since it is simpler.
+    const ts::TID tid = ts::TID(ts::TID_ECM_80 | (msg.CP_number & 0x01));
+
+    // Build the ECM section.
+    ts::SectionPtr ecmSection(new ts::Section(tid, true, ecmBin->data(), ecmBin->size()));
+
+    // Format ECM for the response message.
+    if (_opt.channelStatus.section_TSpkt_flag) {
+        // Send ECM as TS packets, packetize the section.
+        ts::TSPacketVector ecmPackets;
+        ts::OneShotPacketizer zer(_opt.duck);
+        zer.addSection(ecmSection);
+        zer.getPackets(ecmPackets);
+        if (!ecmPackets.empty()) {
+            resp->ECM_datagram.copy(ecmPackets[0].b, ecmPackets.size() * ts::PKT_SIZE);
+        }
     }
+    else {
+        // Send ECM as a section.
+        resp->ECM_datagram.copy(ecmSection->content(), ecmSection->size());
+    }
+
+    return resp;
 }
 
 
@@ -685,32 +1001,31 @@ int MainCode(int argc, char *argv[])
     // the client disconnects, creating a SIGPIPE signal.
     ts::IgnorePipeSignal();
 
-    // Manage incoming client connections.
-    for (;;) {
+    // All client connections are managed by one reactor in the main thread.
+    ts::SocketReactor& reactor(shared.reactor());
+    ECMGServer ecmg(opt, shared, server);
+    if (!reactor.open(shared.report()) || !ecmg.start()) {
+        return EXIT_FAILURE;
+    }
 
-        // Accept one incoming connection.
-        ts::IPSocketAddress clientAddress;
-        ECMGConnectionPtr conn(new ECMGConnection(opt.ecmgscs, true, 3));
-        ts::CheckNonNull(conn.get());
-        if (!server.accept(*conn, clientAddress, shared.report())) {
-            break;
-        }
+    // Start the ECM generation threads.
+    std::vector<std::unique_ptr<ECMGWorker>> workers;
+    for (size_t i = 0; i < shared.workerCount(); ++i) {
+        workers.push_back(std::make_unique<ECMGWorker>(opt, shared, i));
+        workers.back()->start();
+    }
 
-        // Process the connection.
-        if (opt.once) {
-            // If --once is specified, run once in the context of the main thread and exit.
-            ECMGClientHandler client(opt, conn, &shared, false);
-            client.main();
-            break;
-        }
-        else {
-            // Otherwise, create a thread and forget about it.
-            // The thread will deallocate itself automatically when it completes.
-            ECMGClientHandler* client = new ECMGClientHandler(opt, conn, &shared, true);
-            ts::CheckNonNull(client);
-            client->start();
-        }
+    // Manage incoming client connections and client messages.
+    const bool ok = reactor.run(shared.report());
+
+    // Terminate the worker threads (one null request per thread) before closing the reactor.
+    for (size_t i = 0; i < workers.size(); ++i) {
+        shared.workerRequests(i).forceEnqueue(static_cast<ECMRequest*>(nullptr));
     }
+    workers.clear();
 
-    return EXIT_SUCCESS;
+    ecmg.closeAll();
+    reactor.close(shared.report());
+    server.close(shared.report());
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -223,6 +223,12 @@ namespace {
 
         // Comparison, for use in containers.
         bool operator<(const StreamId& other) const;
+
+        // Check if an IP packet belongs to this stream.
+        bool contains(const ts::VLANIdStack& pkt_vlans, const ts::IPPacket& ip) const
+        {
+            return protocol == ip.protocol() && source == ip.source() && destination == ip.destination() && vlans == pkt_vlans;
+        }
     };
 }
 
@@ -335,6 +341,8 @@ namespace {
         DisplayInterval _interval;                      // Display stats by time intervals.
         StatBlock       _global_stats {};               // Global stats
         std::map<StreamId,StatBlock> _streams_stats {}; // Stats per data stream.
+        StreamId        _last_stream {};                // Stream of the last packet.
+        StatBlock*      _last_stats = nullptr;          // Stats of the last stream, consecutive packets often belong to the same stream.
 
         // Display summary of content.
         void displaySummary(std::ostream& out, const StatBlock& stats);
@@ -364,7 +372,11 @@ bool FileAnalysis::analyze(std::ostream& out)
     while (_file.readIP(ip, vlans, timestamp, _opt)) {
         _global_stats.addPacket(ip, timestamp);
         if (_opt.list_streams) {
-            _streams_stats[{vlans, ip.source(), ip.destination(), ip.protocol()}].addPacket(ip, timestamp);
+            if (_last_stats == nullptr || !_last_stream.contains(vlans, ip)) {
+                _last_stream = {vlans, ip.source(), ip.destination(), ip.protocol()};
+                _last_stats = &_streams_stats[_last_stream];
+            }
+            _last_stats->addPacket(ip, timestamp);
         }
         if (_opt.print_intervals) {
             _interval.addPacket(out, _file, ip, timestamp);
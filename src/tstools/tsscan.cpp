@@ -19,6 +19,7 @@
 #include "tsHFBand.h"
 #include "tsTSScanner.h"
 #include "tsChannelFile.h"
+#include "tsMultiTunerScanner.h"
 #include "tsNIT.h"
 #include "tsTransportStreamId.h"
 #include "tsDescriptorList.h"
@@ -61,6 +62,8 @@ namespace {
         bool              update_channel_file = false;
         bool              default_channel_file = false;
         std::vector<ts::DeliverySystem> delivery_systems {};
+        ts::UStringVector device_names {};
+        ts::DuckContext::SavedArgs duck_args {};
     };
 }
 
@@ -89,6 +92,17 @@ ScanOptions::ScanOptions(int argc, char *argv[]) :
          u"This is typically used to scan terrestrial networks using DVB-T and DVT-T2. "
          u"Be aware that the scan time is multiplied by the number of specified systems on channels without signal.");
 
+    // The following option replaces --device-name as defined in TunerArgs.
+    // We want to allow more than one value for it.
+    option(u"device-name", 'd', STRING, 0, UNLIMITED_COUNT);
+    help(u"device-name", u"name",
+         u"Specify the tuner device name. "
+         u"See the dvb input plugin for the syntax of the name on each operating system.\n"
+         u"The option can be specified several times to scan with several tuners in parallel. "
+         u"In that case, the channels or transport streams to scan are dispatched on all tuners. "
+         u"All tuners shall be able to receive the same network. "
+         u"A tuner emulator XML file may also be specified several times, for testing purpose.");
+
     option(u"nit-scan", 'n');
     help(u"nit-scan",
          u"Tuning parameters for a reference transport stream must be present (frequency or channel reference). "
@@ -217,6 +231,12 @@ ScanOptions::ScanOptions(int argc, char *argv[]) :
         error(u"specify at most one --delivery-system with --nit-scan");
     }
 
+    // Same thing for --device-name. Without --device-name, use one tuner, as specified in tuner_args.
+    getValues(device_names, u"device-name");
+    if (device_names.empty()) {
+        device_names.push_back(tuner_args.device_name);
+    }
+
     // Type of HF band to use.
     hfband = vhf_scan ? duck.vhfBand() : duck.uhfBand();
 
@@ -257,6 +277,9 @@ ScanOptions::ScanOptions(int argc, char *argv[]) :
         channel_file = ts::ChannelFile::DefaultFileName();
     }
 
+    // The DuckContext options are reapplied in the context of each tuner.
+    duck.saveArgs(duck_args);
+
     exitOnError();
 }
 
@@ -271,7 +294,7 @@ class OffsetScanner
     TS_NOBUILD_NOCOPY(OffsetScanner);
 public:
     // Constructor: Perform scanning. Keep signal tuned on best offset.
-    OffsetScanner(ScanOptions& opt, ts::Tuner& tuner, uint32_t channel);
+    OffsetScanner(ScanOptions& opt, ts::Report& report, ts::Tuner& tuner, uint32_t channel);
 
     // Check if signal found and which offset is the best one.
     bool signalFound() const { return _signal_found; }
@@ -281,6 +304,7 @@ public:
 
 private:
     ScanOptions&       _opt;
+    ts::Report&        _report;
     ts::Tuner&         _tuner;
     const uint32_t     _channel;
     bool               _signal_found = false;
@@ -310,8 +334,9 @@ private:
 // Perform scanning. Keep signal tuned on best offset
 //----------------------------------------------------------------------------
 
-OffsetScanner::OffsetScanner(ScanOptions& opt, ts::Tuner& tuner, uint32_t channel) :
+OffsetScanner::OffsetScanner(ScanOptions& opt, ts::Report& report, ts::Tuner& tuner, uint32_t channel) :
     _opt(opt),
+    _report(report),
     _tuner(tuner),
     _channel(channel)
 {
@@ -339,10 +364,10 @@ void OffsetScanner::scanAll(ts::DeliverySystem sys)
     if (sys != ts::DS_UNDEFINED) {
         desc.format(u" (%s)", ts::DeliverySystemEnum().name(sys));
     }
-    if (!_opt.hfband->isValidChannel(_channel, _opt)) {
+    if (!_opt.hfband->isValidChannel(_channel, _report)) {
         return;
     }
-    _opt.verbose(u"scanning channel %'d, %'d Hz%s", _channel, _opt.hfband->frequency(_channel), desc);
+    _report.verbose(u"scanning channel %'d, %'d Hz%s", _channel, _opt.hfband->frequency(_channel), desc);
 
     if (_opt.no_offset) {
         // Only try the central frequency
@@ -401,7 +426,7 @@ void OffsetScanner::buildTuningParameters(ts::ModulationArgs& params, int32_t of
     // Other tuning parameters from command line (or default values).
     params = _opt.tuner_args;
     if (sys == ts::DS_UNDEFINED) {
-        params.resolveDeliverySystem(_tuner.deliverySystems(), _opt);
+        params.resolveDeliverySystem(_tuner.deliverySystems(), _report);
     }
     else {
         params.delivery_system = sys;
@@ -428,7 +453,7 @@ bool OffsetScanner::tune(int32_t offset, ts::ModulationArgs& params, ts::Deliver
 
 bool OffsetScanner::tryOffset(int32_t offset, ts::DeliverySystem sys)
 {
-    _opt.debug(u"trying offset %d", offset);
+    _report.debug(u"trying offset %d", offset);
 
     // Tune to transponder and start signal acquisition.
     // Signal locking timeout is applied in start().
@@ -445,7 +470,7 @@ bool OffsetScanner::tryOffset(int32_t offset, ts::DeliverySystem sys)
     // If we don't scan offsets, there is no need to consider signal strength, just use the central offset.
     if (ok && !_opt.no_offset) {
 
-        _opt.verbose(u"%s, %s", _opt.hfband->description(_channel, offset), state);
+        _report.verbose(u"%s, %s", _opt.hfband->description(_channel, offset), state);
 
         if (state.signal_strength.has_value()) {
             const int64_t strength = state.signal_strength.value().value;
@@ -484,10 +509,10 @@ bool OffsetScanner::tryOffset(int32_t offset, ts::DeliverySystem sys)
 
 
 //----------------------------------------------------------------------------
-// Scanning context.
+// Scanning context: dispatch the channels or transport streams on all tuners.
 //----------------------------------------------------------------------------
 
-class ScanContext
+class ScanContext: public ts::MultiTunerScanner
 {
     TS_NOBUILD_NOCOPY(ScanContext);
 public:
@@ -497,43 +522,84 @@ public:
     // tsscan main code.
     void main();
 
+protected:
+    // Implementation of MultiTunerScanner.
+    virtual void scanJob(Job& job, ts::Tuner& tuner, ts::DuckContext& duck, ts::Report& report) override;
+    virtual void reportJob(Job& job) override;
+
 private:
-    ScanOptions&    _opt;
-    ts::Tuner       _tuner;
-    ts::ServiceList _services;
-    ts::ChannelFile _channels;
+    ScanOptions& _opt;
 
-    // Analyze a TS and generate relevant info.
-    void scanTS(std::ostream& strm, const ts::UString& margin, ts::ModulationArgs& tparams);
+    // Build the list of jobs for UHF/VHF-band scanning.
+    void hfBandJobs();
 
-    // UHF/VHF-band scanning
-    void hfBandScan();
+    // Build the list of jobs for NIT-based scanning. Return false if the tuner cannot be used.
+    bool nitJobs();
 
-    // NIT-based scanning
-    void nitScan();
+    // Analyze a TS and generate relevant info, in a scanning thread.
+    void scanTS(std::ostream& strm, const ts::UString& margin, ts::ModulationArgs& tparams, Job& job, ts::Tuner& tuner, ts::DuckContext& duck);
 };
 
 // Constructor.
 ScanContext::ScanContext(ScanOptions& opt) :
-    _opt(opt),
-    _tuner(_opt.duck),
-    _services(),
-    _channels()
+    MultiTunerScanner(opt, opt.tuner_args, opt.device_names, opt.duck_args),
+    _opt(opt)
 {
 }
 
 
+//----------------------------------------------------------------------------
+// Execute one job in a scanning thread.
+//----------------------------------------------------------------------------
+
+void ScanContext::scanJob(Job& job, ts::Tuner& tuner, ts::DuckContext& duck, ts::Report& report)
+{
+    std::ostringstream strm;
+
+    if (_opt.nit_scan) {
+        // Tune to the transponder which is described in the NIT.
+        report.debug(u"* tuning to " + job.params.toPluginOptions(true));
+        if (tuner.tune(job.params)) {
+            // Report channel characteristics
+            ts::SignalState state;
+            tuner.getSignalState(state);
+            strm << "* Frequency: " << job.params.shortDescription(duck) << ", " << state.toString() << std::endl;
+            // Analyze PSI/SI if required
+            scanTS(strm, u"  ", job.params, job, tuner, duck);
+        }
+    }
+    else {
+        // Scan all offsets surrounding the channel.
+        OffsetScanner offscan(_opt, report, tuner, job.channel);
+        if (offscan.signalFound()) {
+
+            // A channel was found, report its characteristics.
+            ts::SignalState state;
+            tuner.getSignalState(state);
+            strm << "* " << _opt.hfband->description(job.channel, offscan.bestOffset()) << ", " << state.toString() << std::endl;
+
+            // Analyze PSI/SI if required.
+            ts::ModulationArgs tparams;
+            offscan.getTunerParameters(tparams);
+            scanTS(strm, u"  ", tparams, job, tuner, duck);
+        }
+    }
+
+    job.text = strm.str();
+}
+
+
 //----------------------------------------------------------------------------
 // Analyze a TS and generate relevant info.
 //----------------------------------------------------------------------------
 
-void ScanContext::scanTS(std::ostream& strm, const ts::UString& margin, ts::ModulationArgs& tparams)
+void ScanContext::scanTS(std::ostream& strm, const ts::UString& margin, ts::ModulationArgs& tparams, Job& job, ts::Tuner& tuner, ts::DuckContext& duck)
 {
     const bool get_services = _opt.list_services || _opt.global_services;
 
     // Collect info from the TS.
     // Use "PAT only" when we do not need the services or channels file.
-    ts::TSScanner info(_opt.duck, _tuner, _opt.psi_timeout, !get_services && _opt.channel_file.empty());
+    ts::TSScanner info(duck, tuner, _opt.psi_timeout, !get_services && _opt.channel_file.empty());
 
     // Get tuning parameters again, as TSScanner waits for a lock.
     // Also keep the original frequency and polarity since satellite tuners can only report the intermediate frequency.
@@ -556,24 +622,17 @@ void ScanContext::scanTS(std::ostream& strm, const ts::UString& margin, ts::Modu
     info.getNIT(nit);
 
     // Get network and TS Id.
-    uint16_t ts_id = 0;
-    uint16_t net_id = 0;
+    job.ts_found = true;
+    job.tune = tparams;
     if (pat != nullptr) {
-        ts_id = pat->ts_id;
-        strm << margin << ts::UString::Format(u"Transport stream id: %d, 0x%X", ts_id, ts_id) << std::endl;
+        job.ts_id = pat->ts_id;
+        strm << margin << ts::UString::Format(u"Transport stream id: %d, 0x%X", job.ts_id, job.ts_id) << std::endl;
     }
     if (nit != nullptr) {
-        net_id = nit->network_id;
+        job.net_id = nit->network_id;
     }
-
-    // Reset TS description in channels file.
-    ts::ChannelFile::TransportStreamPtr ts_info;
-    if (!_opt.channel_file.empty()) {
-        ts::ChannelFile::NetworkPtr net_info(_channels.networkGetOrCreate(net_id, ts::TunerTypeOf(tparams.delivery_system.value_or(ts::DS_UNDEFINED))));
-        ts_info = net_info->tsGetOrCreate(ts_id);
-        ts_info->clear(); // reset all services in TS.
-        ts_info->onid = sdt == nullptr ? 0 : sdt->onetw_id;
-        ts_info->tune = tparams;
+    if (sdt != nullptr) {
+        job.onid = sdt->onetw_id;
     }
 
     // Display modulation parameters
@@ -582,13 +641,12 @@ void ScanContext::scanTS(std::ostream& strm, const ts::UString& margin, ts::Modu
     }
 
     // Display or collect services
-    if (get_services || ts_info != nullptr) {
+    if (get_services || !_opt.channel_file.empty()) {
         ts::ServiceList srvlist;
         if (info.getServices(srvlist)) {
-            if (ts_info != nullptr) {
-                // Add all services in the channels info.
-                ts_info->addServices(srvlist);
-            }
+            // Keep the services for the channels file and the global service list.
+            job.services_found = true;
+            job.services = srvlist;
             if (_opt.list_services) {
                 // Display services for this TS
                 srvlist.sort(ts::Service::Sort1);
@@ -596,86 +654,77 @@ void ScanContext::scanTS(std::ostream& strm, const ts::UString& margin, ts::Modu
                 ts::Service::Display(strm, margin, srvlist);
                 strm << std::endl;
             }
-            if (_opt.global_services) {
-                // Add collected services in global service list
-                _services.insert(_services.end(), srvlist.begin(), srvlist.end());
-            }
         }
     }
 }
 
 
 //----------------------------------------------------------------------------
-// UHF/VHF-band scanning
+// UHF/VHF-band scanning: one job per channel.
 //----------------------------------------------------------------------------
 
-void ScanContext::hfBandScan()
+void ScanContext::hfBandJobs()
 {
-    // Loop on all selected UHF channels
     for (uint32_t chan = _opt.first_channel; chan <= _opt.last_channel; ++chan) {
-
-        // Scan all offsets surrounding the channel.
-        OffsetScanner offscan(_opt, _tuner, chan);
-        if (offscan.signalFound()) {
-
-            // A channel was found, report its characteristics.
-            ts::SignalState state;
-            _tuner.getSignalState(state);
-            std::cout << "* " << _opt.hfband->description(chan, offscan.bestOffset()) << ", " << state.toString() << std::endl;
-
-            // Analyze PSI/SI if required.
-            ts::ModulationArgs tparams;
-            offscan.getTunerParameters(tparams);
-            scanTS(std::cout, u"  ", tparams);
-        }
+        Job job;
+        job.channel = chan;
+        addJob(job);
     }
 }
 
 
 //----------------------------------------------------------------------------
-// NIT-based scanning
+// NIT-based scanning: one job per transport stream in the NIT.
 //----------------------------------------------------------------------------
 
-void ScanContext::nitScan()
+bool ScanContext::nitJobs()
 {
-    // Tune to the reference transponder.
-    if (!_tuner.tune(_opt.tuner_args)) {
-        return;
+    // Collect info on reference transponder, using the first tuner, before starting the threads.
+    if (!openTuner(0)) {
+        return false;
     }
-
-    // Collect info on reference transponder.
-    ts::TSScanner info(_opt.duck, _tuner, _opt.psi_timeout, false);
-
-    // Get the collected NIT
     std::shared_ptr<ts::NIT> nit;
-    info.getNIT(nit);
+    bool tuned = tuner(0).tune(_opt.tuner_args);
+    if (tuned) {
+        ts::TSScanner info(duck(0), tuner(0), _opt.psi_timeout, false);
+        info.getNIT(nit);
+    }
+    tuner(0).close();
+    if (!tuned) {
+        return true;
+    }
     if (nit == nullptr) {
         _opt.error(u"cannot scan network, no NIT found on specified transponder");
-        return;
+        return true;
     }
 
     // Process each TS descriptor list in the NIT.
     for (const auto& it : nit->transports) {
         const ts::TransportStreamId& tsid(it.first);
         const ts::DescriptorList& dlist(it.second.descs);
-        ts::ModulationArgs params;
-        if (params.fromDeliveryDescriptors(_opt.duck, dlist, tsid.transport_stream_id, _opt.tuner_args.delivery_system.value_or(ts::DS_UNDEFINED))) {
+        Job job;
+        if (job.params.fromDeliveryDescriptors(_opt.duck, dlist, tsid.transport_stream_id, _opt.tuner_args.delivery_system.value_or(ts::DS_UNDEFINED))) {
             // Got delivery descriptors, this is the description of one transponder.
             // Copy the local reception parameters (LNB, etc.) from the command line options
             // (we use the same reception equipment).
-            params.copyLocalReceptionParameters(_opt.tuner_args);
-            // Tune to this transponder.
-            _opt.debug(u"* tuning to " + params.toPluginOptions(true));
-            if (_tuner.tune(params)) {
-                // Report channel characteristics
-                ts::SignalState state;
-                _tuner.getSignalState(state);
-                std::cout << "* Frequency: " << params.shortDescription(_opt.duck) << ", " << state.toString() << std::endl;
-                // Analyze PSI/SI if required
-                scanTS(std::cout, u"  ", params);
-            }
+            job.params.copyLocalReceptionParameters(_opt.tuner_args);
+            addJob(job);
         }
     }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Report the result of a job, in the main thread.
+//----------------------------------------------------------------------------
+
+void ScanContext::reportJob(Job& job)
+{
+    std::cout << job.text << std::flush;
+
+    // Merge the channels and services.
+    MultiTunerScanner::reportJob(job);
 }
 
 
@@ -685,39 +734,40 @@ void ScanContext::nitScan()
 
 void ScanContext::main()
 {
-    // Initialize tuner.
-    _tuner.setSignalTimeoutSilent(true);
-    if (!_opt.tuner_args.configureTuner(_tuner)) {
-        return;
-    }
-
     // Pre-load the existing channel file.
-    if (_opt.update_channel_file && !_opt.channel_file.empty() && fs::exists(_opt.channel_file) && !_channels.load(_opt.channel_file, _opt)) {
+    if (_opt.update_channel_file && !_opt.channel_file.empty() && fs::exists(_opt.channel_file) && !channels().load(_opt.channel_file, _opt)) {
         return;
     }
 
-    // Main processing depends on scanning method.
+    // Build the list of jobs, depending on scanning method.
     if (_opt.uhf_scan || _opt.vhf_scan) {
-        hfBandScan();
+        hfBandJobs();
     }
     else if (_opt.nit_scan) {
-        nitScan();
+        if (!nitJobs()) {
+            return;
+        }
     }
     else {
         _opt.fatal(u"inconsistent options, internal error");
     }
 
+    // Scan all channels or transport streams.
+    if (!run()) {
+        return;
+    }
+
     // Report global list of services if required
     if (_opt.global_services) {
-        _services.sort(ts::Service::Sort1);
+        services().sort(ts::Service::Sort1);
         std::cout << std::endl;
-        ts::Service::Display(std::cout, u"", _services);
+        ts::Service::Display(std::cout, u"", services());
     }
 
     // Save channel file. Create intermediate directories when it is the default file.
     if (!_opt.channel_file.empty()) {
         _opt.verbose(u"saving %s", _opt.channel_file);
-        _channels.save(_opt.channel_file, _opt.default_channel_file, _opt);
+        channels().save(_opt.channel_file, _opt.default_channel_file, _opt);
     }
 }
 
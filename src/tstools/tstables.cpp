@@ -18,6 +18,9 @@
 #include "tsPagerArgs.h"
 TS_MAIN(MainCode);
 
+// Number of packets to read at a time with demux threads.
+#define READ_PACKETS 1024
+
 
 //----------------------------------------------------------------------------
 //  Command line options
@@ -36,6 +39,7 @@ namespace {
         ts::PagerArgs      pager {true, true}; // Output paging options.
         fs::path           infile {};          // Input file name.
         ts::TSPacketFormat format = ts::TSPacketFormat::AUTODETECT;
+        size_t             threads = 1;        // Number of demux threads.
     };
 }
 
@@ -55,6 +59,16 @@ Options::Options(int argc, char *argv[]) :
     option(u"", 0, FILENAME, 0, 1);
     help(u"", u"Input transport stream file (standard input if omitted).");
 
+    option(u"threads", 0, POSITIVE);
+    help(u"threads", u"count",
+         u"Demux the sections using the specified number of threads. "
+         u"The PID's to filter are distributed over the threads which reassemble the sections in parallel. "
+         u"The tables and sections are then filtered and logged in their original order. "
+         u"The output is identical to the sequential processing. "
+         u"This is useful with large capture files. "
+         u"The threads are not used with --pack-and-flush and --fill-eit. "
+         u"By default, the sections are demuxed in one single thread.");
+
     analyze(argc, argv);
 
     duck.loadArgs(*this);
@@ -64,6 +78,8 @@ Options::Options(int argc, char *argv[]) :
 
     getPathValue(infile, u"");
     format = ts::LoadTSPacketFormatInputOption(*this);
+    getIntValue(threads, u"threads", 1);
+    logger.setDemuxThreads(threads);
 
     exitOnError();
 }
@@ -92,10 +108,14 @@ int MainCode(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
-    // Read all packets in the file and pass them to the logger
-    ts::TSPacket pkt;
-    while (!opt.logger.completed() && file.readPackets(&pkt, nullptr, 1, opt) > 0) {
-        opt.logger.feedPacket(pkt);
+    // Read all packets in the file and pass them to the logger.
+    // With demux threads, read large batches of packets (but not on a live stream in sequential mode).
+    ts::TSPacketVector pkts(opt.threads > 1 ? READ_PACKETS : 1);
+    size_t count = 0;
+    while (!opt.logger.completed() && (count = file.readPackets(pkts.data(), nullptr, pkts.size(), opt)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            opt.logger.feedPacket(pkts[i]);
+        }
     }
     file.close(opt);
     opt.logger.close();
@@ -51,6 +51,7 @@ namespace {
         uint16_t              first_ecm_id = 0;
         size_t                cw_size = 0;
         size_t                max_ecm = 0;
+        bool                  load = false;
         cn::seconds           max_seconds {};
         int                   log_protocol = 0;
         int                   log_data = 0;
@@ -111,6 +112,12 @@ CmdOptions::CmdOptions(int argc, char *argv[]) :
          u"Subsequent streams use sequential values. "
          u"The default is 0.");
 
+    option(u"load", 'l');
+    help(u"load",
+         u"Load test mode. Send the next CW_provision of each stream as soon as the ECM_response "
+         u"for the previous one is received, regardless of the crypto-period duration. "
+         u"This is used to measure the maximum ECM throughput of the ECMG.");
+
     option(u"log-data", 0, ts::Severity::Enums(), 0, 1, true);
     help(u"log-data", u"level",
          u"Same as --log-protocol but applies to CW_provision and ECM_response messages only. "
@@ -166,6 +173,7 @@ CmdOptions::CmdOptions(int argc, char *argv[]) :
     getChronoValue(cp_duration, u"cp-duration", cn::seconds(10));
     getChronoValue(stat_interval, u"statistics-interval", cn::seconds(10));
     getIntValue(max_ecm, u"max-ecm");
+    load = present(u"load");
     getChronoValue(max_seconds, u"max-seconds");
     log_protocol = present(u"log-protocol") ? intValue<int>(u"log-protocol", ts::Severity::Info) : ts::Severity::Debug;
     log_data = present(u"log-data") ? intValue<int>(u"log-data", ts::Severity::Info) : log_protocol;
@@ -321,7 +329,7 @@ namespace {
 
         // Provide statistics.
         void oneRequest() { _request_count.fetch_add(1); }
-        void oneResponse(const cn::milliseconds& time);
+        void oneResponse(const cn::microseconds& time);
 
         // Terminate the thread.
         void terminate();
@@ -333,17 +341,32 @@ namespace {
     private:
         using ResponseStat = ts::SingleDataStatistics<cn::milliseconds>;
 
-        const CmdOptions&          _opt;
-        ts::Report&                _report;
-        std::atomic<std::uint32_t> _request_count {0}; // same as std::atomic_uint32_t, missing in old GCC
-        volatile bool              _terminate = false;
-        std::mutex                 _mutex {};          // Exclusive access to subsequent fields.
-        std::condition_variable    _condition {};
-        ResponseStat               _instant_response {};
-        ResponseStat               _global_response {};
+        // The histogram of response times has a fixed size, whatever the duration of the test.
+        // Response times in microseconds are grouped in logarithmic buckets, 32 buckets for
+        // each power of 2, meaning a precision of 3%. Response times under 32 us are exact.
+        static constexpr size_t LATENCY_SUB_BITS = 5;
+        static constexpr size_t LATENCY_SUB_BUCKETS = 1 << LATENCY_SUB_BITS;
+        static constexpr size_t LATENCY_BUCKETS = (64 - LATENCY_SUB_BITS) * LATENCY_SUB_BUCKETS;
+        static size_t LatencyBucket(uint64_t us);
+        static uint64_t LatencyBucketValue(size_t bucket);
+
+        const CmdOptions&                  _opt;
+        ts::Report&                        _report;
+        const cn::steady_clock::time_point _start {cn::steady_clock::now()};
+        std::atomic<std::uint32_t>         _request_count {0}; // same as std::atomic_uint32_t, missing in old GCC
+        volatile bool                      _terminate = false;
+        std::mutex                         _mutex {};          // Exclusive access to subsequent fields.
+        std::condition_variable            _condition {};
+        ResponseStat                       _instant_response {};
+        ResponseStat                       _global_response {};
+        std::array<uint64_t, LATENCY_BUCKETS> _latencies {};   // Histogram of response times, for percentiles.
+        uint64_t                           _latency_count = 0; // Number of response times in histogram.
 
         // Report statistics. Must be called with mutex held.
         void reportStatistics(const ResponseStat& stat);
+
+        // Report final latency percentiles and throughput. Must be called with mutex held.
+        void reportPercentiles();
     };
 }
 
@@ -362,11 +385,38 @@ CmdStatistics::~CmdStatistics()
 }
 
 // Provide statistics.
-void CmdStatistics::oneResponse(const cn::milliseconds& time)
+void CmdStatistics::oneResponse(const cn::microseconds& time)
 {
+    const cn::milliseconds ms(cn::duration_cast<cn::milliseconds>(time));
     std::lock_guard<std::mutex> lock(_mutex);
-    _instant_response.feed(time);
-    _global_response.feed(time);
+    _instant_response.feed(ms);
+    _global_response.feed(ms);
+    _latencies[LatencyBucket(uint64_t(std::max<cn::microseconds::rep>(time.count(), 0)))]++;
+    _latency_count++;
+}
+
+// Get the histogram bucket of a response time in microseconds.
+size_t CmdStatistics::LatencyBucket(uint64_t us)
+{
+    if (us < LATENCY_SUB_BUCKETS) {
+        return size_t(us);
+    }
+    else {
+        // Keep the LATENCY_SUB_BITS most significant bits after the leading one.
+        const size_t shift = size_t(std::bit_width(us)) - 1 - LATENCY_SUB_BITS;
+        return (shift + 1) * LATENCY_SUB_BUCKETS + size_t(us >> shift) - LATENCY_SUB_BUCKETS;
+    }
+}
+
+// Get the lowest response time in microseconds in a histogram bucket.
+uint64_t CmdStatistics::LatencyBucketValue(size_t bucket)
+{
+    if (bucket < LATENCY_SUB_BUCKETS) {
+        return bucket;
+    }
+    else {
+        return uint64_t(LATENCY_SUB_BUCKETS + bucket % LATENCY_SUB_BUCKETS) << (bucket / LATENCY_SUB_BUCKETS - 1);
+    }
 }
 
 // Report statistics. Must be called with mutex held.
@@ -378,6 +428,35 @@ void CmdStatistics::reportStatistics(const ResponseStat& stat)
                  stat.standardDeviationString(0, 3));
 }
 
+// Report final latency percentiles and throughput. Must be called with mutex held.
+void CmdStatistics::reportPercentiles()
+{
+    if (_latency_count > 0) {
+        // Get a percentile of the response times, in microseconds, from the histogram.
+        const auto percentile = [this](double pc) {
+            const uint64_t rank = std::min(_latency_count - 1, uint64_t(pc * double(_latency_count) / 100.0));
+            uint64_t cumul = 0;
+            for (size_t bucket = 0; bucket < _latencies.size(); ++bucket) {
+                cumul += _latencies[bucket];
+                if (cumul > rank) {
+                    return LatencyBucketValue(bucket);
+                }
+            }
+            return LatencyBucketValue(_latencies.size() - 1);
+        };
+        const uint64_t p50 = percentile(50.0);
+        const uint64_t p90 = percentile(90.0);
+        const uint64_t p99 = percentile(99.0);
+        const uint64_t p999 = percentile(99.9);
+        _report.info(u"response time (us), p50: %'d, p90: %'d, p99: %'d, p99.9: %'d", p50, p90, p99, p999);
+
+        const cn::milliseconds::rep duration = cn::duration_cast<cn::milliseconds>(cn::steady_clock::now() - _start).count();
+        if (duration > 0) {
+            _report.info(u"throughput: %'d ECM/s", (_latency_count * 1000) / uint64_t(duration));
+        }
+    }
+}
+
 // Thread code.
 void CmdStatistics::main()
 {
@@ -397,6 +476,7 @@ void CmdStatistics::main()
     {
         std::lock_guard<std::mutex> lock(_mutex);
         reportStatistics(_global_response);
+        reportPercentiles();
     }
 }
 
@@ -452,6 +532,7 @@ namespace {
             bool     closing = false;
             uint16_t cp_number = 0;
             ts::Time start_request {};
+            cn::steady_clock::time_point start_time {};  // for precise response time
 
             Stream() = default;
         };
@@ -658,6 +739,7 @@ bool ECMGConnection::sendRequest(uint16_t stream_id)
 
         // Register the message.
         _streams[index].start_request = ts::Time::CurrentUTC();
+        _streams[index].start_time = cn::steady_clock::now();
         _stat.oneRequest();
 
         // Send the message.
@@ -748,14 +830,17 @@ void ECMGConnection::main()
                 if (checkStreamMessage(mp, u"ECM_response")) {
                     std::lock_guard<std::recursive_mutex> lock(_mutex);
                     Stream& stream(_streams[mp->stream_id - _first_stream_id]);
-                    if (!stream.ready || stream.start_request == ts::Time::Epoch) {
+                    if (stream.closing) {
+                        // Response to a request which was sent before closing the stream, ignored.
+                    }
+                    else if (!stream.ready || stream.start_request == ts::Time::Epoch) {
                         _logger.report().error(u"unexpected ECM response, channel_id %d, stream id %d", mp->channel_id, mp->stream_id);
                     }
                     else {
                         // Log current request response time.
-                        _stat.oneResponse(cn::milliseconds(ts::Time::CurrentUTC() - stream.start_request));
-                        // Schedule next request.
-                        _events.postRequest(stream.start_request + _opt.cp_duration, mp->channel_id, mp->stream_id);
+                        _stat.oneResponse(cn::duration_cast<cn::microseconds>(cn::steady_clock::now() - stream.start_time));
+                        // Schedule next request, immediately in load test mode.
+                        _events.postRequest(_opt.load ? ts::Time::CurrentUTC() : stream.start_request + _opt.cp_duration, mp->channel_id, mp->stream_id);
                         stream.start_request = ts::Time::Epoch;
                     }
                 }
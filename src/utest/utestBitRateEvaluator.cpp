@@ -0,0 +1,193 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::BitRateEvaluator
+//
+//----------------------------------------------------------------------------
+
+#include "tsBitRateEvaluator.h"
+#include "tsunit.h"
+#include "utestTSUnitBenchmark.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class BitRateEvaluatorTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(PCRPIDs);
+    TSUNIT_DECLARE_TEST(Discontinuity);
+    TSUNIT_DECLARE_TEST(External);
+    TSUNIT_DECLARE_TEST(Benchmark);
+
+private:
+    // With this bitrate, the duration of a packet is exactly 2000 PCR units.
+    static constexpr uint64_t BITRATE = 20'304'000;
+    static constexpr uint64_t PCR_PER_PACKET = 2000;
+
+    // Number of packets per chunk, as returned by an input plugin.
+    static constexpr size_t CHUNK_SIZE = 1000;
+
+    // Build a constant bitrate stream with 'pid_count' PID's. The first 'pcr_count' PID's carry PCR's.
+    static void BuildTS(ts::TSPacketVector& packets, size_t packet_count, size_t pid_count, size_t pcr_count);
+
+    // Feed packets by chunks, as an input thread.
+    static void Feed(ts::BitRateEvaluator& eval, const ts::TSPacketVector& packets, size_t first = 0, size_t count = ts::NPOS);
+};
+
+TSUNIT_REGISTER(BitRateEvaluatorTest);
+
+
+//----------------------------------------------------------------------------
+// Test helpers.
+//----------------------------------------------------------------------------
+
+void BitRateEvaluatorTest::BuildTS(ts::TSPacketVector& packets, size_t packet_count, size_t pid_count, size_t pcr_count)
+{
+    packets.resize(packet_count);
+    for (size_t i = 0; i < packet_count; ++i) {
+        // One packet per PID, in sequence, with a PCR every 10 packets on PCR PID's.
+        const size_t index = i % pid_count;
+        ts::TSPacket& pkt(packets[i]);
+        pkt = ts::NullPacket;
+        pkt.setPID(ts::PID(0x100 + index));
+        pkt.setCC(uint8_t((i / pid_count) & ts::CC_MASK));
+        if (index < pcr_count && (i / pid_count) % 10 == 0) {
+            pkt.setPCR((i * PCR_PER_PACKET) % ts::PCR_SCALE, true);
+        }
+    }
+}
+
+void BitRateEvaluatorTest::Feed(ts::BitRateEvaluator& eval, const ts::TSPacketVector& packets, size_t first, size_t count)
+{
+    const size_t end = first + std::min(count, packets.size() - first);
+    for (size_t i = first; i < end; i += CHUNK_SIZE) {
+        eval.feedPackets(&packets[i], std::min(CHUNK_SIZE, end - i));
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(PCRPIDs)
+{
+    ts::TSPacketVector packets;
+    BuildTS(packets, 100'000, 8, 4);
+
+    ts::BitRateEvaluator eval(1, 16);
+    TSUNIT_EQUAL(int(ts::BitRateEvaluator::Mode::FULL), int(eval.mode()));
+    TSUNIT_EQUAL(0, eval.evaluate().toInt());
+
+    // Full analysis, until the bitrate is known.
+    Feed(eval, packets, 0, 50'000);
+    TSUNIT_EQUAL(50'000, eval.totalPackets());
+    TSUNIT_EQUAL(50'000, eval.analyzedPackets());
+    TSUNIT_EQUAL(BITRATE, eval.evaluate().toInt());
+    TSUNIT_EQUAL(int(ts::BitRateEvaluator::Mode::PCR_PIDS), int(eval.mode()));
+
+    // Now, only the PCR PID's are analyzed, the bitrate is still exact.
+    Feed(eval, packets, 50'000);
+    TSUNIT_EQUAL(100'000, eval.totalPackets());
+    TSUNIT_EQUAL(75'000, eval.analyzedPackets());
+    TSUNIT_EQUAL(BITRATE, eval.evaluate().toInt());
+    TSUNIT_EQUAL(int(ts::BitRateEvaluator::Mode::PCR_PIDS), int(eval.mode()));
+    debug() << "BitRateEvaluatorTest::PCRPIDs: mode: " << ts::BitRateEvaluator::ModeNames().name(eval.mode()) << std::endl;
+}
+
+TSUNIT_DEFINE_TEST(Discontinuity)
+{
+    ts::TSPacketVector packets;
+    BuildTS(packets, 50'000, 8, 4);
+
+    ts::BitRateEvaluator eval(1, 16);
+    Feed(eval, packets);
+    TSUNIT_EQUAL(BITRATE, eval.evaluate().toInt());
+    TSUNIT_EQUAL(int(ts::BitRateEvaluator::Mode::PCR_PIDS), int(eval.mode()));
+
+    // Break the continuity on a PCR PID: the full analysis is re-armed, the bitrate remains available.
+    ts::TSPacket pkt(packets[0]);
+    pkt.setCC(uint8_t((pkt.getCC() + 5) & ts::CC_MASK));
+    eval.feedPackets(&pkt, 1);
+    TSUNIT_EQUAL(BITRATE, eval.evaluate().toInt());
+    TSUNIT_EQUAL(int(ts::BitRateEvaluator::Mode::FULL), int(eval.mode()));
+
+    // The PCR PID's are collected again, then back to PCR mode.
+    const ts::PacketCounter analyzed = eval.analyzedPackets();
+    Feed(eval, packets);
+    TSUNIT_EQUAL(analyzed + 50'000, eval.analyzedPackets());
+    TSUNIT_ASSERT(eval.evaluate() > 0);
+    TSUNIT_EQUAL(int(ts::BitRateEvaluator::Mode::PCR_PIDS), int(eval.mode()));
+}
+
+TSUNIT_DEFINE_TEST(External)
+{
+    ts::TSPacketVector packets;
+    BuildTS(packets, 50'000, 8, 4);
+
+    // Nothing is analyzed while the bitrate is externally provided.
+    ts::BitRateEvaluator eval(1, 16);
+    eval.setExternalBitRate(true);
+    TSUNIT_EQUAL(int(ts::BitRateEvaluator::Mode::EXTERNAL), int(eval.mode()));
+    Feed(eval, packets);
+    TSUNIT_EQUAL(50'000, eval.totalPackets());
+    TSUNIT_EQUAL(0, eval.analyzedPackets());
+    TSUNIT_EQUAL(0, eval.evaluate().toInt());
+
+    // The full analysis restarts when the external bitrate is no longer available.
+    eval.setExternalBitRate(false);
+    TSUNIT_EQUAL(int(ts::BitRateEvaluator::Mode::FULL), int(eval.mode()));
+    TSUNIT_EQUAL(0, eval.totalPackets());
+    Feed(eval, packets);
+    TSUNIT_EQUAL(BITRATE, eval.evaluate().toInt());
+    TSUNIT_EQUAL(int(ts::BitRateEvaluator::Mode::PCR_PIDS), int(eval.mode()));
+}
+
+TSUNIT_DEFINE_TEST(Benchmark)
+{
+    // Simulate the input thread on a 20-PID stream, 2 of them with PCR's. The bitrate is evaluated
+    // after each 10 chunks of packets. The number of iterations is in TSUNIT_BITRATE_EVALUATOR_ITERATIONS.
+    ts::TSPacketVector packets;
+    BuildTS(packets, 100'000, 20, 2);
+
+    // Previous method: feed all packets into a PCR and a DTS analyzer.
+    utest::TSUnitBenchmark bench1(u"TSUNIT_BITRATE_EVALUATOR_ITERATIONS");
+    ts::PCRAnalyzer pcr_zer(1, 32);
+    ts::PCRAnalyzer dts_zer;
+    dts_zer.resetAndUseDTS(1, 32);
+    bench1.start();
+    for (size_t iter = 0; iter < bench1.iterations; ++iter) {
+        for (const auto& pkt : packets) {
+            pcr_zer.feedPacket(pkt);
+            dts_zer.feedPacket(pkt);
+        }
+    }
+    bench1.stop();
+    bench1.report(u"BitRateEvaluatorTest::Benchmark: PCR and DTS analyzers");
+    TSUNIT_EQUAL(BITRATE, pcr_zer.bitrate188().toInt());
+
+    // Adaptive bitrate evaluator.
+    utest::TSUnitBenchmark bench2(u"TSUNIT_BITRATE_EVALUATOR_ITERATIONS");
+    ts::BitRateEvaluator eval(1, 32);
+    ts::BitRate bitrate = 0;
+    bench2.start();
+    for (size_t iter = 0; iter < bench2.iterations; ++iter) {
+        for (size_t i = 0; i < packets.size(); i += CHUNK_SIZE) {
+            eval.feedPackets(&packets[i], std::min(CHUNK_SIZE, packets.size() - i));
+            if ((i / CHUNK_SIZE) % 10 == 9) {
+                bitrate = eval.evaluate();
+            }
+        }
+    }
+    bench2.stop();
+    bench2.report(u"BitRateEvaluatorTest::Benchmark: adaptive evaluator");
+    debug() << "BitRateEvaluatorTest::Benchmark: analyzed " << eval.analyzedPackets() << " packets out of " << eval.totalPackets() << std::endl;
+    TSUNIT_EQUAL(BITRATE, bitrate.toInt());
+}
@@ -24,6 +24,7 @@
 #include "tsTOT.h"
 #include "tsTDT.h"
 #include "tsunit.h"
+#include "utestTSUnitBenchmark.h"
 
 #include "tables/psi_bat_cplus_packets.h"
 #include "tables/psi_bat_cplus_sections.h"
@@ -66,6 +67,8 @@ class DemuxTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(TDT);
     TSUNIT_DECLARE_TEST(TOT);
     TSUNIT_DECLARE_TEST(HEVC);
+    TSUNIT_DECLARE_TEST(SectionArena);
+    TSUNIT_DECLARE_TEST(SectionArenaBenchmark);
 
 private:
     // Compare a table with the list of reference sections
@@ -76,6 +79,9 @@ private:
 
     // Unitary test for one table.
     void testTable(const char* name, const uint8_t* ref_packets, size_t ref_packets_size, const uint8_t* ref_sections, size_t ref_sections_size);
+
+    // Demux all sections in a list of packets, repeatedly, return the concatenation of the sections of the last iteration.
+    ts::ByteBlock demuxSections(ts::SectionDemux& demux, size_t iterations, const uint8_t* packets, size_t packets_size);
 };
 
 TSUNIT_REGISTER(DemuxTest);
@@ -434,3 +440,137 @@ TSUNIT_DEFINE_TEST(HEVC)
 {
     TEST_TABLE("PMT with HEVC descriptor", pmt_hevc);
 }
+
+
+//----------------------------------------------------------------------------
+// Section allocation in a memory arena.
+//----------------------------------------------------------------------------
+
+namespace {
+    class SectionCollector: public ts::SectionHandlerInterface
+    {
+    public:
+        ts::ByteBlock data {};
+        virtual void handleSection(ts::SectionDemux&, const ts::Section& section) override
+        {
+            data.append(section.content(), section.size());
+        }
+    };
+}
+
+ts::ByteBlock DemuxTest::demuxSections(ts::SectionDemux& demux, size_t iterations, const uint8_t* packets, size_t packets_size)
+{
+    SectionCollector collector;
+    demux.setSectionHandler(&collector);
+    demux.addPID(ts::PID(ts::GetUInt16(packets + 1) & 0x1FFF));
+    const ts::TSPacket* pkt = reinterpret_cast<const ts::TSPacket*>(packets);
+    const size_t count = packets_size / ts::PKT_SIZE;
+    for (size_t iter = 0; iter < iterations; ++iter) {
+        collector.data.clear();
+        demux.reset();
+        for (size_t i = 0; i < count; ++i) {
+            demux.feedPacket(pkt[i]);
+        }
+    }
+    demux.setSectionHandler(nullptr);
+    return collector.data;
+}
+
+TSUNIT_DEFINE_TEST(SectionArena)
+{
+    ts::DuckContext duck;
+    ts::SectionDemux demux(duck);
+    TSUNIT_ASSERT(demux.sectionArena() == nullptr);
+    demux.useSectionArena(true);
+    TSUNIT_ASSERT(demux.sectionArena() != nullptr);
+
+    // Warm up the arena.
+    ts::ByteBlock data(demuxSections(demux, 1, psi_bat_tvnum_packets, sizeof(psi_bat_tvnum_packets)));
+    TSUNIT_EQUAL(sizeof(psi_bat_tvnum_sections), data.size());
+    TSUNIT_ASSERT(ts::MemEqual(data.data(), psi_bat_tvnum_sections, data.size()));
+    const ts::SectionArena::Statistics stats1(demux.sectionArena()->getStatistics());
+    TSUNIT_ASSERT(stats1.sections > 0);
+
+    // When the arena is warm, there is no more heap allocation.
+    data = demuxSections(demux, 10, psi_bat_tvnum_packets, sizeof(psi_bat_tvnum_packets));
+    TSUNIT_EQUAL(sizeof(psi_bat_tvnum_sections), data.size());
+    TSUNIT_ASSERT(ts::MemEqual(data.data(), psi_bat_tvnum_sections, data.size()));
+    const ts::SectionArena::Statistics stats2(demux.sectionArena()->getStatistics());
+    TSUNIT_EQUAL(11 * stats1.sections, stats2.sections);
+    TSUNIT_EQUAL(stats1.heapAllocations(), stats2.heapAllocations());
+    TSUNIT_ASSERT(stats2.reused_byte_blocks > 0);
+
+    debug() << "DemuxTest::SectionArena: sections: " << stats2.sections
+            << ", slabs: " << stats2.slabs
+            << ", large blocks: " << stats2.large_blocks
+            << ", new byte blocks: " << stats2.new_byte_blocks
+            << ", reused byte blocks: " << stats2.reused_byte_blocks
+            << ", memory size: " << stats2.memory_size << std::endl;
+
+    // Sections from the arena can outlive the demux and the arena.
+    ts::SectionPtr sect;
+    {
+        ts::SectionDemux demux2(duck);
+        demux2.useSectionArena(true);
+        class Keeper: public ts::SectionHandlerInterface
+        {
+        public:
+            ts::SectionPtr& ptr;
+            Keeper(ts::SectionPtr& p) : ptr(p) {}
+            virtual void handleSection(ts::SectionDemux&, const ts::Section& section) override
+            {
+                // Share the content of the arena section.
+                ptr = std::make_shared<ts::Section>(section, ts::ShareMode::SHARE);
+            }
+        } keeper(sect);
+        demux2.setSectionHandler(&keeper);
+        demux2.addPID(ts::PID_SDT);
+        const ts::TSPacket* pkt = reinterpret_cast<const ts::TSPacket*>(psi_sdt_r3_packets);
+        for (size_t i = 0; i < sizeof(psi_sdt_r3_packets) / ts::PKT_SIZE; ++i) {
+            demux2.feedPacket(pkt[i]);
+        }
+    }
+    TSUNIT_ASSERT(sect != nullptr);
+    TSUNIT_ASSERT(sect->isValid());
+    TSUNIT_EQUAL(sizeof(psi_sdt_r3_sections), sect->size());
+    TSUNIT_ASSERT(ts::MemEqual(sect->content(), psi_sdt_r3_sections, sect->size()));
+}
+
+TSUNIT_DEFINE_TEST(SectionArenaBenchmark)
+{
+    // Compare the CPU time and the number of heap allocations of the two allocation modes.
+    // The number of iterations is in TSUNIT_DEMUX_ARENA_ITERATIONS.
+    ts::DuckContext duck;
+
+    utest::TSUnitBenchmark bench1(u"TSUNIT_DEMUX_ARENA_ITERATIONS");
+    ts::SectionDemux demux1(duck);
+    bench1.start();
+    const ts::ByteBlock data1(demuxSections(demux1, bench1.iterations, psi_bat_tvnum_packets, sizeof(psi_bat_tvnum_packets)));
+    bench1.stop();
+    TSUNIT_EQUAL(sizeof(psi_bat_tvnum_sections), data1.size());
+    bench1.report(u"DemuxTest::SectionArenaBenchmark (heap)");
+
+    utest::TSUnitBenchmark bench2(u"TSUNIT_DEMUX_ARENA_ITERATIONS");
+    ts::SectionDemux demux2(duck);
+    demux2.useSectionArena(true);
+    bench2.start();
+    const ts::ByteBlock data2(demuxSections(demux2, bench2.iterations, psi_bat_tvnum_packets, sizeof(psi_bat_tvnum_packets)));
+    bench2.stop();
+    TSUNIT_EQUAL(sizeof(psi_bat_tvnum_sections), data2.size());
+    bench2.report(u"DemuxTest::SectionArenaBenchmark (arena)");
+
+    // Without arena, each section needs three heap allocations: the Section object and its control block,
+    // the ByteBlock object and its control block, the data area. The arena counts its own heap allocations.
+    // Use a fixed number of iterations, independent of the benchmark, so that the initial allocations of
+    // the arena are amortized.
+    ts::SectionDemux demux3(duck);
+    demux3.useSectionArena(true);
+    demuxSections(demux3, 100, psi_bat_tvnum_packets, sizeof(psi_bat_tvnum_packets));
+    const ts::SectionArena::Statistics stats(demux3.sectionArena()->getStatistics());
+    const uint64_t heap_allocs = 3 * stats.sections;
+    debug() << "DemuxTest::SectionArenaBenchmark: sections: " << stats.sections
+            << ", heap allocations without arena: " << heap_allocs
+            << ", with arena: " << stats.heapAllocations() << std::endl;
+    TSUNIT_ASSERT(stats.sections >= 100);
+    TSUNIT_ASSERT(stats.heapAllocations() < heap_allocs);
+}
@@ -11,6 +11,15 @@
 //----------------------------------------------------------------------------
 
 #include "tshlsPlayList.h"
+#include "tshlsSegmentPrefetcher.h"
+#include "tsTCPServer.h"
+#include "tsSocketReactor.h"
+#include "tsTSPacket.h"
+#include "tsNullReport.h"
+#include "tsVersionInfo.h"
+#include "tsErrCodeReport.h"
+#include "tsFileUtils.h"
+#include "utestTSUnitThread.h"
 #include "tsunit.h"
 
 
@@ -25,6 +34,9 @@ class HLSTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(MediaPlaylist);
     TSUNIT_DECLARE_TEST(BuildMasterPlaylist);
     TSUNIT_DECLARE_TEST(BuildMediaPlaylist);
+    TSUNIT_DECLARE_TEST(Prefetch);
+    TSUNIT_DECLARE_TEST(PrefetchFile);
+    TSUNIT_DECLARE_TEST(Reload);
 
 public:
     virtual void beforeTest() override;
@@ -361,3 +373,349 @@ TSUNIT_DEFINE_TEST(BuildMediaPlaylist)
 
     TSUNIT_EQUAL(refContent2, pl.textContent());
 }
+
+
+//----------------------------------------------------------------------------
+// A minimal HTTP server serving a synthetic HLS media playlist.
+// Persistent connections are supported. All client connections are
+// managed by a socket reactor in the server thread.
+//----------------------------------------------------------------------------
+
+namespace {
+    class HLSServer: public utest::TSUnitThread, private ts::SocketReactorHandlerInterface
+    {
+        TS_NOCOPY(HLSServer);
+    public:
+        static constexpr size_t  SEGMENT_COUNT = 8;
+        static constexpr size_t  PACKETS_PER_SEGMENT = 10;
+        static constexpr ts::PID FIRST_PID = 100;
+
+        HLSServer() = default;
+        virtual ~HLSServer() override;
+
+        // Open the server, in the main thread, before starting the thread.
+        bool open();
+
+        // Terminate the server thread.
+        void terminate();
+
+        // Build the URL of a file on the server.
+        ts::UString url(const ts::UString& file) const { return ts::UString::Format(u"http://127.0.0.1:%d/%s", _port, file); }
+
+        // Total number of accepted client connections.
+        size_t connectionCount() const { return _connection_count.load(); }
+
+    protected:
+        virtual void test() override;
+
+    private:
+        // Description of a client connection.
+        class Client
+        {
+        public:
+            std::shared_ptr<ts::TCPConnection> conn {};
+            std::string input {};
+            std::string output {};
+        };
+
+        ts::TCPServer       _server {};
+        uint16_t            _port = 0;
+        ts::SocketReactor   _reactor {};
+        std::atomic<size_t> _connection_count {0};
+        std::map<ts::SysSocketType, Client> _clients {};
+
+        // Implementation of SocketReactorHandlerInterface.
+        virtual void handleSocketEvents(ts::SocketReactor& reactor, ts::SysSocketType sock, ts::SocketEvents events) override;
+
+        // Process all complete requests in the input buffer of a client.
+        static void processRequests(Client& client);
+    };
+}
+
+HLSServer::~HLSServer()
+{
+    terminate();
+}
+
+bool HLSServer::open()
+{
+    ts::IPSocketAddress addr(ts::IPAddress::LocalHost4, ts::IPSocketAddress::AnyPort);
+    if (!ts::IPInitialize() ||
+        !_server.open(ts::IP::v4, CERR) ||
+        !_server.reusePort(true, CERR) ||
+        !_server.bind(addr, CERR) ||
+        !_server.listen(5, CERR) ||
+        !_server.getLocalAddress(addr, CERR) ||
+        !_reactor.open(CERR) ||
+        !_reactor.add(_server.getSocket(), this, ts::SocketEvents::READ, CERR))
+    {
+        return false;
+    }
+    _port = addr.port();
+    return true;
+}
+
+void HLSServer::terminate()
+{
+    _reactor.stop();
+    waitForTermination();
+    for (auto& it : _clients) {
+        it.second.conn->close(NULLREP);
+    }
+    _clients.clear();
+    _reactor.close(NULLREP);
+    _server.close(NULLREP);
+}
+
+void HLSServer::test()
+{
+    TSUNIT_ASSERT(_reactor.run(CERR));
+}
+
+void HLSServer::handleSocketEvents(ts::SocketReactor& reactor, ts::SysSocketType sock, ts::SocketEvents events)
+{
+    // Incoming connection on the server socket.
+    if (sock == _server.getSocket()) {
+        Client client;
+        client.conn = std::make_shared<ts::TCPConnection>();
+        ts::IPSocketAddress addr;
+        if (_server.accept(*client.conn, addr, CERR) && client.conn->setNonBlocking(true, CERR)) {
+            const ts::SysSocketType csock = client.conn->getSocket();
+            _clients[csock] = client;
+            _connection_count++;
+            reactor.add(csock, this, ts::SocketEvents::READ, CERR);
+        }
+        return;
+    }
+
+    const auto it = _clients.find(sock);
+    if (it == _clients.end()) {
+        return;
+    }
+    Client& client(it->second);
+    bool ok = true;
+
+    // Receive and process requests.
+    if (bool(events & (ts::SocketEvents::READ | ts::SocketEvents::HANGUP))) {
+        char buffer[4096];
+        size_t size = 0;
+        ok = client.conn->receiveSome(buffer, sizeof(buffer), size, NULLREP);
+        client.input.append(buffer, size);
+        processRequests(client);
+    }
+
+    // Send pending responses.
+    if (ok && !client.output.empty()) {
+        size_t size = 0;
+        ok = client.conn->sendSome(client.output.data(), client.output.size(), size, NULLREP);
+        client.output.erase(0, size);
+    }
+    if (ok) {
+        ok = reactor.modify(sock, client.output.empty() ? ts::SocketEvents::READ : ts::SocketEvents::READ | ts::SocketEvents::WRITE, CERR);
+    }
+
+    // Close the connection on error or disconnection.
+    if (!ok) {
+        reactor.remove(sock, NULLREP);
+        client.conn->close(NULLREP);
+        _clients.erase(it);
+    }
+}
+
+void HLSServer::processRequests(Client& client)
+{
+    for (size_t end = client.input.find("\r\n\r\n"); end != std::string::npos; end = client.input.find("\r\n\r\n")) {
+
+        // Get the path from the request line "GET /path HTTP/1.1".
+        const size_t start = client.input.find(' ') + 1;
+        const std::string path(client.input.substr(start, client.input.find(' ', start) - start));
+        client.input.erase(0, end + 4);
+
+        // Build the content.
+        std::string type("video/mp2t");
+        std::string content;
+        size_t index = 0;
+        if (path == "/index.m3u8") {
+            type = "application/vnd.apple.mpegurl";
+            content = "#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-TARGETDURATION:2\n#EXT-X-MEDIA-SEQUENCE:0\n#EXT-X-PLAYLIST-TYPE:VOD\n";
+            for (size_t i = 0; i < SEGMENT_COUNT; ++i) {
+                content += "#EXTINF:2.0,\nseg" + std::to_string(i) + ".ts\n";
+            }
+            content += "#EXT-X-ENDLIST\n";
+        }
+        else if (std::sscanf(path.c_str(), "/seg%zu.ts", &index) == 1 && index < SEGMENT_COUNT) {
+            for (size_t i = 0; i < PACKETS_PER_SEGMENT; ++i) {
+                ts::TSPacket pkt;
+                pkt.init(ts::PID(FIRST_PID + index), uint8_t(i));
+                content.append(reinterpret_cast<const char*>(pkt.b), ts::PKT_SIZE);
+            }
+        }
+        else {
+            client.output += "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+            continue;
+        }
+        client.output += "HTTP/1.1 200 OK\r\nContent-Type: " + type + "\r\nContent-Length: " + std::to_string(content.size()) + "\r\n\r\n" + content;
+    }
+}
+
+TSUNIT_DEFINE_TEST(Prefetch)
+{
+    // TS_NO_CURL is not visible in the test programs, check the library features.
+    if (ts::VersionInfo::SupportEnum().value(u"http") != 1) {
+        debug() << "HLSTest::Prefetch: skipped, no Web support" << std::endl;
+        return;
+    }
+
+    HLSServer server;
+    TSUNIT_ASSERT(server.open());
+    server.start();
+
+    ts::hls::PlayList pl;
+    TSUNIT_ASSERT(pl.loadURL(server.url(u"index.m3u8"), true, ts::WebRequestArgs(), ts::hls::PlayListType::UNKNOWN, CERR));
+    TSUNIT_ASSERT(pl.isMedia());
+    TSUNIT_EQUAL(HLSServer::SEGMENT_COUNT, pl.segmentCount());
+
+    // Get all segments, in order.
+    ts::hls::SegmentPrefetcher prefetcher(CERR);
+    ts::hls::MediaSegment seg;
+    ts::ByteBlock data;
+    TSUNIT_ASSERT(prefetcher.start(pl, ts::WebRequestArgs(), 3));
+    for (size_t i = 0; i < HLSServer::SEGMENT_COUNT; ++i) {
+        TSUNIT_ASSERT(prefetcher.getNextSegment(seg, data));
+        TSUNIT_EQUAL(server.url(ts::UString::Format(u"seg%d.ts", i)), seg.urlString());
+        TSUNIT_EQUAL(HLSServer::PACKETS_PER_SEGMENT * ts::PKT_SIZE, data.size());
+        TSUNIT_EQUAL(HLSServer::FIRST_PID + i, ts::GetUInt16(data.data() + 1) & 0x1FFF);
+    }
+    TSUNIT_ASSERT(!prefetcher.getNextSegment(seg, data));
+    prefetcher.stop();
+
+    // One connection for the playlist and at most one per download thread: connections are reused.
+    debug() << "HLSTest::Prefetch: connection count: " << server.connectionCount() << std::endl;
+    TSUNIT_ASSERT(server.connectionCount() <= 4);
+
+    // Limited number of segments.
+    TSUNIT_ASSERT(prefetcher.start(pl, ts::WebRequestArgs(), 2, 3));
+    for (size_t i = 0; i < 3; ++i) {
+        TSUNIT_ASSERT(prefetcher.getNextSegment(seg, data));
+        TSUNIT_EQUAL(server.url(ts::UString::Format(u"seg%d.ts", i)), seg.urlString());
+    }
+    TSUNIT_ASSERT(!prefetcher.getNextSegment(seg, data));
+    prefetcher.stop();
+
+    server.terminate();
+}
+
+TSUNIT_DEFINE_TEST(PrefetchFile)
+{
+    // Same media playlist as the HTTP server, in local files. Does not need Web support.
+    const fs::path dir(ts::TempFile(u""));
+    TSUNIT_ASSERT(fs::create_directory(dir, &ts::ErrCodeReport(CERR, u"error creating", dir)));
+    {
+        std::ofstream file(dir / "index.m3u8", std::ios::out | std::ios::trunc);
+        file << "#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-TARGETDURATION:2\n#EXT-X-MEDIA-SEQUENCE:0\n#EXT-X-PLAYLIST-TYPE:VOD\n";
+        for (size_t i = 0; i < HLSServer::SEGMENT_COUNT; ++i) {
+            file << "#EXTINF:2.0,\nseg" << i << ".ts\n";
+        }
+        file << "#EXT-X-ENDLIST\n";
+    }
+    for (size_t i = 0; i < HLSServer::SEGMENT_COUNT; ++i) {
+        std::ofstream file(dir / ("seg" + std::to_string(i) + ".ts"), std::ios::out | std::ios::trunc | std::ios::binary);
+        for (size_t p = 0; p < HLSServer::PACKETS_PER_SEGMENT; ++p) {
+            ts::TSPacket pkt;
+            pkt.init(ts::PID(HLSServer::FIRST_PID + i), uint8_t(p));
+            file.write(reinterpret_cast<const char*>(pkt.b), ts::PKT_SIZE);
+        }
+    }
+
+    ts::hls::PlayList pl;
+    TSUNIT_ASSERT(pl.loadFile(ts::UString(dir / "index.m3u8"), true, ts::hls::PlayListType::UNKNOWN, CERR));
+    TSUNIT_ASSERT(pl.isMedia());
+    TSUNIT_EQUAL(HLSServer::SEGMENT_COUNT, pl.segmentCount());
+
+    // Get all segments, in order.
+    ts::hls::SegmentPrefetcher prefetcher(CERR);
+    ts::hls::MediaSegment seg;
+    ts::ByteBlock data;
+    TSUNIT_ASSERT(prefetcher.start(pl, ts::WebRequestArgs(), 3));
+    for (size_t i = 0; i < HLSServer::SEGMENT_COUNT; ++i) {
+        TSUNIT_ASSERT(prefetcher.getNextSegment(seg, data));
+        TSUNIT_EQUAL(ts::UString::Format(u"seg%d.ts", i), seg.relative_uri);
+        TSUNIT_EQUAL(HLSServer::PACKETS_PER_SEGMENT * ts::PKT_SIZE, data.size());
+        TSUNIT_EQUAL(HLSServer::FIRST_PID + i, ts::GetUInt16(data.data() + 1) & 0x1FFF);
+    }
+    TSUNIT_ASSERT(!prefetcher.getNextSegment(seg, data));
+    prefetcher.stop();
+
+    // Limited number of segments.
+    TSUNIT_ASSERT(prefetcher.start(pl, ts::WebRequestArgs(), 2, 3));
+    for (size_t i = 0; i < 3; ++i) {
+        TSUNIT_ASSERT(prefetcher.getNextSegment(seg, data));
+        TSUNIT_EQUAL(ts::UString::Format(u"seg%d.ts", i), seg.relative_uri);
+    }
+    TSUNIT_ASSERT(!prefetcher.getNextSegment(seg, data));
+    prefetcher.stop();
+
+    // A missing segment file is reported as a failed segment, in playlist order.
+    fs::remove(dir / "seg1.ts", &ts::ErrCodeReport());
+    ts::hls::SegmentPrefetcher failing(NULLREP);
+    TSUNIT_ASSERT(failing.start(pl, ts::WebRequestArgs(), 2, 3));
+    TSUNIT_ASSERT(failing.getNextSegment(seg, data));
+    TSUNIT_EQUAL(u"seg0.ts", seg.relative_uri);
+    TSUNIT_ASSERT(!failing.getNextSegment(seg, data));
+    TSUNIT_EQUAL(u"seg1.ts", seg.relative_uri);
+    failing.stop();
+
+    fs::remove_all(dir, &ts::ErrCodeReport());
+}
+
+// Write a live media playlist in a file, without end of list.
+namespace {
+    void WriteLivePlaylist(const fs::path& filename, size_t first, size_t count)
+    {
+        std::ofstream file(filename, std::ios::out | std::ios::trunc);
+        file << "#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-TARGETDURATION:2\n#EXT-X-MEDIA-SEQUENCE:" << first << "\n";
+        for (size_t i = first; i < first + count; ++i) {
+            file << "#EXTINF:2.0,\nseg" << i << ".ts\n";
+        }
+    }
+}
+
+TSUNIT_DEFINE_TEST(Reload)
+{
+    const fs::path filename(ts::TempFile(u".m3u8"));
+    WriteLivePlaylist(filename, 0, 3);
+
+    ts::hls::PlayList pl;
+    TSUNIT_ASSERT(pl.loadFile(ts::UString(filename), true, ts::hls::PlayListType::UNKNOWN, CERR));
+    TSUNIT_ASSERT(pl.isMedia());
+    TSUNIT_ASSERT(pl.isUpdatable());
+    TSUNIT_EQUAL(0, pl.mediaSequence());
+    TSUNIT_EQUAL(3, pl.segmentCount());
+
+    // Consume one segment, the server drops one and adds two.
+    TSUNIT_ASSERT(pl.popFirstSegment());
+    WriteLivePlaylist(filename, 1, 4);
+    TSUNIT_ASSERT(pl.reload(true, ts::WebRequestArgs(), CERR));
+    TSUNIT_EQUAL(1, pl.mediaSequence());
+    TSUNIT_EQUAL(4, pl.segmentCount());
+    for (size_t i = 0; i < pl.segmentCount(); ++i) {
+        TSUNIT_EQUAL(ts::UString::Format(u"seg%d.ts", i + 1), pl.segment(i).relative_uri);
+    }
+
+    // No new segment, the playlist is unchanged.
+    TSUNIT_ASSERT(pl.popFirstSegment());
+    WriteLivePlaylist(filename, 2, 3);
+    TSUNIT_ASSERT(pl.reload(true, ts::WebRequestArgs(), CERR));
+    TSUNIT_EQUAL(2, pl.mediaSequence());
+    TSUNIT_EQUAL(3, pl.segmentCount());
+
+    // Reloaded too late, the current segments are dropped.
+    WriteLivePlaylist(filename, 10, 2);
+    TSUNIT_ASSERT(pl.reload(true, ts::WebRequestArgs(), NULLREP));
+    TSUNIT_EQUAL(10, pl.mediaSequence());
+    TSUNIT_EQUAL(2, pl.segmentCount());
+    TSUNIT_EQUAL(u"seg10.ts", pl.segment(0).relative_uri);
+    TSUNIT_EQUAL(u"seg11.ts", pl.segment(1).relative_uri);
+
+    fs::remove(filename, &ts::ErrCodeReport());
+}
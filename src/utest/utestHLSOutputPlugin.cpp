@@ -0,0 +1,260 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for the HLS output plugin.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSProcessor.h"
+#include "tshlsPlayList.h"
+#include "tsOneShotPacketizer.h"
+#include "tsCADescriptor.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
+#include "tsTSFile.h"
+#include "tsFileUtils.h"
+#include "tsErrCodeReport.h"
+#include "tsCerrReport.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class HLSOutputPluginTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(LiveWriter);
+    TSUNIT_DECLARE_TEST(Renditions);
+
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+private:
+    fs::path _dir {};
+    fs::path _input {};
+
+    // Reference transport stream: two services of 1,000 packets per second each.
+    static constexpr size_t PACKET_COUNT = 8'000;
+    static constexpr uint64_t PCR_PER_PACKET = ts::SYSTEM_CLOCK_FREQ / 2'000;
+    static constexpr ts::PID PMT1_PID = 0x0100;
+    static constexpr ts::PID VIDEO1_PID = 0x0101;
+    static constexpr ts::PID ECM1_PID = 0x0105;
+    static constexpr ts::PID PMT2_PID = 0x0200;
+    static constexpr ts::PID VIDEO2_PID = 0x0201;
+
+    // Generate the reference transport stream in the input file.
+    void generateInput();
+
+    // Run tsp with the hls output plugin on the input file.
+    void runHLS(const ts::UStringVector& args);
+
+    // Load the PID's of all packets in the segments of a media playlist.
+    static void loadSegmentPIDs(const ts::hls::PlayList& pl, ts::PIDSet& pids);
+
+    // Get the list of files in the output directory.
+    std::set<ts::UString> outputFiles() const;
+};
+
+TSUNIT_REGISTER(HLSOutputPluginTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+void HLSOutputPluginTest::beforeTest()
+{
+    _dir = ts::TempFile(u"");
+    fs::create_directory(_dir, &ts::ErrCodeReport(CERR, u"error creating", _dir));
+    _input = _dir / "input.ts";
+    generateInput();
+}
+
+void HLSOutputPluginTest::afterTest()
+{
+    fs::remove_all(_dir, &ts::ErrCodeReport());
+}
+
+void HLSOutputPluginTest::generateInput()
+{
+    ts::DuckContext duck;
+
+    // One PAT with two services. Service 1 is scrambled, with an ECM PID.
+    ts::PAT pat(0, true, 1);
+    pat.pmts[1] = PMT1_PID;
+    pat.pmts[2] = PMT2_PID;
+
+    ts::PMT pmt1(0, true, 1, VIDEO1_PID);
+    pmt1.streams[VIDEO1_PID].stream_type = ts::ST_MPEG2_VIDEO;
+    pmt1.descs.add(duck, ts::CADescriptor(0x0100, ECM1_PID));
+
+    ts::PMT pmt2(0, true, 2, VIDEO2_PID);
+    pmt2.streams[VIDEO2_PID].stream_type = ts::ST_MPEG2_VIDEO;
+
+    ts::TSPacketVector pat_packets, pmt1_packets, pmt2_packets;
+    ts::OneShotPacketizer pzer(duck, ts::PID_PAT);
+    pzer.addTable(duck, pat);
+    pzer.getPackets(pat_packets);
+    pzer.setPID(PMT1_PID);
+    pzer.addTable(duck, pmt1);
+    pzer.getPackets(pmt1_packets);
+    pzer.setPID(PMT2_PID);
+    pzer.addTable(duck, pmt2);
+    pzer.getPackets(pmt2_packets);
+    TSUNIT_EQUAL(1, pat_packets.size());
+    TSUNIT_EQUAL(1, pmt1_packets.size());
+    TSUNIT_EQUAL(1, pmt2_packets.size());
+
+    // Tables every 100 packets. Video packets alternate between the two services,
+    // with a new PES packet and a PCR every 10 packets.
+    std::map<ts::PID, uint8_t> cc;
+    ts::TSPacketVector packets(PACKET_COUNT);
+    for (size_t n = 0; n < PACKET_COUNT; ++n) {
+        ts::TSPacket& pkt(packets[n]);
+        switch (n % 100) {
+            case 0: pkt = pat_packets[0]; break;
+            case 1: pkt = pmt1_packets[0]; break;
+            case 2: pkt = pmt2_packets[0]; break;
+            case 3: pkt.init(ECM1_PID); break;
+            default: {
+                const ts::PID pid = n % 2 == 0 ? VIDEO1_PID : VIDEO2_PID;
+                pkt.init(pid);
+                if (n % 10 >= 4 && n % 10 <= 5) {
+                    pkt.setPUSI();
+                    pkt.setPCR(n * PCR_PER_PACKET, true);
+                }
+                break;
+            }
+        }
+        pkt.setCC(cc[pkt.getPID()]++ & ts::CC_MASK);
+    }
+
+    ts::TSFile file;
+    TSUNIT_ASSERT(file.open(_input, ts::TSFile::WRITE, CERR));
+    TSUNIT_ASSERT(file.writePackets(packets.data(), nullptr, packets.size(), CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+}
+
+
+//----------------------------------------------------------------------------
+// Helpers.
+//----------------------------------------------------------------------------
+
+void HLSOutputPluginTest::runHLS(const ts::UStringVector& args)
+{
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"HLSOutputPluginTest";
+    opt.input = {u"file", {ts::UString(_input)}};
+    opt.output = {u"hls", args};
+    ts::TSProcessor tsproc(CERR);
+    TSUNIT_ASSERT(tsproc.start(opt));
+    tsproc.waitForTermination();
+}
+
+void HLSOutputPluginTest::loadSegmentPIDs(const ts::hls::PlayList& pl, ts::PIDSet& pids)
+{
+    for (size_t i = 0; i < pl.segmentCount(); ++i) {
+        ts::TSFile file;
+        TSUNIT_ASSERT(file.openRead(pl.segment(i).file_path, 0, CERR));
+        ts::TSPacket pkt;
+        while (file.readPackets(&pkt, nullptr, 1, CERR) == 1) {
+            pids.set(pkt.getPID());
+        }
+        TSUNIT_ASSERT(file.close(CERR));
+    }
+}
+
+std::set<ts::UString> HLSOutputPluginTest::outputFiles() const
+{
+    std::set<ts::UString> files;
+    for (const auto& entry : fs::directory_iterator(_dir)) {
+        if (entry.path() != _input) {
+            files.insert(entry.path().filename());
+        }
+    }
+    return files;
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+// Live playlist: the writer thread renames the segments and purges the obsolete ones.
+TSUNIT_DEFINE_TEST(LiveWriter)
+{
+    const ts::UString playlist(_dir / "live.m3u8");
+    runHLS({u"--live", u"2", u"--live-extra-segments", u"1", u"--duration", u"1", u"--playlist", playlist, ts::UString(_dir / "seg.ts")});
+
+    ts::hls::PlayList pl;
+    TSUNIT_ASSERT(pl.loadFile(playlist, true, ts::hls::PlayListType::UNKNOWN, CERR));
+    TSUNIT_ASSERT(pl.isMedia());
+    TSUNIT_EQUAL(2, pl.segmentCount());
+    TSUNIT_ASSERT(pl.endList());
+    debug() << "HLSOutputPluginTest::LiveWriter: media sequence: " << pl.mediaSequence() << std::endl;
+    TSUNIT_ASSERT(pl.mediaSequence() >= 2);
+
+    // The playlist, the two live segments and one extra segment only, no temporary file.
+    const std::set<ts::UString> files(outputFiles());
+    for (const auto& name : files) {
+        debug() << "HLSOutputPluginTest::LiveWriter: output file: " << name << std::endl;
+    }
+    TSUNIT_EQUAL(4, files.size());
+    TSUNIT_ASSERT(files.contains(u"live.m3u8"));
+    for (size_t i = 0; i < pl.segmentCount(); ++i) {
+        TSUNIT_ASSERT(fs::exists(pl.segment(i).file_path));
+        TSUNIT_ASSERT(files.contains(pl.segment(i).relative_uri));
+    }
+}
+
+// Two renditions in one pass, with aligned segments.
+TSUNIT_DEFINE_TEST(Renditions)
+{
+    const ts::UString master(_dir / "master.m3u8");
+    runHLS({u"--rendition", u"1", u"--rendition", u"2", u"--duration", u"1", u"--playlist", master, ts::UString(_dir / "seg.ts")});
+
+    ts::hls::PlayList mpl;
+    TSUNIT_ASSERT(mpl.loadFile(master, true, ts::hls::PlayListType::UNKNOWN, CERR));
+    TSUNIT_ASSERT(mpl.isMaster());
+    TSUNIT_EQUAL(2, mpl.playListCount());
+
+    ts::hls::PlayList pl1, pl2;
+    TSUNIT_ASSERT(pl1.loadFile(mpl.playList(0).file_path, true, ts::hls::PlayListType::UNKNOWN, CERR));
+    TSUNIT_ASSERT(pl2.loadFile(mpl.playList(1).file_path, true, ts::hls::PlayListType::UNKNOWN, CERR));
+    TSUNIT_ASSERT(pl1.endList());
+    TSUNIT_ASSERT(pl2.endList());
+
+    // Four seconds of content in segments of one second, aligned in the two renditions.
+    debug() << "HLSOutputPluginTest::Renditions: segments: " << pl1.segmentCount() << ", " << pl2.segmentCount() << std::endl;
+    TSUNIT_ASSERT(pl1.segmentCount() >= 3);
+    TSUNIT_EQUAL(pl1.segmentCount(), pl2.segmentCount());
+    for (size_t i = 0; i < pl1.segmentCount(); ++i) {
+        TSUNIT_ASSERT(std::abs((pl1.segment(i).duration - pl2.segment(i).duration).count()) <= 20);
+    }
+
+    // Each rendition contains its own service only, with the ECM PID.
+    ts::PIDSet pids1, pids2;
+    loadSegmentPIDs(pl1, pids1);
+    loadSegmentPIDs(pl2, pids2);
+    TSUNIT_EQUAL(4, pids1.count());
+    TSUNIT_ASSERT(pids1.test(ts::PID_PAT));
+    TSUNIT_ASSERT(pids1.test(PMT1_PID));
+    TSUNIT_ASSERT(pids1.test(VIDEO1_PID));
+    TSUNIT_ASSERT(pids1.test(ECM1_PID));
+    TSUNIT_EQUAL(3, pids2.count());
+    TSUNIT_ASSERT(pids2.test(ts::PID_PAT));
+    TSUNIT_ASSERT(pids2.test(PMT2_PID));
+    TSUNIT_ASSERT(pids2.test(VIDEO2_PID));
+
+    // No temporary file is left.
+    for (const auto& name : outputFiles()) {
+        TSUNIT_ASSERT(!name.ends_with(u".tmp"));
+    }
+}
@@ -0,0 +1,244 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for XML-to-JSON conversion.
+//
+//----------------------------------------------------------------------------
+
+#include "tsxmlJSONConverter.h"
+#include "tsxmlElement.h"
+#include "tsSectionFile.h"
+#include "tsPSIRepository.h"
+#include "tsAbstractTable.h"
+#include "tsDuckContext.h"
+#include "tsTextFormatter.h"
+#include "tsjsonValue.h"
+#include "tsNullReport.h"
+#include "tsCerrReport.h"
+#include "utestTSUnitBenchmark.h"
+#include "tsunit.h"
+
+#include "tables/psi_bat_cplus_sections.h"
+#include "tables/psi_bat_tvnum_sections.h"
+#include "tables/psi_cat_r3_sections.h"
+#include "tables/psi_cat_r6_sections.h"
+#include "tables/psi_nit_tntv23_sections.h"
+#include "tables/psi_pat_r4_sections.h"
+#include "tables/psi_pmt_hevc_sections.h"
+#include "tables/psi_pmt_planete_sections.h"
+#include "tables/psi_pmt_scte35_sections.h"
+#include "tables/psi_sdt_r3_sections.h"
+#include "tables/psi_tdt_tnt_sections.h"
+#include "tables/psi_tot_tnt_sections.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class JSONConverterTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(RegisteredTables);
+    TSUNIT_DECLARE_TEST(SampleTables);
+    TSUNIT_DECLARE_TEST(Tweaks);
+    TSUNIT_DECLARE_TEST(Benchmark);
+
+private:
+    // Build a document with all sample tables.
+    static void BuildSampleDocument(ts::xml::Document& doc);
+
+    // Check that the streaming JSON output is identical to the JSON object output, for an element and all its children.
+    static void CheckElement(const ts::xml::JSONConverter& conv, const ts::xml::Element* elem, const ts::json::Value& value);
+
+    // Check a complete document with the root and each top-level element.
+    static void CheckDocument(const ts::xml::JSONConverter& conv, const ts::xml::Document& doc);
+
+    // Print a JSON value or an XML element in JSON format with indentation.
+    static ts::UString Print(const ts::json::Value& value);
+    static ts::UString Print(const ts::xml::JSONConverter& conv, const ts::xml::Element* elem);
+};
+
+TSUNIT_REGISTER(JSONConverterTest);
+
+
+//----------------------------------------------------------------------------
+// Test helpers.
+//----------------------------------------------------------------------------
+
+ts::UString JSONConverterTest::Print(const ts::json::Value& value)
+{
+    ts::TextFormatter out(NULLREP);
+    out.setString();
+    value.print(out);
+    return out.toString();
+}
+
+ts::UString JSONConverterTest::Print(const ts::xml::JSONConverter& conv, const ts::xml::Element* elem)
+{
+    ts::TextFormatter out(NULLREP);
+    out.setString();
+    conv.printJSON(out, elem);
+    return out.toString();
+}
+
+void JSONConverterTest::CheckElement(const ts::xml::JSONConverter& conv, const ts::xml::Element* elem, const ts::json::Value& value)
+{
+    TSUNIT_EQUAL(value.oneLiner(NULLREP), conv.oneLinerJSON(elem));
+    TSUNIT_EQUAL(Print(value), Print(conv, elem));
+}
+
+void JSONConverterTest::CheckDocument(const ts::xml::JSONConverter& conv, const ts::xml::Document& doc)
+{
+    const ts::json::ValuePtr root(conv.convertToJSON(doc, true));
+    TSUNIT_ASSERT(root != nullptr);
+    CheckElement(conv, doc.rootElement(), *root);
+
+    // Each top-level element, the model is searched from the document root.
+    size_t index = 0;
+    for (const ts::xml::Element* elem = doc.rootElement()->firstChildElement(); elem != nullptr; elem = elem->nextSiblingElement()) {
+        CheckElement(conv, elem, root->query(ts::UString::Format(u"#nodes[%d]", index++)));
+    }
+}
+
+void JSONConverterTest::BuildSampleDocument(ts::xml::Document& doc)
+{
+    ts::DuckContext duck;
+    ts::SectionFile file(duck);
+    TSUNIT_ASSERT(file.loadBuffer(psi_bat_cplus_sections, sizeof(psi_bat_cplus_sections)));
+    TSUNIT_ASSERT(file.loadBuffer(psi_bat_tvnum_sections, sizeof(psi_bat_tvnum_sections)));
+    TSUNIT_ASSERT(file.loadBuffer(psi_cat_r3_sections, sizeof(psi_cat_r3_sections)));
+    TSUNIT_ASSERT(file.loadBuffer(psi_cat_r6_sections, sizeof(psi_cat_r6_sections)));
+    TSUNIT_ASSERT(file.loadBuffer(psi_nit_tntv23_sections, sizeof(psi_nit_tntv23_sections)));
+    TSUNIT_ASSERT(file.loadBuffer(psi_pat_r4_sections, sizeof(psi_pat_r4_sections)));
+    TSUNIT_ASSERT(file.loadBuffer(psi_pmt_hevc_sections, sizeof(psi_pmt_hevc_sections)));
+    TSUNIT_ASSERT(file.loadBuffer(psi_pmt_planete_sections, sizeof(psi_pmt_planete_sections)));
+    TSUNIT_ASSERT(file.loadBuffer(psi_pmt_scte35_sections, sizeof(psi_pmt_scte35_sections)));
+    TSUNIT_ASSERT(file.loadBuffer(psi_sdt_r3_sections, sizeof(psi_sdt_r3_sections)));
+    TSUNIT_ASSERT(file.loadBuffer(psi_tdt_tnt_sections, sizeof(psi_tdt_tnt_sections)));
+    TSUNIT_ASSERT(file.loadBuffer(psi_tot_tnt_sections, sizeof(psi_tot_tnt_sections)));
+    TSUNIT_ASSERT(!file.tables().empty());
+
+    doc.initialize(u"tsduck");
+    for (const auto& table : file.tables()) {
+        TSUNIT_ASSERT(table->toXML(duck, doc.rootElement()) != nullptr);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(RegisteredTables)
+{
+    ts::xml::JSONConverter conv(CERR);
+    TSUNIT_ASSERT(ts::SectionFile::LoadModel(conv));
+
+    // Serialize a default instance of all registered tables.
+    ts::DuckContext duck;
+    ts::xml::Document doc(NULLREP);
+    doc.initialize(u"tsduck");
+
+    ts::UStringList names;
+    ts::PSIRepository::Instance().getRegisteredTableNames(names);
+    TSUNIT_ASSERT(!names.empty());
+
+    size_t count = 0;
+    for (const auto& name : names) {
+        const auto factory = ts::PSIRepository::Instance().getTable(name).factory;
+        if (factory != nullptr) {
+            const ts::AbstractTablePtr table(factory());
+            if (table != nullptr && table->toXML(duck, doc.rootElement()) != nullptr) {
+                count++;
+            }
+        }
+    }
+    debug() << "JSONConverterTest::RegisteredTables: " << count << " tables out of " << names.size() << std::endl;
+    TSUNIT_ASSERT(count > 0);
+    CheckDocument(conv, doc);
+}
+
+TSUNIT_DEFINE_TEST(SampleTables)
+{
+    ts::xml::JSONConverter conv(CERR);
+    TSUNIT_ASSERT(ts::SectionFile::LoadModel(conv));
+
+    ts::xml::Document doc(NULLREP);
+    BuildSampleDocument(doc);
+    CheckDocument(conv, doc);
+
+    // Without model, all attributes are strings.
+    ts::xml::JSONConverter noModel(CERR);
+    CheckDocument(noModel, doc);
+
+    // Null element.
+    TSUNIT_EQUAL(u"null", conv.oneLinerJSON(nullptr));
+}
+
+TSUNIT_DEFINE_TEST(Tweaks)
+{
+    ts::xml::JSONConverter conv(NULLREP);
+    TSUNIT_ASSERT(ts::SectionFile::LoadModel(conv));
+
+    ts::xml::Document doc(NULLREP);
+    TSUNIT_ASSERT(doc.parse(
+        u"<?xml version='1.0' encoding='UTF-8'?>\n"
+        u"<tsduck>\n"
+        u"  <!-- comment -->\n"
+        u"  <PAT version='3' current='maybe' transport_stream_id='foo' network_PID='0x10' other='true'>\n"
+        u"    <service service_id='-0x100000000' program_map_PID='1,234' extra='12'/>\n"
+        u"  </PAT>\n"
+        u"  <generic_short_table table_id='0xAB' private='false'>\n"
+        u"    01 23  45\n"
+        u"    67 89\n"
+        u"  </generic_short_table>\n"
+        u"  <unknown a='1' b='no'>  some \"text\"  <child/>  </unknown>\n"
+        u"  <empty/>\n"
+        u"</tsduck>\n"));
+
+    ts::xml::Tweaks tweaks;
+    for (int mask = 0; mask < 16; ++mask) {
+        tweaks.x2jEnforceInteger = (mask & 1) != 0;
+        tweaks.x2jEnforceBoolean = (mask & 2) != 0;
+        tweaks.x2jTrimText = (mask & 4) != 0;
+        tweaks.x2jCollapseText = (mask & 8) != 0;
+        conv.setTweaks(tweaks);
+        CheckDocument(conv, doc);
+    }
+}
+
+TSUNIT_DEFINE_TEST(Benchmark)
+{
+    // Default: 1 iteration, typically for a quick functional test.
+    // The environment variable TSUNIT_JSON_ITERATIONS can be used to specify a larger number of iterations.
+    utest::TSUnitBenchmark bench1(u"TSUNIT_JSON_ITERATIONS");
+    utest::TSUnitBenchmark bench2(u"TSUNIT_JSON_ITERATIONS");
+
+    ts::xml::JSONConverter conv(NULLREP);
+    TSUNIT_ASSERT(ts::SectionFile::LoadModel(conv));
+
+    ts::xml::Document doc(NULLREP);
+    BuildSampleDocument(doc);
+
+    for (size_t i = 0; i < bench1.iterations; ++i) {
+        bench1.start();
+        const ts::json::ValuePtr root(conv.convertToJSON(doc, true));
+        for (size_t index = 0; index < doc.rootElement()->childrenCount(); ++index) {
+            root->query(ts::UString::Format(u"#nodes[%d]", index)).oneLiner(NULLREP);
+        }
+        bench1.stop();
+        bench2.start();
+        for (const ts::xml::Element* elem = doc.rootElement()->firstChildElement(); elem != nullptr; elem = elem->nextSiblingElement()) {
+            conv.oneLinerJSON(elem);
+        }
+        bench2.stop();
+    }
+
+    bench1.report(u"JSONConverter::convertToJSON() + oneLiner()");
+    bench2.report(u"JSONConverter::oneLinerJSON()");
+}
@@ -12,6 +12,7 @@
 
 #include "tsMemory.h"
 #include "tsunit.h"
+#include "utestTSUnitBenchmark.h"
 
 
 //----------------------------------------------------------------------------
@@ -72,6 +73,9 @@ class MemoryTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(PutIntVarLE);
     TSUNIT_DECLARE_TEST(LocatePattern);
     TSUNIT_DECLARE_TEST(LocateZeroZero);
+    TSUNIT_DECLARE_TEST(LocatePatternVector);
+    TSUNIT_DECLARE_TEST(LocateAllZeroZero);
+    TSUNIT_DECLARE_TEST(StartCodeBenchmark);
     TSUNIT_DECLARE_TEST(Xor);
 };
 
@@ -472,6 +476,164 @@ TSUNIT_DEFINE_TEST(LocateZeroZero)
     TSUNIT_ASSERT(ts::LocateZeroZero(data2, sizeof(data2) - 1, 12) == nullptr);
 }
 
+namespace {
+    // Build a pseudo-random data area with many zeroes. Use a simple LCG for reproducibility.
+    void BuildRandomArea(std::vector<uint8_t>& data, size_t size, uint32_t seed, uint32_t zero_ratio)
+    {
+        data.resize(size);
+        for (auto& b : data) {
+            seed = seed * 1103515245 + 12345;
+            b = (seed >> 16) % zero_ratio == 0 ? 0x00 : uint8_t(seed >> 24);
+        }
+    }
+
+    // Reference implementations, byte by byte.
+    const uint8_t* ReferencePattern(const uint8_t* area, size_t area_size, const uint8_t* pattern, size_t pattern_size)
+    {
+        const uint8_t* const end = area + area_size;
+        const uint8_t* const p = std::search(area, end, pattern, pattern + pattern_size);
+        return p == end ? nullptr : p;
+    }
+
+    void ReferenceAllZeroZero(std::vector<size_t>& offsets, const uint8_t* area, size_t area_size, uint8_t max_third)
+    {
+        offsets.clear();
+        for (size_t i = 0; i + 3 <= area_size; ++i) {
+            if (area[i] == 0 && area[i + 1] == 0 && area[i + 2] <= max_third) {
+                offsets.push_back(i);
+            }
+        }
+    }
+}
+
+TSUNIT_DEFINE_TEST(LocatePatternVector)
+{
+    // The vector implementations process 16 or 32 bytes at a time.
+    // Check all alignments and sizes around these values, and the end of the area.
+    std::vector<uint8_t> data;
+    BuildRandomArea(data, 300, 1, 4);
+
+    for (size_t psize = 2; psize <= 40; psize += 3) {
+        for (size_t start = 0; start + psize <= data.size(); start += 7) {
+            const uint8_t* const pattern = data.data() + start;
+            for (size_t offset = 0; offset < 40; offset += 13) {
+                if (offset <= start) {
+                    const uint8_t* const area = data.data() + offset;
+                    const size_t area_size = data.size() - offset;
+                    TSUNIT_ASSERT(ts::LocatePattern(area, area_size, pattern, psize) == ReferencePattern(area, area_size, pattern, psize));
+                    // Truncated area, the pattern may be only partially present at the end.
+                    const size_t short_size = start - offset + psize - 1;
+                    TSUNIT_ASSERT(ts::LocatePattern(area, short_size, pattern, psize) == ReferencePattern(area, short_size, pattern, psize));
+                }
+            }
+        }
+    }
+
+    // Pattern at the very end of the area.
+    static const uint8_t pattern[] = {0xDE, 0xAD, 0xBE, 0xEF};
+    std::vector<uint8_t> area(100, 0xDE);
+    ts::MemCopy(area.data() + area.size() - sizeof(pattern), pattern, sizeof(pattern));
+    TSUNIT_ASSERT(ts::LocatePattern(area.data(), area.size(), pattern, sizeof(pattern)) == area.data() + area.size() - sizeof(pattern));
+    TSUNIT_ASSERT(ts::LocatePattern(area.data(), area.size() - 1, pattern, sizeof(pattern)) == nullptr);
+}
+
+TSUNIT_DEFINE_TEST(LocateAllZeroZero)
+{
+    std::vector<size_t> offsets;
+    TSUNIT_EQUAL(0, ts::LocateAllZeroZero(offsets, data1, 0));
+    TSUNIT_EQUAL(1, ts::LocateAllZeroZero(offsets, data1, sizeof(data1)));
+    TSUNIT_EQUAL(21, offsets[0]);
+    TSUNIT_EQUAL(0, ts::LocateAllZeroZero(offsets, data2, sizeof(data2), 0x01));
+    TSUNIT_EQUAL(2, ts::LocateAllZeroZero(offsets, data2, sizeof(data2), 0x0C));
+    TSUNIT_EQUAL(0, offsets[0]);
+    TSUNIT_EQUAL(61, offsets[1]);
+
+    // Overlapping patterns.
+    static const uint8_t data3[] = {0x00, 0x00, 0x00, 0x01, 0x67, 0x00, 0x00, 0x01};
+    TSUNIT_EQUAL(3, ts::LocateAllZeroZero(offsets, data3, sizeof(data3)));
+    TSUNIT_ASSERT(offsets == std::vector<size_t>({0, 1, 5}));
+
+    // Compare with the reference implementation on all area sizes and alignments.
+    std::vector<uint8_t> data;
+    std::vector<size_t> ref;
+    BuildRandomArea(data, 300, 2, 3);
+    for (size_t offset = 0; offset < 40; ++offset) {
+        for (size_t size = 0; offset + size <= data.size(); size += 5) {
+            for (uint8_t max : std::initializer_list<uint8_t>{0x00, 0x01, 0x80, 0xFF}) {
+                ts::LocateAllZeroZero(offsets, data.data() + offset, size, max);
+                ReferenceAllZeroZero(ref, data.data() + offset, size, max);
+                TSUNIT_ASSERT(offsets == ref);
+                const uint8_t* first = ts::LocateZeroZero(data.data() + offset, size, max);
+                ReferenceAllZeroZero(ref, data.data() + offset, size, 0xFF);
+                auto it = std::find_if(ref.begin(), ref.end(), [&](size_t i) { return data[offset + i + 2] == max; });
+                TSUNIT_ASSERT(first == (it == ref.end() ? nullptr : data.data() + offset + *it));
+            }
+        }
+    }
+}
+
+TSUNIT_DEFINE_TEST(StartCodeBenchmark)
+{
+    // Simulated 1 MB of H.264 PES payload: random bytes without 00 00 0x sequences
+    // (like after emulation prevention), with a start code prefix every 1000 bytes (average NALunit size).
+    // The number of iterations is in TSUNIT_START_CODE_ITERATIONS. Use 1024 to process 1 GB of data.
+    std::vector<uint8_t> data;
+    BuildRandomArea(data, 1024 * 1024, 3, 64);
+    for (size_t i = 2; i < data.size(); ++i) {
+        if (data[i - 2] == 0 && data[i - 1] == 0 && data[i] <= 0x03) {
+            data[i] = 0x03;
+        }
+    }
+    size_t start_codes = 0;
+    for (size_t i = 100; i + 4 < data.size(); i += 1000) {
+        data[i - 1] = 0x80;
+        data[i] = data[i + 1] = 0x00;
+        data[i + 2] = 0x01;
+        data[i + 3] = 0x65;
+        start_codes++;
+    }
+    std::vector<size_t> ref;
+    ReferenceAllZeroZero(ref, data.data(), data.size(), 0x01);
+    TSUNIT_EQUAL(start_codes, ref.size());
+
+    // Locate all start codes, one by one.
+    utest::TSUnitBenchmark bench1(u"TSUNIT_START_CODE_ITERATIONS");
+    size_t count1 = 0;
+    bench1.start();
+    for (size_t iter = 0; iter < bench1.iterations; ++iter) {
+        const uint8_t* const end = data.data() + data.size();
+        for (const uint8_t* p = ts::LocateZeroZero(data.data(), data.size(), 0x01); p != nullptr; p = ts::LocateZeroZero(p + 3, end - p - 3, 0x01)) {
+            count1++;
+        }
+    }
+    bench1.stop();
+    bench1.report(u"MemoryTest::StartCodeBenchmark (LocateZeroZero)");
+    TSUNIT_EQUAL(start_codes * bench1.iterations, count1);
+
+    // Locate all start codes at once.
+    utest::TSUnitBenchmark bench2(u"TSUNIT_START_CODE_ITERATIONS");
+    std::vector<size_t> offsets;
+    size_t count2 = 0;
+    bench2.start();
+    for (size_t iter = 0; iter < bench2.iterations; ++iter) {
+        count2 += ts::LocateAllZeroZero(offsets, data.data(), data.size());
+    }
+    bench2.stop();
+    bench2.report(u"MemoryTest::StartCodeBenchmark (LocateAllZeroZero)");
+    TSUNIT_EQUAL(start_codes * bench2.iterations, count2);
+    TSUNIT_ASSERT(offsets == ref);
+
+    // Locate a 4-byte pattern which is not present.
+    static const uint8_t pattern[] = {0x47, 0x1F, 0xFF, 0x10};
+    utest::TSUnitBenchmark bench3(u"TSUNIT_START_CODE_ITERATIONS");
+    bench3.start();
+    for (size_t iter = 0; iter < bench3.iterations; ++iter) {
+        TSUNIT_ASSERT(ts::LocatePattern(data.data(), data.size(), pattern, sizeof(pattern)) == nullptr);
+    }
+    bench3.stop();
+    bench3.report(u"MemoryTest::StartCodeBenchmark (LocatePattern)");
+}
+
 TSUNIT_DEFINE_TEST(Xor)
 {
     static const uint8_t src1[] = {
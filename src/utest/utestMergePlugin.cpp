@@ -0,0 +1,97 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for the merge plugin.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSProcessor.h"
+#include "tsMemoryOutputPlugin.h"
+#include "tsPluginEventHandlerInterface.h"
+#include "tsCerrReport.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class MergePluginTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(InProcess);
+};
+
+TSUNIT_REGISTER(MergePluginTest);
+
+
+//----------------------------------------------------------------------------
+// An event handler for memory output plugin: collect packets and metadata.
+//----------------------------------------------------------------------------
+
+namespace {
+    class Output : public ts::PluginEventHandlerInterface
+    {
+        TS_NOCOPY(Output);
+    public:
+        Output() = default;
+        ts::TSPacketVector packets {};
+        ts::TSPacketMetadataVector metadata {};
+        virtual void handlePluginEvent(const ts::PluginEventContext& context) override;
+    };
+
+    void Output::handlePluginEvent(const ts::PluginEventContext& context)
+    {
+        ts::MemoryOutputEventData* data = dynamic_cast<ts::MemoryOutputEventData*>(context.pluginData());
+        if (data != nullptr && data->metadata() != nullptr) {
+            packets.insert(packets.end(), data->packets(), data->packets() + data->packetCount());
+            metadata.insert(metadata.end(), data->metadata(), data->metadata() + data->packetCount());
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(InProcess)
+{
+    // The merged stream is produced by an in-process plugin chain which labels its packets.
+    // The main stream is infinite, the processing terminates after the end of the merged stream.
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"MergePluginTest";
+    opt.input = {u"null", {}};
+    opt.plugins = {
+        {u"merge", {u"--in-process", u"--terminate", u"--no-psi-merge", u"--", u"-I craft --count 500 --pid 100 -P filter --pid 100 --set-label 5"}},
+    };
+    opt.output = {u"memory", {}};
+
+    Output output;
+    ts::TSProcessor tsproc(CERR);
+    tsproc.registerEventHandler(&output, ts::PluginType::OUTPUT);
+    TSUNIT_ASSERT(tsproc.start(opt));
+    tsproc.waitForTermination();
+
+    // All merged packets replace null packets and keep the labels from the plugin chain.
+    debug() << "MergePluginTest::InProcess: output packets: " << output.packets.size() << std::endl;
+    TSUNIT_EQUAL(output.packets.size(), output.metadata.size());
+    size_t merged = 0;
+    for (size_t i = 0; i < output.packets.size(); ++i) {
+        const ts::PID pid = output.packets[i].getPID();
+        TSUNIT_ASSERT(pid == ts::PID_NULL || pid == 100);
+        if (pid == 100) {
+            TSUNIT_EQUAL(merged & ts::CC_MASK, output.packets[i].getCC());
+            TSUNIT_ASSERT(output.metadata[i].hasLabel(5));
+            merged++;
+        }
+        else {
+            TSUNIT_ASSERT(!output.metadata[i].hasAnyLabel());
+        }
+    }
+    TSUNIT_EQUAL(500, merged);
+}
@@ -0,0 +1,120 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::PCRAnalyzer
+//
+//----------------------------------------------------------------------------
+
+#include "tsPCRAnalyzer.h"
+#include "tsunit.h"
+#include "utestTSUnitBenchmark.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PCRAnalyzerTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(SingleClock);
+    TSUNIT_DECLARE_TEST(MultiClock);
+    TSUNIT_DECLARE_TEST(Benchmark);
+
+private:
+    // With this bitrate, the duration of a packet is exactly 2000 PCR units.
+    static constexpr uint64_t BITRATE = 20'304'000;
+    static constexpr uint64_t PCR_PER_PACKET = 2000;
+
+    // Build a constant bitrate MPTS. Each program has one PCR PID.
+    // When 'same_clock' is false, all programs use unrelated clocks.
+    static void BuildMPTS(ts::TSPacketVector& packets, size_t packet_count, size_t program_count, bool same_clock);
+};
+
+TSUNIT_REGISTER(PCRAnalyzerTest);
+
+
+//----------------------------------------------------------------------------
+// Build a constant bitrate MPTS.
+//----------------------------------------------------------------------------
+
+void PCRAnalyzerTest::BuildMPTS(ts::TSPacketVector& packets, size_t packet_count, size_t program_count, bool same_clock)
+{
+    packets.resize(packet_count);
+    for (size_t i = 0; i < packet_count; ++i) {
+        // One packet per program, in sequence, with a PCR every 10 packets per PID.
+        const size_t prog = i % program_count;
+        const uint64_t offset = same_clock ? 0 : (prog * 0x0123456789) % ts::PCR_SCALE;
+        ts::TSPacket& pkt(packets[i]);
+        pkt = ts::NullPacket;
+        pkt.setPID(ts::PID(0x100 + prog));
+        pkt.setCC(uint8_t((i / program_count) & ts::CC_MASK));
+        if ((i / program_count) % 10 == 0) {
+            pkt.setPCR((offset + i * PCR_PER_PACKET) % ts::PCR_SCALE, true);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(SingleClock)
+{
+    ts::TSPacketVector packets;
+    BuildMPTS(packets, 50'000, 4, true);
+
+    ts::PCRAnalyzer zer(1, 16);
+    for (const auto& pkt : packets) {
+        zer.feedPacket(pkt);
+    }
+    TSUNIT_ASSERT(zer.bitrateIsValid());
+    TSUNIT_EQUAL(BITRATE, zer.bitrate188().toInt());
+    TSUNIT_EQUAL(BITRATE, zer.instantaneousBitrate188().toInt());
+}
+
+TSUNIT_DEFINE_TEST(MultiClock)
+{
+    // With unrelated clocks, the instantaneous bitrate is evaluated in each clock domain.
+    ts::TSPacketVector packets;
+    BuildMPTS(packets, 50'000, 4, false);
+
+    ts::PCRAnalyzer zer(1, 16);
+    for (const auto& pkt : packets) {
+        zer.feedPacket(pkt);
+        if (zer.bitrateIsValid()) {
+            TSUNIT_EQUAL(BITRATE, zer.instantaneousBitrate188().toInt());
+        }
+    }
+    TSUNIT_ASSERT(zer.bitrateIsValid());
+    TSUNIT_EQUAL(BITRATE, zer.bitrate188().toInt());
+    TSUNIT_EQUAL(BITRATE, zer.instantaneousBitrate188().toInt());
+}
+
+TSUNIT_DEFINE_TEST(Benchmark)
+{
+    // Analyze a 50-program MPTS with unrelated clocks.
+    // The number of iterations is in TSUNIT_PCR_ANALYZER_ITERATIONS.
+    ts::TSPacketVector packets;
+    BuildMPTS(packets, 100'000, 50, false);
+
+    utest::TSUnitBenchmark bench(u"TSUNIT_PCR_ANALYZER_ITERATIONS");
+    ts::PCRAnalyzer zer(1, 16);
+    bench.start();
+    for (size_t iter = 0; iter < bench.iterations; ++iter) {
+        zer.reset();
+        for (const auto& pkt : packets) {
+            zer.feedPacket(pkt);
+        }
+    }
+    bench.stop();
+    bench.report(u"PCRAnalyzerTest::Benchmark");
+
+    TSUNIT_ASSERT(zer.bitrateIsValid());
+    TSUNIT_EQUAL(BITRATE, zer.instantaneousBitrate188().toInt());
+}
@@ -0,0 +1,224 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::PIDMap
+//
+//----------------------------------------------------------------------------
+
+#include "tsPIDMap.h"
+#include "tsAlgorithm.h"
+#include "tsunit.h"
+#include "utestTSUnitBenchmark.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PIDMapTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Basic);
+    TSUNIT_DECLARE_TEST(Iterator);
+    TSUNIT_DECLARE_TEST(Copy);
+    TSUNIT_DECLARE_TEST(Benchmark);
+
+private:
+    // Simulate a per-packet context lookup on a sequence of PID's, return a checksum.
+    template <class MAP>
+    static uint64_t PacketLoop(MAP& map, const std::vector<ts::PID>& pids, size_t iterations);
+};
+
+TSUNIT_REGISTER(PIDMapTest);
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Basic)
+{
+    ts::PIDMap<int> map;
+    TSUNIT_ASSERT(map.empty());
+    TSUNIT_EQUAL(0, map.size());
+    TSUNIT_ASSERT(!map.contains(100));
+    TSUNIT_ASSERT(map.find(100) == map.end());
+    TSUNIT_ASSERT(map.value(100) == nullptr);
+    TSUNIT_ASSERT(map.begin() == map.end());
+
+    map[100] = 12;
+    TSUNIT_ASSERT(!map.empty());
+    TSUNIT_EQUAL(1, map.size());
+    TSUNIT_ASSERT(map.contains(100));
+    TSUNIT_EQUAL(1, map.count(100));
+    TSUNIT_EQUAL(0, map.count(101));
+    TSUNIT_EQUAL(12, map[100]);
+    TSUNIT_ASSERT(map.value(100) != nullptr);
+    TSUNIT_EQUAL(12, *map.value(100));
+
+    // Default-constructed value.
+    TSUNIT_EQUAL(0, map[ts::PID_NULL]);
+    TSUNIT_EQUAL(2, map.size());
+
+    // Insert does not replace.
+    const auto res1 = map.insert(std::make_pair(ts::PID(100), 47));
+    TSUNIT_ASSERT(!res1.second);
+    TSUNIT_EQUAL(100, res1.first->first);
+    TSUNIT_EQUAL(12, res1.first->second);
+    const auto res2 = map.emplace(0, 47);
+    TSUNIT_ASSERT(res2.second);
+    TSUNIT_EQUAL(47, map[0]);
+    TSUNIT_EQUAL(3, map.size());
+
+    // References remain valid.
+    int& ref(map[100]);
+    for (ts::PID pid = 200; pid < 300; ++pid) {
+        map[pid] = pid;
+    }
+    TSUNIT_EQUAL(12, ref);
+    TSUNIT_EQUAL(103, map.size());
+
+    // Out of range PID's are never found.
+    TSUNIT_ASSERT(!map.contains(ts::PID_MAX));
+    TSUNIT_ASSERT(map.find(0xFFFF) == map.end());
+    TSUNIT_EQUAL(0, map.erase(0xFFFF));
+
+    TSUNIT_EQUAL(1, map.erase(100));
+    TSUNIT_EQUAL(0, map.erase(100));
+    TSUNIT_ASSERT(!map.contains(100));
+    TSUNIT_EQUAL(102, map.size());
+
+    map.clear();
+    TSUNIT_ASSERT(map.empty());
+    TSUNIT_ASSERT(!map.contains(200));
+    TSUNIT_ASSERT(map.begin() == map.end());
+}
+
+TSUNIT_DEFINE_TEST(Iterator)
+{
+    ts::PIDMap<ts::UString> map;
+    const std::vector<ts::PID> pids {ts::PID_NULL, 0, 63, 64, 65, 1000, 127, 128};
+    for (auto pid : pids) {
+        map[pid] = ts::UString::Decimal(pid);
+    }
+
+    // Iteration in PID order.
+    std::vector<ts::PID> sorted(pids);
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<ts::PID> found;
+    for (const auto& it : map) {
+        TSUNIT_EQUAL(ts::UString::Decimal(it.first), it.second);
+        found.push_back(it.first);
+    }
+    TSUNIT_ASSERT(found == sorted);
+
+    // Compatibility with algorithms on std::map.
+    const std::set<ts::PID> keys(ts::MapKeysSet(map));
+    TSUNIT_EQUAL(pids.size(), keys.size());
+    TSUNIT_ASSERT(keys.contains(ts::PID_NULL));
+
+    const ts::PIDSet set(map.pidSet());
+    TSUNIT_EQUAL(pids.size(), set.count());
+    TSUNIT_ASSERT(set.test(1000));
+
+    // Erase during iteration.
+    for (auto it = map.begin(); it != map.end(); ) {
+        if (it->first % 2 != 0) {
+            it = map.erase(it);
+        }
+        else {
+            it->second.append(u"!");
+            ++it;
+        }
+    }
+    found.clear();
+    for (const auto& it : map) {
+        TSUNIT_EQUAL(ts::UString::Decimal(it.first) + u"!", it.second);
+        found.push_back(it.first);
+    }
+    TSUNIT_ASSERT(found == std::vector<ts::PID>({0, 64, 128, 1000}));
+
+    // Const iteration.
+    const ts::PIDMap<ts::UString>& cmap(map);
+    ts::PIDMap<ts::UString>::const_iterator cit = cmap.begin();
+    TSUNIT_EQUAL(0, cit->first);
+    ++cit;
+    TSUNIT_EQUAL(64, cit->first);
+    TSUNIT_ASSERT(cmap.find(128) != cmap.end());
+}
+
+TSUNIT_DEFINE_TEST(Copy)
+{
+    ts::PIDMap<int> map1;
+    map1[10] = 1;
+    map1[20] = 2;
+
+    ts::PIDMap<int> map2(map1);
+    map2[10] = 3;
+    TSUNIT_EQUAL(1, map1[10]);
+    TSUNIT_EQUAL(3, map2[10]);
+    TSUNIT_EQUAL(2, map2.size());
+
+    ts::PIDMap<int> map3(std::move(map2));
+    TSUNIT_ASSERT(map2.empty());
+    TSUNIT_EQUAL(2, map3.size());
+    TSUNIT_EQUAL(3, map3[10]);
+
+    map2 = map1;
+    TSUNIT_EQUAL(2, map2.size());
+    TSUNIT_EQUAL(2, map2[20]);
+
+    map1 = std::move(map3);
+    TSUNIT_ASSERT(map3.empty());
+    TSUNIT_EQUAL(3, map1[10]);
+}
+
+
+//----------------------------------------------------------------------------
+// Compare per-packet lookup in std::map and PIDMap.
+//----------------------------------------------------------------------------
+
+template <class MAP>
+uint64_t PIDMapTest::PacketLoop(MAP& map, const std::vector<ts::PID>& pids, size_t iterations)
+{
+    uint64_t sum = 0;
+    for (size_t iter = 0; iter < iterations; ++iter) {
+        for (auto pid : pids) {
+            sum += ++map[pid];
+        }
+    }
+    return sum;
+}
+
+TSUNIT_DEFINE_TEST(Benchmark)
+{
+    // A typical MPTS has a few tens of PID's. Build a pseudo-random sequence of packets on 60 PID's.
+    // The number of iterations is in TSUNIT_PIDMAP_ITERATIONS.
+    std::vector<ts::PID> pids(100'000);
+    uint32_t seed = 1;
+    for (auto& pid : pids) {
+        seed = seed * 1103515245 + 12345;
+        pid = ts::PID(0x100 + 7 * ((seed >> 16) % 60));
+    }
+
+    std::map<ts::PID, uint64_t> map1;
+    utest::TSUnitBenchmark bench1(u"TSUNIT_PIDMAP_ITERATIONS");
+    bench1.start();
+    const uint64_t sum1 = PacketLoop(map1, pids, bench1.iterations);
+    bench1.stop();
+    bench1.report(u"PIDMapTest::Benchmark (std::map)");
+
+    ts::PIDMap<uint64_t> map2;
+    utest::TSUnitBenchmark bench2(u"TSUNIT_PIDMAP_ITERATIONS");
+    bench2.start();
+    const uint64_t sum2 = PacketLoop(map2, pids, bench2.iterations);
+    bench2.stop();
+    bench2.report(u"PIDMapTest::Benchmark (PIDMap)");
+
+    TSUNIT_EQUAL(sum1, sum2);
+    TSUNIT_EQUAL(map1.size(), map2.size());
+}
@@ -0,0 +1,161 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for PacingTimer.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPacingTimer.h"
+#include "tsUDPSocket.h"
+#include "tsIPUtils.h"
+#include "tsCerrReport.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PacingTimerTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Wait);
+    TSUNIT_DECLARE_TEST(Past);
+    TSUNIT_DECLARE_TEST(Loopback);
+};
+
+TSUNIT_REGISTER(PacingTimerTest);
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Wait)
+{
+    // No spin phase by default, the precision is the one of the system timers.
+    ts::PacingTimer timer;
+    TSUNIT_EQUAL(0, timer.waitCount());
+    TSUNIT_EQUAL(0, timer.spinDuration().count());
+    TSUNIT_ASSERT(timer.precision() >= cn::milliseconds(2));
+
+    // With a spin phase, the precision is better.
+    timer.setSpinDuration(cn::microseconds(100));
+    TSUNIT_EQUAL(100'000, timer.spinDuration().count());
+    TSUNIT_ASSERT(timer.precision() > cn::nanoseconds::zero());
+
+    // A wait never returns before its deadline. However, when the thread is preempted after computing
+    // the deadline, the deadline may be already passed and the wait is not counted. Only check that
+    // some waits are counted and that the statistics are consistent.
+    constexpr size_t count = 50;
+    for (size_t i = 0; i < count; ++i) {
+        const ts::monotonic_time due = ts::monotonic_time::clock::now() + cn::milliseconds(1);
+        timer.waitUntil(due);
+        TSUNIT_ASSERT(ts::monotonic_time::clock::now() >= due);
+    }
+
+    debug() << "PacingTimerTest::Wait: " << timer.statistics() << std::endl;
+    TSUNIT_ASSERT(timer.waitCount() > 0);
+    TSUNIT_ASSERT(timer.waitCount() <= count);
+    TSUNIT_ASSERT(timer.meanLateness() >= cn::nanoseconds::zero());
+    TSUNIT_ASSERT(timer.maxLateness() >= timer.meanLateness());
+
+    timer.resetStatistics();
+    TSUNIT_EQUAL(0, timer.waitCount());
+    TSUNIT_EQUAL(0, timer.maxLateness().count());
+}
+
+TSUNIT_DEFINE_TEST(Past)
+{
+    ts::PacingTimer timer;
+    timer.setSpinDuration(cn::nanoseconds::zero());
+    TSUNIT_EQUAL(0, timer.spinDuration().count());
+
+    // A deadline in the past returns immediately and is not counted.
+    timer.waitUntil(ts::monotonic_time::clock::now() - cn::milliseconds(10));
+    TSUNIT_EQUAL(0, timer.waitCount());
+
+    // Without spin, only sleep. The deadline is far enough to be still in the future when waiting.
+    const ts::monotonic_time due = ts::monotonic_time::clock::now() + cn::milliseconds(100);
+    timer.waitUntil(due);
+    TSUNIT_ASSERT(ts::monotonic_time::clock::now() >= due);
+    TSUNIT_EQUAL(1, timer.waitCount());
+}
+
+// Check the pacing of datagrams on the loopback interface, using receive timestamps.
+TSUNIT_DEFINE_TEST(Loopback)
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    ts::UDPSocket receiver(true, ts::IP::v4);
+    TSUNIT_ASSERT(receiver.isOpen());
+    TSUNIT_ASSERT(receiver.setReceiveBufferSize(1024 * 1024, CERR));
+    TSUNIT_ASSERT(receiver.setReceiveTimestamps(true, CERR));
+    TSUNIT_ASSERT(receiver.setReceiveTimeout(cn::seconds(5), CERR));
+    TSUNIT_ASSERT(receiver.bind(ts::IPSocketAddress(ts::IPAddress::LocalHost4, ts::IPSocketAddress::AnyPort), CERR));
+    ts::IPSocketAddress local;
+    TSUNIT_ASSERT(receiver.getLocalAddress(local, CERR));
+
+    ts::UDPSocket sender(true, ts::IP::v4);
+    TSUNIT_ASSERT(sender.isOpen());
+    TSUNIT_ASSERT(sender.setDefaultDestination(ts::IPSocketAddress(ts::IPAddress::LocalHost4, local.port()), CERR));
+#if defined(TS_LINUX)
+    // The loopback interface has no queuing discipline, transmit times are ignored.
+    TSUNIT_ASSERT(sender.setTransmitTime(ts::TransmitClock::MONOTONIC, CERR));
+#endif
+
+    // The receive timestamps are on the system clock, the deadlines are on the monotonic clock.
+    const cn::microseconds clock_offset(cn::duration_cast<cn::microseconds>(cn::system_clock::now().time_since_epoch() - ts::monotonic_time::clock::now().time_since_epoch()));
+
+    // Send paced datagrams, with a spin phase.
+    constexpr size_t count = 100;
+    constexpr cn::microseconds interval(500);
+    ts::PacingTimer timer;
+    timer.setSpinDuration(cn::microseconds(100));
+    uint8_t data[188];
+    std::vector<cn::microseconds> due_times;
+    ts::monotonic_time due = ts::monotonic_time::clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        due += interval;
+        timer.waitUntil(due);
+        data[0] = uint8_t(i);
+        TSUNIT_ASSERT(sender.sendAt(data, sizeof(data), due, CERR));
+        due_times.push_back(cn::duration_cast<cn::microseconds>(due.time_since_epoch()) + clock_offset);
+    }
+    debug() << "PacingTimerTest::Loopback: sender: " << timer.statistics() << std::endl;
+
+    // Receive all datagrams, compute the lateness of each datagram, compared to its deadline.
+    // The clock offset is approximative, allow some tolerance.
+    constexpr cn::microseconds tolerance(100);
+    cn::microseconds previous(-1);
+    std::vector<cn::microseconds> lateness;
+    for (size_t i = 0; i < count; ++i) {
+        ts::IPSocketAddress from, to;
+        size_t size = 0;
+        cn::microseconds timestamp(-1);
+        TSUNIT_ASSERT(receiver.receive(data, sizeof(data), size, from, to, nullptr, CERR, &timestamp));
+        TSUNIT_EQUAL(sizeof(data), size);
+        TSUNIT_EQUAL(uint8_t(i), data[0]);
+        if (timestamp >= cn::microseconds::zero()) {
+            TSUNIT_ASSERT(timestamp >= previous);
+            previous = timestamp;
+            // A paced datagram is never sent before its deadline.
+            TSUNIT_ASSERT(timestamp >= due_times[i] - tolerance);
+            lateness.push_back(timestamp - due_times[i]);
+        }
+    }
+
+    // Without receive timestamps on this system, there is nothing more to check.
+    if (!lateness.empty()) {
+        // A few datagrams are late when the sender is preempted, the following ones are sent
+        // immediately to catch up with the deadlines. Most datagrams shall be on time.
+        std::sort(lateness.begin(), lateness.end());
+        const cn::microseconds median = lateness[lateness.size() / 2];
+        debug() << "PacingTimerTest::Loopback: lateness: median: " << median.count() << " us, max: " << lateness.back().count() << " us" << std::endl;
+        TSUNIT_ASSERT(median < cn::milliseconds(2));
+    }
+}
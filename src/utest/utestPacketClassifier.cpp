@@ -0,0 +1,343 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::PacketClassifier
+//
+//----------------------------------------------------------------------------
+
+#include "tsPacketClassifier.h"
+#include "tsDuckContext.h"
+#include "tsTSPacket.h"
+#include "tsTSPacketMetadata.h"
+#include "tsOneShotPacketizer.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PacketClassifierTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Verdicts);
+    TSUNIT_DECLARE_TEST(Predicates);
+    TSUNIT_DECLARE_TEST(StreamIds);
+    TSUNIT_DECLARE_TEST(Pattern);
+    TSUNIT_DECLARE_TEST(Ranges);
+    TSUNIT_DECLARE_TEST(Signalization);
+    TSUNIT_DECLARE_TEST(SignalizationHandler);
+
+private:
+    // Packetize a table and feed the packets into a classifier, starting at a given continuity counter.
+    static void feedTable(ts::DuckContext& duck, ts::PacketClassifier& pc, const ts::AbstractTable& table, ts::PID pid, uint8_t cc = 0);
+};
+
+TSUNIT_REGISTER(PacketClassifierTest);
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Verdicts)
+{
+    ts::DuckContext duck;
+    ts::PacketClassifier pc(duck);
+    ts::TSPacketMetadata mdata;
+    ts::TSPacket pkt;
+    pkt.init(100);
+
+    TSUNIT_ASSERT(!pc.needDemux());
+    TSUNIT_EQUAL(ts::PacketClassifier::DROP, pc.verdict(100));
+    TSUNIT_ASSERT(!pc.isSelected(pkt, mdata, 0));
+
+    pc.setVerdict(100, ts::PacketClassifier::PASS);
+    TSUNIT_EQUAL(ts::PacketClassifier::PASS, pc.verdict(100));
+    TSUNIT_ASSERT(pc.isSelected(pkt, mdata, 0));
+
+    constexpr ts::PacketClassifier::Verdict USER = ts::PacketClassifier::FIRST_USER_VERDICT + 3;
+    ts::PIDSet pids;
+    pids.set(200);
+    pids.set(300);
+    pc.setVerdict(pids, USER);
+    TSUNIT_EQUAL(USER, pc.verdict(200));
+    TSUNIT_EQUAL(USER, pc.verdict(300));
+    TSUNIT_EQUAL(ts::PacketClassifier::DROP, pc.verdict(400));
+
+    pc.setDefaultVerdict(ts::PacketClassifier::PASS);
+    TSUNIT_EQUAL(ts::PacketClassifier::PASS, pc.verdict(400));
+    TSUNIT_EQUAL(USER, pc.verdict(300));
+
+    pc.clearVerdict(300);
+    TSUNIT_EQUAL(ts::PacketClassifier::PASS, pc.verdict(300));
+    TSUNIT_EQUAL(USER, pc.verdict(200));
+
+    pc.clear();
+    TSUNIT_EQUAL(ts::PacketClassifier::DROP, pc.verdict(100));
+    TSUNIT_EQUAL(ts::PacketClassifier::DROP, pc.verdict(200));
+
+    // PID-level criteria on signalization require the demux.
+    pc.selectPIDClass(ts::PIDClass::VIDEO);
+    TSUNIT_ASSERT(pc.needDemux());
+}
+
+TSUNIT_DEFINE_TEST(Predicates)
+{
+    ts::DuckContext duck;
+    ts::PacketClassifier pc(duck);
+    ts::TSPacketMetadata mdata;
+    ts::TSPacket pkt;
+    pkt.init(100);
+
+    pc.selectPredicate(ts::PacketClassifier::Predicate::UNIT_START);
+    pc.selectPredicate(ts::PacketClassifier::Predicate::MAX_PAYLOAD, 100);
+    TSUNIT_ASSERT(!pc.needDemux());
+
+    // Per-packet predicates are evaluated on unselected PID's.
+    TSUNIT_EQUAL(ts::PacketClassifier::DROP, pc.verdict(100));
+    TSUNIT_ASSERT(!pc.isSelected(pkt, mdata, 0));
+    pkt.setPUSI();
+    TSUNIT_ASSERT(pc.isSelected(pkt, mdata, 1));
+    pkt.clearPUSI();
+    TSUNIT_ASSERT(!pc.isSelected(pkt, mdata, 2));
+    TSUNIT_ASSERT(pkt.setPayloadSize(100));
+    TSUNIT_ASSERT(pc.isSelected(pkt, mdata, 3));
+
+    // Labels.
+    pkt.init(200);
+    TSUNIT_ASSERT(!pc.isSelected(pkt, mdata, 4));
+    ts::TSPacketLabelSet labels;
+    labels.set(3);
+    labels.set(7);
+    pc.selectLabels(labels);
+    TSUNIT_ASSERT(!pc.isSelected(pkt, mdata, 5));
+    mdata.setLabel(7);
+    TSUNIT_ASSERT(pc.isSelected(pkt, mdata, 6));
+
+    // Explicit verdicts take precedence over predicates.
+    pc.setVerdict(200, ts::PacketClassifier::DROP);
+    TSUNIT_ASSERT(!pc.isSelected(pkt, mdata, 7));
+}
+
+TSUNIT_DEFINE_TEST(StreamIds)
+{
+    ts::DuckContext duck;
+    ts::PacketClassifier pc(duck);
+    ts::TSPacketMetadata mdata;
+    pc.selectStreamIds({0xE0});
+
+    // Start of a video PES packet.
+    ts::TSPacket pkt;
+    pkt.init(100, 0, 0);
+    pkt.setPUSI();
+    pkt.b[4] = 0x00;
+    pkt.b[5] = 0x00;
+    pkt.b[6] = 0x01;
+    pkt.b[7] = 0xE0;
+    TSUNIT_ASSERT(pc.isSelected(pkt, mdata, 0));
+
+    // Continuation of the same PES packet.
+    pkt.clearPUSI();
+    pkt.b[7] = 0x00;
+    TSUNIT_ASSERT(pc.isSelected(pkt, mdata, 1));
+
+    // Start of an audio PES packet on the same PID.
+    pkt.setPUSI();
+    pkt.b[7] = 0xC0;
+    TSUNIT_ASSERT(!pc.isSelected(pkt, mdata, 2));
+    pkt.clearPUSI();
+    TSUNIT_ASSERT(!pc.isSelected(pkt, mdata, 3));
+
+    // The PID state is reset on restart.
+    pkt.setPUSI();
+    pkt.b[7] = 0xE0;
+    TSUNIT_ASSERT(pc.isSelected(pkt, mdata, 4));
+    pc.restart();
+    pkt.clearPUSI();
+    TSUNIT_ASSERT(!pc.isSelected(pkt, mdata, 5));
+}
+
+TSUNIT_DEFINE_TEST(Pattern)
+{
+    ts::DuckContext duck;
+    ts::PacketClassifier pc(duck);
+    ts::TSPacketMetadata mdata;
+    ts::TSPacket pkt;
+    pkt.init(100, 0, 0);
+
+    pc.selectPattern(ts::ByteBlock({0x12, 0x34, 0x56}), true, false, 0);
+    TSUNIT_ASSERT(!pc.isSelected(pkt, mdata, 0));
+    pkt.b[100] = 0x12;
+    pkt.b[101] = 0x34;
+    pkt.b[102] = 0x56;
+    TSUNIT_ASSERT(pc.isSelected(pkt, mdata, 1));
+
+    // Search at fixed offset in payload.
+    pc.selectPattern(ts::ByteBlock({0x12, 0x34, 0x56}), true, true, 96);
+    TSUNIT_ASSERT(pc.isSelected(pkt, mdata, 2));
+    pc.selectPattern(ts::ByteBlock({0x12, 0x34, 0x56}), true, true, 95);
+    TSUNIT_ASSERT(!pc.isSelected(pkt, mdata, 3));
+    pc.selectPattern(ts::ByteBlock({0x12, 0x34, 0x56}), false, true, 100);
+    TSUNIT_ASSERT(pc.isSelected(pkt, mdata, 4));
+}
+
+TSUNIT_DEFINE_TEST(Ranges)
+{
+    ts::DuckContext duck;
+    ts::PacketClassifier pc(duck);
+    ts::TSPacketMetadata mdata;
+    ts::TSPacket pkt;
+    pkt.init(100);
+
+    pc.selectPacketRange(10, 12);
+    pc.selectPacketRange(20, 20);
+    std::vector<ts::PacketCounter> selected;
+    for (ts::PacketCounter i = 0; i < 30; ++i) {
+        if (pc.isSelected(pkt, mdata, i)) {
+            selected.push_back(i);
+        }
+    }
+    TSUNIT_ASSERT(selected == std::vector<ts::PacketCounter>({10, 11, 12, 20}));
+
+    pc.clear();
+    pc.selectEvery(10, 5);
+    selected.clear();
+    for (ts::PacketCounter i = 5; i < 40; ++i) {
+        if (pc.isSelected(pkt, mdata, i)) {
+            selected.push_back(i);
+        }
+    }
+    TSUNIT_ASSERT(selected == std::vector<ts::PacketCounter>({5, 15, 25, 35}));
+}
+
+void PacketClassifierTest::feedTable(ts::DuckContext& duck, ts::PacketClassifier& pc, const ts::AbstractTable& table, ts::PID pid, uint8_t cc)
+{
+    ts::OneShotPacketizer pzer(duck, pid);
+    pzer.setNextContinuityCounter(cc);
+    pzer.addTable(duck, table);
+    ts::TSPacketVector packets;
+    pzer.getPackets(packets);
+    TSUNIT_ASSERT(!packets.empty());
+    for (const auto& pkt : packets) {
+        pc.feedPacket(pkt);
+    }
+}
+
+TSUNIT_DEFINE_TEST(Signalization)
+{
+    ts::DuckContext duck;
+    ts::PacketClassifier pc(duck);
+    pc.selectPIDClass(ts::PIDClass::VIDEO);
+    TSUNIT_ASSERT(pc.needDemux());
+
+    // Nothing is known before the signalization.
+    TSUNIT_EQUAL(ts::PacketClassifier::DROP, pc.verdict(0x101));
+
+    ts::PAT pat(0, true, 1);
+    pat.pmts[1] = 0x100;
+    feedTable(duck, pc, pat, ts::PID_PAT);
+
+    ts::PMT pmt(0, true, 1, 0x101);
+    pmt.streams[0x101].stream_type = ts::ST_MPEG2_VIDEO;
+    pmt.streams[0x102].stream_type = ts::ST_MPEG2_AUDIO;
+    feedTable(duck, pc, pmt, 0x100);
+
+    TSUNIT_EQUAL(ts::PacketClassifier::PASS, pc.verdict(0x101));
+    TSUNIT_EQUAL(ts::PacketClassifier::DROP, pc.verdict(0x102));
+    TSUNIT_EQUAL(ts::PacketClassifier::DROP, pc.verdict(0x103));
+
+    // New version of the PMT: the video moves to another PID, the old video PID now carries audio.
+    pmt.clear();
+    pmt.version = 1;
+    pmt.service_id = 1;
+    pmt.pcr_pid = 0x103;
+    pmt.streams[0x101].stream_type = ts::ST_MPEG2_AUDIO;
+    pmt.streams[0x103].stream_type = ts::ST_AVC_VIDEO;
+    feedTable(duck, pc, pmt, 0x100, 1);
+
+    TSUNIT_EQUAL(ts::PacketClassifier::DROP, pc.verdict(0x101));
+    TSUNIT_EQUAL(ts::PacketClassifier::DROP, pc.verdict(0x102));
+    TSUNIT_EQUAL(ts::PacketClassifier::PASS, pc.verdict(0x103));
+}
+
+// A signalization handler which sets explicit verdicts from the PMT, as plugins do.
+namespace {
+    class PMTHandler: public ts::SignalizationHandlerInterface
+    {
+        TS_NOBUILD_NOCOPY(PMTHandler);
+    public:
+        PMTHandler(ts::PacketClassifier& pc) : _pc(pc) {}
+        size_t pat_count = 0;
+        size_t pmt_count = 0;
+        virtual void handlePAT(const ts::PAT& pat, ts::PID pid) override;
+        virtual void handlePMT(const ts::PMT& pmt, ts::PID pid) override;
+    private:
+        ts::PacketClassifier& _pc;
+    };
+
+    void PMTHandler::handlePAT(const ts::PAT&, ts::PID)
+    {
+        pat_count++;
+    }
+
+    void PMTHandler::handlePMT(const ts::PMT& pmt, ts::PID pid)
+    {
+        pmt_count++;
+        _pc.setVerdict(pid, ts::PacketClassifier::FIRST_USER_VERDICT);
+        for (const auto& it : pmt.streams) {
+            _pc.setVerdict(it.first, ts::PacketClassifier::PASS);
+        }
+    }
+}
+
+TSUNIT_DEFINE_TEST(SignalizationHandler)
+{
+    ts::DuckContext duck;
+    ts::PacketClassifier pc(duck);
+    PMTHandler handler(pc);
+
+    // Without criteria, the demux is needed only for the handler.
+    TSUNIT_ASSERT(!pc.needDemux());
+    pc.setSignalizationHandler(&handler);
+    TSUNIT_ASSERT(pc.needDemux());
+    pc.clear();
+    TSUNIT_ASSERT(pc.needDemux());
+
+    ts::PAT pat(0, true, 1);
+    pat.pmts[1] = 0x100;
+    feedTable(duck, pc, pat, ts::PID_PAT);
+    TSUNIT_EQUAL(1, handler.pat_count);
+    TSUNIT_EQUAL(0, handler.pmt_count);
+
+    ts::PMT pmt(0, true, 1, 0x101);
+    pmt.streams[0x101].stream_type = ts::ST_MPEG2_VIDEO;
+    pmt.streams[0x102].stream_type = ts::ST_MPEG2_AUDIO;
+    feedTable(duck, pc, pmt, 0x100);
+    TSUNIT_EQUAL(1, handler.pat_count);
+    TSUNIT_EQUAL(1, handler.pmt_count);
+
+    // The verdicts which were set by the handler are used.
+    TSUNIT_EQUAL(ts::PacketClassifier::FIRST_USER_VERDICT, pc.verdict(0x100));
+    TSUNIT_EQUAL(ts::PacketClassifier::PASS, pc.verdict(0x101));
+    TSUNIT_EQUAL(ts::PacketClassifier::PASS, pc.verdict(0x102));
+    TSUNIT_EQUAL(ts::PacketClassifier::DROP, pc.verdict(0x103));
+
+    // The last PMT of the service is available from the demux.
+    ts::PMT last;
+    TSUNIT_ASSERT(pc.demux().getPMT(last, 1));
+    TSUNIT_EQUAL(0x101, last.pcr_pid);
+    TSUNIT_EQUAL(2, last.streams.size());
+    TSUNIT_ASSERT(!pc.demux().getPMT(last, 2));
+    TSUNIT_ASSERT(!last.isValid());
+
+    // The demux is no longer needed after removing the handler.
+    pc.setSignalizationHandler(nullptr);
+    TSUNIT_ASSERT(!pc.needDemux());
+}
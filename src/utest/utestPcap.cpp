@@ -0,0 +1,367 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for PcapFile and PcapFilter.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPcapFilter.h"
+#include "tsIPPacket.h"
+#include "tsByteBlock.h"
+#include "tsFileUtils.h"
+#include "tsErrCodeReport.h"
+#include "tsCerrReport.h"
+#include "tsNullReport.h"
+#include "tsTS.h"
+#include "utestTSUnitBenchmark.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PcapTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Pcap);
+    TSUNIT_DECLARE_TEST(Pcapng);
+    TSUNIT_DECLARE_TEST(Filter);
+    TSUNIT_DECLARE_TEST(Reference);
+    TSUNIT_DECLARE_TEST(Benchmark);
+
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+private:
+    fs::path _pcap_file {};
+    fs::path _pcapng_file {};
+
+    static constexpr size_t   PACKET_COUNT = 200;   // Total number of IP packets in test files.
+    static constexpr uint16_t PORT1 = 1000;         // Destination port of even packets.
+    static constexpr uint16_t PORT2 = 2000;         // Destination port of odd packets.
+
+    // Build an Ethernet frame containing a UDP datagram with 7 TS packets.
+    static void BuildFrame(ts::ByteBlock& frame, size_t index);
+
+    // Build the test files.
+    static void BuildPcap(ts::ByteBlock& file, size_t count);
+    static void BuildPcapng(ts::ByteBlock& file, size_t count);
+
+    // Read all UDP datagrams from a file, return the number of datagrams.
+    size_t readFile(const fs::path& filename, bool use_map, bool check);
+};
+
+TSUNIT_REGISTER(PcapTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void PcapTest::beforeTest()
+{
+    if (_pcap_file.empty()) {
+        _pcap_file = ts::TempFile(u".pcap");
+    }
+    if (_pcapng_file.empty()) {
+        _pcapng_file = ts::TempFile(u".pcapng");
+    }
+    fs::remove(_pcap_file, &ts::ErrCodeReport());
+    fs::remove(_pcapng_file, &ts::ErrCodeReport());
+}
+
+// Test suite cleanup method.
+void PcapTest::afterTest()
+{
+    fs::remove(_pcap_file, &ts::ErrCodeReport());
+    fs::remove(_pcapng_file, &ts::ErrCodeReport());
+}
+
+
+//----------------------------------------------------------------------------
+// Build test files.
+//----------------------------------------------------------------------------
+
+void PcapTest::BuildFrame(ts::ByteBlock& frame, size_t index)
+{
+    constexpr size_t payload_size = 7 * ts::PKT_SIZE;
+    const uint16_t port = index % 2 == 0 ? PORT1 : PORT2;
+
+    frame.clear();
+
+    // Ethernet header: destination MAC, source MAC, ethertype IPv4.
+    frame.append(ts::ByteBlock(12, 0x02));
+    frame.appendUInt16(0x0800);
+
+    // IPv4 header, 10.0.0.1 -> 239.1.1.1.
+    const size_t ip_start = frame.size();
+    frame.appendUInt8(0x45);
+    frame.appendUInt8(0);
+    frame.appendUInt16(uint16_t(20 + 8 + payload_size));
+    frame.appendUInt16(uint16_t(index));
+    frame.appendUInt16(0);
+    frame.appendUInt8(64);
+    frame.appendUInt8(17);
+    frame.appendUInt16(0);
+    frame.appendUInt32(0x0A000001);
+    frame.appendUInt32(0xEF010101);
+    ts::IPPacket::UpdateIPHeaderChecksum(frame.data() + ip_start, 20);
+
+    // UDP header, no checksum.
+    frame.appendUInt16(5000);
+    frame.appendUInt16(port);
+    frame.appendUInt16(uint16_t(8 + payload_size));
+    frame.appendUInt16(0);
+
+    // TS packets, with the datagram index in the payload.
+    for (size_t i = 0; i < 7; ++i) {
+        frame.appendUInt8(ts::SYNC_BYTE);
+        frame.appendUInt16(0x0100);
+        frame.appendUInt8(0x10);
+        frame.appendUInt32(uint32_t(index));
+        frame.append(ts::ByteBlock(ts::PKT_SIZE - 8, uint8_t(i)));
+    }
+}
+
+void PcapTest::BuildPcap(ts::ByteBlock& file, size_t count)
+{
+    file.clear();
+
+    // Global header, little endian, microsecond resolution, Ethernet.
+    file.appendUInt32LE(0xA1B2C3D4);
+    file.appendUInt16LE(2);
+    file.appendUInt16LE(4);
+    file.appendUInt32LE(0);
+    file.appendUInt32LE(0);
+    file.appendUInt32LE(65535);
+    file.appendUInt32LE(1);
+
+    ts::ByteBlock frame;
+    for (size_t i = 0; i < count; ++i) {
+        BuildFrame(frame, i);
+        file.appendUInt32LE(uint32_t(1'700'000'000 + i / 1000));
+        file.appendUInt32LE(uint32_t((i % 1000) * 1000));
+        file.appendUInt32LE(uint32_t(frame.size()));
+        file.appendUInt32LE(uint32_t(frame.size()));
+        file.append(frame);
+    }
+}
+
+void PcapTest::BuildPcapng(ts::ByteBlock& file, size_t count)
+{
+    file.clear();
+
+    // Section header block.
+    file.appendUInt32LE(0x0A0D0D0A);
+    file.appendUInt32LE(28);
+    file.appendUInt32LE(0x1A2B3C4D);
+    file.appendUInt16LE(1);
+    file.appendUInt16LE(0);
+    file.appendUInt64LE(0xFFFFFFFFFFFFFFFF);
+    file.appendUInt32LE(28);
+
+    // Interface description block, Ethernet, default microsecond resolution.
+    file.appendUInt32LE(1);
+    file.appendUInt32LE(20);
+    file.appendUInt16LE(1);
+    file.appendUInt16LE(0);
+    file.appendUInt32LE(65535);
+    file.appendUInt32LE(20);
+
+    // Enhanced packet blocks.
+    ts::ByteBlock frame;
+    for (size_t i = 0; i < count; ++i) {
+        BuildFrame(frame, i);
+        const size_t padded = ts::round_up<size_t>(frame.size(), 4);
+        const uint32_t block_size = uint32_t(28 + padded + 4);
+        const uint64_t timestamp = 1'700'000'000'000'000 + i * 1000;
+        file.appendUInt32LE(6);
+        file.appendUInt32LE(block_size);
+        file.appendUInt32LE(0);
+        file.appendUInt32LE(uint32_t(timestamp >> 32));
+        file.appendUInt32LE(uint32_t(timestamp));
+        file.appendUInt32LE(uint32_t(frame.size()));
+        file.appendUInt32LE(uint32_t(frame.size()));
+        file.append(frame);
+        file.append(ts::ByteBlock(padded - frame.size(), 0));
+        file.appendUInt32LE(block_size);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Read all UDP datagrams from a file.
+//----------------------------------------------------------------------------
+
+size_t PcapTest::readFile(const fs::path& filename, bool use_map, bool check)
+{
+    ts::PcapFile file;
+    ts::IPPacket ip;
+    ts::VLANIdStack vlans;
+    cn::microseconds timestamp {};
+    size_t count = 0;
+
+    file.setMemoryMapping(use_map);
+    TSUNIT_ASSERT(file.open(filename, CERR));
+    TSUNIT_ASSERT(file.isOpen());
+
+    while (file.readIP(ip, vlans, timestamp, NULLREP)) {
+        if (check) {
+            TSUNIT_ASSERT(ip.isUDP());
+            TSUNIT_EQUAL(use_map, ip.isReference());
+            TSUNIT_EQUAL(7 * ts::PKT_SIZE, ip.protocolDataSize());
+            TSUNIT_EQUAL(count % 2 == 0 ? PORT1 : PORT2, ip.destination().port());
+            TSUNIT_EQUAL(count, ts::GetUInt32(ip.protocolData() + 4));
+            TSUNIT_EQUAL(1'700'000'000'000'000 + count * 1000, size_t(timestamp.count()));
+        }
+        count++;
+    }
+
+    if (check) {
+        TSUNIT_EQUAL(use_map, file.isMemoryMapped());
+        TSUNIT_EQUAL(count, file.packetCount());
+        TSUNIT_EQUAL(count, file.ipPacketCount());
+    }
+    file.close();
+    TSUNIT_ASSERT(!file.isOpen());
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Pcap)
+{
+    ts::ByteBlock data;
+    BuildPcap(data, PACKET_COUNT);
+    TSUNIT_ASSERT(data.saveToFile(_pcap_file, &CERR));
+
+    TSUNIT_EQUAL(PACKET_COUNT, readFile(_pcap_file, false, true));
+#if defined(TS_UNIX)
+    TSUNIT_EQUAL(PACKET_COUNT, readFile(_pcap_file, true, true));
+#endif
+}
+
+TSUNIT_DEFINE_TEST(Pcapng)
+{
+    ts::ByteBlock data;
+    BuildPcapng(data, PACKET_COUNT);
+    TSUNIT_ASSERT(data.saveToFile(_pcapng_file, &CERR));
+
+    TSUNIT_EQUAL(PACKET_COUNT, readFile(_pcapng_file, false, true));
+#if defined(TS_UNIX)
+    TSUNIT_EQUAL(PACKET_COUNT, readFile(_pcapng_file, true, true));
+#endif
+}
+
+TSUNIT_DEFINE_TEST(Filter)
+{
+    ts::ByteBlock data;
+    BuildPcap(data, PACKET_COUNT);
+    TSUNIT_ASSERT(data.saveToFile(_pcap_file, &CERR));
+
+    for (int use_map = 0; use_map < 2; ++use_map) {
+        ts::PcapFilter file;
+        ts::IPPacket ip;
+        ts::VLANIdStack vlans;
+        cn::microseconds timestamp {};
+        size_t count = 0;
+
+        // The filters are reset when the file is open.
+        file.setMemoryMapping(use_map != 0);
+        TSUNIT_ASSERT(file.open(_pcap_file, CERR));
+        file.setProtocolFilterUDP();
+        file.setDestinationFilter(ts::IPSocketAddress(239, 1, 1, 1, PORT2));
+        while (file.readIP(ip, vlans, timestamp, NULLREP)) {
+            TSUNIT_EQUAL(PORT2, ip.destination().port());
+            TSUNIT_EQUAL(2 * count + 1, ts::GetUInt32(ip.protocolData() + 4));
+            count++;
+        }
+        TSUNIT_EQUAL(PACKET_COUNT / 2, count);
+        TSUNIT_EQUAL(PACKET_COUNT, file.packetCount());
+        file.close();
+    }
+}
+
+TSUNIT_DEFINE_TEST(Reference)
+{
+    ts::ByteBlock data;
+    BuildPcap(data, PACKET_COUNT);
+    TSUNIT_ASSERT(data.saveToFile(_pcap_file, &CERR));
+
+    // Memory mapping is not the default.
+    ts::PcapFile file;
+    ts::IPPacket ip;
+    ts::VLANIdStack vlans;
+    cn::microseconds timestamp {};
+    TSUNIT_ASSERT(file.open(_pcap_file, CERR));
+    TSUNIT_ASSERT(!file.isMemoryMapped());
+    TSUNIT_ASSERT(file.readIP(ip, vlans, timestamp, CERR));
+    TSUNIT_ASSERT(!ip.isReference());
+    file.close();
+
+#if defined(TS_UNIX)
+    file.setMemoryMapping(true);
+    TSUNIT_ASSERT(file.open(_pcap_file, CERR));
+    TSUNIT_ASSERT(file.isMemoryMapped());
+    TSUNIT_ASSERT(file.readIP(ip, vlans, timestamp, CERR));
+    TSUNIT_ASSERT(ip.isReference());
+
+    // A copy always owns its data, a move keeps the reference.
+    ts::IPPacket copy1(ip);
+    TSUNIT_ASSERT(copy1.isValid());
+    TSUNIT_ASSERT(!copy1.isReference());
+    TSUNIT_ASSERT(copy1.data() != ip.data());
+    TSUNIT_EQUAL(ip.size(), copy1.size());
+    TSUNIT_EQUAL(0, std::memcmp(ip.data(), copy1.data(), ip.size()));
+
+    ts::IPPacket copy2;
+    copy2 = ip;
+    TSUNIT_ASSERT(!copy2.isReference());
+    TSUNIT_ASSERT(copy2.data() != ip.data());
+    TSUNIT_EQUAL(0, std::memcmp(ip.data(), copy2.data(), ip.size()));
+
+    const uint8_t* const addr = ip.data();
+    ts::IPPacket moved(std::move(ip));
+    TSUNIT_ASSERT(moved.isReference());
+    TSUNIT_ASSERT(moved.data() == addr);
+
+    // The copies remain valid after the file is unmapped.
+    file.close();
+    TSUNIT_EQUAL(0, ts::GetUInt32(copy1.protocolData() + 4));
+    TSUNIT_EQUAL(0, ts::GetUInt32(copy2.protocolData() + 4));
+#endif
+}
+
+TSUNIT_DEFINE_TEST(Benchmark)
+{
+    // Default: 1 iteration, typically for a quick functional test.
+    // The environment variable TSUNIT_PCAP_ITERATIONS can be used to specify a larger number of iterations.
+    utest::TSUnitBenchmark bench1(u"TSUNIT_PCAP_ITERATIONS");
+    utest::TSUnitBenchmark bench2(u"TSUNIT_PCAP_ITERATIONS");
+
+    ts::ByteBlock data;
+    BuildPcap(data, 20 * PACKET_COUNT);
+    TSUNIT_ASSERT(data.saveToFile(_pcap_file, &CERR));
+
+    for (size_t i = 0; i < bench1.iterations; ++i) {
+        bench1.start();
+        TSUNIT_EQUAL(20 * PACKET_COUNT, readFile(_pcap_file, false, false));
+        bench1.stop();
+        bench2.start();
+        TSUNIT_EQUAL(20 * PACKET_COUNT, readFile(_pcap_file, true, false));
+        bench2.stop();
+    }
+
+    bench1.report(u"PcapFile::readIP() with file stream");
+    bench2.report(u"PcapFile::readIP() with memory mapping");
+}
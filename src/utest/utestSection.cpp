@@ -12,6 +12,7 @@
 
 #include "tsSection.h"
 #include "tsBinaryTable.h"
+#include "tsSectionDigest.h"
 #include "tsunit.h"
 
 #include "tables/psi_tot_tnt_sections.h"
@@ -32,6 +33,8 @@ class SectionTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(Assign);
     TSUNIT_DECLARE_TEST(PackSections);
     TSUNIT_DECLARE_TEST(Size);
+    TSUNIT_DECLARE_TEST(Digest);
+    TSUNIT_DECLARE_TEST(DigestSet);
 
 private:
     // Create a dummy long section.
@@ -240,3 +243,75 @@ TSUNIT_DEFINE_TEST(Size)
     TSUNIT_EQUAL(366, table.totalSize());
     TSUNIT_EQUAL(2, table.packetCount());
 }
+
+TSUNIT_DEFINE_TEST(Digest)
+{
+    const ts::Section tot(psi_tot_tnt_sections, sizeof(psi_tot_tnt_sections), ts::PID_TOT, ts::CRC32::CHECK);
+    const ts::Section nit(psi_nit_tntv23_sections, sizeof(psi_nit_tntv23_sections), ts::PID_NIT, ts::CRC32::CHECK);
+    TSUNIT_ASSERT(tot.isValid());
+    TSUNIT_ASSERT(nit.isValid());
+
+    const ts::SectionDigest d1(tot);
+    const ts::SectionDigest d2(psi_tot_tnt_sections, sizeof(psi_tot_tnt_sections));
+    const ts::SectionDigest d3(nit);
+    TSUNIT_ASSERT(!d1.isNull());
+    TSUNIT_ASSERT(d1 == d2);
+    TSUNIT_ASSERT(d1 != d3);
+
+    // Any modified byte, including in the last partial block, changes the digest.
+    ts::ByteBlock data(psi_nit_tntv23_sections, sizeof(psi_nit_tntv23_sections));
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] ^= 0x01;
+        TSUNIT_ASSERT(ts::SectionDigest(data.data(), data.size()) != d3);
+        data[i] ^= 0x01;
+    }
+    TSUNIT_ASSERT(ts::SectionDigest(data.data(), data.size()) == d3);
+    TSUNIT_ASSERT(ts::SectionDigest(data.data(), data.size() - 1) != d3);
+
+    // Invalid sections have a null digest.
+    TSUNIT_ASSERT(ts::SectionDigest(ts::Section()).isNull());
+}
+
+TSUNIT_DEFINE_TEST(DigestSet)
+{
+    ts::ByteBlock data(4);
+    std::vector<ts::SectionDigest> digests;
+    for (uint32_t i = 0; i < 10; ++i) {
+        ts::PutUInt32(data.data(), i);
+        digests.push_back(ts::SectionDigest(data.data(), data.size()));
+    }
+
+    ts::SectionDigestSet set(3);
+    TSUNIT_ASSERT(!set.findOrInsert(digests[0]));
+    TSUNIT_ASSERT(!set.findOrInsert(digests[1]));
+    TSUNIT_ASSERT(!set.findOrInsert(digests[2]));
+    TSUNIT_ASSERT(set.findOrInsert(digests[0]));
+    TSUNIT_EQUAL(3, set.size());
+
+    // Digest 1 is the least recently used, it is removed first.
+    TSUNIT_ASSERT(!set.findOrInsert(digests[3]));
+    TSUNIT_EQUAL(3, set.size());
+    TSUNIT_ASSERT(set.findOrInsert(digests[0]));
+    TSUNIT_ASSERT(set.findOrInsert(digests[2]));
+    TSUNIT_ASSERT(set.findOrInsert(digests[3]));
+    TSUNIT_ASSERT(!set.findOrInsert(digests[1]));
+    TSUNIT_ASSERT(set.memorySize() > 0);
+
+    set.setMaxSize(1);
+    TSUNIT_EQUAL(1, set.size());
+    TSUNIT_ASSERT(set.findOrInsert(digests[1]));
+
+    // Unlimited set.
+    set.setMaxSize(0);
+    for (const auto& d : digests) {
+        set.findOrInsert(d);
+    }
+    TSUNIT_EQUAL(10, set.size());
+    for (const auto& d : digests) {
+        TSUNIT_ASSERT(set.findOrInsert(d));
+    }
+
+    set.clear();
+    TSUNIT_EQUAL(0, set.size());
+    TSUNIT_ASSERT(!set.findOrInsert(digests[5]));
+}
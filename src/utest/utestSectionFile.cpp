@@ -48,6 +48,7 @@ class SectionFileTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(MultiSectionsAtProgramLevelPMT);
     TSUNIT_DECLARE_TEST(MultiSectionsAtStreamLevelPMT);
     TSUNIT_DECLARE_TEST(Attribute);
+    TSUNIT_DECLARE_TEST(LoadXMLInvalidTable);
 
 public:
     virtual void beforeTest() override;
@@ -803,3 +804,36 @@ TSUNIT_DEFINE_TEST(Attribute)
     table2.toXML(duck, root3);
     TSUNIT_EQUAL(xmlref, doc3.toString());
 }
+
+TSUNIT_DEFINE_TEST(LoadXMLInvalidTable)
+{
+    // The PAT in the middle is valid for the XML model but has no transport_stream_id.
+    const ts::UString content(
+        u"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        u"<tsduck>\n"
+        u"  <TDT UTC_time=\"2025-01-02 03:04:05\"/>\n"
+        u"  <PAT>\n"
+        u"    <service service_id=\"0x100\" program_map_PID=\"0x200\"/>\n"
+        u"  </PAT>\n"
+        u"  <CAT/>\n"
+        u"</tsduck>\n");
+    TSUNIT_ASSERT(content.save(_tempFileNameXML, false, true));
+
+    // Loading from a file, a stream or a string: the valid tables are added, an error is returned.
+    ts::DuckContext duck(&report());
+    ts::SectionFile from_file(duck);
+    ts::SectionFile from_stream(duck);
+    ts::SectionFile from_string(duck);
+    std::istringstream strm(content.toUTF8());
+
+    TSUNIT_ASSERT(!from_file.loadXML(_tempFileNameXML));
+    TSUNIT_ASSERT(!from_stream.loadXML(strm));
+    TSUNIT_ASSERT(!from_string.parseXML(content));
+
+    for (const auto* file : {&from_file, &from_stream, &from_string}) {
+        TSUNIT_EQUAL(2, file->tablesCount());
+        TSUNIT_EQUAL(2, file->sectionsCount());
+        TSUNIT_EQUAL(ts::TID_TDT, file->tables()[0]->tableId());
+        TSUNIT_EQUAL(ts::TID_CAT, file->tables()[1]->tableId());
+    }
+}
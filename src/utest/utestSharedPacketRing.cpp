@@ -0,0 +1,404 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::SharedPacketRing
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedPacketRing.h"
+#include "tsUDPSocket.h"
+#include "tsIPUtils.h"
+#include "tsNullReport.h"
+#include "tsEnvironment.h"
+#include "tsunit.h"
+#include "utestTSUnitThread.h"
+#include "utestTSUnitBenchmark.h"
+
+#if defined(TS_UNIX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/wait.h>
+    #include <unistd.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class SharedPacketRingTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Basic);
+    TSUNIT_DECLARE_TEST(MultipleReaders);
+    TSUNIT_DECLARE_TEST(Drop);
+    TSUNIT_DECLARE_TEST(InUse);
+    TSUNIT_DECLARE_TEST(WriterTerminated);
+    TSUNIT_DECLARE_TEST(Threads);
+    TSUNIT_DECLARE_TEST(Benchmark);
+
+public:
+    // Build a packet and its metadata with a sequence number.
+    static void MakePacket(ts::TSPacket& pkt, ts::TSPacketMetadata& mdata, uint64_t seq);
+    static uint64_t PacketSequence(const ts::TSPacket& pkt) { return ts::GetUInt64(pkt.b + 4); }
+
+    // Build a unique name for the shared memory of a test.
+    static ts::UString RingName(const ts::UString& test);
+
+    // Transfer packets from a writer thread through a shared memory ring. Return the number of received packets.
+    static size_t TransferRing(const ts::UString& name, size_t count);
+
+    // Transfer packets from a writer thread through UDP on the loopback interface. Return the number of received packets.
+    static size_t TransferUDP(size_t count);
+};
+
+TSUNIT_REGISTER(SharedPacketRingTest);
+
+
+//----------------------------------------------------------------------------
+// Test utilities.
+//----------------------------------------------------------------------------
+
+void SharedPacketRingTest::MakePacket(ts::TSPacket& pkt, ts::TSPacketMetadata& mdata, uint64_t seq)
+{
+    pkt = ts::NullPacket;
+    ts::PutUInt64(pkt.b + 4, seq);
+    mdata.reset();
+    mdata.setLabel(seq % ts::TSPacketLabelSet::SIZE);
+}
+
+ts::UString SharedPacketRingTest::RingName(const ts::UString& test)
+{
+    return ts::UString::Format(u"utest-%s-%X", test, cn::system_clock::now().time_since_epoch().count());
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Basic)
+{
+    const ts::UString name(RingName(u"basic"));
+    ts::SharedPacketRing writer;
+    ts::SharedPacketRing reader;
+
+    TSUNIT_ASSERT(!writer.isOpen());
+    TSUNIT_ASSERT(!reader.open(name, NULLREP));
+    TSUNIT_ASSERT(writer.create(name, 100, 4, ts::SharedPacketRing::Policy::WAIT));
+    TSUNIT_ASSERT(writer.isOpen());
+    TSUNIT_ASSERT(writer.isWriter());
+    TSUNIT_EQUAL(100, writer.capacity());
+    TSUNIT_EQUAL(0, writer.readerCount());
+
+    TSUNIT_ASSERT(reader.open(name));
+    TSUNIT_ASSERT(reader.isOpen());
+    TSUNIT_ASSERT(!reader.isWriter());
+    TSUNIT_EQUAL(100, reader.capacity());
+    TSUNIT_EQUAL(1, writer.readerCount());
+
+    ts::TSPacket pkts[30];
+    ts::TSPacketMetadata mdata[30];
+    for (size_t i = 0; i < 30; ++i) {
+        MakePacket(pkts[i], mdata[i], i);
+    }
+
+    // Nothing to read yet.
+    TSUNIT_EQUAL(0, reader.read(pkts, mdata, 30, nullptr, cn::milliseconds(10)));
+    TSUNIT_ASSERT(!reader.endOfStream());
+
+    TSUNIT_EQUAL(30, writer.write(pkts, mdata, 30));
+
+    ts::TSPacket in[20];
+    ts::TSPacketMetadata in_mdata[20];
+    TSUNIT_EQUAL(20, reader.read(in, in_mdata, 20));
+    for (size_t i = 0; i < 20; ++i) {
+        TSUNIT_EQUAL(i, PacketSequence(in[i]));
+        TSUNIT_ASSERT(in_mdata[i].hasLabel(i % ts::TSPacketLabelSet::SIZE));
+    }
+
+    // The remaining packets are read after the writer is closed, then end of stream.
+    TSUNIT_ASSERT(writer.close());
+    TSUNIT_ASSERT(!writer.isOpen());
+    TSUNIT_ASSERT(!reader.endOfStream());
+    TSUNIT_EQUAL(10, reader.read(in, in_mdata, 20));
+    TSUNIT_EQUAL(20, PacketSequence(in[0]));
+    TSUNIT_EQUAL(29, PacketSequence(in[9]));
+    TSUNIT_ASSERT(reader.endOfStream());
+    TSUNIT_EQUAL(0, reader.read(in, in_mdata, 20));
+    TSUNIT_EQUAL(0, reader.lostPackets());
+    TSUNIT_ASSERT(reader.close());
+}
+
+TSUNIT_DEFINE_TEST(MultipleReaders)
+{
+    const ts::UString name(RingName(u"multi"));
+    ts::SharedPacketRing writer;
+    ts::SharedPacketRing reader1;
+    ts::SharedPacketRing reader2;
+    ts::SharedPacketRing reader3;
+
+    TSUNIT_ASSERT(writer.create(name, 10, 2, ts::SharedPacketRing::Policy::WAIT));
+    TSUNIT_ASSERT(reader1.open(name));
+    TSUNIT_ASSERT(reader2.open(name));
+    TSUNIT_ASSERT(!reader3.open(name, NULLREP));
+    TSUNIT_EQUAL(2, writer.readerCount());
+
+    ts::TSPacket pkts[10];
+    ts::TSPacketMetadata mdata[10];
+    for (size_t i = 0; i < 10; ++i) {
+        MakePacket(pkts[i], mdata[i], i);
+    }
+
+    // The ring is full for the slowest reader.
+    TSUNIT_EQUAL(10, writer.write(pkts, mdata, 10));
+    TSUNIT_EQUAL(10, reader1.read(pkts, mdata, 10));
+    TSUNIT_EQUAL(9, PacketSequence(pkts[9]));
+
+    // Reader 2 has not read anything yet, the writer waits for it.
+    TSUNIT_EQUAL(5, reader2.read(pkts, mdata, 5));
+    TSUNIT_EQUAL(0, PacketSequence(pkts[0]));
+    TSUNIT_EQUAL(5, writer.write(pkts, mdata, 5));
+
+    // A slot is free again after a reader is closed.
+    TSUNIT_ASSERT(reader1.close());
+    TSUNIT_EQUAL(1, writer.readerCount());
+    TSUNIT_ASSERT(reader3.open(name));
+    TSUNIT_EQUAL(2, writer.readerCount());
+}
+
+TSUNIT_DEFINE_TEST(Drop)
+{
+    const ts::UString name(RingName(u"drop"));
+    ts::SharedPacketRing writer;
+    ts::SharedPacketRing reader;
+
+    TSUNIT_ASSERT(writer.create(name, 100, 4, ts::SharedPacketRing::Policy::DROP));
+    TSUNIT_ASSERT(reader.open(name));
+
+    std::vector<ts::TSPacket> pkts(150);
+    std::vector<ts::TSPacketMetadata> mdata(150);
+    for (size_t i = 0; i < pkts.size(); ++i) {
+        MakePacket(pkts[i], mdata[i], i);
+    }
+
+    // The writer never waits, the reader is overrun and skips to the most recent packets.
+    TSUNIT_EQUAL(150, writer.write(pkts.data(), mdata.data(), 150));
+    TSUNIT_EQUAL(0, reader.read(pkts.data(), mdata.data(), 150, nullptr, cn::milliseconds(10)));
+    TSUNIT_EQUAL(150, reader.lostPackets());
+
+    TSUNIT_EQUAL(10, writer.write(pkts.data(), mdata.data(), 10));
+    TSUNIT_EQUAL(10, reader.read(pkts.data() + 20, mdata.data() + 20, 150));
+    TSUNIT_EQUAL(0, PacketSequence(pkts[20]));
+    TSUNIT_EQUAL(150, reader.lostPackets());
+}
+
+TSUNIT_DEFINE_TEST(InUse)
+{
+    const ts::UString name(RingName(u"inuse"));
+    ts::SharedPacketRing writer1;
+    ts::SharedPacketRing writer2;
+
+    // A ring buffer of a live writer is never replaced.
+    TSUNIT_ASSERT(writer1.create(name, 100, 4, ts::SharedPacketRing::Policy::WAIT));
+    TSUNIT_ASSERT(!writer2.create(name, 100, 4, ts::SharedPacketRing::Policy::WAIT, NULLREP));
+    TSUNIT_ASSERT(!writer2.isOpen());
+
+    ts::SharedMemory shm;
+    TSUNIT_ASSERT(!shm.create(name, 1000, NULLREP));
+    TSUNIT_ASSERT(!shm.isOpen());
+
+    // The name is available again after the writer is closed.
+    TSUNIT_ASSERT(writer1.close());
+    TSUNIT_ASSERT(writer2.create(name, 100, 4, ts::SharedPacketRing::Policy::WAIT));
+    TSUNIT_ASSERT(writer2.close());
+}
+
+TSUNIT_DEFINE_TEST(WriterTerminated)
+{
+#if defined(TS_UNIX)
+    const ts::UString name(RingName(u"stale"));
+
+    // A child process creates the ring buffer, writes packets and exits without closing it.
+    const ::pid_t pid = ::fork();
+    TSUNIT_ASSERT(pid >= 0);
+    if (pid == 0) {
+        ts::SharedPacketRing writer;
+        ts::TSPacket pkt;
+        ts::TSPacketMetadata mdata;
+        MakePacket(pkt, mdata, 0);
+        const bool ok = writer.create(name, 100, 4, ts::SharedPacketRing::Policy::DROP, NULLREP) && writer.write(&pkt, &mdata, 1) == 1;
+        ::_exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    int status = 0;
+    TSUNIT_EQUAL(pid, ::waitpid(pid, &status, 0));
+    TSUNIT_ASSERT(WIFEXITED(status));
+    TSUNIT_EQUAL(EXIT_SUCCESS, WEXITSTATUS(status));
+
+    // The reader does not wait forever for the dead writer.
+    ts::SharedPacketRing reader;
+    TSUNIT_ASSERT(reader.open(name));
+    ts::TSPacket pkt;
+    TSUNIT_EQUAL(0, reader.read(&pkt, nullptr, 1));
+    TSUNIT_ASSERT(reader.writerTerminated());
+    TSUNIT_ASSERT(!reader.endOfStream());
+    TSUNIT_ASSERT(reader.close());
+
+    // The stale ring buffer is replaced by a new writer.
+    ts::SharedPacketRing writer;
+    TSUNIT_ASSERT(writer.create(name, 100, 4, ts::SharedPacketRing::Policy::WAIT));
+    TSUNIT_ASSERT(writer.close());
+#endif
+}
+
+// A thread which writes packets in a shared memory ring.
+namespace {
+    class RingWriter: public utest::TSUnitThread
+    {
+        TS_NOBUILD_NOCOPY(RingWriter);
+    public:
+        RingWriter(ts::SharedPacketRing& ring, size_t count) : _ring(ring), _count(count) {}
+        virtual ~RingWriter() override { waitForTermination(); }
+
+        virtual void test() override
+        {
+            ts::TSPacket pkts[100];
+            ts::TSPacketMetadata mdata[100];
+            for (size_t seq = 0; seq < _count; ) {
+                const size_t n = std::min<size_t>(100, _count - seq);
+                for (size_t i = 0; i < n; ++i) {
+                    SharedPacketRingTest::MakePacket(pkts[i], mdata[i], seq + i);
+                }
+                TSUNIT_EQUAL(n, _ring.write(pkts, mdata, n));
+                seq += n;
+            }
+            TSUNIT_ASSERT(_ring.close());
+        }
+
+    private:
+        ts::SharedPacketRing& _ring;
+        size_t _count;
+    };
+
+    // A thread which sends packets on UDP, 7 packets per datagram.
+    class UDPWriter: public utest::TSUnitThread
+    {
+        TS_NOBUILD_NOCOPY(UDPWriter);
+    public:
+        UDPWriter(uint16_t port, size_t count) : _port(port), _count(count) {}
+        virtual ~UDPWriter() override { waitForTermination(); }
+
+        virtual void test() override
+        {
+            ts::UDPSocket sock(true, ts::IP::v4);
+            TSUNIT_ASSERT(sock.setDefaultDestination(ts::IPSocketAddress(ts::IPAddress::LocalHost4, _port)));
+            ts::TSPacket pkts[7];
+            ts::TSPacketMetadata mdata;
+            for (size_t seq = 0; seq < _count; ) {
+                const size_t n = std::min<size_t>(7, _count - seq);
+                for (size_t i = 0; i < n; ++i) {
+                    SharedPacketRingTest::MakePacket(pkts[i], mdata, seq + i);
+                }
+                TSUNIT_ASSERT(sock.send(pkts, n * ts::PKT_SIZE));
+                seq += n;
+            }
+        }
+
+    private:
+        uint16_t _port;
+        size_t _count;
+    };
+}
+
+size_t SharedPacketRingTest::TransferRing(const ts::UString& name, size_t count)
+{
+    ts::TSPacket pkts[1000];
+    ts::TSPacketMetadata mdata[1000];
+
+    // Transfer through the shared memory ring, using back-pressure, nothing is lost.
+    ts::SharedPacketRing writer;
+    ts::SharedPacketRing reader;
+    TSUNIT_ASSERT(writer.create(name, 1000, 4, ts::SharedPacketRing::Policy::WAIT));
+    TSUNIT_ASSERT(reader.open(name));
+
+    size_t total = 0;
+    bool ordered = true;
+    {
+        RingWriter thread(writer, count);
+        TSUNIT_ASSERT(thread.start());
+        size_t n = 0;
+        while ((n = reader.read(pkts, mdata, 1000)) > 0) {
+            for (size_t i = 0; i < n; ++i) {
+                ordered = ordered && PacketSequence(pkts[i]) == total + i && mdata[i].hasLabel((total + i) % ts::TSPacketLabelSet::SIZE);
+            }
+            total += n;
+        }
+    }
+    TSUNIT_ASSERT(ordered);
+    TSUNIT_EQUAL(0, reader.lostPackets());
+    TSUNIT_ASSERT(reader.endOfStream());
+    TSUNIT_ASSERT(!reader.writerTerminated());
+    return total;
+}
+
+size_t SharedPacketRingTest::TransferUDP(size_t count)
+{
+    ts::TSPacket pkts[1000];
+
+    // Receive on an ephemeral port of the loopback interface.
+    TSUNIT_ASSERT(ts::IPInitialize());
+    ts::UDPSocket sock;
+    TSUNIT_ASSERT(sock.open(ts::IP::v4));
+    sock.setReceiveBufferSize(4 * 1024 * 1024, NULLREP);
+    TSUNIT_ASSERT(sock.setReceiveTimeout(cn::milliseconds(200)));
+    TSUNIT_ASSERT(sock.bind(ts::IPSocketAddress(ts::IPAddress::LocalHost4, ts::IPSocketAddress::AnyPort)));
+    ts::IPSocketAddress local;
+    TSUNIT_ASSERT(sock.getLocalAddress(local));
+
+    size_t total = 0;
+    {
+        UDPWriter thread(local.port(), count);
+        TSUNIT_ASSERT(thread.start());
+        size_t size = 0;
+        ts::IPSocketAddress sender;
+        ts::IPSocketAddress destination;
+        while (total < count && sock.receive(pkts, sizeof(pkts), size, sender, destination, nullptr, NULLREP)) {
+            total += size / ts::PKT_SIZE;
+        }
+    }
+    sock.close(NULLREP);
+    return total;
+}
+
+TSUNIT_DEFINE_TEST(Threads)
+{
+    constexpr size_t COUNT = 20'000;
+    TSUNIT_EQUAL(COUNT, TransferRing(RingName(u"threads"), COUNT));
+}
+
+TSUNIT_DEFINE_TEST(Benchmark)
+{
+    // Compare the shared memory ring with UDP on the loopback interface.
+    // The test runs only when TSUNIT_SHMRING_ITERATIONS specifies the number of transfers of 500,000 packets.
+    constexpr size_t COUNT = 500'000;
+    utest::TSUnitBenchmark ring_bench(u"TSUNIT_SHMRING_ITERATIONS");
+    utest::TSUnitBenchmark udp_bench(u"TSUNIT_SHMRING_ITERATIONS");
+    if (ts::EnvironmentExists(u"TSUNIT_SHMRING_ITERATIONS")) {
+        size_t udp_total = 0;
+        for (size_t iter = 0; iter < ring_bench.iterations; ++iter) {
+            ring_bench.start();
+            TSUNIT_EQUAL(COUNT, TransferRing(RingName(u"bench"), COUNT));
+            ring_bench.stop();
+            udp_bench.start();
+            udp_total += TransferUDP(COUNT);
+            udp_bench.stop();
+        }
+        ring_bench.report(u"SharedPacketRingTest::Benchmark (shared memory)");
+        udp_bench.report(u"SharedPacketRingTest::Benchmark (UDP loopback)");
+        debug() << "SharedPacketRingTest::Benchmark: UDP loopback: received " << udp_total << " packets out of " << (COUNT * ring_bench.iterations) << std::endl;
+    }
+}
@@ -0,0 +1,185 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::SocketReactor.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSocketReactor.h"
+#include "tsTCPConnection.h"
+#include "tsTCPServer.h"
+#include "tsIPUtils.h"
+#include "tsCerrReport.h"
+#include "utestTSUnitThread.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class SocketReactorTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Callbacks);
+    TSUNIT_DECLARE_TEST(WakeUp);
+    TSUNIT_DECLARE_TEST(Echo);
+};
+
+TSUNIT_REGISTER(SocketReactorTest);
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Callbacks)
+{
+    ts::SocketReactor reactor;
+    TSUNIT_ASSERT(reactor.open(CERR));
+    TSUNIT_ASSERT(reactor.isOpen());
+    TSUNIT_EQUAL(0, reactor.socketCount());
+
+    // Posted callbacks are executed first, in order, then the timers, by due time.
+    std::vector<int> order;
+    reactor.postAfter(cn::milliseconds(40), [&]() { order.push_back(5); reactor.stop(); });
+    reactor.postAfter(cn::milliseconds(10), [&]() { order.push_back(3); });
+    reactor.postAfter(cn::milliseconds(10), [&]() { order.push_back(4); });
+    reactor.post([&]() { order.push_back(1); });
+    reactor.post([&]() { order.push_back(2); });
+
+    const cn::steady_clock::time_point start = cn::steady_clock::now();
+    TSUNIT_ASSERT(reactor.run(CERR));
+    const cn::milliseconds elapsed = cn::duration_cast<cn::milliseconds>(cn::steady_clock::now() - start);
+    debug() << "SocketReactorTest::Callbacks: elapsed: " << elapsed.count() << " ms" << std::endl;
+
+    TSUNIT_ASSERT(elapsed >= cn::milliseconds(40));
+    TSUNIT_EQUAL(5, order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        TSUNIT_EQUAL(int(i + 1), order[i]);
+    }
+    TSUNIT_ASSERT(reactor.close(CERR));
+    TSUNIT_ASSERT(!reactor.isOpen());
+}
+
+TSUNIT_DEFINE_TEST(WakeUp)
+{
+    // A reactor without socket and timer is woken up by a callback which is posted from another thread.
+    ts::SocketReactor reactor;
+    TSUNIT_ASSERT(reactor.open(CERR));
+    std::atomic<bool> executed {false};
+    std::thread poster([&]() {
+        std::this_thread::sleep_for(cn::milliseconds(20));
+        reactor.post([&]() { executed = true; reactor.stop(); });
+    });
+    TSUNIT_ASSERT(reactor.run(CERR));
+    poster.join();
+    TSUNIT_ASSERT(executed);
+    TSUNIT_ASSERT(reactor.close(CERR));
+}
+
+// An echo server, managed by a reactor, accepting one single client.
+namespace {
+    class EchoServer: public ts::SocketReactorHandlerInterface
+    {
+        TS_NOCOPY(EchoServer);
+    public:
+        ts::TCPServer     server {};
+        ts::TCPConnection client {};
+        size_t            received = 0;
+
+        EchoServer() = default;
+        virtual void handleSocketEvents(ts::SocketReactor& reactor, ts::SysSocketType sock, ts::SocketEvents events) override;
+    };
+
+    void EchoServer::handleSocketEvents(ts::SocketReactor& reactor, ts::SysSocketType sock, ts::SocketEvents)
+    {
+        if (sock == server.getSocket()) {
+            // Incoming connection, stop listening.
+            ts::IPSocketAddress addr;
+            TSUNIT_ASSERT(server.accept(client, addr, CERR));
+            TSUNIT_ASSERT(client.setNonBlocking(true, CERR));
+            TSUNIT_ASSERT(reactor.remove(sock, CERR));
+            TSUNIT_ASSERT(reactor.add(client.getSocket(), this, ts::SocketEvents::READ, CERR));
+        }
+        else {
+            TSUNIT_ASSERT(sock == client.getSocket());
+            uint8_t buffer[1024];
+            size_t size = 0;
+            if (client.receiveSome(buffer, sizeof(buffer), size, CERR)) {
+                // Echo the data. The amount of data is small enough to be sent at once.
+                received += size;
+                size_t sent = 0;
+                TSUNIT_ASSERT(client.sendSome(buffer, size, sent, CERR));
+                TSUNIT_EQUAL(size, sent);
+            }
+            else {
+                // End of connection.
+                TSUNIT_ASSERT(reactor.remove(sock, CERR));
+                client.close(CERR);
+                reactor.stop();
+            }
+        }
+    }
+
+    class EchoClient: public utest::TSUnitThread
+    {
+        TS_NOBUILD_NOCOPY(EchoClient);
+    private:
+        ts::IPSocketAddress _server_address;
+    public:
+        std::string message {"Hello reactor"};
+        std::string response {};
+
+        explicit EchoClient(const ts::IPSocketAddress& server_address) : _server_address(server_address) {}
+        virtual ~EchoClient() override { waitForTermination(); }
+
+        virtual void test() override
+        {
+            ts::TCPConnection session;
+            TSUNIT_ASSERT(session.open(ts::IP::v4, CERR));
+            TSUNIT_ASSERT(session.connect(_server_address, CERR));
+            TSUNIT_ASSERT(session.send(message.data(), message.size(), CERR));
+            TSUNIT_ASSERT(session.closeWriter(CERR));
+            char buffer[1024];
+            size_t size = 0;
+            while (session.receive(buffer, sizeof(buffer), size, nullptr, CERR)) {
+                response.append(buffer, size);
+            }
+            session.disconnect(CERR);
+            session.close(CERR);
+        }
+    };
+}
+
+TSUNIT_DEFINE_TEST(Echo)
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    EchoServer echo;
+    TSUNIT_ASSERT(echo.server.open(ts::IP::v4, CERR));
+    TSUNIT_ASSERT(echo.server.bind(ts::IPSocketAddress(ts::IPAddress::LocalHost4, ts::IPSocketAddress::AnyPort), CERR));
+    TSUNIT_ASSERT(echo.server.listen(5, CERR));
+    ts::IPSocketAddress server_address;
+    TSUNIT_ASSERT(echo.server.getLocalAddress(server_address, CERR));
+
+    ts::SocketReactor reactor;
+    TSUNIT_ASSERT(reactor.open(CERR));
+    TSUNIT_ASSERT(reactor.add(echo.server.getSocket(), &echo, ts::SocketEvents::READ, CERR));
+    TSUNIT_EQUAL(1, reactor.socketCount());
+
+    EchoClient client(server_address);
+    client.start();
+    TSUNIT_ASSERT(reactor.run(CERR));
+    client.waitForTermination();
+
+    TSUNIT_EQUAL(0, reactor.socketCount());
+    TSUNIT_EQUAL(client.message.size(), echo.received);
+    TSUNIT_EQUAL(client.message, client.response);
+    TSUNIT_ASSERT(reactor.close(CERR));
+    echo.server.close(CERR);
+}
@@ -0,0 +1,247 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::TSAnalyzer
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSAnalyzerReport.h"
+#include "tsTSAnalyzerOptions.h"
+#include "tsTSPacketMetadata.h"
+#include "tsCyclingPacketizer.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
+#include "tsSDT.h"
+#include "tsDuckContext.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TSAnalyzerTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(BoundedIdentical);
+    TSUNIT_DECLARE_TEST(PruneUnseen);
+    TSUNIT_DECLARE_TEST(MaxMemory);
+    TSUNIT_DECLARE_TEST(Merge);
+
+private:
+    // With this bitrate, there are exactly 1000 packets per second.
+    static constexpr uint64_t BITRATE = 1'504'000;
+
+    // Feed an analyzer with packets, cycling on a range of PID's.
+    static void Feed(ts::TSAnalyzer& analyzer, size_t packet_count, ts::PID first_pid, size_t pid_count);
+
+    // Build a stream with one service, with a continuity error in the audio PID at the specified packet index.
+    static void BuildService(ts::TSPacketVector& packets, size_t cycles, size_t error_index);
+
+    // Feed an analyzer with a range of packets.
+    static void Feed(ts::TSAnalyzer& analyzer, const ts::TSPacketVector& packets, size_t first, size_t count);
+
+    // Get a normalized and deterministic report.
+    static ts::UString Normalized(ts::TSAnalyzerReport& analyzer);
+};
+
+TSUNIT_REGISTER(TSAnalyzerTest);
+
+
+//----------------------------------------------------------------------------
+// Test suite helpers.
+//----------------------------------------------------------------------------
+
+void TSAnalyzerTest::Feed(ts::TSAnalyzer& analyzer, size_t packet_count, ts::PID first_pid, size_t pid_count)
+{
+    const ts::TSPacketMetadata mdata;
+    ts::TSPacket pkt;
+    for (size_t i = 0; i < packet_count; ++i) {
+        const ts::PID pid = ts::PID(first_pid + i % pid_count);
+        pkt = ts::NullPacket;
+        pkt.setPID(pid);
+        pkt.setCC(uint8_t((i / pid_count) & ts::CC_MASK));
+        analyzer.feedPacket(pkt, mdata);
+    }
+}
+
+void TSAnalyzerTest::BuildService(ts::TSPacketVector& packets, size_t cycles, size_t error_index)
+{
+    // Service 1, PMT PID 0x100, video PID 0x200 with PCR, audio PID 0x201.
+    ts::DuckContext duck;
+    ts::PAT pat(1, true, 10);
+    pat.pmts[1] = 0x100;
+    ts::PMT pmt(2, true, 1, 0x200);
+    pmt.streams[0x200].stream_type = ts::ST_AVC_VIDEO;
+    pmt.streams[0x201].stream_type = ts::ST_MPEG2_AUDIO;
+    ts::SDT sdt(true, 3, true, 10, 20);
+    sdt.services[1].setName(duck, u"Service");
+    sdt.services[1].setProvider(duck, u"Provider");
+
+    ts::CyclingPacketizer pat_pzer(duck, ts::PID_PAT, ts::CyclingPacketizer::StuffingPolicy::ALWAYS);
+    ts::CyclingPacketizer pmt_pzer(duck, 0x100, ts::CyclingPacketizer::StuffingPolicy::ALWAYS);
+    ts::CyclingPacketizer sdt_pzer(duck, ts::PID_SDT, ts::CyclingPacketizer::StuffingPolicy::ALWAYS);
+    pat_pzer.addTable(duck, pat);
+    pmt_pzer.addTable(duck, pmt);
+    sdt_pzer.addTable(duck, sdt);
+
+    // Cycles of 10 packets: PAT, PMT, SDT, 5 video packets, 2 audio packets.
+    // With a PCR in each cycle, at 2000 PCR units per packet, the bitrate is 20,304,000 b/s.
+    uint8_t video_cc = 0;
+    uint8_t audio_cc = 0;
+    packets.resize(10 * cycles);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        ts::TSPacket& pkt(packets[i]);
+        switch (i % 10) {
+            case 0:
+                pat_pzer.getNextPacket(pkt);
+                break;
+            case 1:
+                pmt_pzer.getNextPacket(pkt);
+                break;
+            case 2:
+                sdt_pzer.getNextPacket(pkt);
+                break;
+            case 8:
+            case 9:
+                pkt = ts::NullPacket;
+                pkt.setPID(0x201);
+                if (i == error_index) {
+                    audio_cc++;
+                }
+                pkt.setCC(audio_cc++ & ts::CC_MASK);
+                break;
+            default:
+                pkt = ts::NullPacket;
+                pkt.setPID(0x200);
+                pkt.setCC(video_cc++ & ts::CC_MASK);
+                if (i % 10 == 3) {
+                    pkt.setPCR(i * 2000, true);
+                }
+                break;
+        }
+    }
+}
+
+void TSAnalyzerTest::Feed(ts::TSAnalyzer& analyzer, const ts::TSPacketVector& packets, size_t first, size_t count)
+{
+    const ts::TSPacketMetadata mdata;
+    for (size_t i = first; i < first + count && i < packets.size(); ++i) {
+        analyzer.feedPacket(packets[i], mdata);
+    }
+}
+
+ts::UString TSAnalyzerTest::Normalized(ts::TSAnalyzerReport& analyzer)
+{
+    ts::TSAnalyzerOptions opt;
+    opt.normalized = true;
+    opt.deterministic = true;
+    std::stringstream strm;
+    analyzer.report(strm, opt);
+    return ts::UString::FromUTF8(strm.str());
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(BoundedIdentical)
+{
+    // When nothing is pruned, the reports in bounded-memory mode are identical.
+    ts::DuckContext duck;
+    ts::TSAnalyzerReport unbounded(duck, BITRATE, ts::BitRateConfidence::OVERRIDE);
+    ts::TSAnalyzerReport bounded(duck, BITRATE, ts::BitRateConfidence::OVERRIDE);
+    bounded.setMemoryLimits(cn::seconds(60), 1024 * 1024);
+
+    Feed(unbounded, 30'000, 100, 10);
+    Feed(bounded, 30'000, 100, 10);
+
+    const ts::UString report(Normalized(unbounded));
+    debug() << "TSAnalyzerTest::BoundedIdentical: " << report << std::endl;
+    TSUNIT_ASSERT(!report.contains(u"pruned"));
+    TSUNIT_EQUAL(report, Normalized(bounded));
+}
+
+TSUNIT_DEFINE_TEST(PruneUnseen)
+{
+    ts::DuckContext duck;
+    ts::TSAnalyzerReport analyzer(duck, BITRATE, ts::BitRateConfidence::OVERRIDE);
+    analyzer.setMemoryLimits(cn::seconds(5), 0);
+
+    // 20 PID's during 10 seconds, then only 2 PID's during 20 seconds.
+    Feed(analyzer, 10'000, 200, 20);
+    const size_t footprint = analyzer.memoryFootprint();
+    std::vector<ts::PID> pids;
+    analyzer.getPIDs(pids);
+    TSUNIT_EQUAL(20, pids.size());
+
+    Feed(analyzer, 20'000, 200, 2);
+    analyzer.getPIDs(pids);
+    TSUNIT_EQUAL(2, pids.size());
+    TSUNIT_EQUAL(200, pids[0]);
+    TSUNIT_EQUAL(201, pids[1]);
+    debug() << "TSAnalyzerTest::PruneUnseen: footprint: " << footprint << " -> " << analyzer.memoryFootprint() << std::endl;
+    TSUNIT_ASSERT(analyzer.memoryFootprint() < footprint);
+    TSUNIT_ASSERT(Normalized(analyzer).contains(u"prunedpids=18:"));
+
+    // A reset clears the pruning statistics.
+    analyzer.reset();
+    TSUNIT_ASSERT(!Normalized(analyzer).contains(u"pruned"));
+}
+
+TSUNIT_DEFINE_TEST(MaxMemory)
+{
+    ts::DuckContext duck;
+    ts::TSAnalyzerReport analyzer(duck, BITRATE, ts::BitRateConfidence::OVERRIDE);
+
+    // Measure the footprint with 10 PID's, then use it as limit.
+    Feed(analyzer, 1'000, 300, 10);
+    const size_t limit = analyzer.memoryFootprint();
+    analyzer.reset();
+    analyzer.setMemoryLimits(cn::seconds::zero(), limit);
+
+    // 1000 PID's, then 10 PID's only: the old PID's are pruned to fit in the limit.
+    Feed(analyzer, 20'000, 400, 1'000);
+    Feed(analyzer, 40'000, 300, 10);
+    std::vector<ts::PID> pids;
+    analyzer.getPIDs(pids);
+    debug() << "TSAnalyzerTest::MaxMemory: limit: " << limit << ", footprint: " << analyzer.memoryFootprint() << ", PID's: " << pids.size() << std::endl;
+    TSUNIT_ASSERT(analyzer.memoryFootprint() <= limit);
+    TSUNIT_EQUAL(10, pids.size());
+    TSUNIT_EQUAL(300, pids[0]);
+}
+
+TSUNIT_DEFINE_TEST(Merge)
+{
+    // 3000 packets, analyzed in 3 chunks, with a continuity error at the first boundary.
+    ts::TSPacketVector packets;
+    BuildService(packets, 300, 1008);
+
+    ts::DuckContext duck0;
+    ts::TSAnalyzerReport sequential(duck0);
+    Feed(sequential, packets, 0, packets.size());
+
+    ts::DuckContext duck1;
+    ts::DuckContext duck2;
+    ts::DuckContext duck3;
+    ts::TSAnalyzerReport merged(duck1);
+    ts::TSAnalyzer chunk2(duck2);
+    ts::TSAnalyzer chunk3(duck3);
+    Feed(merged, packets, 0, 1000);
+    Feed(chunk2, packets, 1000, 1000);
+    Feed(chunk3, packets, 2000, 1000);
+    merged.merge(chunk2);
+    merged.merge(chunk3);
+
+    const ts::UString report(Normalized(sequential));
+    debug() << "TSAnalyzerTest::Merge: " << report << std::endl;
+    TSUNIT_ASSERT(report.contains(u"pid:pid=513:"));
+    TSUNIT_ASSERT(report.contains(u":discontinuities=1:"));
+    TSUNIT_ASSERT(report.contains(u":name=Service"));
+    TSUNIT_EQUAL(report, Normalized(merged));
+}
@@ -0,0 +1,90 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::TSDatagramOutput
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSDatagramOutput.h"
+#include "tsCerrReport.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TSDatagramOutputTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Ranges);
+
+private:
+    // A datagram handler which collects the datagrams.
+    class Handler: public ts::TSDatagramOutputHandlerInterface
+    {
+    public:
+        std::vector<ts::ByteBlock> datagrams {};
+        virtual bool sendDatagram(const void* address, size_t size, ts::Report& report) override;
+    };
+};
+
+TSUNIT_REGISTER(TSDatagramOutputTest);
+
+bool TSDatagramOutputTest::Handler::sendDatagram(const void* address, size_t size, ts::Report& report)
+{
+    datagrams.emplace_back(address, size);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Ranges)
+{
+    // One packet out of two is dropped.
+    ts::TSPacketVector packets(40);
+    ts::TSPacketRangeVector ranges;
+    for (size_t i = 0; i < packets.size(); ++i) {
+        packets[i].init(ts::PID(i), uint8_t(i), uint8_t(i));
+        if (i % 2 == 0) {
+            ranges.emplace_back(&packets[i], nullptr, 1);
+        }
+    }
+    // Add a large contiguous range.
+    ts::TSPacketVector more(10);
+    for (size_t i = 0; i < more.size(); ++i) {
+        more[i].init(ts::PID(100 + i), 0, 0);
+    }
+    ranges.emplace_back(more.data(), nullptr, more.size());
+
+    Handler handler;
+    ts::TSDatagramOutput output(ts::TSDatagramOutputOptions::NONE, &handler);
+    TSUNIT_ASSERT(output.open(CERR));
+    TSUNIT_ASSERT(output.send(ranges.data(), ranges.size(), 0, CERR));
+
+    // 30 packets: 4 full datagrams of 7 packets, then 2 packets in a shorter one.
+    TSUNIT_EQUAL(5, handler.datagrams.size());
+    TSUNIT_EQUAL(7 * ts::PKT_SIZE, handler.datagrams[0].size());
+    TSUNIT_EQUAL(7 * ts::PKT_SIZE, handler.datagrams[3].size());
+    TSUNIT_EQUAL(2 * ts::PKT_SIZE, handler.datagrams[4].size());
+
+    // Check packet order.
+    size_t pid = 0;
+    for (size_t d = 0; d < handler.datagrams.size(); ++d) {
+        for (size_t i = 0; i < handler.datagrams[d].size(); i += ts::PKT_SIZE) {
+            ts::TSPacket pkt;
+            pkt.copyFrom(handler.datagrams[d].data() + i);
+            TSUNIT_EQUAL(pid, pkt.getPID());
+            pid = pid < 38 ? pid + 2 : (pid == 38 ? 100 : pid + 1);
+        }
+    }
+    TSUNIT_EQUAL(110, pid);
+    TSUNIT_ASSERT(output.close(0, false, CERR));
+}
@@ -11,11 +11,16 @@
 //----------------------------------------------------------------------------
 
 #include "tsTSFile.h"
+#include "tsTSFileIndex.h"
+#include "tsTSForkPipe.h"
 #include "tsTSPacket.h"
 #include "tsTSPacketMetadata.h"
 #include "tsCerrReport.h"
+#include "tsNullReport.h"
+#include "tsMemory.h"
 #include "tsFileUtils.h"
 #include "tsErrCodeReport.h"
+#include "utestTSUnitBenchmark.h"
 #include "tsunit.h"
 
 
@@ -30,6 +35,12 @@ class TSFileTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(Duck);
     TSUNIT_DECLARE_TEST(StuffingRead);
     TSUNIT_DECLARE_TEST(StuffingWrite);
+    TSUNIT_DECLARE_TEST(Ranges);
+    TSUNIT_DECLARE_TEST(RangesForkPipe);
+    TSUNIT_DECLARE_TEST(RangesBenchmark);
+    TSUNIT_DECLARE_TEST(Index);
+    TSUNIT_DECLARE_TEST(IndexRS204);
+    TSUNIT_DECLARE_TEST(IndexBenchmark);
 
 public:
     virtual void beforeTest() override;
@@ -37,6 +48,16 @@ public:
 
 private:
     fs::path _tempFileName {};
+
+    // Build packets and ranges of non-dropped packets with a pseudo-random 50% drop pattern.
+    static void BuildRanges(ts::TSPacketVector& packets, ts::TSPacketRangeVector& ranges);
+
+    // Build packets with a PCR every 10 packets, 2000 PCR units per packet, starting at first_pcr.
+    // Each packet contains its index in its last 4 bytes.
+    static void BuildPCR(ts::TSPacketVector& packets, uint64_t first_pcr);
+
+    // Read the next packet and return its index, as built by BuildPCR().
+    static size_t ReadIndex(ts::TSFile& file);
 };
 
 TSUNIT_REGISTER(TSFileTest);
@@ -53,12 +74,14 @@ void TSFileTest::beforeTest()
         _tempFileName = ts::TempFile(u".ts");
     }
     fs::remove(_tempFileName, &ts::ErrCodeReport());
+    fs::remove(ts::TSFileIndex::SidecarFileName(_tempFileName), &ts::ErrCodeReport());
 }
 
 // Test suite cleanup method.
 void TSFileTest::afterTest()
 {
     fs::remove(_tempFileName, &ts::ErrCodeReport());
+    fs::remove(ts::TSFileIndex::SidecarFileName(_tempFileName), &ts::ErrCodeReport());
 }
 
 
@@ -358,3 +381,272 @@ TSUNIT_DEFINE_TEST(StuffingWrite)
     TSUNIT_EQUAL(184, packets[5].getPayloadSize());
     TSUNIT_EQUAL(0xFF, packets[5].getPayload()[0]);
 }
+
+void TSFileTest::BuildRanges(ts::TSPacketVector& packets, ts::TSPacketRangeVector& ranges)
+{
+    // Deterministic pseudo-random sequence (xorshift), one bit per packet.
+    uint32_t state = 0x12345678;
+    ranges.clear();
+    for (size_t i = 0; i < packets.size(); ++i) {
+        packets[i].init(ts::PID(i % 0x1000), uint8_t(i), uint8_t(i));
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        if ((state & 1) != 0) {
+            if (!ranges.empty() && ranges.back().packets + ranges.back().count == &packets[i]) {
+                ranges.back().count++;
+            }
+            else {
+                ranges.emplace_back(&packets[i], nullptr, 1);
+            }
+        }
+    }
+}
+
+TSUNIT_DEFINE_TEST(Ranges)
+{
+    ts::TSPacketVector packets(1000);
+    ts::TSPacketRangeVector ranges;
+    BuildRanges(packets, ranges);
+    const size_t count = ts::TSPacketRange::PacketCount(ranges.data(), ranges.size());
+    TSUNIT_ASSERT(ranges.size() > 100);
+    TSUNIT_ASSERT(count > 300);
+    TSUNIT_ASSERT(count < 700);
+
+    ts::TSFile file;
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE, CERR));
+    TSUNIT_ASSERT(file.writePacketRanges(ranges.data(), ranges.size(), CERR));
+    TSUNIT_EQUAL(count, file.writePacketsCount());
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL(count * ts::PKT_SIZE, fs::file_size(_tempFileName, &ts::ErrCodeReport(CERR)));
+
+    // Read the file and compare with the non-dropped packets.
+    ts::TSPacketVector input(count + 10);
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::READ, CERR));
+    TSUNIT_EQUAL(count, file.readPackets(input.data(), nullptr, input.size(), CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+
+    size_t index = 0;
+    for (const auto& r : ranges) {
+        for (size_t i = 0; i < r.count; ++i) {
+            TSUNIT_ASSERT(input[index++] == r.packets[i]);
+        }
+    }
+
+    // Same thing in M2TS format, range by range.
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE, CERR, ts::TSPacketFormat::M2TS));
+    TSUNIT_ASSERT(file.writePacketRanges(ranges.data(), ranges.size(), CERR));
+    TSUNIT_EQUAL(count, file.writePacketsCount());
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL(count * (ts::PKT_SIZE + 4), fs::file_size(_tempFileName, &ts::ErrCodeReport(CERR)));
+}
+
+TSUNIT_DEFINE_TEST(RangesForkPipe)
+{
+#if defined(TS_UNIX)
+    // More ranges than IOV_MAX and more data than the pipe buffer: several partial vectored writes.
+    ts::TSPacketVector packets(10'000);
+    ts::TSPacketRangeVector ranges;
+    BuildRanges(packets, ranges);
+    const size_t count = ts::TSPacketRange::PacketCount(ranges.data(), ranges.size());
+    TSUNIT_ASSERT(ranges.size() > 1024);
+
+    ts::TSForkPipe pipe;
+    TSUNIT_ASSERT(pipe.open(u"cat > " + ts::UString(_tempFileName), ts::ForkPipe::SYNCHRONOUS, 0, CERR, ts::ForkPipe::KEEP_BOTH, ts::ForkPipe::STDIN_PIPE, ts::TSPacketFormat::TS));
+    TSUNIT_ASSERT(pipe.writePacketRanges(ranges.data(), ranges.size(), CERR));
+    TSUNIT_EQUAL(count, pipe.writePacketsCount());
+    TSUNIT_ASSERT(pipe.close(CERR));
+    TSUNIT_EQUAL(count * ts::PKT_SIZE, fs::file_size(_tempFileName, &ts::ErrCodeReport(CERR)));
+
+    // Read the file and compare with the non-dropped packets.
+    ts::TSFile file;
+    ts::TSPacketVector input(count + 10);
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::READ, CERR));
+    TSUNIT_EQUAL(count, file.readPackets(input.data(), nullptr, input.size(), CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+
+    size_t index = 0;
+    for (const auto& r : ranges) {
+        for (size_t i = 0; i < r.count; ++i) {
+            TSUNIT_ASSERT(input[index++] == r.packets[i]);
+        }
+    }
+#endif
+}
+
+TSUNIT_DEFINE_TEST(RangesBenchmark)
+{
+    // Default: 1 iteration, typically for a quick functional test.
+    // The environment variable TSUNIT_TSFILE_ITERATIONS can be used to specify a larger number of iterations.
+    utest::TSUnitBenchmark bench1(u"TSUNIT_TSFILE_ITERATIONS");
+    utest::TSUnitBenchmark bench2(u"TSUNIT_TSFILE_ITERATIONS");
+
+    // One typical tsp buffer with 50% dropped packets.
+    ts::TSPacketVector packets(10'000);
+    ts::TSPacketRangeVector ranges;
+    BuildRanges(packets, ranges);
+    const size_t count = ts::TSPacketRange::PacketCount(ranges.data(), ranges.size());
+
+    ts::TSFile file;
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE, CERR));
+
+    for (size_t iter = 0; iter < bench1.iterations; ++iter) {
+        // One write per range.
+        bench1.start();
+        for (const auto& r : ranges) {
+            TSUNIT_ASSERT(file.writePackets(r.packets, r.metadata, r.count, CERR));
+        }
+        bench1.stop();
+        // One vectored write for all ranges.
+        bench2.start();
+        TSUNIT_ASSERT(file.writePacketRanges(ranges.data(), ranges.size(), CERR));
+        bench2.stop();
+    }
+
+    TSUNIT_EQUAL(2 * bench1.iterations * count, file.writePacketsCount());
+    TSUNIT_ASSERT(file.close(CERR));
+
+    bench1.report(u"TSFile::writePackets() per range, 50% drop");
+    bench2.report(u"TSFile::writePacketRanges(), 50% drop");
+}
+
+void TSFileTest::BuildPCR(ts::TSPacketVector& packets, uint64_t first_pcr)
+{
+    for (size_t i = 0; i < packets.size(); ++i) {
+        packets[i] = ts::NullPacket;
+        packets[i].setPID(i % 10 == 0 ? 0x100 : 0x101);
+        packets[i].setCC(uint8_t(i & ts::CC_MASK));
+        if (i % 10 == 0) {
+            packets[i].setPCR((first_pcr + 2000 * i) % ts::PCR_SCALE, true);
+        }
+        ts::PutUInt32(packets[i].b + ts::PKT_SIZE - 4, uint32_t(i));
+    }
+}
+
+size_t TSFileTest::ReadIndex(ts::TSFile& file)
+{
+    ts::TSPacket pkt;
+    return file.readPackets(&pkt, nullptr, 1, CERR) == 1 ? size_t(ts::GetUInt32(pkt.b + ts::PKT_SIZE - 4)) : ts::NPOS;
+}
+
+TSUNIT_DEFINE_TEST(Index)
+{
+    // 50,000 packets, the PCR wraps up between packets 20,000 and 20,010.
+    ts::TSPacketVector packets(50'000);
+    BuildPCR(packets, ts::PCR_SCALE - 2000 * 20'005);
+    const fs::path sidecar(ts::TSFileIndex::SidecarFileName(_tempFileName));
+
+    // Write the file with its index, using both write methods.
+    ts::TSFile file;
+    const ts::TSPacketRange range(&packets[30'000], nullptr, 20'000);
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE | ts::TSFile::INDEX, CERR));
+    TSUNIT_ASSERT(file.writePackets(packets.data(), nullptr, 30'000, CERR));
+    TSUNIT_ASSERT(file.writePacketRanges(&range, 1, CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_ASSERT(fs::exists(sidecar));
+
+    ts::TSFileIndex index;
+    TSUNIT_ASSERT(index.load(_tempFileName, CERR));
+    TSUNIT_EQUAL(50'000, index.packetCount());
+    TSUNIT_EQUAL(ts::PKT_SIZE, index.packetSize());
+    TSUNIT_EQUAL(0x100, index.pcrPID());
+    TSUNIT_EQUAL(5, index.entries().size());
+    TSUNIT_EQUAL(20'000, index.entries()[2].packet);
+    TSUNIT_EQUAL(2000 * 49'990, index.duration().count());
+
+    // Seek by time and PCR, after the PCR wrap-up.
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 0, CERR));
+    TSUNIT_ASSERT(file.seekTime(ts::PCR(2000 * 12'345), CERR));
+    TSUNIT_EQUAL(12'345, ReadIndex(file));
+    TSUNIT_ASSERT(file.seekTime(ts::PCR(2000 * 45'678), CERR));
+    TSUNIT_EQUAL(45'678, ReadIndex(file));
+    TSUNIT_ASSERT(file.seekPCR(2000 * 15, CERR));
+    TSUNIT_EQUAL(20'020, ReadIndex(file));
+    TSUNIT_ASSERT(file.seekPCR(ts::PCR_SCALE - 2000 * 5, CERR));
+    TSUNIT_EQUAL(20'000, ReadIndex(file));
+    TSUNIT_ASSERT(!file.seekTime(ts::PCR(2000 * 50'000), NULLREP));
+    TSUNIT_ASSERT(!file.seekPCR(2000 * 40'000, NULLREP));
+    TSUNIT_ASSERT(file.close(CERR));
+
+    // Appending packets makes the sidecar file obsolete, the index is rebuilt.
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::APPEND | ts::TSFile::INDEX, CERR));
+    TSUNIT_ASSERT(file.writePackets(packets.data(), nullptr, 10, CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_ASSERT(!index.load(_tempFileName, NULLREP));
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 0, CERR));
+    TSUNIT_ASSERT(file.loadIndex(CERR, true));
+    TSUNIT_EQUAL(50'010, file.index().packetCount());
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_ASSERT(index.load(_tempFileName, CERR));
+    TSUNIT_EQUAL(50'010, index.packetCount());
+}
+
+TSUNIT_DEFINE_TEST(IndexRS204)
+{
+    ts::TSPacketVector packets(1000);
+    BuildPCR(packets, 0);
+
+    ts::TSFile file;
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE | ts::TSFile::INDEX, CERR, ts::TSPacketFormat::RS204));
+    TSUNIT_ASSERT(file.writePackets(packets.data(), nullptr, packets.size(), CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL(1000 * 204, fs::file_size(_tempFileName, &ts::ErrCodeReport(CERR)));
+
+    // The packet trailers are included in the seek offset.
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 0, CERR));
+    TSUNIT_EQUAL(0, ReadIndex(file));
+    TSUNIT_EQUAL(ts::TSPacketFormat::RS204, file.packetFormat());
+    TSUNIT_ASSERT(file.seek(777, CERR));
+    TSUNIT_EQUAL(777, ReadIndex(file));
+    TSUNIT_ASSERT(file.seekTime(ts::PCR(2000 * 555), CERR));
+    TSUNIT_EQUAL(204, file.index().packetSize());
+    TSUNIT_EQUAL(555, ReadIndex(file));
+    TSUNIT_ASSERT(file.close(CERR));
+}
+
+TSUNIT_DEFINE_TEST(IndexBenchmark)
+{
+    // Default: 1 iteration, typically for a quick functional test.
+    // The environment variable TSUNIT_TSFILE_ITERATIONS can be used to specify a larger number of iterations.
+    utest::TSUnitBenchmark bench1(u"TSUNIT_TSFILE_ITERATIONS");
+    utest::TSUnitBenchmark bench2(u"TSUNIT_TSFILE_ITERATIONS");
+
+    // A file of 100,000 packets (18.8 MB) with its index. Seek at 90% of the file.
+    ts::TSPacketVector packets(100'000);
+    BuildPCR(packets, 0);
+    const ts::PCR target(2000 * 90'000);
+
+    ts::TSFile file;
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE | ts::TSFile::INDEX, CERR));
+    TSUNIT_ASSERT(file.writePackets(packets.data(), nullptr, packets.size(), CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+
+    ts::TSPacketVector buffer(1000);
+    for (size_t iter = 0; iter < bench1.iterations; ++iter) {
+        // Sequential scan of the file, until the PCR of the target time.
+        bench1.start();
+        TSUNIT_ASSERT(file.openRead(_tempFileName, 0, CERR));
+        size_t found = ts::NPOS;
+        for (size_t base = 0, count = 0; found == ts::NPOS && (count = file.readPackets(buffer.data(), nullptr, buffer.size(), CERR)) > 0; base += count) {
+            for (size_t i = 0; found == ts::NPOS && i < count; ++i) {
+                if (buffer[i].hasPCR() && buffer[i].getPCR() >= uint64_t(target.count())) {
+                    found = base + i;
+                }
+            }
+        }
+        TSUNIT_ASSERT(file.close(CERR));
+        bench1.stop();
+        TSUNIT_EQUAL(90'000, found);
+
+        // Seek using the sidecar index file.
+        bench2.start();
+        TSUNIT_ASSERT(file.openRead(_tempFileName, 0, CERR));
+        TSUNIT_ASSERT(file.seekTime(target, CERR));
+        bench2.stop();
+        TSUNIT_EQUAL(90'000, ReadIndex(file));
+        TSUNIT_ASSERT(file.close(CERR));
+    }
+
+    bench1.report(u"TSFile sequential search of PCR, 100,000 packets");
+    bench2.report(u"TSFile::seekTime() with index, 100,000 packets");
+}
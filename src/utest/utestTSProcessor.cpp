@@ -12,6 +12,7 @@
 
 #include "tsTSProcessor.h"
 #include "tsPluginRepository.h"
+#include "tsOutputPlugin.h"
 #include "tsCerrReport.h"
 #include "tsunit.h"
 
@@ -23,6 +24,7 @@
 class TSProcessorTest: public tsunit::Test
 {
     TSUNIT_DECLARE_TEST(Processing);
+    TSUNIT_DECLARE_TEST(OutputRanges);
 };
 
 TSUNIT_REGISTER(TSProcessorTest);
@@ -127,6 +129,63 @@ TestPlugin::Status TestPlugin::processPacket(ts::TSPacket& pkt, ts::TSPacketMeta
 }
 
 
+//----------------------------------------------------------------------------
+// Internal plugins to test the collection of output ranges.
+// The packet processing plugin numbers all packets and drops one packet out
+// of three. The output plugin logs all output operations.
+//----------------------------------------------------------------------------
+
+namespace {
+    class TestDropPlugin : ts::ProcessorPlugin
+    {
+    public:
+        TestDropPlugin(ts::TSP* t) : ts::ProcessorPlugin(t, u"Test drop plugin", u"") {}
+        virtual Status processPacket(ts::TSPacket&, ts::TSPacketMetadata&) override;
+        static ts::ProcessorPlugin* CreateInstance(ts::TSP* t) { return new TestDropPlugin(t); }
+    };
+
+    TestDropPlugin::Status TestDropPlugin::processPacket(ts::TSPacket& pkt, ts::TSPacketMetadata&)
+    {
+        ts::PutUInt32(pkt.b + 4, uint32_t(tsp->pluginPackets()));
+        return tsp->pluginPackets() % 3 == 1 ? TSP_DROP : TSP_OK;
+    }
+
+    class TestRangesOutput : ts::OutputPlugin
+    {
+    public:
+        TestRangesOutput(ts::TSP* t) : ts::OutputPlugin(t, u"Test ranges output plugin", u"") {}
+        virtual bool send(const ts::TSPacket*, const ts::TSPacketMetadata*, size_t) override;
+        virtual bool sendVector(const ts::TSPacketRange*, size_t) override;
+        static ts::OutputPlugin* CreateInstance(ts::TSP* t) { return new TestRangesOutput(t); }
+
+        // Log of output operations: number of packets per range, sequence numbers of all packets.
+        static std::vector<std::vector<size_t>> calls;
+        static std::vector<uint32_t> sequences;
+    };
+
+    std::vector<std::vector<size_t>> TestRangesOutput::calls;
+    std::vector<uint32_t> TestRangesOutput::sequences;
+
+    bool TestRangesOutput::send(const ts::TSPacket* buffer, const ts::TSPacketMetadata* pkt_data, size_t packet_count)
+    {
+        const ts::TSPacketRange range(buffer, pkt_data, packet_count);
+        return sendVector(&range, 1);
+    }
+
+    bool TestRangesOutput::sendVector(const ts::TSPacketRange* ranges, size_t range_count)
+    {
+        calls.emplace_back();
+        for (size_t r = 0; r < range_count; ++r) {
+            calls.back().push_back(ranges[r].count);
+            for (size_t i = 0; i < ranges[r].count; ++i) {
+                sequences.push_back(ts::GetUInt32(ranges[r].packets[i].b + 4));
+            }
+        }
+        return true;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // A test plugin event handler.
 // We don't do the TSUNIT assertions in the event handler (called in plugin
@@ -274,3 +333,46 @@ TSUNIT_DEFINE_TEST(Processing)
     TSUNIT_EQUAL(3,          handler2.logs[0].count);
     TSUNIT_EQUAL(26,         handler2.logs[0].packets);
 }
+
+TSUNIT_DEFINE_TEST(OutputRanges)
+{
+    ts::PluginRepository::Instance().registerProcessor(u"test-drop", TestDropPlugin::CreateInstance);
+    ts::PluginRepository::Instance().registerOutput(u"test-ranges", TestRangesOutput::CreateInstance);
+    TestRangesOutput::calls.clear();
+    TestRangesOutput::sequences.clear();
+
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"TSProcessorTest::OutputRanges";
+    opt.max_output_pkt = 10;
+    opt.input = {u"null", {u"1000"}};
+    opt.plugins = {{u"test-drop", {}}};
+    opt.output = {u"test-ranges", {}};
+
+    ts::TSProcessor tsproc(CERR);
+    TSUNIT_ASSERT(tsproc.start(opt));
+    tsproc.waitForTermination();
+
+    // All non-dropped packets are output in order.
+    TSUNIT_EQUAL(667, TestRangesOutput::sequences.size());
+    for (size_t i = 0; i < TestRangesOutput::sequences.size(); ++i) {
+        TSUNIT_EQUAL(i + i / 2 + (i % 2 == 0 ? 0 : 1), TestRangesOutput::sequences[i]);
+    }
+
+    // Each output operation contains several ranges, up to --max-output-packets.
+    size_t multi_ranges = 0;
+    for (const auto& call : TestRangesOutput::calls) {
+        size_t total = 0;
+        for (size_t count : call) {
+            TSUNIT_ASSERT(count > 0);
+            TSUNIT_ASSERT(count <= 2);
+            total += count;
+        }
+        TSUNIT_ASSERT(total <= 10);
+        if (call.size() > 1) {
+            multi_ranges++;
+        }
+    }
+    debug() << "TSProcessorTest::OutputRanges: " << TestRangesOutput::calls.size() << " output operations, "
+            << multi_ranges << " with several ranges" << std::endl;
+    TSUNIT_ASSERT(multi_ranges > 0);
+}
@@ -0,0 +1,490 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for zero-copy table views.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPATView.h"
+#include "tsPMTView.h"
+#include "tsCATView.h"
+#include "tsSDTView.h"
+#include "tsNITView.h"
+#include "tsEITView.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
+#include "tsCAT.h"
+#include "tsSDT.h"
+#include "tsNIT.h"
+#include "tsEIT.h"
+#include "tsSectionFile.h"
+#include "tsSignalizationDemux.h"
+#include "tsOneShotPacketizer.h"
+#include "tsServiceDescriptor.h"
+#include "tsISO639LanguageDescriptor.h"
+#include "tsShortEventDescriptor.h"
+#include "tsDuckContext.h"
+#include "tsunit.h"
+#include "utestTSUnitBenchmark.h"
+
+#include "tables/psi_pat_r4_sections.h"
+#include "tables/psi_pmt_hevc_sections.h"
+#include "tables/psi_pmt_planete_sections.h"
+#include "tables/psi_cat_r6_sections.h"
+#include "tables/psi_sdt_r3_sections.h"
+#include "tables/psi_nit_tntv23_sections.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TableViewsTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(PAT);
+    TSUNIT_DECLARE_TEST(PMT);
+    TSUNIT_DECLARE_TEST(CAT);
+    TSUNIT_DECLARE_TEST(SDT);
+    TSUNIT_DECLARE_TEST(NIT);
+    TSUNIT_DECLARE_TEST(EIT);
+    TSUNIT_DECLARE_TEST(Invalid);
+    TSUNIT_DECLARE_TEST(SignalizationDemux);
+    TSUNIT_DECLARE_TEST(Benchmark);
+
+private:
+    // Load a binary table from a list of reference sections.
+    static ts::BinaryTablePtr LoadTable(ts::DuckContext& duck, const uint8_t* sections, size_t sections_size);
+
+    // Build the signalization of a synthetic MPTS.
+    static void BuildMPTS(ts::PAT& pat, std::vector<ts::PMT>& pmts, ts::SDT& sdt, size_t service_count);
+
+    // Packetize all tables of a synthetic MPTS with a given version, append to a list of packets.
+    using PacketizerMap = std::map<ts::PID, std::shared_ptr<ts::OneShotPacketizer>>;
+    static void AddMPTS(ts::DuckContext& duck, PacketizerMap& pzers, ts::TSPacketVector& packets, uint8_t version, ts::PAT& pat, std::vector<ts::PMT>& pmts, ts::SDT& sdt);
+};
+
+TSUNIT_REGISTER(TableViewsTest);
+
+
+//----------------------------------------------------------------------------
+// Test helpers.
+//----------------------------------------------------------------------------
+
+ts::BinaryTablePtr TableViewsTest::LoadTable(ts::DuckContext& duck, const uint8_t* sections, size_t sections_size)
+{
+    ts::SectionFile file(duck);
+    TSUNIT_ASSERT(file.loadBuffer(sections, sections_size));
+    TSUNIT_EQUAL(1, file.tables().size());
+    TSUNIT_ASSERT(file.tables()[0] != nullptr);
+    return file.tables()[0];
+}
+
+void TableViewsTest::BuildMPTS(ts::PAT& pat, std::vector<ts::PMT>& pmts, ts::SDT& sdt, size_t service_count)
+{
+    ts::DuckContext duck;
+    pat.ts_id = sdt.ts_id = 0x0123;
+    sdt.onetw_id = 0x20FA;
+    pmts.clear();
+    for (size_t i = 0; i < service_count; ++i) {
+        const uint16_t id = uint16_t(0x0100 + i);
+        const ts::PID base = ts::PID(0x0200 + 16 * i);
+        pat.pmts[id] = base;
+
+        ts::PMT pmt(0, true, id, base + 1);
+        pmt.streams[base + 1].stream_type = ts::ST_AVC_VIDEO;
+        for (ts::PID pid = base + 2; pid < base + 4; ++pid) {
+            ts::PMT::Stream& audio(pmt.streams[pid]);
+            audio.stream_type = ts::ST_MPEG1_AUDIO;
+            audio.descs.add(duck, ts::ISO639LanguageDescriptor(pid == base + 2 ? u"fra" : u"eng", 0));
+        }
+        pmts.push_back(pmt);
+
+        ts::SDT::ServiceEntry& srv(sdt.services[id]);
+        srv.running_status = 4;
+        srv.EITpf_present = true;
+        srv.descs.add(duck, ts::ServiceDescriptor(0x01, u"Provider", ts::UString::Format(u"Service %d", i)));
+    }
+}
+
+void TableViewsTest::AddMPTS(ts::DuckContext& duck, PacketizerMap& pzers, ts::TSPacketVector& packets, uint8_t version, ts::PAT& pat, std::vector<ts::PMT>& pmts, ts::SDT& sdt)
+{
+    const auto add = [&](ts::AbstractLongTable& table, ts::PID pid) {
+        auto& pzer(pzers[pid]);
+        if (pzer == nullptr) {
+            pzer = std::make_shared<ts::OneShotPacketizer>(duck, pid);
+        }
+        table.version = version;
+        ts::TSPacketVector pkts;
+        pzer->addTable(duck, table);
+        pzer->getPackets(pkts);
+        pzer->removeAll();
+        packets.insert(packets.end(), pkts.begin(), pkts.end());
+    };
+    add(pat, ts::PID_PAT);
+    for (auto& pmt : pmts) {
+        add(pmt, pat.pmts[pmt.service_id]);
+    }
+    add(sdt, ts::PID_SDT);
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(PAT)
+{
+    ts::DuckContext duck;
+    const ts::BinaryTablePtr ptr(LoadTable(duck, psi_pat_r4_sections, sizeof(psi_pat_r4_sections)));
+    const ts::BinaryTable& table(*ptr);
+    ts::PAT pat(duck, table);
+    TSUNIT_ASSERT(pat.isValid());
+
+    const ts::PATView view(*table.sectionAt(0));
+    TSUNIT_ASSERT(view.isValid());
+    TSUNIT_EQUAL(pat.ts_id, view.tsId());
+    TSUNIT_EQUAL(pat.version, view.version());
+    TSUNIT_ASSERT(view.isCurrent());
+
+    size_t count = 0;
+    for (const auto& prog : view.programs()) {
+        if (prog.programNumber() == 0) {
+            TSUNIT_EQUAL(pat.nit_pid, prog.pid());
+        }
+        else {
+            TSUNIT_ASSERT(pat.pmts.contains(prog.programNumber()));
+            TSUNIT_EQUAL(pat.pmts[prog.programNumber()], prog.pid());
+            count++;
+        }
+    }
+    TSUNIT_EQUAL(pat.pmts.size(), count);
+
+    // The version is ignored, not the content.
+    TSUNIT_ASSERT(ts::PATView::SameContent(table, pat));
+    pat.version = (pat.version + 1) & ts::SVERSION_MASK;
+    TSUNIT_ASSERT(ts::PATView::SameContent(table, pat));
+    pat.pmts.begin()->second++;
+    TSUNIT_ASSERT(!ts::PATView::SameContent(table, pat));
+    pat.pmts.begin()->second--;
+    pat.pmts.erase(pat.pmts.begin());
+    TSUNIT_ASSERT(!ts::PATView::SameContent(table, pat));
+}
+
+TSUNIT_DEFINE_TEST(PMT)
+{
+    ts::DuckContext duck;
+    for (const auto& ref : {std::make_pair(psi_pmt_hevc_sections, sizeof(psi_pmt_hevc_sections)), std::make_pair(psi_pmt_planete_sections, sizeof(psi_pmt_planete_sections))}) {
+        const ts::BinaryTablePtr ptr(LoadTable(duck, ref.first, ref.second));
+        const ts::BinaryTable& table(*ptr);
+        ts::PMT pmt(duck, table);
+        TSUNIT_ASSERT(pmt.isValid());
+
+        const ts::PMTView view(*table.sectionAt(0));
+        TSUNIT_ASSERT(view.isValid());
+        TSUNIT_EQUAL(pmt.service_id, view.serviceId());
+        TSUNIT_EQUAL(pmt.pcr_pid, view.pcrPID());
+        TSUNIT_EQUAL(pmt.descs.size(), view.descs().count());
+        TSUNIT_ASSERT(view.descs().sameAs(pmt.descs));
+        TSUNIT_EQUAL(pmt.streams.size(), view.streams().count());
+
+        for (const auto& str : view.streams()) {
+            TSUNIT_ASSERT(pmt.streams.contains(str.pid()));
+            const ts::PMT::Stream& ref_str(pmt.streams[str.pid()]);
+            TSUNIT_EQUAL(ref_str.stream_type, str.streamType());
+            TSUNIT_EQUAL(ref_str.descs.size(), str.descs().count());
+            size_t index = 0;
+            for (const auto& desc : str.descs()) {
+                TSUNIT_EQUAL(ref_str.descs[index]->tag(), desc.tag());
+                TSUNIT_EQUAL(ref_str.descs[index]->payloadSize(), desc.payloadSize());
+                index++;
+            }
+        }
+
+        TSUNIT_ASSERT(ts::PMTView::SameContent(table, pmt));
+        pmt.version = (pmt.version + 1) & ts::SVERSION_MASK;
+        TSUNIT_ASSERT(ts::PMTView::SameContent(table, pmt));
+        pmt.streams.begin()->second.stream_type ^= 0xFF;
+        TSUNIT_ASSERT(!ts::PMTView::SameContent(table, pmt));
+        pmt.streams.begin()->second.stream_type ^= 0xFF;
+        TSUNIT_ASSERT(ts::PMTView::SameContent(table, pmt));
+        pmt.pcr_pid++;
+        TSUNIT_ASSERT(!ts::PMTView::SameContent(table, pmt));
+    }
+}
+
+TSUNIT_DEFINE_TEST(CAT)
+{
+    ts::DuckContext duck;
+    const ts::BinaryTablePtr ptr(LoadTable(duck, psi_cat_r6_sections, sizeof(psi_cat_r6_sections)));
+    const ts::BinaryTable& table(*ptr);
+    const ts::CAT cat(duck, table);
+    TSUNIT_ASSERT(cat.isValid());
+
+    const ts::CATView view(*table.sectionAt(0));
+    TSUNIT_ASSERT(view.isValid());
+    TSUNIT_EQUAL(cat.descs.size(), view.descs().count());
+    TSUNIT_ASSERT(view.descs().sameAs(cat.descs));
+
+    size_t index = 0;
+    for (const auto& desc : view.descs()) {
+        TSUNIT_EQUAL(cat.descs[index]->tag(), desc.tag());
+        TSUNIT_EQUAL(cat.descs[index]->size(), desc.size());
+        index++;
+    }
+}
+
+TSUNIT_DEFINE_TEST(SDT)
+{
+    ts::DuckContext duck;
+    const ts::BinaryTablePtr ptr(LoadTable(duck, psi_sdt_r3_sections, sizeof(psi_sdt_r3_sections)));
+    const ts::BinaryTable& table(*ptr);
+    ts::SDT sdt(duck, table);
+    TSUNIT_ASSERT(sdt.isValid());
+
+    const ts::SDTView view(*table.sectionAt(0));
+    TSUNIT_ASSERT(view.isValid());
+    TSUNIT_ASSERT(view.isActual());
+    TSUNIT_EQUAL(sdt.ts_id, view.tsId());
+    TSUNIT_EQUAL(sdt.onetw_id, view.onId());
+    TSUNIT_EQUAL(sdt.services.size(), view.services().count());
+
+    for (const auto& srv : view.services()) {
+        TSUNIT_ASSERT(sdt.services.contains(srv.serviceId()));
+        const ts::SDT::ServiceEntry& ref_srv(sdt.services[srv.serviceId()]);
+        TSUNIT_EQUAL(ref_srv.EITs_present, srv.EITsPresent());
+        TSUNIT_EQUAL(ref_srv.EITpf_present, srv.EITpfPresent());
+        TSUNIT_EQUAL(ref_srv.running_status, srv.runningStatus());
+        TSUNIT_EQUAL(ref_srv.CA_controlled, srv.CAControlled());
+        TSUNIT_ASSERT(srv.descs().sameAs(ref_srv.descs));
+    }
+
+    TSUNIT_ASSERT(ts::SDTView::SameContent(table, sdt));
+    sdt.version = (sdt.version + 1) & ts::SVERSION_MASK;
+    TSUNIT_ASSERT(ts::SDTView::SameContent(table, sdt));
+    sdt.services.begin()->second.running_status ^= 0x07;
+    TSUNIT_ASSERT(!ts::SDTView::SameContent(table, sdt));
+    sdt.services.begin()->second.running_status ^= 0x07;
+    sdt.services.begin()->second.descs.clear();
+    TSUNIT_ASSERT(!ts::SDTView::SameContent(table, sdt));
+}
+
+TSUNIT_DEFINE_TEST(NIT)
+{
+    ts::DuckContext duck;
+    const ts::BinaryTablePtr ptr(LoadTable(duck, psi_nit_tntv23_sections, sizeof(psi_nit_tntv23_sections)));
+    const ts::BinaryTable& table(*ptr);
+    ts::NIT nit(duck, table);
+    TSUNIT_ASSERT(nit.isValid());
+
+    size_t desc_count = 0;
+    size_t ts_count = 0;
+    for (size_t i = 0; i < table.sectionCount(); ++i) {
+        const ts::NITView view(*table.sectionAt(i));
+        TSUNIT_ASSERT(view.isValid());
+        TSUNIT_ASSERT(view.isActual());
+        TSUNIT_EQUAL(nit.network_id, view.networkId());
+        desc_count += view.descs().count();
+        for (const auto& tp : view.transports()) {
+            const ts::TransportStreamId id(tp.tsId(), tp.onId());
+            TSUNIT_ASSERT(nit.transports.contains(id));
+            TSUNIT_ASSERT(tp.descs().sameAs(nit.transports[id].descs));
+            ts_count++;
+        }
+    }
+    TSUNIT_EQUAL(nit.descs.size(), desc_count);
+    TSUNIT_EQUAL(nit.transports.size(), ts_count);
+
+    TSUNIT_ASSERT(ts::NITView::SameContent(table, nit));
+    nit.version = (nit.version + 1) & ts::SVERSION_MASK;
+    TSUNIT_ASSERT(ts::NITView::SameContent(table, nit));
+    nit.transports.begin()->second.descs.clear();
+    TSUNIT_ASSERT(!ts::NITView::SameContent(table, nit));
+}
+
+TSUNIT_DEFINE_TEST(EIT)
+{
+    ts::DuckContext duck;
+    ts::EIT eit(true, true, 0, 3, true, 0x0102, 0x0304, 0x0506);
+    eit.last_table_id = ts::TID_EIT_PF_ACT;
+
+    ts::EIT::Event& ev1(eit.events.newEntry());
+    ev1.event_id = 0x1234;
+    ev1.start_time = ts::Time(2025, 3, 14, 20, 45, 0);
+    ev1.duration = cn::seconds(5400 + 17);
+    ev1.running_status = 4;
+    ev1.descs.add(duck, ts::ShortEventDescriptor(u"fre", u"Event 1", u"Text"));
+
+    ts::EIT::Event& ev2(eit.events.newEntry());
+    ev2.event_id = 0x1235;
+    ev2.start_time = ts::Time(2025, 3, 14, 22, 15, 17);
+    ev2.duration = cn::seconds(3600);
+    ev2.CA_controlled = true;
+
+    ts::BinaryTable table;
+    TSUNIT_ASSERT(eit.serialize(duck, table));
+    TSUNIT_EQUAL(1, table.sectionCount());
+
+    const ts::EITView view(*table.sectionAt(0));
+    TSUNIT_ASSERT(view.isValid());
+    TSUNIT_ASSERT(view.isActual());
+    TSUNIT_ASSERT(view.isPresentFollowing());
+    TSUNIT_EQUAL(0x0102, view.serviceId());
+    TSUNIT_EQUAL(0x0304, view.tsId());
+    TSUNIT_EQUAL(0x0506, view.onId());
+    TSUNIT_EQUAL(ts::TID_EIT_PF_ACT, view.lastTableId());
+    TSUNIT_EQUAL(2, view.events().count());
+
+    auto it = view.events().begin();
+    TSUNIT_ASSERT(it != view.events().end());
+    TSUNIT_EQUAL(0x1234, it->eventId());
+    TSUNIT_ASSERT(ev1.start_time == it->startTime());
+    TSUNIT_EQUAL(5417, it->duration().count());
+    TSUNIT_EQUAL(4, it->runningStatus());
+    TSUNIT_ASSERT(!it->CAControlled());
+    TSUNIT_ASSERT(it->descs().sameAs(ev1.descs));
+
+    ++it;
+    TSUNIT_ASSERT(it != view.events().end());
+    TSUNIT_EQUAL(0x1235, it->eventId());
+    TSUNIT_ASSERT(ev2.start_time == it->startTime());
+    TSUNIT_EQUAL(3600, it->duration().count());
+    TSUNIT_ASSERT(it->CAControlled());
+    TSUNIT_ASSERT(it->descs().empty());
+
+    ++it;
+    TSUNIT_ASSERT(it == view.events().end());
+}
+
+TSUNIT_DEFINE_TEST(Invalid)
+{
+    ts::DuckContext duck;
+    const ts::BinaryTablePtr ptr(LoadTable(duck, psi_sdt_r3_sections, sizeof(psi_sdt_r3_sections)));
+    const ts::BinaryTable& table(*ptr);
+    const ts::Section& section(*table.sectionAt(0));
+
+    // Wrong table id.
+    const ts::PMTView pmt(section);
+    TSUNIT_ASSERT(!pmt.isValid());
+    TSUNIT_EQUAL(ts::PID_NULL, pmt.pcrPID());
+    TSUNIT_ASSERT(pmt.descs().empty());
+    TSUNIT_ASSERT(pmt.streams().empty());
+    TSUNIT_ASSERT(!ts::EITView(section).isValid());
+    TSUNIT_ASSERT(!ts::PATView::SameContent(table, ts::PAT()));
+
+    // Truncated descriptor list: the iteration stops on the truncated descriptor.
+    static const uint8_t descs[] = {0x48, 0x02, 0x01, 0x00, 0x52, 0x01, 0x07, 0x0A, 0x04, 0x66};
+    const ts::DescriptorListView view(descs, sizeof(descs));
+    TSUNIT_EQUAL(2, view.count());
+    auto it = view.begin();
+    TSUNIT_EQUAL(0x48, it->tag());
+    TSUNIT_EQUAL(2, it->payloadSize());
+    ++it;
+    TSUNIT_EQUAL(0x52, it->tag());
+    TSUNIT_EQUAL(3, it->size());
+    ++it;
+    TSUNIT_ASSERT(it == view.end());
+}
+
+TSUNIT_DEFINE_TEST(SignalizationDemux)
+{
+    ts::DuckContext duck;
+    ts::PAT pat;
+    std::vector<ts::PMT> pmts;
+    ts::SDT sdt;
+    BuildMPTS(pat, pmts, sdt, 4);
+
+    // Three versions of the same signalization, then a real change in a PMT.
+    PacketizerMap pzers;
+    ts::TSPacketVector packets;
+    for (uint8_t version = 0; version < 3; ++version) {
+        AddMPTS(duck, pzers, packets, version, pat, pmts, sdt);
+    }
+    pmts[1].streams[0x0219].stream_type = ts::ST_HEVC_VIDEO;
+    AddMPTS(duck, pzers, packets, 3, pat, pmts, sdt);
+
+    ts::SignalizationDemux demux(duck);
+    demux.addFullFilters();
+    for (const auto& pkt : packets) {
+        demux.feedPacket(pkt);
+    }
+
+    // The versions are updated, even when the content is unchanged.
+    TSUNIT_ASSERT(demux.hasPAT());
+    TSUNIT_EQUAL(3, demux.lastPAT().version);
+    TSUNIT_EQUAL(pat.pmts.size(), demux.lastPAT().pmts.size());
+
+    ts::ServiceList services;
+    demux.getServices(services);
+    TSUNIT_EQUAL(4, services.size());
+    for (const auto& srv : services) {
+        TSUNIT_ASSERT(srv.hasName());
+        TSUNIT_EQUAL(pat.pmts[srv.getId()], srv.getPMTPID());
+    }
+
+    // The changed PMT was processed.
+    TSUNIT_EQUAL(ts::ST_HEVC_VIDEO, demux.streamType(0x0219));
+    TSUNIT_EQUAL(ts::ST_MPEG1_AUDIO, demux.streamType(0x0212));
+    TSUNIT_EQUAL(0x0101, demux.serviceId(0x0219));
+}
+
+TSUNIT_DEFINE_TEST(Benchmark)
+{
+    // Synthetic MPTS with frequent versions of identical PSI/SI. The number
+    // of iterations is in the environment variable TSUNIT_TABLE_VIEWS_ITERATIONS.
+    ts::DuckContext duck;
+    ts::PAT pat;
+    std::vector<ts::PMT> pmts;
+    ts::SDT sdt;
+    BuildMPTS(pat, pmts, sdt, 16);
+
+    ts::BinaryTable bin_pmt;
+    TSUNIT_ASSERT(pmts[0].serialize(duck, bin_pmt));
+    ts::BinaryTable bin_sdt;
+    TSUNIT_ASSERT(sdt.serialize(duck, bin_sdt));
+
+    // Change detection on one PMT and the SDT: deserialization vs. view.
+    utest::TSUnitBenchmark bench1(u"TSUNIT_TABLE_VIEWS_ITERATIONS");
+    bool same = true;
+    bench1.start();
+    for (size_t iter = 0; iter < 1000 * bench1.iterations; ++iter) {
+        const ts::PMT pmt(duck, bin_pmt);
+        const ts::SDT sdt2(duck, bin_sdt);
+        same = same && pmt.streams.size() == pmts[0].streams.size() && sdt2.services.size() == sdt.services.size();
+    }
+    bench1.stop();
+    bench1.report(u"TableViewsTest::Benchmark: PMT and SDT deserialization");
+    TSUNIT_ASSERT(same);
+
+    utest::TSUnitBenchmark bench2(u"TSUNIT_TABLE_VIEWS_ITERATIONS");
+    bench2.start();
+    for (size_t iter = 0; iter < 1000 * bench2.iterations; ++iter) {
+        same = same && ts::PMTView::SameContent(bin_pmt, pmts[0]) && ts::SDTView::SameContent(bin_sdt, sdt);
+    }
+    bench2.stop();
+    bench2.report(u"TableViewsTest::Benchmark: PMT and SDT views");
+    TSUNIT_ASSERT(same);
+
+    // Full signalization demux on the synthetic MPTS.
+    PacketizerMap pzers;
+    ts::TSPacketVector packets;
+    for (uint8_t version = 0; version < 32; ++version) {
+        AddMPTS(duck, pzers, packets, version, pat, pmts, sdt);
+    }
+    utest::TSUnitBenchmark bench3(u"TSUNIT_TABLE_VIEWS_ITERATIONS");
+    bench3.start();
+    for (size_t iter = 0; iter < bench3.iterations; ++iter) {
+        ts::SignalizationDemux demux(duck);
+        demux.addFullFilters();
+        for (const auto& pkt : packets) {
+            demux.feedPacket(pkt);
+        }
+        TSUNIT_EQUAL(31, demux.lastPAT().version);
+    }
+    bench3.stop();
+    bench3.report(ts::UString::Format(u"TableViewsTest::Benchmark: SignalizationDemux, %d packets", packets.size()));
+}
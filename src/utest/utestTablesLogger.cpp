@@ -0,0 +1,152 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2025, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::TablesLogger
+//
+//----------------------------------------------------------------------------
+
+#include "tsTablesLogger.h"
+#include "tsTablesDisplay.h"
+#include "tsCyclingPacketizer.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
+#include "tsSDT.h"
+#include "tsArgs.h"
+#include "tsDuckContext.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TablesLoggerTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(DemuxThreads);
+
+private:
+    // Build a stream with one service, with a new version of the PMT every 100 cycles
+    // and a continuity error in the SDT PID at the specified packet index.
+    static void BuildStream(ts::TSPacketVector& packets, size_t cycles, size_t error_index);
+
+    // Log all tables from a stream, return one line per table.
+    static ts::UString LogTables(const ts::TSPacketVector& packets, size_t threads, const ts::UStringVector& options);
+
+    // A table handler which collects the description of all tables.
+    class Collector: public ts::TableHandlerInterface
+    {
+    public:
+        ts::UString tables {};
+        virtual void handleTable(ts::SectionDemux&, const ts::BinaryTable&) override;
+    };
+};
+
+TSUNIT_REGISTER(TablesLoggerTest);
+
+
+//----------------------------------------------------------------------------
+// Test suite helpers.
+//----------------------------------------------------------------------------
+
+void TablesLoggerTest::BuildStream(ts::TSPacketVector& packets, size_t cycles, size_t error_index)
+{
+    ts::DuckContext duck;
+    ts::PAT pat(1, true, 10);
+    pat.pmts[1] = 0x100;
+    ts::PMT pmt(0, true, 1, 0x200);
+    pmt.streams[0x200].stream_type = ts::ST_AVC_VIDEO;
+    ts::SDT sdt(true, 3, true, 10, 20);
+    sdt.services[1].setName(duck, u"Service");
+
+    ts::CyclingPacketizer pat_pzer(duck, ts::PID_PAT, ts::CyclingPacketizer::StuffingPolicy::ALWAYS);
+    ts::CyclingPacketizer pmt_pzer(duck, 0x100, ts::CyclingPacketizer::StuffingPolicy::ALWAYS);
+    ts::CyclingPacketizer sdt_pzer(duck, ts::PID_SDT, ts::CyclingPacketizer::StuffingPolicy::ALWAYS);
+    pat_pzer.addTable(duck, pat);
+    sdt_pzer.addTable(duck, sdt);
+
+    // Cycles of 5 packets: PAT, PMT, SDT, 2 video packets.
+    uint8_t video_cc = 0;
+    packets.resize(5 * cycles);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        ts::TSPacket& pkt(packets[i]);
+        if (i % 500 == 0) {
+            pmt.version = uint8_t((i / 500) & 0x1F);
+            pmt_pzer.removeAll();
+            pmt_pzer.addTable(duck, pmt);
+        }
+        switch (i % 5) {
+            case 0:
+                pat_pzer.getNextPacket(pkt);
+                break;
+            case 1:
+                pmt_pzer.getNextPacket(pkt);
+                break;
+            case 2:
+                sdt_pzer.getNextPacket(pkt);
+                if (i == error_index) {
+                    pkt.setCC((pkt.getCC() + 1) & ts::CC_MASK);
+                }
+                break;
+            default:
+                pkt = ts::NullPacket;
+                pkt.setPID(0x200);
+                pkt.setCC(video_cc++ & ts::CC_MASK);
+                break;
+        }
+    }
+}
+
+void TablesLoggerTest::Collector::handleTable(ts::SectionDemux&, const ts::BinaryTable& table)
+{
+    tables.format(u"pid: %n, tid: %n, version: %d, packets: %d-%d\n",
+                  table.sourcePID(), table.tableId(), table.version(), table.firstTSPacketIndex(), table.lastTSPacketIndex());
+}
+
+ts::UString TablesLoggerTest::LogTables(const ts::TSPacketVector& packets, size_t threads, const ts::UStringVector& options)
+{
+    ts::DuckContext duck;
+    ts::TablesDisplay display(duck);
+    ts::TablesLogger logger(display);
+    Collector collector;
+    logger.setTableHandler(&collector);
+    logger.setDemuxThreads(threads);
+
+    ts::Args args(u"test", u"", ts::Args::NO_EXIT_ON_ERROR);
+    logger.defineArgs(args);
+    TSUNIT_ASSERT(args.analyze(u"test", options));
+    TSUNIT_ASSERT(logger.loadArgs(duck, args));
+    TSUNIT_ASSERT(logger.open());
+    for (const auto& pkt : packets) {
+        logger.feedPacket(pkt);
+    }
+    logger.close();
+    return collector.tables;
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(DemuxThreads)
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets, 2000, 5002);
+
+    // All PID's are demuxed in demux threads.
+    const ts::UString all(LogTables(packets, 1, {}));
+    debug() << "TablesLoggerTest::DemuxThreads: all PID's:\n" << all << std::endl;
+    TSUNIT_ASSERT(all.contains(u"pid: 0x0100 (256), tid: 0x02 (2), version: 19"));
+    TSUNIT_EQUAL(all, LogTables(packets, 3, {}));
+
+    // The PMT PID is added by the PSI/SI filter and demuxed in the main thread.
+    const ts::UString psi(LogTables(packets, 1, {u"--psi-si", u"--max-tables", u"15"}));
+    debug() << "TablesLoggerTest::DemuxThreads: PSI/SI:\n" << psi << std::endl;
+    TSUNIT_ASSERT(psi.contains(u"pid: 0x0100 (256)"));
+    TSUNIT_EQUAL(psi, LogTables(packets, 3, {u"--psi-si", u"--max-tables", u"15"}));
+}
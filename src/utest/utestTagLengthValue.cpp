@@ -13,6 +13,10 @@
 #include "tsECMGSCS.h"
 #include "tsEMMGMUX.h"
 #include "tstlvMessageFactory.h"
+#include "tstlvConnection.h"
+#include "tsTCPServer.h"
+#include "tsIPUtils.h"
+#include "tsCerrReport.h"
 #include "tsunit.h"
 
 
@@ -26,6 +30,7 @@ class TagLengthValueTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(EMMG);
     TSUNIT_DECLARE_TEST(ECMGError);
     TSUNIT_DECLARE_TEST(EMMGError);
+    TSUNIT_DECLARE_TEST(NonBlockingReassembly);
 };
 
 TSUNIT_REGISTER(TagLengthValueTest);
@@ -303,3 +308,95 @@ TSUNIT_DEFINE_TEST(EMMGError)
     debug() << "TagLengthValueTest::testEMMGError: dump" << std::endl << str << std::endl;
     TSUNIT_EQUAL(refString, str);
 }
+
+TSUNIT_DEFINE_TEST(NonBlockingReassembly)
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    // Server on an ephemeral port.
+    ts::TCPServer server;
+    TSUNIT_ASSERT(server.open(ts::IP::v4, CERR));
+    TSUNIT_ASSERT(server.bind(ts::IPSocketAddress(ts::IPAddress::LocalHost4, ts::IPSocketAddress::AnyPort), CERR));
+    TSUNIT_ASSERT(server.listen(5, CERR));
+    ts::IPSocketAddress server_address;
+    TSUNIT_ASSERT(server.getLocalAddress(server_address, CERR));
+
+    // The client connection is queued in the backlog of the server.
+    ts::TCPConnection client;
+    TSUNIT_ASSERT(client.open(ts::IP::v4, CERR));
+    TSUNIT_ASSERT(client.connect(server_address, CERR));
+
+    ts::ecmgscs::Protocol protocol;
+    ts::tlv::Connection<ts::ThreadSafety::None> conn(protocol);
+    ts::IPSocketAddress client_address;
+    TSUNIT_ASSERT(server.accept(conn, client_address, CERR));
+    TSUNIT_ASSERT(conn.setNonBlocking(true, CERR));
+
+    // Two consecutive messages.
+    ts::ecmgscs::ChannelSetup setup(protocol);
+    setup.channel_id = 12;
+    setup.Super_CAS_id = 0x12345678;
+    ts::ecmgscs::ChannelTest test(protocol);
+    test.channel_id = 12;
+    ts::ByteBlockPtr data(new ts::ByteBlock);
+    {
+        ts::tlv::Serializer zer(data);
+        setup.serialize(zer);
+        test.serialize(zer);
+    }
+    TSUNIT_EQUAL(19 + 11, data->size());
+    const size_t split1 = 3;        // Inside the header of the first message.
+    const size_t split2 = 19 + 2;   // Inside the header of the second message.
+
+    // Receive messages until the expected number is reached or a timeout occurs.
+    ts::tlv::Logger logger(ts::Severity::Debug, &CERR);
+    std::list<ts::tlv::MessagePtr> msgs;
+    const auto receive = [&](size_t expected) {
+        for (int i = 0; i < 200 && msgs.size() < expected; ++i) {
+            TSUNIT_ASSERT(conn.receiveNonBlocking(msgs, logger));
+            if (msgs.size() < expected) {
+                std::this_thread::sleep_for(cn::milliseconds(5));
+            }
+        }
+    };
+
+    // A partial header is not a message.
+    TSUNIT_ASSERT(client.send(data->data(), split1, CERR));
+    std::this_thread::sleep_for(cn::milliseconds(20));
+    TSUNIT_ASSERT(conn.receiveNonBlocking(msgs, logger));
+    TSUNIT_ASSERT(msgs.empty());
+
+    // End of first message and partial header of the second one.
+    TSUNIT_ASSERT(client.send(data->data() + split1, split2 - split1, CERR));
+    receive(1);
+    TSUNIT_EQUAL(1, msgs.size());
+    const auto msg1 = std::dynamic_pointer_cast<ts::ecmgscs::ChannelSetup>(msgs.front());
+    TSUNIT_ASSERT(msg1 != nullptr);
+    TSUNIT_EQUAL(12, msg1->channel_id);
+    TSUNIT_EQUAL(0x12345678, msg1->Super_CAS_id);
+
+    // End of second message.
+    TSUNIT_ASSERT(client.send(data->data() + split2, data->size() - split2, CERR));
+    receive(2);
+    TSUNIT_EQUAL(2, msgs.size());
+    const auto msg2 = std::dynamic_pointer_cast<ts::ecmgscs::ChannelTest>(msgs.back());
+    TSUNIT_ASSERT(msg2 != nullptr);
+    TSUNIT_EQUAL(12, msg2->channel_id);
+
+    // Disconnection of the client is reported as an error.
+    TSUNIT_ASSERT(client.closeWriter(CERR));
+    bool ok = true;
+    for (int i = 0; ok && i < 200; ++i) {
+        ok = conn.receiveNonBlocking(msgs, logger);
+        if (ok) {
+            std::this_thread::sleep_for(cn::milliseconds(5));
+        }
+    }
+    TSUNIT_ASSERT(!ok);
+    TSUNIT_EQUAL(2, msgs.size());
+
+    client.disconnect(CERR);
+    client.close(CERR);
+    conn.close(CERR);
+    server.close(CERR);
+}
@@ -12,8 +12,17 @@
 
 #include "tsTimeShiftBuffer.h"
 #include "tsCerrReport.h"
+#include "tsFileUtils.h"
+#include "tsErrCodeReport.h"
+#include "tsNullReport.h"
 #include "tsunit.h"
 
+#if defined(TS_UNIX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/stat.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
 
 //----------------------------------------------------------------------------
 // The test fixture
@@ -24,9 +33,11 @@ class TimeShiftBufferTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(Minimum);
     TSUNIT_DECLARE_TEST(Memory);
     TSUNIT_DECLARE_TEST(File);
+    TSUNIT_DECLARE_TEST(Mapped);
+    TSUNIT_DECLARE_TEST(Persistent);
 
 private:
-    void testCommon(uint8_t total, uint8_t memory);
+    void testCommon(uint8_t total, uint8_t memory, bool mapped = false);
 };
 
 TSUNIT_REGISTER(TimeShiftBufferTest);
@@ -36,10 +47,11 @@ TSUNIT_REGISTER(TimeShiftBufferTest);
 // Unitary tests.
 //----------------------------------------------------------------------------
 
-void TimeShiftBufferTest::testCommon(uint8_t total, uint8_t memory)
+void TimeShiftBufferTest::testCommon(uint8_t total, uint8_t memory, bool mapped)
 {
     ts::TimeShiftBuffer buf(total);
     TSUNIT_ASSERT(buf.setMemoryPackets(memory));
+    TSUNIT_ASSERT(buf.setMemoryMapped(mapped));
     TSUNIT_ASSERT(!buf.isOpen());
     TSUNIT_ASSERT(buf.open(CERR));
     TSUNIT_ASSERT(buf.isOpen());
@@ -48,6 +60,7 @@ void TimeShiftBufferTest::testCommon(uint8_t total, uint8_t memory)
     TSUNIT_ASSERT(buf.empty());
     TSUNIT_ASSERT(!buf.full());
     TSUNIT_EQUAL(memory >= total, buf.memoryResident());
+    TSUNIT_EQUAL(mapped && memory < total, buf.memoryMapped());
 
     ts::TSPacket pkt;
     ts::TSPacketMetadata mdata;
@@ -120,3 +133,75 @@ TSUNIT_DEFINE_TEST(File)
 {
     testCommon(20, 4);
 }
+
+TSUNIT_DEFINE_TEST(Mapped)
+{
+#if defined(TS_UNIX)
+    testCommon(20, 4, true);
+#endif
+}
+
+TSUNIT_DEFINE_TEST(Persistent)
+{
+#if defined(TS_UNIX)
+    const fs::path filename(ts::TempFile(u".tsbuf"));
+    constexpr size_t total = 20;
+    ts::TSPacket pkt;
+    ts::TSPacketMetadata mdata;
+
+    // First session: fill the buffer and shift a few packets.
+    {
+        ts::TimeShiftBuffer buf(total);
+        TSUNIT_ASSERT(buf.setPersistentFile(filename));
+        TSUNIT_ASSERT(buf.open(CERR));
+        TSUNIT_ASSERT(buf.memoryMapped());
+        TSUNIT_ASSERT(!buf.resumed());
+        for (uint8_t i = 0; i < total + 5; i++) {
+            pkt.init(i, i, i);
+            TSUNIT_ASSERT(buf.shift(pkt, mdata, CERR));
+        }
+        TSUNIT_ASSERT(buf.full());
+        TSUNIT_ASSERT(buf.close(CERR));
+    }
+    TSUNIT_EQUAL(total, ts::TimeShiftBuffer::PersistentFileSize(filename));
+
+    // Second session: resume with the same content.
+    {
+        ts::TimeShiftBuffer buf(total);
+        TSUNIT_ASSERT(buf.setPersistentFile(filename));
+        TSUNIT_ASSERT(buf.open(CERR));
+        TSUNIT_ASSERT(buf.resumed());
+        TSUNIT_ASSERT(buf.full());
+
+        // The file is locked, it cannot be used by another buffer at the same time.
+        ts::TimeShiftBuffer other(total);
+        TSUNIT_ASSERT(other.setPersistentFile(filename));
+        TSUNIT_ASSERT(!other.open(NULLREP));
+        TSUNIT_ASSERT(!other.isOpen());
+        for (uint8_t i = total + 5; i < 2 * total; i++) {
+            pkt.init(i, i, i);
+            TSUNIT_ASSERT(buf.shift(pkt, mdata, CERR));
+            TSUNIT_EQUAL(i - total, pkt.getPID());
+            TSUNIT_EQUAL(i - total, *pkt.getPayload());
+        }
+        TSUNIT_ASSERT(buf.close(CERR));
+    }
+
+    // Third session: a different size reinitializes the buffer.
+    {
+        ts::TimeShiftBuffer buf(total + 1);
+        TSUNIT_ASSERT(buf.setPersistentFile(filename));
+        TSUNIT_ASSERT(buf.open(NULLREP));
+        TSUNIT_ASSERT(!buf.resumed());
+        TSUNIT_ASSERT(buf.empty());
+        TSUNIT_ASSERT(buf.close(CERR));
+    }
+    TSUNIT_EQUAL(total + 1, ts::TimeShiftBuffer::PersistentFileSize(filename));
+
+    // The disk space is allocated, the file is not sparse.
+    struct ::stat st;
+    TSUNIT_EQUAL(0, ::stat(filename.c_str(), &st));
+    TSUNIT_ASSERT(uint64_t(st.st_blocks) * 512 >= uint64_t(st.st_size));
+    TSUNIT_ASSERT(fs::remove(filename, &ts::ErrCodeReport()));
+#endif
+}
@@ -20,8 +20,16 @@
 #include "tsTSScanner.h"
 #include "tsService.h"
 #include "tsHFBand.h"
+#include "tsChannelFile.h"
+#include "tsMultiTunerScanner.h"
+#include "tsOneShotPacketizer.h"
+#include "tsTSFile.h"
+#include "tsFileUtils.h"
+#include "tsErrCodeReport.h"
 #include "tsEnvironment.h"
 #include "tsCOM.h"
+#include "tsNullReport.h"
+#include "tsCerrReport.h"
 #include "tsunit.h"
 #if defined(TS_LINUX)
 #include "tsDTVProperties.h"
@@ -39,17 +47,179 @@ class TunerTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(ListTuners);
     TSUNIT_DECLARE_TEST(ScanDVBT);
     TSUNIT_DECLARE_TEST(SignalState);
+    TSUNIT_DECLARE_TEST(EmulatorScan);
+    TSUNIT_DECLARE_TEST(EmulatorScanNoTuner);
 #if defined(TS_LINUX)
     TSUNIT_DECLARE_TEST(DTVProperties);
 #endif
 
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
 private:
     ts::COM _com {}; // required in Windows only
+    std::vector<fs::path> _tempFiles {};
+
+    // Emulated network: one TS per frequency.
+    static constexpr size_t   EMUL_TS_COUNT = 6;
+    static constexpr uint16_t EMUL_NETWORK_ID = 0x1234;
+    static constexpr uint16_t EMUL_ONETW_ID = 0x20FA;
+    static constexpr uint64_t EMUL_BASE_FREQUENCY = 474'000'000;
+    static constexpr uint64_t EMUL_BANDWIDTH = 8'000'000;
+
+    // Create a TS file containing a PAT, an SDT and a NIT for a TS in the emulated network.
+    void createEmulatedTS(const fs::path& file_name, size_t index);
+
+    // Create the emulated network and return the tuner emulator XML file.
+    ts::UString createEmulatedNetwork();
+
+    // Scanner of the emulated network, one frequency per job.
+    class EmulatorScanner: public ts::MultiTunerScanner
+    {
+        TS_NOBUILD_NOCOPY(EmulatorScanner);
+    public:
+        EmulatorScanner(ts::Report& report, const ts::UStringVector& device_names);
+        std::vector<uint64_t> reported {};  // Frequencies of the reported jobs, in order.
+    protected:
+        virtual void scanJob(Job& job, ts::Tuner& tuner, ts::DuckContext& duck, ts::Report& report) override;
+        virtual void reportJob(Job& job) override;
+    };
 };
 
 TSUNIT_REGISTER(TunerTest);
 
 
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void TunerTest::beforeTest()
+{
+    _tempFiles.clear();
+}
+
+// Test suite cleanup method.
+void TunerTest::afterTest()
+{
+    for (const auto& name : _tempFiles) {
+        fs::remove(name, &ts::ErrCodeReport());
+    }
+    _tempFiles.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Emulated network.
+//----------------------------------------------------------------------------
+
+void TunerTest::createEmulatedTS(const fs::path& file_name, size_t index)
+{
+    ts::DuckContext duck;
+    const uint16_t ts_id = uint16_t(index + 1);
+    const uint16_t service_id = uint16_t(100 + index);
+
+    ts::PAT pat(0, true, ts_id);
+    pat.pmts[service_id] = 0x0100;
+
+    ts::SDT sdt(true, 0, true, ts_id, EMUL_ONETW_ID);
+    sdt.services[service_id].setName(duck, ts::UString::Format(u"Service %d", service_id));
+
+    ts::NIT nit(true, 0, true, EMUL_NETWORK_ID);
+    for (size_t i = 0; i < EMUL_TS_COUNT; ++i) {
+        nit.transports[ts::TransportStreamId(uint16_t(i + 1), EMUL_ONETW_ID)];
+    }
+
+    // One cycle of tables, followed by null packets, as a recorded TS.
+    ts::TSPacketVector packets;
+    ts::TSPacketVector tables;
+    ts::OneShotPacketizer pzer(duck);
+    pzer.setPID(ts::PID_PAT);
+    pzer.addTable(duck, pat);
+    pzer.getPackets(tables);
+    packets.insert(packets.end(), tables.begin(), tables.end());
+    pzer.reset();
+    pzer.setPID(ts::PID_SDT);
+    pzer.addTable(duck, sdt);
+    pzer.getPackets(tables);
+    packets.insert(packets.end(), tables.begin(), tables.end());
+    pzer.reset();
+    pzer.setPID(ts::PID_NIT);
+    pzer.addTable(duck, nit);
+    pzer.getPackets(tables);
+    packets.insert(packets.end(), tables.begin(), tables.end());
+    packets.resize(packets.size() + 500, ts::NullPacket);
+
+    ts::TSFile file;
+    TSUNIT_ASSERT(file.open(file_name, ts::TSFile::WRITE, CERR));
+    TSUNIT_ASSERT(file.writePackets(packets.data(), nullptr, packets.size(), CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+}
+
+ts::UString TunerTest::createEmulatedNetwork()
+{
+    // Create one TS file per frequency and the tuner emulator XML file.
+    ts::UStringList xml;
+    xml.push_back(u"<?xml version='1.0' encoding='UTF-8'?>");
+    xml.push_back(ts::UString::Format(u"<tsduck><defaults delivery='DVB-T' bandwidth='%d'/>", EMUL_BANDWIDTH));
+    for (size_t i = 0; i < EMUL_TS_COUNT; ++i) {
+        _tempFiles.push_back(ts::TempFile(u".ts"));
+        createEmulatedTS(_tempFiles.back(), i);
+        xml.push_back(ts::UString::Format(u"<channel frequency='%d' file='%s'/>", EMUL_BASE_FREQUENCY + i * EMUL_BANDWIDTH, _tempFiles.back()));
+    }
+    xml.push_back(u"</tsduck>");
+    _tempFiles.push_back(ts::TempFile(u".xml"));
+    const ts::UString xml_file(_tempFiles.back());
+    TSUNIT_ASSERT(ts::UString::Save(xml, xml_file));
+    return xml_file;
+}
+
+TunerTest::EmulatorScanner::EmulatorScanner(ts::Report& report, const ts::UStringVector& device_names) :
+    MultiTunerScanner(report, ts::TunerArgs(), device_names)
+{
+    // One job per frequency in the emulated network.
+    for (size_t i = 0; i < EMUL_TS_COUNT; ++i) {
+        Job job;
+        job.params.delivery_system = ts::DS_DVB_T;
+        job.params.frequency = EMUL_BASE_FREQUENCY + i * EMUL_BANDWIDTH;
+        job.params.setDefaultValues();
+        addJob(job);
+    }
+}
+
+void TunerTest::EmulatorScanner::scanJob(Job& job, ts::Tuner& tuner, ts::DuckContext& duck, ts::Report& report)
+{
+    if (!tuner.tune(job.params)) {
+        return;
+    }
+
+    // The scanner shall complete as soon as all tables are collected, long before the timeout.
+    ts::TSScanner scan(duck, tuner, cn::seconds(30));
+    std::shared_ptr<ts::PAT> pat;
+    std::shared_ptr<ts::NIT> nit;
+    std::shared_ptr<ts::SDT> sdt;
+    scan.getPAT(pat);
+    scan.getNIT(nit);
+    scan.getSDT(sdt);
+    if (scan.completed() && pat != nullptr && nit != nullptr && sdt != nullptr) {
+        job.ts_found = true;
+        job.ts_id = pat->ts_id;
+        job.net_id = nit->network_id;
+        job.onid = sdt->onetw_id;
+        job.tune = job.params;
+        job.services_found = scan.getServices(job.services);
+    }
+    report.debug(u"scanned %'d Hz, TS found: %s", job.params.frequency.value_or(0), job.ts_found);
+}
+
+void TunerTest::EmulatorScanner::reportJob(Job& job)
+{
+    reported.push_back(job.params.frequency.value_or(0));
+    MultiTunerScanner::reportJob(job);
+}
+
+
 //----------------------------------------------------------------------------
 // Unitary tests.
 //----------------------------------------------------------------------------
@@ -135,6 +305,63 @@ TSUNIT_DEFINE_TEST(SignalState)
     TSUNIT_EQUAL(u"12.345 dB", ts::SignalState::Value(12345, ts::SignalState::Unit::MDB).toString());
 }
 
+TSUNIT_DEFINE_TEST(EmulatorScan)
+{
+    // Scan the emulated network using several emulated tuners in parallel.
+    const ts::UString xml_file(createEmulatedNetwork());
+    constexpr size_t tuner_count = 3;
+    EmulatorScanner scanner(CERR, ts::UStringVector(tuner_count, xml_file));
+    TSUNIT_EQUAL(tuner_count, scanner.tunerCount());
+    TSUNIT_EQUAL(EMUL_TS_COUNT, scanner.jobCount());
+
+    const ts::monotonic_time start = ts::monotonic_time::clock::now();
+    TSUNIT_ASSERT(scanner.run());
+    debug() << "TunerTest::EmulatorScan: " << EMUL_TS_COUNT << " transport streams scanned in "
+            << cn::duration_cast<cn::milliseconds>(ts::monotonic_time::clock::now() - start).count() << " ms" << std::endl;
+
+    // The results are reported in the order of the jobs.
+    TSUNIT_EQUAL(EMUL_TS_COUNT, scanner.reported.size());
+    for (size_t i = 0; i < EMUL_TS_COUNT; ++i) {
+        TSUNIT_EQUAL(EMUL_BASE_FREQUENCY + i * EMUL_BANDWIDTH, scanner.reported[i]);
+    }
+
+    // All transport streams must be merged in the channel file.
+    const ts::ChannelFile& channels(scanner.channels());
+    TSUNIT_EQUAL(1, channels.networkCount());
+    const auto net(channels.networkById(EMUL_NETWORK_ID, ts::TT_DVB_T));
+    TSUNIT_ASSERT(net != nullptr);
+    TSUNIT_EQUAL(EMUL_TS_COUNT, net->tsCount());
+    for (size_t i = 0; i < EMUL_TS_COUNT; ++i) {
+        const auto ts_info(net->tsById(uint16_t(i + 1)));
+        TSUNIT_ASSERT(ts_info != nullptr);
+        TSUNIT_EQUAL(EMUL_ONETW_ID, ts_info->onid);
+        TSUNIT_EQUAL(EMUL_BASE_FREQUENCY + i * EMUL_BANDWIDTH, ts_info->tune.frequency.value_or(0));
+        TSUNIT_EQUAL(1, ts_info->serviceCount());
+        const auto srv(ts_info->serviceById(uint16_t(100 + i)));
+        TSUNIT_ASSERT(srv != nullptr);
+        TSUNIT_EQUAL(ts::UString::Format(u"Service %d", 100 + i), srv->name);
+    }
+
+    // And all services in the global list of services, in the order of the jobs.
+    TSUNIT_EQUAL(EMUL_TS_COUNT, scanner.services().size());
+    uint16_t service_id = 100;
+    for (const auto& srv : scanner.services()) {
+        TSUNIT_EQUAL(service_id++, srv.getId());
+    }
+}
+
+TSUNIT_DEFINE_TEST(EmulatorScanNoTuner)
+{
+    // When no tuner can be opened, no job is executed.
+    _tempFiles.push_back(ts::TempFile(u".xml"));
+    EmulatorScanner scanner(NULLREP, ts::UStringVector(2, ts::UString(_tempFiles.back())));
+    TSUNIT_EQUAL(2, scanner.tunerCount());
+    TSUNIT_ASSERT(!scanner.run());
+    TSUNIT_ASSERT(scanner.reported.empty());
+    TSUNIT_EQUAL(0, scanner.channels().networkCount());
+    TSUNIT_ASSERT(scanner.services().empty());
+}
+
 #if defined(TS_LINUX)
 TSUNIT_DEFINE_TEST(DTVProperties)
 {
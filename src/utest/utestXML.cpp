@@ -11,6 +11,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsxmlModelDocument.h"
+#include "tsxmlStreamingDocument.h"
 #include "tsxmlElement.h"
 #include "tsxmlDeclaration.h"
 #include "tsSectionFile.h"
@@ -20,6 +21,7 @@
 #include "tsFileUtils.h"
 #include "tsErrCodeReport.h"
 #include "tsunit.h"
+#include "utestTSUnitBenchmark.h"
 
 
 //----------------------------------------------------------------------------
@@ -32,6 +34,9 @@ class XMLTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(Invalid);
     TSUNIT_DECLARE_TEST(FileBOM);
     TSUNIT_DECLARE_TEST(Validation);
+    TSUNIT_DECLARE_TEST(ValidationErrors);
+    TSUNIT_DECLARE_TEST(ValidationThreads);
+    TSUNIT_DECLARE_TEST(ValidationBenchmark);
     TSUNIT_DECLARE_TEST(Creation);
     TSUNIT_DECLARE_TEST(KeepOpen);
     TSUNIT_DECLARE_TEST(Escape);
@@ -43,6 +48,8 @@ class XMLTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(SetFloat);
     TSUNIT_DECLARE_TEST(PreserveSpace);
     TSUNIT_DECLARE_TEST(IntValue);
+    TSUNIT_DECLARE_TEST(Streaming);
+    TSUNIT_DECLARE_TEST(StreamingInvalid);
 
 public:
     virtual void beforeTest() override;
@@ -247,6 +254,108 @@ TSUNIT_DEFINE_TEST(Validation)
     TSUNIT_ASSERT(model.validate(doc));
 }
 
+TSUNIT_DEFINE_TEST(ValidationErrors)
+{
+    ts::xml::ModelDocument model(report());
+    TSUNIT_ASSERT(model.load(ts::SectionFile::XML_TABLES_MODEL));
+
+    ts::xml::Document doc(report());
+    TSUNIT_ASSERT(doc.parse(
+        u"<?xml version='1.0' encoding='UTF-8'?>\n"
+        u"<TSDuck>\n"
+        u"  <pat VERSION='2' transport_stream_id='27'>\n"
+        u"    <Service service_id='1' program_map_PID='1000'/>\n"
+        u"  </pat>\n"
+        u"</TSDuck>"));
+    TSUNIT_ASSERT(model.validate(doc));
+
+    ts::ReportBuffer<ts::ThreadSafety::None> rep;
+    ts::xml::ModelDocument model2(rep);
+    TSUNIT_ASSERT(model2.load(ts::SectionFile::XML_TABLES_MODEL));
+    ts::xml::Document doc2(report());
+    TSUNIT_ASSERT(doc2.parse(
+        u"<?xml version='1.0' encoding='UTF-8'?>\n"
+        u"<tsduck>\n"
+        u"  <PMT version='3' service_id='789' PCR_PID='3004' foo='1'>\n"
+        u"    <CA_descriptor CA_system_id='500' CA_PID='3005'/>\n"
+        u"    <component stream_type='0x04' elementary_PID='3006'>\n"
+        u"      <service service_id='1' program_map_PID='1000'/>\n"
+        u"    </component>\n"
+        u"  </PMT>\n"
+        u"</tsduck>"));
+    TSUNIT_ASSERT(!model2.validate(doc2));
+    debug() << "XMLTest::ValidationErrors: " << rep.messages() << std::endl;
+    TSUNIT_EQUAL(u"Error: unexpected attribute 'foo' in <PMT>, line 3\n"
+                 u"Error: unexpected node <service> in <component>, line 6",
+                 rep.messages());
+}
+
+TSUNIT_DEFINE_TEST(ValidationThreads)
+{
+    // The model is compiled on first use, concurrently from several threads.
+    ts::xml::ModelDocument model(report());
+    TSUNIT_ASSERT(model.load(ts::SectionFile::XML_TABLES_MODEL));
+
+    ts::xml::Document doc(report());
+    TSUNIT_ASSERT(doc.parse(
+        u"<?xml version='1.0' encoding='UTF-8'?>\n"
+        u"<tsduck>\n"
+        u"  <PAT version='2' transport_stream_id='27'>\n"
+        u"    <service service_id='1' program_map_PID='1000'/>\n"
+        u"  </PAT>\n"
+        u"</tsduck>"));
+
+    constexpr size_t thread_count = 8;
+    std::array<bool, thread_count> results {};
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads.emplace_back([&model, &doc, &results, i]() { results[i] = model.validate(doc); });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+        TSUNIT_ASSERT(results[i]);
+    }
+}
+
+TSUNIT_DEFINE_TEST(ValidationBenchmark)
+{
+    ts::xml::ModelDocument model(report());
+    TSUNIT_ASSERT(ts::SectionFile::LoadModel(model));
+
+    // Build a large document with many tables and descriptors.
+    ts::xml::Document doc(report());
+    ts::xml::Element* root = doc.initialize(u"tsduck");
+    TSUNIT_ASSERT(root != nullptr);
+    for (int srv = 1; srv <= 200; ++srv) {
+        ts::xml::Element* pmt = root->addElement(u"PMT");
+        pmt->setIntAttribute(u"service_id", srv);
+        pmt->setIntAttribute(u"PCR_PID", 100 + srv);
+        ts::xml::Element* ca = pmt->addElement(u"CA_descriptor");
+        ca->setIntAttribute(u"CA_system_id", 0x0500);
+        ca->setIntAttribute(u"CA_PID", 200 + srv);
+        for (int comp = 0; comp < 4; ++comp) {
+            ts::xml::Element* es = pmt->addElement(u"component");
+            es->setIntAttribute(u"stream_type", 4);
+            es->setIntAttribute(u"elementary_PID", 1000 + 4 * srv + comp);
+            es->addElement(u"ISO_639_language_descriptor")->addElement(u"language")->setAttribute(u"code", u"eng");
+            es->addElement(u"stream_identifier_descriptor")->setIntAttribute(u"component_tag", comp);
+        }
+    }
+
+    // Support for benchmarking.
+    utest::TSUnitBenchmark bench(u"TSUNIT_XML_VALIDATION_ITERATIONS");
+    bool ok = true;
+    bench.start();
+    for (size_t iter = 0; iter < bench.iterations; ++iter) {
+        ok = model.validate(doc) && ok;
+    }
+    bench.stop();
+    TSUNIT_ASSERT(ok);
+    bench.report(u"XMLTest::ValidationBenchmark");
+}
+
 TSUNIT_DEFINE_TEST(Creation)
 {
     ts::xml::Document doc(report());
@@ -792,3 +901,117 @@ TSUNIT_DEFINE_TEST(IntValue)
     int8_t i8 = 0;
     TSUNIT_ASSERT(!root->getIntAttribute(i8, u"a"));
 }
+
+TSUNIT_DEFINE_TEST(Streaming)
+{
+    ts::xml::ModelDocument model(report());
+    TSUNIT_ASSERT(model.load(ts::SectionFile::XML_TABLES_MODEL));
+
+    const ts::UString xmlContent(
+        u"<?xml version='1.0' encoding='UTF-8'?>\n"
+        u"<!-- Leading comment -->\n"
+        u"<tsduck>\n"
+        u"  <PAT version='2' transport_stream_id='27'>\n"
+        u"    <service service_id='1' program_map_PID='1000'/>\n"
+        u"    <!-- <service service_id='9' program_map_PID='9000'/> -->\n"
+        u"    <service service_id='2'\n"
+        u"             program_map_PID='2000'/>\n"
+        u"  </PAT>\n"
+        u"  <!-- Comment between tables -->\n"
+        u"  <TDT UTC_time='2017-12-25 14:55:27'/><TOT UTC_time='2017-12-25 14:55:27'>\n"
+        u"    <generic_descriptor tag='0x80'>\n"
+        u"      <![CDATA[ <not> an </element> ]]>\n"
+        u"    </generic_descriptor>\n"
+        u"  </TOT>\n"
+        u"  <foo bar='>'><PAT/></foo>\n"
+        u"</tsduck>\n"
+        u"<!-- Trailing comment -->\n");
+
+    ts::ReportBuffer<ts::ThreadSafety::None> rep;
+    ts::xml::StreamingDocument doc(rep);
+    TSUNIT_ASSERT(doc.open(xmlContent));
+    TSUNIT_ASSERT(!doc.eof());
+
+    ts::xml::Element* root = doc.rootElement();
+    TSUNIT_ASSERT(root != nullptr);
+    TSUNIT_EQUAL(u"tsduck", root->name());
+    TSUNIT_EQUAL(3, root->lineNumber());
+    TSUNIT_ASSERT(!root->hasChildren());
+    TSUNIT_ASSERT(model.validate(doc));
+
+    TSUNIT_ASSERT(doc.next());
+    TSUNIT_EQUAL(1, root->childrenCount());
+    ts::xml::Element* elem = root->firstChildElement();
+    TSUNIT_ASSERT(elem != nullptr);
+    TSUNIT_EQUAL(u"PAT", elem->name());
+    TSUNIT_EQUAL(4, elem->lineNumber());
+    TSUNIT_EQUAL(u"27", elem->attribute(u"transport_stream_id").value());
+    ts::xml::ElementVector children;
+    TSUNIT_ASSERT(elem->getChildren(children, u"service"));
+    TSUNIT_EQUAL(2, children.size());
+    TSUNIT_EQUAL(5, children[0]->lineNumber());
+    TSUNIT_EQUAL(7, children[1]->lineNumber());
+    TSUNIT_EQUAL(u"2000", children[1]->attribute(u"program_map_PID").value());
+    TSUNIT_ASSERT(model.validate(doc));
+
+    TSUNIT_ASSERT(doc.next());
+    TSUNIT_EQUAL(1, root->childrenCount());
+    elem = root->firstChildElement();
+    TSUNIT_ASSERT(elem != nullptr);
+    TSUNIT_EQUAL(u"TDT", elem->name());
+    TSUNIT_EQUAL(11, elem->lineNumber());
+    TSUNIT_ASSERT(model.validate(doc));
+
+    TSUNIT_ASSERT(doc.next());
+    TSUNIT_EQUAL(1, root->childrenCount());
+    elem = root->firstChildElement();
+    TSUNIT_ASSERT(elem != nullptr);
+    TSUNIT_EQUAL(u"TOT", elem->name());
+    TSUNIT_EQUAL(11, elem->lineNumber());
+    const ts::xml::Element* desc = elem->findFirstChild(u"generic_descriptor");
+    TSUNIT_ASSERT(desc != nullptr);
+    TSUNIT_EQUAL(12, desc->lineNumber());
+    TSUNIT_EQUAL(u"<not> an </element>", desc->text(true));
+    TSUNIT_ASSERT(model.validate(doc));
+
+    TSUNIT_ASSERT(doc.next());
+    TSUNIT_EQUAL(1, root->childrenCount());
+    elem = root->firstChildElement();
+    TSUNIT_ASSERT(elem != nullptr);
+    TSUNIT_EQUAL(u"foo", elem->name());
+    TSUNIT_EQUAL(u">", elem->attribute(u"bar").value());
+    TSUNIT_ASSERT(!model.validate(doc));
+
+    TSUNIT_ASSERT(!doc.next());
+    TSUNIT_ASSERT(doc.eof());
+    TSUNIT_ASSERT(!root->hasChildren());
+    TSUNIT_EQUAL(u"tsduck", root->name());
+}
+
+TSUNIT_DEFINE_TEST(StreamingInvalid)
+{
+    ts::ReportBuffer<ts::ThreadSafety::None> rep;
+    ts::xml::StreamingDocument doc(rep);
+
+    TSUNIT_ASSERT(doc.open(u"<?xml version='1.0' encoding='UTF-8'?>\n<root>\n  <a>\n    <b/>\n  </a>\n  <c>\n"));
+    TSUNIT_ASSERT(doc.next());
+    TSUNIT_ASSERT(!doc.next());
+    TSUNIT_ASSERT(!doc.eof());
+    debug() << "XMLTest::StreamingInvalid: " << rep.messages() << std::endl;
+    TSUNIT_ASSERT(rep.gotErrors());
+
+    rep.clear();
+    rep.resetErrors();
+    TSUNIT_ASSERT(!doc.open(u"<?xml version='1.0' encoding='UTF-8'?>\n<root/>\n<trailing/>\n"));
+    TSUNIT_ASSERT(!doc.eof());
+    TSUNIT_ASSERT(rep.gotErrors());
+
+    rep.clear();
+    rep.resetErrors();
+    TSUNIT_ASSERT(doc.open(u"<?xml version='1.0' encoding='UTF-8'?>\n<root a='1'/>\n"));
+    TSUNIT_ASSERT(doc.eof());
+    TSUNIT_ASSERT(!rep.gotErrors());
+    TSUNIT_ASSERT(doc.rootElement() != nullptr);
+    TSUNIT_EQUAL(u"1", doc.rootElement()->attribute(u"a").value());
+    TSUNIT_ASSERT(!doc.next());
+}